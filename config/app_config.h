@@ -36,6 +36,7 @@
 
 // 界面配置
 #define UI_REFRESH_RATE_MS          50      // UI刷新率
+#define UI_TARGET_FPS               (1000 / UI_REFRESH_RATE_MS)  // 帧节拍目标帧率
 #define UI_TRANSITION_TIME_MS       300     // 界面切换时间
 
 // ========================================
@@ -138,6 +139,10 @@
 #error "SYSTEM_TICK_MS must be positive"
 #endif
 
+#if UI_REFRESH_RATE_MS <= 0 || UI_REFRESH_RATE_MS > 1000
+#error "UI_REFRESH_RATE_MS must be in 1..1000"
+#endif
+
 #if DISPLAY_DEFAULT_BRIGHTNESS > 255
 #error "DISPLAY_DEFAULT_BRIGHTNESS must be <= 255"
 #endif
@@ -34,7 +34,10 @@
 
 // 测试功能总开关 - 开发阶段启用，生产环境设为 0
 
+// 主机模拟 (env:native) 用 -DENABLE_TEST_CODE=0 覆盖 - 测试套件要真硬件
+#ifndef ENABLE_TEST_CODE
 #define ENABLE_TEST_CODE            1       // 开发阶段启用测试
+#endif
 
 // 具体测试模块控制
 #if ENABLE_TEST_CODE
@@ -0,0 +1,362 @@
+#!/usr/bin/env python3
+"""
+ESP32-S3 HoloCubic UI资源包工具
+Linus风格：资源在主机上压缩一次，设备上直接映射Flash读取
+
+格式与 src/drivers/display/display_assets.h 一致：
+  头    16字节: magic "HCAP", version, count, size, reserved
+  索引  32字节 × count, 按名字的FNV-1a哈希升序
+  数据  QOI565或原始RGB565 (BGR565, 小端), 每项4字节对齐
+
+功能：
+1. pack   - 把图片压缩成资源包
+2. list   - 列出资源包内容
+3. verify - 用mmap打开资源包，逐个查找、解压并与原图比对，测量查找和解压速度
+4. flash  - 用esptool把资源包写入assets分区
+"""
+
+import argparse
+import mmap
+import struct
+import subprocess
+import sys
+import time
+from pathlib import Path
+
+MAGIC = 0x50414348          # "HCAP"
+VERSION = 1
+NAME_MAX = 12               # 含结尾0
+HEADER = struct.Struct('<IHHII')
+ENTRY = struct.Struct('<IIIHHB3x12s')
+CODEC_RAW = 0
+CODEC_QOI565 = 1
+CODEC_NAMES = {CODEC_RAW: 'raw', CODEC_QOI565: 'qoi565'}
+
+PARTITION_TABLE = Path(__file__).resolve().parent.parent / 'FLASH_8MB.csv'
+PARTITION_NAME = 'assets'
+IMAGE_SUFFIXES = {'.png', '.jpg', '.jpeg', '.bmp', '.gif'}
+
+
+def fnv1a(name):
+    h = 2166136261
+    for b in name.encode('ascii'):
+        h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def qoi_hash(px):
+    return ((px >> 11) * 3 + ((px >> 5) & 63) * 5 + (px & 31) * 7) & 63
+
+
+def wrap(delta, bits):
+    """把分量差折回有符号范围"""
+    half = 1 << (bits - 1)
+    return ((delta + half) & ((1 << bits) - 1)) - half
+
+
+def qoi565_encode(pixels):
+    """像素列表 -> QOI565字节流 (操作码见display_assets.h)"""
+    out = bytearray()
+    index = [0] * 64
+    prev = 0
+    run = 0
+    last = len(pixels) - 1
+
+    for i, px in enumerate(pixels):
+        if px == prev:
+            run += 1
+            if run == 62 or i == last:
+                out.append(0xC0 | (run - 1))
+                run = 0
+            continue
+
+        if run:
+            out.append(0xC0 | (run - 1))
+            run = 0
+
+        slot = qoi_hash(px)
+        if index[slot] == px:
+            out.append(slot)
+        else:
+            index[slot] = px
+            dh = wrap((px >> 11) - (prev >> 11), 5)
+            dm = wrap(((px >> 5) & 63) - ((prev >> 5) & 63), 6)
+            dl = wrap((px & 31) - (prev & 31), 5)
+            half = dm >> 1
+            if -2 <= dh <= 1 and -2 <= dm <= 1 and -2 <= dl <= 1:
+                out.append(0x40 | ((dh + 2) << 4) | ((dm + 2) << 2) | (dl + 2))
+            elif -32 <= dm <= 31 and -8 <= dh - half <= 7 and -8 <= dl - half <= 7:
+                out.append(0x80 | (dm + 32))
+                out.append(((dh - half + 8) << 4) | (dl - half + 8))
+            else:
+                out += bytes((0xFE, px & 0xFF, px >> 8))
+        prev = px
+
+    return bytes(out)
+
+
+def qoi565_decode(data, count):
+    """QOI565字节流 -> 像素列表 - 和设备上的解码器逐条对应"""
+    out = []
+    index = [0] * 64
+    px = 0
+    pos = 0
+    while len(out) < count:
+        b = data[pos]
+        pos += 1
+        if b < 0x40:
+            px = index[b]
+        elif b < 0x80:
+            px = (((((px >> 11) + ((b >> 4) & 3) - 2) & 31) << 11) |
+                  (((((px >> 5) & 63) + ((b >> 2) & 3) - 2) & 63) << 5) |
+                  (((px & 31) + (b & 3) - 2) & 31))
+        elif b < 0xC0:
+            b2 = data[pos]
+            pos += 1
+            dm = (b & 63) - 32
+            half = dm >> 1
+            px = (((((px >> 11) + (b2 >> 4) - 8 + half) & 31) << 11) |
+                  (((((px >> 5) & 63) + dm) & 63) << 5) |
+                  (((px & 31) + (b2 & 15) - 8 + half) & 31))
+        elif b < 0xFE:
+            out.extend([px] * (b - 0xC0 + 1))
+            continue
+        elif b == 0xFE:
+            px = data[pos] | (data[pos + 1] << 8)
+            pos += 2
+        else:
+            raise ValueError('invalid opcode 0xFF')
+        index[qoi_hash(px)] = px
+        out.append(px)
+    return out[:count]
+
+
+def load_image(path):
+    """图片 -> (宽, 高, BGR565像素列表)，透明度和黑色混合，与显示驱动一致"""
+    try:
+        from PIL import Image
+    except ImportError:
+        sys.exit('❌ 需要Pillow: pip install pillow')
+
+    img = Image.open(path)
+    if img.mode.startswith('I;16'):
+        # 16位灰度取高字节，和设备上的PNG解码器一样；直接convert会把超过255的值截成白色
+        img = img.point(lambda v: v * (1 / 256)).convert('L')
+    if img.mode in ('RGBA', 'LA', 'P'):
+        img = img.convert('RGBA')
+        black = Image.new('RGBA', img.size, (0, 0, 0, 255))
+        img = Image.alpha_composite(black, img)
+    img = img.convert('RGB')
+
+    rgb = img.tobytes()
+    pixels = [((rgb[i + 2] >> 3) << 11) | ((rgb[i + 1] >> 2) << 5) | (rgb[i] >> 3) for i in range(0, len(rgb), 3)]
+    return img.width, img.height, pixels
+
+
+def collect_inputs(paths):
+    files = []
+    for p in map(Path, paths):
+        if p.is_dir():
+            files += sorted(f for f in p.iterdir() if f.suffix.lower() in IMAGE_SUFFIXES)
+        else:
+            files.append(p)
+    return files
+
+
+def asset_name(path):
+    name = path.stem
+    if len(name) >= NAME_MAX or not name.isascii():
+        sys.exit(f'❌ 资源名必须是ASCII且不超过{NAME_MAX - 1}个字符: {name}')
+    return name
+
+
+def partition_info(name=PARTITION_NAME):
+    """从分区表读 (偏移, 大小)"""
+    with open(PARTITION_TABLE) as f:
+        for line in f:
+            parts = [p.strip() for p in line.split(',')]
+            if len(parts) >= 5 and parts[0] == name:
+                return int(parts[3], 0), int(parts[4], 0)
+    sys.exit(f'❌ {PARTITION_TABLE.name} 里没有 {name} 分区')
+
+
+class AssetPack:
+    """用mmap打开的资源包 - 与设备上的display_assets_open/find对应"""
+
+    def __init__(self, path):
+        self.file = open(path, 'rb')
+        self.map = mmap.mmap(self.file.fileno(), 0, access=mmap.ACCESS_READ)
+        magic, version, self.count, self.size, _ = HEADER.unpack_from(self.map, 0)
+        if magic != MAGIC or version != VERSION or self.size > len(self.map):
+            raise ValueError(f'{path}: 不是有效的资源包')
+        self.hashes = [ENTRY.unpack_from(self.map, HEADER.size + i * ENTRY.size)[0] for i in range(self.count)]
+
+    def entry(self, i):
+        h, offset, length, width, height, codec, name = ENTRY.unpack_from(self.map, HEADER.size + i * ENTRY.size)
+        return {'hash': h, 'offset': offset, 'length': length, 'width': width, 'height': height,
+                'codec': codec, 'name': name.rstrip(b'\0').decode('ascii')}
+
+    def find(self, name):
+        """二分查找 - 和设备上一样只比较哈希，命中后再核对名字"""
+        h = fnv1a(name)
+        lo, hi = 0, self.count
+        while lo < hi:
+            mid = (lo + hi) // 2
+            if self.hashes[mid] < h:
+                lo = mid + 1
+            else:
+                hi = mid
+        if lo < self.count and self.hashes[lo] == h:
+            e = self.entry(lo)
+            if e['name'] == name:
+                return e
+        return None
+
+    def pixels(self, e):
+        data = self.map[e['offset']:e['offset'] + e['length']]
+        count = e['width'] * e['height']
+        if e['codec'] == CODEC_RAW:
+            return list(struct.unpack(f'<{count}H', data))
+        return qoi565_decode(data, count)
+
+    def close(self):
+        self.map.close()
+        self.file.close()
+
+
+def cmd_pack(args):
+    assets = {}
+    for path in collect_inputs(args.inputs):
+        name = asset_name(path)
+        h = fnv1a(name)
+        if h in assets:
+            sys.exit(f'❌ 名字重复或哈希冲突: {name} / {assets[h][0]}')
+        width, height, pixels = load_image(path)
+        raw = struct.pack(f'<{len(pixels)}H', *pixels)
+        data, codec = raw, CODEC_RAW
+        if not args.raw:
+            packed = qoi565_encode(pixels)
+            if len(packed) < len(raw):
+                data, codec = packed, CODEC_QOI565
+        assets[h] = (name, width, height, codec, data)
+
+    entries = sorted(assets.items())
+    offset = HEADER.size + len(entries) * ENTRY.size
+    index = bytearray()
+    blob = bytearray()
+    for h, (name, width, height, codec, data) in entries:
+        index += ENTRY.pack(h, offset + len(blob), len(data), width, height, codec, name.encode('ascii'))
+        blob += data
+        blob += b'\0' * (-len(blob) % 4)
+
+    size = offset + len(blob)
+    _, limit = partition_info()
+    if size > limit:
+        sys.exit(f'❌ 资源包 {size} 字节超过 {PARTITION_NAME} 分区 {limit} 字节')
+
+    with open(args.output, 'wb') as f:
+        f.write(HEADER.pack(MAGIC, VERSION, len(entries), size, 0))
+        f.write(index)
+        f.write(blob)
+
+    raw_total = sum(w * h * 2 for _, w, h, _, _ in assets.values())
+    print(f'✅ {args.output}: {len(entries)} 个资源, {size} 字节 '
+          f'(原始 {raw_total} 字节, {100.0 * size / max(raw_total, 1):.1f}%), 分区用量 {100.0 * size / limit:.1f}%')
+
+
+def cmd_list(args):
+    pack = AssetPack(args.pack)
+    print(f'📦 {args.pack}: {pack.count} 个资源, {pack.size} 字节')
+    for i in range(pack.count):
+        e = pack.entry(i)
+        ratio = 100.0 * e['length'] / max(e['width'] * e['height'] * 2, 1)
+        print(f"  {e['name']:<12} {e['width']:>4}x{e['height']:<4} {CODEC_NAMES.get(e['codec'], '?'):<7} "
+              f"{e['length']:>7} 字节 ({ratio:.1f}%)  @0x{e['offset']:06x}")
+    pack.close()
+
+
+def cmd_verify(args):
+    pack = AssetPack(args.pack)
+    failures = 0
+    names = []
+    for path in collect_inputs(args.inputs):
+        name = asset_name(path)
+        names.append(name)
+        e = pack.find(name)
+        if e is None:
+            print(f'❌ {name}: 不在资源包里')
+            failures += 1
+            continue
+        width, height, expected = load_image(path)
+        if (e['width'], e['height']) != (width, height) or pack.pixels(e) != expected:
+            print(f'❌ {name}: 解压结果与原图不一致')
+            failures += 1
+        else:
+            print(f'✅ {name}: {width}x{height} 一致')
+
+    # 查找和解压速度 - Python实现，只用来比较不同资源包
+    if names:
+        rounds = max(1, args.lookups // len(names))
+        start = time.perf_counter()
+        for _ in range(rounds):
+            for name in names:
+                pack.find(name)
+        lookup_s = time.perf_counter() - start
+
+        pixels = 0
+        start = time.perf_counter()
+        for i in range(pack.count):
+            e = pack.entry(i)
+            pixels += len(pack.pixels(e))
+        decode_s = time.perf_counter() - start
+        print(f'📊 查找: {rounds * len(names) / lookup_s / 1000:.1f} K次/秒, '
+              f'解压: {pixels / decode_s / 1e6:.2f} M像素/秒 (主机Python)')
+
+    pack.close()
+    return 1 if failures else 0
+
+
+def cmd_flash(args):
+    offset, limit = partition_info()
+    size = Path(args.pack).stat().st_size
+    if size > limit:
+        sys.exit(f'❌ 资源包 {size} 字节超过分区 {limit} 字节')
+    cmd = [sys.executable, '-m', 'esptool', '--chip', 'esp32s3']
+    if args.port:
+        cmd += ['--port', args.port]
+    cmd += ['write_flash', hex(offset), args.pack]
+    print('📤 ' + ' '.join(cmd))
+    return subprocess.call(cmd)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='ESP32-S3 HoloCubic UI资源包工具')
+    sub = parser.add_subparsers(dest='command', required=True)
+
+    p = sub.add_parser('pack', help='把图片压缩成资源包')
+    p.add_argument('output')
+    p.add_argument('inputs', nargs='+', help='图片文件或目录，资源名 = 文件名去掉扩展名')
+    p.add_argument('--raw', action='store_true', help='不压缩')
+    p.set_defaults(func=cmd_pack)
+
+    p = sub.add_parser('list', help='列出资源包内容')
+    p.add_argument('pack')
+    p.set_defaults(func=cmd_list)
+
+    p = sub.add_parser('verify', help='与原图比对并测量速度')
+    p.add_argument('pack')
+    p.add_argument('inputs', nargs='+')
+    p.add_argument('--lookups', type=int, default=100000, help='查找测速次数')
+    p.set_defaults(func=cmd_verify)
+
+    p = sub.add_parser('flash', help='写入assets分区')
+    p.add_argument('pack')
+    p.add_argument('--port')
+    p.set_defaults(func=cmd_flash)
+
+    args = parser.parse_args()
+    return args.func(args) or 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
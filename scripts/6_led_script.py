@@ -0,0 +1,230 @@
+#!/usr/bin/env python3
+"""
+ESP32-S3 HoloCubic LED动画脚本编译器
+Linus风格：动画在主机上编译一次，设备上的解释器只认字节码
+
+格式与 src/app/managers/led_script.h 一致：
+  头    8字节: magic "HCLS", version, reserved, code_size (小端)
+  代码  code_size字节
+
+文本格式 (一行一条，; 后面是注释)：
+  label:                  标签，跳转目标
+  set #00ff00             立即换色，也可以写 set 0 255 0
+  fade #000000 300        渐变到颜色，300ms后执行下一条
+  wait 1000
+  light 128 500           背光500ms渐变到128 (0-255)，不等待
+  repeat 3 ... next       重复3次，可以嵌套4层
+  jump label
+  if wifi label           状态位为1就跳；ifnot 相反
+  end                     停在当前颜色
+
+状态名: wifi, wifi_busy, wifi_failed (或直接写位号0-31)
+
+功能：
+1. compile - 文本 -> .lsc
+2. dump    - 反汇编 .lsc
+"""
+
+import argparse
+import struct
+import sys
+from pathlib import Path
+
+MAGIC = 0x534C4348          # "HCLS"
+VERSION = 1
+HEADER = struct.Struct('<IBBH')
+MAX_CODE = 1024
+MAX_DEPTH = 4
+
+# 操作码, 操作数格式 (B=字节, H=16位)
+OPS = {
+    'end':    (0x00, ''),
+    'set':    (0x01, 'BBB'),
+    'fade':   (0x02, 'BBBH'),
+    'wait':   (0x03, 'H'),
+    'light':  (0x04, 'BH'),
+    'repeat': (0x05, 'B'),
+    'next':   (0x06, 'H'),
+    'jump':   (0x07, 'H'),
+    'if':     (0x08, 'BH'),
+    'ifnot':  (0x09, 'BH'),
+}
+NAMES = {code: (name, fmt) for name, (code, fmt) in OPS.items()}
+
+STATES = {'wifi': 0, 'wifi_busy': 1, 'wifi_failed': 2}
+
+
+class ScriptError(Exception):
+    pass
+
+
+def parse_color(args, line_no):
+    """#rrggbb 或者 r g b -> (r, g, b, 剩下的参数)"""
+    if args and args[0].startswith('#'):
+        text = args[0][1:]
+        if len(text) != 6:
+            raise ScriptError(f'第{line_no}行: 颜色要写成 #rrggbb')
+        value = int(text, 16)
+        return (value >> 16) & 255, (value >> 8) & 255, value & 255, args[1:]
+    if len(args) < 3:
+        raise ScriptError(f'第{line_no}行: 缺少颜色')
+    return parse_int(args[0], 255, line_no), parse_int(args[1], 255, line_no), \
+        parse_int(args[2], 255, line_no), args[3:]
+
+
+def parse_int(text, limit, line_no):
+    try:
+        value = int(text, 0)
+    except ValueError:
+        raise ScriptError(f'第{line_no}行: 不是数字: {text}')
+    if not 0 <= value <= limit:
+        raise ScriptError(f'第{line_no}行: {value} 超出范围 0-{limit}')
+    return value
+
+
+def parse_state(text, line_no):
+    if text in STATES:
+        return STATES[text]
+    return parse_int(text, 31, line_no)
+
+
+def compile_text(text):
+    """文本 -> 代码字节 (不含头)。两遍：先定地址，再填跳转"""
+    ins = []            # (行号, 名字, 操作数列表, 需要解析的标签)
+    labels = {}
+    pc = 0
+    loops = []          # repeat之后那条指令的地址
+
+    for line_no, raw in enumerate(text.splitlines(), 1):
+        line = raw.split(';', 1)[0].strip()
+        if not line:
+            continue
+
+        if line.endswith(':'):
+            name = line[:-1].strip()
+            if name in labels:
+                raise ScriptError(f'第{line_no}行: 标签重复: {name}')
+            labels[name] = pc
+            continue
+
+        words = line.split()
+        op, args = words[0].lower(), words[1:]
+        if op not in OPS:
+            raise ScriptError(f'第{line_no}行: 未知指令: {op}')
+
+        operands, label = [], None
+        if op in ('set', 'fade'):
+            r, g, b, args = parse_color(args, line_no)
+            operands = [r, g, b]
+            if op == 'fade':
+                if len(args) != 1:
+                    raise ScriptError(f'第{line_no}行: fade 要写时长')
+                operands.append(parse_int(args[0], 65535, line_no))
+        elif op == 'wait':
+            operands = [parse_int(args[0], 65535, line_no)]
+        elif op == 'light':
+            operands = [parse_int(args[0], 255, line_no), parse_int(args[1], 65535, line_no)]
+        elif op == 'repeat':
+            count = parse_int(args[0], 255, line_no)
+            if count == 0:
+                raise ScriptError(f'第{line_no}行: repeat 至少1次')
+            operands = [count]
+            if len(loops) >= MAX_DEPTH:
+                raise ScriptError(f'第{line_no}行: repeat 嵌套超过{MAX_DEPTH}层')
+            loops.append(pc + 2)
+        elif op == 'next':
+            if not loops:
+                raise ScriptError(f'第{line_no}行: next 没有对应的 repeat')
+            operands = [loops.pop()]
+        elif op == 'jump':
+            label = args[0]
+            operands = [0]
+        elif op in ('if', 'ifnot'):
+            label = args[1]
+            operands = [parse_state(args[0], line_no), 0]
+
+        ins.append((line_no, op, operands, label))
+        pc += 1 + struct.calcsize('<' + OPS[op][1])
+
+    if loops:
+        raise ScriptError('repeat 没有 next')
+
+    code = bytearray()
+    for line_no, op, operands, label in ins:
+        if label is not None:
+            if label not in labels:
+                raise ScriptError(f'第{line_no}行: 找不到标签: {label}')
+            operands[-1] = labels[label]
+        opcode, fmt = OPS[op]
+        code.append(opcode)
+        code += struct.pack('<' + fmt, *operands)
+
+    if not code:
+        raise ScriptError('脚本是空的')
+    if len(code) > MAX_CODE:
+        raise ScriptError(f'代码 {len(code)} 字节，超过上限 {MAX_CODE}')
+    return bytes(code)
+
+
+def pack(code):
+    return HEADER.pack(MAGIC, VERSION, 0, len(code)) + code
+
+
+def disassemble(image):
+    magic, version, _, size = HEADER.unpack_from(image)
+    if magic != MAGIC or version != VERSION or size + HEADER.size != len(image):
+        raise ScriptError('不是有效的 .lsc 文件')
+    code = image[HEADER.size:]
+    lines = []
+    pc = 0
+    while pc < len(code):
+        opcode = code[pc]
+        if opcode not in NAMES:
+            raise ScriptError(f'{pc}: 未知操作码 0x{opcode:02x}')
+        name, fmt = NAMES[opcode]
+        operands = struct.unpack_from('<' + fmt, code, pc + 1)
+        lines.append(f'{pc:4d}  {name:<6} ' + ' '.join(str(v) for v in operands))
+        pc += 1 + struct.calcsize('<' + fmt)
+    return lines
+
+
+def cmd_compile(args):
+    for src in args.inputs:
+        src = Path(src)
+        out = Path(args.output) / (src.stem + '.lsc') if args.output else src.with_suffix('.lsc')
+        try:
+            code = compile_text(src.read_text(encoding='utf-8'))
+        except ScriptError as e:
+            sys.exit(f'❌ {src}: {e}')
+        out.parent.mkdir(parents=True, exist_ok=True)
+        out.write_bytes(pack(code))
+        print(f'✅ {src} -> {out} ({len(code)} 字节代码)')
+
+
+def cmd_dump(args):
+    try:
+        for line in disassemble(Path(args.script).read_bytes()):
+            print(line)
+    except ScriptError as e:
+        sys.exit(f'❌ {e}')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='ESP32-S3 HoloCubic LED动画脚本编译器')
+    sub = parser.add_subparsers(dest='command', required=True)
+
+    p = sub.add_parser('compile', help='文本 -> .lsc')
+    p.add_argument('inputs', nargs='+')
+    p.add_argument('-o', '--output', help='输出目录，默认和源文件放一起')
+    p.set_defaults(func=cmd_compile)
+
+    p = sub.add_parser('dump', help='反汇编 .lsc')
+    p.add_argument('script')
+    p.set_defaults(func=cmd_dump)
+
+    args = parser.parse_args()
+    args.func(args)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,418 @@
+#!/usr/bin/env python3
+"""
+ESP32-S3 HoloCubic 二进制串口协议客户端
+Linus风格：文本给人看，帧给程序用 - 同一个USB CDC口
+
+格式与 src/app/interface/link_proto.h 一致：
+  线上    00 <COBS(msg flags seq ack payload crc16)> 00
+  crc16   CRC-16/CCITT-FALSE，小端
+  窗口    主机发的请求带序号，最多8帧没确认；超时或重复确认就从最早没确认的那帧重发
+
+帧外的字节是设备的文本输出，原样打到stderr。
+不需要pyserial：串口和pty都用termios设成raw直接读写。
+
+功能：
+1. metrics - 取一次设备统计
+2. fb      - 上传一张图到屏幕 (PNG/JPG要Pillow，.raw是本机字节序的BGR565)
+3. put     - 写文件到SPIFFS或SD卡
+4. bench   - 回显和整屏上传的吞吐量 (MB/s)
+
+回环测试：link_bench --serve 在pty上跑设备端，打印pty路径
+  .pio/build/native_link_bench/program --serve &
+  python3 scripts/7_usb_link.py /dev/pts/N bench
+"""
+
+import argparse
+import binascii
+import os
+import select
+import struct
+import sys
+import termios
+import time
+import tty
+from pathlib import Path
+
+ESCAPE = 0x00
+PAYLOAD_MAX = 1024
+WINDOW = 8
+FLAG_SEQ = 0x01
+RESEND_S = 0.1
+TIMEOUT_S = 3.0
+
+MSG_ACK = 0x01
+MSG_PING = 0x02
+MSG_PONG = 0x03
+MSG_STATUS = 0x04
+MSG_METRICS_GET = 0x10
+MSG_METRICS = 0x11
+MSG_FB_BEGIN = 0x20
+MSG_FB_DATA = 0x21
+MSG_FB_END = 0x22
+MSG_FILE_OPEN = 0x30
+MSG_FILE_DATA = 0x31
+MSG_FILE_CLOSE = 0x32
+
+STATUS_NAMES = ['ok', 'bad request', 'unknown message', 'file system not mounted', 'file I/O failed',
+                'out of memory']
+
+FS_SPIFFS = 0
+FS_SD = 1
+
+# usb_link_metric_t的顺序；模块名是app_prof_id_t的顺序
+METRIC_NAMES = [
+    'uptime_ms', 'heap_free', 'psram_free', 'frames', 'frames_skipped', 'frame_interval_p99_us',
+    'render_p99_us', 'flush_p99_us', 'inbox_posted', 'inbox_dropped', 'command_lines',
+    'link_rx_bytes', 'link_frames', 'link_errors', 'link_resent',
+] + ['p99_us.' + name for name in
+     ('render', 'flush', 'inbox', 'events', 'wifi_led', 'led', 'wifi', 'command', 'heartbeat')]
+
+SCREEN_W = 240
+SCREEN_H = 240
+
+
+class LinkError(Exception):
+    pass
+
+
+def crc16(data):
+    return binascii.crc_hqx(data, 0xFFFF)
+
+
+def cobs_encode(data):
+    out = bytearray()
+    for block in data.split(b'\0'):
+        while len(block) >= 254:
+            out.append(0xFF)
+            out += block[:254]
+            block = block[254:]
+        out.append(len(block) + 1)
+        out += block
+    return bytes(out)
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            raise LinkError('bad COBS')
+        out += data[i + 1:i + code]
+        i += code
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def encode_frame(msg, payload=b'', seq=0, flags=0, ack=0):
+    if len(payload) > PAYLOAD_MAX:
+        raise LinkError('payload too long')
+    raw = bytes((msg, flags, seq, ack)) + payload
+    raw += struct.pack('<H', crc16(raw))
+    return b'\0' + cobs_encode(raw) + b'\0'
+
+
+def decode_frame(body):
+    raw = cobs_decode(body)
+    if len(raw) < 6 or len(raw) > 6 + PAYLOAD_MAX:
+        raise LinkError('bad length')
+    if crc16(raw[:-2]) != struct.unpack('<H', raw[-2:])[0]:
+        raise LinkError('bad CRC')
+    return raw[0], raw[1], raw[2], raw[3], raw[4:-2]
+
+
+def open_port(path):
+    fd = os.open(path, os.O_RDWR | os.O_NOCTTY | os.O_NONBLOCK)
+    if os.isatty(fd):
+        tty.setraw(fd, termios.TCSANOW)
+    return fd
+
+
+class Link:
+    """一个串口上的帧收发 - 文本打到stderr，回复排队"""
+
+    def __init__(self, fd):
+        self.fd = fd
+        self.rx = bytearray()
+        self.in_frame = False
+        self.base = 0
+        self.next = 0
+        self.unacked = {}             # seq -> 线上字节
+        self.progress = time.monotonic()
+        self.fast_base = None
+        self.replies = []
+        self.resent = 0
+        self.errors = 0
+        self.tx_bytes = 0
+        os.write(fd, b'\0\0')          # 对方在帧里帧外都回到帧开头
+
+    def write(self, data):
+        view = memoryview(data)
+        while view:
+            try:
+                n = os.write(self.fd, view)
+            except BlockingIOError:
+                select.select([], [self.fd], [], 0.1)
+                continue
+            view = view[n:]
+        self.tx_bytes += len(data)
+
+    def send(self, msg, payload=b''):
+        self.write(encode_frame(msg, payload))
+
+    def send_seq(self, msg, payload=b''):
+        while self.next - self.base >= WINDOW:
+            self.poll(0.01)
+        seq = self.next & 0xFF
+        wire = encode_frame(msg, payload, seq=seq, flags=FLAG_SEQ)
+        if not self.unacked:
+            self.progress = time.monotonic()
+        self.unacked[seq] = wire
+        self.next += 1
+        self.write(wire)
+
+    def resend(self):
+        for n in range(self.base, self.next):
+            self.write(self.unacked[n & 0xFF])
+            self.resent += 1
+        self.progress = time.monotonic()
+
+    def on_frame(self, msg, ack, payload):
+        newly = (ack - self.base) & 0xFF
+        in_flight = self.next - self.base
+        if 0 < newly <= in_flight:
+            for n in range(self.base, self.base + newly):
+                self.unacked.pop(n & 0xFF, None)
+            self.base += newly
+            self.progress = time.monotonic()
+            self.fast_base = None
+        elif msg == MSG_ACK and in_flight and self.fast_base != self.base:
+            # 重复确认 - 对方丢了最早那帧，整个窗口重发一次
+            self.fast_base = self.base
+            self.resend()
+        if msg != MSG_ACK:
+            self.replies.append((msg, payload))
+
+    def poll(self, timeout):
+        ready, _, _ = select.select([self.fd], [], [], timeout)
+        if ready:
+            try:
+                data = os.read(self.fd, 65536)
+            except BlockingIOError:
+                data = b''
+            self.feed(data)
+        if self.next != self.base and time.monotonic() - self.progress > RESEND_S:
+            self.resend()
+
+    def feed(self, data):
+        pos = 0
+        while pos < len(data):
+            if not self.in_frame:
+                at = data.find(b'\0', pos)
+                end = len(data) if at < 0 else at
+                if end > pos:
+                    sys.stderr.buffer.write(data[pos:end])
+                    sys.stderr.flush()
+                if at < 0:
+                    return
+                self.in_frame = True
+                self.rx.clear()
+                pos = at + 1
+                continue
+            at = data.find(b'\0', pos)
+            if at < 0:
+                self.rx += data[pos:]
+                return
+            self.rx += data[pos:at]
+            pos = at + 1
+            if not self.rx:
+                continue                # 空帧 - 还在帧里
+            self.in_frame = False
+            try:
+                msg, _, _, ack, payload = decode_frame(bytes(self.rx))
+            except LinkError:
+                self.errors += 1
+                continue
+            self.on_frame(msg, ack, payload)
+
+    def reply(self, timeout=TIMEOUT_S):
+        until = time.monotonic() + timeout
+        while not self.replies:
+            if time.monotonic() > until:
+                raise LinkError('no reply from device')
+            self.poll(0.01)
+        return self.replies.pop(0)
+
+    def status(self, want_msg, timeout=TIMEOUT_S):
+        while True:
+            msg, payload = self.reply(timeout)
+            if msg != MSG_STATUS:
+                continue
+            req, code, value = struct.unpack('<BBI', payload)
+            if code != 0:
+                name = STATUS_NAMES[code] if code < len(STATUS_NAMES) else str(code)
+                raise LinkError('request 0x%02x failed: %s (value %d)' % (req, name, value))
+            if req == want_msg:
+                return value
+
+    def drain(self, timeout=TIMEOUT_S):
+        until = time.monotonic() + timeout
+        while self.next != self.base:
+            if time.monotonic() > until:
+                raise LinkError('device stopped acknowledging')
+            self.poll(0.01)
+
+
+def metrics(link):
+    link.send(MSG_METRICS_GET)
+    while True:
+        msg, payload = link.reply()
+        if msg == MSG_METRICS:
+            break
+    version, count = payload[0], payload[1]
+    values = struct.unpack('<%dI' % count, payload[2:2 + 4 * count])
+    result = {}
+    for i, value in enumerate(values):
+        result[METRIC_NAMES[i] if i < len(METRIC_NAMES) else 'metric%d' % i] = value
+    return version, result
+
+
+def upload_fb(link, pixels, x, y, w, h, wait=True):
+    """pixels: 本机字节序的BGR565，w*h*2字节"""
+    link.send_seq(MSG_FB_BEGIN, struct.pack('<hhhh', x, y, w, h))
+    chunk = PAYLOAD_MAX - 4
+    for offset in range(0, len(pixels), chunk):
+        link.send_seq(MSG_FB_DATA, struct.pack('<I', offset) + pixels[offset:offset + chunk])
+    link.send_seq(MSG_FB_END)
+    if wait:
+        return link.status(MSG_FB_END)
+    return None
+
+
+def put_file(link, data, remote, fs):
+    path = remote.encode()
+    link.send_seq(MSG_FILE_OPEN, struct.pack('<BBI', fs, 0, len(data)) + path)
+    link.status(MSG_FILE_OPEN)
+    chunk = PAYLOAD_MAX - 4
+    for offset in range(0, len(data), chunk):
+        link.send_seq(MSG_FILE_DATA, struct.pack('<I', offset) + data[offset:offset + chunk])
+    link.send_seq(MSG_FILE_CLOSE)
+    return link.status(MSG_FILE_CLOSE, timeout=30.0)
+
+
+def image_to_bgr565(path, w, h):
+    if path.suffix.lower() == '.raw':
+        data = path.read_bytes()
+        if len(data) != w * h * 2:
+            raise LinkError('%s: %d bytes, expected %d for %dx%d' % (path, len(data), w * h * 2, w, h))
+        return data
+    try:
+        from PIL import Image
+    except ImportError:
+        raise LinkError('PNG/JPG need Pillow (pip install pillow); .raw works without it')
+    img = Image.open(path).convert('RGB').resize((w, h))
+    out = bytearray()
+    for r, g, b in img.getdata():
+        out += struct.pack('<H', ((b >> 3) << 11) | ((g >> 2) << 5) | (r >> 3))
+    return bytes(out)
+
+
+def bench_pixels(frame):
+    # 和link_bench_main.cpp的test_pixel()一样，--serve的设备端逐像素核对
+    return struct.pack('<%dH' % (SCREEN_W * SCREEN_H),
+                       *(((frame * 2654435761) + i * 40503) & 0xFFFF for i in range(SCREEN_W * SCREEN_H)))
+
+
+def cmd_metrics(link, args):
+    version, values = metrics(link)
+    print('metrics version %d, %d values' % (version, len(values)))
+    for name, value in values.items():
+        print('  %-24s %u' % (name, value))
+
+
+def cmd_fb(link, args):
+    pixels = image_to_bgr565(Path(args.image), args.w, args.h)
+    t0 = time.monotonic()
+    upload_fb(link, pixels, args.x, args.y, args.w, args.h)
+    spent = time.monotonic() - t0
+    print('%s: %d bytes in %.3f s (%.2f MB/s)' % (args.image, len(pixels), spent, len(pixels) / spent / 1e6))
+
+
+def cmd_put(link, args):
+    data = Path(args.local).read_bytes()
+    t0 = time.monotonic()
+    written = put_file(link, data, args.remote, FS_SD if args.sd else FS_SPIFFS)
+    spent = time.monotonic() - t0
+    print('%s -> %s%s: %d bytes in %.3f s (%.1f KB/s)' % (args.local, 'sd:' if args.sd else 'spiffs:',
+                                                          args.remote, written, spent, written / spent / 1e3))
+
+
+def cmd_bench(link, args):
+    payload = bytes(range(256)) * (PAYLOAD_MAX // 256)
+    t0 = time.monotonic()
+    sent = received = 0
+    while received < args.pings:
+        while sent < args.pings and sent - received < WINDOW:
+            link.send(MSG_PING, payload)
+            sent += 1
+        msg, reply = link.reply()
+        if msg == MSG_PONG:
+            if reply != payload:
+                raise LinkError('echo: wrong payload')
+            received += 1
+    spent = time.monotonic() - t0
+    print('echo    %8.2f MB/s each way   %d pings' % (args.pings * len(payload) / spent / 1e6, args.pings))
+
+    frames = [bench_pixels(f) for f in range(args.frames)]
+    resent0 = link.resent
+    t0 = time.monotonic()
+    for pixels in frames:
+        upload_fb(link, pixels, 0, 0, SCREEN_W, SCREEN_H, wait=False)
+    for _ in frames:
+        link.status(MSG_FB_END)
+    spent = time.monotonic() - t0
+    total = len(frames) * SCREEN_W * SCREEN_H * 2
+    print('upload  %8.2f MB/s %8.1f fps   %d images, %d frames resent' % (
+        total / spent / 1e6, len(frames) / spent, len(frames), link.resent - resent0))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='ESP32-S3 HoloCubic 二进制串口协议客户端')
+    parser.add_argument('port', help='串口或pty，如 /dev/ttyACM0')
+    sub = parser.add_subparsers(dest='cmd', required=True)
+
+    sub.add_parser('metrics', help='取一次设备统计')
+
+    p = sub.add_parser('fb', help='上传一张图到屏幕')
+    p.add_argument('image', help='PNG/JPG，或本机字节序BGR565的.raw')
+    p.add_argument('--x', type=int, default=0)
+    p.add_argument('--y', type=int, default=0)
+    p.add_argument('--w', type=int, default=SCREEN_W)
+    p.add_argument('--h', type=int, default=SCREEN_H)
+
+    p = sub.add_parser('put', help='写文件到SPIFFS或SD卡')
+    p.add_argument('local')
+    p.add_argument('remote', help='设备上的路径，以/开头')
+    p.add_argument('--sd', action='store_true', help='写SD卡 (默认SPIFFS)')
+
+    p = sub.add_parser('bench', help='回显和整屏上传的吞吐量')
+    p.add_argument('--pings', type=int, default=500)
+    p.add_argument('--frames', type=int, default=20)
+
+    args = parser.parse_args()
+    fd = open_port(args.port)
+    try:
+        link = Link(fd)
+        {'metrics': cmd_metrics, 'fb': cmd_fb, 'put': cmd_put, 'bench': cmd_bench}[args.cmd](link, args)
+        link.drain()
+        return 0
+    except LinkError as e:
+        print('错误: %s' % e, file=sys.stderr)
+        return 1
+    finally:
+        os.close(fd)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
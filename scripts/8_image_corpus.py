@@ -0,0 +1,295 @@
+#!/usr/bin/env python3
+"""
+ESP32-S3 HoloCubic 图像解码测试语料生成器
+Linus风格：语料生成一次提交进仓库，主机测试只读文件，不依赖Pillow
+
+生成 scripts/images/ 下的：
+  *.png / *.jpg   测试图像 - 小尺寸、奇数宽高，覆盖解码器支持的每种格式
+  *.rgb           参考像素 - RGB888逐行，透明度已经按解码器的规则混到黑色上
+                  整屏的两张只测吞吐量，不带参考像素，免得仓库里多几百KB
+  corpus.txt      清单 - 文件名、期望结果、允许的误差(RGB565单位，最大/平均)
+
+PNG用自己的编码器写，每行轮流用5种滤波器，参考像素直接来自生成的样本值：
+  16位取高字节，1/2/4位灰度放大到0-255，透明度 c*a/255 四舍五入
+JPEG用Pillow(libjpeg)编码，参考像素是Pillow解出来的结果，解码器的IDCT和上采样不同，所以有误差
+
+坏文件：截断的、改坏的 - 期望解码器返回错误而不是崩溃或写出界
+
+用法：
+  python3 scripts/8_image_corpus.py              # 重新生成 scripts/images/
+  python3 scripts/8_image_corpus.py --out DIR
+"""
+
+import argparse
+import io
+import struct
+import sys
+import zlib
+from pathlib import Path
+
+try:
+    from PIL import Image
+except ImportError:
+    Image = None
+
+W, H = 37, 23               # 奇数宽高 - 覆盖MCU和字节边界
+BIG = 240                   # 吞吐量用的整屏图像
+
+# JPEG允许的误差 "最大/平均"，RGB565单位 - 参考用libjpeg的平滑色度上采样，解码器是复制，色度抽样的误差大
+# Allowed JPEG error "max/mean" in RGB565 steps - the reference uses libjpeg's smooth chroma upsampling, the
+# decoder replicates, so subsampled chroma differs more
+JPEG_TOLERANCE = {'jpg_gray.jpg': '2/0.05', 'jpg_444.jpg': '2/0.2', 'jpg_422.jpg': '10/2.0',
+                  'jpg_420.jpg': '14/3.0', 'jpg_restart.jpg': '14/3.0'}
+
+
+# ========================================
+# 样本 - 固定的伪随机数，每次生成结果相同
+# ========================================
+
+def lcg(seed):
+    state = seed & 0xFFFFFFFF
+    while True:
+        state = (state * 1664525 + 1013904223) & 0xFFFFFFFF
+        yield state >> 24
+
+
+def pattern(w, h, channels, maxval, seed, noise_max=16):
+    """渐变加一点噪声 - 滤波器和压缩都有事可做"""
+    noise = lcg(seed)
+    rows = []
+    for y in range(h):
+        row = []
+        for x in range(w):
+            for c in range(channels):
+                v = (x * (c + 1) * 7 + y * (3 - c % 3) * 11 + next(noise) % noise_max) % 256
+                row.append(v * maxval // 255)
+        rows.append(row)
+    return rows
+
+
+# ========================================
+# PNG编码器
+# ========================================
+
+def png_chunk(kind, data):
+    body = kind + data
+    return struct.pack('>I', len(data)) + body + struct.pack('>I', zlib.crc32(body) & 0xFFFFFFFF)
+
+
+def pack_row(samples, depth):
+    if depth == 16:
+        return b''.join(struct.pack('>H', s) for s in samples)
+    if depth == 8:
+        return bytes(samples)
+    out, acc, bits = bytearray(), 0, 0
+    for s in samples:
+        acc = (acc << depth) | s
+        bits += depth
+        if bits == 8:
+            out.append(acc)
+            acc, bits = 0, 0
+    if bits:
+        out.append(acc << (8 - bits))
+    return bytes(out)
+
+
+def paeth(a, b, c):
+    p = a + b - c
+    pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+    if pa <= pb and pa <= pc:
+        return a
+    return b if pb <= pc else c
+
+
+def png_filter(kind, row, prev, bpp):
+    out = bytearray([kind])
+    for i, v in enumerate(row):
+        a = row[i - bpp] if i >= bpp else 0
+        b = prev[i]
+        c = prev[i - bpp] if i >= bpp else 0
+        pred = (0, a, b, (a + b) // 2, paeth(a, b, c))[kind]
+        out.append((v - pred) & 0xFF)
+    return bytes(out)
+
+
+def png_encode(rows, w, h, color_type, depth, palette=None, trns=None, level=9, idat_split=0, interlace=0):
+    channels = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}[color_type]
+    bpp = max(1, channels * depth // 8)
+    raw, prev = bytearray(), bytes((w * channels * depth + 7) // 8)
+    for y, samples in enumerate(rows):
+        row = pack_row(samples, depth)
+        raw += png_filter(y % 5, row, prev, bpp)
+        prev = row
+    data = zlib.compress(bytes(raw), level)
+
+    out = b'\x89PNG\r\n\x1a\n'
+    out += png_chunk(b'IHDR', struct.pack('>IIBBBBB', w, h, depth, color_type, 0, 0, interlace))
+    if palette:
+        out += png_chunk(b'PLTE', b''.join(bytes(c) for c in palette))
+    if trns:
+        out += png_chunk(b'tRNS', bytes(trns))
+    parts = [data[i:i + idat_split] for i in range(0, len(data), idat_split)] if idat_split else [data]
+    for part in parts:
+        out += png_chunk(b'IDAT', part)
+    return out + png_chunk(b'IEND', b'')
+
+
+def over_black(c, a):
+    return (c * a + 127) // 255
+
+
+def png_reference(rows, w, color_type, depth, palette=None, trns=None):
+    """按PNG规范和解码器的透明度规则算参考像素"""
+    out = bytearray()
+    scale = 255 // ((1 << depth) - 1) if depth < 8 else 1
+    for samples in rows:
+        for x in range(w):
+            if depth == 16:
+                s = [v >> 8 for v in samples]
+            else:
+                s = samples
+            a = 255
+            if color_type == 0:
+                r = g = b = s[x] * scale
+            elif color_type == 2:
+                r, g, b = s[3 * x:3 * x + 3]
+            elif color_type == 3:
+                r, g, b = palette[s[x]]
+                a = trns[s[x]] if trns and s[x] < len(trns) else 255
+            elif color_type == 4:
+                r = g = b = s[2 * x]
+                a = s[2 * x + 1]
+            else:
+                r, g, b, a = s[4 * x:4 * x + 4]
+            if a != 255:
+                r, g, b = over_black(r, a), over_black(g, a), over_black(b, a)
+            out += bytes((r, g, b))
+    return bytes(out)
+
+
+def png_case(name, color_type, depth, seed, **kw):
+    channels = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}[color_type]
+    maxval = (1 << depth) - 1
+    palette = trns = None
+    if color_type == 3:
+        colors = 1 << depth
+        palette = [((i * 37) % 256, (i * 91) % 256, (i * 53 + 17) % 256) for i in range(colors)]
+        trns = [(i * 29) % 256 for i in range(colors // 2)] if kw.pop('alpha', False) else None
+    rows = pattern(W, H, channels, maxval, seed)
+    data = png_encode(rows, W, H, color_type, depth, palette, trns, **kw)
+    return name, data, png_reference(rows, W, color_type, depth, palette, trns)
+
+
+# ========================================
+# JPEG - Pillow编码
+# ========================================
+
+def jpeg_case(name, w, h, mode, seed, **kw):
+    channels = 1 if mode == 'L' else 3
+    rows = pattern(w, h, channels, 255, seed)
+    img = Image.frombytes(mode, (w, h), bytes(v for row in rows for v in row))
+    buf = io.BytesIO()
+    img.save(buf, 'JPEG', quality=90, **kw)
+    data = buf.getvalue()
+    ref = Image.open(io.BytesIO(data)).convert('RGB').tobytes()
+    return name, data, ref
+
+
+# ========================================
+# 语料
+# ========================================
+
+def corrupt_png(data):
+    """第一个IDAT的deflate块类型改成保留值3"""
+    i = data.index(b'IDAT') + 4 + 2          # 跳过zlib头
+    return data[:i] + bytes([data[i] | 0x06]) + data[i + 1:]
+
+
+def corrupt_jpeg_dht(data):
+    """第一张哈夫曼表的码长计数加起来超过256"""
+    i = data.index(b'\xff\xc4') + 5
+    return data[:i] + b'\xff' * 16 + data[i + 16:]
+
+
+def corrupt_jpeg_dht_oversubscribed(data):
+    """第一张哈夫曼表的码数不变，全挤到长度1 - 总数合法但码空间放不下，短码查找表会写越界"""
+    i = data.index(b'\xff\xc4') + 5
+    total = sum(data[i:i + 16])
+    return data[:i] + bytes([total]) + bytes(15) + data[i + 16:]
+
+
+def build(out):
+    if Image is None:
+        sys.exit('需要Pillow: pip install pillow')
+    out.mkdir(parents=True, exist_ok=True)
+
+    cases = [
+        png_case('png_gray1.png', 0, 1, 1),
+        png_case('png_gray2.png', 0, 2, 2),
+        png_case('png_gray4.png', 0, 4, 3),
+        png_case('png_gray8.png', 0, 8, 4),
+        png_case('png_gray16.png', 0, 16, 5),
+        png_case('png_rgb8.png', 2, 8, 6),
+        png_case('png_rgb16.png', 2, 16, 7),
+        png_case('png_pal4.png', 3, 4, 8, alpha=True),
+        png_case('png_pal8.png', 3, 8, 9),
+        png_case('png_graya8.png', 4, 8, 10),
+        png_case('png_rgba8.png', 6, 8, 11),
+        png_case('png_rgba16.png', 6, 16, 12),
+        png_case('png_stored.png', 2, 8, 13, level=0),
+        png_case('png_split.png', 2, 8, 14, idat_split=97),
+        jpeg_case('jpg_gray.jpg', W, H, 'L', 20),
+        jpeg_case('jpg_444.jpg', W, H, 'RGB', 21, subsampling=0),
+        jpeg_case('jpg_422.jpg', W, H, 'RGB', 22, subsampling=1),
+        jpeg_case('jpg_420.jpg', W, H, 'RGB', 23, subsampling=2),
+        jpeg_case('jpg_restart.jpg', W, H, 'RGB', 24, subsampling=2, restart_marker_blocks=3),
+    ]
+    big = [
+        ('png_big.png', png_encode(pattern(BIG, BIG, 3, 255, 30, 1), BIG, BIG, 2, 8)),
+        ('jpg_big.jpg', jpeg_case('', BIG, BIG, 'RGB', 31, subsampling=2)[1]),
+    ]
+
+    manifest = ['# 文件 期望结果 误差(RGB565单位，最大/平均，-表示不比像素)',
+                '# 结果: ok format unsupported memory io corrupt']
+    for name, data, ref in cases:
+        (out / name).write_bytes(data)
+        (out / (Path(name).stem + '.rgb')).write_bytes(ref)
+        manifest.append(f'{name} ok {JPEG_TOLERANCE.get(name, 0)}')
+    for name, data in big:
+        (out / name).write_bytes(data)
+        manifest.append(f'{name} ok -')
+
+    png = dict((n, d) for n, d, _ in cases)['png_rgb8.png']
+    jpg = dict((n, d) for n, d, _ in cases)['jpg_420.jpg']
+    progressive = io.BytesIO()
+    Image.open(io.BytesIO(jpg)).save(progressive, 'JPEG', quality=90, progressive=True)
+    interlaced = png_encode(pattern(W, H, 3, 255, 6), W, H, 2, 8, interlace=1)
+
+    bad = [
+        ('bad_png_trunc.png', png[:len(png) // 2], 'io'),
+        ('bad_jpg_trunc.jpg', jpg[:len(jpg) // 2], 'io'),
+        ('bad_png_deflate.png', corrupt_png(png), 'corrupt'),
+        ('bad_jpg_dht.jpg', corrupt_jpeg_dht(jpg), 'corrupt'),
+        ('bad_jpg_dht_oversub.jpg', corrupt_jpeg_dht_oversubscribed(jpg), 'corrupt'),
+        ('bad_jpg_progressive.jpg', progressive.getvalue(), 'unsupported'),
+        ('bad_png_interlaced.png', interlaced, 'unsupported'),
+        ('bad_format.bin', b'GIF89a' + bytes(64), 'format'),
+    ]
+    for name, data, result in bad:
+        (out / name).write_bytes(data)
+        manifest.append(f'{name} {result} -')
+
+    (out / 'corpus.txt').write_text('\n'.join(manifest) + '\n')
+    total = sum((out / line.split()[0]).stat().st_size for line in manifest if not line.startswith('#'))
+    print(f'✅ {len(cases) + len(big) + len(bad)} 个文件, {total} 字节 -> {out}')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='ESP32-S3 HoloCubic 图像解码测试语料生成器')
+    parser.add_argument('--out', type=Path, default=Path(__file__).parent / 'images', help='输出目录')
+    args = parser.parse_args()
+    build(args.out)
+
+
+if __name__ == '__main__':
+    main()
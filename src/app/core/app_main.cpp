@@ -4,67 +4,433 @@
 
 #include "app_main.h"
 #include "../../core/config/app_constants.h"
+#include "../../core/config/hardware_config.h"
+#include "../../core/state/system_state.h"
+#include "../../drivers/display/display_driver.h"
 #include "../interface/command_handler.h"
+#include "../interface/usb_link.h"
 #include "../managers/led_manager.h"
+#include "../managers/led_script_fs.h"
 #include "../monitoring/heartbeat.h"
 #include "../network/wifi_app.h"
+#include "../../system/panic.h"
+#include "app_config.h"
+#include "app_profile.h"
+#include "app_trace.h"
+#include "../../system/serial_out.h"
 #include <Arduino.h>
+#include <SPIFFS.h>
+#include <esp_timer.h>
+#include <string.h>
 
 //** 简单的全局变量
 
 uint32_t g_app_start_time = 0;
 
+//** 帧节拍 - 渲染只在这里发生，其他模块不再各自看millis()刷屏
+static frame_pacer_t frame_pacer;
+static app_render_fn frame_render = NULL;
+static display_fence_t frame_fence = 0;
+static bool frame_blocked = false;          // 到期了但上一帧还在传 - 刷新完成时叫醒帧任务
+
+//** 状态灯动画 - SPIFFS里有 /anim/status.lsc 就替换下面写死的WiFi闪烁
+static uint8_t status_file[LED_SCRIPT_HEADER_SIZE + LED_SCRIPT_MAX_CODE];
+static led_script_t status_script;
+static bool status_scripted = false;
+
+static void app_backlight(uint8_t level) {
+  display_backlight(level / (float)PWM_MAX_VALUE);
+}
+
+//** 脚本分支用的状态位
+static uint32_t app_led_state(wifi_state_t wifi) {
+  uint32_t state = 0;
+  if (wifi == WIFI_STATE_CONNECTED) state |= 1u << LED_STATE_WIFI_READY;
+  if (wifi == WIFI_STATE_CONNECTING) state |= 1u << LED_STATE_WIFI_BUSY;
+  if (wifi == WIFI_STATE_FAILED) state |= 1u << LED_STATE_WIFI_FAILED;
+  return state;
+}
+
+//** ========================================
+//** 双核循环 - 渲染核跑loop()，IO核跑app_io任务
+//** 调度器任务的返回值是相对于now_us多久以后再叫
+//** ========================================
+
+#if defined(ARDUINO_RUNNING_CORE) && ARDUINO_RUNNING_CORE == HW_CORE_IO
+#error "loop() 和 IO任务在同一个核上 - 检查 HW_CORE_IO"
+#endif
+
+//** 每个核一个循环：自己的调度器，睡眠时esp_timer到点或事件来了都用任务通知叫醒
+typedef struct {
+  app_sched_t sched;
+  TaskHandle_t task;
+  esp_timer_handle_t timer;
+} app_loop_t;
+
+static app_loop_t render_loop, io_loop;
+static int8_t task_display = -1, task_frame = -1, task_led = -1;  // 渲染核
+static int8_t task_inbox = -1, task_events = -1, task_wifi_led = -1;
+static int8_t task_command = -1;                                    // IO核
+
+static void app_wake(app_loop_t* loop, int8_t task) {
+  app_sched_signal(&loop->sched, task);
+  if (loop->task) xTaskNotifyGive(loop->task);
+}
+
+static void wake_timer_fired(void* arg) {
+  app_loop_t* loop = (app_loop_t*)arg;
+  if (loop->task) xTaskNotifyGive(loop->task);
+}
+
+static void app_loop_timer(app_loop_t* loop, const char* name) {
+  const esp_timer_create_args_t timer_args = { wake_timer_fired, loop, ESP_TIMER_TASK, name };
+  esp_timer_create(&timer_args, &loop->timer);
+}
+
+//** 睡到最近的截止时间或者事件来 - 最长APP_IDLE_MAX_MS，loop()里的健康检查照常进行
+static void app_loop_wait(app_loop_t* loop) {
+  uint32_t wait = app_sched_timeout_us(&loop->sched, micros());
+  if (wait == 0) {
+    return;
+  }
+  if (wait > APP_IDLE_MAX_MS * 1000) {
+    wait = APP_IDLE_MAX_MS * 1000;
+  }
+  esp_timer_start_once(loop->timer, wait);
+  ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+  esp_timer_stop(loop->timer);  // 被事件提前叫醒时定时器还在走
+}
+
+//** ========================================
+//** 渲染核收件箱 - 只有IO核往里放
+//** ========================================
+
+static app_msg_queue_t render_inbox;
+static app_msg_stats_t inbox_stats;
+static event_bus_t render_bus;      // 事件总线 - 在渲染核上分发，订阅者都在渲染核
+
+//** IO核调用 - 满了返回false，由调用者决定丢掉还是下次再发
+static bool app_post(const app_msg_t* msg) {
+  if (!render_inbox.push(*msg)) {
+    inbox_stats.dropped++;
+    return false;
+  }
+  inbox_stats.posted++;
+  uint32_t depth = render_inbox.size();
+  if (depth > inbox_stats.peak) inbox_stats.peak = depth;
+  app_wake(&render_loop, task_inbox);
+  return true;
+}
+
+static uint32_t app_inbox_task(uint32_t now_us, void* ctx) {
+  APP_PROF_SCOPE(APP_PROF_INBOX);
+  app_msg_t msg;
+  while (render_inbox.pop(&msg)) {
+    switch (msg.type) {
+    case APP_MSG_LED_REQUEST:
+      led_request(&msg.led);
+      break;
+    case APP_MSG_LED_RELEASE:
+      led_release(msg.priority);
+      break;
+    case APP_MSG_COMMAND:
+      command_handler_execute(msg.line);
+      break;
+    case APP_MSG_EVENT:
+      if (event_bus_post(&render_bus, &msg.event)) app_sched_signal(&render_loop.sched, task_events);
+      break;
+    case APP_MSG_BLIT:
+      display_blit(msg.blit.x, msg.blit.y, msg.blit.w, msg.blit.h, msg.blit.pixels);
+      usb_link_blit_done();
+      app_wake(&io_loop, task_command);    //** 可能有下一张在等
+      break;
+    default:
+      break;
+    }
+  }
+  return APP_SCHED_IDLE;
+}
+
+static bool app_forward_command(const char* line) {
+  app_msg_t msg = {};
+  msg.type = APP_MSG_COMMAND;
+  strncpy(msg.line, line, sizeof(msg.line) - 1);
+  return app_post(&msg);
+}
+
+static bool app_forward_blit(int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t* pixels) {
+  app_msg_t msg = {};
+  msg.type = APP_MSG_BLIT;
+  msg.blit.x = x;
+  msg.blit.y = y;
+  msg.blit.w = w;
+  msg.blit.h = h;
+  msg.blit.pixels = pixels;
+  return app_post(&msg);
+}
+
+//** ========================================
+//** 事件总线
+//** ========================================
+
+//** event_publish()的出口 - 渲染核上直接入队，IO核上经收件箱转过来
+//** 只能在两个循环任务里发布：收件箱只有一个生产者
+static void app_event_sink(event_t* event) {
+  event->time_us = micros();
+  if (xPortGetCoreID() == HW_CORE_IO) {
+    if (!(render_bus.wanted & EVENT_MASK(event->type))) return;   // 没人要的不占收件箱
+    app_msg_t msg = {};
+    msg.type = APP_MSG_EVENT;
+    msg.event = *event;
+    app_post(&msg);
+    return;
+  }
+  if (event_bus_post(&render_bus, event)) app_sched_signal(&render_loop.sched, task_events);
+}
+
+static uint32_t app_events_task(uint32_t now_us, void* ctx) {
+  {
+    APP_PROF_SCOPE(APP_PROF_EVENTS);
+    event_bus_dispatch(&render_bus, micros());
+  }
+  return event_bus_pending(&render_bus) ? 0 : APP_SCHED_IDLE;
+}
+
+//** ms时间戳到期还有多久 (us) - 模块自己用millis()比较，多等1ms保证它认为到期了
+static uint32_t app_until_ms(uint32_t last_ms, uint32_t interval_ms) {
+  uint32_t since = millis() - last_ms;
+  return since >= interval_ms ? 1000 : (interval_ms - since + 1) * 1000;
+}
+
+//** 刷新完成回调 - 在display_flush_poll()里调用；等着上一帧传完的帧任务这时叫醒
+static void frame_flush_done(display_fence_t fence, void* ctx) {
+  if ((int32_t)(fence - frame_fence) >= 0) {
+    frame_pacer_flushed(&frame_pacer, micros());
+    if (frame_blocked) app_sched_signal(&render_loop.sched, task_frame);
+  }
+}
+
+//** 推进异步显示刷新 - 在途的一带落地时再来，传完就只等下一帧叫醒
+static uint32_t app_display_task(uint32_t now_us, void* ctx) {
+  {
+    APP_PROF_SCOPE(APP_PROF_FLUSH);
+    display_flush_poll();
+  }
+  uint32_t wait = display_flush_wait_us();
+  return wait ? wait : APP_SCHED_IDLE;
+}
+
+//** 到期才渲染一帧：上一帧传完 -> 渲染 -> 异步提交刷新
+static uint32_t app_frame_task(uint32_t now_us, void* ctx) {
+  uint32_t wait = frame_pacer_wait_us(&frame_pacer, now_us);
+  if (wait) return wait;
+
+  //** 上一帧还在传 - 帧缓冲不能边传边画，刷新完成回调会叫醒
+  frame_blocked = !display_fence_reached(frame_fence);
+  if (frame_blocked) return APP_SCHED_IDLE;
+
+  frame_pacer_begin(&frame_pacer, micros());
+  if (frame_render) {
+    APP_PROF_SCOPE(APP_PROF_RENDER);
+    frame_render();
+  }
+  frame_pacer_rendered(&frame_pacer, micros());
+  frame_fence = display_flush_async();
+  app_sched_signal(&render_loop.sched, task_display);
+
+  //** 渲染完的时间算还要等多久，再换成相对now_us的 (调度器从now_us起算)；晚了就是渲染花掉的时间，下一次dispatch就跑
+  uint32_t done_us = micros();
+  return frame_pacer_wait_us(&frame_pacer, done_us) + (done_us - now_us);
+}
+
+static uint32_t app_wifi_task(uint32_t now_us, void* ctx) {
+  {
+    APP_PROF_SCOPE(APP_PROF_WIFI);
+    wifi_app_process();
+  }
+  return app_until_ms(wifi_app_get_state()->last_check, HW_WIFI_STATUS_CHECK_MS);
+}
+
+static uint32_t app_led_task(uint32_t now_us, void* ctx) {
+  {
+    APP_PROF_SCOPE(APP_PROF_LED);
+    led_process();
+  }
+  uint32_t next = led_next_ms();
+  return next == LED_NEXT_IDLE ? APP_SCHED_IDLE : next * 1000;
+}
+
+//** WiFi状态 - 从EVENT_WIFI_STATE来，不再去读wifi_app的结构体
+static wifi_state_t wifi_led_state = WIFI_STATE_IDLE;
+
+//** WiFi状态LED指示 - 低优先级，不会干扰测试；有状态灯脚本时由脚本负责
+static uint32_t app_wifi_led_task(uint32_t now_us, void* ctx) {
+  if (status_scripted) return APP_SCHED_IDLE;
+
+  APP_PROF_SCOPE(APP_PROF_WIFI_LED);
+  if (wifi_led_state == WIFI_STATE_CONNECTED) {
+    //** WiFi连接 - 绿色闪烁一次
+    led_set_blink(LED_PRIORITY_SYSTEM, LED_COLOR_MIN_VALUE, LED_COLOR_MAX_VALUE, LED_COLOR_MIN_VALUE, LED_BLINK_ON_MS,
+                  LED_BLINK_OFF_MS); // 原魔数: 0, 255, 0, 200, 200
+  } else {
+    //** WiFi未连接 - 红色闪烁一次
+    led_set_blink(LED_PRIORITY_SYSTEM, LED_COLOR_MAX_VALUE, LED_COLOR_MIN_VALUE, LED_COLOR_MIN_VALUE, LED_BLINK_ON_MS,
+                  LED_BLINK_OFF_MS); // 原魔数: 255, 0, 0, 200, 200
+  }
+  return WIFI_LED_UPDATE_INTERVAL_MS * 1000; // 每2秒更新一次 (原魔数: 2000)
+}
+
+//** WiFi状态变了 - 脚本状态位马上更新，闪烁指示不等下一个2秒
+static void app_on_wifi(const event_t* event, void* ctx) {
+  wifi_led_state = (wifi_state_t)event->arg;
+  led_set_state(app_led_state(wifi_led_state));
+  app_sched_signal(&render_loop.sched, task_wifi_led);
+}
+
+//** 串口命令 - 收到数据的事件叫醒；没有事件源的配置退回定时轮询
+static uint32_t app_command_task(uint32_t now_us, void* ctx) {
+  bool more;
+  {
+    APP_PROF_SCOPE(APP_PROF_COMMAND);
+    more = command_handler_process();
+  }
+  if (more) return 0;     //** 一次没收完 - 让同一轮的其他任务先跑，马上再来
+  if (usb_link_busy()) return APP_LINK_BUSY_POLL_US;
+#if ARDUINO_USB_CDC_ON_BOOT && ARDUINO_USB_MODE
+  return APP_SCHED_IDLE;
+#else
+  return APP_COMMAND_POLL_MS * 1000;
+#endif
+}
+
+#if ARDUINO_USB_CDC_ON_BOOT && ARDUINO_USB_MODE
+static void app_serial_rx(void* arg, esp_event_base_t base, int32_t id, void* data) {
+  app_wake(&io_loop, task_command);
+}
+#endif
+
+static uint32_t app_heartbeat_task(uint32_t now_us, void* ctx) {
+  {
+    APP_PROF_SCOPE(APP_PROF_HEARTBEAT);
+    heartbeat_process();
+  }
+  return app_until_ms(HEARTBEAT_STATE()->last_beat_ms, HEARTBEAT_STATE()->interval_ms);
+}
+
+static void app_led_wake(void) {
+  app_wake(&render_loop, task_led);
+}
+
+//** IO核 - 和loop()一样的循环，只是跑另一组任务
+static void app_io_main(void* arg) {
+  io_loop.task = xTaskGetCurrentTaskHandle();
+  for (;;) {
+    app_sched_dispatch(&io_loop.sched, micros());
+    app_loop_wait(&io_loop);
+  }
+}
+
+void app_set_render(app_render_fn render) {
+  frame_render = render;
+}
+
+frame_pacer_t* app_frame_pacer(void) {
+  return &frame_pacer;
+}
+
+app_sched_t* app_scheduler(app_loop_id_t loop) {
+  return loop == APP_LOOP_IO ? &io_loop.sched : &render_loop.sched;
+}
+
+const app_msg_stats_t* app_inbox_stats(void) {
+  return &inbox_stats;
+}
+
+event_bus_t* app_event_bus(void) {
+  return &render_bus;
+}
+
 void app_init(void) {
 
-  Serial.println("初始化应用模块...");
+  //** 串口锁最先建 - 从IO任务开始两个核都会打印
+  serial_out_init();
+  serial_out.println("初始化应用模块...");
+
+  //** 输入记录最先开 - 后面模块读到的输入都要记上
+  app_trace_init();
 
   //** WiFi应用初始化 - 只初始化，不连接
-  Serial.println("- WiFi应用");
+  serial_out.println("- WiFi应用");
   wifi_app_init();
 
   //** 应用模块初始化
-  Serial.println("- 命令处理器");
+  serial_out.println("- 命令处理器");
   command_handler_init();
+  command_handler_set_forward(app_forward_command);
+  usb_link_set_blit(app_forward_blit);
 
-  Serial.println("- 心跳监控");
+  serial_out.println("- 心跳监控");
   heartbeat_init();
 
-  Serial.println("✓ 应用模块初始化完成");
+  serial_out.println("- 状态灯动画");
+  led_set_backlight_output(app_backlight);
+  led_script_result_t result = led_script_load_file(SPIFFS, "/anim/status.lsc", status_file,
+                                                    sizeof(status_file), &status_script);
+  if (result == LED_SCRIPT_OK) {
+    status_scripted = led_set_script(LED_PRIORITY_SYSTEM, &status_script, 0);
+  } else if (result != LED_SCRIPT_ERR_IO) {
+    serial_out.printf("  /anim/status.lsc 无效 (%s)，使用内置\n", led_script_result_str(result));
+  }
 
-  g_app_start_time = millis();
-}
+  //** 事件总线 - 订阅要在IO核开始发布之前完成
+  serial_out.println("- 事件总线");
+  event_bus_init(&render_bus);
+  event_subscribe(&render_bus, EVENT_MASK(EVENT_WIFI_STATE), app_on_wifi, NULL);
+  event_set_sink(app_event_sink);
 
-void app_run(void) {
-  //** WiFi应用处理
-  wifi_app_process();
-
-  //** LED管理器处理
-  led_process();
-
-  //** WiFi状态LED指示 - 低优先级，不会干扰测试
-  static uint32_t last_wifi_led_update = 0;
-  uint32_t now = millis();
-
-  if (now - last_wifi_led_update >
-      WIFI_LED_UPDATE_INTERVAL_MS) { // 每2秒更新一次 (原魔数: 2000)
-    const wifi_app_t *wifi_state = wifi_app_get_state();
-    if (wifi_state->is_ready) {
-      //** WiFi连接 - 绿色闪烁一次
-      led_set_blink(LED_PRIORITY_SYSTEM, LED_COLOR_MIN_VALUE, LED_COLOR_MAX_VALUE, LED_COLOR_MIN_VALUE, LED_BLINK_ON_MS,
-                    LED_BLINK_OFF_MS); // 原魔数: 0, 255, 0, 200, 200
-    } else {
-      //** WiFi未连接 - 红色闪烁一次
-      led_set_blink(LED_PRIORITY_SYSTEM, LED_COLOR_MAX_VALUE, LED_COLOR_MIN_VALUE, LED_COLOR_MIN_VALUE, LED_BLINK_ON_MS,
-                    LED_BLINK_OFF_MS); // 原魔数: 255, 0, 0, 200, 200
-    }
-    last_wifi_led_update = now;
+  serial_out.printf("- 帧节拍 (%d fps)\n", UI_TARGET_FPS);
+  frame_pacer_init(&frame_pacer, UI_TARGET_FPS, micros());
+  display_set_flush_callback(frame_flush_done, NULL);
+
+  //** 调度器 - 注册顺序就是同一次唤醒里的运行顺序；收件箱排在led前面，请求当次就生效
+  serial_out.printf("- 调度器 (渲染核%d, IO核%d)\n", xPortGetCoreID(), HW_CORE_IO);
+  uint32_t now = micros();
+  app_sched_init(&render_loop.sched, now);
+  task_display = app_sched_add(&render_loop.sched, "display", app_display_task, NULL, APP_SCHED_IDLE, now);
+  task_frame = app_sched_add(&render_loop.sched, "frame", app_frame_task, NULL, 0, now);
+  task_inbox = app_sched_add(&render_loop.sched, "inbox", app_inbox_task, NULL, APP_SCHED_IDLE, now);
+  task_events = app_sched_add(&render_loop.sched, "events", app_events_task, NULL, APP_SCHED_IDLE, now);
+  task_wifi_led = app_sched_add(&render_loop.sched, "wifi_led", app_wifi_led_task, NULL, 0, now);
+  task_led = app_sched_add(&render_loop.sched, "led", app_led_task, NULL, 0, now);
+  led_set_wake(app_led_wake);
+  render_loop.task = xTaskGetCurrentTaskHandle();
+  app_loop_timer(&render_loop, "render_wake");
+
+  app_sched_init(&io_loop.sched, now);
+  app_sched_add(&io_loop.sched, "wifi", app_wifi_task, NULL, 0, now);
+  task_command = app_sched_add(&io_loop.sched, "command", app_command_task, NULL, 0, now);
+  app_sched_add(&io_loop.sched, "heartbeat", app_heartbeat_task, NULL, HEARTBEAT_DEFAULT_INTERVAL_MS * 1000, now);
+  app_loop_timer(&io_loop, "io_wake");
+
+  //** 从这里开始LED管理器和显示只归渲染核，IO核只能发消息
+  if (xTaskCreatePinnedToCore(app_io_main, "app_io", HW_IO_TASK_STACK, NULL, HW_IO_TASK_PRIORITY, NULL,
+                              HW_CORE_IO) != pdPASS) {
+    system_panic(PANIC_INIT_FAILED, "IO task create failed");
   }
+#if ARDUINO_USB_CDC_ON_BOOT && ARDUINO_USB_MODE
+  Serial.onEvent(ARDUINO_HW_CDC_RX_EVENT, app_serial_rx);
+#endif
+
+  serial_out.println("✓ 应用模块初始化完成");
 
-  //** 处理其他模块
-  command_handler_process();
-  heartbeat_process();
+  g_app_start_time = millis();
+}
 
-  delay(10);
+void app_run(void) {
+  app_trace_tick();
+  //** 渲染核 - 只运行到期的和有事件的模块
+  app_sched_dispatch(&render_loop.sched, micros());
+  app_loop_wait(&render_loop);
 }
 
 void app_cleanup(void) {
@@ -73,5 +439,5 @@ void app_cleanup(void) {
 
   g_app_start_time = 0;
 
-  Serial.println("应用清理完成");
+  serial_out.println("应用清理完成");
 }
\ No newline at end of file
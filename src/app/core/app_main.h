@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include "app_msg.h"
+#include "app_sched.h"
+#include "frame_pacer.h"
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -23,6 +26,28 @@ void app_run(void);
 //** 应用清理 - 资源释放
 void app_cleanup(void);
 
+//** 帧渲染回调 - 按 UI_TARGET_FPS 节拍调用，画完后由app_run提交刷新
+typedef void (*app_render_fn)(void);
+void app_set_render(app_render_fn render);
+
+//** 帧节拍和帧时间统计 - 串口命令 f 查看
+frame_pacer_t* app_frame_pacer(void);
+
+//** 每个核一个循环，各有自己的调度器 - 串口命令 f 查看唤醒次数和调度延迟
+typedef enum {
+  APP_LOOP_RENDER = 0,    // loop()：刷屏、帧节拍、LED
+  APP_LOOP_IO,            // app_io任务：WiFi、串口命令、心跳
+  APP_LOOP_COUNT
+} app_loop_id_t;
+
+app_sched_t* app_scheduler(app_loop_id_t loop);
+
+//** IO核发往渲染核的消息统计
+const app_msg_stats_t* app_inbox_stats(void);
+
+//** 渲染核的事件总线 - 在app_init()之后订阅；订阅者在渲染核的循环里被调用
+event_bus_t* app_event_bus(void);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,52 @@
+//** ESP32-S3 HoloCubic - Cross-Core Messages
+//** Linus原则：两个核之间只传值，不共享可写状态
+//**
+//** 渲染核 (loop()): 刷屏、帧节拍、LED管理器和LED输出
+//** IO核 (app_io):    WiFi、存储、串口命令、心跳
+//** IO核要动LED或显示时，把请求打包成消息放进渲染核的收件箱，由渲染核的inbox任务执行。
+//** 每个方向一条SPSC队列，只有一个生产者 - 中断和事件回调只能用app_sched_signal()叫醒，不能发消息。
+
+#pragma once
+
+#include "../../core/types/spsc_queue.h"
+#include "../interface/command_line.h"
+#include "../managers/led_manager.h"
+#include "event_bus.h"
+#include <stdint.h>
+
+#define APP_MSG_QUEUE_DEPTH 16      // 命令和LED请求都是零星的，16条够一个WiFi重连的突发
+
+typedef enum {
+  APP_MSG_NONE = 0,
+  APP_MSG_LED_REQUEST,              // led: 原样交给led_request()
+  APP_MSG_LED_RELEASE,              // priority: led_release()
+  APP_MSG_COMMAND,                  // line: 串口命令里碰显示或LED的那些，整行
+  APP_MSG_EVENT,                    // event: IO核发布的事件，进渲染核的事件总线
+  APP_MSG_BLIT,                     // blit: usb_link上传的图，画完调usb_link_blit_done()
+} app_msg_type_t;
+
+//** 像素归usb_link，渲染核画完之前IO核不会再写
+typedef struct {
+  int16_t x, y, w, h;
+  const uint16_t* pixels;
+} app_blit_t;
+
+typedef struct {
+  uint8_t type;                     // app_msg_type_t
+  union {
+    led_request_t led;              // 脚本指针指向的led_script_t归渲染核所有
+    led_priority_t priority;
+    char line[COMMAND_LINE_MAX];    // 不比led_request_t大，消息不因此变长
+    event_t event;
+    app_blit_t blit;
+  };
+} app_msg_t;
+
+typedef spsc_queue<app_msg_t, APP_MSG_QUEUE_DEPTH> app_msg_queue_t;
+
+//** 收件箱统计 - 生产者写，串口命令 f 读
+typedef struct {
+  uint32_t posted;
+  uint32_t dropped;                 // 满了没放进去的
+  uint32_t peak;                    // 最多同时排着几条
+} app_msg_stats_t;
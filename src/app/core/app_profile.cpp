@@ -0,0 +1,39 @@
+//** ESP32-S3 HoloCubic - Per-Module Loop Latency Profile Implementation
+
+#include "app_profile.h"
+
+typedef struct {
+  lat_hist_t hist;
+  volatile bool reset_pending;    // 另一个核要求清零
+} app_prof_t;
+
+static app_prof_t profiles[APP_PROF_COUNT];
+
+static const char* const prof_names[APP_PROF_COUNT] = {
+  "render", "flush", "inbox", "events", "wifi_led", "led", "wifi", "command", "heartbeat",
+};
+
+void app_prof_add(app_prof_id_t id, uint32_t cycles) {
+  if ((unsigned)id >= APP_PROF_COUNT) return;
+  app_prof_t* prof = &profiles[id];
+  if (prof->reset_pending) {
+    lat_hist_reset(&prof->hist);
+    prof->reset_pending = false;
+  }
+  lat_hist_add(&prof->hist, cycles);
+}
+
+const lat_hist_t* app_prof_hist(app_prof_id_t id) {
+  if ((unsigned)id >= APP_PROF_COUNT || profiles[id].reset_pending) return NULL;
+  return &profiles[id].hist;
+}
+
+const char* app_prof_name(app_prof_id_t id) {
+  return (unsigned)id < APP_PROF_COUNT ? prof_names[id] : "?";
+}
+
+void app_prof_reset(void) {
+  for (uint8_t i = 0; i < APP_PROF_COUNT; i++) {
+    profiles[i].reset_pending = true;
+  }
+}
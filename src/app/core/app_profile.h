@@ -0,0 +1,55 @@
+//** ESP32-S3 HoloCubic - Per-Module Loop Latency Profile
+//** Linus原则：卡顿的时候先看是谁，再猜为什么
+//**
+//** - 每个模块调用外面套一个 APP_PROF_SCOPE(id)，进出各读一次CPU周期计数器
+//** - 每个模块一个 lat_hist_t，只由跑这个模块的那个核写
+//** - 串口命令 p 打印 p50/p99/max (us)，P 清零；清零只是做个标记，由写的那个核下次加样本时清
+
+#pragma once
+
+#include "lat_hist.h"
+#include <Arduino.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+  APP_PROF_RENDER = 0,    // 渲染核: frame_render()
+  APP_PROF_FLUSH,         //         display_flush_poll()
+  APP_PROF_INBOX,         //         收件箱消息
+  APP_PROF_EVENTS,        //         事件分发
+  APP_PROF_WIFI_LED,      //         WiFi状态闪烁
+  APP_PROF_LED,           //         led_process()
+  APP_PROF_WIFI,          // IO核:   wifi_app_process()
+  APP_PROF_COMMAND,       //         command_handler_process()
+  APP_PROF_HEARTBEAT,     //         heartbeat_process()
+  APP_PROF_COUNT
+} app_prof_id_t;
+
+//** 记一个样本 (CPU周期)
+void app_prof_add(app_prof_id_t id, uint32_t cycles);
+
+//** 读直方图 - 清零标记还没处理时返回NULL，当作空
+const lat_hist_t* app_prof_hist(app_prof_id_t id);
+const char* app_prof_name(app_prof_id_t id);
+
+//** 所有模块清零
+void app_prof_reset(void);
+
+#ifdef __cplusplus
+}
+
+//** 作用域计时 - 构造时读周期计数，析构时记样本；任务固定在一个核上，两次读的是同一个计数器
+class app_prof_scope {
+public:
+  explicit app_prof_scope(app_prof_id_t id) : id_(id), start_(ESP.getCycleCount()) {}
+  ~app_prof_scope() { app_prof_add(id_, ESP.getCycleCount() - start_); }
+
+private:
+  app_prof_id_t id_;
+  uint32_t start_;
+};
+
+#define APP_PROF_SCOPE(id) app_prof_scope app_prof_scope_(id)
+#endif
@@ -0,0 +1,160 @@
+//** ESP32-S3 HoloCubic - Tickless Deadline Scheduler Implementation
+//** Linus原则：时间差一律用无符号减法，micros()回绕也正确
+
+#include "app_sched.h"
+#include <string.h>
+
+#define SLOT_MASK (APP_SCHED_SLOTS - 1)
+
+static inline uint32_t slot_of(uint32_t us) {
+  return (us >> APP_SCHED_SLOT_SHIFT) & SLOT_MASK;
+}
+
+//** 轮子转了几格 - 绝对格号相减
+static inline uint32_t slot_distance(uint32_t from_us, uint32_t to_us) {
+  return (to_us >> APP_SCHED_SLOT_SHIFT) - (from_us >> APP_SCHED_SLOT_SHIFT);
+}
+
+static void wheel_remove(app_sched_t* s, uint8_t id) {
+  app_task_t* t = &s->tasks[id];
+  if (!t->armed) return;
+  uint32_t slot = slot_of(t->deadline_us);
+  s->slots[slot] &= (uint16_t)~(1u << id);
+  if (!s->slots[slot]) s->occupied &= ~(1ULL << slot);
+  t->armed = false;
+}
+
+static void wheel_insert(app_sched_t* s, uint8_t id, uint32_t deadline_us) {
+  app_task_t* t = &s->tasks[id];
+  wheel_remove(s, id);
+  t->deadline_us = deadline_us;
+  t->armed = true;
+
+  //** 不晚于上次dispatch的已经到期 - 直接进pending，轮子里只放将来的
+  if ((int32_t)(deadline_us - s->cursor_us) <= 0) {
+    __atomic_fetch_or(&s->pending, 1u << id, __ATOMIC_RELAXED);
+    return;
+  }
+  uint32_t slot = slot_of(deadline_us);
+  s->slots[slot] |= (uint16_t)(1u << id);
+  s->occupied |= 1ULL << slot;
+}
+
+void app_sched_init(app_sched_t* s, uint32_t now_us) {
+  memset(s, 0, sizeof(*s));
+  s->cursor_us = now_us;
+}
+
+int8_t app_sched_add(app_sched_t* s, const char* name, app_task_fn fn, void* ctx,
+                     uint32_t first_us, uint32_t now_us) {
+  if (s->count >= APP_SCHED_MAX_TASKS || !fn) return -1;
+
+  int8_t id = (int8_t)s->count++;
+  app_task_t* t = &s->tasks[id];
+  t->name = name;
+  t->fn = fn;
+  t->ctx = ctx;
+  if (first_us != APP_SCHED_IDLE) wheel_insert(s, (uint8_t)id, now_us + first_us);
+  return id;
+}
+
+void app_sched_at(app_sched_t* s, int8_t task, uint32_t deadline_us) {
+  if (task < 0 || task >= s->count) return;
+  wheel_insert(s, (uint8_t)task, deadline_us);
+}
+
+void app_sched_cancel(app_sched_t* s, int8_t task) {
+  if (task < 0 || task >= s->count) return;
+  wheel_remove(s, (uint8_t)task);
+  __atomic_fetch_and(&s->pending, ~(1u << task), __ATOMIC_RELAXED);
+}
+
+void app_sched_signal(app_sched_t* s, int8_t task) {
+  if (task < 0 || task >= APP_SCHED_MAX_TASKS) return;
+  __atomic_fetch_or(&s->pending, 1u << task, __ATOMIC_RELAXED);
+}
+
+uint32_t app_sched_timeout_us(const app_sched_t* s, uint32_t now_us) {
+  if (s->pending) return 0;
+  if (!s->occupied) return APP_SCHED_IDLE;
+
+  //** 从上次dispatch的格子往后找第一个有本圈任务的格子 - 后几圈的任务同格但不算
+  uint32_t start = slot_of(s->cursor_us);
+  uint64_t rest = (s->occupied >> start) | (start ? s->occupied << (APP_SCHED_SLOTS - start) : 0);
+  bool found = false;
+  uint32_t nearest = 0;
+
+  while (rest && !found) {
+    uint32_t d = (uint32_t)__builtin_ctzll(rest);
+    rest &= rest - 1;
+    uint16_t mask = s->slots[(start + d) & SLOT_MASK];
+    for (uint8_t id = 0; mask; id++, mask >>= 1) {
+      if (!(mask & 1)) continue;
+      const app_task_t* t = &s->tasks[id];
+      if (slot_distance(s->cursor_us, t->deadline_us) != d) continue;
+      if (!found || (int32_t)(t->deadline_us - nearest) < 0) nearest = t->deadline_us;
+      found = true;
+    }
+  }
+
+  //** 全都在一圈以外 - 少见，逐个比
+  if (!found) {
+    for (uint8_t id = 0; id < s->count; id++) {
+      const app_task_t* t = &s->tasks[id];
+      if (!t->armed) continue;
+      if (!found || (int32_t)(t->deadline_us - nearest) < 0) nearest = t->deadline_us;
+      found = true;
+    }
+  }
+
+  int32_t left = (int32_t)(nearest - now_us);
+  return left > 0 ? (uint32_t)left : 0;
+}
+
+uint8_t app_sched_dispatch(app_sched_t* s, uint32_t now_us) {
+  s->wakeups++;
+  uint32_t run = __atomic_exchange_n(&s->pending, 0, __ATOMIC_RELAXED);
+
+  //** 走过上次dispatch到现在经过的格子 - 超过一圈就整圈都看
+  uint32_t span = slot_distance(s->cursor_us, now_us);
+  if (span >= APP_SCHED_SLOTS) span = APP_SCHED_SLOTS - 1;
+  uint32_t start = slot_of(s->cursor_us);
+  for (uint32_t d = 0; d <= span; d++) {
+    uint16_t mask = s->slots[(start + d) & SLOT_MASK];
+    for (uint8_t id = 0; mask; id++, mask >>= 1) {
+      if ((mask & 1) && (int32_t)(s->tasks[id].deadline_us - now_us) <= 0) run |= 1u << id;
+    }
+  }
+  s->cursor_us = now_us;
+
+  uint8_t ran = 0;
+  for (uint8_t id = 0; run; id++, run >>= 1) {
+    if (!(run & 1)) continue;
+    app_task_t* t = &s->tasks[id];
+
+    //** 延迟只对定时唤醒有意义；被signal提前叫醒的不算
+    if (t->armed && (int32_t)(now_us - t->deadline_us) > 0) {
+      uint32_t late = now_us - t->deadline_us;
+      if (late > t->max_late_us) t->max_late_us = late;
+      if (late > s->max_late_us) s->max_late_us = late;
+    }
+    wheel_remove(s, id);
+
+    uint32_t next = t->fn(now_us, t->ctx);
+    t->runs++;
+    s->runs++;
+    ran++;
+    if (next != APP_SCHED_IDLE) wheel_insert(s, id, now_us + next);
+  }
+  return ran;
+}
+
+void app_sched_reset_stats(app_sched_t* s) {
+  s->wakeups = 0;
+  s->runs = 0;
+  s->max_late_us = 0;
+  for (uint8_t id = 0; id < s->count; id++) {
+    s->tasks[id].runs = 0;
+    s->tasks[id].max_late_us = 0;
+  }
+}
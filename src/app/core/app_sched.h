@@ -0,0 +1,73 @@
+//** ESP32-S3 HoloCubic - Tickless Deadline Scheduler Header
+//** Linus原则：没到期就不叫醒 - 主循环睡到最近的截止时间或者事件来
+//**
+//** - 每个模块是一个任务：被调用时返回多久以后再叫它，APP_SCHED_IDLE表示只等事件
+//** - 截止时间放在64格的时间轮里，每格1.024ms；格子里是任务位图，找最近的截止时间不用遍历所有任务
+//** - 事件 (串口收到数据、LED请求、开始刷新) 用 app_sched_signal() 标记，下一次dispatch立即运行
+//** - 同一次dispatch里按注册顺序运行，先注册的先跑
+//** - 纯函数，时间由调用者传进来 (us)，主机上用虚拟时钟跑 (src/native/sched_main.cpp)
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define APP_SCHED_MAX_TASKS   16
+#define APP_SCHED_SLOTS       64
+#define APP_SCHED_SLOT_SHIFT  10              // 一格 1024us
+#define APP_SCHED_IDLE        0xFFFFFFFFu     // 任务返回值：不定时，等事件
+
+//** 任务 - 返回多少us后再运行 (0 = 下一次dispatch)
+typedef uint32_t (*app_task_fn)(uint32_t now_us, void* ctx);
+
+typedef struct {
+  const char* name;
+  app_task_fn fn;
+  void* ctx;
+  uint32_t deadline_us;
+  bool armed;                   // 在时间轮里
+  uint32_t runs;
+  uint32_t max_late_us;         // 到期到真正运行的最大延迟
+} app_task_t;
+
+typedef struct {
+  app_task_t tasks[APP_SCHED_MAX_TASKS];
+  uint8_t count;
+  uint16_t slots[APP_SCHED_SLOTS];  // 每格里的任务位图
+  uint64_t occupied;                // 哪些格不空
+  volatile uint32_t pending;        // 被signal的任务，中断里也可以置位
+  uint32_t cursor_us;               // 上次dispatch的时间 - 轮子里的截止时间都在它之后
+
+  uint32_t wakeups;                 // dispatch次数
+  uint32_t runs;                    // 任务运行次数
+  uint32_t max_late_us;             // 所有任务里最坏的调度延迟
+} app_sched_t;
+
+void app_sched_init(app_sched_t* sched, uint32_t now_us);
+
+//** 注册任务 - first_us后第一次运行 (APP_SCHED_IDLE = 等事件)；返回任务号，满了返回-1
+int8_t app_sched_add(app_sched_t* sched, const char* name, app_task_fn fn, void* ctx,
+                     uint32_t first_us, uint32_t now_us);
+
+//** 改截止时间 - 已经到期的下一次dispatch就运行
+void app_sched_at(app_sched_t* sched, int8_t task, uint32_t deadline_us);
+void app_sched_cancel(app_sched_t* sched, int8_t task);
+
+//** 事件 - 只置一个位，可以在中断或其他任务里调用
+void app_sched_signal(app_sched_t* sched, int8_t task);
+
+//** 离最近的截止时间还有多少us；有事件或已到期返回0，什么都没有返回APP_SCHED_IDLE
+uint32_t app_sched_timeout_us(const app_sched_t* sched, uint32_t now_us);
+
+//** 运行所有到期和被signal的任务，返回运行的个数
+uint8_t app_sched_dispatch(app_sched_t* sched, uint32_t now_us);
+
+void app_sched_reset_stats(app_sched_t* sched);
+
+#ifdef __cplusplus
+}
+#endif
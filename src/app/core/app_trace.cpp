@@ -0,0 +1,95 @@
+//** ESP32-S3 HoloCubic - Input Recorder Implementation
+
+#include "app_trace.h"
+#include "../../core/config/hardware_config.h"
+#include "../../system/serial_out.h"
+#include <Arduino.h>
+
+static input_trace_t g_trace;
+static bool g_active = false;
+static portMUX_TYPE g_lock = portMUX_INITIALIZER_UNLOCKED;
+
+//** 只记变化 - 状态机每次检查都读，大多数时候值没变
+static uint8_t g_wifi_status = 0xFF;
+static int16_t g_wifi_rssi = INT16_MAX;
+
+static void trace_put(uint8_t type, uint8_t arg, const uint8_t* payload) {
+  uint32_t now = micros();
+  portENTER_CRITICAL(&g_lock);
+  input_trace_put(&g_trace, now, type, arg, payload);
+  portEXIT_CRITICAL(&g_lock);
+}
+
+void app_trace_init(void) {
+#if HW_TRACE_BYTES > 0
+  uint8_t* buf = (uint8_t*)ps_malloc(HW_TRACE_BYTES);
+  if (!buf) {
+    serial_out.println("  输入记录缓冲分配失败，不记录");
+    return;
+  }
+  input_trace_init(&g_trace, buf, HW_TRACE_BYTES, micros());
+  g_active = true;
+  serial_out.printf("- 输入记录 (%u KB, 命令T保存)\n", (unsigned)(HW_TRACE_BYTES / 1024));
+#endif
+}
+
+bool app_trace_active(void) {
+  return g_active;
+}
+
+void app_trace_tick(void) {
+  if (g_active) trace_put(INPUT_TRACE_TICK, 0, NULL);
+}
+
+void app_trace_serial(uint8_t byte) {
+  if (g_active) trace_put(INPUT_TRACE_SERIAL, 0, &byte);
+}
+
+void app_trace_wifi_status(uint8_t status) {
+  if (!g_active || status == g_wifi_status) return;
+  g_wifi_status = status;
+  trace_put(INPUT_TRACE_WIFI_STATUS, 0, &status);
+}
+
+void app_trace_wifi_rssi(int8_t rssi) {
+  if (!g_active || rssi == g_wifi_rssi) return;
+  g_wifi_rssi = rssi;
+  uint8_t payload = (uint8_t)rssi;
+  trace_put(INPUT_TRACE_WIFI_RSSI, 0, &payload);
+}
+
+void app_trace_imu(uint8_t gesture, const float acc[3], const float gyro[3]) {
+  if (!g_active) return;
+  uint8_t payload[INPUT_TRACE_MAX_PAYLOAD];
+  input_trace_pack_imu(acc, gyro, payload);
+  trace_put(INPUT_TRACE_IMU, gesture & 0x0F, payload);
+}
+
+const uint8_t* app_trace_snapshot(uint32_t* len) {
+  if (!g_active) {
+    *len = 0;
+    return NULL;
+  }
+  portENTER_CRITICAL(&g_lock);
+  input_trace_seal(&g_trace);
+  *len = g_trace.len;
+  portEXIT_CRITICAL(&g_lock);
+  return g_trace.buf;
+}
+
+const input_trace_t* app_trace_stats(void) {
+  return g_active ? &g_trace : NULL;
+}
+
+bool app_trace_save(fs::FS& fs, const char* path) {
+  uint32_t len;
+  const uint8_t* data = app_trace_snapshot(&len);
+  if (!data) return false;
+
+  //** 只写快照那一段 - 写的时候另一个核还在往后面追加
+  fs::File file = fs.open(path, "w");
+  if (!file) return false;
+  size_t written = file.write(data, len);
+  file.close();
+  return written == len;
+}
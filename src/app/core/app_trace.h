@@ -0,0 +1,41 @@
+//** ESP32-S3 HoloCubic - Input Recorder
+//** Linus原则：现场复现不了的卡顿，把输入带回来在主机上重放
+//**
+//** - 固件读外部输入的地方各调一个钩子，记进PSRAM里的input_trace缓冲 (HW_TRACE_BYTES，0 = 全部空操作)
+//** - 两个核都会记，追加在一个自旋锁里，只有几十条指令
+//** - WiFi状态和RSSI只记变化，其余每次都记
+//** - 串口命令 T 存到SPIFFS (HW_TRACE_FILE)；app_trace_save()也能写SD卡
+//** - 回放：pio run -e native && .pio/build/native/program --replay trace.bin
+
+#pragma once
+
+#include "input_trace.h"
+#include <FS.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//** 分配缓冲并从现在开始记 - 在app_init里调用
+void app_trace_init(void);
+bool app_trace_active(void);
+
+//** 钩子
+void app_trace_tick(void);                                     // loop()每圈开始
+void app_trace_serial(uint8_t byte);                           // Serial.read()之后
+void app_trace_wifi_status(uint8_t status);                    // WiFi.status()之后
+void app_trace_wifi_rssi(int8_t rssi);                         // WiFi.RSSI()之后
+void app_trace_imu(uint8_t gesture, const float acc[3], const float gyro[3]);
+
+//** 封好头，返回buf[0, *len) - 之后还会继续追加，调用者只读这一段
+const uint8_t* app_trace_snapshot(uint32_t* len);
+
+//** 记录器计数 (records, dropped, len)；没开时返回NULL
+const input_trace_t* app_trace_stats(void);
+
+#ifdef __cplusplus
+}
+
+//** 把当前记录写成文件 - SPIFFS或SD_MMC都行
+bool app_trace_save(fs::FS& fs, const char* path);
+#endif
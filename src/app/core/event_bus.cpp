@@ -0,0 +1,107 @@
+//** ESP32-S3 HoloCubic - Event Bus Implementation
+//** Linus原则：分发只看位图，订阅者再多也不逐个比较类型
+
+#include "event_bus.h"
+#include <string.h>
+
+#define RING_MASK (EVENT_BUS_DEPTH - 1)
+
+static event_sink_fn g_sink = NULL;
+
+void event_bus_init(event_bus_t* bus) {
+  memset(bus, 0, sizeof(*bus));
+}
+
+int8_t event_subscribe(event_bus_t* bus, uint32_t mask, event_handler_fn fn, void* ctx) {
+  mask &= EVENT_MASK_ALL;
+  if (!fn || !mask) return -1;
+
+  for (int8_t id = 0; id < EVENT_BUS_MAX_SUBS; id++) {
+    event_sub_t* sub = &bus->subs[id];
+    if (sub->fn) continue;
+    sub->fn = fn;
+    sub->ctx = ctx;
+    sub->mask = mask;
+    for (uint8_t type = 0; type < EVENT_TYPE_COUNT; type++) {
+      if (mask & EVENT_MASK(type)) bus->by_type[type] |= 1u << id;
+    }
+    bus->wanted |= mask;
+    return id;
+  }
+  return -1;
+}
+
+void event_unsubscribe(event_bus_t* bus, int8_t id) {
+  if (id < 0 || id >= EVENT_BUS_MAX_SUBS || !bus->subs[id].fn) return;
+
+  memset(&bus->subs[id], 0, sizeof(bus->subs[id]));
+  bus->wanted = 0;
+  for (uint8_t type = 0; type < EVENT_TYPE_COUNT; type++) {
+    bus->by_type[type] &= ~(1u << id);
+    if (bus->by_type[type]) bus->wanted |= EVENT_MASK(type);
+  }
+}
+
+bool event_bus_post(event_bus_t* bus, const event_t* event) {
+  if (event->type >= EVENT_TYPE_COUNT || !(bus->wanted & EVENT_MASK(event->type))) return true;
+  if (bus->head - bus->tail == EVENT_BUS_DEPTH) {
+    bus->dropped++;
+    return false;
+  }
+  bus->ring[bus->head & RING_MASK] = *event;
+  bus->head++;
+  bus->posted++;
+  return true;
+}
+
+bool event_bus_pending(const event_bus_t* bus) {
+  return bus->head != bus->tail;
+}
+
+uint32_t event_bus_dispatch(event_bus_t* bus, uint32_t now_us) {
+  uint32_t end = bus->head;
+  uint32_t handled = 0;
+
+  while (bus->tail != end) {
+    //** 先拷出来再出队 - 订阅者里发布的新事件不会覆盖正在处理的
+    event_t event = bus->ring[bus->tail & RING_MASK];
+    bus->tail++;
+    bus->dispatched++;
+    handled++;
+
+    uint32_t latency = now_us - event.time_us;
+    if (latency > bus->max_latency_us) bus->max_latency_us = latency;
+    bus->total_latency_us += latency;
+
+    //** 订阅者可能在回调里退订 - 调用前再确认一次
+    uint32_t subs = bus->by_type[event.type];
+    while (subs) {
+      uint8_t id = (uint8_t)__builtin_ctz(subs);
+      subs &= subs - 1;
+      const event_sub_t* sub = &bus->subs[id];
+      if (!sub->fn || !(sub->mask & EVENT_MASK(event.type))) continue;
+      sub->fn(&event, sub->ctx);
+      bus->delivered++;
+    }
+  }
+  return handled;
+}
+
+void event_bus_reset_stats(event_bus_t* bus) {
+  bus->posted = 0;
+  bus->dropped = 0;
+  bus->dispatched = 0;
+  bus->delivered = 0;
+  bus->max_latency_us = 0;
+  bus->total_latency_us = 0;
+}
+
+void event_set_sink(event_sink_fn sink) {
+  g_sink = sink;
+}
+
+void event_publish(event_type_t type, uint16_t arg, int32_t value) {
+  if (!g_sink) return;
+  event_t event = { (uint16_t)type, arg, value, 0 };
+  g_sink(&event);
+}
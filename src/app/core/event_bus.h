@@ -0,0 +1,87 @@
+//** ESP32-S3 HoloCubic - Event Bus Header
+//** Linus原则：状态变了就说一声 - 消费者不再定时去读别人的结构体
+//**
+//** - 事件是12字节的值，放进预先分配的环里，发布时不分配内存
+//** - 订阅者按事件类型位图登记，每种类型有一张订阅者位图，分发时只叫感兴趣的
+//** - 单线程：一条总线只属于一个循环，发布和分发都在这个循环的任务里
+//**   其他核的模块用event_publish()，由应用的sink决定怎么送过来 (app_main里走渲染核收件箱)
+//** - 纯函数，时间由调用者传进来 (us)，主机上压测 (src/native/event_bench_main.cpp)
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EVENT_BUS_DEPTH       32            // 2的幂
+#define EVENT_BUS_MAX_SUBS    32
+
+typedef enum {
+  EVENT_WIFI_STATE = 0,     // arg: wifi_state_t, value: RSSI (dBm)
+  EVENT_COMMAND,            // arg: 命令名的第一个字符, value: 参数个数
+  EVENT_HEALTH,             // arg: 1=健康检查通过, value: 空闲堆 (字节)
+  EVENT_IMU_GESTURE,        // arg: 手势编号 (驱动没给时为0)
+  EVENT_TYPE_COUNT
+} event_type_t;
+
+#define EVENT_MASK(type)  (1u << (type))
+#define EVENT_MASK_ALL    ((1u << EVENT_TYPE_COUNT) - 1)
+
+typedef struct {
+  uint16_t type;            // event_type_t
+  uint16_t arg;             // 小参数
+  int32_t value;            // 大参数
+  uint32_t time_us;         // 发布时间 - 用来统计分发延迟
+} event_t;
+
+typedef void (*event_handler_fn)(const event_t* event, void* ctx);
+
+typedef struct {
+  event_handler_fn fn;
+  void* ctx;
+  uint32_t mask;
+} event_sub_t;
+
+typedef struct {
+  event_t ring[EVENT_BUS_DEPTH];
+  uint32_t head, tail;                          // 自由增长，相减就是排队个数
+  event_sub_t subs[EVENT_BUS_MAX_SUBS];
+  uint32_t by_type[EVENT_TYPE_COUNT];           // 每种类型的订阅者位图
+  uint32_t wanted;                              // 有人订阅的类型 - 其余的发布时直接丢掉
+
+  uint32_t posted;
+  uint32_t dropped;                             // 环满了丢掉的
+  uint32_t dispatched;                          // 分发过的事件
+  uint32_t delivered;                           // 调用了多少次订阅者
+  uint32_t max_latency_us;                      // 发布到分发的最大延迟
+  uint64_t total_latency_us;
+} event_bus_t;
+
+void event_bus_init(event_bus_t* bus);
+
+//** 订阅 - mask是EVENT_MASK()的组合；返回订阅号，满了返回-1
+int8_t event_subscribe(event_bus_t* bus, uint32_t mask, event_handler_fn fn, void* ctx);
+void event_unsubscribe(event_bus_t* bus, int8_t id);
+
+//** 发布 - 没人订阅返回true但不入队；环满了返回false
+bool event_bus_post(event_bus_t* bus, const event_t* event);
+
+//** 有没有排队的事件
+bool event_bus_pending(const event_bus_t* bus);
+
+//** 分发调用前已经排队的事件，订阅者里新发布的留到下一次；返回处理的事件数
+uint32_t event_bus_dispatch(event_bus_t* bus, uint32_t now_us);
+
+void event_bus_reset_stats(event_bus_t* bus);
+
+//** 给模块用的发布入口 - 应用用event_set_sink()决定事件进哪条总线，没设置时直接丢掉
+typedef void (*event_sink_fn)(event_t* event);
+void event_set_sink(event_sink_fn sink);
+void event_publish(event_type_t type, uint16_t arg, int32_t value);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,98 @@
+//** ESP32-S3 HoloCubic - Frame Pacer Implementation
+//** Linus原则：时间差一律用无符号减法，micros()回绕也正确
+
+#include "frame_pacer.h"
+#include <string.h>
+
+void frame_hist_add(frame_hist_t* hist, uint32_t us) {
+  uint32_t bucket = us / FRAME_HIST_BUCKET_US;
+  if (bucket >= FRAME_HIST_BUCKETS) bucket = FRAME_HIST_BUCKETS - 1;
+  hist->counts[bucket]++;
+  hist->samples++;
+  hist->total_us += us;
+  if (us > hist->max_us) hist->max_us = us;
+}
+
+uint32_t frame_hist_percentile(const frame_hist_t* hist, uint8_t percent) {
+  if (hist->samples == 0) return 0;
+
+  //** 向上取整，保证至少percent%的样本不超过返回值
+  uint32_t target = (uint32_t)(((uint64_t)hist->samples * percent + 99) / 100);
+  uint32_t seen = 0;
+  for (uint32_t i = 0; i < FRAME_HIST_BUCKETS - 1; i++) {
+    seen += hist->counts[i];
+    if (seen >= target) {
+      uint32_t upper = (i + 1) * FRAME_HIST_BUCKET_US;
+      return upper < hist->max_us ? upper : hist->max_us;
+    }
+  }
+  return hist->max_us;
+}
+
+void frame_pacer_init(frame_pacer_t* pacer, uint16_t fps, uint32_t now_us) {
+  memset(pacer, 0, sizeof(*pacer));
+  frame_pacer_set_fps(pacer, fps, now_us);
+}
+
+void frame_pacer_set_fps(frame_pacer_t* pacer, uint16_t fps, uint32_t now_us) {
+  pacer->period_us = 1000000u / (fps ? fps : 1);
+  pacer->deadline_us = now_us;
+}
+
+void frame_pacer_reset_stats(frame_pacer_t* pacer) {
+  pacer->frames = 0;
+  pacer->skipped = 0;
+  memset(&pacer->interval, 0, sizeof(pacer->interval));
+  memset(&pacer->render, 0, sizeof(pacer->render));
+  memset(&pacer->flush, 0, sizeof(pacer->flush));
+  memset(&pacer->idle, 0, sizeof(pacer->idle));
+}
+
+bool frame_pacer_due(const frame_pacer_t* pacer, uint32_t now_us) {
+  return (int32_t)(now_us - pacer->deadline_us) >= 0;
+}
+
+bool frame_pacer_begin(frame_pacer_t* pacer, uint32_t now_us) {
+  if (!frame_pacer_due(pacer, now_us)) return false;
+  uint32_t late = now_us - pacer->deadline_us;
+
+  //** 上一帧的刷新完成没报上来 - 就当现在完成，idle为0
+  if (pacer->in_frame) frame_pacer_flushed(pacer, now_us);
+
+  //** 错过的整周期直接跳过，截止时间保持原来的相位
+  if (late >= pacer->period_us) {
+    uint32_t missed = late / pacer->period_us;
+    pacer->skipped += missed;
+    pacer->deadline_us += missed * pacer->period_us;
+  }
+  pacer->deadline_us += pacer->period_us;
+
+  if (pacer->started) {
+    frame_hist_add(&pacer->interval, now_us - pacer->begin_us);
+    frame_hist_add(&pacer->idle, now_us - pacer->flushed_us);
+  }
+  pacer->begin_us = now_us;
+  pacer->rendered_us = now_us;
+  pacer->in_frame = true;
+  pacer->started = true;
+  return true;
+}
+
+void frame_pacer_rendered(frame_pacer_t* pacer, uint32_t now_us) {
+  if (!pacer->in_frame) return;
+  pacer->rendered_us = now_us;
+  frame_hist_add(&pacer->render, now_us - pacer->begin_us);
+}
+
+void frame_pacer_flushed(frame_pacer_t* pacer, uint32_t now_us) {
+  if (!pacer->in_frame) return;
+  pacer->in_frame = false;
+  pacer->flushed_us = now_us;
+  pacer->frames++;
+  frame_hist_add(&pacer->flush, now_us - pacer->rendered_us);
+}
+
+uint32_t frame_pacer_wait_us(const frame_pacer_t* pacer, uint32_t now_us) {
+  int32_t until = (int32_t)(pacer->deadline_us - now_us);
+  return until > 0 ? (uint32_t)until : 0;
+}
@@ -0,0 +1,74 @@
+//** ESP32-S3 HoloCubic - Frame Pacer Header
+//** Linus原则：节拍逻辑是纯函数，时间由调用者传进来
+//**
+//** - 目标帧率固定节拍，截止时间按周期前进，不随处理延迟漂移
+//** - 超时的帧直接跳过并计数，不补帧
+//** - 每帧记录 render / flush / idle 三段时间和帧间隔，进直方图
+//** - 不调用 micros()，主机上可以用虚拟时钟测试
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FRAME_HIST_BUCKETS    64      // 最后一格收所有更长的 / the last bucket takes everything longer
+#define FRAME_HIST_BUCKET_US  1000    // 每格1ms
+
+//** 时间直方图 - 线性分格，最大值单独记录
+typedef struct {
+  uint32_t counts[FRAME_HIST_BUCKETS];
+  uint32_t samples;
+  uint32_t max_us;
+  uint64_t total_us;
+} frame_hist_t;
+
+typedef struct {
+  uint32_t period_us;
+  uint32_t deadline_us;       // 下一帧的时间点
+  uint32_t begin_us;          // 当前帧开始
+  uint32_t rendered_us;       // 当前帧渲染结束、刷新提交
+  uint32_t flushed_us;        // 上一帧刷新完成
+  bool in_frame;              // begin之后、flushed之前
+  bool started;               // 至少开始过一帧
+
+  uint32_t frames;
+  uint32_t skipped;           // 超时跳过的帧
+
+  frame_hist_t interval;      // 相邻两帧开始的间隔
+  frame_hist_t render;
+  frame_hist_t flush;
+  frame_hist_t idle;          // 刷新完成到下一帧开始
+} frame_pacer_t;
+
+void frame_hist_add(frame_hist_t* hist, uint32_t us);
+
+//** 百分位 - 返回所在格的上界 (us)，溢出格返回max
+uint32_t frame_hist_percentile(const frame_hist_t* hist, uint8_t percent);
+
+//** 初始化 - 第一帧立即到期
+void frame_pacer_init(frame_pacer_t* pacer, uint16_t fps, uint32_t now_us);
+void frame_pacer_set_fps(frame_pacer_t* pacer, uint16_t fps, uint32_t now_us);
+void frame_pacer_reset_stats(frame_pacer_t* pacer);
+
+//** 下一帧是否到期
+bool frame_pacer_due(const frame_pacer_t* pacer, uint32_t now_us);
+
+//** 到期就开始一帧返回true；错过的整周期记为跳帧
+bool frame_pacer_begin(frame_pacer_t* pacer, uint32_t now_us);
+
+//** 渲染结束，刷新已提交
+void frame_pacer_rendered(frame_pacer_t* pacer, uint32_t now_us);
+
+//** 刷新完成 - 一帧结束，样本进直方图
+void frame_pacer_flushed(frame_pacer_t* pacer, uint32_t now_us);
+
+//** 离下一帧还有多久 (us)，已到期返回0 - 调度器用它定下一次唤醒
+uint32_t frame_pacer_wait_us(const frame_pacer_t* pacer, uint32_t now_us);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,168 @@
+//** ESP32-S3 HoloCubic - Input Trace Codec Implementation
+//** Linus原则：追加只写尾巴，头等要存的时候再补
+
+#include "input_trace.h"
+#include <string.h>
+
+//** 头: magic[4] version flags reserved[2] start_us bytes，小端
+#define HDR_VERSION   4
+#define HDR_FLAGS     5
+#define HDR_START     8
+#define HDR_BYTES     12
+
+static const int8_t payload_lens[INPUT_TRACE_TYPE_COUNT] = {
+  -1,   // 0 不用
+  0,    // TICK
+  1,    // SERIAL
+  1,    // WIFI_STATUS
+  1,    // WIFI_RSSI
+  12,   // IMU
+};
+
+static void put_u32(uint8_t* p, uint32_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+}
+
+static uint32_t get_u32(const uint8_t* p) {
+  return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+int8_t input_trace_payload_len(uint8_t type) {
+  return type && type < INPUT_TRACE_TYPE_COUNT ? payload_lens[type] : -1;
+}
+
+void input_trace_init(input_trace_t* trace, uint8_t* buf, uint32_t cap, uint32_t now_us) {
+  memset(trace, 0, sizeof(*trace));
+  trace->buf = buf;
+  trace->cap = buf && cap >= INPUT_TRACE_HEADER_SIZE ? cap : 0;
+  trace->last_us = now_us;
+  if (!trace->cap) return;
+
+  memset(buf, 0, INPUT_TRACE_HEADER_SIZE);
+  memcpy(buf, INPUT_TRACE_MAGIC, 4);
+  buf[HDR_VERSION] = INPUT_TRACE_VERSION;
+  put_u32(buf + HDR_START, now_us);
+  trace->len = INPUT_TRACE_HEADER_SIZE;
+}
+
+bool input_trace_put(input_trace_t* trace, uint32_t now_us, uint8_t type, uint8_t arg, const uint8_t* payload) {
+  int8_t payload_len = input_trace_payload_len(type);
+  if (payload_len < 0 || arg > 0x0F || (payload_len && !payload)) return false;
+
+  //** 最长18字节，先拼在栈上再一次拷进去 - 放不下就整条不要，文件里不会有半条
+  uint8_t record[INPUT_TRACE_MAX_RECORD];
+  uint8_t n = 0;
+  record[n++] = (uint8_t)(type << 4 | arg);
+  uint32_t delta = now_us - trace->last_us;
+  do {
+    uint8_t byte = delta & 0x7F;
+    delta >>= 7;
+    record[n++] = delta ? byte | 0x80 : byte;
+  } while (delta);
+  if (payload_len) memcpy(record + n, payload, (size_t)payload_len);
+  n += (uint8_t)payload_len;
+
+  if (trace->cap - trace->len < n) {
+    trace->dropped++;
+    return false;
+  }
+  memcpy(trace->buf + trace->len, record, n);
+  trace->len += n;
+  trace->last_us = now_us;
+  trace->records++;
+  return true;
+}
+
+void input_trace_seal(input_trace_t* trace) {
+  if (!trace->cap) return;
+  trace->buf[HDR_FLAGS] = trace->dropped ? INPUT_TRACE_FLAG_TRUNCATED : 0;
+  put_u32(trace->buf + HDR_BYTES, trace->len - INPUT_TRACE_HEADER_SIZE);
+}
+
+static int16_t saturate_i16(float v) {
+  if (v >= 32767.0f) return 32767;
+  if (v <= -32768.0f) return -32768;
+  return (int16_t)(v < 0 ? v - 0.5f : v + 0.5f);
+}
+
+void input_trace_pack_imu(const float acc[3], const float gyro[3], uint8_t payload[INPUT_TRACE_MAX_PAYLOAD]) {
+  for (uint8_t i = 0; i < 6; i++) {
+    int16_t v = i < 3 ? saturate_i16(acc[i] * 1000.0f) : saturate_i16(gyro[i - 3] * 10.0f);
+    payload[i * 2] = (uint8_t)v;
+    payload[i * 2 + 1] = (uint8_t)((uint16_t)v >> 8);
+  }
+}
+
+void input_trace_unpack_imu(const uint8_t payload[INPUT_TRACE_MAX_PAYLOAD], float acc[3], float gyro[3]) {
+  for (uint8_t i = 0; i < 6; i++) {
+    int16_t v = (int16_t)(payload[i * 2] | payload[i * 2 + 1] << 8);
+    if (i < 3) {
+      acc[i] = v / 1000.0f;
+    } else {
+      gyro[i - 3] = v / 10.0f;
+    }
+  }
+}
+
+input_trace_result_t input_trace_open(input_trace_reader_t* reader, const uint8_t* data, uint32_t len) {
+  memset(reader, 0, sizeof(*reader));
+  if (!data || len < INPUT_TRACE_HEADER_SIZE || memcmp(data, INPUT_TRACE_MAGIC, 4) != 0 ||
+      data[HDR_VERSION] != INPUT_TRACE_VERSION) {
+    return INPUT_TRACE_ERR_HEADER;
+  }
+  uint32_t bytes = get_u32(data + HDR_BYTES);
+  if (bytes > len - INPUT_TRACE_HEADER_SIZE) return INPUT_TRACE_ERR_SIZE;
+
+  reader->data = data;
+  reader->len = INPUT_TRACE_HEADER_SIZE + bytes;
+  reader->pos = INPUT_TRACE_HEADER_SIZE;
+  reader->start_us = get_u32(data + HDR_START);
+  reader->truncated = (data[HDR_FLAGS] & INPUT_TRACE_FLAG_TRUNCATED) != 0;
+  reader->time_us = reader->start_us;
+  return INPUT_TRACE_OK;
+}
+
+input_trace_result_t input_trace_next(input_trace_reader_t* reader, input_trace_record_t* record) {
+  memset(record, 0, sizeof(*record));
+  if (reader->pos >= reader->len) return INPUT_TRACE_OK;
+
+  uint8_t tag = reader->data[reader->pos++];
+  int8_t payload_len = input_trace_payload_len(tag >> 4);
+  if (payload_len < 0) return INPUT_TRACE_ERR_RECORD;
+
+  uint32_t delta = 0;
+  for (uint8_t shift = 0;; shift += 7) {
+    if (reader->pos >= reader->len || shift > 28) return INPUT_TRACE_ERR_RECORD;
+    uint8_t byte = reader->data[reader->pos++];
+    delta |= (uint32_t)(byte & 0x7F) << shift;
+    if (!(byte & 0x80)) break;
+  }
+  if (reader->len - reader->pos < (uint32_t)payload_len) return INPUT_TRACE_ERR_RECORD;
+
+  reader->time_us += delta;
+  record->type = tag >> 4;
+  record->arg = tag & 0x0F;
+  record->len = (uint8_t)payload_len;
+  memcpy(record->payload, reader->data + reader->pos, (size_t)payload_len);
+  record->time_us = reader->time_us;
+  reader->pos += (uint32_t)payload_len;
+  return INPUT_TRACE_OK;
+}
+
+const char* input_trace_result_str(input_trace_result_t result) {
+  switch (result) {
+  case INPUT_TRACE_OK: return "ok";
+  case INPUT_TRACE_ERR_HEADER: return "not a trace file";
+  case INPUT_TRACE_ERR_SIZE: return "length mismatch";
+  case INPUT_TRACE_ERR_RECORD: return "bad record";
+  }
+  return "?";
+}
+
+const char* input_trace_type_name(uint8_t type) {
+  static const char* const names[INPUT_TRACE_TYPE_COUNT] = {"?", "tick", "serial", "wifi", "rssi", "imu"};
+  return type < INPUT_TRACE_TYPE_COUNT ? names[type] : "?";
+}
@@ -0,0 +1,95 @@
+//** ESP32-S3 HoloCubic - Input Trace Codec Header
+//** Linus原则：只记外面进来的东西 - 输入一样，主循环走的路就一样
+//**
+//** - 记录在固件读到输入的那一刻写：串口字节、WiFi状态和RSSI、IMU样本，外加每圈loop()一个节拍
+//** - 每条记录 = 1字节标签 (高4位类型，低4位小参数) + 距上一条的us (LEB128变长) + 定长负载
+//**   节拍记录通常只有2字节，一秒几百圈也只要几KB
+//** - 文件 = 16字节头 + 记录；缓冲满了就停，头里标记截断
+//** - 纯函数，时间由调用者传进来 (us)；设备上的记录在app_trace，主机上的回放在src/native/sim_main.cpp
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define INPUT_TRACE_MAGIC         "HCTR"
+#define INPUT_TRACE_VERSION       2
+#define INPUT_TRACE_HEADER_SIZE   16
+#define INPUT_TRACE_MAX_PAYLOAD   12
+#define INPUT_TRACE_MAX_RECORD    (1 + 5 + INPUT_TRACE_MAX_PAYLOAD)
+#define INPUT_TRACE_FLAG_TRUNCATED 0x01
+
+typedef enum {
+  INPUT_TRACE_TICK = 1,       // loop()开始一圈
+  INPUT_TRACE_SERIAL,         // 负载: 读到的字节
+  INPUT_TRACE_WIFI_STATUS,    // 负载: wl_status_t (WL_NO_SHIELD是255，小参数放不下)
+  INPUT_TRACE_WIFI_RSSI,      // 负载: int8 dBm
+  INPUT_TRACE_IMU,            // 小参数: 手势编号；负载: 加速度 (mg) 和角速度 (0.1 dps)，各3个int16
+  INPUT_TRACE_TYPE_COUNT
+} input_trace_type_t;
+
+typedef enum {
+  INPUT_TRACE_OK = 0,
+  INPUT_TRACE_ERR_HEADER,     // 不是记录文件，或者版本不对
+  INPUT_TRACE_ERR_SIZE,       // 头里的长度和数据对不上
+  INPUT_TRACE_ERR_RECORD,     // 记录类型未知或者被截断
+} input_trace_result_t;
+
+//** 记录器 - 缓冲由调用者给
+typedef struct {
+  uint8_t* buf;
+  uint32_t cap;
+  uint32_t len;                 // 已写字节，含头
+  uint32_t last_us;             // 上一条记录的时间
+  uint32_t records;
+  uint32_t dropped;             // 缓冲满了没写进去的
+} input_trace_t;
+
+typedef struct {
+  uint8_t type;                 // input_trace_type_t
+  uint8_t arg;                  // 小参数 (0-15)
+  uint8_t len;                  // 负载字节
+  uint8_t payload[INPUT_TRACE_MAX_PAYLOAD];
+  uint64_t time_us;             // 从记录开始算的绝对时间 (start_us + 累加的间隔)
+} input_trace_record_t;
+
+typedef struct {
+  const uint8_t* data;
+  uint32_t len;
+  uint32_t pos;
+  uint32_t start_us;            // 开始记录时设备的micros()
+  bool truncated;
+  uint64_t time_us;
+} input_trace_reader_t;
+
+//** 写入头，从now_us开始记
+void input_trace_init(input_trace_t* trace, uint8_t* buf, uint32_t cap, uint32_t now_us);
+
+//** 追加一条 - 负载长度由类型决定；满了返回false
+bool input_trace_put(input_trace_t* trace, uint32_t now_us, uint8_t type, uint8_t arg, const uint8_t* payload);
+
+//** 把当前长度和截断标记写回头里 - 之后buf[0, len)就是一个完整的记录文件
+void input_trace_seal(input_trace_t* trace);
+
+//** 每种类型的负载字节数；未知类型返回-1
+int8_t input_trace_payload_len(uint8_t type);
+
+//** IMU样本和负载互转 - 超出int16范围的饱和
+void input_trace_pack_imu(const float acc[3], const float gyro[3], uint8_t payload[INPUT_TRACE_MAX_PAYLOAD]);
+void input_trace_unpack_imu(const uint8_t payload[INPUT_TRACE_MAX_PAYLOAD], float acc[3], float gyro[3]);
+
+//** 读
+input_trace_result_t input_trace_open(input_trace_reader_t* reader, const uint8_t* data, uint32_t len);
+//** 下一条；读完返回INPUT_TRACE_OK并把record->type置0
+input_trace_result_t input_trace_next(input_trace_reader_t* reader, input_trace_record_t* record);
+
+const char* input_trace_result_str(input_trace_result_t result);
+const char* input_trace_type_name(uint8_t type);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,57 @@
+//** ESP32-S3 HoloCubic - Log-Linear Latency Histogram Implementation
+//** Linus原则：格号 = 指数 * 8 + 最高位后面的3位，不查表不循环
+
+#include "lat_hist.h"
+#include <string.h>
+
+void lat_hist_reset(lat_hist_t* hist) {
+  memset(hist, 0, sizeof(*hist));
+}
+
+uint32_t lat_hist_bucket(uint32_t value) {
+  if (value < LAT_HIST_SUB) return value;
+  uint32_t exp = 31 - (uint32_t)__builtin_clz(value);           // 最高位
+  uint32_t shift = exp - LAT_HIST_SUB_BITS;
+  return (shift + 1) * LAT_HIST_SUB + ((value >> shift) - LAT_HIST_SUB);
+}
+
+uint32_t lat_hist_bucket_low(uint32_t bucket) {
+  if (bucket < LAT_HIST_SUB) return bucket;
+  uint32_t shift = bucket / LAT_HIST_SUB - 1;
+  return (LAT_HIST_SUB + bucket % LAT_HIST_SUB) << shift;
+}
+
+uint32_t lat_hist_bucket_high(uint32_t bucket) {
+  if (bucket < LAT_HIST_SUB) return bucket;
+  uint32_t shift = bucket / LAT_HIST_SUB - 1;
+  return lat_hist_bucket_low(bucket) + ((1u << shift) - 1);
+}
+
+void lat_hist_add(lat_hist_t* hist, uint32_t value) {
+  hist->counts[lat_hist_bucket(value)]++;
+  if (hist->samples == 0 || value < hist->min) hist->min = value;
+  if (value > hist->max) hist->max = value;
+  hist->samples++;
+  hist->total += value;
+}
+
+uint32_t lat_hist_percentile(const lat_hist_t* hist, uint8_t percent) {
+  if (hist->samples == 0) return 0;
+  if (percent > 100) percent = 100;
+
+  //** 向上取整，和frame_hist_percentile一样
+  uint32_t target = (uint32_t)(((uint64_t)hist->samples * percent + 99) / 100);
+  if (target == 0) return hist->min;
+
+  uint32_t seen = 0;
+  for (uint32_t i = 0; i < LAT_HIST_BUCKETS; i++) {
+    seen += hist->counts[i];
+    if (seen >= target) {
+      uint32_t high = lat_hist_bucket_high(i);
+      if (high > hist->max) high = hist->max;
+      return high < hist->min ? hist->min : high;
+    }
+  }
+  //** 另一个核正在加样本时counts和samples可能差一点
+  return hist->max;
+}
@@ -0,0 +1,42 @@
+//** ESP32-S3 HoloCubic - Log-Linear Latency Histogram Header
+//** Linus原则：固定大小，加一个样本只有几条指令 - 可以一直开着
+//**
+//** - 每个2的幂区间再线性分成8格，相对误差不超过1/8；小于8的值每个值一格
+//** - 覆盖整个uint32范围，不用预先知道最大值；单位由调用者决定 (app_profile里是CPU周期)
+//** - 百分位返回所在格的上界，再用真实的最大值封顶
+//** - 纯函数，和frame_hist一样可以在主机上测
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LAT_HIST_SUB_BITS   3
+#define LAT_HIST_SUB        (1u << LAT_HIST_SUB_BITS)             // 每个2的幂区间的格数
+#define LAT_HIST_BUCKETS    ((33 - LAT_HIST_SUB_BITS) * LAT_HIST_SUB) // 240
+
+typedef struct {
+  uint32_t counts[LAT_HIST_BUCKETS];
+  uint32_t samples;
+  uint32_t min;
+  uint32_t max;
+  uint64_t total;
+} lat_hist_t;
+
+void lat_hist_reset(lat_hist_t* hist);
+void lat_hist_add(lat_hist_t* hist, uint32_t value);
+
+//** 值落在哪一格，以及这一格的上下界 (都含)
+uint32_t lat_hist_bucket(uint32_t value);
+uint32_t lat_hist_bucket_low(uint32_t bucket);
+uint32_t lat_hist_bucket_high(uint32_t bucket);
+
+//** 百分位 - 至少percent%的样本不超过返回值；没有样本返回0
+uint32_t lat_hist_percentile(const lat_hist_t* hist, uint8_t percent);
+
+#ifdef __cplusplus
+}
+#endif
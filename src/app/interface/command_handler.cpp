@@ -1,10 +1,19 @@
 //** ESP32-S3 HoloCubic - Command Handler Implementation
 //** Linus原则：简单的命令分发，无复杂逻辑
+//**
+//** 串口按行收，一行是 "命令 参数..."；命令在command_line的表里查，这里只管收字节、报错和转发
+//** 同一个串口上还走二进制帧 (usb_link) - 0x00开头的一段归它，其余的字节才进行缓冲
 
 #include "command_handler.h"
+#include "command_line.h"
+#include "usb_link.h"
 #include "../../config/app_config.h" // 测试代码控制
 #include "../network/wifi_app.h"
+#include "../core/app_main.h"
+#include "../core/app_profile.h"
+#include "../core/app_trace.h"
 #include "../../core/config/app_constants.h"
+#include "../../core/config/hardware_config.h"
 
 #if ENABLE_LED_TESTS
 #include "../../test/led_test.h"
@@ -16,147 +25,413 @@
 
 #if ENABLE_DEBUG_COMMANDS
 #include "../../system/debug_utils.h"
+#include "../../drivers/display/display_bench.h"
 #endif
 
 #include "../../drivers/led/led_driver.h"
+#include "../../system/serial_out.h"
 #include <Arduino.h>
+#include <SPIFFS.h>
+#include <string.h>
 
-void command_handler_init(void) { 
-  //** 命令处理器初始化 - 无需状态跟踪
-}
+#define COMMAND_RX_CHUNK   64       // 一次从驱动拿多少字节
+#define COMMAND_RX_BUDGET  512      // 一次调用最多处理多少字节，剩下的下一轮再来
+
+static command_forward_fn g_forward = NULL;
+static command_line_t g_line;
+static command_stats_t g_stats;
+
+//** 从驱动拿出来还没处理的字节 - usb_link忙的时候剩下的留到下一次
+static uint8_t g_rx[COMMAND_RX_CHUNK];
+static uint8_t g_rx_pos = 0, g_rx_len = 0;
 
 static void show_help(void) {
-  Serial.println("\n=== Commands ===");
-  Serial.println("h - Help");
+  serial_out.println("\n=== Commands ===");
+  for (uint8_t i = 0; i < command_count(); i++) {
+    const command_t *command = command_at(i);
+    if (command->help) serial_out.println(command->help);
+  }
+  serial_out.println("================\n");
+}
+
+//** 帧时间一行 - 百分位是直方图格的上界
+static void print_frame_hist(const char* name, const frame_hist_t* hist) {
+  uint32_t avg = hist->samples ? (uint32_t)(hist->total_us / hist->samples) : 0;
+  serial_out.printf("%-9s %7u %7u %7u %7u %7u\n", name, frame_hist_percentile(hist, 50),
+                frame_hist_percentile(hist, 95), frame_hist_percentile(hist, 99), hist->max_us, avg);
+}
+
+static void show_frame_stats(void) {
+  const frame_pacer_t *pacer = app_frame_pacer();
+  serial_out.println("\n=== Frame Stats ===");
+  serial_out.printf("Target: %u fps (%u us), frames: %u, skipped: %u\n",
+                1000000u / pacer->period_us, pacer->period_us, pacer->frames, pacer->skipped);
+  serial_out.println("us            p50     p95     p99     max     avg");
+  print_frame_hist("interval", &pacer->interval);
+  print_frame_hist("render", &pacer->render);
+  print_frame_hist("flush", &pacer->flush);
+  print_frame_hist("idle", &pacer->idle);
+  const led_stats_t *led = led_get_stats();
+  serial_out.printf("LED show: %u sent, %u unchanged, %u deferred\n", led->shows, led->skipped, led->deferred);
+  static const char *const loop_names[APP_LOOP_COUNT] = {"render", "io"};
+  for (uint8_t loop = 0; loop < APP_LOOP_COUNT; loop++) {
+    const app_sched_t *sched = app_scheduler((app_loop_id_t)loop);
+    serial_out.printf("Sched %s: %u wakeups, %u runs, worst late %u us\n", loop_names[loop], sched->wakeups, sched->runs,
+                  sched->max_late_us);
+    for (uint8_t i = 0; i < sched->count; i++) {
+      serial_out.printf("  %-9s %7u runs, late max %6u us\n", sched->tasks[i].name, sched->tasks[i].runs,
+                    sched->tasks[i].max_late_us);
+    }
+  }
+  const app_msg_stats_t *inbox = app_inbox_stats();
+  serial_out.printf("Inbox: %u posted, %u dropped, peak %u\n", inbox->posted, inbox->dropped, inbox->peak);
+  const event_bus_t *bus = app_event_bus();
+  serial_out.printf("Events: %u posted, %u dropped, %u delivered, latency max %u us, avg %u us\n", bus->posted,
+                bus->dropped, bus->delivered, bus->max_latency_us,
+                bus->dispatched ? (uint32_t)(bus->total_latency_us / bus->dispatched) : 0);
+  serial_out.println("===================\n");
+}
+
+//** 每个模块一次调用的耗时 - 直方图里是CPU周期，换算成us打印
+static void show_module_latency(void) {
+  uint32_t mhz = ESP.getCpuFreqMHz();
+  if (mhz == 0) mhz = 1;
+  serial_out.println("\n=== Module Latency (us) ===");
+  serial_out.println("module       calls      p50      p99      max      avg");
+  for (uint8_t i = 0; i < APP_PROF_COUNT; i++) {
+    const lat_hist_t *hist = app_prof_hist((app_prof_id_t)i);
+    if (!hist || hist->samples == 0) {
+      serial_out.printf("%-9s %8u        -        -        -        -\n", app_prof_name((app_prof_id_t)i), 0u);
+      continue;
+    }
+    uint32_t avg = (uint32_t)(hist->total / hist->samples);
+    serial_out.printf("%-9s %8u %8.1f %8.1f %8.1f %8.1f\n", app_prof_name((app_prof_id_t)i), hist->samples,
+                  lat_hist_percentile(hist, 50) / (float)mhz, lat_hist_percentile(hist, 99) / (float)mhz,
+                  hist->max / (float)mhz, avg / (float)mhz);
+  }
+  serial_out.println("===========================\n");
+}
+
+//** 存输入记录 - 在IO核上写SPIFFS，渲染核照常追加，只存到调用时为止
+static void save_input_trace(void) {
+  const input_trace_t* stats = app_trace_stats();
+  if (!stats) {
+    serial_out.println("Input trace disabled (HW_TRACE_BYTES=0)");
+    return;
+  }
+  uint32_t start = millis();
+  if (!app_trace_save(SPIFFS, HW_TRACE_FILE)) {
+    serial_out.println("Input trace save failed");
+    return;
+  }
+  serial_out.printf("Input trace: %u records, %u bytes%s -> %s (%lu ms)\n", stats->records, stats->len,
+                stats->dropped ? ", truncated" : "", HW_TRACE_FILE, millis() - start);
+}
 
 #if ENABLE_DEBUG_COMMANDS
-  Serial.println("c - Show config");
-#endif
+//** 显示基准 - CSV逐行打到串口，屏幕会被画花
+static uint32_t bench_clock(void) { return micros(); }
 
-  //** WiFi commands
-  Serial.println("w - WiFi status");
+static void bench_emit(void *ctx, const char *line) { serial_out.println(line); }
 
-#if ENABLE_LED_TESTS
-  Serial.println("1 - LED Basic test");
-  Serial.println("2 - LED HSV test");
-  Serial.println("3 - LED Brightness test");
+static void run_display_bench(void) {
+  display_bench_config_t config = {bench_clock, bench_emit, NULL, HW_DISPLAY_SPI_FREQ, 1};
+  display_bench_run(&config);
+}
 #endif
 
-#if ENABLE_TFT_TESTS
-  Serial.println("4 - TFT Display test (WiFi info display)");
-#endif
+//** WiFi状态查询 - 只读取，不管理
+static void show_wifi_status(void) {
+  const wifi_app_t *wifi_state = wifi_app_get_state();
+  serial_out.println("\n=== WiFi Status ===");
+  if (wifi_state->is_ready) {
+    serial_out.println("✓ Connected");
+    serial_out.print("Signal: ");
+    serial_out.print(wifi_state->rssi);
+    serial_out.println(" dBm");
+    uint32_t uptime = (millis() - wifi_state->connect_time) / MILLISECONDS_TO_SECONDS; // 原魔数: 1000
+    serial_out.print("Uptime: ");
+    serial_out.print(uptime / SECONDS_TO_MINUTES); // 原魔数: 60
+    serial_out.print("m ");
+    serial_out.print(uptime % SECONDS_TO_MINUTES); // 原魔数: 60
+    serial_out.println("s");
+  } else {
+    serial_out.println("✗ Not Connected");
+    const char *state_str;
+    switch (wifi_state->state) {
+    case WIFI_STATE_CONNECTING:
+      state_str = "Connecting...";
+      break;
+    case WIFI_STATE_FAILED:
+      state_str = "Failed";
+      break;
+    default:
+      state_str = "Idle";
+      break;
+    }
+    serial_out.print("State: ");
+    serial_out.println(state_str);
+  }
+  serial_out.println("==================\n");
+}
 
-  Serial.println("r/g/b - Red/Green/Blue");
-  Serial.println("o - Off");
+static void show_command_stats(void) {
+  serial_out.println("\n=== Commands Stats ===");
+  serial_out.printf("RX %u bytes, %u lines: %u run, %u forwarded, %u busy\n", g_stats.bytes, g_stats.lines,
+                g_stats.executed, g_stats.forwarded, g_stats.busy);
+  serial_out.printf("Errors: %u unknown, %u bad args, %u too long\n", g_stats.unknown, g_stats.bad_args,
+                g_stats.too_long);
+  serial_out.println("======================\n");
+}
 
-#if ENABLE_TEST_CODE
-  Serial.println("--- Test Commands (Development Only) ---");
-#endif
+static void show_link_stats(void) {
+  const usb_link_stats_t *link = usb_link_stats();
+  serial_out.println("\n=== Binary Link Stats ===");
+  serial_out.printf("RX %u bytes, %u frames, %u errors, %u resent, %u busy\n", link->rx_bytes, link->rx_frames,
+                link->errors, link->resent, link->busy);
+  serial_out.printf("TX %u bytes, %u frames; %u images, %u files\n", link->tx_bytes, link->tx_frames,
+                link->fb_uploads, link->files);
+  serial_out.println("=========================\n");
+}
+
+//** ========================================
+//** 命令 - argv[0]是命令名，参数个数已经查过
+//** ========================================
 
-  Serial.println("================\n");
+static void cmd_help(uint8_t argc, char *argv[]) { show_help(); }
+static void cmd_wifi(uint8_t argc, char *argv[]) { show_wifi_status(); }
+static void cmd_frame_stats(uint8_t argc, char *argv[]) { show_frame_stats(); }
+static void cmd_latency(uint8_t argc, char *argv[]) { show_module_latency(); }
+static void cmd_trace_save(uint8_t argc, char *argv[]) { save_input_trace(); }
+
+static void cmd_latency_reset(uint8_t argc, char *argv[]) {
+  app_prof_reset();
+  serial_out.println("Module latency reset");
 }
 
-void command_handler_process(void) {
-  if (!Serial.available()) {
-    return;
+static void cmd_frame_reset(uint8_t argc, char *argv[]) {
+  frame_pacer_reset_stats(app_frame_pacer());
+  led_reset_stats();
+  app_sched_reset_stats(app_scheduler(APP_LOOP_RENDER));
+  app_sched_reset_stats(app_scheduler(APP_LOOP_IO));
+  event_bus_reset_stats(app_event_bus());
+  memset(&g_stats, 0, sizeof(g_stats));
+  serial_out.println("Frame stats reset");
+}
+
+//** 统计页 - 不带参数全打；在渲染核上跑，其余几页只是读
+static const struct {
+  const char *name;
+  void (*show)(void);
+} stats_pages[] = {
+  {"frame", show_frame_stats},
+  {"latency", show_module_latency},
+  {"wifi", show_wifi_status},
+  {"cmd", show_command_stats},
+  {"link", show_link_stats},
+};
+
+static void cmd_stats(uint8_t argc, char *argv[]) {
+  const char *page = argc > 1 ? argv[1] : "all";
+  bool all = strcmp(page, "all") == 0;
+  bool shown = false;
+  for (uint8_t i = 0; i < sizeof(stats_pages) / sizeof(stats_pages[0]); i++) {
+    if (!all && strcmp(page, stats_pages[i].name) != 0) continue;
+    stats_pages[i].show();
+    shown = true;
   }
+  if (!shown) serial_out.printf("Unknown stats page '%s' (frame|latency|wifi|cmd|link|all)\n", page);
+}
 
-  char cmd = Serial.read();
-
-  //** WiFi状态查询 - 只读取，不管理
-  if (cmd == 'w') {
-    const wifi_app_t *wifi_state = wifi_app_get_state();
-    Serial.println("\n=== WiFi Status ===");
-    if (wifi_state->is_ready) {
-      Serial.println("✓ Connected");
-      Serial.print("Signal: ");
-      Serial.print(wifi_state->rssi);
-      Serial.println(" dBm");
-      uint32_t uptime = (millis() - wifi_state->connect_time) / MILLISECONDS_TO_SECONDS; // 原魔数: 1000
-      Serial.print("Uptime: ");
-      Serial.print(uptime / SECONDS_TO_MINUTES); // 原魔数: 60
-      Serial.print("m ");
-      Serial.print(uptime % SECONDS_TO_MINUTES); // 原魔数: 60
-      Serial.println("s");
-    } else {
-      Serial.println("✗ Not Connected");
-      const char *state_str;
-      switch (wifi_state->state) {
-      case WIFI_STATE_CONNECTING:
-        state_str = "Connecting...";
-        break;
-      case WIFI_STATE_FAILED:
-        state_str = "Failed";
-        break;
-      default:
-        state_str = "Idle";
-        break;
-      }
-      Serial.print("State: ");
-      Serial.println(state_str);
-    }
-    Serial.println("==================\n");
+static void cmd_brightness(uint8_t argc, char *argv[]) {
+  uint32_t level;
+  if (!command_arg_u32(argv[1], 0, 255, &level)) {
+    serial_out.printf("Bad brightness '%s' (0-255)\n", argv[1]);
     return;
   }
+  led_set_brightness((uint8_t)level);
+  serial_out.printf("LED brightness: %u\n", level);
+}
 
-  switch (cmd) {
-  case 'h':
-    show_help();
-    break;
+static void cmd_red(uint8_t argc, char *argv[]) {
+  led_red();
+  serial_out.println("LED: Red");
+}
+
+static void cmd_green(uint8_t argc, char *argv[]) {
+  led_green();
+  serial_out.println("LED: Green");
+}
+
+static void cmd_blue(uint8_t argc, char *argv[]) {
+  led_blue();
+  serial_out.println("LED: Blue");
+}
+
+static void cmd_off(uint8_t argc, char *argv[]) {
+  led_off();
+  serial_out.println("LED: Off");
+}
 
 #if ENABLE_DEBUG_COMMANDS
-  case 'c':
-    debug_print_hw_config();
-    break;
+static void cmd_config(uint8_t argc, char *argv[]) { debug_print_hw_config(); }
+static void cmd_display_bench(uint8_t argc, char *argv[]) { run_display_bench(); }
 #endif
 
 #if ENABLE_LED_TESTS
-  case '1':
-    led_test_basic();
-    break;
-
-  case '2':
-    led_test_hsv();
-    break;
+static void cmd_led_basic(uint8_t argc, char *argv[]) { led_test_basic(); }
+static void cmd_led_hsv(uint8_t argc, char *argv[]) { led_test_hsv(); }
+static void cmd_led_brightness(uint8_t argc, char *argv[]) { led_test_brightness(); }
+#endif
 
-  case '3':
-    led_test_brightness();
-    break;
+#if ENABLE_TFT_TESTS
+static void cmd_tft_test(uint8_t argc, char *argv[]) { tft_display_test_run(); }
 #endif
 
+//** 单字母的是原来的按键命令，保留下来；COMMAND_RENDER的动渲染核的东西：帧统计、显示基准、LED测试和颜色、TFT测试
+static const command_t commands[] = {
+  {"h",      cmd_help,          "h | help - Help",                            0, 0, 0},
+  {"help",   cmd_help,          NULL,                                         0, 0, 0},
+  {"w",      cmd_wifi,          "w - WiFi status",                            0, 0, 0},
+  {"f",      cmd_frame_stats,   "f/F - Frame + LED stats / reset",            0, 0, COMMAND_RENDER},
+  {"F",      cmd_frame_reset,   NULL,                                         0, 0, COMMAND_RENDER},
+  {"p",      cmd_latency,       "p/P - Per-module latency / reset",           0, 0, 0},
+  {"P",      cmd_latency_reset, NULL,                                         0, 0, 0},
+  {"stats",  cmd_stats,         "stats [frame|latency|wifi|cmd|link|all] - Stats page", 0, 1, COMMAND_RENDER},
+  {"T",      cmd_trace_save,    "T - Save input trace (" HW_TRACE_FILE ")",   0, 0, 0},
+  {"bright", cmd_brightness,    "bright <0-255> - LED brightness",            1, 1, COMMAND_RENDER},
+  {"r",      cmd_red,           "r/g/b - Red/Green/Blue",                     0, 0, COMMAND_RENDER},
+  {"g",      cmd_green,         NULL,                                         0, 0, COMMAND_RENDER},
+  {"b",      cmd_blue,          NULL,                                         0, 0, COMMAND_RENDER},
+  {"o",      cmd_off,           "o - Off",                                    0, 0, COMMAND_RENDER},
+#if ENABLE_DEBUG_COMMANDS
+  {"c",      cmd_config,        "c - Show config",                            0, 0, 0},
+  {"B",      cmd_display_bench, "B - Display benchmark (CSV)",                0, 0, COMMAND_RENDER},
+#endif
+#if ENABLE_LED_TESTS
+  {"1",      cmd_led_basic,     "1 - LED Basic test",                         0, 0, COMMAND_RENDER},
+  {"2",      cmd_led_hsv,       "2 - LED HSV test",                           0, 0, COMMAND_RENDER},
+  {"3",      cmd_led_brightness, "3 - LED Brightness test",                   0, 0, COMMAND_RENDER},
+#endif
 #if ENABLE_TFT_TESTS
-  case '4':
-    tft_display_test_run();
-    break;
+  {"4",      cmd_tft_test,      "4 - TFT Display test (WiFi info display)",   0, 0, COMMAND_RENDER},
 #endif
+};
 
-  //** 基础LED控制 - 生产环境保留
-  case 'r':
-    led_red();
-    Serial.println("LED: Red");
-    break;
+void command_handler_init(void) {
+  command_line_reset(&g_line);
+  usb_link_init();
+  if (!command_register(commands, sizeof(commands) / sizeof(commands[0]))) {
+    serial_out.println("  命令表登记失败 (重名或表满)");
+  }
+}
 
-  case 'g':
-    led_green();
-    Serial.println("LED: Green");
-    break;
+void command_handler_set_forward(command_forward_fn forward) {
+  g_forward = forward;
+}
 
-  case 'b':
-    led_blue();
-    Serial.println("LED: Blue");
-    break;
+const command_stats_t *command_handler_stats(void) {
+  return &g_stats;
+}
 
-  case 'o':
-    led_off();
-    Serial.println("LED: Off");
+//** 报错只在收行的IO核上打；转发过去的行已经检查过
+static void report_error(command_result_t result, const command_t *command, const char *name) {
+  switch (result) {
+  case COMMAND_UNKNOWN:
+    g_stats.unknown++;
+    serial_out.printf("Unknown command: '%s' (h for help)\n", name);
+    break;
+  case COMMAND_BAD_ARGS:
+    g_stats.bad_args++;
+    serial_out.printf("Usage: %s\n", command->help ? command->help : command->name);
+    break;
+  case COMMAND_TOO_LONG:
+    g_stats.too_long++;
+    serial_out.printf("Line too long (max %d chars, %d words)\n", COMMAND_LINE_MAX - 1, COMMAND_MAX_ARGS);
     break;
-
-#if ENABLE_TEST_CODE
   default:
-    if (cmd >= ASCII_PRINTABLE_START && cmd <= ASCII_PRINTABLE_END) { // 可打印字符 (原魔数: 32, 126)
-      Serial.printf("Unknown command: '%c' (Test mode enabled)\n", cmd);
-    }
     break;
-#endif
   }
-}
\ No newline at end of file
+}
+
+//** 一整行 - 查表，要么在这里执行，要么整行转发给渲染核
+static void command_handler_line(void) {
+  if (g_line.overflow) {
+    report_error(COMMAND_TOO_LONG, NULL, NULL);
+    return;
+  }
+
+  char text[COMMAND_LINE_MAX];
+  memcpy(text, g_line.buf, (size_t)g_line.len + 1);
+  const command_t *command;
+  uint8_t argc;
+  char *argv[COMMAND_MAX_ARGS];
+  command_result_t result = command_parse(text, &command, &argc, argv);
+  if (result == COMMAND_EMPTY) return;
+
+  g_stats.lines++;
+  if (result != COMMAND_OK) {
+    report_error(result, command, argv[0]);
+    return;
+  }
+
+  event_publish(EVENT_COMMAND, (uint8_t)command->name[0], argc - 1);
+  if (g_forward && (command->flags & COMMAND_RENDER)) {
+    if (g_forward(g_line.buf)) {
+      g_stats.forwarded++;
+    } else {
+      g_stats.busy++;
+      serial_out.printf("Busy, command '%s' dropped\n", command->name);
+    }
+    return;
+  }
+  g_stats.executed++;
+  command->fn(argc, argv);
+}
+
+bool command_handler_process(void) {
+  uint32_t budget = COMMAND_RX_BUDGET;
+
+  while (budget) {
+    if (g_rx_pos == g_rx_len) {
+      int available = Serial.available();
+      if (available <= 0) break;
+      size_t want = (size_t)available < sizeof(g_rx) ? (size_t)available : sizeof(g_rx);
+      if (want > budget) want = budget;
+      g_rx_len = (uint8_t)Serial.read(g_rx, want);
+      g_rx_pos = 0;
+      if (g_rx_len == 0) break;
+      budget -= g_rx_len;
+      g_stats.bytes += g_rx_len;
+      for (uint8_t i = 0; i < g_rx_len; i++) app_trace_serial(g_rx[i]);
+    }
+
+    while (g_rx_pos < g_rx_len) {
+      //** 上一帧还没处理掉 - 剩下的字节先不动
+      if (!usb_link_retry()) {
+        usb_link_flush();
+        return false;
+      }
+      uint8_t c = g_rx[g_rx_pos++];
+      if (usb_link_feed(c)) continue;
+      if (command_line_feed(&g_line, (char)c)) {
+        command_handler_line();
+        command_line_reset(&g_line);
+      }
+    }
+  }
+  usb_link_flush();
+  return g_rx_pos < g_rx_len || Serial.available() > 0;
+}
+
+void command_handler_execute(const char *line) {
+  char text[COMMAND_LINE_MAX];
+  strncpy(text, line, sizeof(text) - 1);
+  text[sizeof(text) - 1] = '\0';
+
+  const command_t *command;
+  uint8_t argc;
+  char *argv[COMMAND_MAX_ARGS];
+  if (command_parse(text, &command, &argc, argv) != COMMAND_OK) return;
+  command->fn(argc, argv);
+}
@@ -3,16 +3,42 @@
 
 #pragma once
 
+#include <stdbool.h>
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-//** 初始化命令处理器
+//** 初始化命令处理器 - 登记内置命令表；其他模块用command_register()登记自己的
 void command_handler_init(void);
 
-//** 处理串口命令 - 非阻塞
-void command_handler_process(void);
+//** 处理串口命令 - 非阻塞，在IO核上调用
+//** 把已经到了的字节收进行缓冲，每凑够一行执行一次；一次最多处理COMMAND_RX_BUDGET字节，还有剩的返回true
+//** 二进制帧交给usb_link；它忙 (usb_link_busy()) 时停下返回false，剩下的字节留到下一次
+bool command_handler_process(void);
+
+//** 碰显示或LED的命令交给渲染核 - 设置后这些命令整行通过forward转发，放不进去返回false
+typedef bool (*command_forward_fn)(const char* line);
+void command_handler_set_forward(command_forward_fn forward);
+
+//** 执行一行命令 - 渲染核收到转发的命令时调用
+void command_handler_execute(const char* line);
+
+//** 收行统计 - IO核写，统计页读
+typedef struct {
+  uint32_t bytes;
+  uint32_t lines;             // 非空行
+  uint32_t executed;          // 在IO核上执行的
+  uint32_t forwarded;         // 转发给渲染核的
+  uint32_t busy;              // 收件箱满了丢掉的
+  uint32_t unknown;
+  uint32_t bad_args;
+  uint32_t too_long;
+} command_stats_t;
+
+const command_stats_t* command_handler_stats(void);
 
 #ifdef __cplusplus
 }
-#endif
\ No newline at end of file
+#endif
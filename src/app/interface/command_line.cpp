@@ -0,0 +1,147 @@
+//** ESP32-S3 HoloCubic - Line Command Parser Implementation
+//** Linus原则：登记时排一次序，之后每次查找只比较log2(n)次
+
+#include "command_line.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const command_t* g_index[COMMAND_TABLE_MAX];
+static uint8_t g_count = 0;
+
+//** ========================================
+//** 收行
+//** ========================================
+
+void command_line_reset(command_line_t* line) {
+  line->len = 0;
+  line->overflow = false;
+  line->buf[0] = '\0';
+}
+
+bool command_line_feed(command_line_t* line, char c) {
+  if (c == '\r' || c == '\n') {
+    line->buf[line->len] = '\0';
+    return true;
+  }
+  if (c == '\b' || c == 0x7F) {
+    if (line->len && !line->overflow) line->len--;
+    return false;
+  }
+  if ((uint8_t)c < ' ') return false;
+
+  if (line->len < COMMAND_LINE_MAX - 1) {
+    line->buf[line->len++] = c;
+  } else {
+    line->overflow = true;
+  }
+  return false;
+}
+
+//** ========================================
+//** 命令表
+//** ========================================
+
+//** 第一个名字不小于name的位置；found表示正好相等
+static uint8_t index_lower_bound(const char* name, bool* found) {
+  uint8_t low = 0, high = g_count;
+  while (low < high) {
+    uint8_t mid = (uint8_t)((low + high) / 2);
+    if (strcmp(g_index[mid]->name, name) < 0) {
+      low = (uint8_t)(mid + 1);
+    } else {
+      high = mid;
+    }
+  }
+  *found = low < g_count && strcmp(g_index[low]->name, name) == 0;
+  return low;
+}
+
+bool command_register(const command_t* table, uint8_t count) {
+  for (uint8_t i = 0; i < count; i++) {
+    const command_t* command = &table[i];
+    if (!command->name || !command->name[0] || !command->fn || g_count >= COMMAND_TABLE_MAX) return false;
+
+    bool found;
+    uint8_t pos = index_lower_bound(command->name, &found);
+    if (found) return false;
+    memmove(&g_index[pos + 1], &g_index[pos], (size_t)(g_count - pos) * sizeof(g_index[0]));
+    g_index[pos] = command;
+    g_count++;
+  }
+  return true;
+}
+
+const command_t* command_find(const char* name) {
+  bool found;
+  uint8_t pos = index_lower_bound(name, &found);
+  return found ? g_index[pos] : NULL;
+}
+
+uint8_t command_count(void) {
+  return g_count;
+}
+
+const command_t* command_at(uint8_t index) {
+  return index < g_count ? g_index[index] : NULL;
+}
+
+void command_registry_reset(void) {
+  g_count = 0;
+}
+
+//** ========================================
+//** 解析
+//** ========================================
+
+int8_t command_tokenize(char* text, char* argv[], uint8_t max) {
+  uint8_t argc = 0;
+  char* p = text;
+  for (;;) {
+    while (*p == ' ' || *p == '\t') p++;
+    if (!*p) return (int8_t)argc;
+    if (argc >= max) return -1;
+    argv[argc++] = p;
+    while (*p && *p != ' ' && *p != '\t') p++;
+    if (*p) *p++ = '\0';
+  }
+}
+
+command_result_t command_parse(char* text, const command_t** command, uint8_t* argc, char* argv[]) {
+  *command = NULL;
+  *argc = 0;
+  int8_t count = command_tokenize(text, argv, COMMAND_MAX_ARGS);
+  if (count < 0) return COMMAND_TOO_LONG;
+  if (count == 0) return COMMAND_EMPTY;
+
+  *argc = (uint8_t)count;
+  *command = command_find(argv[0]);
+  if (!*command) return COMMAND_UNKNOWN;
+  uint8_t args = (uint8_t)(count - 1);
+  if (args < (*command)->min_args || args > (*command)->max_args) return COMMAND_BAD_ARGS;
+  return COMMAND_OK;
+}
+
+bool command_arg_u32(const char* text, uint32_t min, uint32_t max, uint32_t* value) {
+  //** strtoul会跳过前导空白、接受正负号 - 这里只要数字开头
+  if (!text || *text < '0' || *text > '9') return false;
+  //** 只有0x/0X才是十六进制；不用base 0，免得"010"被当成八进制的8
+  int base = (text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) ? 16 : 10;
+  char* end;
+  errno = 0;
+  unsigned long v = strtoul(text, &end, base);
+  if (*end || errno == ERANGE || v < min || v > max) return false;
+  *value = (uint32_t)v;
+  return true;
+}
+
+const char* command_result_str(command_result_t result) {
+  switch (result) {
+  case COMMAND_OK: return "ok";
+  case COMMAND_EMPTY: return "empty line";
+  case COMMAND_UNKNOWN: return "unknown command";
+  case COMMAND_BAD_ARGS: return "wrong number of arguments";
+  case COMMAND_TOO_LONG: return "line too long";
+  }
+  return "?";
+}
@@ -0,0 +1,79 @@
+//** ESP32-S3 HoloCubic - Line Command Parser Header
+//** Linus原则：命令是一张表，不是一个越长越大的switch
+//**
+//** - 按行收：\r或\n结束一行，退格删一个字符，其余控制字符丢掉；超长的整行作废
+//** - 就地切分成argv (空格/Tab分隔)，不分配内存
+//** - 各模块在初始化时把自己的命令表登记进来，登记时按名字插入一张有序索引，查找是二分
+//**   之后表只读，两个核都可以查
+//** - 纯函数，不碰串口；主机上压测 (src/native/command_bench_main.cpp)
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define COMMAND_LINE_MAX      48      // 含结尾的0 - 转发给渲染核时整行放进app_msg_t
+#define COMMAND_MAX_ARGS      8       // 含命令名
+#define COMMAND_TABLE_MAX     48
+
+#define COMMAND_RENDER        0x01    // 碰显示或LED - 转发到渲染核执行
+
+//** argv[0]是命令名；参数个数已经按min_args/max_args检查过
+typedef void (*command_fn)(uint8_t argc, char* argv[]);
+
+typedef struct {
+  const char* name;
+  command_fn fn;
+  const char* help;                   // "bright <0-255> - LED brightness"；NULL = 帮助里不列
+  uint8_t min_args;                   // 不含命令名
+  uint8_t max_args;
+  uint8_t flags;
+} command_t;
+
+typedef enum {
+  COMMAND_OK = 0,
+  COMMAND_EMPTY,                      // 空行
+  COMMAND_UNKNOWN,
+  COMMAND_BAD_ARGS,                   // 参数个数不对
+  COMMAND_TOO_LONG,                   // 行超过COMMAND_LINE_MAX-1，或者参数超过COMMAND_MAX_ARGS-1
+} command_result_t;
+
+typedef struct {
+  char buf[COMMAND_LINE_MAX];
+  uint8_t len;
+  bool overflow;
+} command_line_t;
+
+//** ---- 收行 ----
+void command_line_reset(command_line_t* line);
+//** 喂一个字节；一行结束时返回true，buf以0结尾 (overflow时内容不完整)。调用者处理完再reset
+bool command_line_feed(command_line_t* line, char c);
+
+//** ---- 命令表 ----
+//** 登记一张表 - 表要一直有效；满了或者重名返回false (同一张表里前面的已经登记)
+bool command_register(const command_t* table, uint8_t count);
+const command_t* command_find(const char* name);
+//** 按名字排好的第i个，help用
+uint8_t command_count(void);
+const command_t* command_at(uint8_t index);
+//** 清空索引 - 只给主机测试用
+void command_registry_reset(void);
+
+//** ---- 解析 ----
+//** 就地切分，返回个数；超过max返回-1
+int8_t command_tokenize(char* text, char* argv[], uint8_t max);
+//** 切分 + 查表 + 检查参数个数 - text会被改写，argv指向text里面
+command_result_t command_parse(char* text, const command_t** command, uint8_t* argc, char* argv[]);
+
+//** 十进制，0x/0X开头是十六进制 (前导0仍是十进制)，范围含两端；不是数或越界返回false
+bool command_arg_u32(const char* text, uint32_t min, uint32_t max, uint32_t* value);
+
+const char* command_result_str(command_result_t result);
+
+#ifdef __cplusplus
+}
+#endif
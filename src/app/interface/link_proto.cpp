@@ -0,0 +1,180 @@
+//** ESP32-S3 HoloCubic - Binary Link Protocol Implementation
+//** Linus原则：编码一遍过，解码原地做，不多拷一份
+
+#include "link_proto.h"
+#include <string.h>
+
+//** ========================================
+//** CRC-16/CCITT-FALSE - 查表，一个字节一次
+//** ========================================
+
+static uint16_t crc_table[256];
+static bool crc_ready = false;
+
+static void crc_init(void) {
+  for (uint16_t i = 0; i < 256; i++) {
+    uint16_t crc = (uint16_t)(i << 8);
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+    crc_table[i] = crc;
+  }
+  crc_ready = true;
+}
+
+uint16_t link_crc16(uint16_t crc, const uint8_t* data, size_t len) {
+  if (!crc_ready) crc_init();
+  for (size_t i = 0; i < len; i++) {
+    crc = (uint16_t)((crc << 8) ^ crc_table[(uint8_t)(crc >> 8) ^ data[i]]);
+  }
+  return crc;
+}
+
+//** ========================================
+//** COBS
+//** ========================================
+
+size_t link_cobs_encode(uint8_t* dst, const uint8_t* src, size_t len) {
+  size_t code_at = 0, out = 1;
+  uint8_t code = 1;
+  for (size_t i = 0; i < len; i++) {
+    if (src[i]) {
+      dst[out++] = src[i];
+      code++;
+    }
+    if (!src[i] || code == 0xFF) {
+      dst[code_at] = code;
+      code = 1;
+      code_at = out++;
+    }
+  }
+  dst[code_at] = code;
+  return out;
+}
+
+//** 输出不会比输入长，写的位置永远不超过读的位置，所以可以原地
+size_t link_cobs_decode(uint8_t* dst, const uint8_t* src, size_t len) {
+  size_t in = 0, out = 0;
+  while (in < len) {
+    uint8_t code = src[in++];
+    if (code == 0 || in + code - 1 > len) return 0;
+    for (uint8_t i = 1; i < code; i++) {
+      if (!src[in]) return 0;
+      dst[out++] = src[in++];
+    }
+    if (code != 0xFF && in < len) dst[out++] = 0;
+  }
+  return out;
+}
+
+size_t link_frame_encode(uint8_t* wire, const link_frame_t* frame) {
+  if (frame->len > LINK_PAYLOAD_MAX) return 0;
+
+  //** 先拼出原始帧，放在wire的尾部，再往前编码 - 编码的写位置追不上读位置
+  size_t raw_len = LINK_HEADER_SIZE + frame->len + LINK_CRC_SIZE;
+  uint8_t* raw = wire + LINK_WIRE_MAX - raw_len;
+  raw[0] = frame->msg;
+  raw[1] = frame->flags;
+  raw[2] = frame->seq;
+  raw[3] = frame->ack;
+  if (frame->len) memmove(raw + LINK_HEADER_SIZE, frame->payload, frame->len);
+  link_put_u16(raw + LINK_HEADER_SIZE + frame->len, link_crc16(0xFFFF, raw, LINK_HEADER_SIZE + frame->len));
+
+  wire[0] = LINK_ESCAPE;
+  size_t n = link_cobs_encode(wire + 1, raw, raw_len);
+  wire[1 + n] = LINK_ESCAPE;
+  return n + 2;
+}
+
+//** ========================================
+//** 收帧
+//** ========================================
+
+void link_rx_reset(link_rx_t* rx) {
+  rx->len = 0;
+  rx->in_frame = false;
+  rx->overflow = false;
+}
+
+bool link_rx_feed(link_rx_t* rx, uint8_t c, bool* done) {
+  *done = false;
+  if (!rx->in_frame) {
+    if (c != LINK_ESCAPE) return false;
+    rx->in_frame = true;
+    rx->overflow = false;
+    rx->len = 0;
+    return true;
+  }
+  if (c == LINK_ESCAPE) {
+    if (rx->len == 0) return true;      //** 空帧 - 还在帧里
+    rx->in_frame = false;
+    *done = true;
+    return true;
+  }
+  if (rx->len >= sizeof(rx->buf)) {
+    //** 不是帧 - 交还给文本，这一段已经丢了
+    rx->in_frame = false;
+    rx->overflow = true;
+    *done = true;
+    return false;
+  }
+  rx->buf[rx->len++] = c;
+  return true;
+}
+
+link_result_t link_rx_frame(link_rx_t* rx, link_frame_t* frame) {
+  if (rx->overflow) return LINK_ERR_TOO_LONG;
+  size_t n = link_cobs_decode(rx->buf, rx->buf, rx->len);
+  if (n == 0) return LINK_ERR_COBS;
+  if (n < LINK_HEADER_SIZE + LINK_CRC_SIZE || n > LINK_FRAME_MAX) return LINK_ERR_SHORT;
+  n -= LINK_CRC_SIZE;
+  if (link_crc16(0xFFFF, rx->buf, n) != link_get_u16(rx->buf + n)) return LINK_ERR_CRC;
+
+  frame->msg = rx->buf[0];
+  frame->flags = rx->buf[1];
+  frame->seq = rx->buf[2];
+  frame->ack = rx->buf[3];
+  frame->payload = rx->buf + LINK_HEADER_SIZE;
+  frame->len = (uint16_t)(n - LINK_HEADER_SIZE);
+  return LINK_OK;
+}
+
+//** ========================================
+//** 窗口
+//** ========================================
+
+uint8_t link_tx_acked(link_tx_window_t* win, uint8_t ack) {
+  uint8_t newly = (uint8_t)(ack - win->base);
+  if (newly > link_tx_in_flight(win)) return 0;
+  win->base = ack;
+  return newly;
+}
+
+link_seq_t link_seq_check(uint8_t expected, uint8_t seq) {
+  if (seq == expected) return LINK_SEQ_NEW;
+  //** 落在expected前面一个窗口里的是重发的；其余的说明中间丢了
+  return (uint8_t)(expected - seq) <= LINK_WINDOW ? LINK_SEQ_DUPLICATE : LINK_SEQ_GAP;
+}
+
+const char* link_result_str(link_result_t result) {
+  switch (result) {
+  case LINK_OK: return "ok";
+  case LINK_ERR_TOO_LONG: return "frame too long";
+  case LINK_ERR_COBS: return "bad COBS";
+  case LINK_ERR_SHORT: return "bad length";
+  case LINK_ERR_CRC: return "bad CRC";
+  }
+  return "?";
+}
+
+const char* link_status_str(link_status_t status) {
+  switch (status) {
+  case LINK_STATUS_OK: return "ok";
+  case LINK_STATUS_BAD_REQUEST: return "bad request";
+  case LINK_STATUS_UNKNOWN_MSG: return "unknown message";
+  case LINK_STATUS_NO_FS: return "file system not mounted";
+  case LINK_STATUS_IO: return "file I/O failed";
+  case LINK_STATUS_NO_MEMORY: return "out of memory";
+  }
+  return "?";
+}
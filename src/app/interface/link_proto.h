@@ -0,0 +1,148 @@
+//** ESP32-S3 HoloCubic - Binary Link Protocol Header
+//** Linus原则：串口上要搬数据就用帧，不要再printf十六进制
+//**
+//** 帧在线上是 00 <COBS编码的内容> 00 - COBS保证中间没有0，0x00就是帧的分界
+//** 文本控制台里不会出现0x00，所以同一个串口上文本和帧可以混着走：
+//**   帧外的字节是文本；碰到0x00进帧，收到下一个0x00帧结束，回到文本
+//**   帧里紧接着的0x00 (空帧) 不结束帧 - 所以先发 00 00 再发帧，不管对方在帧里还是帧外都能重新同步
+//**
+//** 解码后的内容: msg(1) flags(1) seq(1) ack(1) payload(0..LINK_PAYLOAD_MAX) crc16(2)
+//** - crc16是CRC-16/CCITT-FALSE (多项式0x1021，初值0xFFFF)，算前面所有字节，小端
+//** - 所有多字节字段都是小端
+//** - 带LINK_FLAG_SEQ的帧按seq顺序收，最多LINK_WINDOW帧没确认；不带的帧 (确认、回复) 不占序号
+//** - ack是发送方下一个想收的seq，累积确认；收到乱序的帧丢掉并马上确认，发送方从ack重发 (回退N帧)
+//** - 纯函数，不碰串口；主机上压测 (src/native/link_bench_main.cpp)，主机客户端是scripts/7_usb_link.py
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LINK_ESCAPE           0x00    // 帧的开始和结束
+#define LINK_HEADER_SIZE      4
+#define LINK_CRC_SIZE         2
+#define LINK_PAYLOAD_MAX      1024
+#define LINK_FRAME_MAX        (LINK_HEADER_SIZE + LINK_PAYLOAD_MAX + LINK_CRC_SIZE)
+//** COBS每254字节多1字节，再加开头的1字节和两头的分界
+#define LINK_WIRE_MAX         (LINK_FRAME_MAX + LINK_FRAME_MAX / 254 + 1 + 2)
+#define LINK_WINDOW           8       // 最多几帧发出去没确认
+
+#define LINK_FLAG_SEQ         0x01    // 按序号收、要确认
+
+typedef enum {
+  LINK_MSG_ACK = 0x01,                // 设备->主机: 只有ack
+  LINK_MSG_PING = 0x02,               // 任意内容，原样回PONG
+  LINK_MSG_PONG = 0x03,
+  LINK_MSG_STATUS = 0x04,             // 设备->主机: msg(1) code(1) value(4) - 回复哪个请求，link_status_t
+  LINK_MSG_METRICS_GET = 0x10,
+  LINK_MSG_METRICS = 0x11,            // 设备->主机: version(1) count(1) count个u32
+  LINK_MSG_FB_BEGIN = 0x20,           // x(2) y(2) w(2) h(2) - 有符号；像素是本机字节序的BGR565
+  LINK_MSG_FB_DATA = 0x21,            // offset(4) 像素字节
+  LINK_MSG_FB_END = 0x22,             // 交给渲染核显示；回STATUS，value = 字节数 - 下一个FB_BEGIN等上一张画完
+  LINK_MSG_FILE_OPEN = 0x30,          // fs(1) 保留(1) size(4) path - 路径不带结尾的0；写模式打开
+  LINK_MSG_FILE_DATA = 0x31,          // offset(4) 字节 - offset必须接着上一块
+  LINK_MSG_FILE_CLOSE = 0x32,         // 回STATUS，value = 写了多少字节
+} link_msg_t;
+
+typedef enum {
+  LINK_STATUS_OK = 0,
+  LINK_STATUS_BAD_REQUEST,            // 长度、范围或顺序不对
+  LINK_STATUS_UNKNOWN_MSG,
+  LINK_STATUS_NO_FS,                  // 这个文件系统没有挂载
+  LINK_STATUS_IO,                     // 打开或写文件失败
+  LINK_STATUS_NO_MEMORY,
+} link_status_t;
+
+typedef enum {
+  LINK_OK = 0,
+  LINK_ERR_TOO_LONG,                  // 超过LINK_WIRE_MAX - 多半是文本里混进了一个0x00，后面的字节回到文本
+  LINK_ERR_COBS,
+  LINK_ERR_SHORT,                     // 不够帧头加CRC
+  LINK_ERR_CRC,
+} link_result_t;
+
+typedef struct {
+  uint8_t msg;                        // link_msg_t
+  uint8_t flags;
+  uint8_t seq;
+  uint8_t ack;
+  const uint8_t* payload;
+  uint16_t len;
+} link_frame_t;
+
+//** ---- 小端字段 ----
+static inline void link_put_u16(uint8_t* p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+static inline void link_put_u32(uint8_t* p, uint32_t v) {
+  link_put_u16(p, (uint16_t)v);
+  link_put_u16(p + 2, (uint16_t)(v >> 16));
+}
+static inline uint16_t link_get_u16(const uint8_t* p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+static inline uint32_t link_get_u32(const uint8_t* p) {
+  return link_get_u16(p) | ((uint32_t)link_get_u16(p + 2) << 16);
+}
+
+//** ---- 编码 ----
+uint16_t link_crc16(uint16_t crc, const uint8_t* data, size_t len);   // 第一次传0xFFFF
+//** dst至少 len + len/254 + 1 字节；返回写了多少
+size_t link_cobs_encode(uint8_t* dst, const uint8_t* src, size_t len);
+//** 可以原地解码 (dst == src)；格式不对返回0
+size_t link_cobs_decode(uint8_t* dst, const uint8_t* src, size_t len);
+//** 整帧写进wire (至少LINK_WIRE_MAX字节)，包括两头的0x00；返回线上字节数，payload太长返回0
+size_t link_frame_encode(uint8_t* wire, const link_frame_t* frame);
+
+//** ---- 收帧 ----
+typedef struct {
+  uint8_t buf[LINK_WIRE_MAX];
+  uint16_t len;
+  bool in_frame;
+  bool overflow;
+} link_rx_t;
+
+void link_rx_reset(link_rx_t* rx);
+//** 喂一个字节 - 帧外的字节返回false (是文本)；帧里的和分界返回true
+//** 帧结束时done = true，接着用link_rx_frame()取出来
+bool link_rx_feed(link_rx_t* rx, uint8_t c, bool* done);
+//** 原地解码，只能调一次；frame->payload指向rx->buf里面，下一次feed之前有效
+link_result_t link_rx_frame(link_rx_t* rx, link_frame_t* frame);
+
+//** ---- 窗口 ----
+//** 发送方：base是最早没确认的seq，next是下一个要发的
+typedef struct {
+  uint8_t base;
+  uint8_t next;
+} link_tx_window_t;
+
+static inline uint8_t link_tx_in_flight(const link_tx_window_t* win) {
+  return (uint8_t)(win->next - win->base);
+}
+static inline bool link_tx_can_send(const link_tx_window_t* win) {
+  return link_tx_in_flight(win) < LINK_WINDOW;
+}
+//** 收到ack - 返回新确认了几帧；不在窗口里的ack返回0
+uint8_t link_tx_acked(link_tx_window_t* win, uint8_t ack);
+
+typedef enum {
+  LINK_SEQ_NEW = 0,                   // 正是想要的，处理完expected加一
+  LINK_SEQ_DUPLICATE,                 // 已经处理过 (重发的)
+  LINK_SEQ_GAP,                       // 前面丢了帧
+} link_seq_t;
+
+//** 接收方：expected是下一个想要的seq
+link_seq_t link_seq_check(uint8_t expected, uint8_t seq);
+
+const char* link_result_str(link_result_t result);
+const char* link_status_str(link_status_t status);
+
+#ifdef __cplusplus
+}
+#endif
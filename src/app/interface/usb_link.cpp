@@ -0,0 +1,309 @@
+//** ESP32-S3 HoloCubic - USB Binary Link Implementation
+//** Linus原则：帧收全了才处理，处理不了就别再读 - 不丢帧，也不多缓存
+
+#include "usb_link.h"
+#include "link_proto.h"
+#include "command_handler.h"
+#include "../../config/app_config.h"
+#include "../../core/config/hardware_config.h"
+#include "../core/app_main.h"
+#include "../../system/serial_out.h"
+#include <Arduino.h>
+#include <SPIFFS.h>
+#include <atomic>
+#include <string.h>
+
+#if ENABLE_SD_TESTS
+#include <SD_MMC.h>
+#endif
+
+static link_rx_t g_rx;
+static link_frame_t g_pending;            // 忙着没处理的帧，payload指向g_rx.buf
+static bool g_has_pending = false;
+static uint8_t g_expected = 0;            // 下一个想要的seq
+static uint8_t g_unacked = 0;             // 处理了还没确认的帧
+static uint8_t g_tx_seq = 0;
+static uint8_t g_wire[LINK_WIRE_MAX];
+static usb_link_stats_t g_stats;
+
+//** 图像上传 - 整屏大小的PSRAM缓冲，第一次用时分配
+static usb_link_blit_fn g_blit = NULL;
+static uint16_t* g_fb_pixels = NULL;
+static int16_t g_fb_x, g_fb_y, g_fb_w, g_fb_h;
+static bool g_fb_open = false;
+static std::atomic<bool> g_fb_busy(false);    // 交给渲染核了还没画完 - IO核置位，渲染核清
+
+//** 文件 - 一次一个
+static File g_file;
+static uint32_t g_file_size = 0, g_file_written = 0;
+
+//** ========================================
+//** 发送 - 只在IO核上；一整帧一次serial_out.write，在串口锁里写完，渲染核上的命令输出插不进帧中间
+//** ========================================
+
+static void link_send(uint8_t msg, const uint8_t* payload, uint16_t len) {
+  link_frame_t frame = {msg, 0, g_tx_seq++, g_expected, payload, len};
+  size_t n = link_frame_encode(g_wire, &frame);
+  serial_out.write(g_wire, n);
+  g_unacked = 0;                          //** 每一帧都带着ack
+  g_stats.tx_frames++;
+  g_stats.tx_bytes += n;
+}
+
+static void link_send_status(uint8_t msg, link_status_t code, uint32_t value) {
+  uint8_t payload[6];
+  payload[0] = msg;
+  payload[1] = (uint8_t)code;
+  link_put_u32(payload + 2, value);
+  link_send(LINK_MSG_STATUS, payload, sizeof(payload));
+}
+
+//** ========================================
+//** 端点 - 返回false表示现在处理不了，帧留着重试
+//** ========================================
+
+static bool handle_metrics(const link_frame_t* frame) {
+  //** 不加锁的快照：每个字段是对齐的32位，单个读不会撕裂；字段之间可能差一帧
+  uint32_t m[USB_LINK_METRIC_COUNT];
+  const frame_pacer_t* pacer = app_frame_pacer();
+  const app_msg_stats_t* inbox = app_inbox_stats();
+  uint32_t mhz = ESP.getCpuFreqMHz();
+  if (mhz == 0) mhz = 1;
+
+  m[USB_LINK_METRIC_UPTIME_MS] = millis();
+  m[USB_LINK_METRIC_HEAP_FREE] = ESP.getFreeHeap();
+  m[USB_LINK_METRIC_PSRAM_FREE] = ESP.getFreePsram();
+  m[USB_LINK_METRIC_FRAMES] = pacer->frames;
+  m[USB_LINK_METRIC_FRAMES_SKIPPED] = pacer->skipped;
+  m[USB_LINK_METRIC_FRAME_INTERVAL_P99_US] = frame_hist_percentile(&pacer->interval, 99);
+  m[USB_LINK_METRIC_RENDER_P99_US] = frame_hist_percentile(&pacer->render, 99);
+  m[USB_LINK_METRIC_FLUSH_P99_US] = frame_hist_percentile(&pacer->flush, 99);
+  m[USB_LINK_METRIC_INBOX_POSTED] = inbox->posted;
+  m[USB_LINK_METRIC_INBOX_DROPPED] = inbox->dropped;
+  m[USB_LINK_METRIC_COMMAND_LINES] = command_handler_stats()->lines;
+  m[USB_LINK_METRIC_LINK_RX_BYTES] = g_stats.rx_bytes;
+  m[USB_LINK_METRIC_LINK_FRAMES] = g_stats.rx_frames;
+  m[USB_LINK_METRIC_LINK_ERRORS] = g_stats.errors;
+  m[USB_LINK_METRIC_LINK_RESENT] = g_stats.resent;
+  for (uint8_t i = 0; i < APP_PROF_COUNT; i++) {
+    const lat_hist_t* hist = app_prof_hist((app_prof_id_t)i);
+    m[USB_LINK_METRIC_MODULE_P99_US + i] = hist && hist->samples ? lat_hist_percentile(hist, 99) / mhz : 0;
+  }
+
+  uint8_t payload[2 + sizeof(m)];
+  payload[0] = USB_LINK_METRICS_VERSION;
+  payload[1] = USB_LINK_METRIC_COUNT;
+  for (uint8_t i = 0; i < USB_LINK_METRIC_COUNT; i++) link_put_u32(payload + 2 + i * 4, m[i]);
+  link_send(LINK_MSG_METRICS, payload, sizeof(payload));
+  return true;
+}
+
+static bool handle_fb_begin(const link_frame_t* frame) {
+  if (g_fb_busy.load(std::memory_order_acquire)) return false;   //** 上一张还没画完
+
+  if (frame->len != 8) {
+    link_send_status(frame->msg, LINK_STATUS_BAD_REQUEST, 0);
+    return true;
+  }
+  int16_t x = (int16_t)link_get_u16(frame->payload), y = (int16_t)link_get_u16(frame->payload + 2);
+  int16_t w = (int16_t)link_get_u16(frame->payload + 4), h = (int16_t)link_get_u16(frame->payload + 6);
+  if (w <= 0 || h <= 0 || (int32_t)w * h > (int32_t)HW_DISPLAY_WIDTH * HW_DISPLAY_HEIGHT) {
+    link_send_status(frame->msg, LINK_STATUS_BAD_REQUEST, 0);
+    return true;
+  }
+  if (!g_fb_pixels) {
+    g_fb_pixels = (uint16_t*)ps_malloc((size_t)HW_DISPLAY_WIDTH * HW_DISPLAY_HEIGHT * sizeof(uint16_t));
+    if (!g_fb_pixels) {
+      link_send_status(frame->msg, LINK_STATUS_NO_MEMORY, 0);
+      return true;
+    }
+  }
+  g_fb_x = x;
+  g_fb_y = y;
+  g_fb_w = w;
+  g_fb_h = h;
+  g_fb_open = true;
+  return true;
+}
+
+static bool handle_fb_data(const link_frame_t* frame) {
+  uint32_t total = (uint32_t)g_fb_w * g_fb_h * sizeof(uint16_t);
+  uint32_t offset = frame->len >= 4 ? link_get_u32(frame->payload) : total;
+  uint32_t bytes = frame->len >= 4 ? frame->len - 4u : 0;
+  if (!g_fb_open || offset > total || bytes > total - offset) {
+    link_send_status(frame->msg, LINK_STATUS_BAD_REQUEST, offset);
+    return true;
+  }
+  memcpy((uint8_t*)g_fb_pixels + offset, frame->payload + 4, bytes);
+  return true;
+}
+
+static bool handle_fb_end(const link_frame_t* frame) {
+  if (!g_fb_open || !g_blit) {
+    link_send_status(frame->msg, LINK_STATUS_BAD_REQUEST, 0);
+    return true;
+  }
+  g_fb_busy.store(true, std::memory_order_release);
+  if (!g_blit(g_fb_x, g_fb_y, g_fb_w, g_fb_h, g_fb_pixels)) {
+    g_fb_busy.store(false, std::memory_order_relaxed);
+    return false;                                                //** 收件箱满了
+  }
+  g_fb_open = false;
+  g_stats.fb_uploads++;
+  link_send_status(frame->msg, LINK_STATUS_OK, (uint32_t)g_fb_w * g_fb_h * sizeof(uint16_t));
+  return true;
+}
+
+static fs::FS* link_fs(uint8_t fs) {
+  if (fs == USB_LINK_FS_SPIFFS) return &SPIFFS;
+#if ENABLE_SD_TESTS
+  if (fs == USB_LINK_FS_SD && SD_MMC.cardType() != CARD_NONE) return &SD_MMC;
+#endif
+  return NULL;
+}
+
+static bool handle_file_open(const link_frame_t* frame) {
+  if (g_file) g_file.close();                                    //** 上一个没关的作废
+  uint16_t path_len = frame->len > 6 ? (uint16_t)(frame->len - 6) : 0;
+  if (path_len == 0 || path_len >= USB_LINK_PATH_MAX || frame->payload[6] != '/') {
+    link_send_status(frame->msg, LINK_STATUS_BAD_REQUEST, 0);
+    return true;
+  }
+  fs::FS* fs = link_fs(frame->payload[0]);
+  if (!fs) {
+    link_send_status(frame->msg, LINK_STATUS_NO_FS, 0);
+    return true;
+  }
+  char path[USB_LINK_PATH_MAX];
+  memcpy(path, frame->payload + 6, path_len);
+  path[path_len] = '\0';
+
+  g_file = fs->open(path, "w");
+  g_file_size = link_get_u32(frame->payload + 2);
+  g_file_written = 0;
+  link_send_status(frame->msg, g_file ? LINK_STATUS_OK : LINK_STATUS_IO, 0);
+  return true;
+}
+
+static bool handle_file_data(const link_frame_t* frame) {
+  uint32_t offset = frame->len >= 4 ? link_get_u32(frame->payload) : 0;
+  uint32_t bytes = frame->len >= 4 ? frame->len - 4u : 0;
+  if (!g_file || frame->len < 4 || offset != g_file_written || bytes > g_file_size - g_file_written) {
+    link_send_status(frame->msg, LINK_STATUS_BAD_REQUEST, g_file_written);
+    return true;
+  }
+  if (g_file.write(frame->payload + 4, bytes) != bytes) {
+    g_file.close();
+    link_send_status(frame->msg, LINK_STATUS_IO, g_file_written);
+    return true;
+  }
+  g_file_written += bytes;
+  return true;
+}
+
+static bool handle_file_close(const link_frame_t* frame) {
+  if (!g_file) {
+    link_send_status(frame->msg, LINK_STATUS_BAD_REQUEST, 0);
+    return true;
+  }
+  g_file.close();
+  g_stats.files++;
+  link_send_status(frame->msg, g_file_written == g_file_size ? LINK_STATUS_OK : LINK_STATUS_BAD_REQUEST,
+                   g_file_written);
+  return true;
+}
+
+static bool link_handle(const link_frame_t* frame) {
+  switch (frame->msg) {
+  case LINK_MSG_PING:
+    link_send(LINK_MSG_PONG, frame->payload, frame->len);
+    return true;
+  case LINK_MSG_METRICS_GET: return handle_metrics(frame);
+  case LINK_MSG_FB_BEGIN: return handle_fb_begin(frame);
+  case LINK_MSG_FB_DATA: return handle_fb_data(frame);
+  case LINK_MSG_FB_END: return handle_fb_end(frame);
+  case LINK_MSG_FILE_OPEN: return handle_file_open(frame);
+  case LINK_MSG_FILE_DATA: return handle_file_data(frame);
+  case LINK_MSG_FILE_CLOSE: return handle_file_close(frame);
+  default:
+    link_send_status(frame->msg, LINK_STATUS_UNKNOWN_MSG, 0);
+    return true;
+  }
+}
+
+//** ========================================
+//** 收帧
+//** ========================================
+
+//** 处理一帧 - 按序号的先过窗口；处理不了返回false
+static bool link_dispatch(const link_frame_t* frame) {
+  if (!(frame->flags & LINK_FLAG_SEQ)) return link_handle(frame);
+
+  switch (link_seq_check(g_expected, frame->seq)) {
+  case LINK_SEQ_NEW:
+    if (!link_handle(frame)) return false;
+    g_expected++;
+    if (++g_unacked >= LINK_WINDOW / 2) link_send(LINK_MSG_ACK, NULL, 0);
+    return true;
+  case LINK_SEQ_DUPLICATE:
+  case LINK_SEQ_GAP:
+    //** 重发的或者中间丢了 - 马上告诉主机从哪里接着发
+    g_stats.resent++;
+    link_send(LINK_MSG_ACK, NULL, 0);
+    return true;
+  }
+  return true;
+}
+
+void usb_link_init(void) {
+  link_rx_reset(&g_rx);
+  g_has_pending = false;
+  g_expected = 0;
+  g_unacked = 0;
+}
+
+bool usb_link_feed(uint8_t c) {
+  bool done;
+  bool mine = link_rx_feed(&g_rx, c, &done);
+  if (mine) g_stats.rx_bytes++;
+  if (!done) return mine;
+
+  link_frame_t frame;
+  link_result_t result = link_rx_frame(&g_rx, &frame);
+  if (result != LINK_OK) {
+    g_stats.errors++;
+    return mine;
+  }
+  g_stats.rx_frames++;
+  if (!link_dispatch(&frame)) {
+    g_pending = frame;
+    g_has_pending = true;
+    g_stats.busy++;
+  }
+  return mine;
+}
+
+bool usb_link_busy(void) {
+  return g_has_pending;
+}
+
+bool usb_link_retry(void) {
+  if (g_has_pending && link_dispatch(&g_pending)) g_has_pending = false;
+  return !g_has_pending;
+}
+
+void usb_link_flush(void) {
+  if (g_unacked) link_send(LINK_MSG_ACK, NULL, 0);
+}
+
+void usb_link_set_blit(usb_link_blit_fn blit) {
+  g_blit = blit;
+}
+
+void usb_link_blit_done(void) {
+  g_fb_busy.store(false, std::memory_order_release);
+}
+
+const usb_link_stats_t* usb_link_stats(void) {
+  return &g_stats;
+}
@@ -0,0 +1,85 @@
+//** ESP32-S3 HoloCubic - USB Binary Link Header
+//** Linus原则：一个串口，两种用法 - 人敲的文本和程序发的帧
+//**
+//** 帧格式见link_proto.h；这里是设备这头的端点：
+//** - PING -> PONG               原样回显，主机测往返吞吐量
+//** - METRICS_GET -> METRICS     一次取全部统计 (下面的usb_link_metric_t)
+//** - FB_BEGIN/DATA/END          整块像素传进PSRAM，END后交给渲染核display_blit()
+//** - FILE_OPEN/DATA/CLOSE       写文件到SPIFFS或SD卡
+//** 主机发的请求都带LINK_FLAG_SEQ；设备每收够半个窗口或者一批字节收完就确认一次
+//** 处理不了的帧 (上一张图渲染核还没画完) 留着不确认，也不再读串口 - 背压靠USB自己的流控
+
+#pragma once
+
+#include "../core/app_profile.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define USB_LINK_PATH_MAX     64      // 文件路径，含结尾的0
+#define USB_LINK_METRICS_VERSION 1
+
+typedef enum {
+  USB_LINK_FS_SPIFFS = 0,
+  USB_LINK_FS_SD,                     // 只有ENABLE_SD_TESTS的构建挂载了SD卡
+} usb_link_fs_t;
+
+//** METRICS里u32的顺序 - 只往后加，主机按version和count解 (scripts/7_usb_link.py)
+typedef enum {
+  USB_LINK_METRIC_UPTIME_MS = 0,
+  USB_LINK_METRIC_HEAP_FREE,
+  USB_LINK_METRIC_PSRAM_FREE,
+  USB_LINK_METRIC_FRAMES,
+  USB_LINK_METRIC_FRAMES_SKIPPED,
+  USB_LINK_METRIC_FRAME_INTERVAL_P99_US,
+  USB_LINK_METRIC_RENDER_P99_US,
+  USB_LINK_METRIC_FLUSH_P99_US,
+  USB_LINK_METRIC_INBOX_POSTED,
+  USB_LINK_METRIC_INBOX_DROPPED,
+  USB_LINK_METRIC_COMMAND_LINES,
+  USB_LINK_METRIC_LINK_RX_BYTES,
+  USB_LINK_METRIC_LINK_FRAMES,
+  USB_LINK_METRIC_LINK_ERRORS,        // CRC、COBS、长度
+  USB_LINK_METRIC_LINK_RESENT,        // 重复的和乱序的
+  USB_LINK_METRIC_MODULE_P99_US,      // 后面APP_PROF_COUNT个，app_prof_id_t的顺序
+  USB_LINK_METRIC_COUNT = USB_LINK_METRIC_MODULE_P99_US + APP_PROF_COUNT
+} usb_link_metric_t;
+
+typedef struct {
+  uint32_t rx_bytes;                  // 帧里的字节，含分界
+  uint32_t rx_frames;                 // 解出来的好帧
+  uint32_t errors;
+  uint32_t resent;
+  uint32_t busy;                      // 因为忙留着重试的次数
+  uint32_t tx_frames;
+  uint32_t tx_bytes;
+  uint32_t fb_uploads;
+  uint32_t files;
+} usb_link_stats_t;
+
+void usb_link_init(void);
+
+//** 喂一个字节 - 属于帧的返回true；文本返回false，交给命令行
+//** usb_link_busy()时不要喂
+bool usb_link_feed(uint8_t c);
+
+//** 有一帧留着没处理 - 先usb_link_retry()，成功了才接着喂
+bool usb_link_busy(void);
+bool usb_link_retry(void);
+
+//** 一批字节喂完了 - 把攒着的确认发出去
+void usb_link_flush(void);
+
+//** 上传的图交给渲染核 - 放不进去返回false，过一会儿重试；画完在渲染核上调usb_link_blit_done()
+typedef bool (*usb_link_blit_fn)(int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t* pixels);
+void usb_link_set_blit(usb_link_blit_fn blit);
+void usb_link_blit_done(void);
+
+const usb_link_stats_t* usb_link_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
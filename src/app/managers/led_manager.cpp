@@ -1,23 +1,37 @@
 //** ESP32-S3 HoloCubic - LED Resource Manager
 //** Linus原则：单一所有权 - "One owner per resource, eliminate race conditions"
 //** 职责：LED资源统一管理，优先级仲裁，消除资源竞争
+//**
+//** 每个优先级一个图层槽，固定容量、静态分配：
+//** - 每个tick从最高优先级往下合成，每颗LED取覆盖它的最上层
+//** - 图层超时或释放只清自己的槽，下面的图层接着显示，不需要重新请求
 
 #include "led_manager.h"
 #include "../../core/types/error_handling.h"
+#include "../../core/config/hardware_config.h"
 #include "../../drivers/led/led_driver.h"
 #include <Arduino.h>
+#include <string.h>
 
-//** 全局状态 - 单一数据源
-static led_request_t g_current_request = {
-    .priority = LED_PRIORITY_IDLE,
-    .mode = LED_MODE_OFF,
-    .red = 0, .green = 0, .blue = 0,
-    .period_ms = 0,
-    .duration_ms = 0,
-    .start_time = 0
-};
+#define LED_ALL_MASK (HW_LED_COUNT >= 64 ? ~0ULL : ((1ULL << HW_LED_COUNT) - 1))
 
+typedef struct {
+    led_request_t request;
+    uint64_t mask;          // 覆盖的LED，已展开0=全部
+    bool active;
+} led_layer_t;
 
+//** 全局状态 - 单一数据源，槽号就是优先级
+static led_layer_t g_layers[LED_LAYER_COUNT];
+static led_color_t g_frame[HW_LED_COUNT];
+static uint32_t g_state;                    // 脚本分支用的状态位
+static led_backlight_fn g_backlight_output;
+static int16_t g_backlight = -1;            // 上次输出的背光，-1=还没输出过
+static led_wake_fn g_wake;
+
+static void led_wake(void) {
+    if (g_wake) g_wake();
+}
 
 void led_manager_init(void) {
     //** 初始化LED驱动
@@ -26,10 +40,10 @@ void led_manager_init(void) {
         return;
     }
     
-    //** 重置状态
-    g_current_request.priority = LED_PRIORITY_IDLE;
-    g_current_request.mode = LED_MODE_OFF;
-    g_current_request.start_time = millis();
+    //** 重置状态 - 没有图层就是全灭
+    memset(g_layers, 0, sizeof(g_layers));
+    g_state = 0;
+    g_backlight = -1;
     
     led_off();
     
@@ -39,84 +53,141 @@ void led_manager_init(void) {
 bool led_request(const led_request_t* request) {
     RETURN_FALSE_IF_NULL(request);
     
-    //** 检查优先级 - 只有更高或相等优先级才能覆盖
-    if (request->priority < g_current_request.priority) {
-        LOG_WARNING_F("LED request rejected: priority %d < current %d", 
-                     request->priority, g_current_request.priority);
+    if ((unsigned)request->priority >= LED_LAYER_COUNT) {
+        LOG_WARNING_F("LED request rejected: priority %d out of range", request->priority);
         return false;
     }
+    if (request->mode == LED_MODE_SCRIPT) {
+        RETURN_FALSE_IF_NULL(request->script);
+    }
     
-    //** 接受请求
-    g_current_request = *request;
-    g_current_request.start_time = millis();
+    //** 放进自己优先级的槽 - 同级覆盖，低级的也接受，只是被上面的盖住
+    led_layer_t* layer = &g_layers[request->priority];
+    layer->request = *request;
+    layer->request.start_time = millis();
+    layer->mask = request->leds ? (request->leds & LED_ALL_MASK) : LED_ALL_MASK;
+    layer->active = true;
+    
+    if (request->mode == LED_MODE_SCRIPT) {
+        led_script_start(request->script, layer->request.start_time);
+    }
     
+    led_wake();
     return true;
 }
 
-//** 检查LED请求是否超时
-static bool led_check_timeout(uint32_t now) {
-    if (g_current_request.duration_ms > 0 && 
-        (now - g_current_request.start_time) >= g_current_request.duration_ms) {
-        //** 超时，回到空闲状态
-        g_current_request.priority = LED_PRIORITY_IDLE;
-        g_current_request.mode = LED_MODE_OFF;
-        led_off();
-        return true;
+//** 检查图层是否超时 - 超时只清自己的槽
+static void led_check_timeout(uint32_t now) {
+    for (uint8_t i = 0; i < LED_LAYER_COUNT; i++) {
+        led_layer_t* layer = &g_layers[i];
+        if (layer->active && layer->request.duration_ms > 0 &&
+            (now - layer->request.start_time) >= layer->request.duration_ms) {
+            layer->active = false;
+        }
     }
-    return false;
 }
 
-//** 处理闪烁模式
-static void led_handle_blink(uint32_t now) {
-    uint32_t elapsed = now - g_current_request.start_time;
-    uint32_t cycle_pos = elapsed % g_current_request.period_ms;
+//** 一颗LED在图层里的颜色 - 相位按LED序号错开spread，全是整数运算
+static led_color_t led_layer_color(const led_request_t* req, uint32_t now, uint8_t index) {
+    led_color_t top = { req->red, req->green, req->blue };
+    uint16_t phase = (uint16_t)(led_wave_phase(now - req->start_time, req->period_ms) + index * req->spread);
+    led_wave_shape_t wave;
     
-    if (cycle_pos < (g_current_request.period_ms / 2)) {
-        led_set_color(g_current_request.red, g_current_request.green, g_current_request.blue);
-    } else {
-        led_off();
-    }
-}
+    switch (req->mode) {
+        case LED_MODE_SOLID:
+            return top;
+            
+        case LED_MODE_BLINK:
+            wave = LED_WAVE_SQUARE;
+            break;
+            
+        case LED_MODE_PULSE:
+            wave = LED_WAVE_SINE;
+            break;
 
-//** 处理呼吸灯模式
-static void led_handle_pulse(uint32_t now) {
-    uint32_t elapsed = now - g_current_request.start_time;
-    uint32_t cycle_pos = elapsed % g_current_request.period_ms;
-    float brightness = (sin(2.0 * PI * cycle_pos / g_current_request.period_ms) + 1.0) / 2.0;
-    
-    uint8_t r = (uint8_t)(g_current_request.red * brightness);
-    uint8_t g = (uint8_t)(g_current_request.green * brightness);
-    uint8_t b = (uint8_t)(g_current_request.blue * brightness);
+        case LED_MODE_WAVE:
+            wave = req->wave;
+            break;
+
+        case LED_MODE_KEYFRAMES:
+            return led_keyframes_sample(req->keyframes, req->keyframe_count, phase);
+
+        case LED_MODE_SCRIPT:
+            return led_script_color(req->script, now);
+
+        case LED_MODE_OFF:
+        default: {
+            led_color_t black = { 0, 0, 0 };
+            return black;
+        }
+    }
     
-    led_set_color(r, g, b);
+    //** 亮度在base和请求颜色之间插值
+    return led_color_lerp(req->base, top, led_wave_level(wave, phase));
 }
 
 void led_process(void) {
     uint32_t now = millis();
     
     //** 检查超时
-    if (led_check_timeout(now)) {
-        return;
+    led_check_timeout(now);
+    
+    //** 脚本每个tick推进一次，不是每颗LED一次；背光跟最上层碰过背光的脚本
+    int16_t backlight = -1;
+    for (int8_t i = LED_LAYER_COUNT - 1; i >= 0; i--) {
+        const led_layer_t* layer = &g_layers[i];
+        if (!layer->active || layer->request.mode != LED_MODE_SCRIPT) continue;
+        
+        led_script_step(layer->request.script, now, g_state);
+        if (backlight < 0) backlight = led_script_backlight(layer->request.script, now);
+    }
+    if (backlight >= 0 && backlight != g_backlight && g_backlight_output) {
+        g_backlight_output((uint8_t)backlight);
+        g_backlight = backlight;
     }
     
-    //** 根据模式控制LED
-    switch (g_current_request.mode) {
-        case LED_MODE_OFF:
-            led_off();
-            break;
-            
-        case LED_MODE_SOLID:
-            led_set_color(g_current_request.red, g_current_request.green, g_current_request.blue);
-            break;
-            
-        case LED_MODE_BLINK:
-            led_handle_blink(now);
-            break;
-            
-        case LED_MODE_PULSE:
-            led_handle_pulse(now);
-            break;
+    //** 从上往下合成 - todo里是还没有图层盖住的LED
+    uint64_t todo = LED_ALL_MASK;
+    for (int8_t i = LED_LAYER_COUNT - 1; i >= 0 && todo; i--) {
+        const led_layer_t* layer = &g_layers[i];
+        if (!layer->active) continue;
+        
+        uint64_t cover = layer->mask & todo;
+        for (uint8_t led = 0; led < HW_LED_COUNT; led++) {
+            if (cover & (1ULL << led)) g_frame[led] = led_layer_color(&layer->request, now, led);
+        }
+        todo &= ~cover;
+    }
+    
+    //** 没有图层的LED是灭的
+    for (uint8_t led = 0; led < HW_LED_COUNT; led++) {
+        if (todo & (1ULL << led)) {
+            g_frame[led].r = g_frame[led].g = g_frame[led].b = 0;
+        }
+    }
+    
+    led_set_pixels(g_frame);
+}
+
+uint32_t led_next_ms(void) {
+    uint32_t now = millis();
+    uint32_t next = led_pending() ? (1000 / HW_LED_MAX_REFRESH_HZ) : LED_NEXT_IDLE;
+    
+    for (uint8_t i = 0; i < LED_LAYER_COUNT; i++) {
+        const led_request_t* req = &g_layers[i].request;
+        if (!g_layers[i].active) continue;
+        
+        //** 静态图层只在超时时要处理
+        if (req->mode != LED_MODE_SOLID && req->mode != LED_MODE_OFF && next > LED_FRAME_MS) {
+            next = LED_FRAME_MS;
+        }
+        if (req->duration_ms > 0) {
+            uint32_t elapsed = now - req->start_time;
+            uint32_t left = elapsed >= req->duration_ms ? 0 : req->duration_ms - elapsed;
+            if (left < next) next = left;
+        }
     }
+    return next;
 }
 
 //** 快速接口实现
@@ -144,6 +215,56 @@ bool led_set_blink(led_priority_t priority, uint8_t r, uint8_t g, uint8_t b, uin
     return led_request(&request);
 }
 
+bool led_set_wave(led_priority_t priority, led_wave_shape_t wave, uint8_t r, uint8_t g, uint8_t b,
+                  uint16_t period_ms, uint32_t duration_ms) {
+    led_request_t request = {
+        .priority = priority,
+        .mode = LED_MODE_WAVE,
+        .red = r, .green = g, .blue = b,
+        .period_ms = period_ms,
+        .duration_ms = duration_ms,
+        .start_time = 0,
+        .wave = wave
+    };
+    return led_request(&request);
+}
+
+bool led_set_keyframes(led_priority_t priority, const led_keyframe_t* frames, uint8_t count,
+                       uint16_t period_ms, uint32_t duration_ms) {
+    led_request_t request = {
+        .priority = priority,
+        .mode = LED_MODE_KEYFRAMES,
+        .red = 0, .green = 0, .blue = 0,
+        .period_ms = period_ms,
+        .duration_ms = duration_ms,
+        .start_time = 0,
+        .wave = LED_WAVE_SQUARE,
+        .base = { 0, 0, 0 },
+        .keyframes = frames,
+        .keyframe_count = count
+    };
+    return led_request(&request);
+}
+
+bool led_set_script(led_priority_t priority, led_script_t* script, uint32_t duration_ms) {
+    led_request_t request = {
+        .priority = priority,
+        .mode = LED_MODE_SCRIPT,
+        .red = 0, .green = 0, .blue = 0,
+        .period_ms = 0,
+        .duration_ms = duration_ms,
+        .start_time = 0,
+        .wave = LED_WAVE_SQUARE,
+        .base = { 0, 0, 0 },
+        .keyframes = NULL,
+        .keyframe_count = 0,
+        .leds = 0,
+        .spread = 0,
+        .script = script
+    };
+    return led_request(&request);
+}
+
 bool led_set_off(led_priority_t priority) {
     led_request_t request = {
         .priority = priority,
@@ -157,9 +278,24 @@ bool led_set_off(led_priority_t priority) {
 }
 
 void led_release(led_priority_t priority) {
-    if (g_current_request.priority == priority) {
-        g_current_request.priority = LED_PRIORITY_IDLE;
-        g_current_request.mode = LED_MODE_OFF;
-        led_off();
+    //** 下面的图层下一个tick自动接上
+    if ((unsigned)priority < LED_LAYER_COUNT) {
+        g_layers[priority].active = false;
+        led_wake();
     }
+}
+
+void led_set_state(uint32_t state) {
+    if (state == g_state) return;
+    g_state = state;
+    led_wake();
+}
+
+void led_set_wake(led_wake_fn wake) {
+    g_wake = wake;
+}
+
+void led_set_backlight_output(led_backlight_fn output) {
+    g_backlight_output = output;
+    g_backlight = -1;
 }
\ No newline at end of file
@@ -7,8 +7,11 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "led_wave.h"
+#include "led_script.h"
 
 //** 只有LED管理器可以控制LED，其他模块只能请求
+//** 每个优先级一个图层：高优先级盖住低优先级，释放或超时后下面的图层自动恢复
 
 // ========================================
 // LED状态优先级
@@ -21,11 +24,18 @@ typedef enum {
     LED_PRIORITY_PANIC = 3      // 紧急状态（最高优先级）
 } led_priority_t;
 
+#define LED_LAYER_COUNT (LED_PRIORITY_PANIC + 1)   // 每个优先级一层
+#define LED_FRAME_MS 20                 // 有动画图层时的刷新间隔
+#define LED_NEXT_IDLE 0xFFFFFFFFu       // led_next_ms(): 图层不变就不用再处理
+
 typedef enum {
     LED_MODE_OFF = 0,
     LED_MODE_SOLID,     // 固定颜色
-    LED_MODE_BLINK,     // 闪烁
-    LED_MODE_PULSE      // 呼吸灯
+    LED_MODE_BLINK,     // 闪烁 - 方波
+    LED_MODE_PULSE,     // 呼吸灯 - 正弦波
+    LED_MODE_WAVE,      // 任意波形，见wave
+    LED_MODE_KEYFRAMES, // 关键帧颜色，每个周期循环一遍
+    LED_MODE_SCRIPT     // 字节码动画，见led_script.h
 } led_mode_t;
 
 typedef struct {
@@ -35,6 +45,13 @@ typedef struct {
     uint16_t period_ms;     // 闪烁/呼吸周期
     uint32_t duration_ms;   // 持续时间，0=永久
     uint32_t start_time;    // 开始时间
+    led_wave_shape_t wave;  // LED_MODE_WAVE的波形
+    led_color_t base;       // 波形亮度为0时的颜色，默认黑
+    const led_keyframe_t* keyframes;  // LED_MODE_KEYFRAMES - 调用者保证一直有效
+    uint8_t keyframe_count;
+    uint64_t leds;          // 覆盖哪些LED (bit i = 第i颗)，0=全部
+    uint16_t spread;        // 相邻LED的相位差 (Q16)，0=整条同步
+    led_script_t* script;   // LED_MODE_SCRIPT - 已绑定代码，请求时从头开始；一个脚本只能放在一层
 } led_request_t;
 
 // ========================================
@@ -47,15 +64,34 @@ void led_manager_init(void);
 //** 处理LED状态 - 在主循环中调用
 void led_process(void);
 
+//** 多久以后需要再调用led_process() (ms) - 动画、图层超时、推迟的帧取最近的
+uint32_t led_next_ms(void);
+
+//** 图层或状态位变了时调用 - 调度器用它叫醒LED任务
+typedef void (*led_wake_fn)(void);
+void led_set_wake(led_wake_fn wake);
+
 //** 请求LED控制
 bool led_request(const led_request_t* request);
 
 //** 快速请求接口
 bool led_set_solid(led_priority_t priority, uint8_t r, uint8_t g, uint8_t b, uint32_t duration_ms);
 bool led_set_blink(led_priority_t priority, uint8_t r, uint8_t g, uint8_t b, uint16_t period_ms, uint32_t duration_ms);
+bool led_set_wave(led_priority_t priority, led_wave_shape_t wave, uint8_t r, uint8_t g, uint8_t b,
+                  uint16_t period_ms, uint32_t duration_ms);
+bool led_set_keyframes(led_priority_t priority, const led_keyframe_t* frames, uint8_t count,
+                       uint16_t period_ms, uint32_t duration_ms);
+bool led_set_script(led_priority_t priority, led_script_t* script, uint32_t duration_ms);
 bool led_set_off(led_priority_t priority);
 
-//** 释放控制权
+//** 脚本分支用的状态位 (bit = led_script_state_t) - 应用在状态变化时更新
+void led_set_state(uint32_t state);
+
+//** 脚本控制的背光输出 - 最上层碰过背光的脚本决定亮度，值变了才调用
+typedef void (*led_backlight_fn)(uint8_t level);
+void led_set_backlight_output(led_backlight_fn output);
+
+//** 释放控制权 - 只清这一层
 void led_release(led_priority_t priority);
 
 #endif // LED_MANAGER_H
\ No newline at end of file
@@ -0,0 +1,218 @@
+//** ESP32-S3 HoloCubic - LED/Backlight Animation Bytecode Interpreter
+//** Linus原则：加载时检查一次，运行时只做便宜的检查
+
+#include "led_script.h"
+#include "led_wave.h"
+#include <string.h>
+
+//** 每条指令的总长度 (含操作码)
+static const uint8_t op_length[LED_OP_COUNT] = {
+    1,  // END
+    4,  // SET r g b
+    6,  // FADE r g b ms16
+    3,  // WAIT ms16
+    4,  // LIGHT level ms16
+    2,  // REPEAT n
+    3,  // NEXT addr16
+    3,  // JUMP addr16
+    4,  // IF state addr16
+    4,  // IFNOT state addr16
+};
+
+static inline uint16_t read16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+//** 线性插值的Q16进度 - ms为0或已经结束时是1
+static uint16_t fade_t(uint32_t start, uint16_t ms, uint32_t now_ms) {
+    uint32_t elapsed = now_ms - start;
+    if (ms == 0 || elapsed >= ms) return LED_WAVE_ONE;
+    return (uint16_t)((elapsed * LED_WAVE_ONE) / ms);
+}
+
+led_script_result_t led_script_bind(led_script_t* script, const uint8_t* image, size_t len) {
+    memset(script, 0, sizeof(*script));
+
+    if (len < LED_SCRIPT_HEADER_SIZE) return LED_SCRIPT_ERR_SIZE;
+    uint32_t magic = (uint32_t)image[0] | ((uint32_t)image[1] << 8) |
+                     ((uint32_t)image[2] << 16) | ((uint32_t)image[3] << 24);
+    if (magic != LED_SCRIPT_MAGIC) return LED_SCRIPT_ERR_MAGIC;
+    if (image[4] != LED_SCRIPT_VERSION) return LED_SCRIPT_ERR_VERSION;
+
+    uint16_t size = read16(image + 6);
+    if (size == 0 || size > LED_SCRIPT_MAX_CODE || (size_t)size + LED_SCRIPT_HEADER_SIZE != len) {
+        return LED_SCRIPT_ERR_SIZE;
+    }
+    const uint8_t* code = image + LED_SCRIPT_HEADER_SIZE;
+
+    //** 第一遍：标出指令边界，检查操作码和操作数
+    uint8_t starts[LED_SCRIPT_MAX_CODE / 8];
+    memset(starts, 0, sizeof(starts));
+    for (uint16_t pc = 0; pc < size; pc += op_length[code[pc]]) {
+        uint8_t op = code[pc];
+        if (op >= LED_OP_COUNT || pc + op_length[op] > size) return LED_SCRIPT_ERR_OPCODE;
+        if (op == LED_OP_REPEAT && code[pc + 1] == 0) return LED_SCRIPT_ERR_OPERAND;
+        if ((op == LED_OP_IF || op == LED_OP_IFNOT) && code[pc + 1] >= 32) return LED_SCRIPT_ERR_OPERAND;
+        starts[pc >> 3] |= (uint8_t)(1 << (pc & 7));
+    }
+
+    //** 第二遍：跳转只能落在指令开头 - 运行时就不用再查
+    for (uint16_t pc = 0; pc < size; pc += op_length[code[pc]]) {
+        uint8_t op = code[pc];
+        uint16_t target;
+        if (op == LED_OP_NEXT || op == LED_OP_JUMP) {
+            target = read16(code + pc + 1);
+        } else if (op == LED_OP_IF || op == LED_OP_IFNOT) {
+            target = read16(code + pc + 2);
+        } else {
+            continue;
+        }
+        if (target >= size || !(starts[target >> 3] & (1 << (target & 7)))) return LED_SCRIPT_ERR_TARGET;
+    }
+
+    script->code = code;
+    script->size = size;
+    return LED_SCRIPT_OK;
+}
+
+void led_script_start(led_script_t* script, uint32_t now_ms) {
+    led_color_t black = { 0, 0, 0 };
+    script->pc = 0;
+    script->status = script->code ? LED_SCRIPT_RUNNING : LED_SCRIPT_IDLE;
+    script->depth = 0;
+    script->busy = false;
+    script->clock = now_ms;
+    script->from = script->to = black;
+    script->fade_start = now_ms;
+    script->fade_ms = 0;
+    script->light_used = false;
+    script->light_from = script->light_to = 0;
+    script->light_ms = 0;
+}
+
+//** 停在这条指令上等待ms - 到期返回true，逻辑时钟前进ms
+static bool wait_done(led_script_t* s, uint16_t ms, uint32_t now_ms) {
+    if (now_ms - s->clock < ms) return false;
+    s->clock += ms;
+    return true;
+}
+
+bool led_script_step(led_script_t* s, uint32_t now_ms, uint32_t state) {
+    if (s->status != LED_SCRIPT_RUNNING) return false;
+
+    for (uint8_t budget = 0; budget < LED_SCRIPT_MAX_STEPS; budget++) {
+        const uint8_t* ins = s->code + s->pc;
+        uint16_t next = (uint16_t)(s->pc + op_length[ins[0]]);
+
+        switch (ins[0]) {
+            case LED_OP_END:
+                s->status = LED_SCRIPT_DONE;
+                return false;
+
+            case LED_OP_SET:
+                s->to.r = ins[1]; s->to.g = ins[2]; s->to.b = ins[3];
+                s->from = s->to;
+                s->fade_ms = 0;
+                break;
+
+            case LED_OP_FADE: {
+                uint16_t ms = read16(ins + 4);
+                //** 第一次执行到这里才开始渐变 - 等待期间pc不动
+                if (!s->busy) {
+                    s->from = led_script_color(s, s->clock);
+                    s->to.r = ins[1]; s->to.g = ins[2]; s->to.b = ins[3];
+                    s->fade_start = s->clock;
+                    s->fade_ms = ms;
+                    s->busy = true;
+                }
+                if (!wait_done(s, ms, now_ms)) return true;
+                s->from = s->to;
+                s->fade_ms = 0;
+                s->busy = false;
+                break;
+            }
+
+            case LED_OP_WAIT:
+                if (!wait_done(s, read16(ins + 1), now_ms)) return true;
+                break;
+
+            case LED_OP_LIGHT:
+                s->light_from = s->light_used ? (uint8_t)led_script_backlight(s, s->clock) : ins[1];
+                s->light_to = ins[1];
+                s->light_start = s->clock;
+                s->light_ms = read16(ins + 2);
+                s->light_used = true;
+                break;
+
+            case LED_OP_REPEAT:
+                if (s->depth >= LED_SCRIPT_MAX_DEPTH) {
+                    s->status = LED_SCRIPT_FAULT;
+                    return false;
+                }
+                s->loops[s->depth++] = ins[1];
+                break;
+
+            case LED_OP_NEXT:
+                if (s->depth == 0) {
+                    s->status = LED_SCRIPT_FAULT;
+                    return false;
+                }
+                if (--s->loops[s->depth - 1] > 0) {
+                    next = read16(ins + 1);
+                } else {
+                    s->depth--;
+                }
+                break;
+
+            case LED_OP_JUMP:
+                next = read16(ins + 1);
+                break;
+
+            case LED_OP_IF:
+                if (state & (1u << ins[1])) next = read16(ins + 2);
+                break;
+
+            case LED_OP_IFNOT:
+                if (!(state & (1u << ins[1]))) next = read16(ins + 2);
+                break;
+        }
+
+        s->executed++;
+        //** 顺序执行到代码末尾等同END
+        if (next >= s->size) {
+            s->status = LED_SCRIPT_DONE;
+            return false;
+        }
+        s->pc = next;
+    }
+
+    //** 预算用完 - 要么是没有wait的循环，要么落后太多；放弃追赶，从现在重新计时
+    s->clock = now_ms;
+    return true;
+}
+
+led_color_t led_script_color(const led_script_t* s, uint32_t now_ms) {
+    if (s->fade_ms == 0) return s->to;
+    return led_color_lerp(s->from, s->to, fade_t(s->fade_start, s->fade_ms, now_ms));
+}
+
+int16_t led_script_backlight(const led_script_t* s, uint32_t now_ms) {
+    if (!s->light_used) return -1;
+    uint16_t t = fade_t(s->light_start, s->light_ms, now_ms);
+    int32_t delta = (int32_t)s->light_to - s->light_from;
+    return (int16_t)(s->light_from + (delta * t + (delta >= 0 ? 32767 : -32767)) / (int32_t)LED_WAVE_ONE);
+}
+
+const char* led_script_result_str(led_script_result_t result) {
+    switch (result) {
+        case LED_SCRIPT_OK:           return "ok";
+        case LED_SCRIPT_ERR_IO:       return "io";
+        case LED_SCRIPT_ERR_MAGIC:    return "bad magic";
+        case LED_SCRIPT_ERR_VERSION:  return "bad version";
+        case LED_SCRIPT_ERR_SIZE:     return "bad size";
+        case LED_SCRIPT_ERR_OPCODE:   return "bad opcode";
+        case LED_SCRIPT_ERR_OPERAND:  return "bad operand";
+        case LED_SCRIPT_ERR_TARGET:   return "bad jump target";
+    }
+    return "?";
+}
@@ -0,0 +1,123 @@
+//** ESP32-S3 HoloCubic - LED/Backlight Animation Bytecode
+//** Linus原则：动画是数据不是代码 - 换动画只换SPIFFS里的文件，不重新烧录
+//**
+//** - 主机上用 scripts/6_led_script.py 把文本编译成字节码，放进SPIFFS的 /anim/
+//** - 解释器不分配内存：字节码在调用者的缓冲区里，状态全在 led_script_t 里
+//** - 每次 led_script_step() 最多执行 LED_SCRIPT_MAX_STEPS 条指令 - 没有wait的死循环也卡不住主循环
+//** - 时间按指令累加 (wait 100 就是上一条结束后100ms)，不会因为tick抖动越跑越慢
+//** - 纯函数，不依赖Arduino，主机上可以模拟和测时 (src/native/led_script_main.cpp)
+//**
+//** 文件格式 (小端):
+//**   头   8字节: magic "HCLS", version, reserved, code_size
+//**   代码 code_size字节，跳转地址是代码内偏移
+//**
+//** 指令 (操作码 + 操作数):
+//**   END                      0x00                    停在当前颜色
+//**   SET   r g b              0x01 r g b              立即换色
+//**   FADE  r g b ms           0x02 r g b ms16         从当前颜色渐变，渐变完才执行下一条
+//**   WAIT  ms                 0x03 ms16
+//**   LIGHT level ms           0x04 level ms16         背光渐变到level (0-255)，不等待
+//**   REPEAT n                 0x05 n                  n次循环开始 (n>=1)，最多嵌套 LED_SCRIPT_MAX_DEPTH 层
+//**   NEXT  addr               0x06 addr16             计数没到就跳回addr
+//**   JUMP  addr               0x07 addr16
+//**   IF    state addr         0x08 state addr16       状态位为1就跳
+//**   IFNOT state addr         0x09 state addr16       状态位为0就跳
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "led_driver.h"  // led_color_t
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LED_SCRIPT_MAGIC 0x534C4348u    // "HCLS"
+#define LED_SCRIPT_VERSION 1
+#define LED_SCRIPT_HEADER_SIZE 8
+#define LED_SCRIPT_MAX_CODE 1024        // 单个脚本的代码上限，也是文件缓冲区的推荐大小
+#define LED_SCRIPT_MAX_STEPS 16         // 每个tick最多执行的指令数
+#define LED_SCRIPT_MAX_DEPTH 4          // REPEAT嵌套层数
+
+typedef enum {
+    LED_OP_END = 0x00,
+    LED_OP_SET,
+    LED_OP_FADE,
+    LED_OP_WAIT,
+    LED_OP_LIGHT,
+    LED_OP_REPEAT,
+    LED_OP_NEXT,
+    LED_OP_JUMP,
+    LED_OP_IF,
+    LED_OP_IFNOT,
+    LED_OP_COUNT
+} led_script_op_t;
+
+//** 分支用的状态位 - 由应用每个tick交给 led_script_step()
+typedef enum {
+    LED_STATE_WIFI_READY = 0,   // WiFi已连接
+    LED_STATE_WIFI_BUSY,        // 正在连接
+    LED_STATE_WIFI_FAILED,      // 连接失败
+    LED_STATE_COUNT             // 最多32个
+} led_script_state_t;
+
+typedef enum {
+    LED_SCRIPT_OK = 0,
+    LED_SCRIPT_ERR_IO,          // 文件打不开或读不全
+    LED_SCRIPT_ERR_MAGIC,
+    LED_SCRIPT_ERR_VERSION,
+    LED_SCRIPT_ERR_SIZE,        // 代码为空、超过上限或和头不一致
+    LED_SCRIPT_ERR_OPCODE,      // 未知操作码或操作数被截断
+    LED_SCRIPT_ERR_OPERAND,     // REPEAT 0或状态位超出范围
+    LED_SCRIPT_ERR_TARGET       // 跳转地址不在指令边界上
+} led_script_result_t;
+
+typedef enum {
+    LED_SCRIPT_IDLE = 0,        // 还没绑定代码
+    LED_SCRIPT_RUNNING,
+    LED_SCRIPT_DONE,            // 执行了END
+    LED_SCRIPT_FAULT            // REPEAT嵌套太深或NEXT没有对应的REPEAT
+} led_script_status_t;
+
+//** 解释器状态 - 调用者静态分配
+typedef struct {
+    const uint8_t* code;        // 绑定的代码，调用者保证一直有效
+    uint16_t size;
+    uint16_t pc;
+    uint8_t status;             // led_script_status_t
+    bool busy;                  // 当前的FADE已经开始，正在等它走完
+    uint8_t depth;
+    uint8_t loops[LED_SCRIPT_MAX_DEPTH];
+    uint32_t clock;             // 当前指令的逻辑开始时间 (ms)
+    led_color_t from, to;       // 颜色渐变
+    uint32_t fade_start;
+    uint16_t fade_ms;
+    bool light_used;            // 脚本是否碰过背光
+    uint8_t light_from, light_to;
+    uint32_t light_start;
+    uint16_t light_ms;
+    uint32_t executed;          // 累计执行的指令数
+} led_script_t;
+
+//** 检查文件镜像并绑定代码 - 成功后要 led_script_start() 才会跑
+led_script_result_t led_script_bind(led_script_t* script, const uint8_t* image, size_t len);
+
+//** 从头开始，颜色黑
+void led_script_start(led_script_t* script, uint32_t now_ms);
+
+//** 推进到now - 最多LED_SCRIPT_MAX_STEPS条指令；返回是否还在运行
+bool led_script_step(led_script_t* script, uint32_t now_ms, uint32_t state);
+
+//** 当前颜色 (含渐变插值)
+led_color_t led_script_color(const led_script_t* script, uint32_t now_ms);
+
+//** 当前背光 0-255；脚本没碰过背光返回-1
+int16_t led_script_backlight(const led_script_t* script, uint32_t now_ms);
+
+const char* led_script_result_str(led_script_result_t result);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,23 @@
+//** 从SPIFFS加载LED动画脚本实现
+
+#include "led_script_fs.h"
+#include <string.h>
+
+led_script_result_t led_script_load_file(fs::FS& fs, const char* path, uint8_t* buf, size_t cap,
+                                         led_script_t* script) {
+    memset(script, 0, sizeof(*script));
+
+    fs::File file = fs.open(path, "r");
+    if (!file) return LED_SCRIPT_ERR_IO;
+
+    size_t len = file.size();
+    if (len > cap) {
+        file.close();
+        return LED_SCRIPT_ERR_SIZE;
+    }
+    size_t got = file.read(buf, len);
+    file.close();
+    if (got != len) return LED_SCRIPT_ERR_IO;
+
+    return led_script_bind(script, buf, len);
+}
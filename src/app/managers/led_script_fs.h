@@ -0,0 +1,15 @@
+#pragma once
+
+//** 从SPIFFS加载LED动画脚本 - 依赖Arduino FS，主机模拟 (env:native) 用native/fakes里的FS替身
+//**
+//** 用法:
+//**   static uint8_t buf[LED_SCRIPT_HEADER_SIZE + LED_SCRIPT_MAX_CODE];
+//**   static led_script_t script;
+//**   if (led_script_load_file(SPIFFS, "/anim/status.lsc", buf, sizeof(buf), &script) == LED_SCRIPT_OK) ...
+
+#include "led_script.h"
+#include <FS.h>
+
+//** 读进调用者的缓冲区再绑定 - 失败时script不可用 (status保持IDLE)
+led_script_result_t led_script_load_file(fs::FS& fs, const char* path, uint8_t* buf, size_t cap,
+                                         led_script_t* script);
@@ -0,0 +1,148 @@
+//** ESP32-S3 HoloCubic - LED Waveform Engine Implementation
+//** Linus原则：表是数据，插值是一行整数运算
+
+#include "led_wave.h"
+
+//** round(65535 * (sin(2*pi*i/256) + 1) / 2)
+static const uint16_t sine_table[256] = {
+    32768, 33572, 34375, 35178, 35979, 36779, 37575, 38369,
+    39160, 39947, 40729, 41507, 42279, 43046, 43807, 44560,
+    45307, 46046, 46777, 47500, 48214, 48919, 49613, 50298,
+    50972, 51635, 52287, 52927, 53555, 54170, 54773, 55362,
+    55938, 56499, 57047, 57579, 58097, 58600, 59087, 59558,
+    60013, 60451, 60873, 61278, 61666, 62036, 62389, 62724,
+    63041, 63339, 63620, 63881, 64124, 64348, 64553, 64739,
+    64905, 65053, 65180, 65289, 65377, 65446, 65496, 65525,
+    65535, 65525, 65496, 65446, 65377, 65289, 65180, 65053,
+    64905, 64739, 64553, 64348, 64124, 63881, 63620, 63339,
+    63041, 62724, 62389, 62036, 61666, 61278, 60873, 60451,
+    60013, 59558, 59087, 58600, 58097, 57579, 57047, 56499,
+    55938, 55362, 54773, 54170, 53555, 52927, 52287, 51635,
+    50972, 50298, 49613, 48919, 48214, 47500, 46777, 46046,
+    45307, 44560, 43807, 43046, 42279, 41507, 40729, 39947,
+    39160, 38369, 37575, 36779, 35979, 35178, 34375, 33572,
+    32768, 31963, 31160, 30357, 29556, 28756, 27960, 27166,
+    26375, 25588, 24806, 24028, 23256, 22489, 21728, 20975,
+    20228, 19489, 18758, 18035, 17321, 16616, 15922, 15237,
+    14563, 13900, 13248, 12608, 11980, 11365, 10762, 10173,
+     9597,  9036,  8488,  7956,  7438,  6935,  6448,  5977,
+     5522,  5084,  4662,  4257,  3869,  3499,  3146,  2811,
+     2494,  2196,  1915,  1654,  1411,  1187,   982,   796,
+      630,   482,   355,   246,   158,    89,    39,    10,
+        0,    10,    39,    89,   158,   246,   355,   482,
+      630,   796,   982,  1187,  1411,  1654,  1915,  2196,
+     2494,  2811,  3146,  3499,  3869,  4257,  4662,  5084,
+     5522,  5977,  6448,  6935,  7438,  7956,  8488,  9036,
+     9597, 10173, 10762, 11365, 11980, 12608, 13248, 13900,
+    14563, 15237, 15922, 16616, 17321, 18035, 18758, 19489,
+    20228, 20975, 21728, 22489, 23256, 24028, 24806, 25588,
+    26375, 27166, 27960, 28756, 29556, 30357, 31160, 31963,
+};
+
+//** round(65535 * ((1 - cos(2*pi*i/256)) / 2) ^ 2.2)
+static const uint16_t breathe_table[256] = {
+        0,     0,     0,     0,     0,     0,     1,     1,
+        2,     4,     6,    10,    14,    20,    28,    37,
+       49,    64,    82,   104,   130,   160,   195,   237,
+      284,   338,   399,   468,   546,   633,   731,   838,
+      957,  1088,  1231,  1388,  1559,  1744,  1945,  2162,
+     2395,  2646,  2915,  3202,  3508,  3834,  4180,  4547,
+     4935,  5345,  5777,  6231,  6708,  7208,  7731,  8278,
+     8848,  9442, 10060, 10702, 11367, 12056, 12768, 13504,
+    14263, 15044, 15848, 16674, 17521, 18388, 19276, 20184,
+    21110, 22054, 23016, 23994, 24987, 25995, 27016, 28049,
+    29094, 30148, 31211, 32282, 33359, 34441, 35526, 36614,
+    37702, 38790, 39875, 40957, 42033, 43103, 44165, 45217,
+    46257, 47285, 48299, 49297, 50277, 51239, 52180, 53100,
+    53997, 54869, 55715, 56533, 57323, 58083, 58812, 59509,
+    60173, 60801, 61395, 61952, 62471, 62952, 63394, 63796,
+    64158, 64478, 64757, 64994, 65188, 65340, 65448, 65513,
+    65535, 65513, 65448, 65340, 65188, 64994, 64757, 64478,
+    64158, 63796, 63394, 62952, 62471, 61952, 61395, 60801,
+    60173, 59509, 58812, 58083, 57323, 56533, 55715, 54869,
+    53997, 53100, 52180, 51239, 50277, 49297, 48299, 47285,
+    46257, 45217, 44165, 43103, 42033, 40957, 39875, 38790,
+    37702, 36614, 35526, 34441, 33359, 32282, 31211, 30148,
+    29094, 28049, 27016, 25995, 24987, 23994, 23016, 22054,
+    21110, 20184, 19276, 18388, 17521, 16674, 15848, 15044,
+    14263, 13504, 12768, 12056, 11367, 10702, 10060,  9442,
+     8848,  8278,  7731,  7208,  6708,  6231,  5777,  5345,
+     4935,  4547,  4180,  3834,  3508,  3202,  2915,  2646,
+     2395,  2162,  1945,  1744,  1559,  1388,  1231,  1088,
+      957,   838,   731,   633,   546,   468,   399,   338,
+      284,   237,   195,   160,   130,   104,    82,    64,
+       49,    37,    28,    20,    14,    10,     6,     4,
+        2,     1,     1,     0,     0,     0,     0,     0,
+};
+
+//** 高8位查表，低8位在相邻两项之间插值；最后一项和第0项相邻
+static uint16_t table_lookup(const uint16_t* table, uint16_t phase) {
+    uint8_t i = (uint8_t)(phase >> 8);
+    int32_t a = table[i];
+    int32_t b = table[(uint8_t)(i + 1)];
+    return (uint16_t)(a + (((b - a) * (int32_t)(phase & 0xFF) + 128) >> 8));
+}
+
+//** 0..1..0，峰值在半周期
+static uint16_t triangle(uint16_t phase) {
+    uint32_t up = (uint32_t)phase << 1;  // 0..131070
+    return (uint16_t)(up <= LED_WAVE_ONE ? up : 2 * LED_WAVE_ONE - up + 1);
+}
+
+//** smoothstep: t*t*(3-2t)，Q16
+static uint16_t smoothstep(uint16_t t) {
+    uint64_t t2 = (uint64_t)t * t;
+    uint32_t s = (uint32_t)((t2 * (3 * 65536u - 2u * t) + ((uint64_t)1 << 31)) >> 32);
+    return (uint16_t)(s < LED_WAVE_ONE ? s : LED_WAVE_ONE);  // t=ONE时会舍入到65536
+}
+
+uint16_t led_wave_phase(uint32_t elapsed_ms, uint16_t period_ms) {
+    if (period_ms == 0) return 0;
+    uint32_t pos = elapsed_ms % period_ms;
+    return (uint16_t)((pos << 16) / period_ms);
+}
+
+uint16_t led_wave_level(led_wave_shape_t shape, uint16_t phase) {
+    switch (shape) {
+        case LED_WAVE_SQUARE:   return phase < 0x8000u ? LED_WAVE_ONE : 0;
+        case LED_WAVE_SINE:     return table_lookup(sine_table, phase);
+        case LED_WAVE_TRIANGLE: return triangle(phase);
+        case LED_WAVE_SAWTOOTH: return phase;
+        case LED_WAVE_EASE:     return smoothstep(triangle(phase));
+        case LED_WAVE_BREATHE:  return table_lookup(breathe_table, phase);
+        default:                return 0;
+    }
+}
+
+led_color_t led_color_lerp(led_color_t a, led_color_t b, uint16_t t) {
+    //** 0..65535 -> 0..65536，这样t=ONE时正好是b
+    uint32_t w = (uint32_t)t + (t >> 15);
+    uint32_t v = 65536u - w;
+    led_color_t c;
+    c.r = (uint8_t)((a.r * v + b.r * w + 32768u) >> 16);
+    c.g = (uint8_t)((a.g * v + b.g * w + 32768u) >> 16);
+    c.b = (uint8_t)((a.b * v + b.b * w + 32768u) >> 16);
+    return c;
+}
+
+led_color_t led_keyframes_sample(const led_keyframe_t* frames, uint8_t count, uint16_t phase) {
+    led_color_t black = { 0, 0, 0 };
+    if (!frames || count == 0) return black;
+    if (count == 1) return frames[0].color;
+
+    //** 找phase之前最后一帧；在第一帧之前就是最后一帧 (绕回)
+    uint8_t i = count - 1;
+    for (uint8_t k = 0; k < count; k++) {
+        if (frames[k].at > phase) break;
+        i = k;
+    }
+    const led_keyframe_t* from = &frames[i];
+    const led_keyframe_t* to = &frames[(uint8_t)(i + 1) % count];
+
+    //** 无符号16位减法自动处理绕回
+    uint16_t span = (uint16_t)(to->at - from->at);
+    uint16_t pos = (uint16_t)(phase - from->at);
+    if (span == 0) return to->color;
+    uint16_t t = (uint16_t)((uint32_t)pos * LED_WAVE_ONE / span);
+    return led_color_lerp(from->color, to->color, t);
+}
@@ -0,0 +1,51 @@
+//** ESP32-S3 HoloCubic - LED Waveform Engine
+//** Linus原则：查表加整数插值，主循环里没有浮点
+//**
+//** - 相位和亮度都是Q16: 0..65535 表示 0..1 (亮度65535就是满)
+//** - 正弦和呼吸曲线各一张256项表，相邻两项线性插值
+//** - 三角、锯齿、缓入缓出直接整数计算
+//** - 误差: 和double参考相比亮度不超过 ±8/65535 (呼吸表最大，约6)，插值后的8位颜色不超过 ±1
+//** - 纯函数，不依赖Arduino，主机上可以直接验证
+
+#pragma once
+
+#include <stdint.h>
+#include "led_driver.h"  // led_color_t
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LED_WAVE_ONE 65535u     // Q16的1.0
+
+typedef enum {
+    LED_WAVE_SQUARE = 0,        // 前半周期亮 - 闪烁
+    LED_WAVE_SINE,              // (sin+1)/2，从一半亮度往上走 - 原来的呼吸灯
+    LED_WAVE_TRIANGLE,          // 0 -> 1 -> 0
+    LED_WAVE_SAWTOOTH,          // 0 -> 1 然后跳回0
+    LED_WAVE_EASE,              // 缓入缓出的三角波 (smoothstep)
+    LED_WAVE_BREATHE,           // 从灭开始的余弦再做gamma 2.2 - 人眼看起来均匀
+    LED_WAVE_COUNT
+} led_wave_shape_t;
+
+//** 关键帧 - at是周期内的相位 (Q16)，按升序排列
+typedef struct {
+    uint16_t at;
+    led_color_t color;
+} led_keyframe_t;
+
+//** 周期内相位 - period为0时返回0
+uint16_t led_wave_phase(uint32_t elapsed_ms, uint16_t period_ms);
+
+//** 波形在相位处的亮度 (Q16)；未知波形返回0
+uint16_t led_wave_level(led_wave_shape_t shape, uint16_t phase);
+
+//** 颜色插值 - t=0得到a，t=LED_WAVE_ONE得到b，四舍五入
+led_color_t led_color_lerp(led_color_t a, led_color_t b, uint16_t t);
+
+//** 关键帧采样 - 相邻两帧之间线性插值，最后一帧和第一帧之间绕回
+led_color_t led_keyframes_sample(const led_keyframe_t* frames, uint8_t count, uint16_t phase);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,75 +1,115 @@
 //** ESP32-S3 HoloCubic - Heartbeat Monitor Implementation  
 //** Linus原则：非阻塞心跳，使用系统状态
+//**
+//** 心跳灯是一段LED脚本，放在最低优先级的图层：
+//** - SPIFFS里有 /anim/heartbeat.lsc 就用它，没有就用下面内置的那段
+//** - 内置的一圈正好是一个心跳间隔；hb改间隔时改写灭灯那条wait，灯和计数一起变
+//** - 这里只负责计数和打印，不再直接碰LED驱动
 
 #include "heartbeat.h"
 #include "../../core/config/hardware_config.h"
 #include "../../core/state/system_state.h"
 #include "../../core/config/app_constants.h"
-#include "../../drivers/led/led_driver.h"
+#include "../managers/led_manager.h"
+#include "../managers/led_script_fs.h"
+#include "../interface/command_line.h"
+#include "../../system/serial_out.h"
 #include <Arduino.h>
+#include <SPIFFS.h>
 
-//** 心跳状态机
-typedef enum {
-    HEARTBEAT_IDLE,
-    HEARTBEAT_LED_ON,
-    HEARTBEAT_LED_OFF
-} heartbeat_phase_t;
+#define HEARTBEAT_SCRIPT_PATH "/anim/heartbeat.lsc"
+#define HEARTBEAT_MIN_INTERVAL_MS 100
+#define HEARTBEAT_MAX_INTERVAL_MS 60000
 
-static heartbeat_phase_t heartbeat_phase = HEARTBEAT_IDLE;
-static uint32_t phase_start_ms = 0;
+#define LE16(v) (uint8_t)((v) & 0xFF), (uint8_t)(((v) >> 8) & 0xFF)
+
+//** 内置心跳: 绿灯亮HW_LED_HEARTBEAT_ON_MS，灭到一个心跳间隔为止，循环 - 一圈就是一个间隔，不会和计数越差越远
+static uint8_t heartbeat_builtin[] = {
+    'H', 'C', 'L', 'S', LED_SCRIPT_VERSION, 0, LE16(17),
+    LED_OP_SET, 0, 255, 0,
+    LED_OP_WAIT, LE16(HW_LED_HEARTBEAT_ON_MS),
+    LED_OP_SET, 0, 0, 0,
+    LED_OP_WAIT, LE16(HEARTBEAT_DEFAULT_INTERVAL_MS - HW_LED_HEARTBEAT_ON_MS),
+    LED_OP_JUMP, LE16(0),
+};
+
+//** 灭灯那条wait的参数在镜像里的位置: 头 + SET(4) + WAIT(3) + SET(4) + 操作码
+#define HEARTBEAT_OFF_WAIT_AT (LED_SCRIPT_HEADER_SIZE + 4 + 3 + 4 + 1)
+
+static uint8_t heartbeat_file[LED_SCRIPT_HEADER_SIZE + LED_SCRIPT_MAX_CODE];
+static led_script_t heartbeat_script;
+static bool heartbeat_from_file = false;
+
+//** 先试SPIFFS，不行再用内置的
+static void heartbeat_load_script(void) {
+    led_script_result_t result = led_script_load_file(SPIFFS, HEARTBEAT_SCRIPT_PATH, heartbeat_file,
+                                                      sizeof(heartbeat_file), &heartbeat_script);
+    if (result == LED_SCRIPT_OK) {
+        serial_out.printf("  心跳动画: %s\n", HEARTBEAT_SCRIPT_PATH);
+        heartbeat_from_file = true;
+        return;
+    }
+    if (result != LED_SCRIPT_ERR_IO) {
+        serial_out.printf("  心跳动画 %s 无效 (%s)，使用内置\n", HEARTBEAT_SCRIPT_PATH, led_script_result_str(result));
+    }
+    led_script_bind(&heartbeat_script, heartbeat_builtin, sizeof(heartbeat_builtin));
+}
+
+//** 串口命令 hb [ms] - 不带参数只打印；新间隔从下一次心跳起生效
+//** 内置脚本改写灭灯的wait再从头放，灯和计数一起变；SPIFFS的脚本节奏是它自己的，只改计数
+//** 在渲染核上跑 (COMMAND_RENDER)，和解释器同一个核，改脚本字节不会被读到一半
+static void heartbeat_command(uint8_t argc, char* argv[]) {
+    auto* hb = HEARTBEAT_STATE();
+    if (argc > 1) {
+        uint32_t ms;
+        if (!command_arg_u32(argv[1], HEARTBEAT_MIN_INTERVAL_MS, HEARTBEAT_MAX_INTERVAL_MS, &ms)) {
+            serial_out.printf("Bad interval '%s' (%u-%u ms)\n", argv[1], HEARTBEAT_MIN_INTERVAL_MS,
+                          HEARTBEAT_MAX_INTERVAL_MS);
+            return;
+        }
+        hb->interval_ms = ms;
+        if (!heartbeat_from_file) {
+            uint16_t off_ms = (uint16_t)(ms - HW_LED_HEARTBEAT_ON_MS);
+            heartbeat_builtin[HEARTBEAT_OFF_WAIT_AT] = (uint8_t)(off_ms & 0xFF);
+            heartbeat_builtin[HEARTBEAT_OFF_WAIT_AT + 1] = (uint8_t)(off_ms >> 8);
+            led_set_script(LED_PRIORITY_IDLE, &heartbeat_script, 0);
+            hb->last_beat_ms = millis();  // 计数和重新开始的灯对齐 / beats line up with the restarted LED
+        }
+    }
+    serial_out.printf("Heartbeat: every %u ms, %u beats%s\n", hb->interval_ms, hb->beat_count,
+                      heartbeat_from_file ? " (LED timing from " HEARTBEAT_SCRIPT_PATH ")" : "");
+}
+
+static const command_t heartbeat_commands[] = {
+    {"hb", heartbeat_command, "hb [ms] - Heartbeat interval (LED + beat count)", 0, 1, COMMAND_RENDER},
+};
 
 void heartbeat_init(void) {
     HEARTBEAT_STATE()->last_beat_ms = millis();
     HEARTBEAT_STATE()->interval_ms = HEARTBEAT_DEFAULT_INTERVAL_MS; // 原魔数: 1000
     HEARTBEAT_STATE()->beat_count = 0;
-    heartbeat_phase = HEARTBEAT_IDLE;
+    
+    heartbeat_load_script();
+    led_set_script(LED_PRIORITY_IDLE, &heartbeat_script, 0);
+    command_register(heartbeat_commands, sizeof(heartbeat_commands) / sizeof(heartbeat_commands[0]));
 }
 
-//** 处理心跳空闲状态
-static void heartbeat_handle_idle(uint32_t now, decltype(g_system_state.heartbeat)* hb) {
+void heartbeat_process(void) {
+    uint32_t now = millis();
+    auto* hb = HEARTBEAT_STATE();
+    
     //** 检查是否到了心跳时间
     if (now - hb->last_beat_ms < hb->interval_ms) {
         return;  // 还没到心跳时间
     }
     
-    //** 开始心跳 - 点亮绿色LED
-    led_green();
-    
-    heartbeat_phase = HEARTBEAT_LED_ON;
-    phase_start_ms = now;
+    //** 按间隔累加，不从now重算 - 和灯脚本一样，调度晚一点不会越积越多；落后一个间隔以上就重新对齐
+    hb->last_beat_ms = (now - hb->last_beat_ms < 2 * hb->interval_ms) ? hb->last_beat_ms + hb->interval_ms : now;
     hb->beat_count++;
     
     //** 打印系统状态（每10次心跳打印一次）
     if (hb->beat_count % 10 == 0) {
-        Serial.printf("Heartbeat #%u - Uptime: %u ms, Free heap: %u bytes\n", 
+        serial_out.printf("Heartbeat #%u - Uptime: %u ms, Free heap: %u bytes\n", 
                      hb->beat_count, now, ESP.getFreeHeap());
     }
 }
-
-//** 处理LED点亮状态
-static void heartbeat_handle_led_on(uint32_t now, decltype(g_system_state.heartbeat)* hb) {
-    //** 检查是否到了关闭时间
-    if (now - phase_start_ms < HW_LED_HEARTBEAT_ON_MS) {
-        return;  // 还没到关闭时间
-    }
-    
-    led_off();
-    heartbeat_phase = HEARTBEAT_IDLE;
-    hb->last_beat_ms = now;
-}
-
-void heartbeat_process(void) {
-    uint32_t now = millis();
-    auto* hb = HEARTBEAT_STATE();
-    
-    //** 使用早期返回消除嵌套
-    if (heartbeat_phase == HEARTBEAT_IDLE) {
-        heartbeat_handle_idle(now, hb);
-        return;
-    }
-    
-    if (heartbeat_phase == HEARTBEAT_LED_ON) {
-        heartbeat_handle_led_on(now, hb);
-        return;
-    }
-}
\ No newline at end of file
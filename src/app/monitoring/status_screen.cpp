@@ -0,0 +1,93 @@
+//** ESP32-S3 HoloCubic - Status Screen Implementation
+//** Linus原则：没变就不画 - 每个字段记住上次画的字符串
+//**
+//** - 帧缓冲模式下只有画过的字段进脏列表，静止时刷新什么都不发
+//** - 没有PSRAM时退回直接画，同样只画变了的字段
+
+#include "status_screen.h"
+#include "../../drivers/display/display_driver.h"
+#include "../core/app_main.h"
+#include "../network/wifi_app.h"
+#include "../../system/serial_out.h"
+#include <Arduino.h>
+#include <stdio.h>
+#include <string.h>
+
+#define STATUS_FONT 1                   // GLCD 6x8，放大2倍 = 12x16
+#define STATUS_SIZE 2
+#define STATUS_LABEL_X 8
+#define STATUS_VALUE_X 96
+#define STATUS_TOP 64
+#define STATUS_LINE 28
+#define STATUS_VALUE_CHARS 12           // 定宽到屏幕右边，短的值用空格盖掉上次的尾巴
+
+typedef enum {
+    STATUS_WIFI = 0,
+    STATUS_UPTIME,
+    STATUS_FPS,
+    STATUS_HEAP,
+    STATUS_FIELD_COUNT
+} status_field_t;
+
+static const char* const status_labels[STATUS_FIELD_COUNT] = { "WiFi", "Uptime", "FPS", "Heap" };
+static char status_shown[STATUS_FIELD_COUNT][STATUS_VALUE_CHARS + 1];
+
+static const char* status_wifi_name(wifi_state_t state) {
+    switch (state) {
+        case WIFI_STATE_CONNECTING: return "connecting";
+        case WIFI_STATE_CONNECTED:  return "connected";
+        case WIFI_STATE_FAILED:     return "failed";
+        case WIFI_STATE_IDLE:
+        default:                    return "idle";
+    }
+}
+
+//** 值变了才画 - 帧缓冲里只有这一行的矩形变脏
+static void status_field(status_field_t field, const char* value, uint16_t color) {
+    char padded[STATUS_VALUE_CHARS + 1];
+    snprintf(padded, sizeof(padded), "%-*s", STATUS_VALUE_CHARS, value);
+    if (strcmp(padded, status_shown[field]) == 0) return;
+
+    memcpy(status_shown[field], padded, sizeof(padded));
+    display_text(STATUS_VALUE_X, STATUS_TOP + field * STATUS_LINE, padded, STATUS_FONT, STATUS_SIZE, color,
+                 DISPLAY_BLACK);
+}
+
+void status_screen_init(void) {
+    if (!display_framebuffer_enable(true)) {
+        serial_out.println("  状态屏: 没有帧缓冲，直接画");
+    }
+    display_clear(DISPLAY_BLACK);
+    display_text(STATUS_LABEL_X, 16, "HoloCubic", STATUS_FONT, 3, DISPLAY_WHITE, DISPLAY_BLACK);
+    for (uint8_t i = 0; i < STATUS_FIELD_COUNT; i++) {
+        display_text(STATUS_LABEL_X, STATUS_TOP + i * STATUS_LINE, status_labels[i], STATUS_FONT, STATUS_SIZE,
+                     DISPLAY_CYAN, DISPLAY_BLACK);
+        status_shown[i][0] = '\0';
+    }
+}
+
+void status_screen_render(void) {
+    char value[32];                     // 比字段宽，status_field截到定宽
+
+    const wifi_app_t* wifi = wifi_app_get_state();
+    if (wifi->state == WIFI_STATE_CONNECTED) {
+        snprintf(value, sizeof(value), "%d dBm", wifi->rssi);
+    } else {
+        snprintf(value, sizeof(value), "%s", status_wifi_name(wifi->state));
+    }
+    status_field(STATUS_WIFI, value, wifi->state == WIFI_STATE_CONNECTED ? DISPLAY_GREEN : DISPLAY_YELLOW);
+
+    uint32_t seconds = millis() / 1000;
+    snprintf(value, sizeof(value), "%02lu:%02lu:%02lu", (unsigned long)(seconds / 3600),
+             (unsigned long)(seconds / 60 % 60), (unsigned long)(seconds % 60));
+    status_field(STATUS_UPTIME, value, DISPLAY_WHITE);
+
+    //** 帧间隔中位数 - 一帧都没有时先空着
+    const frame_pacer_t* pacer = app_frame_pacer();
+    uint32_t interval = frame_hist_percentile(&pacer->interval, 50);
+    snprintf(value, sizeof(value), "%lu", interval ? (unsigned long)(1000000UL / interval) : 0UL);
+    status_field(STATUS_FPS, value, DISPLAY_WHITE);
+
+    snprintf(value, sizeof(value), "%lu KB", (unsigned long)(ESP.getFreeHeap() / 1024));
+    status_field(STATUS_HEAP, value, DISPLAY_WHITE);
+}
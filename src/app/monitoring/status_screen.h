@@ -0,0 +1,18 @@
+//** ESP32-S3 HoloCubic - Status Screen Header
+//** Linus原则：默认的帧渲染 - 只重画变了的字段，界面不变时刷新一带都不发
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//** 初始化 - 开帧缓冲 (没有PSRAM就直接画到屏上)，画标题和标签
+void status_screen_init(void);
+
+//** app_set_render() 的回调 - 按帧节拍调用，WiFi、运行时间、帧率、空闲堆
+void status_screen_render(void);
+
+#ifdef __cplusplus
+}
+#endif
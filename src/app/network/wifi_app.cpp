@@ -3,8 +3,11 @@
 //** 职责：WiFi连接状态管理，简化接口，单一数据源
 
 #include "wifi_app.h"
+#include "../core/app_trace.h"
+#include "../core/event_bus.h"
 #include "../../core/config/hardware_config.h"
-#include "../../config/secrets.h"
+#include "secrets.h"  // config/secrets.h，主机模拟时是native/fakes里的假凭据
+#include "../../system/serial_out.h"
 #include <Arduino.h>
 #include <WiFi.h>
 
@@ -17,8 +20,15 @@ static wifi_app_t g_wifi_app = {
     .is_ready = false
 };
 
+//** 状态变了就发事件 - 订阅者不用再定时读g_wifi_app
+static void wifi_set_state(wifi_state_t state) {
+    if (g_wifi_app.state == state) return;
+    g_wifi_app.state = state;
+    event_publish(EVENT_WIFI_STATE, (uint16_t)state, g_wifi_app.rssi);
+}
+
 void wifi_app_init(void) {
-    Serial.println("WiFi App: 初始化");
+    serial_out.println("WiFi App: 初始化");
     
     //** 初始化WiFi硬件
     WiFi.mode(WIFI_STA);
@@ -30,61 +40,74 @@ void wifi_app_init(void) {
     g_wifi_app.last_check = 0;
     g_wifi_app.rssi = 0;
     
-    Serial.println("WiFi App: 初始化完成，等待连接命令");
+    serial_out.println("WiFi App: 初始化完成，等待连接命令");
+}
+
+//** WiFi驱动返回的状态和信号强度是外部输入 - 读的地方都走这里，顺便记下来
+static wl_status_t wifi_status(void) {
+    wl_status_t status = WiFi.status();
+    app_trace_wifi_status((uint8_t)status);
+    return status;
+}
+
+static int8_t wifi_rssi(void) {
+    int8_t rssi = WiFi.RSSI();
+    app_trace_wifi_rssi(rssi);
+    return rssi;
 }
 
 //** 启动WiFi连接
 static void wifi_start_connection(uint32_t now) {
-    Serial.print("WiFi App: 开始连接到 ");
-    Serial.println(WIFI_SSID_1);
+    serial_out.print("WiFi App: 开始连接到 ");
+    serial_out.println(WIFI_SSID_1);
     WiFi.begin(WIFI_SSID_1, WIFI_PASSWORD_1);
-    g_wifi_app.state = WIFI_STATE_CONNECTING;
     g_wifi_app.connect_time = now;
     g_wifi_app.last_check = now;
+    wifi_set_state(WIFI_STATE_CONNECTING);
 }
 
 //** 处理连接中状态
 static void wifi_handle_connecting(uint32_t now) {
-    if (WiFi.status() == WL_CONNECTED) {
+    if (wifi_status() == WL_CONNECTED) {
         //** 连接成功
-        g_wifi_app.state = WIFI_STATE_CONNECTED;
         g_wifi_app.is_ready = true;
-        g_wifi_app.rssi = WiFi.RSSI();
-        Serial.print("WiFi App: ✓ 连接成功 - IP: ");
-        Serial.println(WiFi.localIP());
+        g_wifi_app.rssi = wifi_rssi();
+        wifi_set_state(WIFI_STATE_CONNECTED);
+        serial_out.print("WiFi App: ✓ 连接成功 - IP: ");
+        serial_out.println(WiFi.localIP());
         return;
     }
     
     if (now - g_wifi_app.connect_time > HW_WIFI_CONNECT_TIMEOUT_MS) {
         //** 连接超时
-        g_wifi_app.state = WIFI_STATE_FAILED;
-        Serial.println("WiFi App: ✗ 连接超时");
+        wifi_set_state(WIFI_STATE_FAILED);
+        serial_out.println("WiFi App: ✗ 连接超时");
     }
 }
 
 //** 处理已连接状态
 static void wifi_handle_connected(uint32_t now) {
-    if (WiFi.status() != WL_CONNECTED) {
+    if (wifi_status() != WL_CONNECTED) {
         //** 连接丢失，重新连接
-        g_wifi_app.state = WIFI_STATE_CONNECTING;
         g_wifi_app.is_ready = false;
         g_wifi_app.connect_time = now;
+        wifi_set_state(WIFI_STATE_CONNECTING);
         WiFi.reconnect();
-        Serial.println("WiFi App: 重新连接...");
+        serial_out.println("WiFi App: 重新连接...");
         return;
     }
     
     //** 更新信号强度
-    g_wifi_app.rssi = WiFi.RSSI();
+    g_wifi_app.rssi = wifi_rssi();
 }
 
 //** 处理失败状态
 static void wifi_handle_failed(uint32_t now) {
     //** 失败后重试
-    g_wifi_app.state = WIFI_STATE_CONNECTING;
     g_wifi_app.connect_time = now;
+    wifi_set_state(WIFI_STATE_CONNECTING);
     WiFi.begin(WIFI_SSID_1, WIFI_PASSWORD_1);
-    Serial.println("WiFi App: 重试连接...");
+    serial_out.println("WiFi App: 重试连接...");
 }
 
 void wifi_app_process(void) {
@@ -2,6 +2,7 @@
 #define HARDWARE_INIT_H
 
 #include "hardware_config.h"
+#include "../../system/serial_out.h"
 #include <Arduino.h>
 
 /*
@@ -168,23 +169,23 @@ static inline hw_init_result_t init_all_hardware(void) {
     // 按依赖顺序初始化
     result = init_display_hardware();
     if (result != HW_INIT_OK) {
-        Serial.printf("Display hardware init failed: %d\n", result);
+        serial_out.printf("Display hardware init failed: %d\n", result);
         return result;
     }
     
     result = init_led_hardware();
     if (result != HW_INIT_OK) {
-        Serial.printf("LED hardware init failed: %d\n", result);
+        serial_out.printf("LED hardware init failed: %d\n", result);
         return result;
     }
     
     result = init_imu_hardware();
     if (result != HW_INIT_OK) {
-        Serial.printf("IMU hardware init failed: %d\n", result);
+        serial_out.printf("IMU hardware init failed: %d\n", result);
         return result;
     }
     
-    Serial.println("All hardware initialized successfully");
+    serial_out.println("All hardware initialized successfully");
     return HW_INIT_OK;
 }
 
@@ -195,29 +196,29 @@ static inline hw_init_result_t init_all_hardware(void) {
 static inline void print_hardware_config(void) {
     const hardware_config_t* cfg = get_hardware_config();
     
-    Serial.println("\n=== Hardware Configuration ===");
-    Serial.printf("Board: %s %s\n", cfg->board_name, cfg->version);
-    Serial.printf("System Clock: %u MHz\n", cfg->system_clock_mhz);
-    Serial.printf("Serial Baud: %u\n", cfg->serial_baud_rate);
+    serial_out.println("\n=== Hardware Configuration ===");
+    serial_out.printf("Board: %s %s\n", cfg->board_name, cfg->version);
+    serial_out.printf("System Clock: %u MHz\n", cfg->system_clock_mhz);
+    serial_out.printf("Serial Baud: %u\n", cfg->serial_baud_rate);
     
-    Serial.println("\nDisplay:");
-    Serial.printf("  Type: %d, Size: %dx%d\n", 
+    serial_out.println("\nDisplay:");
+    serial_out.printf("  Type: %d, Size: %dx%d\n", 
         cfg->display.type, cfg->display.width, cfg->display.height);
-    Serial.printf("  SPI: MISO=%d, MOSI=%d, SCLK=%d, CS=%d\n",
+    serial_out.printf("  SPI: MISO=%d, MOSI=%d, SCLK=%d, CS=%d\n",
         cfg->display.spi.miso, cfg->display.spi.mosi, 
         cfg->display.spi.sclk, cfg->display.spi.cs);
-    Serial.printf("  Control: DC=%d, RST=%d, BL=%d\n",
+    serial_out.printf("  Control: DC=%d, RST=%d, BL=%d\n",
         cfg->display.dc_pin, cfg->display.rst_pin, cfg->display.backlight.pin);
     
-    Serial.println("\nLED:");
-    Serial.printf("  Type: %d, Count: %d, Pin: %d\n",
+    serial_out.println("\nLED:");
+    serial_out.printf("  Type: %d, Count: %d, Pin: %d\n",
         cfg->led.type, cfg->led.count, cfg->led.data_pin);
     
-    Serial.println("\nIMU:");
-    Serial.printf("  Type: %d, I2C: SDA=%d, SCL=%d, Addr=0x%02X\n",
+    serial_out.println("\nIMU:");
+    serial_out.printf("  Type: %d, I2C: SDA=%d, SCL=%d, Addr=0x%02X\n",
         cfg->imu.type, cfg->imu.i2c.sda, cfg->imu.i2c.scl, cfg->imu.i2c.address);
     
-    Serial.println("============================\n");
+    serial_out.println("============================\n");
 }
 
 #endif // HARDWARE_INIT_H
@@ -7,11 +7,13 @@
 #include "app_main.h"           // 应用主程序
 #include "led_manager.h"        // LED管理器
 #include "display_driver.h"     // 显示驱动
+#include "display_assets_flash.h"  // UI资源包分区
 #include "../config/app_constants.h"  // 应用常量
 
 #include "imu_gesture_driver.h" // IMU手势驱动
 #include "hardware_config.h"    // 硬件配置
 #include "system_constants.h"   // 系统常量定义
+#include "serial_out.h"         // 串口输出 (两个核共用一把锁)
 #include <Wire.h>
 #include <SPIFFS.h>  // SPIFFS文件系统
 #include <FS.h>      // File系统基础类
@@ -88,28 +90,28 @@ boot_result_t system_early_init(void) {
 
 //** 阶段2：打印系统信息和构建配置
 void system_print_banner(void) {
-  Serial.println("========================================");
-  Serial.println("ESP32-S3 HoloCubic - Linus Style Architecture");
+  serial_out.println("========================================");
+  serial_out.println("ESP32-S3 HoloCubic - Linus Style Architecture");
 
 #if ENABLE_TEST_CODE
-  Serial.println("*** DEVELOPMENT BUILD - TEST CODE ENABLED ***");
+  serial_out.println("*** DEVELOPMENT BUILD - TEST CODE ENABLED ***");
 #else
-  Serial.println("*** PRODUCTION BUILD ***");
+  serial_out.println("*** PRODUCTION BUILD ***");
 #endif
 
-  Serial.println("========================================");
+  serial_out.println("========================================");
 
   //** 编译时宏检查 - 确认测试代码状态
 #if ENABLE_TEST_CODE
-  Serial.println("✓ Test code is ENABLED");
+  serial_out.println("✓ Test code is ENABLED");
 #else
-  Serial.println("✗ Test code is DISABLED");
+  serial_out.println("✗ Test code is DISABLED");
 #endif
 
 #if ENABLE_TFT_TESTS
-  Serial.println("✓ TFT tests are ENABLED");
+  serial_out.println("✓ TFT tests are ENABLED");
 #else
-  Serial.println("✗ TFT tests are DISABLED");
+  serial_out.println("✗ TFT tests are DISABLED");
 #endif
 
 #if ENABLE_SYSTEM_INFO
@@ -120,49 +122,58 @@ void system_print_banner(void) {
 
 //** 存储系统初始化 - Linus风格：直接执行，无冗余检查
 boot_result_t storage_init_all(void) {
-  Serial.println("- Storage Systems");
+  serial_out.println("- Storage Systems");
 
   //** Flash存储初始化 - SPIFFS
-  Serial.println("  - Flash Storage (SPIFFS)");
+  serial_out.println("  - Flash Storage (SPIFFS)");
   if (!SPIFFS.begin(true)) {  // true = 格式化如果挂载失败
-    Serial.println("    ✗ SPIFFS mount failed");
+    serial_out.println("    ✗ SPIFFS mount failed");
     return BOOT_ERROR_STORAGE;
   }
   
   // 打印SPIFFS信息
   size_t total_bytes = SPIFFS.totalBytes();
   size_t used_bytes = SPIFFS.usedBytes();
-  Serial.printf("    ✓ SPIFFS: %zu/%zu bytes (%.1f%% used)\n", 
+  serial_out.printf("    ✓ SPIFFS: %zu/%zu bytes (%.1f%% used)\n", 
                 used_bytes, total_bytes, 
                 (float)used_bytes / total_bytes * PERCENTAGE_MULTIPLIER);
+
+  //** UI资源包 - 映射Flash分区，没烧写时不影响启动
+  serial_out.println("  - Asset Pack (flash mmap)");
+  const display_assets_t* assets = display_assets_mount(DISPLAY_ASSETS_PARTITION);
+  if (assets) {
+    serial_out.printf("    ✓ Assets: %u entries, %u bytes\n", assets->count, (unsigned)assets->size);
+  } else {
+    serial_out.println("    ✗ No asset pack (scripts/5_asset_pack.py flash)");
+  }
   
 
 
 #if ENABLE_SD_TESTS
   //** SD卡存储初始化 - SD_MMC
-  Serial.println("  - SD Card Storage (SD_MMC)");
+  serial_out.println("  - SD Card Storage (SD_MMC)");
   
   // ESP32-S3 SD卡初始化 - 使用验证过的HoloCubic配置
-  Serial.printf("    Using HoloCubic pins: CLK=%d, CMD=%d, D0=%d\n", HW_SD_CLK, HW_SD_CMD, HW_SD_D0);
-  Serial.println("    Note: Using SDMMC_FREQ_DEFAULT to avoid ESP32-S3 40MHz frequency issues");
+  serial_out.printf("    Using HoloCubic pins: CLK=%d, CMD=%d, D0=%d\n", HW_SD_CLK, HW_SD_CMD, HW_SD_D0);
+  serial_out.println("    Note: Using SDMMC_FREQ_DEFAULT to avoid ESP32-S3 40MHz frequency issues");
   
   // 关键解决方案：使用SDMMC_FREQ_DEFAULT避免ESP32-S3的40MHz频率问题
   SD_MMC.setPins(HW_SD_CLK, HW_SD_CMD, HW_SD_D0);
   if (SD_MMC.begin("/root", true, false, SDMMC_FREQ_DEFAULT)) {
     uint64_t cardSize = SD_MMC.cardSize() / BYTES_TO_MB; // 原魔数: (1024 * 1024)
     uint8_t cardType = SD_MMC.cardType();
-    Serial.printf("    ✓ SD card initialized: %lluMB\n", cardSize);
-    Serial.printf("    ✓ Card type: %s\n", 
+    serial_out.printf("    ✓ SD card initialized: %lluMB\n", cardSize);
+    serial_out.printf("    ✓ Card type: %s\n", 
                   cardType == CARD_MMC ? "MMC" :
                   cardType == CARD_SD ? "SDSC" :
                   cardType == CARD_SDHC ? "SDHC" : "UNKNOWN");
   } else {
-    Serial.println("    ✗ SD card initialization failed with HoloCubic method");
-    Serial.println("    Check: 1) SD card inserted? 2) Pin connections? 3) Card format (FAT32)?");
+    serial_out.println("    ✗ SD card initialization failed with HoloCubic method");
+    serial_out.println("    Check: 1) SD card inserted? 2) Pin connections? 3) Card format (FAT32)?");
   }
 #else
   //** SD卡存储跳过 - 测试被禁用
-  Serial.println("  - SD Card Storage: Disabled");
+  serial_out.println("  - SD Card Storage: Disabled");
 #endif
 
   return BOOT_OK;
@@ -172,25 +183,25 @@ boot_result_t storage_init_all(void) {
 boot_result_t hardware_init_all(void) {
   current_boot_stage = BOOT_STAGE_HARDWARE;
 
-  Serial.println("Initializing hardware...");
+  serial_out.println("Initializing hardware...");
 
   //** 存储系统初始化 - 优先初始化，其他模块可能需要存储
   boot_result_t storage_result = storage_init_all();
   if (storage_result != BOOT_OK) {
-    Serial.println("Storage initialization failed, continuing with limited functionality");
+    serial_out.println("Storage initialization failed, continuing with limited functionality");
     // 存储失败不阻止系统启动，但记录错误
   }
 
   //** TFT显示屏初始化
-  Serial.println("- TFT Display");
+  serial_out.println("- TFT Display");
   display_init();
 
   //** LED管理器初始化
-  Serial.println("- LED Manager");
+  serial_out.println("- LED Manager");
   led_manager_init();
 
   //** IMU初始化 - Linus风格：直接执行，调用者负责顺序
-  Serial.println("- IMU System");
+  serial_out.println("- IMU System");
   
   // I2C + 传感器 + 驱动 - 一次性完成，无状态检查
   Wire.begin(HW_IMU_SDA, HW_IMU_SCL);
@@ -199,7 +210,7 @@ boot_result_t hardware_init_all(void) {
   QMI8658_init();        // 直接初始化，无检查
   imu_gesture_init();    // 手势驱动初始化，无检查
   
-  Serial.println("  ✓ IMU system initialized (Linus style - no checks)");
+  serial_out.println("  ✓ IMU system initialized (Linus style - no checks)");
 
   //** 启动指示 - 蓝色闪烁
   led_set_solid(LED_PRIORITY_SYSTEM, 0, 0, PWM_MAX_VALUE, HW_LED_STARTUP_DURATION_MS); // 原魔数: 255
@@ -211,15 +222,15 @@ boot_result_t hardware_init_all(void) {
 boot_result_t application_init_all(void) {
   current_boot_stage = BOOT_STAGE_APPLICATION;
 
-  Serial.println("- Application modules");
+  serial_out.println("- Application modules");
   app_init();
 
 #if ENABLE_TFT_TESTS
-  Serial.println("TFT display tests available - press '4' to run");
+  serial_out.println("TFT display tests available - press '4' to run");
 #endif
 
 #if ENABLE_IMU_TESTS
-  Serial.println(
+  serial_out.println(
       "IMU gesture tests enabled - UP/DOWN/LEFT/RIGHT detection active");
 #endif
 
@@ -243,7 +254,7 @@ boot_result_t system_boot_sequence(void) {
   // 阶段3：硬件初始化
   result = hardware_init_all();
   if (result != BOOT_OK) {
-    Serial.printf("Hardware initialization failed at stage: %s\n",
+    serial_out.printf("Hardware initialization failed at stage: %s\n",
                   get_boot_stage_name(current_boot_stage));
     return result;
   }
@@ -251,35 +262,35 @@ boot_result_t system_boot_sequence(void) {
   // 阶段4：应用初始化
   result = application_init_all();
   if (result != BOOT_OK) {
-    Serial.printf("Application initialization failed at stage: %s\n",
+    serial_out.printf("Application initialization failed at stage: %s\n",
                   get_boot_stage_name(current_boot_stage));
     return result;
   }
 
-  Serial.println("✓ All systems initialized successfully");
+  serial_out.println("✓ All systems initialized successfully");
   
   // 打印存储系统状态 - 简单版本
-  Serial.println("=== Storage System Status ===");
+  serial_out.println("=== Storage System Status ===");
   if (SPIFFS.begin(false)) {
     size_t total = SPIFFS.totalBytes();
     size_t used = SPIFFS.usedBytes();
-    Serial.printf("Flash (SPIFFS): %zu/%zu bytes (%.1f%% used)\n", 
+    serial_out.printf("Flash (SPIFFS): %zu/%zu bytes (%.1f%% used)\n", 
                   used, total, (float)used / total * PERCENTAGE_MULTIPLIER);
   } else {
-    Serial.println("Flash (SPIFFS): ERROR - Mount failed");
+    serial_out.println("Flash (SPIFFS): ERROR - Mount failed");
   }
   
 #if ENABLE_SD_TESTS
   if (SD_MMC.cardSize() > 0) {
     uint64_t cardSize = SD_MMC.cardSize() / BYTES_TO_MB; // 原魔数: (1024 * 1024)
-    Serial.printf("SD Card: %lluMB available\n", cardSize);
+    serial_out.printf("SD Card: %lluMB available\n", cardSize);
   } else {
-    Serial.println("SD Card: Not available");
+    serial_out.println("SD Card: Not available");
   }
 #else
-  Serial.println("SD Card: Tests disabled");
+  serial_out.println("SD Card: Tests disabled");
 #endif
-  Serial.println("=============================");
+  serial_out.println("=============================");
   
   return BOOT_OK;
 }
@@ -287,27 +298,27 @@ boot_result_t system_boot_sequence(void) {
 //** 实现Flash信息打印函数
 void debug_flash_info() {
 #if DEBUG_FLASH_ENABLED && (GLOBAL_DEBUG_LEVEL >= DEBUG_LEVEL_INFO)
-    Serial.println("========================================");
-    Serial.println("=== Flash Partition Information ===");
-    Serial.println("========================================");
-    Serial.printf("[FLASH] Total size: %u bytes (%.2f MB)\n", 
+    serial_out.println("========================================");
+    serial_out.println("=== Flash Partition Information ===");
+    serial_out.println("========================================");
+    serial_out.printf("[FLASH] Total size: %u bytes (%.2f MB)\n", 
         ESP.getFlashChipSize(), ESP.getFlashChipSize() / KB_TO_MB_DIVISOR / BYTES_TO_KB); // 原魔数: 1024.0 / 1024.0
-    Serial.printf("[FLASH] Speed: %u Hz\n", ESP.getFlashChipSpeed());
-    Serial.printf("[FLASH] Mode: %u\n", ESP.getFlashChipMode());
+    serial_out.printf("[FLASH] Speed: %u Hz\n", ESP.getFlashChipSpeed());
+    serial_out.printf("[FLASH] Mode: %u\n", ESP.getFlashChipMode());
     
     // SPIFFS信息
     if (SPIFFS.begin(false)) {
         size_t total_bytes = SPIFFS.totalBytes();
         size_t used_bytes = SPIFFS.usedBytes();
-        Serial.printf("[SPIFFS] Total: %zu bytes (%.2f MB)\n", 
+        serial_out.printf("[SPIFFS] Total: %zu bytes (%.2f MB)\n", 
             total_bytes, total_bytes / KB_TO_MB_DIVISOR / BYTES_TO_KB); // 原魔数: 1024.0 / 1024.0
-        Serial.printf("[SPIFFS] Used: %zu bytes (%.2f MB)\n", 
+        serial_out.printf("[SPIFFS] Used: %zu bytes (%.2f MB)\n", 
             used_bytes, used_bytes / KB_TO_MB_DIVISOR / BYTES_TO_KB); // 原魔数: 1024.0 / 1024.0
-        Serial.printf("[SPIFFS] Free: %zu bytes (%.2f MB)\n", 
+        serial_out.printf("[SPIFFS] Free: %zu bytes (%.2f MB)\n", 
             total_bytes - used_bytes, (total_bytes - used_bytes) / KB_TO_MB_DIVISOR / BYTES_TO_KB); // 原魔数: 1024.0 / 1024.0
     } else {
-        Serial.println("[SPIFFS] Not mounted");
+        serial_out.println("[SPIFFS] Not mounted");
     }
-    Serial.println("========================================");
+    serial_out.println("========================================");
 #endif
 }
\ No newline at end of file
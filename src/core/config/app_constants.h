@@ -16,6 +16,14 @@ extern "C" {
 //** WiFi LED指示相关
 #define WIFI_LED_UPDATE_INTERVAL_MS    2000    // WiFi状态LED更新间隔 (2秒)
 
+// ========================================
+// 主循环调度相关常量
+// ========================================
+
+#define APP_IDLE_MAX_MS                1000    // 主循环最长睡眠，loop()里的健康检查靠它
+#define APP_COMMAND_POLL_MS            20      // 串口没有接收事件时的轮询间隔
+#define APP_LINK_BUSY_POLL_US          2000    // 上传的图在等渲染核 - 画完会叫醒，这是收件箱满时的兜底
+
 // ========================================
 // LED闪烁相关常量
 // ========================================
@@ -37,6 +37,11 @@
 #define HW_LED_PIN 39
 #define HW_LED_COUNT 2
 #define HW_LED_BRIGHTNESS 200
+#define HW_LED_MAX_REFRESH_HZ 200  // show()上限，每次都要关中断发整条灯带
+#define HW_LED_RMT_CHANNEL 0       // 非阻塞发送用的RMT通道，占用通道0和1的内存块
+#ifndef HW_LED_RMT_ASYNC
+#define HW_LED_RMT_ASYNC 1         // 0 = 退回FastLED.show() 阻塞发送 (主机构建用)
+#endif
 
 // TFT dispaly显示配置 (ST7789 240x240)
 //
@@ -49,6 +54,7 @@
 #define HW_DISPLAY_WIDTH 240
 #define HW_DISPLAY_HEIGHT 240
 #define HW_DISPLAY_SPI_FREQ 40000000
+#define HW_DISPLAY_GRAM_HEIGHT 320       // ST7789显存行数，面板只显示其中240行
 
 // 应用层显示配置
 #define HW_DISPLAY_DEFAULT_ROTATION 4    // HoloCubic全息模式
@@ -76,10 +82,22 @@
 #define HW_SYSTEM_CPU_MHZ 240
 #define HW_SYSTEM_SERIAL_BAUD 115200
 
+// 双核分工 - loop()在ARDUINO_RUNNING_CORE (核1) 上渲染和驱动LED
+// WiFi、存储、串口命令放到核0，和WiFi协议栈在一起
+#define HW_CORE_IO 0
+#define HW_IO_TASK_STACK 8192   // WiFi连接和串口printf
+#define HW_IO_TASK_PRIORITY 1   // 和loopTask相同
+
+// 输入记录 (app_trace) - 缓冲放PSRAM，满了就停；0 = 不记录
+// 每圈loop()一个2字节节拍，其余输入很少；空闲时一秒一百圈左右，256KB够二十来分钟
+#ifndef HW_TRACE_BYTES
+#define HW_TRACE_BYTES 0
+#endif
+#define HW_TRACE_FILE "/trace.bin"   // 串口命令 T 存到SPIFFS的这个文件
+
 // 系统时间常量 - 消除魔数
 #define HW_SYSTEM_STARTUP_DELAY_MS 1000 // ESP32-S3启动稳定时间
 #define HW_SYSTEM_HEALTH_CHECK_MS 30000 // 系统健康检查间隔
-#define HW_SYSTEM_TFT_UPDATE_MS 10000   // TFT显示更新间隔
 
 // LED系统常量
 #define HW_LED_STARTUP_DURATION_MS 200 // 启动指示LED持续时间
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <Arduino.h>
+#include "../../system/serial_out.h"
 
 // ========================================
 // 错误处理宏 - 统一风格
@@ -20,17 +21,17 @@ typedef enum {
     RESULT_ERROR_NETWORK_FAIL
 } result_t;
 
-//** 统一的成功/失败日志宏
-#define LOG_SUCCESS(msg) Serial.println("✓ " msg)
-#define LOG_ERROR(msg)   Serial.println("✗ " msg)
-#define LOG_WARNING(msg) Serial.println("⚠ " msg)
-#define LOG_INFO(msg)    Serial.println("ℹ " msg)
+//** 统一的成功/失败日志宏 - 一行一次write，不会被另一个核的输出拆开
+#define LOG_SUCCESS(msg) serial_out.print("✓ " msg "\r\n")
+#define LOG_ERROR(msg)   serial_out.print("✗ " msg "\r\n")
+#define LOG_WARNING(msg) serial_out.print("⚠ " msg "\r\n")
+#define LOG_INFO(msg)    serial_out.print("ℹ " msg "\r\n")
 
 //** 带格式化的日志宏
-#define LOG_SUCCESS_F(fmt, ...) Serial.printf("✓ " fmt "\n", ##__VA_ARGS__)
-#define LOG_ERROR_F(fmt, ...)   Serial.printf("✗ " fmt "\n", ##__VA_ARGS__)
-#define LOG_WARNING_F(fmt, ...) Serial.printf("⚠ " fmt "\n", ##__VA_ARGS__)
-#define LOG_INFO_F(fmt, ...)    Serial.printf("ℹ " fmt "\n", ##__VA_ARGS__)
+#define LOG_SUCCESS_F(fmt, ...) serial_out.printf("✓ " fmt "\n", ##__VA_ARGS__)
+#define LOG_ERROR_F(fmt, ...)   serial_out.printf("✗ " fmt "\n", ##__VA_ARGS__)
+#define LOG_WARNING_F(fmt, ...) serial_out.printf("⚠ " fmt "\n", ##__VA_ARGS__)
+#define LOG_INFO_F(fmt, ...)    serial_out.printf("ℹ " fmt "\n", ##__VA_ARGS__)
 
 //** 早期返回宏 - Linus风格
 #define RETURN_IF_NULL(ptr) \
@@ -0,0 +1,73 @@
+//** ESP32-S3 HoloCubic - 单生产者单消费者无锁环形队列
+//** Linus原则：一个写者一个读者就不需要锁 - 各自只写自己的下标
+//**
+//** - 只有一个任务push，只有一个任务pop；两个核各占一头
+//** - 容量是2的幂，下标是自由增长的uint32，相减就是元素个数，回绕也正确
+//** - 生产者release发布head，消费者acquire读head后才读槽；tail反过来，槽可以安全重用
+//** - 两边各缓存对方的下标，只有看起来满/空时才去读另一个核写的缓存行
+//** - 满了push返回false，由生产者决定丢弃还是重试，队列自己不阻塞
+//** - 只用头文件，主机上用std::thread压测 (src/native/spsc_stress_main.cpp)
+
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+#ifndef SPSC_CACHE_LINE
+#define SPSC_CACHE_LINE 64      // 生产者和消费者的下标放在不同缓存行，互不干扰
+#endif
+
+template <typename T, uint32_t N>
+class spsc_queue {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "spsc_queue capacity must be a power of two");
+
+public:
+    spsc_queue() : head_(0), tail_cache_(0), tail_(0), head_cache_(0) {}
+
+    //** 生产者 - 满了返回false
+    bool push(const T& item) {
+        uint32_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_cache_ == N) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head - tail_cache_ == N) return false;
+        }
+        slots_[head & (N - 1)] = item;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    //** 消费者 - 空了返回false
+    bool pop(T* item) {
+        uint32_t tail = tail_.load(std::memory_order_relaxed);
+        if (head_cache_ == tail) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (head_cache_ == tail) return false;
+        }
+        *item = slots_[tail & (N - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    //** 两边都能调用，另一边同时在动时只是个近似值
+    uint32_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    bool empty() const { return size() == 0; }
+
+    static uint32_t capacity() { return N; }
+
+private:
+    //** 生产者的缓存行：自己的head和看到的tail
+    alignas(SPSC_CACHE_LINE) std::atomic<uint32_t> head_;
+    uint32_t tail_cache_;
+
+    //** 消费者的缓存行
+    alignas(SPSC_CACHE_LINE) std::atomic<uint32_t> tail_;
+    uint32_t head_cache_;
+
+    alignas(SPSC_CACHE_LINE) T slots_[N];
+
+    spsc_queue(const spsc_queue&);
+    spsc_queue& operator=(const spsc_queue&);
+};
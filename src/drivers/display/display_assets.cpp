@@ -0,0 +1,153 @@
+//** UI资源包实现 / UI Asset Pack Implementation
+//**
+//** 只读包里的数据 - 不分配，不拷贝 / Reads from the pack in place - no allocation, no copies
+
+#include "display_assets.h"
+#include <string.h>
+
+#define QOI_OP_DIFF    0x40
+#define QOI_OP_LUMA    0x80
+#define QOI_OP_RUN     0xC0
+#define QOI_OP_LITERAL 0xFE
+
+static inline uint8_t qoi_hash(uint16_t px) {
+    return (uint8_t)(((px >> 11) * 3 + ((px >> 5) & 63) * 5 + (px & 31) * 7) & 63);
+}
+
+static inline uint16_t qoi_pack(int h, int m, int l) {
+    return (uint16_t)(((h & 31) << 11) | ((m & 63) << 5) | (l & 31));
+}
+
+uint32_t display_assets_hash(const char* name) {
+    uint32_t h = 2166136261u;
+    while (*name) h = (h ^ (uint8_t)*name++) * 16777619u;
+    return h;
+}
+
+bool display_assets_open(display_assets_t* pack, const void* base, uint32_t size) {
+    memset(pack, 0, sizeof(*pack));
+    if (!base || ((uintptr_t)base & 3) || size < sizeof(display_assets_header_t)) return false;
+
+    const display_assets_header_t* header = (const display_assets_header_t*)base;
+    if (header->magic != DISPLAY_ASSETS_MAGIC || header->version != DISPLAY_ASSETS_VERSION) return false;
+    if (header->size > size) return false;  // 包被截断 / truncated pack
+
+    uint32_t index_end = sizeof(*header) + (uint32_t)header->count * sizeof(display_asset_entry_t);
+    if (index_end > header->size) return false;
+
+    const display_asset_entry_t* entries = (const display_asset_entry_t*)(header + 1);
+    for (uint16_t i = 0; i < header->count; i++) {
+        const display_asset_entry_t* e = &entries[i];
+        if (e->offset < index_end || e->offset > header->size || e->length > header->size - e->offset) return false;
+        if (e->codec > DISPLAY_ASSET_QOI565 || e->name[DISPLAY_ASSET_NAME_MAX - 1] != '\0') return false;
+        //** 原始像素的长度是定的 - 对不上的项解到一半就会缺数据 / Raw pixels have a fixed length - a mismatched
+        //** entry would run out of data half way through
+        if (e->codec == DISPLAY_ASSET_RAW && (uint32_t)e->width * e->height * sizeof(uint16_t) != e->length) {
+            return false;
+        }
+        if (i && e->hash < entries[i - 1].hash) return false;  // 必须有序 / must be sorted
+    }
+
+    pack->base = (const uint8_t*)base;
+    pack->size = header->size;
+    pack->entries = entries;
+    pack->count = header->count;
+    return true;
+}
+
+const display_asset_entry_t* display_assets_find(const display_assets_t* pack, const char* name) {
+    uint32_t hash = display_assets_hash(name);
+    uint32_t lo = 0, hi = pack->count;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if (pack->entries[mid].hash < hash) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    //** 打包工具拒绝哈希冲突，比较名字只是防止误命中 / The packer rejects hash collisions, comparing names only guards against false hits
+    if (lo < pack->count && pack->entries[lo].hash == hash &&
+        strncmp(pack->entries[lo].name, name, DISPLAY_ASSET_NAME_MAX) == 0) {
+        return &pack->entries[lo];
+    }
+    return NULL;
+}
+
+void display_asset_decoder_init(display_asset_decoder_t* dec, const display_assets_t* pack,
+                                const display_asset_entry_t* entry) {
+    memset(dec, 0, sizeof(*dec));
+    dec->src = pack->base + entry->offset;
+    dec->end = dec->src + entry->length;
+    dec->codec = entry->codec;
+}
+
+uint32_t display_asset_decode(display_asset_decoder_t* dec, uint16_t* out, uint32_t count) {
+    if (dec->codec == DISPLAY_ASSET_RAW) {
+        //** 包是小端的，和ESP32一样 / The pack is little-endian, like the ESP32
+        uint32_t avail = (uint32_t)(dec->end - dec->src) / sizeof(uint16_t);
+        if (count > avail) {
+            count = avail;
+            dec->error = true;
+        }
+        memcpy(out, dec->src, count * sizeof(uint16_t));
+        dec->src += count * sizeof(uint16_t);
+        return count;
+    }
+
+    const uint8_t* s = dec->src;
+    const uint8_t* end = dec->end;
+    uint16_t px = dec->px;
+    uint32_t n = 0;
+
+    while (n < count) {
+        if (dec->run) {
+            uint32_t k = count - n < dec->run ? count - n : dec->run;
+            dec->run -= (uint8_t)k;
+            while (k--) out[n++] = px;
+            continue;
+        }
+
+        if (s >= end) {
+            dec->error = true;
+            break;
+        }
+
+        uint8_t b = *s++;
+        if (b < QOI_OP_DIFF) {
+            px = dec->index[b];
+        } else if (b < QOI_OP_LUMA) {
+            px = qoi_pack((px >> 11) + ((b >> 4) & 3) - 2,
+                          ((px >> 5) & 63) + ((b >> 2) & 3) - 2,
+                          (px & 31) + (b & 3) - 2);
+        } else if (b < QOI_OP_RUN) {
+            if (s >= end) {
+                dec->error = true;
+                break;
+            }
+            uint8_t b2 = *s++;
+            int dm = (b & 63) - 32;
+            int half = ((dm + 32) >> 1) - 16;  // floor(dm / 2)
+            px = qoi_pack((px >> 11) + (b2 >> 4) - 8 + half,
+                          ((px >> 5) & 63) + dm,
+                          (px & 31) + (b2 & 15) - 8 + half);
+        } else if (b < QOI_OP_LITERAL) {
+            dec->run = (uint8_t)(b - QOI_OP_RUN + 1);
+            continue;
+        } else if (b == QOI_OP_LITERAL && end - s >= 2) {
+            px = (uint16_t)(s[0] | (s[1] << 8));
+            s += 2;
+        } else {
+            dec->error = true;
+            break;
+        }
+
+        dec->index[qoi_hash(px)] = px;
+        out[n++] = px;
+    }
+
+    dec->src = s;
+    dec->px = px;
+    return n;
+}
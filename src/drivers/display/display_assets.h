@@ -0,0 +1,97 @@
+#pragma once
+
+//** UI资源包 - 压缩的RGB565资源，从Flash分区直接映射 / UI Asset Pack - Compressed RGB565 Assets Mapped Straight from Flash
+//**
+//** 设计要点 / Design Notes:
+//** 1. 包是一块只读内存 - 设备上是mmap的分区，主机上是mmap的文件
+//**    A pack is one read-only block of memory - a mapped partition on the device, a mapped file on the host
+//** 2. 索引按名字哈希排序，查找是一次二分 / The index is sorted by name hash, a lookup is one binary search
+//** 3. 解压是流式的 - 每次要多少像素解多少，不需要整张图的缓冲
+//**    Decompression streams - as many pixels as asked for, no whole-image buffer
+//** 4. 打包工具 / Packer: scripts/5_asset_pack.py
+//**
+//** 格式 (小端) / Format (little-endian):
+//**   头 / header  16字节 / bytes: magic "HCAP", version, count, size, reserved
+//**   索引 / index 32字节 × count, 按hash升序 / 32 bytes × count, ascending hash
+//**   数据 / data  每个资源4字节对齐 / every asset 4-byte aligned
+//**
+//** QOI565编码 - 像素按16位拆成高5/中6/低5位三个分量
+//** QOI565 codec - each 16-bit pixel is split into high 5 / middle 6 / low 5 bit fields
+//**   00iiiiii            INDEX   最近64色表 / recent-colour table [i]
+//**   01hhmmll            DIFF    各分量差 -2..1 (偏置2) / per-field delta -2..1 (bias 2)
+//**   10mmmmmm hhhhllll   LUMA    中差 -32..31, 高/低差减去中差/2后 -8..7
+//**                               middle delta -32..31, high/low delta minus middle/2 in -8..7
+//**   11rrrrrr            RUN     重复上一像素 1..62次 / repeat previous pixel 1..62 times
+//**   0xFE lo hi          LITERAL 原始像素 / raw pixel
+//**   颜色表哈希 / table hash: (h*3 + m*5 + l*7) & 63, 初始像素为0 / the initial pixel is 0
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DISPLAY_ASSETS_MAGIC   0x50414348u   // "HCAP"
+#define DISPLAY_ASSETS_VERSION 1
+#define DISPLAY_ASSET_NAME_MAX 12            // 含结尾0 / including the terminating 0
+
+typedef enum {
+    DISPLAY_ASSET_RAW = 0,                   // 未压缩RGB565 / uncompressed RGB565
+    DISPLAY_ASSET_QOI565 = 1
+} display_asset_codec_t;
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;
+    uint32_t size;                           // 整个包的字节数 / bytes in the whole pack
+    uint32_t reserved;
+} display_assets_header_t;
+
+typedef struct {
+    uint32_t hash;                           // 名字的FNV-1a / FNV-1a of the name
+    uint32_t offset;                         // 从包开头算 / from the start of the pack
+    uint32_t length;                         // 压缩后字节数 / compressed bytes
+    uint16_t width, height;
+    uint8_t codec;
+    uint8_t reserved[3];
+    char name[DISPLAY_ASSET_NAME_MAX];
+} display_asset_entry_t;
+
+typedef struct {
+    const uint8_t* base;
+    uint32_t size;
+    const display_asset_entry_t* entries;
+    uint16_t count;
+} display_assets_t;
+
+//** 解码器状态 - 像素是BGR565本机字节序 / Decoder state - pixels are BGR565 in native byte order
+typedef struct {
+    const uint8_t* src;
+    const uint8_t* end;
+    uint8_t codec;
+    uint8_t run;
+    uint16_t px;
+    bool error;
+    uint16_t index[64];
+} display_asset_decoder_t;
+
+//** 打开映射好的包 - 校验头和每个索引项 / Open a mapped pack - checks the header and every index entry
+bool display_assets_open(display_assets_t* pack, const void* base, uint32_t size);
+
+uint32_t display_assets_hash(const char* name);
+
+//** 二分查找 - 没有时返回NULL / Binary search - NULL when absent
+const display_asset_entry_t* display_assets_find(const display_assets_t* pack, const char* name);
+
+void display_asset_decoder_init(display_asset_decoder_t* dec, const display_assets_t* pack,
+                                const display_asset_entry_t* entry);
+
+//** 解出接下来的count个像素 - 返回实际数量，数据不足时设置error
+//** Decode the next count pixels - returns how many were produced, sets error when the data runs short
+uint32_t display_asset_decode(display_asset_decoder_t* dec, uint16_t* out, uint32_t count);
+
+#ifdef __cplusplus
+}
+#endif
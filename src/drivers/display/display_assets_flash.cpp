@@ -0,0 +1,36 @@
+//** 把UI资源包分区映射进地址空间实现 / Map the UI Asset Pack Partition into the Address Space Implementation
+
+#include "display_assets_flash.h"
+#include <esp_partition.h>
+
+static display_assets_t mounted_pack;
+static bool mounted = false;
+
+const display_assets_t* display_assets_mount(const char* label) {
+    if (mounted) return &mounted_pack;
+
+    const esp_partition_t* part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                                           (esp_partition_subtype_t)DISPLAY_ASSETS_SUBTYPE, label);
+    if (!part) {
+        DISPLAY_DEBUG("Asset partition not found: %s", label);
+        return NULL;
+    }
+
+    //** 映射经过cache读Flash，不占RAM，映射一直保留 / The mapping reads flash through the cache, costs no RAM and is kept for good
+    const void* base = NULL;
+    spi_flash_mmap_handle_t handle;
+    if (esp_partition_mmap(part, 0, part->size, SPI_FLASH_MMAP_DATA, &base, &handle) != ESP_OK) {
+        DISPLAY_DEBUG("Asset partition mmap failed");
+        return NULL;
+    }
+
+    if (!display_assets_open(&mounted_pack, base, part->size)) {
+        DISPLAY_DEBUG("Asset partition holds no valid pack");
+        spi_flash_munmap(handle);
+        return NULL;
+    }
+
+    mounted = true;
+    DISPLAY_DEBUG("Asset pack: %u assets, %u bytes", mounted_pack.count, (unsigned)mounted_pack.size);
+    return &mounted_pack;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+//** 把UI资源包分区映射进地址空间 / Map the UI Asset Pack Partition into the Address Space
+//**
+//** 用法 / Usage:
+//**   const display_assets_t* assets = display_assets_mount(DISPLAY_ASSETS_PARTITION);
+//**   display_asset_draw(assets, "logo", 0, 0);
+//**
+//** 写入分区 / Writing the partition: python3 scripts/5_asset_pack.py flash assets.bin
+
+#include "display_driver.h"
+
+#define DISPLAY_ASSETS_PARTITION "assets"     // FLASH_8MB.csv里的名字 / name in FLASH_8MB.csv
+#define DISPLAY_ASSETS_SUBTYPE   0x40         // 自定义数据子类型 / custom data subtype
+
+//** 只映射一次，之后返回同一个包；分区不存在或内容无效时返回NULL
+//** Maps once and returns the same pack afterwards; NULL when the partition is missing or holds no valid pack
+const display_assets_t* display_assets_mount(const char* label);
@@ -0,0 +1,230 @@
+//** 显示吞吐基准实现 / Display Throughput Benchmark Implementation
+
+#include "display_bench.h"
+#include "display_driver.h"
+#include "display_fake_spi.h"  //** 线上周期估算 / Wire cycle estimate
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_BLIT_SIZE 64
+#define BENCH_TEXT "HoloCubic 12:34"
+#define BENCH_GLYPH_BUDGET (16 * 1024)
+#define BENCH_DAMAGE_SIZE 64
+
+//** 用例之间共享的状态 - 绘图函数只拿到调用序号 / State shared by cases - draw functions only get the call index
+static int16_t bench_w, bench_h;
+static uint16_t* bench_pixels;
+static uint8_t* bench_rgb;
+static display_compositor_t bench_comp;
+static uint32_t bench_last_us;  // 上一个用例的墙钟 / wall time of the last case
+
+//** ========================================
+//** 用例 / Cases
+//** ========================================
+
+static void case_clear(uint32_t i) {
+    display_clear((i & 1) ? DISPLAY_BLUE : DISPLAY_BLACK);
+}
+
+static void case_rect(uint32_t i) {
+    display_rect((int16_t)(i * 37 % (bench_w - 16)), (int16_t)(i * 53 % (bench_h - 16)), 16, 16, (uint16_t)(i * 2654435761u));
+}
+
+static void case_pixel(uint32_t i) {
+    display_pixel((int16_t)(i * 7 % bench_w), (int16_t)(i * 13 % bench_h), (uint16_t)i);
+}
+
+static void case_hline(uint32_t i) {
+    int16_t y = (int16_t)(i % bench_h);
+    display_line(0, y, bench_w - 1, y, (uint16_t)i);
+}
+
+static void case_line(uint32_t i) {
+    int16_t y = (int16_t)(i % bench_h);
+    display_line(0, y, bench_w - 1, bench_h - 1 - y, (uint16_t)i);
+}
+
+static void case_text(uint32_t i) {
+    display_text(0, (int16_t)(i * 16 % (bench_h - 16)), BENCH_TEXT, 1, 2, DISPLAY_WHITE, DISPLAY_BLACK);
+}
+
+static void case_blit(uint32_t i) {
+    display_blit((int16_t)(i * 37 % (bench_w - BENCH_BLIT_SIZE)), (int16_t)(i * 53 % (bench_h - BENCH_BLIT_SIZE)),
+                 BENCH_BLIT_SIZE, BENCH_BLIT_SIZE, bench_pixels);
+}
+
+static void case_blit_rgb888(uint32_t i) {
+    display_blit_rgb888((int16_t)(i * 37 % (bench_w - BENCH_BLIT_SIZE)), (int16_t)(i * 53 % (bench_h - BENCH_BLIT_SIZE)),
+                        BENCH_BLIT_SIZE, BENCH_BLIT_SIZE, bench_rgb);
+}
+
+//** 帧缓冲模式: 画一个小块再刷新 - 只推脏矩形 / Framebuffer mode: draw a small block then flush - dirty rects only
+static void case_fb_rect_flush(uint32_t i) {
+    case_rect(i);
+    display_flush();
+}
+
+static void case_fb_clear_flush(uint32_t i) {
+    case_clear(i);
+    display_flush();
+}
+
+//** 合成: 一块64x64受损，所有图层都盖住它 / Compositing: one 64x64 block damaged, every layer covers it
+static void case_compose(uint32_t i) {
+    display_compositor_damage(&bench_comp, (int16_t)(i * 37 % (bench_w - BENCH_DAMAGE_SIZE)),
+                              (int16_t)(i * 53 % (bench_h - BENCH_DAMAGE_SIZE)), BENCH_DAMAGE_SIZE, BENCH_DAMAGE_SIZE);
+    display_compose(&bench_comp);
+}
+
+//** ========================================
+//** 计时与输出 / Timing and Output
+//** ========================================
+
+static void emit(const display_bench_config_t* config, const char* line) {
+    config->emit(config->ctx, line);
+}
+
+static uint32_t run_case(const display_bench_config_t* config, const char* name, uint32_t calls, void (*draw)(uint32_t)) {
+    display_stats_t before = *display_get_stats();
+    uint32_t start = config->now_us();
+    for (uint32_t i = 0; i < calls; i++) draw(i);
+    uint32_t elapsed = config->now_us() - start;
+    bench_last_us = elapsed;
+    const display_stats_t* after = display_get_stats();
+
+    display_bench_result_t result = { name, calls, elapsed, after->windows - before.windows, after->bytes - before.bytes };
+    char line[DISPLAY_BENCH_LINE_MAX];
+    display_bench_format(&result, config->spi_hz, line, sizeof(line));
+    emit(config, line);
+    return 1;
+}
+
+static void skip_case(const display_bench_config_t* config, const char* name, const char* why) {
+    char line[DISPLAY_BENCH_LINE_MAX];
+    snprintf(line, sizeof(line), "# %s skipped: %s", name, why);
+    emit(config, line);
+}
+
+//** 定点两位小数 / Fixed point with two decimals
+static void rate(char* out, uint32_t size, uint32_t pixels, uint32_t us) {
+    uint64_t centi = us ? (uint64_t)pixels * 100 / us : 0;
+    snprintf(out, size, "%lu.%02lu", (unsigned long)(centi / 100), (unsigned long)(centi % 100));
+}
+
+void display_bench_format(const display_bench_result_t* result, uint32_t spi_hz, char* line, uint32_t line_size) {
+    uint32_t pixels = result->bytes / sizeof(uint16_t);
+    uint32_t bus_us = display_spi_us(display_spi_cycles(result->bytes, result->windows), spi_hz);
+    uint32_t ns_call = result->calls ? (uint32_t)((uint64_t)result->us * 1000 / result->calls) : 0;
+
+    char wall_rate[16], bus_rate[16];
+    rate(wall_rate, sizeof(wall_rate), pixels, result->us);
+    rate(bus_rate, sizeof(bus_rate), pixels, bus_us);
+
+    snprintf(line, line_size, "%s,%lu,%lu,%lu,%lu,%s,%lu,%lu,%lu,%s",
+             result->name, (unsigned long)result->calls, (unsigned long)result->us, (unsigned long)ns_call,
+             (unsigned long)pixels, wall_rate, (unsigned long)result->bytes, (unsigned long)result->windows,
+             (unsigned long)bus_us, bus_rate);
+}
+
+//** ========================================
+//** 公开接口 / Public Interface
+//** ========================================
+
+uint32_t display_bench_run(const display_bench_config_t* config) {
+    if (!config || !config->now_us || !config->emit) return 0;
+    uint32_t scale = config->scale ? config->scale : 1;
+    uint32_t done = 0;
+    char line[DISPLAY_BENCH_LINE_MAX];
+
+    //** 基准只测立即模式和它自己开的缓存 / The benchmark measures immediate mode and the caches it enables itself
+    display_framebuffer_enable(false);
+    display_glyph_cache_enable(0);
+    bench_w = display_width();
+    bench_h = display_height();
+
+    snprintf(line, sizeof(line), "# display_bench v%d width=%d height=%d spi_hz=%lu scale=%lu",
+             DISPLAY_BENCH_VERSION, bench_w, bench_h, (unsigned long)config->spi_hz, (unsigned long)scale);
+    emit(config, line);
+    emit(config, "case,calls,us,ns_call,pixels,mpix_s,bus_bytes,windows,bus_us,bus_mpix_s");
+
+    //** 填充、直线 / Fills and lines
+    done += run_case(config, "clear", 8 * scale, case_clear);
+    done += run_case(config, "rect16", 1000 * scale, case_rect);
+    done += run_case(config, "pixel", 5000 * scale, case_pixel);
+    done += run_case(config, "hline", 500 * scale, case_hline);
+    done += run_case(config, "line", 500 * scale, case_line);
+
+    //** 文字 - 先直接画，再走字形缓存 (第一遍预热不计时)
+    //** Text - direct first, then through the glyph cache (the warm-up pass is not timed)
+    done += run_case(config, "text", 200 * scale, case_text);
+    if (display_glyph_cache_enable(BENCH_GLYPH_BUDGET)) {
+        case_text(0);
+        done += run_case(config, "text_cached", 200 * scale, case_text);
+        display_glyph_cache_enable(0);
+    } else {
+        skip_case(config, "text_cached", "no PSRAM");
+    }
+
+    //** 块传输 - 测试图案临时分配 / Blits - the test pattern is allocated for the run only
+    bench_pixels = (uint16_t*)malloc(BENCH_BLIT_SIZE * BENCH_BLIT_SIZE * sizeof(uint16_t));
+    bench_rgb = (uint8_t*)malloc(BENCH_BLIT_SIZE * BENCH_BLIT_SIZE * 3);
+    if (bench_pixels && bench_rgb) {
+        for (uint32_t i = 0; i < BENCH_BLIT_SIZE * BENCH_BLIT_SIZE; i++) {
+            bench_pixels[i] = (uint16_t)(i * 2654435761u >> 16);
+            bench_rgb[i * 3 + 0] = (uint8_t)i;
+            bench_rgb[i * 3 + 1] = (uint8_t)(i >> 6);
+            bench_rgb[i * 3 + 2] = (uint8_t)(i >> 3);
+        }
+        done += run_case(config, "blit64", 200 * scale, case_blit);
+        done += run_case(config, "blit64_rgb888", 100 * scale, case_blit_rgb888);
+    } else {
+        skip_case(config, "blit64", "out of memory");
+    }
+    free(bench_pixels);
+    free(bench_rgb);
+    bench_pixels = NULL;
+    bench_rgb = NULL;
+
+    //** 帧缓冲 - 绘图进PSRAM，刷新推脏矩形 / Framebuffer - drawing goes to PSRAM, flush pushes dirty rects
+    if (display_framebuffer_enable(true)) {
+        display_flush();
+        done += run_case(config, "fb_rect_flush", 500 * scale, case_fb_rect_flush);
+        done += run_case(config, "fb_clear_flush", 8 * scale, case_fb_clear_flush);
+        display_framebuffer_enable(false);
+    } else {
+        skip_case(config, "fb_flush", "no PSRAM");
+    }
+
+    //** 合成 - 1到4个全屏图层，0层不透明，上面的半透明；每个受损像素的代价看ns_px
+    //** Compositing - 1 to 4 full-screen layers, layer 0 opaque, the ones above translucent; ns_px is the cost per
+    //** damaged pixel
+    static const char* const compose_names[DISPLAY_LAYER_MAX] = { "compose_1", "compose_2", "compose_3", "compose_4" };
+    display_compositor_init(&bench_comp, bench_w, bench_h, DISPLAY_BLACK);
+    for (uint8_t layers = 1; layers <= DISPLAY_LAYER_MAX; layers++) {
+        uint8_t z = (uint8_t)(layers - 1);
+        if (!display_layer_create(&bench_comp, z, 0, 0, bench_w, bench_h, z > 0)) {
+            skip_case(config, compose_names[z], "no PSRAM");
+            break;
+        }
+        display_layer_fill(&bench_comp, z, 0, 0, bench_w, bench_h, (uint16_t)(0x18E3u << z), z ? 96 : 255);
+        display_compose(&bench_comp);  // 整屏受损的第一帧不计时 / the first, fully damaged frame is not timed
+
+        display_compositor_stats_t before = bench_comp.stats;
+        done += run_case(config, compose_names[z], 100 * scale, case_compose);
+        uint32_t us = bench_last_us;
+        uint32_t pixels = bench_comp.stats.pixels - before.pixels;
+        uint32_t blended = bench_comp.stats.layer_pixels - before.layer_pixels;
+        uint64_t centi_ns = pixels ? (uint64_t)us * 100000 / pixels : 0;
+        snprintf(line, sizeof(line), "# %s damaged_px=%lu layer_px=%lu ns_px=%lu.%02lu", compose_names[z],
+                 (unsigned long)pixels, (unsigned long)blended, (unsigned long)(centi_ns / 100),
+                 (unsigned long)(centi_ns % 100));
+        emit(config, line);
+    }
+    for (uint8_t z = 0; z < DISPLAY_LAYER_MAX; z++) display_layer_destroy(&bench_comp, z);
+
+    display_clear(DISPLAY_BLACK);
+    snprintf(line, sizeof(line), "# done cases=%lu", (unsigned long)done);
+    emit(config, line);
+    return done;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+//** 显示吞吐基准 / Display Throughput Benchmark
+//**
+//** 设计要点 / Design Notes:
+//** 1. 只用公开绘图接口，每个用例固定调用次数 / Public drawing API only, a fixed call count per case
+//** 2. 总线字节和窗口取自 display_get_stats() 的差值，不清零调用者的统计
+//**    Bus bytes and windows are deltas of display_get_stats(), the caller's statistics are not reset
+//** 3. 时钟和输出由调用者提供 - 设备上是micros()和串口，主机上是真实时钟和stdout
+//**    Clock and output come from the caller - micros() and serial on the device, a real clock and stdout on the host
+//** 4. 输出CSV，第一行是表头，'#'开头的是注释 - 两次结果可以直接diff
+//**    CSV output, the first row is the header, '#' lines are comments - two runs diff directly
+//**
+//** 列 / Columns:
+//**   case,calls,us,ns_call,pixels,mpix_s,bus_bytes,windows,bus_us,bus_mpix_s
+//**   us/mpix_s 是实测墙钟；bus_us/bus_mpix_s 是按SPI时钟算的线上时间 (命令字节也算)
+//**   us/mpix_s are measured wall time; bus_us/bus_mpix_s are wire time at the SPI clock (command bytes included)
+//**   compose_1..4 每行后面的注释给出受损像素数、图层像素数和每个受损像素的纳秒数 (ns_px)
+//**   After each compose_1..4 row a comment gives damaged pixels, layer pixels and nanoseconds per damaged pixel (ns_px)
+//**
+//** 跑完后: 立即模式、字形缓存关闭、图层释放、屏幕清黑
+//** Afterwards: immediate mode, glyph cache off, layers freed, screen cleared to black
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DISPLAY_BENCH_VERSION 1
+#define DISPLAY_BENCH_LINE_MAX 128
+
+typedef uint32_t (*display_bench_clock_fn)(void);
+typedef void (*display_bench_emit_fn)(void* ctx, const char* line);  // 一行，不带换行 / one line, no newline
+
+typedef struct {
+    display_bench_clock_fn now_us;
+    display_bench_emit_fn emit;
+    void* ctx;
+    uint32_t spi_hz;            // 估算线上时间用 / for wire-time estimates
+    uint16_t scale;             // 调用次数倍数，0按1算 / call count multiplier, 0 counts as 1
+} display_bench_config_t;
+
+typedef struct {
+    const char* name;
+    uint32_t calls;
+    uint32_t us;
+    uint32_t windows;
+    uint32_t bytes;
+} display_bench_result_t;
+
+//** 跑全部用例，返回跑完的用例数 / Run every case, returns the number of cases completed
+uint32_t display_bench_run(const display_bench_config_t* config);
+
+//** 一行CSV / One CSV row
+void display_bench_format(const display_bench_result_t* result, uint32_t spi_hz,
+                          char* line, uint32_t line_size);
+
+#ifdef __cplusplus
+}
+#endif
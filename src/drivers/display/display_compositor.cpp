@@ -0,0 +1,211 @@
+//** 图层合成器实现 / Layer Compositor Implementation
+
+#include "display_compositor.h"
+#include <string.h>
+
+static void damage_rect(display_compositor_t* comp, int16_t x, int16_t y, int16_t w, int16_t h) {
+    display_rect_t r = { x, y, w, h };
+    if (display_rect_clip(&r, comp->width, comp->height)) display_dirty_add(&comp->damage, &r);
+}
+
+static void damage_layer(display_compositor_t* comp, const display_layer_t* layer) {
+    if (layer->pixels && layer->visible) damage_rect(comp, layer->x, layer->y, layer->w, layer->h);
+}
+
+static display_layer_t* layer_at(display_compositor_t* comp, uint8_t z) {
+    if (z >= DISPLAY_LAYER_MAX || !comp->layers[z].pixels) return NULL;
+    return &comp->layers[z];
+}
+
+void display_compositor_init(display_compositor_t* comp, int16_t width, int16_t height, uint16_t background) {
+    memset(comp, 0, sizeof(*comp));
+    comp->width = width;
+    comp->height = height;
+    comp->background = background;
+    damage_rect(comp, 0, 0, width, height);
+}
+
+bool display_layer_attach(display_compositor_t* comp, uint8_t z, uint16_t* pixels, uint8_t* alpha,
+                          int16_t x, int16_t y, int16_t w, int16_t h) {
+    if (z >= DISPLAY_LAYER_MAX || !pixels || w <= 0 || h <= 0) return false;
+
+    display_layer_t* layer = &comp->layers[z];
+    damage_layer(comp, layer);
+    layer->pixels = pixels;
+    layer->alpha = alpha;
+    layer->x = x;
+    layer->y = y;
+    layer->w = w;
+    layer->h = h;
+    layer->opacity = DISPLAY_ALPHA_OPAQUE;
+    layer->visible = true;
+    damage_layer(comp, layer);
+    return true;
+}
+
+void display_layer_detach(display_compositor_t* comp, uint8_t z) {
+    display_layer_t* layer = layer_at(comp, z);
+    if (!layer) return;
+    damage_layer(comp, layer);
+    memset(layer, 0, sizeof(*layer));
+}
+
+void display_layer_move(display_compositor_t* comp, uint8_t z, int16_t x, int16_t y) {
+    display_layer_t* layer = layer_at(comp, z);
+    if (!layer || (layer->x == x && layer->y == y)) return;
+    damage_layer(comp, layer);
+    layer->x = x;
+    layer->y = y;
+    damage_layer(comp, layer);
+}
+
+void display_layer_set_opacity(display_compositor_t* comp, uint8_t z, uint8_t opacity) {
+    display_layer_t* layer = layer_at(comp, z);
+    if (!layer || layer->opacity == opacity) return;
+    layer->opacity = opacity;
+    damage_layer(comp, layer);
+}
+
+void display_layer_show(display_compositor_t* comp, uint8_t z, bool visible) {
+    display_layer_t* layer = layer_at(comp, z);
+    if (!layer || layer->visible == visible) return;
+    if (!visible) damage_layer(comp, layer);
+    layer->visible = visible;
+    damage_layer(comp, layer);
+}
+
+void display_layer_fill(display_compositor_t* comp, uint8_t z, int16_t x, int16_t y, int16_t w, int16_t h,
+                        uint16_t color, uint8_t alpha) {
+    display_layer_t* layer = layer_at(comp, z);
+    if (!layer) return;
+
+    display_rect_t r = { x, y, w, h };
+    if (!display_rect_clip(&r, layer->w, layer->h)) return;
+
+    for (int16_t row = r.y; row < r.y + r.h; row++) {
+        uint16_t* p = layer->pixels + (int32_t)row * layer->w + r.x;
+        for (int16_t i = 0; i < r.w; i++) p[i] = color;
+        if (layer->alpha) memset(layer->alpha + (int32_t)row * layer->w + r.x, alpha, r.w);
+    }
+    if (layer->visible) damage_rect(comp, layer->x + r.x, layer->y + r.y, r.w, r.h);
+}
+
+void display_layer_damage(display_compositor_t* comp, uint8_t z, int16_t x, int16_t y, int16_t w, int16_t h) {
+    display_layer_t* layer = layer_at(comp, z);
+    if (!layer || !layer->visible) return;
+
+    display_rect_t r = { x, y, w, h };
+    if (display_rect_clip(&r, layer->w, layer->h)) damage_rect(comp, layer->x + r.x, layer->y + r.y, r.w, r.h);
+}
+
+void display_compositor_damage(display_compositor_t* comp, int16_t x, int16_t y, int16_t w, int16_t h) {
+    damage_rect(comp, x, y, w, h);
+}
+
+//** ========================================
+//** 合成 / Compositing
+//** ========================================
+
+//** a*b/255，四舍五入 / a*b/255, rounded
+static inline uint8_t mul255(uint8_t a, uint8_t b) {
+    uint32_t t = (uint32_t)a * b + 128;
+    return (uint8_t)((t + (t >> 8)) >> 8);
+}
+
+static void blend_row(uint16_t* dst, const uint16_t* src, const uint8_t* alpha, uint8_t opacity, int16_t count) {
+    if (!alpha) {
+        if (opacity == DISPLAY_ALPHA_OPAQUE) {
+            memcpy(dst, src, count * sizeof(uint16_t));
+        } else {
+            for (int16_t i = 0; i < count; i++) dst[i] = display_blend565(dst[i], src[i], opacity);
+        }
+        return;
+    }
+
+    for (int16_t i = 0; i < count; i++) {
+        uint8_t a = opacity == DISPLAY_ALPHA_OPAQUE ? alpha[i] : mul255(alpha[i], opacity);
+        if (a == DISPLAY_ALPHA_OPAQUE) {
+            dst[i] = src[i];
+        } else if (a) {
+            dst[i] = display_blend565(dst[i], src[i], a);
+        }
+    }
+}
+
+static bool layer_covers(const display_layer_t* layer, const display_rect_t* r) {
+    return !layer->alpha && layer->opacity == DISPLAY_ALPHA_OPAQUE &&
+           layer->x <= r->x && layer->y <= r->y &&
+           layer->x + layer->w >= r->x + r->w && layer->y + layer->h >= r->y + r->h;
+}
+
+static bool layer_live(const display_layer_t* layer) {
+    return layer->pixels && layer->visible && layer->opacity;
+}
+
+static void compose_band(display_compositor_t* comp, const display_rect_t* band, uint16_t* out) {
+    //** 从最上面往下找第一个盖住整带的不透明图层 / Find the topmost opaque layer covering the whole band
+    int8_t bottom = -1;
+    for (int8_t z = DISPLAY_LAYER_MAX - 1; z >= 0; z--) {
+        if (layer_live(&comp->layers[z]) && layer_covers(&comp->layers[z], band)) {
+            bottom = z;
+            break;
+        }
+    }
+
+    if (bottom < 0) {
+        uint32_t count = (uint32_t)band->w * band->h;
+        for (uint32_t i = 0; i < count; i++) out[i] = comp->background;
+        bottom = 0;
+    }
+
+    for (uint8_t z = (uint8_t)bottom; z < DISPLAY_LAYER_MAX; z++) {
+        const display_layer_t* layer = &comp->layers[z];
+        if (!layer_live(layer)) continue;
+
+        display_rect_t r = { layer->x, layer->y, layer->w, layer->h };
+        int16_t x0 = r.x > band->x ? r.x : band->x;
+        int16_t y0 = r.y > band->y ? r.y : band->y;
+        int16_t x1 = (r.x + r.w < band->x + band->w) ? r.x + r.w : band->x + band->w;
+        int16_t y1 = (r.y + r.h < band->y + band->h) ? r.y + r.h : band->y + band->h;
+        if (x0 >= x1 || y0 >= y1) continue;
+
+        int16_t n = x1 - x0;
+        for (int16_t y = y0; y < y1; y++) {
+            int32_t src = (int32_t)(y - layer->y) * layer->w + (x0 - layer->x);
+            blend_row(out + (int32_t)(y - band->y) * band->w + (x0 - band->x), layer->pixels + src,
+                      layer->alpha ? layer->alpha + src : NULL, layer->opacity, n);
+        }
+        comp->stats.layer_pixels += (uint32_t)n * (y1 - y0);
+    }
+}
+
+uint32_t display_compositor_render(display_compositor_t* comp, uint16_t* scratch, uint32_t scratch_pixels,
+                                   display_compositor_out_fn out, void* ctx) {
+    if (display_dirty_empty(&comp->damage)) return 0;
+
+    uint32_t half = scratch_pixels / 2;
+    uint16_t* buffers[2] = { scratch, scratch + half };
+    uint8_t slot = 0;
+    uint32_t total = 0;
+
+    for (uint8_t i = 0; i < comp->damage.count; i++) {
+        const display_rect_t* rect = &comp->damage.rects[i];
+        int16_t lines = (int16_t)(half / (uint32_t)rect->w);
+        if (lines <= 0) continue;  // 比屏幕还宽的矩形不会出现 / never happens for rectangles no wider than the screen
+        if (lines > rect->h) lines = rect->h;
+
+        for (int16_t row = 0; row < rect->h; row += lines, slot ^= 1) {
+            display_rect_t band = { rect->x, (int16_t)(rect->y + row), rect->w,
+                                    (int16_t)(rect->h - row < lines ? rect->h - row : lines) };
+            compose_band(comp, &band, buffers[slot]);
+            out(ctx, band.x, band.y, band.w, band.h, buffers[slot]);
+            total += display_rect_area(&band);
+        }
+    }
+
+    comp->stats.frames++;
+    comp->stats.rects += comp->damage.count;
+    comp->stats.pixels += total;
+    display_dirty_clear(&comp->damage);
+    return total;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+//** 图层合成器 - 叠加层不用重画下面的内容 / Layer Compositor - Overlays Without Redrawing What Is Underneath
+//**
+//** 设计要点 / Design Notes:
+//** 1. 固定数量的图层，槽位号就是z序，0在最下面 / A fixed number of layers, the slot number is the z-order, 0 at the bottom
+//** 2. 不负责分配 - 图层像素由调用者提供 (PSRAM) / Does not allocate - layer pixels come from the caller (PSRAM)
+//** 3. 只合成受损区域，输出按带交给回调 / Only damaged regions are composited, output goes to a callback band by band
+//** 4. 8位整数透明度，没有浮点 / 8-bit integer alpha, no floats
+//** 5. 完全盖住受损区域的不透明图层下面的图层直接跳过
+//**    Layers below an opaque layer that fully covers the damaged region are skipped
+//** 6. 纯C数据 - 不依赖Arduino和TFT_eSPI / Plain C data - no Arduino or TFT_eSPI dependency
+
+#include "display_dirty.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DISPLAY_LAYER_MAX 4
+#define DISPLAY_ALPHA_OPAQUE 255
+
+typedef struct {
+    uint16_t* pixels;       // BGR565，步长 = w；NULL表示空槽 / BGR565, stride = w; NULL marks an empty slot
+    uint8_t* alpha;         // 每像素透明度，步长 = w；NULL表示不透明 / per-pixel alpha, stride = w; NULL means opaque
+    int16_t x, y, w, h;     // 屏幕位置 / position on screen
+    uint8_t opacity;        // 整层透明度 / whole-layer alpha
+    bool visible;
+} display_layer_t;
+
+typedef struct {
+    uint32_t frames;        // 有输出的render次数 / renders that produced output
+    uint32_t rects;         // 合成的受损矩形 / damaged rectangles composited
+    uint32_t pixels;        // 输出像素 / pixels output
+    uint32_t layer_pixels;  // 图层像素被拷贝或混合的次数 / layer pixels copied or blended
+} display_compositor_stats_t;
+
+typedef struct {
+    display_layer_t layers[DISPLAY_LAYER_MAX];
+    int16_t width, height;
+    uint16_t background;    // 没有图层的地方 / where no layer covers
+    display_dirty_t damage;
+    display_compositor_stats_t stats;
+} display_compositor_t;
+
+//** 一带合成好的像素，步长 = w / One band of composited pixels, stride = w
+typedef void (*display_compositor_out_fn)(void* ctx, int16_t x, int16_t y, int16_t w, int16_t h,
+                                          const uint16_t* pixels);
+
+//** 8位透明度混合 - alpha为0保留dst，255得到src / 8-bit alpha blend - alpha 0 keeps dst, 255 gives src
+static inline uint16_t display_blend565(uint16_t dst, uint16_t src, uint8_t alpha) {
+    uint32_t a = alpha + (alpha >> 7);  // 0..255 -> 0..256
+    //** 高低5位分量拉开到16位间隔，一次乘法混合两个 / Spread the 5-bit fields 16 bits apart, one multiply blends both
+    uint32_t s_rb = ((src & 0xF800u) << 5) | (src & 0x001Fu);
+    uint32_t d_rb = ((dst & 0xF800u) << 5) | (dst & 0x001Fu);
+    uint32_t rb = (s_rb * a + d_rb * (256 - a) + 0x00800080u) >> 8;  // +半个最低位取整 / + half an LSB to round
+    uint32_t g = ((src & 0x07E0u) * a + (dst & 0x07E0u) * (256 - a) + 0x1000u) >> 8;
+    return (uint16_t)(((rb >> 5) & 0xF800u) | (rb & 0x001Fu) | (g & 0x07E0u));
+}
+
+//** 初始化 - 没有图层，整屏受损 / Init - no layers, the whole screen is damaged
+void display_compositor_init(display_compositor_t* comp, int16_t width, int16_t height, uint16_t background);
+
+//** 把像素放进z槽，覆盖原有图层 / Put pixels into slot z, replacing what was there
+bool display_layer_attach(display_compositor_t* comp, uint8_t z, uint16_t* pixels, uint8_t* alpha,
+                          int16_t x, int16_t y, int16_t w, int16_t h);
+void display_layer_detach(display_compositor_t* comp, uint8_t z);
+
+//** 图层属性 - 改变都会标记受损区域 / Layer properties - every change marks the damage
+void display_layer_move(display_compositor_t* comp, uint8_t z, int16_t x, int16_t y);
+void display_layer_set_opacity(display_compositor_t* comp, uint8_t z, uint8_t opacity);
+void display_layer_show(display_compositor_t* comp, uint8_t z, bool visible);
+
+//** 图层内容 - 坐标相对图层 / Layer content - coordinates are relative to the layer
+void display_layer_fill(display_compositor_t* comp, uint8_t z, int16_t x, int16_t y, int16_t w, int16_t h,
+                        uint16_t color, uint8_t alpha);
+void display_layer_damage(display_compositor_t* comp, uint8_t z, int16_t x, int16_t y, int16_t w, int16_t h);
+
+//** 屏幕区域受损 - 比如改了背景色 / A screen region is damaged - e.g. the background colour changed
+void display_compositor_damage(display_compositor_t* comp, int16_t x, int16_t y, int16_t w, int16_t h);
+
+//** 合成所有受损区域 - scratch分成两半轮流使用，回调返回后上一带才会被覆盖
+//** Composite every damaged region - scratch is split into two halves that alternate, a band is only overwritten
+//** after the following callback has returned
+//** 返回输出的像素数 / Returns the number of pixels output
+uint32_t display_compositor_render(display_compositor_t* comp, uint16_t* scratch, uint32_t scratch_pixels,
+                                   display_compositor_out_fn out, void* ctx);
+
+#ifdef __cplusplus
+}
+#endif
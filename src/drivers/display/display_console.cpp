@@ -0,0 +1,41 @@
+//** 硬件滚动控制台模型实现 / Hardware Scroll Console Model Implementation
+
+#include "display_console.h"
+#include <string.h>
+
+uint16_t display_scroll_map(const display_scroll_regs_t* regs, uint16_t screen_row) {
+    if (screen_row < regs->tfa || screen_row >= regs->tfa + regs->vsa) return screen_row;
+    //** 滚动区从VSP开始，到区尾后绕回区首 / The scroll area starts at VSP and wraps back to its start
+    uint16_t offset = (uint16_t)((screen_row - regs->tfa) + (regs->vsp - regs->tfa));
+    return (uint16_t)(regs->tfa + offset % regs->vsa);
+}
+
+bool display_console_layout(display_console_t* con, int16_t top, int16_t height, int16_t line_h, uint16_t gram_lines) {
+    memset(con, 0, sizeof(*con));
+    if (top < 0 || line_h <= 0 || height < line_h || top + height > gram_lines) return false;
+
+    con->top = top;
+    con->line_h = line_h;
+    con->lines = (uint16_t)(height / line_h);
+    con->regs.tfa = (uint16_t)top;
+    con->regs.vsa = (uint16_t)(con->lines * line_h);
+    con->regs.bfa = (uint16_t)(gram_lines - con->regs.tfa - con->regs.vsa);
+    con->regs.vsp = con->regs.tfa;  // 不滚动 / no scroll
+    return true;
+}
+
+int16_t display_console_push(display_console_t* con, bool* scroll) {
+    //** 还没写满 - 从上往下依次写 / Not full yet - fill from the top down
+    if (con->count < con->lines) {
+        *scroll = false;
+        return display_console_row(con, con->count++);
+    }
+
+    //** 满了 - 最旧的一行就是VSP指向的那行，写它然后往前推
+    //** Full - the oldest line is the one VSP points at, overwrite it and move on
+    *scroll = true;
+    int16_t row = (int16_t)con->regs.vsp;
+    uint16_t next = (uint16_t)(con->regs.vsp - con->regs.tfa + con->line_h);
+    con->regs.vsp = (uint16_t)(con->regs.tfa + next % con->regs.vsa);
+    return row;
+}
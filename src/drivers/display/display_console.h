@@ -0,0 +1,59 @@
+#pragma once
+
+//** 硬件滚动控制台模型 - ST7789垂直滚动寄存器 / Hardware Scroll Console Model - ST7789 Vertical Scroll Registers
+//**
+//** 设计要点 / Design Notes:
+//** 1. VSCRDEF (0x33) 把显存行分成 顶部固定TFA / 滚动区VSA / 底部固定BFA，三者之和 = 显存行数
+//**    VSCRDEF (0x33) splits the frame memory rows into top fixed TFA / scroll area VSA / bottom fixed BFA,
+//**    summing to the frame memory height
+//** 2. VSCRSADD (0x37) 指定滚动区第一行显示哪一行显存 / VSCRSADD (0x37) picks the memory row shown first in the scroll area
+//** 3. 新行写进最旧那一行的显存，再把VSP往前推一行 - 每行只推一行像素加一次寄存器写
+//**    A new line is written over the oldest line's memory, then VSP moves on by one line -
+//**    one line of pixels plus one register write per line
+//** 4. 纯C数据 - 寄存器和行映射在主机上可验证 / Plain C data - registers and row mapping are verifiable on the host
+//**
+//** 只支持不交换行列且行偏移为0的方向: 旋转0和全息模式4 (只镜像列)
+//** Only orientations without row/column exchange and with row offset 0: rotation 0 and holographic mode 4 (columns mirrored only)
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DISPLAY_CMD_VSCRDEF  0x33
+#define DISPLAY_CMD_VSCRSADD 0x37
+
+typedef struct {
+    uint16_t tfa, vsa, bfa;     // VSCRDEF
+    uint16_t vsp;               // VSCRSADD
+} display_scroll_regs_t;
+
+typedef struct {
+    display_scroll_regs_t regs;
+    int16_t top;                // 滚动区第一行 / first row of the scroll area
+    int16_t line_h;
+    uint16_t lines;             // 滚动区能放几行 / lines the scroll area holds
+    uint16_t count;             // 已写的行，最多lines / lines written so far, at most lines
+} display_console_t;
+
+//** 滚动寄存器下屏幕行 -> 显存行 / Screen row -> memory row under the scroll registers
+uint16_t display_scroll_map(const display_scroll_regs_t* regs, uint16_t screen_row);
+
+//** 区域高度向下取整到整行；放不下一行返回false / The height is rounded down to whole lines; false if not even one line fits
+bool display_console_layout(display_console_t* con, int16_t top, int16_t height, int16_t line_h, uint16_t gram_lines);
+
+//** 为新行腾位置 - 返回新行的显存行；*scroll为true时调用者先清这行，再写VSCRSADD = regs.vsp，再画字
+//** Make room for a new line - returns its memory row; when *scroll is true the caller clears the row,
+//** writes VSCRSADD = regs.vsp, then draws the text
+int16_t display_console_push(display_console_t* con, bool* scroll);
+
+//** 第i行可见行 (0在最上面) 在屏幕上的行号 / Screen row of visible line i (0 at the top)
+static inline int16_t display_console_row(const display_console_t* con, uint16_t line) {
+    return (int16_t)(con->top + line * con->line_h);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,131 @@
+//** 脏矩形列表实现 / Dirty Rectangle List Implementation
+//**
+//** 合并规则只有一条 / There is exactly one merge rule:
+//** 合并后多推的像素 <= 省掉一次窗口设置的代价 → 合并
+//** extra pixels pushed by the union <= cost of one saved window → merge
+//** 列表满时的强制合并走同一条路径，没有特殊情况
+//** Forced merging when the list is full takes the same path - no special case
+
+#include "display_dirty.h"
+
+//** ========================================
+//** 矩形辅助函数 / Rectangle Helpers
+//** ========================================
+
+bool display_rect_clip(display_rect_t* rect, int16_t width, int16_t height) {
+    int32_t x0 = rect->x;
+    int32_t y0 = rect->y;
+    int32_t x1 = x0 + rect->w;
+    int32_t y1 = y0 + rect->h;
+
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 > width) x1 = width;
+    if (y1 > height) y1 = height;
+
+    if (x1 <= x0 || y1 <= y0) {
+        rect->w = 0;
+        rect->h = 0;
+        return false;
+    }
+
+    rect->x = (int16_t)x0;
+    rect->y = (int16_t)y0;
+    rect->w = (int16_t)(x1 - x0);
+    rect->h = (int16_t)(y1 - y0);
+    return true;
+}
+
+display_rect_t display_rect_union(const display_rect_t* a, const display_rect_t* b) {
+    int16_t x0 = a->x < b->x ? a->x : b->x;
+    int16_t y0 = a->y < b->y ? a->y : b->y;
+    int16_t x1 = (a->x + a->w) > (b->x + b->w) ? (a->x + a->w) : (b->x + b->w);
+    int16_t y1 = (a->y + a->h) > (b->y + b->h) ? (a->y + a->h) : (b->y + b->h);
+
+    display_rect_t out = { x0, y0, (int16_t)(x1 - x0), (int16_t)(y1 - y0) };
+    return out;
+}
+
+uint32_t display_rect_area(const display_rect_t* rect) {
+    if (rect->w <= 0 || rect->h <= 0) return 0;
+    return (uint32_t)rect->w * (uint32_t)rect->h;
+}
+
+uint32_t display_rect_overlap(const display_rect_t* a, const display_rect_t* b) {
+    int16_t x0 = a->x > b->x ? a->x : b->x;
+    int16_t y0 = a->y > b->y ? a->y : b->y;
+    int16_t x1 = (a->x + a->w) < (b->x + b->w) ? (a->x + a->w) : (b->x + b->w);
+    int16_t y1 = (a->y + a->h) < (b->y + b->h) ? (a->y + a->h) : (b->y + b->h);
+
+    if (x1 <= x0 || y1 <= y0) return 0;
+    return (uint32_t)(x1 - x0) * (uint32_t)(y1 - y0);
+}
+
+//** 合并浪费的像素数 - 并集面积减去两者实际覆盖的面积
+//** Pixels wasted by merging - union area minus the area actually covered
+static uint32_t display_rect_merge_waste(const display_rect_t* a, const display_rect_t* b) {
+    display_rect_t u = display_rect_union(a, b);
+    uint32_t covered = display_rect_area(a) + display_rect_area(b) - display_rect_overlap(a, b);
+    return display_rect_area(&u) - covered;
+}
+
+//** ========================================
+//** 列表操作 / List Operations
+//** ========================================
+
+void display_dirty_clear(display_dirty_t* list) {
+    list->count = 0;
+}
+
+static void display_dirty_remove(display_dirty_t* list, uint8_t index) {
+    list->count--;
+    list->rects[index] = list->rects[list->count];
+}
+
+void display_dirty_add(display_dirty_t* list, const display_rect_t* rect) {
+    if (rect->w <= 0 || rect->h <= 0) return;
+
+    display_rect_t cur = *rect;
+
+    for (;;) {
+        //** 第1步：吸收所有值得合并的矩形 / Step 1: absorb every rect worth merging
+        uint8_t i = 0;
+        while (i < list->count) {
+            if (display_rect_merge_waste(&list->rects[i], &cur) <= DISPLAY_DIRTY_MERGE_SLACK_PX) {
+                cur = display_rect_union(&list->rects[i], &cur);
+                display_dirty_remove(list, i);
+                i = 0;  // 并集变大了，重新扫描 / union grew, rescan
+                continue;
+            }
+            i++;
+        }
+
+        //** 第2步：有空位就放进去 / Step 2: append if there is room
+        if (list->count < DISPLAY_DIRTY_MAX) {
+            list->rects[list->count++] = cur;
+            return;
+        }
+
+        //** 第3步：列表已满 - 取出浪费最小的一个并入，再走一遍
+        //** Step 3: list full - pull in the cheapest neighbour and go round again
+        uint8_t best = 0;
+        uint32_t best_waste = UINT32_MAX;
+        for (i = 0; i < list->count; i++) {
+            uint32_t waste = display_rect_merge_waste(&list->rects[i], &cur);
+            if (waste < best_waste) {
+                best_waste = waste;
+                best = i;
+            }
+        }
+        cur = display_rect_union(&list->rects[best], &cur);
+        display_dirty_remove(list, best);
+    }
+}
+
+uint32_t display_dirty_area(const display_dirty_t* list) {
+    uint32_t area = 0;
+    for (uint8_t i = 0; i < list->count; i++) {
+        area += display_rect_area(&list->rects[i]);
+    }
+    return area;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+//** 脏矩形列表 - 帧缓冲刷新的区域记账 / Dirty Rectangle List - Region Bookkeeping for Framebuffer Flush
+//**
+//** 设计要点 / Design Notes:
+//** 1. 固定容量数组 - 无动态分配 / Fixed-capacity array - no dynamic allocation
+//** 2. 插入时合并 - 刷新时不再做决策 / Merge on insert - flush makes no decisions
+//** 3. 纯C数据 - 不依赖Arduino，可在主机上编译 / Plain C data - no Arduino dependency, host-buildable
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//** 列表容量 - 满了就强制合并代价最小的一对 / Capacity - when full, force-merge the cheapest pair
+#define DISPLAY_DIRTY_MAX 16
+
+//** 合并容忍度 - 一次setAddrWindow大约等于这么多像素的总线时间
+//** Merge slack - one setAddrWindow costs roughly this many pixels of bus time
+#define DISPLAY_DIRTY_MERGE_SLACK_PX 64
+
+typedef struct {
+    int16_t x, y, w, h;
+} display_rect_t;
+
+typedef struct {
+    display_rect_t rects[DISPLAY_DIRTY_MAX];
+    uint8_t count;
+} display_dirty_t;
+
+//** 矩形辅助函数 / Rectangle Helpers
+bool display_rect_clip(display_rect_t* rect, int16_t width, int16_t height);
+display_rect_t display_rect_union(const display_rect_t* a, const display_rect_t* b);
+uint32_t display_rect_area(const display_rect_t* rect);
+uint32_t display_rect_overlap(const display_rect_t* a, const display_rect_t* b);
+
+//** 列表操作 / List Operations
+void display_dirty_clear(display_dirty_t* list);
+void display_dirty_add(display_dirty_t* list, const display_rect_t* rect);
+uint32_t display_dirty_area(const display_dirty_t* list);
+
+static inline bool display_dirty_empty(const display_dirty_t* list) { return list->count == 0; }
+
+#ifdef __cplusplus
+}
+#endif
@@ -10,8 +10,18 @@
 //** 4. 快速失败 - 无隐藏错误处理 / Fail fast - no hidden error handling
 
 #include "display_driver.h"
+#include "display_framebuffer.h"  //** 帧缓冲与脏矩形 / Framebuffer and dirty rectangles
+#include "display_raster.h"       //** 直线光栅化 / Line rasterization
+#include "display_tiles.h"        //** 图块哈希 / Tile hashing
+#include "display_glyphs.h"       //** 字形缓存 / Glyph cache
+#include "display_pixels.h"       //** 像素格式转换 / Pixel format conversion
+#include "display_image.h"        //** 流式图像解码 / Streaming image decode
+#include "display_assets.h"       //** UI资源包 / UI asset pack
+#include "display_compositor.h"   //** 图层合成 / Layer compositing
+#include "display_console.h"      //** 硬件滚动控制台 / Hardware scroll console
 #include "hardware_config.h"  //** 硬件配置常量 / Hardware configuration constants
 #include "../../core/config/app_constants.h"  //** 应用常量 / Application constants
+#include "../../system/serial_out.h"
 #include <Arduino.h>  //** 仅用于PWM函数 / Only for PWM functions
 
 //** ========================================
@@ -47,8 +57,172 @@
 //** Single static TFT display instance - direct instantiation, avoid pointer complexity
 static TFT_eSPI tft_display;
 
-//** Linus原则：移除初始化标志 - 调用者负责正确的调用顺序
-//** Linus principle: Remove initialization flag - caller responsible for correct order
+//** 帧缓冲 - pixels为NULL表示立即模式 / Framebuffer - NULL pixels means immediate mode
+static display_fb_t fb_state = { NULL, HW_DISPLAY_WIDTH, HW_DISPLAY_HEIGHT, { {}, 0 } };
+
+//** 总线统计 / Bus statistics
+static display_stats_t bus_stats;
+
+//** 图块哈希 - 只在帧缓冲模式下起作用 / Tile hashing - only meaningful in framebuffer mode
+static display_tiles_t tile_state;
+static bool tiles_enabled = false;
+
+//** 字形缓存 - atlas为NULL表示文字直接由TFT_eSPI绘制
+//** Glyph cache - NULL atlas means text is drawn by TFT_eSPI directly
+static display_glyph_cache_t glyph_cache;
+
+//** 异步刷新 - 两个带缓冲放在内部SRAM，DMA可直接访问
+//** Async flush - both band buffers in internal SRAM where DMA can reach them
+static uint16_t flush_band[2][HW_DISPLAY_WIDTH * DISPLAY_FLUSH_BAND_LINES];
+static display_flush_engine_t flush_engine;
+static bool dma_ready = false;
+
+//** 在途的一带 - 什么时候开始发、线上要多久；调度器按它定下一次推进，不用轮询
+//** The band in flight - when it started and how long it takes on the wire; the scheduler times the next pump
+//** from it instead of polling
+static uint32_t band_sent_us;
+static uint32_t band_wire_us;
+
+//** 格式转换暂存 - 一次转换若干行 / Conversion scratch - a few lines converted at a time
+#define CONVERT_LINES 8
+static uint16_t convert_lines[HW_DISPLAY_WIDTH * CONVERT_LINES];
+
+//** 图像解码内存池 - 编译时预算就是峰值上限，第一次画图时从PSRAM分配
+//** 只有CPU碰它 - 刷新引擎把带拷进SRAM的flush_band再交给DMA，所以不必占内部SRAM
+//** Image decode pool - the compile-time budget is the peak limit, allocated from PSRAM on the first draw
+//** Only the CPU touches it - the flush engine copies bands into the SRAM flush_band before DMA, so it needn't
+//** live in internal SRAM
+static uint8_t* image_pool = NULL;
+
+static uint8_t* image_pool_get(void) {
+    if (image_pool) return image_pool;
+#ifdef BOARD_HAS_PSRAM
+    image_pool = (uint8_t*)ps_malloc(DISPLAY_IMAGE_BUDGET);
+#endif
+    if (!image_pool) DISPLAY_DEBUG("Image pool allocation failed: %u bytes", (unsigned)DISPLAY_IMAGE_BUDGET);
+    return image_pool;
+}
+
+//** ========================================
+//** TFT输出端 - 默认SPI出口 / TFT Sink - Default SPI Exit
+//** ========================================
+
+static void tft_sink_fill_rect(void* ctx, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    tft_display.fillRect(x, y, w, h, color);
+}
+
+static void tft_sink_push_rect(void* ctx, int16_t x, int16_t y, int16_t w, int16_t h,
+                               const uint16_t* pixels, int16_t stride) {
+    //** 一个地址窗口，逐行推送 - 窗口内地址自动换行
+    //** One address window, pushed row by row - the window wraps addresses itself
+    bool swap = tft_display.getSwapBytes();
+    tft_display.setSwapBytes(true);  // 帧缓冲存本机字节序 / framebuffer holds native byte order
+    tft_display.startWrite();
+    tft_display.setAddrWindow(x, y, w, h);
+    for (int16_t row = 0; row < h; row++) {
+        tft_display.pushPixels(pixels + (int32_t)row * stride, w);
+    }
+    tft_display.endWrite();
+    tft_display.setSwapBytes(swap);
+}
+
+static const display_sink_t tft_sink = { tft_sink_fill_rect, tft_sink_push_rect, NULL };
+static display_sink_t active_sink = tft_sink;
+
+//** ========================================
+//** TFT传输层 - DMA或阻塞推送 / TFT Transport - DMA or Blocking Push
+//** ========================================
+
+static bool tft_transport_swap = false;
+
+static void tft_transport_open(void* ctx) {
+    //** 带缓冲已经是线上字节序，关闭交换 / Band buffers are already in wire order, disable swapping
+    tft_transport_swap = tft_display.getSwapBytes();
+    tft_display.setSwapBytes(false);
+    tft_display.startWrite();
+}
+
+static void tft_transport_window(void* ctx, int16_t x, int16_t y, int16_t w, int16_t h) {
+    tft_display.setAddrWindow(x, y, w, h);
+}
+
+static void tft_transport_send(void* ctx, const uint16_t* wire_pixels, uint32_t count) {
+#if USE_DMA
+    if (dma_ready) {
+        band_sent_us = micros();
+        band_wire_us = (uint32_t)((uint64_t)count * 16 * 1000000 / HW_DISPLAY_SPI_FREQ) + 1;
+        tft_display.pushPixelsDMA((uint16_t*)wire_pixels, count);
+        return;
+    }
+#endif
+    tft_display.pushPixels(wire_pixels, count);
+}
+
+static bool tft_transport_busy(void* ctx) {
+#if USE_DMA
+    if (dma_ready) return tft_display.dmaBusy();
+#endif
+    return false;
+}
+
+static void tft_transport_close(void* ctx) {
+#if USE_DMA
+    if (dma_ready) tft_display.dmaWait();
+#endif
+    tft_display.endWrite();
+    tft_display.setSwapBytes(tft_transport_swap);
+}
+
+static const display_transport_t tft_transport = {
+    tft_transport_open, tft_transport_window, tft_transport_send,
+    tft_transport_busy, tft_transport_close, NULL
+};
+static display_transport_t active_transport = tft_transport;
+
+//** 引擎在第一次使用时绑定带缓冲 / The engine binds its band buffers on first use
+static display_flush_engine_t* flush(void) {
+    if (!flush_engine.transport) {
+        display_flush_engine_init(&flush_engine, &active_transport, flush_band[0], flush_band[1],
+                                  HW_DISPLAY_WIDTH * DISPLAY_FLUSH_BAND_LINES);
+    }
+    return &flush_engine;
+}
+
+//** 统计包装 - 所有像素必经之路 / Counting wrappers - the only road pixels take
+static void sink_fill(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    display_rect_t r = { x, y, w, h };
+    if (!display_rect_clip(&r, tft_display.width(), tft_display.height())) return;
+
+    display_flush_engine_wait(flush());  // 总线只有一条 / there is only one bus
+    bus_stats.windows++;
+    bus_stats.bytes += display_rect_area(&r) * sizeof(uint16_t);
+    active_sink.fill_rect(active_sink.ctx, r.x, r.y, r.w, r.h, color);
+}
+
+static void sink_push(const display_rect_t* r, const uint16_t* pixels, int16_t stride) {
+    display_flush_engine_wait(flush());
+    bus_stats.windows++;
+    bus_stats.bytes += display_rect_area(r) * sizeof(uint16_t);
+    active_sink.push_rect(active_sink.ctx, r->x, r->y, r->w, r->h, pixels, stride);
+}
+
+//** 绘图目标 - 帧缓冲或输出端，二选一 / Draw target - framebuffer or sink, one or the other
+static void target_fill(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    if (fb_state.pixels) {
+        display_fb_fill_rect(&fb_state, x, y, w, h, color);
+    } else {
+        sink_fill(x, y, w, h, color);
+    }
+}
+
+//** 直线拆成矩形段交给绘图目标 / Line split into runs for the draw target
+static void target_run(void* ctx, int16_t x, int16_t y, int16_t w, int16_t h) {
+    target_fill(x, y, w, h, *(const uint16_t*)ctx);
+}
+
+static void target_line(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+    display_raster_line(x0, y0, x1, y1, target_run, &color);
+}
 
 //** ========================================
 //** 核心初始化函数 / Core Initialization Functions
@@ -73,8 +247,11 @@ void display_init_with_params(uint8_t rotation, uint8_t backlight) {
 
     //** 第3步：初始化TFT显示屏 / Step 3: Initialize TFT display
     tft_display.begin();
+#if USE_DMA
+    dma_ready = tft_display.initDMA();
+#endif
 
-    DISPLAY_DEBUG("TFT begin() completed");
+    DISPLAY_DEBUG("TFT begin() completed, DMA=%d", dma_ready);
     DISPLAY_DEBUG("TFT width: %d, height: %d", tft_display.width(), tft_display.height());
 
     //** 第4步：清屏并启用显示 / Step 4: Clear screen and enable display
@@ -101,19 +278,605 @@ void display_init_with_params(uint8_t rotation, uint8_t backlight) {
 //** ========================================
 
 void display_clear(uint16_t color) { 
-    tft_display.fillScreen(color); 
+    target_fill(0, 0, tft_display.width(), tft_display.height(), color);
 }
 
 void display_pixel(int16_t x, int16_t y, uint16_t color) {
-    tft_display.drawPixel(x, y, color);
+    target_fill(x, y, 1, 1, color);
 }
 
 void display_line(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
-    tft_display.drawLine(x0, y0, x1, y1, color);
+    target_line(x0, y0, x1, y1, color);
 }
 
 void display_rect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
-    tft_display.fillRect(x, y, w, h, color);
+    target_fill(x, y, w, h, color);
+}
+
+void display_blit(int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t* pixels) {
+    if (fb_state.pixels) {
+        display_fb_blit(&fb_state, x, y, w, h, pixels, w);
+        return;
+    }
+
+    display_rect_t r = { x, y, w, h };
+    if (!display_rect_clip(&r, tft_display.width(), tft_display.height())) return;
+    sink_push(&r, pixels + (int32_t)(r.y - y) * w + (r.x - x), w);
+}
+
+void display_blit_rgb888(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t* rgb) {
+    display_rect_t r = { x, y, w, h };
+    if (!display_rect_clip(&r, tft_display.width(), tft_display.height())) return;
+
+    //** r.w不超过屏宽，每块至少CONVERT_LINES行 / r.w never exceeds the screen width, so each chunk is at least CONVERT_LINES rows
+    int16_t lines = (int16_t)(sizeof(convert_lines) / sizeof(convert_lines[0]) / r.w);
+    for (int16_t row = 0; row < r.h; row += lines) {
+        int16_t n = (r.h - row < lines) ? (int16_t)(r.h - row) : lines;
+        for (int16_t i = 0; i < n; i++) {
+            const uint8_t* src = rgb + ((int32_t)(r.y - y + row + i) * w + (r.x - x)) * 3;
+            display_px_rgb888_to_bgr565(convert_lines + (int32_t)i * r.w, src, r.w);
+        }
+        display_blit(r.x, r.y + row, r.w, n, convert_lines);
+    }
+}
+
+//** 直接上屏 - 文字由TFT_eSPI光栅化；立即模式和控制台走这里
+//** Straight to the panel - TFT_eSPI rasterizes; immediate mode and the console go this way
+static void text_panel(int16_t x, int16_t y, const char* text, uint8_t font, uint8_t size, uint16_t fg, uint16_t bg) {
+    display_flush_engine_wait(flush());
+    tft_display.setTextFont(font);
+    tft_display.setTextSize(size);
+    tft_display.setTextColor(fg, bg);
+
+    //** 每个字符一个窗口，整个字符格都要推送 / One window per glyph, the whole cell is pushed
+    bus_stats.windows += strlen(text);
+    bus_stats.bytes += (uint32_t)tft_display.textWidth(text) * tft_display.fontHeight() * sizeof(uint16_t);
+    tft_display.drawString(text, x, y);
+}
+
+//** 帧缓冲模式 - 先画进屏内部分大小的精灵，再拷进帧缓冲并标脏；直接上屏的话下次刷新会被旧像素盖掉
+//** Framebuffer mode - drawn into a sprite the size of the on-screen part, then copied into the framebuffer
+//** and marked dirty; drawn straight to the panel it would be painted over by stale pixels on the next flush
+static void text_framebuffer(int16_t x, int16_t y, const char* text, uint8_t font, uint8_t size, uint16_t fg, uint16_t bg) {
+    tft_display.setTextFont(font);
+    tft_display.setTextSize(size);
+    display_rect_t r = { x, y, tft_display.textWidth(text), tft_display.fontHeight() };
+    if (!display_rect_clip(&r, fb_state.width, fb_state.height)) return;
+
+    TFT_eSprite sprite(&tft_display);
+    sprite.setColorDepth(16);
+    if (!sprite.createSprite(r.w, r.h)) {
+        DISPLAY_DEBUG("Text sprite allocation failed: %dx%d", r.w, r.h);
+        return;
+    }
+    sprite.fillSprite(bg);
+    sprite.setTextFont(font);
+    sprite.setTextSize(size);
+    sprite.setTextColor(fg, bg);
+    sprite.drawString(text, x - r.x, y - r.y);
+
+    //** readPixel给本机字节序，借转换暂存每次搬几行 / readPixel gives native order, a few rows at a time go
+    //** through the conversion scratch
+    int16_t lines = (int16_t)(sizeof(convert_lines) / sizeof(convert_lines[0]) / r.w);
+    for (int16_t row = 0; row < r.h; row += lines) {
+        int16_t n = (r.h - row < lines) ? (int16_t)(r.h - row) : lines;
+        for (int16_t i = 0; i < n; i++) {
+            for (int16_t col = 0; col < r.w; col++) {
+                convert_lines[(int32_t)i * r.w + col] = sprite.readPixel(col, row + i);
+            }
+        }
+        display_fb_blit(&fb_state, r.x, r.y + row, r.w, n, convert_lines, r.w);
+    }
+    sprite.deleteSprite();
+}
+
+//** 不经缓存绘制 / Uncached drawing
+static void text_direct(int16_t x, int16_t y, const char* text, uint8_t font, uint8_t size, uint16_t fg, uint16_t bg) {
+    if (fb_state.pixels) {
+        text_framebuffer(x, y, text, font, size, fg, bg);
+    } else {
+        text_panel(x, y, text, font, size, fg, bg);
+    }
+}
+
+void display_text(int16_t x, int16_t y, const char* text, uint8_t font, uint8_t size, uint16_t fg, uint16_t bg) {
+    if (!glyph_cache.atlas) {
+        text_direct(x, y, text, font, size, fg, bg);
+        return;
+    }
+
+    //** 缓存的字形是普通像素块 - 帧缓冲模式下同样进帧缓冲
+    //** Cached glyphs are plain pixel blocks - in framebuffer mode they land in the framebuffer too
+    display_glyph_key_t key = { fg, bg, 0, font, size };
+    for (const char* c = text; *c; c++) {
+        int16_t w, h;
+        key.ch = (uint8_t)*c;
+        const uint16_t* pixels = display_glyph_get(&glyph_cache, &key, &w, &h);
+        if (pixels) {
+            display_blit(x, y, w, h, pixels);
+        } else {
+            char single[2] = { *c, 0 };
+            text_direct(x, y, single, font, size, fg, bg);
+        }
+        x += w;
+    }
+}
+
+//** ========================================
+//** 帧缓冲模式 - 绘图进PSRAM / Framebuffer Mode - Draw into PSRAM
+//** ========================================
+
+bool display_framebuffer_enable(bool enable) {
+    if (enable == (fb_state.pixels != NULL)) return true;
+
+    if (!enable) {
+        //** 先把未推送的内容推出去再释放 / Push what is pending before releasing
+        display_flush();
+        display_flush_engine_wait(flush());
+        free(fb_state.pixels);
+        fb_state.pixels = NULL;
+        DISPLAY_DEBUG("Framebuffer disabled");
+        return true;
+    }
+
+    size_t bytes = (size_t)HW_DISPLAY_WIDTH * HW_DISPLAY_HEIGHT * sizeof(uint16_t);
+#ifdef BOARD_HAS_PSRAM
+    uint16_t* pixels = (uint16_t*)ps_malloc(bytes);
+#else
+    uint16_t* pixels = NULL;  // 没有PSRAM就不占用内部SRAM / no PSRAM, don't eat internal SRAM
+#endif
+    if (!pixels) {
+        DISPLAY_DEBUG("Framebuffer allocation failed: %u bytes", (unsigned)bytes);
+        return false;
+    }
+
+    display_fb_init(&fb_state, pixels, HW_DISPLAY_WIDTH, HW_DISPLAY_HEIGHT);
+    display_tiles_invalidate(&tile_state);
+    DISPLAY_DEBUG("Framebuffer enabled: %u bytes in PSRAM", (unsigned)bytes);
+    return true;
+}
+
+bool display_framebuffer_active(void) {
+    return fb_state.pixels != NULL;
+}
+
+//** 本帧要推送的区域 - 图块模式下先滤掉没变的图块
+//** Regions to push this frame - unchanged tiles filtered out first in tile mode
+static const display_dirty_t* flush_regions(void) {
+    static display_dirty_t changed;
+    if (!tiles_enabled) return &fb_state.dirty;
+
+    display_tiles_filter(&tile_state, &fb_state, &fb_state.dirty, &changed);
+    return &changed;
+}
+
+void display_flush(void) {
+    if (!fb_state.pixels) return;
+
+    bus_stats.flushes++;
+    const display_dirty_t* regions = flush_regions();
+    for (uint8_t i = 0; i < regions->count; i++) {
+        const display_rect_t* r = &regions->rects[i];
+        sink_push(r, display_fb_at(&fb_state, r->x, r->y), fb_state.width);
+    }
+    display_dirty_clear(&fb_state.dirty);
+}
+
+//** ========================================
+//** 图块哈希 / Tile Hashing
+//** ========================================
+
+void display_tiles_enable(bool enable) {
+    if (enable && !tiles_enabled) {
+        display_tiles_init(&tile_state);  // 全部无效 - 第一帧全部发送 / all invalid - first frame sends everything
+    }
+    tiles_enabled = enable;
+}
+
+void display_tile_stats(display_tile_stats_t* last_frame, display_tile_stats_t* total) {
+    if (last_frame) *last_frame = tile_state.last;
+    if (total) *total = tile_state.total;
+}
+
+//** ========================================
+//** 字形缓存 / Glyph Cache
+//** ========================================
+
+static void tft_glyph_measure(void* ctx, uint8_t ch, uint8_t font, uint8_t size, int16_t* w, int16_t* h) {
+    char single[2] = { (char)ch, 0 };
+    tft_display.setTextFont(font);
+    tft_display.setTextSize(size);
+    *w = tft_display.textWidth(single);
+    *h = tft_display.fontHeight();
+}
+
+//** 未命中时才走这里 - 用临时精灵让TFT_eSPI画一次
+//** Only reached on a miss - a temporary sprite lets TFT_eSPI draw it once
+static void tft_glyph_render(void* ctx, const display_glyph_key_t* key, uint16_t* pixels, int16_t w, int16_t h) {
+    char single[2] = { (char)key->ch, 0 };
+    TFT_eSprite glyph(&tft_display);
+    glyph.setColorDepth(16);
+    if (!glyph.createSprite(w, h)) {
+        for (int32_t i = 0; i < (int32_t)w * h; i++) pixels[i] = key->bg;
+        return;
+    }
+
+    glyph.fillSprite(key->bg);
+    glyph.setTextFont(key->font);
+    glyph.setTextSize(key->size);
+    glyph.setTextColor(key->fg, key->bg);
+    glyph.drawString(single, 0, 0);
+
+    //** readPixel返回本机字节序 / readPixel returns native byte order
+    for (int16_t row = 0; row < h; row++) {
+        for (int16_t col = 0; col < w; col++) {
+            pixels[(int32_t)row * w + col] = glyph.readPixel(col, row);
+        }
+    }
+    glyph.deleteSprite();
+}
+
+static const display_glyph_source_t tft_glyph_source = { tft_glyph_measure, tft_glyph_render, NULL };
+
+bool display_glyph_cache_enable(uint32_t budget_bytes) {
+    if (glyph_cache.atlas) {
+        free(glyph_cache.atlas);
+        glyph_cache.atlas = NULL;
+        DISPLAY_DEBUG("Glyph cache disabled");
+    }
+    if (budget_bytes == 0) return true;
+
+#ifdef BOARD_HAS_PSRAM
+    uint8_t* atlas = (uint8_t*)ps_malloc(budget_bytes);
+#else
+    uint8_t* atlas = NULL;  // 没有PSRAM就不占用内部SRAM / no PSRAM, don't eat internal SRAM
+#endif
+    if (!atlas) {
+        DISPLAY_DEBUG("Glyph atlas allocation failed: %u bytes", (unsigned)budget_bytes);
+        return false;
+    }
+
+    display_glyph_cache_init(&glyph_cache, atlas, budget_bytes, &tft_glyph_source);
+    DISPLAY_DEBUG("Glyph cache enabled: %u bytes in PSRAM", (unsigned)budget_bytes);
+    return true;
+}
+
+const display_glyph_stats_t* display_glyph_stats(void) {
+    return &glyph_cache.stats;
+}
+
+//** ========================================
+//** 流式图像 / Streaming Images
+//** ========================================
+
+//** 每次读文件前推进一下DMA，上一带在读下一块时发送
+//** Advance the DMA before every file read, so the previous band goes out while the next chunk is read
+static int32_t image_read(void* ctx, uint8_t* buf, uint32_t len) {
+    const display_image_reader_t* inner = (const display_image_reader_t*)ctx;
+    display_flush_poll();
+    return inner->read(inner->ctx, buf, len);
+}
+
+//** 解好的一带 - 帧缓冲模式进帧缓冲，否则交给异步引擎
+//** A decoded band - into the framebuffer in framebuffer mode, otherwise to the async engine
+static void image_band(void* ctx, int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t* pixels) {
+    if (fb_state.pixels) {
+        display_blit(x, y, w, h, pixels);
+        return;
+    }
+
+    display_dirty_t band;
+    display_dirty_clear(&band);
+    band.rects[0].x = x;
+    band.rects[0].y = y;
+    band.rects[0].w = w;
+    band.rects[0].h = h;
+    if (!display_rect_clip(&band.rects[0], tft_display.width(), tft_display.height())) return;
+    band.count = 1;
+
+    //** 解码器有两个带缓冲 - 提交会先等上一带发完，它的缓冲才会被重用
+    //** The decoder has two band buffers - submitting waits for the previous band, only then is its buffer reused
+    bus_stats.windows++;
+    bus_stats.bytes += display_rect_area(&band.rects[0]) * sizeof(uint16_t);
+    display_flush_engine_submit_at(flush(), pixels, w, x, y, &band);
+}
+
+display_image_result_t display_image_draw(const display_image_reader_t* reader, int16_t x, int16_t y,
+                                          display_image_stats_t* stats) {
+    uint8_t* pool = image_pool_get();
+    if (!pool) return DISPLAY_IMAGE_ERR_MEMORY;
+
+    display_image_reader_t polled = { image_read, (void*)reader };
+    display_image_result_t result = display_image_decode(&polled, pool, DISPLAY_IMAGE_BUDGET,
+                                                         x, y, image_band, NULL, stats);
+    display_flush_engine_wait(flush());  // 池在下次解码时重用 / the pool is reused by the next decode
+
+    DISPLAY_DEBUG("Image decode: %s", display_image_result_name(result));
+    return result;
+}
+
+//** ========================================
+//** UI资源包 / UI Asset Pack
+//** ========================================
+
+bool display_asset_draw(const display_assets_t* pack, const char* name, int16_t x, int16_t y) {
+    if (!pack) return false;  // 包没挂载 / pack not mounted
+    const display_asset_entry_t* entry = display_assets_find(pack, name);
+    if (!entry) {
+        DISPLAY_DEBUG("Asset not found: %s", name);
+        return false;
+    }
+
+    //** 比屏幕大的资源不画 - 宽度超过32767会变负数，带行数会算成0而死循环
+    //** Assets larger than the screen are not drawn - widths above 32767 go negative and the band line count
+    //** would come out as 0 and loop forever
+    if (entry->width > HW_DISPLAY_WIDTH || entry->height > HW_DISPLAY_HEIGHT) {
+        DISPLAY_DEBUG("Asset too large: %s (%ux%u)", name, (unsigned)entry->width, (unsigned)entry->height);
+        return false;
+    }
+
+    display_asset_decoder_t dec;
+    display_asset_decoder_init(&dec, pack, entry);
+    int16_t w = (int16_t)entry->width;
+    int16_t h = (int16_t)entry->height;
+
+    //** 帧缓冲模式且完全在屏内 - 直接解到帧缓冲的行里
+    //** Framebuffer mode and fully on screen - decode straight into the framebuffer rows
+    if (fb_state.pixels && x >= 0 && y >= 0 && x + w <= fb_state.width && y + h <= fb_state.height) {
+        for (int16_t row = 0; row < h && !dec.error; row++) {
+            display_asset_decode(&dec, display_fb_at(&fb_state, x, (int16_t)(y + row)), (uint32_t)w);
+        }
+        display_fb_invalidate(&fb_state, x, y, w, h);
+        return !dec.error;
+    }
+
+    //** 否则按带解码，借用图像池做两个带缓冲，和流式图像走同一条输出路径
+    //** Otherwise decode in bands, borrowing the image pool as two band buffers, and share the streaming image output path
+    uint8_t* pool = image_pool_get();
+    if (!pool) return false;
+    uint16_t* band[2] = { (uint16_t*)pool, (uint16_t*)(pool + DISPLAY_IMAGE_BUDGET / 2) };
+    int16_t lines = (int16_t)(DISPLAY_IMAGE_BUDGET / 2 / sizeof(uint16_t) / (w ? w : 1));
+    if (lines > h) lines = h;
+    if (lines <= 0) return h == 0;
+
+    uint8_t slot = 0;
+    for (int16_t row = 0; row < h; row += lines, slot ^= 1) {
+        int16_t n = (h - row < lines) ? (int16_t)(h - row) : lines;
+        uint32_t count = (uint32_t)w * n;
+        if (display_asset_decode(&dec, band[slot], count) != count) break;
+        image_band(NULL, x, (int16_t)(y + row), w, n, band[slot]);
+    }
+    display_flush_engine_wait(flush());  // 带缓冲在池里 / the band buffers live in the pool
+
+    if (dec.error) DISPLAY_DEBUG("Asset corrupt: %s", name);
+    return !dec.error;
+}
+
+//** ========================================
+//** 图层合成 / Layer Compositing
+//** ========================================
+
+bool display_layer_create(display_compositor_t* comp, uint8_t z, int16_t x, int16_t y, int16_t w, int16_t h,
+                          bool with_alpha) {
+    if (z >= DISPLAY_LAYER_MAX || w <= 0 || h <= 0) return false;
+    display_layer_destroy(comp, z);
+
+    //** 像素和透明度放在同一块PSRAM里 / Pixels and alpha share one PSRAM block
+    size_t count = (size_t)w * h;
+    size_t bytes = count * sizeof(uint16_t) + (with_alpha ? count : 0);
+#ifdef BOARD_HAS_PSRAM
+    uint8_t* block = (uint8_t*)ps_malloc(bytes);
+#else
+    uint8_t* block = NULL;  // 没有PSRAM就不占用内部SRAM / no PSRAM, don't eat internal SRAM
+#endif
+    if (!block) {
+        DISPLAY_DEBUG("Layer allocation failed: %u bytes", (unsigned)bytes);
+        return false;
+    }
+
+    uint8_t* alpha = with_alpha ? block + count * sizeof(uint16_t) : NULL;
+    if (alpha) memset(alpha, 0, count);  // 新图层完全透明 / a new layer starts fully transparent
+    display_layer_attach(comp, z, (uint16_t*)block, alpha, x, y, w, h);
+    DISPLAY_DEBUG("Layer %u: %dx%d, %u bytes in PSRAM", z, w, h, (unsigned)bytes);
+    return true;
+}
+
+void display_layer_destroy(display_compositor_t* comp, uint8_t z) {
+    if (z >= DISPLAY_LAYER_MAX || !comp->layers[z].pixels) return;
+    uint16_t* block = comp->layers[z].pixels;
+    display_layer_detach(comp, z);
+    free(block);
+}
+
+void display_compose(display_compositor_t* comp) {
+    //** 借用图像池做两个带缓冲，和流式图像走同一条输出路径
+    //** Borrow the image pool as two band buffers and share the streaming image output path
+    uint8_t* pool = image_pool_get();
+    if (!pool) return;
+    display_compositor_render(comp, (uint16_t*)pool, DISPLAY_IMAGE_BUDGET / sizeof(uint16_t), image_band, NULL);
+    display_flush_engine_wait(flush());  // 带缓冲在池里 / the band buffers live in the pool
+}
+
+//** ========================================
+//** 硬件滚动控制台 / Hardware Scroll Console
+//** ========================================
+
+static display_console_t console;
+static bool console_active = false;
+static int16_t console_height;
+static uint8_t console_font, console_size;
+static uint16_t console_fg, console_bg;
+
+static void scroll_write(uint8_t cmd, const uint16_t* values, uint8_t count) {
+    display_flush_engine_wait(flush());  // 总线只有一条 / there is only one bus
+    tft_display.writecommand(cmd);
+    for (uint8_t i = 0; i < count; i++) {
+        tft_display.writedata((uint8_t)(values[i] >> 8));
+        tft_display.writedata((uint8_t)values[i]);
+    }
+}
+
+static void scroll_define(const display_scroll_regs_t* regs) {
+    const uint16_t area[3] = { regs->tfa, regs->vsa, regs->bfa };
+    scroll_write(DISPLAY_CMD_VSCRDEF, area, 3);
+    scroll_write(DISPLAY_CMD_VSCRSADD, &regs->vsp, 1);
+}
+
+//** 滚动沿显存行方向，只有行不交换、行偏移为0的方向才是屏幕上的上下
+//** Scrolling runs along memory rows, which are screen rows only without row/column exchange and with row offset 0
+static bool console_rotation_ok(uint8_t rotation) {
+    return rotation == 0 || rotation == 4;
+}
+
+bool display_console_begin(int16_t top, int16_t height, uint8_t font, uint8_t size, uint16_t fg, uint16_t bg) {
+    display_console_end();
+    if (!console_rotation_ok(tft_display.getRotation())) {
+        DISPLAY_DEBUG("Console needs rotation 0 or 4, not %d", tft_display.getRotation());
+        return false;
+    }
+
+    tft_display.setTextSize(size);
+    int16_t line_h = tft_display.fontHeight(font);
+    if (!display_console_layout(&console, top, height, line_h, HW_DISPLAY_GRAM_HEIGHT) ||
+        top + height > tft_display.height()) {
+        DISPLAY_DEBUG("Console area does not fit: top=%d height=%d line=%d", top, height, line_h);
+        return false;
+    }
+
+    console_active = true;
+    console_height = height;
+    console_font = font;
+    console_size = size;
+    console_fg = fg;
+    console_bg = bg;
+
+    scroll_define(&console.regs);
+    sink_fill(0, top, tft_display.width(), (int16_t)console.regs.vsa, bg);
+    DISPLAY_DEBUG("Console: %u lines of %d px at y=%d", console.lines, line_h, top);
+    return true;
+}
+
+void display_console_print(const char* text) {
+    if (!console_active) return;
+
+    //** 写满后: 清掉最旧的一行 -> 滚一行 -> 在底部画新行
+    //** Once full: clear the oldest line -> scroll by one line -> draw the new line at the bottom
+    bool scroll;
+    int16_t row = display_console_push(&console, &scroll);
+    sink_fill(0, row, tft_display.width(), console.line_h, console_bg);
+    if (scroll) scroll_write(DISPLAY_CMD_VSCRSADD, &console.regs.vsp, 1);
+    text_panel(0, row, text, console_font, console_size, console_fg, console_bg);
+}
+
+void display_console_end(void) {
+    if (!console_active) return;
+    console_active = false;
+
+    //** 恢复不滚动，显存行的顺序又是屏幕顺序 - 控制台区域的内容作废
+    //** Back to no scrolling, memory rows are in screen order again - the console area content is stale
+    const display_scroll_regs_t identity = { 0, HW_DISPLAY_GRAM_HEIGHT, 0, 0 };
+    scroll_define(&identity);
+    sink_fill(0, console.top, tft_display.width(), (int16_t)console.regs.vsa, console_bg);
+    if (fb_state.pixels) display_fb_invalidate(&fb_state, 0, console.top, fb_state.width, (int16_t)console.regs.vsa);
+}
+
+bool display_console_active(void) {
+    return console_active;
+}
+
+//** ========================================
+//** 异步刷新 / Async Flush
+//** ========================================
+
+display_fence_t display_flush_async(void) {
+    static const display_dirty_t nothing = { {}, 0 };
+    if (!fb_state.pixels) {
+        return display_flush_engine_submit(flush(), NULL, 0, &nothing);
+    }
+
+    //** 窗口和字节数在提交时就已确定 / Windows and bytes are known at submit time
+    const display_dirty_t* regions = flush_regions();
+    bus_stats.flushes++;
+    bus_stats.windows += regions->count;
+    bus_stats.bytes += display_dirty_area(regions) * sizeof(uint16_t);
+
+    display_fence_t fence = display_flush_engine_submit(flush(), fb_state.pixels, fb_state.width, regions);
+    display_dirty_clear(&fb_state.dirty);
+    return fence;
+}
+
+void display_flush_poll(void) {
+    display_flush_engine_poll(flush());
+}
+
+uint32_t display_flush_wait_us(void) {
+    if (display_flush_engine_idle(flush())) return 0;
+    uint32_t elapsed = micros() - band_sent_us;
+    //** 比线上时间慢 (总线上还有别人，或传输层不是TFT) - 再等八分之一带
+    //** Slower than the wire time (someone else on the bus, or not the TFT transport) - wait an eighth of a band more
+    if (elapsed >= band_wire_us) return band_wire_us / 8 + 1;
+    return band_wire_us - elapsed;
+}
+
+bool display_fence_reached(display_fence_t fence) {
+    return display_flush_engine_reached(flush(), fence);
+}
+
+void display_fence_wait(display_fence_t fence) {
+    while (!display_flush_engine_reached(flush(), fence)) {
+        display_flush_engine_poll(&flush_engine);
+    }
+}
+
+void display_set_flush_callback(display_flush_done_t callback, void* ctx) {
+    flush()->on_done = callback;
+    flush_engine.on_done_ctx = ctx;
+}
+
+void display_set_transport(const display_transport_t* transport) {
+    display_flush_engine_wait(flush());
+    active_transport = transport ? *transport : tft_transport;
+}
+
+//** ========================================
+//** 显示列表回放目标 / Display List Playback Target
+//** ========================================
+
+static void list_target_fill(void* ctx, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    display_rect(x, y, w, h, color);
+}
+
+static void list_target_blit(void* ctx, int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t* pixels) {
+    display_blit(x, y, w, h, pixels);
+}
+
+static void list_target_text(void* ctx, int16_t x, int16_t y, const char* text, uint8_t font, uint8_t size,
+                             uint16_t fg, uint16_t bg) {
+    display_text(x, y, text, font, size, fg, bg);
+}
+
+static const display_list_target_t driver_list_target = {
+    list_target_fill, list_target_blit, list_target_text, NULL
+};
+
+const display_list_target_t* display_list_target(void) {
+    return &driver_list_target;
+}
+
+//** ========================================
+//** 输出端与统计 / Sink and Statistics
+//** ========================================
+
+void display_set_sink(const display_sink_t* sink) {
+    active_sink = sink ? *sink : tft_sink;
+}
+
+const display_stats_t* display_get_stats(void) {
+    return &bus_stats;
+}
+
+void display_reset_stats(void) {
+    memset(&bus_stats, 0, sizeof(bus_stats));
 }
 
 //** ========================================
@@ -136,7 +899,22 @@ void display_backlight(float duty) {
 }
 
 void display_rotation(uint8_t rotation) {
+    //** 控制台在新方向上重新开始 (比如0和全息模式4之间切换)，不支持的方向就关掉
+    //** The console restarts in the new orientation (e.g. switching between 0 and holographic mode 4),
+    //** unsupported orientations close it
+    bool console_restart = console_active;
+    display_console_end();
+
     tft_display.setRotation(rotation);
+    if (console_restart && console_rotation_ok(rotation)) {
+        display_console_begin(console.top, console_height, console_font, console_size, console_fg, console_bg);
+    }
+
+    //** 方向变了，面板上的内容全部作废 / Orientation changed, everything on the panel is stale
+    if (fb_state.pixels) {
+        display_fb_invalidate(&fb_state, 0, 0, fb_state.width, fb_state.height);
+        display_tiles_invalidate(&tile_state);
+    }
     DISPLAY_DEBUG("Rotation set: %d", rotation);
 }
 
@@ -170,23 +948,23 @@ TFT_eSPI* display_tft(void) {
 
 void display_debug_config(void) {
 #ifdef DEBUG_DISPLAY
-    Serial.println("=== Display Driver Configuration ===");
-    Serial.printf("Hardware Config (from TFT_eSPI setup):\n");
-    Serial.printf("  MISO=%d, MOSI=%d, SCLK=%d, CS=%d\n", 
+    serial_out.println("=== Display Driver Configuration ===");
+    serial_out.printf("Hardware Config (from TFT_eSPI setup):\n");
+    serial_out.printf("  MISO=%d, MOSI=%d, SCLK=%d, CS=%d\n", 
                   TFT_MISO, TFT_MOSI, TFT_SCLK, TFT_CS);
-    Serial.printf("  DC=%d, RST=%d, BL=%d\n", 
+    serial_out.printf("  DC=%d, RST=%d, BL=%d\n", 
                   TFT_DC, TFT_RST, TFT_BL);
-    Serial.printf("  SPI Freq=%d Hz\n", SPI_FREQUENCY);
+    serial_out.printf("  SPI Freq=%d Hz\n", SPI_FREQUENCY);
 
-    Serial.printf("Runtime Status:\n");
+    serial_out.printf("Runtime Status:\n");
     //** Linus原则：移除初始化检查，调用者负责正确顺序
-    Serial.printf("  Current Size: %dx%d\n", tft_display.width(), tft_display.height());
-    Serial.printf("  Current Rotation: %d\n", tft_display.getRotation());
+    serial_out.printf("  Current Size: %dx%d\n", tft_display.width(), tft_display.height());
+    serial_out.printf("  Current Rotation: %d\n", tft_display.getRotation());
 
-    Serial.printf("PWM Config:\n");
-    Serial.printf("  Channel=%d, Freq=%d Hz, Resolution=%d bits\n",
+    serial_out.printf("PWM Config:\n");
+    serial_out.printf("  Channel=%d, Freq=%d Hz, Resolution=%d bits\n",
                   HW_DISPLAY_PWM_CHANNEL, HW_DISPLAY_PWM_FREQUENCY, HW_DISPLAY_PWM_RESOLUTION);
-    Serial.println("=====================================");
+    serial_out.println("=====================================");
 #else
     //** 在非调试模式下什么都不做 / Do nothing in non-debug mode
 #endif
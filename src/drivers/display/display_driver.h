@@ -12,7 +12,16 @@
 //** 4. 快速失败 - 无隐藏错误 / Fail fast - no hidden errors
 //** 5. 清洁依赖 - hardware_config.h + TFT_eSPI.h / Clean dependencies - hardware_config.h + TFT_eSPI.h
 
+#include "display_flush.h"
+#include "display_glyphs.h"
+#include "display_image.h"
+#include "display_assets.h"
+#include "display_compositor.h"
+#include "display_console.h"
+#include "display_list.h"
+#include "display_tiles.h"
 #include "hardware_config.h"
+#include "../../system/serial_out.h"
 #include <TFT_eSPI.h>
 #include <stdbool.h>
 #include <stdint.h>
@@ -34,6 +43,9 @@ void display_clear(uint16_t color);
 void display_pixel(int16_t x, int16_t y, uint16_t color);
 void display_line(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
 void display_rect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+void display_blit(int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t* pixels);  // 本机字节序 / native byte order
+void display_blit_rgb888(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t* rgb);  // r,g,b字节，转成BGR565 / r,g,b bytes, converted to BGR565
+void display_text(int16_t x, int16_t y, const char* text, uint8_t font, uint8_t size, uint16_t fg, uint16_t bg);
 
 //** 配置函数 / Configuration Functions
 void display_backlight(float duty);
@@ -45,8 +57,157 @@ int16_t display_height(void);
 uint8_t display_get_rotation(void);
 
 //** 直接TFT访问 - 高级用法 / Direct TFT Access - Advanced Usage
+//** 注意：帧缓冲模式下直接TFT绘图会绕过帧缓冲 / Note: direct TFT drawing bypasses the framebuffer
 TFT_eSPI* display_tft(void);
 
+//** ========================================
+//** 帧缓冲模式 / Framebuffer Mode
+//** ========================================
+//**
+//** 启用后绘图只写PSRAM，display_flush() 只推送合并后的脏矩形
+//** When enabled, drawing only writes PSRAM; display_flush() pushes merged dirty rectangles only
+//** 启用时帧缓冲清为黑色，调用者负责重绘整屏 / Enabling clears the buffer to black, caller redraws
+
+bool display_framebuffer_enable(bool enable);   // PSRAM分配失败返回false / false if PSRAM allocation fails
+bool display_framebuffer_active(void);
+void display_flush(void);                       // 立即模式下为空操作 / no-op in immediate mode
+
+//** ========================================
+//** 图块哈希 - 整屏重绘只发送变化的16x16图块 / Tile Hashing - Full Redraws Send Only Changed 16x16 Tiles
+//** ========================================
+//**
+//** 作用于 display_flush() 和 display_flush_async()，需要帧缓冲模式
+//** Applies to display_flush() and display_flush_async(), requires framebuffer mode
+
+void display_tiles_enable(bool enable);
+void display_tile_stats(display_tile_stats_t* last_frame, display_tile_stats_t* total);  // 均可为NULL / either may be NULL
+
+//** ========================================
+//** 字形缓存 - display_text() 每个字形只光栅化一次 / Glyph Cache - display_text() Rasterizes Each Glyph Once
+//** ========================================
+//**
+//** 预算就是PSRAM图集的字节数，超出按LRU淘汰；0关闭缓存
+//** The budget is the PSRAM atlas size in bytes, LRU eviction beyond it; 0 disables the cache
+//** 帧缓冲模式下文字总是进帧缓冲，缓存省掉的是每次的光栅化 / In framebuffer mode text always goes into the
+//** framebuffer, the cache saves rasterizing it every time
+
+bool display_glyph_cache_enable(uint32_t budget_bytes);  // PSRAM分配失败返回false / false if PSRAM allocation fails
+const display_glyph_stats_t* display_glyph_stats(void);
+
+//** ========================================
+//** 流式图像 - JPEG/PNG边读边解边显示 / Streaming Images - JPEG/PNG Read, Decoded and Shown Band by Band
+//** ========================================
+//**
+//** 峰值内存是 DISPLAY_IMAGE_BUDGET 字节的池，第一次画图时从PSRAM分配，没有PSRAM返回ERR_MEMORY
+//** Peak memory is a pool of DISPLAY_IMAGE_BUDGET bytes, allocated from PSRAM on the first draw; without PSRAM
+//** draws return ERR_MEMORY
+//** 文件读取见 display_image_fs.h / For reading files see display_image_fs.h
+
+display_image_result_t display_image_draw(const display_image_reader_t* reader, int16_t x, int16_t y,
+                                          display_image_stats_t* stats);  // stats可为NULL / stats may be NULL
+
+//** ========================================
+//** UI资源包 - 从映射的Flash分区解压显示 / UI Asset Pack - Decompressed from a Mapped Flash Partition
+//** ========================================
+//**
+//** 分区挂载见 display_assets_flash.h / For mounting the partition see display_assets_flash.h
+
+//** 找不到名字或数据损坏时返回false / Returns false for an unknown name or corrupt data
+bool display_asset_draw(const display_assets_t* pack, const char* name, int16_t x, int16_t y);
+
+//** ========================================
+//** 图层合成 - 叠加层合成后走刷新路径 / Layer Compositing - Overlays Composited into the Flush Path
+//** ========================================
+//**
+//** 合成器拥有它的受损区域 - 那里直接画的内容下次合成会被盖掉
+//** The compositor owns its damaged regions - anything drawn there directly is covered by the next compose
+//** 帧缓冲模式下输出进帧缓冲，之后照常 display_flush()
+//** In framebuffer mode the output lands in the framebuffer, then display_flush() as usual
+
+//** 在PSRAM里分配图层放进z槽 - with_alpha时带每像素透明度，初始全透明
+//** Allocate a layer in PSRAM into slot z - with_alpha adds per-pixel alpha, initially fully transparent
+bool display_layer_create(display_compositor_t* comp, uint8_t z, int16_t x, int16_t y, int16_t w, int16_t h,
+                          bool with_alpha);
+void display_layer_destroy(display_compositor_t* comp, uint8_t z);
+
+//** 合成受损区域并输出 / Composite the damaged regions and send them out
+void display_compose(display_compositor_t* comp);
+
+//** ========================================
+//** 硬件滚动控制台 - 新行只推一行像素 / Hardware Scroll Console - a New Line Pushes One Line of Pixels
+//** ========================================
+//**
+//** 用ST7789的VSCRDEF/VSCRSADD滚动 [top, top+height) 区域，只支持旋转0和全息模式4
+//** Scrolls [top, top+height) with the ST7789 VSCRDEF/VSCRSADD commands, rotation 0 and holographic mode 4 only
+//** 控制台直接画到面板上，区域归控制台所有 - 不要在那里经帧缓冲绘图
+//** The console draws straight to the panel and owns its area - don't draw there through the framebuffer
+
+bool display_console_begin(int16_t top, int16_t height, uint8_t font, uint8_t size, uint16_t fg, uint16_t bg);
+void display_console_print(const char* text);  // 一行，不换行 / one line, no wrapping
+void display_console_end(void);                 // 恢复不滚动 / back to no scrolling
+bool display_console_active(void);
+
+//** ========================================
+//** 异步刷新 - DMA乒乓流水线 / Async Flush - DMA Ping-Pong Pipeline
+//** ========================================
+//**
+//** display_flush_async() 只启动第一带就返回，剩下的由 display_flush_poll() 推进
+//** display_flush_async() starts the first band and returns; display_flush_poll() drives the rest
+//** 完成后栅栏到达，回调(如果设置了)在poll中调用 / On completion the fence is reached and the callback runs from poll
+//** display_flush_wait_us() 是在途一带按SPI时钟算的剩余线上时间，空闲返回0 - 到点再poll，不用固定间隔轮询
+//** display_flush_wait_us() is the wire time left for the band in flight at the SPI clock, 0 when idle - poll then
+//** instead of at a fixed interval
+//** 同步绘图路径会先等待进行中的异步刷新 / The synchronous drawing path waits for an in-flight async flush first
+
+display_fence_t display_flush_async(void);
+void display_flush_poll(void);
+uint32_t display_flush_wait_us(void);
+bool display_fence_reached(display_fence_t fence);
+void display_fence_wait(display_fence_t fence);
+void display_set_flush_callback(display_flush_done_t callback, void* ctx);
+void display_set_transport(const display_transport_t* transport);  // NULL恢复TFT传输层 / NULL restores TFT transport
+
+//** ========================================
+//** 显示列表回放目标 / Display List Playback Target
+//** ========================================
+//**
+//** 用法 / Usage:
+//**   static uint8_t arena[2048];
+//**   display_list_init(&list, arena, sizeof(arena), display_list_target());
+//**   display_list_begin(&list); ... display_list_end(&list);
+
+const display_list_target_t* display_list_target(void);
+
+//** ========================================
+//** 像素输出端 - 可替换的SPI出口 / Pixel Sink - Replaceable SPI Exit
+//** ========================================
+//**
+//** 所有像素最终都经过这两个函数 / Every pixel ends up going through these two functions
+//** 默认输出端是TFT_eSPI；主机构建可换成内存实现来统计字节
+//** Default sink is TFT_eSPI; a host build can swap in a memory sink to count bytes
+
+typedef struct {
+    void (*fill_rect)(void* ctx, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    void (*push_rect)(void* ctx, int16_t x, int16_t y, int16_t w, int16_t h,
+                      const uint16_t* pixels, int16_t stride);
+    void* ctx;
+} display_sink_t;
+
+void display_set_sink(const display_sink_t* sink);  // NULL恢复TFT输出端 / NULL restores the TFT sink
+
+//** ========================================
+//** 总线统计 / Bus Statistics
+//** ========================================
+
+typedef struct {
+    uint32_t windows;   // 地址窗口次数 / address windows opened
+    uint32_t bytes;     // 推送的像素字节 / pixel bytes pushed
+    uint32_t flushes;   // 刷新次数(同步+异步) / flushes, sync and async
+} display_stats_t;
+
+const display_stats_t* display_get_stats(void);
+void display_reset_stats(void);
+
 //** 调试函数 / Debug Functions
 void display_debug_config(void);
 
@@ -129,7 +290,7 @@ static inline int16_t display_center_y(void) { return display_height() / 2; }
 //** ========================================
 
 #ifdef DEBUG_DISPLAY
-#define DISPLAY_DEBUG(fmt, ...) Serial.printf("[DISPLAY] " fmt "\n", ##__VA_ARGS__)
+#define DISPLAY_DEBUG(fmt, ...) serial_out.printf("[DISPLAY] " fmt "\n", ##__VA_ARGS__)
 #else
 #define DISPLAY_DEBUG(fmt, ...) ((void)0)
 #endif
@@ -0,0 +1,142 @@
+//** 假SPI总线实现 / Fake SPI Bus Implementation
+
+#include "display_fake_spi.h"
+#include <string.h>
+
+static void fake_window(display_fake_spi_t* spi, uint32_t pixels) {
+    spi->windows++;
+    spi->bytes += (uint64_t)pixels * sizeof(uint16_t);
+    spi->cycles += display_spi_cycles((uint64_t)pixels * sizeof(uint16_t), 1);
+}
+
+//** 内存面板上的一个像素 - 面板外的丢掉，和真面板一样 / One pixel on the in-memory panel - off-panel ones are
+//** dropped, as on the real panel
+static void panel_put(display_fake_spi_t* spi, int32_t x, int32_t y, uint16_t color) {
+    if (x < 0 || y < 0 || x >= spi->panel_w || y >= spi->panel_h) return;
+    spi->panel[y * spi->panel_w + x] = color;
+}
+
+//** 输出端 - 每次调用一个窗口 / Sink - one window per call
+static void fake_fill_rect(void* ctx, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    display_fake_spi_t* spi = (display_fake_spi_t*)ctx;
+    fake_window(spi, (uint32_t)w * h);
+    if (!spi->panel) return;
+    for (int16_t row = 0; row < h; row++) {
+        for (int16_t col = 0; col < w; col++) panel_put(spi, x + col, y + row, color);
+    }
+}
+
+static void fake_push_rect(void* ctx, int16_t x, int16_t y, int16_t w, int16_t h,
+                           const uint16_t* pixels, int16_t stride) {
+    display_fake_spi_t* spi = (display_fake_spi_t*)ctx;
+    fake_window(spi, (uint32_t)w * h);
+    if (!spi->panel) return;
+    for (int16_t row = 0; row < h; row++) {
+        for (int16_t col = 0; col < w; col++) panel_put(spi, x + col, y + row, pixels[(int32_t)row * stride + col]);
+    }
+}
+
+//** 传输层 - 窗口和像素分开到达 / Transport - windows and pixels arrive separately
+//** 模拟时钟下总线是否还在传输 / Whether the bus is still transferring on the simulated clock
+static bool fake_in_flight(display_fake_spi_t* spi, uint32_t now) {
+    return spi->clock_us && (int32_t)(spi->busy_until_us - now) > 0;
+}
+
+//** 上一个窗口必须正好写满 - 带的顺序或长度错了都会在这里露出来
+//** The previous window must be exactly full - a wrong band order or length shows up here
+static void fake_end_window(display_fake_spi_t* spi) {
+    if (spi->win_w > 0 && spi->win_pos != (uint32_t)spi->win_w * spi->win_h) spi->short_windows++;
+    spi->win_w = 0;
+}
+
+static void fake_open(void* ctx) {
+    display_fake_spi_t* spi = (display_fake_spi_t*)ctx;
+    spi->open = true;
+    if (spi->clock_us) spi->busy_until_us = spi->clock_us();
+}
+
+static void fake_set_window(void* ctx, int16_t x, int16_t y, int16_t w, int16_t h) {
+    display_fake_spi_t* spi = (display_fake_spi_t*)ctx;
+    if (spi->clock_us && fake_in_flight(spi, spi->clock_us())) spi->busy_violations++;
+    fake_window(spi, 0);
+    fake_end_window(spi);
+    spi->window_cycles += (uint32_t)display_spi_cycles(0, 1);
+    spi->win_x = x;
+    spi->win_y = y;
+    spi->win_w = w;
+    spi->win_h = h;
+    spi->win_pos = 0;
+}
+
+//** 线上字节序是高字节在前 - 窗口内地址自动换行 / Wire order is MSB first - addresses wrap inside the window
+static void fake_send(void* ctx, const uint16_t* wire_pixels, uint32_t count) {
+    display_fake_spi_t* spi = (display_fake_spi_t*)ctx;
+    uint64_t cycles = display_spi_cycles((uint64_t)count * sizeof(uint16_t), 0);
+    spi->bytes += (uint64_t)count * sizeof(uint16_t);
+    spi->cycles += cycles;
+
+    if (spi->clock_us) {
+        uint32_t now = spi->clock_us();
+        if (fake_in_flight(spi, now)) {
+            spi->busy_violations++;
+        } else if (spi->open && now - spi->busy_until_us > spi->idle_max_us) {
+            spi->idle_max_us = now - spi->busy_until_us;
+        }
+        uint32_t us = display_spi_us(cycles + spi->window_cycles, spi->hz);
+        spi->busy_until_us = now + us;
+        spi->busy_us += us;
+    }
+    spi->window_cycles = 0;
+
+    if (spi->win_w <= 0) return;
+    for (uint32_t i = 0; spi->panel && i < count; i++) {
+        uint32_t pos = spi->win_pos + i;
+        uint16_t c = (uint16_t)((wire_pixels[i] << 8) | (wire_pixels[i] >> 8));
+        panel_put(spi, spi->win_x + (int32_t)(pos % spi->win_w), spi->win_y + (int32_t)(pos / spi->win_w), c);
+    }
+    spi->win_pos += count;
+}
+
+static bool fake_busy(void* ctx) {
+    display_fake_spi_t* spi = (display_fake_spi_t*)ctx;
+    return spi->clock_us && fake_in_flight(spi, spi->clock_us());
+}
+
+static void fake_close(void* ctx) {
+    display_fake_spi_t* spi = (display_fake_spi_t*)ctx;
+    if (spi->clock_us && fake_in_flight(spi, spi->clock_us())) spi->busy_violations++;
+    fake_end_window(spi);
+    spi->open = false;
+}
+
+void display_fake_spi_init(display_fake_spi_t* spi, uint32_t hz) {
+    memset(spi, 0, sizeof(*spi));
+    spi->hz = hz;
+
+    spi->sink.fill_rect = fake_fill_rect;
+    spi->sink.push_rect = fake_push_rect;
+    spi->sink.ctx = spi;
+
+    spi->transport.open = fake_open;
+    spi->transport.window = fake_set_window;
+    spi->transport.send = fake_send;
+    spi->transport.busy = fake_busy;
+    spi->transport.close = fake_close;
+    spi->transport.ctx = spi;
+}
+
+void display_fake_spi_panel(display_fake_spi_t* spi, uint16_t* pixels, int16_t width, int16_t height) {
+    spi->panel = pixels;
+    spi->panel_w = pixels ? width : 0;
+    spi->panel_h = pixels ? height : 0;
+}
+
+void display_fake_spi_reset(display_fake_spi_t* spi) {
+    spi->windows = 0;
+    spi->bytes = 0;
+    spi->cycles = 0;
+    spi->busy_us = 0;
+    spi->idle_max_us = 0;
+    spi->busy_violations = 0;
+    spi->short_windows = 0;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+//** 假SPI总线 - 不接面板，只数字节和时钟周期 / Fake SPI Bus - No Panel, Only Counts Bytes and Clock Cycles
+//**
+//** 设计要点 / Design Notes:
+//** 1. 同时实现 display_sink_t 和 display_transport_t，装上后除了TFT_eSPI直接画的文字，像素都进这里
+//**    Implements both display_sink_t and display_transport_t, once installed every pixel except text drawn
+//**    directly by TFT_eSPI lands here
+//** 2. 周期按ST7789线上协议估算: 每个窗口 CASET(1+4) + RASET(1+4) + RAMWR(1) = 11字节，像素每个2字节，每字节8个时钟
+//**    Cycles follow the ST7789 wire protocol: each window is CASET(1+4) + RASET(1+4) + RAMWR(1) = 11 bytes,
+//**    each pixel 2 bytes, 8 clocks per byte
+//** 3. 给了时钟就模拟传输时间 - send()后按线上时间busy，忙时再window()/send()记一次违规
+//**    With a clock the transfer time is simulated - busy() for the wire time after send(), and window()/send()
+//**    while busy counts as a violation; without one transfers complete at once
+//** 4. 不调用Arduino和TFT_eSPI - 主机上直接可用 / Never calls into Arduino or TFT_eSPI - usable on the host as is
+//** 5. 可选的内存面板 - 收到的像素按本机字节序写进去，主机测试拿它和参考画面比
+//**    Optional in-memory panel - received pixels are written into it in native order, host tests compare it
+//**    against a reference picture
+
+#include "display_driver.h"
+#include "display_flush.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DISPLAY_SPI_WINDOW_BYTES 11     // CASET + RASET + RAMWR 命令和参数 / commands and parameters
+
+typedef struct {
+    uint32_t hz;                // 估算用的SPI时钟 / SPI clock used for estimates
+    uint32_t windows;
+    uint64_t bytes;             // 像素字节，不含命令 / pixel bytes, commands excluded
+    uint64_t cycles;            // 总线时钟周期，含命令 / bus clock cycles, commands included
+    uint16_t* panel;            // NULL = 不留像素 / NULL = pixels not kept
+    int16_t panel_w, panel_h;
+    int16_t win_x, win_y, win_w, win_h;   // 传输层当前窗口 / current transport window
+    uint32_t win_pos;
+
+    //** 模拟传输时间 - clock_us为NULL时立即完成 / Simulated transfer time - immediate when clock_us is NULL
+    uint32_t (*clock_us)(void);
+    uint32_t busy_until_us;
+    uint32_t window_cycles;     // 随下一次send()发出的命令 / commands that go out with the next send()
+    uint32_t busy_us;           // 总线忙的总时间 / total time the bus was busy
+    uint32_t idle_max_us;       // 一帧内两次传输之间最长的空闲 / longest idle gap between transfers within a frame
+    bool open;
+    uint32_t busy_violations;   // 忙时调用window()/send() / window()/send() called while busy
+    uint32_t short_windows;     // 没写满就换的窗口 / windows abandoned before they were full
+    display_sink_t sink;        // ctx指向本结构 / ctx points at this struct
+    display_transport_t transport;
+} display_fake_spi_t;
+
+//** 总线周期估算 - 基准程序也用它换算驱动自己的统计 / Bus cycle estimate - the benchmark uses it on driver stats too
+static inline uint64_t display_spi_cycles(uint64_t pixel_bytes, uint32_t windows) {
+    return (pixel_bytes + (uint64_t)windows * DISPLAY_SPI_WINDOW_BYTES) * 8;
+}
+
+//** 周期 -> 微秒 / Cycles -> microseconds
+static inline uint32_t display_spi_us(uint64_t cycles, uint32_t hz) {
+    return hz ? (uint32_t)(cycles * 1000000u / hz) : 0;
+}
+
+void display_fake_spi_init(display_fake_spi_t* spi, uint32_t hz);
+void display_fake_spi_reset(display_fake_spi_t* spi);  // 只清计数 / counters only
+
+//** 装上内存面板 - 调用者提供width*height个像素，NULL卸下 / Attach an in-memory panel - the caller provides
+//** width*height pixels, NULL detaches
+void display_fake_spi_panel(display_fake_spi_t* spi, uint16_t* pixels, int16_t width, int16_t height);
+
+//** 装到驱动上 / Install into the driver:
+//**   display_set_sink(&spi.sink);
+//**   display_set_transport(&spi.transport);
+
+#ifdef __cplusplus
+}
+#endif
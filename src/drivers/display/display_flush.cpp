@@ -0,0 +1,151 @@
+//** 异步刷新引擎实现 / Async Flush Engine Implementation
+//**
+//** 流水线只有两个状态变量：有没有待发送的带，还有没有行要填
+//** The pipeline has only two state variables: is a band pending, are rows left to fill
+//**
+//**   CPU:  fill0 | fill1 | ..... | fill0 | .....
+//**   DMA:        | send0 ------- | send1 ------- | send0
+
+#include "display_flush.h"
+#include "display_pixels.h"
+
+void display_flush_engine_init(display_flush_engine_t* e, const display_transport_t* transport,
+                               uint16_t* band0, uint16_t* band1, uint32_t band_capacity) {
+    e->transport = transport;
+    e->band[0] = band0;
+    e->band[1] = band1;
+    e->band_capacity = band_capacity;
+
+    e->src = 0;
+    e->src_stride = 0;
+    e->src_x = 0;
+    e->src_y = 0;
+    e->rect_count = 0;
+    e->rect_index = 0;
+    e->next_row = 0;
+    e->active = false;
+    e->pending = false;
+    e->pending_window = false;
+    e->pending_slot = 0;
+    e->pending_count = 0;
+
+    e->submitted = 0;
+    e->completed = 0;
+    e->on_done = 0;
+    e->on_done_ctx = 0;
+
+    e->bands_sent = 0;
+    e->busy_polls = 0;
+}
+
+//** 从源帧拷贝一带到带缓冲，同时转成线上字节序(高字节在前)
+//** Copy one band from the source frame into a band buffer, converting to wire order (MSB first)
+static void display_flush_fill_band(display_flush_engine_t* e, uint8_t slot) {
+    const display_rect_t* r = &e->rects[e->rect_index];
+
+    int16_t lines = (int16_t)(e->band_capacity / (uint32_t)r->w);
+    if (lines > r->h - e->next_row) lines = r->h - e->next_row;
+
+    uint16_t* dst = e->band[slot];
+    for (int16_t row = 0; row < lines; row++) {
+        const uint16_t* src = e->src + (int32_t)(r->y - e->src_y + e->next_row + row) * e->src_stride + (r->x - e->src_x);
+        display_px_swap_bytes(dst, src, r->w);
+        dst += r->w;
+    }
+
+    e->pending = true;
+    e->pending_window = (e->next_row == 0);  // 每个矩形的第一带打开新窗口 / first band of a rect opens its window
+    e->pending_slot = slot;
+    e->pending_count = (uint32_t)lines * (uint32_t)r->w;
+    e->pending_rect = *r;
+
+    e->next_row += lines;
+    if (e->next_row >= r->h) {
+        e->rect_index++;
+        e->next_row = 0;
+    }
+}
+
+display_fence_t display_flush_engine_submit(display_flush_engine_t* e, const uint16_t* src, int16_t src_stride,
+                                            const display_dirty_t* dirty) {
+    return display_flush_engine_submit_at(e, src, src_stride, 0, 0, dirty);
+}
+
+display_fence_t display_flush_engine_submit_at(display_flush_engine_t* e, const uint16_t* src, int16_t src_stride,
+                                               int16_t src_x, int16_t src_y, const display_dirty_t* dirty) {
+    display_flush_engine_wait(e);
+
+    e->submitted++;
+    if (display_dirty_empty(dirty)) {
+        //** 空帧立即完成 - 不碰总线 / Empty frame completes at once - bus untouched
+        e->completed = e->submitted;
+        if (e->on_done) e->on_done(e->completed, e->on_done_ctx);
+        return e->submitted;
+    }
+
+    e->src = src;
+    e->src_stride = src_stride;
+    e->src_x = src_x;
+    e->src_y = src_y;
+    for (uint8_t i = 0; i < dirty->count; i++) {
+        e->rects[i] = dirty->rects[i];
+    }
+    e->rect_count = dirty->count;
+    e->rect_index = 0;
+    e->next_row = 0;
+    e->pending = false;
+    e->active = true;
+
+    e->transport->open(e->transport->ctx);
+    display_flush_engine_poll(e);
+    return e->submitted;
+}
+
+void display_flush_engine_poll(display_flush_engine_t* e) {
+    const display_transport_t* t = e->transport;
+
+    while (e->active) {
+        if (e->pending) {
+            //** 上一带还在路上 - 让出CPU，下次再来 / Previous band still in flight - yield, come back later
+            if (t->busy(t->ctx)) {
+                e->busy_polls++;
+                return;
+            }
+            if (e->pending_window) {
+                const display_rect_t* r = &e->pending_rect;
+                t->window(t->ctx, r->x, r->y, r->w, r->h);
+            }
+            t->send(t->ctx, e->band[e->pending_slot], e->pending_count);
+            e->pending = false;
+            e->bands_sent++;
+
+            //** 发送刚开始，马上填另一个缓冲 - 这就是重叠
+            //** Transfer just started, fill the other buffer right away - this is the overlap
+            if (e->rect_index < e->rect_count) {
+                display_flush_fill_band(e, (uint8_t)(e->pending_slot ^ 1));
+            }
+            continue;
+        }
+
+        if (e->rect_index < e->rect_count) {
+            display_flush_fill_band(e, 0);
+            continue;
+        }
+
+        //** 全部发出，等最后一带落地 / Everything sent, wait for the last band to land
+        if (t->busy(t->ctx)) {
+            e->busy_polls++;
+            return;
+        }
+        t->close(t->ctx);
+        e->active = false;
+        e->completed = e->submitted;
+        if (e->on_done) e->on_done(e->completed, e->on_done_ctx);
+    }
+}
+
+void display_flush_engine_wait(display_flush_engine_t* e) {
+    while (e->active) {
+        display_flush_engine_poll(e);
+    }
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+//** 异步刷新引擎 - DMA乒乓带缓冲 / Async Flush Engine - DMA Ping-Pong Band Buffers
+//**
+//** 设计要点 / Design Notes:
+//** 1. 一帧按行切成带，CPU填充第N+1带时DMA发送第N带
+//**    A frame is cut into line bands; the CPU fills band N+1 while DMA sends band N
+//** 2. 传输层可替换 - 设备上是TFT_eSPI DMA，主机上可以是模拟SPI
+//**    Pluggable transport - TFT_eSPI DMA on device, a simulated SPI on the host
+//** 3. 栅栏是单调递增的序号 - 轮询或回调二选一
+//**    Fences are monotonically increasing sequence numbers - poll or take a callback
+//** 4. 纯C数据，不依赖Arduino / Plain C data, no Arduino dependency
+
+#include "display_dirty.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//** 每带行数 - 两个带缓冲常驻内部SRAM / Lines per band - both band buffers live in internal SRAM
+#ifndef DISPLAY_FLUSH_BAND_LINES
+#define DISPLAY_FLUSH_BAND_LINES 10
+#endif
+
+//** 传输层 - 引擎只在 busy() 为false时调用 window()/send()
+//** Transport - the engine only calls window()/send() while busy() is false
+typedef struct {
+    void (*open)(void* ctx);                                              // 帧开始，占用总线 / frame start, take the bus
+    void (*window)(void* ctx, int16_t x, int16_t y, int16_t w, int16_t h);
+    void (*send)(void* ctx, const uint16_t* wire_pixels, uint32_t count); // 启动传输，可立即返回 / start, may return at once
+    bool (*busy)(void* ctx);
+    void (*close)(void* ctx);                                             // 帧结束，释放总线 / frame end, release the bus
+    void* ctx;
+} display_transport_t;
+
+typedef uint32_t display_fence_t;
+typedef void (*display_flush_done_t)(display_fence_t fence, void* ctx);
+
+typedef struct {
+    //** 固定资源 / Fixed resources
+    const display_transport_t* transport;
+    uint16_t* band[2];
+    uint32_t band_capacity;             // 每个带缓冲的像素数 / pixels per band buffer
+
+    //** 当前作业 - 提交时从脏列表拷贝 / Current job - copied from the dirty list on submit
+    const uint16_t* src;
+    int16_t src_stride;
+    int16_t src_x, src_y;               // src[0]对应的屏幕坐标 / screen position of src[0]
+    display_rect_t rects[DISPLAY_DIRTY_MAX];
+    uint8_t rect_count;
+    uint8_t rect_index;
+    int16_t next_row;                   // 当前矩形内下一个待填充行 / next row to fill in the current rect
+    bool active;
+
+    //** 已填充待发送的带 / Band filled and waiting to be sent
+    bool pending;
+    bool pending_window;                // 发送前需要设置新窗口 / a new window precedes it
+    uint8_t pending_slot;
+    uint32_t pending_count;
+    display_rect_t pending_rect;
+
+    //** 栅栏 / Fences
+    display_fence_t submitted;
+    display_fence_t completed;
+    display_flush_done_t on_done;
+    void* on_done_ctx;
+
+    //** 统计 / Statistics
+    uint32_t bands_sent;
+    uint32_t busy_polls;                // 轮询时DMA仍在传输的次数 = 重叠的证据 / polls that found DMA busy = overlap
+} display_flush_engine_t;
+
+//** band_capacity 至少是一行的像素数 / band_capacity must hold at least one full display line
+void display_flush_engine_init(display_flush_engine_t* e, const display_transport_t* transport,
+                               uint16_t* band0, uint16_t* band1, uint32_t band_capacity);
+
+//** 提交一帧 - 上一帧未完成时先等它完成 / Submit a frame - waits for the previous one if still running
+display_fence_t display_flush_engine_submit(display_flush_engine_t* e, const uint16_t* src, int16_t src_stride,
+                                            const display_dirty_t* dirty);
+
+//** 同上，但src只覆盖从 (src_x, src_y) 开始的一块 - 用于带状的源
+//** As above, but src only covers a block starting at (src_x, src_y) - for band-shaped sources
+display_fence_t display_flush_engine_submit_at(display_flush_engine_t* e, const uint16_t* src, int16_t src_stride,
+                                               int16_t src_x, int16_t src_y, const display_dirty_t* dirty);
+
+//** 推进流水线 - 主循环中调用，不阻塞 / Advance the pipeline - call from the main loop, never blocks
+void display_flush_engine_poll(display_flush_engine_t* e);
+
+//** 阻塞直到当前作业完成 / Block until the current job is done
+void display_flush_engine_wait(display_flush_engine_t* e);
+
+static inline bool display_flush_engine_idle(const display_flush_engine_t* e) { return !e->active; }
+
+static inline bool display_flush_engine_reached(const display_flush_engine_t* e, display_fence_t fence) {
+    return (int32_t)(e->completed - fence) >= 0;  // 序号回绕安全 / wrap-around safe
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,53 @@
+//** RGB565帧缓冲实现 / RGB565 Framebuffer Implementation
+//**
+//** "Bad programmers worry about the code. Good programmers worry about data structures."
+//** 帧缓冲就是一块内存加一张脏矩形表，没有别的 / A framebuffer is a block of memory plus a dirty list, nothing more
+
+#include "display_framebuffer.h"
+#include <string.h>
+
+void display_fb_init(display_fb_t* fb, uint16_t* pixels, int16_t width, int16_t height) {
+    fb->pixels = pixels;
+    fb->width = width;
+    fb->height = height;
+    memset(pixels, 0, (size_t)width * (size_t)height * sizeof(uint16_t));
+    display_dirty_clear(&fb->dirty);
+}
+
+void display_fb_fill_rect(display_fb_t* fb, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    display_rect_t r = { x, y, w, h };
+    if (!display_rect_clip(&r, fb->width, fb->height)) return;
+
+    //** 第一行逐像素写，后续行整行复制 / First row per pixel, following rows copied whole
+    uint16_t* first = display_fb_at(fb, r.x, r.y);
+    for (int16_t i = 0; i < r.w; i++) {
+        first[i] = color;
+    }
+    for (int16_t row = 1; row < r.h; row++) {
+        memcpy(first + (int32_t)row * fb->width, first, (size_t)r.w * sizeof(uint16_t));
+    }
+
+    display_dirty_add(&fb->dirty, &r);
+}
+
+void display_fb_blit(display_fb_t* fb, int16_t x, int16_t y, int16_t w, int16_t h,
+                     const uint16_t* src, int16_t src_stride) {
+    display_rect_t r = { x, y, w, h };
+    if (!display_rect_clip(&r, fb->width, fb->height)) return;
+
+    //** 裁剪后源数据的起点也要跟着移动 / Source origin moves with the clip
+    src += (int32_t)(r.y - y) * src_stride + (r.x - x);
+
+    for (int16_t row = 0; row < r.h; row++) {
+        memcpy(display_fb_at(fb, r.x, r.y + row), src + (int32_t)row * src_stride,
+               (size_t)r.w * sizeof(uint16_t));
+    }
+
+    display_dirty_add(&fb->dirty, &r);
+}
+
+void display_fb_invalidate(display_fb_t* fb, int16_t x, int16_t y, int16_t w, int16_t h) {
+    display_rect_t r = { x, y, w, h };
+    if (!display_rect_clip(&r, fb->width, fb->height)) return;
+    display_dirty_add(&fb->dirty, &r);
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+//** RGB565帧缓冲 - 绘图进内存，刷新只推脏区 / RGB565 Framebuffer - Draw to Memory, Flush Only Dirty Regions
+//**
+//** 设计要点 / Design Notes:
+//** 1. 不负责分配 - 调用者提供像素内存 (PSRAM) / Does not allocate - caller provides pixel memory (PSRAM)
+//** 2. 每次写入都记录脏矩形 / Every write records a dirty rectangle
+//** 3. 纯C数据 - 不依赖Arduino和TFT_eSPI / Plain C data - no Arduino or TFT_eSPI dependency
+
+#include "display_dirty.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint16_t* pixels;       // 行优先，步长 = width / row-major, stride = width
+    int16_t width, height;
+    display_dirty_t dirty;
+} display_fb_t;
+
+//** 初始化 - 像素清零，脏列表清空 / Init - pixels zeroed, dirty list cleared
+void display_fb_init(display_fb_t* fb, uint16_t* pixels, int16_t width, int16_t height);
+
+//** 绘图操作 - 自动裁剪并标记脏区 / Drawing - clipped and marked dirty automatically
+void display_fb_fill_rect(display_fb_t* fb, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+void display_fb_blit(display_fb_t* fb, int16_t x, int16_t y, int16_t w, int16_t h,
+                     const uint16_t* src, int16_t src_stride);
+
+//** 只标记不绘制 - 内容被外部修改时使用 / Mark without drawing - for content changed behind our back
+void display_fb_invalidate(display_fb_t* fb, int16_t x, int16_t y, int16_t w, int16_t h);
+
+//** 像素地址 - 调用者保证坐标合法 / Pixel address - caller guarantees coordinates are in range
+static inline uint16_t* display_fb_at(const display_fb_t* fb, int16_t x, int16_t y) {
+    return fb->pixels + (int32_t)y * fb->width + x;
+}
+
+#ifdef __cplusplus
+}
+#endif
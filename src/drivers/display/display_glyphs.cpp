@@ -0,0 +1,124 @@
+//** 字形图集缓存实现 / Glyph Atlas Cache Implementation
+//**
+//** 图集是一块字节内存，字形按4字节对齐首次适配放置
+//** The atlas is one block of bytes, glyphs are placed first-fit at 4-byte alignment
+
+#include "display_glyphs.h"
+#include <string.h>
+
+void display_glyph_cache_init(display_glyph_cache_t* cache, uint8_t* atlas, uint32_t capacity,
+                              const display_glyph_source_t* source) {
+    memset(cache, 0, sizeof(*cache));
+    cache->atlas = atlas;
+    cache->capacity = capacity;
+    cache->source = source;
+}
+
+void display_glyph_cache_clear(display_glyph_cache_t* cache) {
+    memset(cache->entries, 0, sizeof(cache->entries));
+    cache->stats.bytes_used = 0;
+    cache->stats.entries = 0;
+}
+
+static bool glyph_key_equal(const display_glyph_key_t* a, const display_glyph_key_t* b) {
+    return a->ch == b->ch && a->font == b->font && a->size == b->size && a->fg == b->fg && a->bg == b->bg;
+}
+
+static void glyph_evict(display_glyph_cache_t* cache, display_glyph_entry_t* e) {
+    e->used = false;
+    cache->stats.bytes_used -= e->bytes;
+    cache->stats.entries--;
+    cache->stats.evictions++;
+}
+
+//** 最久没用的条目 / Least recently used entry
+static display_glyph_entry_t* glyph_lru(display_glyph_cache_t* cache) {
+    display_glyph_entry_t* oldest = NULL;
+    for (uint16_t i = 0; i < DISPLAY_GLYPH_MAX_ENTRIES; i++) {
+        display_glyph_entry_t* e = &cache->entries[i];
+        if (e->used && (!oldest || e->last_used < oldest->last_used)) oldest = e;
+    }
+    return oldest;
+}
+
+static display_glyph_entry_t* glyph_free_slot(display_glyph_cache_t* cache) {
+    for (uint16_t i = 0; i < DISPLAY_GLYPH_MAX_ENTRIES; i++) {
+        if (!cache->entries[i].used) return &cache->entries[i];
+    }
+    return NULL;
+}
+
+//** 按偏移排序已用条目，找第一个放得下的空隙
+//** Sort used entries by offset and find the first gap that fits
+static bool glyph_find_gap(const display_glyph_cache_t* cache, uint32_t bytes, uint32_t* offset) {
+    uint8_t order[DISPLAY_GLYPH_MAX_ENTRIES];
+    uint16_t n = 0;
+
+    for (uint16_t i = 0; i < DISPLAY_GLYPH_MAX_ENTRIES; i++) {
+        if (!cache->entries[i].used) continue;
+        uint16_t j = n++;
+        while (j > 0 && cache->entries[order[j - 1]].offset > cache->entries[i].offset) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = (uint8_t)i;
+    }
+
+    uint32_t cursor = 0;
+    for (uint16_t k = 0; k < n; k++) {
+        const display_glyph_entry_t* e = &cache->entries[order[k]];
+        if (e->offset - cursor >= bytes) break;
+        cursor = e->offset + e->bytes;
+    }
+    if (cache->capacity - cursor < bytes) return false;
+
+    *offset = cursor;
+    return true;
+}
+
+const uint16_t* display_glyph_get(display_glyph_cache_t* cache, const display_glyph_key_t* key,
+                                  int16_t* w, int16_t* h) {
+    cache->clock++;
+
+    for (uint16_t i = 0; i < DISPLAY_GLYPH_MAX_ENTRIES; i++) {
+        display_glyph_entry_t* e = &cache->entries[i];
+        if (e->used && glyph_key_equal(&e->key, key)) {
+            e->last_used = cache->clock;
+            cache->stats.hits++;
+            *w = e->w;
+            *h = e->h;
+            return (const uint16_t*)(cache->atlas + e->offset);
+        }
+    }
+
+    cache->stats.misses++;
+    cache->source->measure(cache->source->ctx, key->ch, key->font, key->size, w, h);
+
+    uint32_t bytes = ((uint32_t)(*w > 0 ? *w : 0) * (uint32_t)(*h > 0 ? *h : 0) * sizeof(uint16_t) + 3u) & ~3u;
+    if (bytes == 0 || bytes > cache->capacity) {
+        cache->stats.uncacheable++;
+        return NULL;
+    }
+
+    //** 槽位或空间不够就淘汰最旧的，图集空了总能放下
+    //** Evict the oldest while short of slots or space - an empty atlas always fits
+    display_glyph_entry_t* slot;
+    uint32_t offset;
+    while (!(slot = glyph_free_slot(cache)) || !glyph_find_gap(cache, bytes, &offset)) {
+        glyph_evict(cache, glyph_lru(cache));
+    }
+
+    slot->key = *key;
+    slot->w = *w;
+    slot->h = *h;
+    slot->offset = offset;
+    slot->bytes = bytes;
+    slot->last_used = cache->clock;
+    slot->used = true;
+    cache->stats.bytes_used += bytes;
+    cache->stats.entries++;
+
+    uint16_t* pixels = (uint16_t*)(cache->atlas + offset);
+    cache->source->render(cache->source->ctx, key, pixels, *w, *h);
+    return pixels;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+//** 字形图集缓存 - 每个字形只光栅化一次 / Glyph Atlas Cache - Each Glyph Rasterized Once
+//**
+//** 设计要点 / Design Notes:
+//** 1. 键是 (字符, 字体, 字号, 前景色, 背景色)，值是RGB565像素块
+//**    Key is (char, font, size, fg, bg), value is a block of RGB565 pixels
+//** 2. 像素放在调用者提供的图集内存里 (PSRAM)，图集大小就是内存预算
+//**    Pixels live in a caller-provided atlas (PSRAM); the atlas size is the memory budget
+//** 3. 放不下时按LRU淘汰，直到出现足够大的连续空隙
+//**    When full, evict LRU until a large enough contiguous gap appears
+//** 4. 光栅化由字形源完成 - 设备上是TFT_eSPI，主机上可以是假实现
+//**    Rasterizing is done by the glyph source - TFT_eSPI on device, a fake on the host
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DISPLAY_GLYPH_MAX_ENTRIES 128
+#define DISPLAY_GLYPH_DEFAULT_BUDGET (64 * 1024)  // 字节 / bytes
+
+typedef struct {
+    uint16_t fg, bg;
+    uint8_t ch;
+    uint8_t font;
+    uint8_t size;
+} display_glyph_key_t;
+
+//** 字形源 - 量尺寸和画像素 / Glyph source - measures and draws pixels
+typedef struct {
+    void (*measure)(void* ctx, uint8_t ch, uint8_t font, uint8_t size, int16_t* w, int16_t* h);
+    void (*render)(void* ctx, const display_glyph_key_t* key, uint16_t* pixels, int16_t w, int16_t h);
+    void* ctx;
+} display_glyph_source_t;
+
+typedef struct {
+    display_glyph_key_t key;
+    int16_t w, h;
+    uint32_t offset;            // 图集内字节偏移 / byte offset in the atlas
+    uint32_t bytes;
+    uint32_t last_used;         // LRU时钟 / LRU clock
+    bool used;
+} display_glyph_entry_t;
+
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+    uint32_t uncacheable;       // 比整个图集还大 / larger than the whole atlas
+    uint32_t bytes_used;
+    uint16_t entries;
+} display_glyph_stats_t;
+
+typedef struct {
+    uint8_t* atlas;
+    uint32_t capacity;
+    uint32_t clock;
+    const display_glyph_source_t* source;
+    display_glyph_entry_t entries[DISPLAY_GLYPH_MAX_ENTRIES];
+    display_glyph_stats_t stats;
+} display_glyph_cache_t;
+
+void display_glyph_cache_init(display_glyph_cache_t* cache, uint8_t* atlas, uint32_t capacity,
+                              const display_glyph_source_t* source);
+
+//** 丢弃所有字形，统计保留 / Drop every glyph, statistics are kept
+void display_glyph_cache_clear(display_glyph_cache_t* cache);
+
+//** 查找或光栅化一个字形 - w/h总会填上；返回NULL表示缓存不下，调用者直接绘制
+//** Look up or rasterize one glyph - w/h are always filled; NULL means uncacheable, caller draws directly
+const uint16_t* display_glyph_get(display_glyph_cache_t* cache, const display_glyph_key_t* key,
+                                  int16_t* w, int16_t* h);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,113 @@
+//** 流式图像解码公共部分 / Streaming Image Decode Common Parts
+//**
+//** 输入缓冲、内存池、带输出和格式分派 / Input buffering, memory pool, band output and format dispatch
+
+#include "display_image_internal.h"
+#include <string.h>
+
+void* display_image_alloc(display_image_ctx_t* ctx, uint32_t bytes) {
+    uint32_t size = (bytes + 3u) & ~3u;
+    if (size > ctx->pool_size - ctx->pool_used) {
+        display_image_fail(ctx, DISPLAY_IMAGE_ERR_MEMORY);
+        return NULL;
+    }
+
+    void* p = ctx->pool + ctx->pool_used;
+    ctx->pool_used += size;
+    if (ctx->pool_used > ctx->stats->peak_bytes) ctx->stats->peak_bytes = ctx->pool_used;
+    return p;
+}
+
+uint8_t display_image_byte(display_image_ctx_t* ctx) {
+    if (ctx->chunk_pos == ctx->chunk_len) {
+        int32_t n = ctx->eof ? 0 : ctx->reader->read(ctx->reader->ctx, ctx->chunk, DISPLAY_IMAGE_CHUNK);
+        if (n <= 0) {
+            ctx->eof = true;
+            display_image_fail(ctx, DISPLAY_IMAGE_ERR_IO);
+            return 0;
+        }
+        ctx->chunk_len = (uint32_t)n;
+        ctx->chunk_pos = 0;
+        ctx->stats->bytes_in += (uint32_t)n;
+    }
+    return ctx->chunk[ctx->chunk_pos++];
+}
+
+uint16_t display_image_be16(display_image_ctx_t* ctx) {
+    uint16_t hi = display_image_byte(ctx);
+    return (uint16_t)((hi << 8) | display_image_byte(ctx));
+}
+
+uint32_t display_image_be32(display_image_ctx_t* ctx) {
+    uint32_t hi = display_image_be16(ctx);
+    return (hi << 16) | display_image_be16(ctx);
+}
+
+void display_image_skip(display_image_ctx_t* ctx, uint32_t count) {
+    while (count && !ctx->error) {
+        if (ctx->chunk_pos == ctx->chunk_len) {
+            display_image_byte(ctx);  // 重新填充 / refill
+            count--;
+            continue;
+        }
+        //** 缓冲里有的一步跳过 / Skip what is already buffered in one step
+        uint32_t n = ctx->chunk_len - ctx->chunk_pos;
+        if (n > count) n = count;
+        ctx->chunk_pos += n;
+        count -= n;
+    }
+}
+
+bool display_image_bands_alloc(display_image_ctx_t* ctx, int16_t width, int16_t lines) {
+    uint32_t bytes = (uint32_t)width * (uint32_t)lines * sizeof(uint16_t);
+    ctx->band[0] = (uint16_t*)display_image_alloc(ctx, bytes);
+    ctx->band[1] = (uint16_t*)display_image_alloc(ctx, bytes);
+    ctx->band_slot = 0;
+    return ctx->band[1] != NULL;
+}
+
+void display_image_band_emit(display_image_ctx_t* ctx, int16_t row, int16_t width, int16_t lines) {
+    ctx->band_fn(ctx->band_ctx, ctx->x, (int16_t)(ctx->y + row), width, lines, ctx->band[ctx->band_slot]);
+    ctx->stats->bands++;
+    ctx->band_slot ^= 1;
+}
+
+display_image_result_t display_image_decode(const display_image_reader_t* reader, uint8_t* pool, uint32_t pool_size,
+                                            int16_t x, int16_t y, display_image_band_fn band, void* band_ctx,
+                                            display_image_stats_t* stats) {
+    display_image_stats_t local;
+    display_image_ctx_t ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.reader = reader;
+    ctx.pool = pool;
+    ctx.pool_size = pool_size;
+    ctx.x = x;
+    ctx.y = y;
+    ctx.band_fn = band;
+    ctx.band_ctx = band_ctx;
+    ctx.stats = stats ? stats : &local;
+    memset(ctx.stats, 0, sizeof(*ctx.stats));
+
+    ctx.chunk = (uint8_t*)display_image_alloc(&ctx, DISPLAY_IMAGE_CHUNK);
+    if (!ctx.chunk) return ctx.error;
+
+    uint8_t b0 = display_image_byte(&ctx);
+    uint8_t b1 = display_image_byte(&ctx);
+    if (ctx.error) return ctx.error;
+
+    if (b0 == 0xFF && b1 == 0xD8) return display_image_jpeg(&ctx);
+    if (b0 == 0x89 && b1 == 'P') return display_image_png(&ctx);
+    return DISPLAY_IMAGE_ERR_FORMAT;
+}
+
+const char* display_image_result_name(display_image_result_t result) {
+    switch (result) {
+        case DISPLAY_IMAGE_OK:              return "ok";
+        case DISPLAY_IMAGE_ERR_FORMAT:      return "unknown format";
+        case DISPLAY_IMAGE_ERR_UNSUPPORTED: return "unsupported";
+        case DISPLAY_IMAGE_ERR_MEMORY:      return "out of budget";
+        case DISPLAY_IMAGE_ERR_IO:          return "read error";
+        case DISPLAY_IMAGE_ERR_CORRUPT:     return "corrupt";
+    }
+    return "?";
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+//** 流式图像解码 - JPEG/PNG边读边解，按带输出 / Streaming Image Decode - JPEG/PNG Decoded While Read, Emitted in Bands
+//**
+//** 设计要点 / Design Notes:
+//** 1. 输入按块从读取器拉取，整个文件从不进内存 / Input is pulled from a reader in chunks, the file never sits in RAM
+//** 2. 所有工作内存来自调用者提供的池，池大小就是峰值上限
+//**    All working memory comes from a caller-provided pool, whose size is the peak limit
+//** 3. 一带(JPEG一行MCU / PNG若干扫描线)解完立即交给输出回调
+//**    Each band (one MCU row for JPEG / a few scanlines for PNG) goes to the output callback as soon as it is done
+//** 4. 两个带缓冲轮流使用 - 回调返回后上一带才会被覆盖
+//**    Two band buffers alternate - a band is only overwritten after the following callback has returned
+//** 5. 支持 / Supported: 基线JPEG (灰度, 4:4:4, 4:2:2, 4:2:0, 重启间隔 / restart intervals);
+//**    非隔行PNG (所有颜色类型和位深 / all colour types and bit depths, 透明度与黑色混合 / alpha over black)
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//** PNG需要32KB的LZ77窗口，默认预算按它来定 / PNG needs a 32KB LZ77 window, the default budget is sized for it
+#ifndef DISPLAY_IMAGE_BUDGET
+#define DISPLAY_IMAGE_BUDGET (48 * 1024)
+#endif
+
+#define DISPLAY_IMAGE_CHUNK 512       // 每次读取的字节数 / bytes per read
+#define DISPLAY_IMAGE_PNG_LINES 8     // PNG每带扫描线数 / PNG scanlines per band
+
+typedef enum {
+    DISPLAY_IMAGE_OK = 0,
+    DISPLAY_IMAGE_ERR_FORMAT,         // 不是JPEG也不是PNG / neither JPEG nor PNG
+    DISPLAY_IMAGE_ERR_UNSUPPORTED,    // 渐进JPEG、隔行PNG等 / progressive JPEG, interlaced PNG, ...
+    DISPLAY_IMAGE_ERR_MEMORY,         // 超出内存池 / exceeds the pool
+    DISPLAY_IMAGE_ERR_IO,             // 读取失败或文件截断 / read failure or truncated file
+    DISPLAY_IMAGE_ERR_CORRUPT         // 数据损坏 / corrupt data
+} display_image_result_t;
+
+//** 读取器 - 返回读到的字节数，0表示结束，负数表示错误
+//** Reader - returns bytes read, 0 at end of file, negative on error
+typedef struct {
+    int32_t (*read)(void* ctx, uint8_t* buf, uint32_t len);
+    void* ctx;
+} display_image_reader_t;
+
+//** 一带BGR565像素，本机字节序，步长 = w / One band of BGR565 pixels, native byte order, stride = w
+typedef void (*display_image_band_fn)(void* ctx, int16_t x, int16_t y, int16_t w, int16_t h,
+                                      const uint16_t* pixels);
+
+typedef struct {
+    int16_t width, height;
+    uint32_t bytes_in;        // 从读取器读到的字节 / bytes pulled from the reader
+    uint32_t bands;
+    uint32_t peak_bytes;      // 内存池用量峰值 / pool high-water mark
+} display_image_stats_t;
+
+//** 解码到 (x, y) - stats可为NULL / Decode to (x, y) - stats may be NULL
+display_image_result_t display_image_decode(const display_image_reader_t* reader, uint8_t* pool, uint32_t pool_size,
+                                            int16_t x, int16_t y, display_image_band_fn band, void* band_ctx,
+                                            display_image_stats_t* stats);
+
+const char* display_image_result_name(display_image_result_t result);
+
+#ifdef __cplusplus
+}
+#endif
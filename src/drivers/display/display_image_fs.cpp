@@ -0,0 +1,22 @@
+//** 从文件系统流式显示图像实现 / Stream Images from a File System Implementation
+
+#include "display_image_fs.h"
+
+static int32_t file_read(void* ctx, uint8_t* buf, uint32_t len) {
+    fs::File* file = (fs::File*)ctx;
+    return (int32_t)file->read(buf, len);
+}
+
+display_image_result_t display_image_draw_file(fs::FS& fs, const char* path, int16_t x, int16_t y,
+                                               display_image_stats_t* stats) {
+    fs::File file = fs.open(path, "r");
+    if (!file) {
+        DISPLAY_DEBUG("Image open failed: %s", path);
+        return DISPLAY_IMAGE_ERR_IO;
+    }
+
+    display_image_reader_t reader = { file_read, &file };
+    display_image_result_t result = display_image_draw(&reader, x, y, stats);
+    file.close();
+    return result;
+}
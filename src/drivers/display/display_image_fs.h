@@ -0,0 +1,14 @@
+#pragma once
+
+//** 从文件系统流式显示图像 - SPIFFS或SD_MMC / Stream Images from a File System - SPIFFS or SD_MMC
+//**
+//** 用法 / Usage:
+//**   display_image_draw_file(SPIFFS, "/logo.jpg", 0, 0, NULL);
+//**   display_image_draw_file(SD_MMC, "/photos/cat.png", 0, 0, &stats);
+
+#include "display_driver.h"
+#include <FS.h>
+
+//** 路径相对于文件系统挂载点 / The path is relative to the file system's mount point
+display_image_result_t display_image_draw_file(fs::FS& fs, const char* path, int16_t x, int16_t y,
+                                               display_image_stats_t* stats);
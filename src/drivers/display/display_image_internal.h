@@ -0,0 +1,52 @@
+#pragma once
+
+//** 图像解码器内部接口 - 只给 display_image*.cpp 使用
+//** Image decoder internals - for display_image*.cpp only
+
+#include "display_image.h"
+#include <stdbool.h>
+
+typedef struct {
+    const display_image_reader_t* reader;
+    uint8_t* chunk;
+    uint32_t chunk_len, chunk_pos;
+    bool eof;
+
+    uint8_t* pool;
+    uint32_t pool_size, pool_used;
+
+    display_image_result_t error;   // 第一个错误 / first error seen
+
+    int16_t x, y;
+    display_image_band_fn band_fn;
+    void* band_ctx;
+    uint16_t* band[2];
+    uint8_t band_slot;
+
+    display_image_stats_t* stats;
+} display_image_ctx_t;
+
+//** 记录错误 - 只保留第一个 / Record an error - only the first one sticks
+static inline void display_image_fail(display_image_ctx_t* ctx, display_image_result_t error) {
+    if (ctx->error == DISPLAY_IMAGE_OK) ctx->error = error;
+}
+
+//** 从池里分配，4字节对齐；不够时记ERR_MEMORY返回NULL
+//** Allocate from the pool, 4-byte aligned; on shortage records ERR_MEMORY and returns NULL
+void* display_image_alloc(display_image_ctx_t* ctx, uint32_t bytes);
+
+//** 读一个字节 - 文件结束时记ERR_IO返回0 / Read one byte - at end of file records ERR_IO and returns 0
+uint8_t display_image_byte(display_image_ctx_t* ctx);
+uint16_t display_image_be16(display_image_ctx_t* ctx);
+uint32_t display_image_be32(display_image_ctx_t* ctx);
+void display_image_skip(display_image_ctx_t* ctx, uint32_t count);
+
+//** 带缓冲 - 先分配，再往当前带写，写满一带就发出
+//** Band buffers - allocate once, write into the current band, emit it when done
+bool display_image_bands_alloc(display_image_ctx_t* ctx, int16_t width, int16_t lines);
+static inline uint16_t* display_image_band(display_image_ctx_t* ctx) { return ctx->band[ctx->band_slot]; }
+void display_image_band_emit(display_image_ctx_t* ctx, int16_t row, int16_t width, int16_t lines);
+
+//** 格式解码器 - 签名已经读过 / Format decoders - the signature has been consumed
+display_image_result_t display_image_jpeg(display_image_ctx_t* ctx);
+display_image_result_t display_image_png(display_image_ctx_t* ctx);
@@ -0,0 +1,570 @@
+//** 基线JPEG流式解码 / Streaming Baseline JPEG Decoder
+//**
+//** 每解完一行MCU就转成BGR565放进带缓冲发出 - 内存只有一行MCU的量
+//** Every finished MCU row is converted to BGR565 in a band and emitted - memory holds one MCU row
+//**
+//** 整数IDCT (与libjpeg islow相同的常数) / Integer IDCT (same constants as libjpeg islow)
+//** 色度用最近邻上采样 / Chroma is upsampled nearest-neighbour
+
+#include "display_image_internal.h"
+#include "display_pixels.h"
+#include <string.h>
+
+#define JPEG_FAST_BITS 8
+#define JPEG_MAX_COMPONENTS 3
+
+//** 之字形序号 -> 自然顺序 / Zigzag index -> natural order
+static const uint8_t jpeg_natural[64] = {
+     0,  1,  8, 16,  9,  2,  3, 10, 17, 24, 32, 25, 18, 11,  4,  5,
+    12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13,  6,  7, 14, 21, 28,
+    35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+    58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63
+};
+
+typedef struct {
+    uint16_t fast[1 << JPEG_FAST_BITS];   // (长度 << 8) | 值，0表示走慢路径 / (length << 8) | value, 0 = slow path
+    int32_t maxcode[17];                  // 每个长度的最大码，-1表示没有 / largest code per length, -1 = none
+    int32_t valoff[17];
+    uint8_t values[256];
+} jpeg_huff_t;
+
+typedef struct {
+    uint8_t id;
+    uint8_t h, v;
+    uint8_t tq;
+    uint8_t td, ta;
+    int16_t dc_pred;
+    uint8_t* samples;                     // 本MCU内该分量的样本，步长 = 8*h / this MCU's samples, stride = 8*h
+} jpeg_component_t;
+
+typedef struct {
+    display_image_ctx_t* io;
+
+    jpeg_huff_t* huff[4];                 // DC0, DC1, AC0, AC1
+    uint16_t qt[4][64];                   // 之字形顺序 / zigzag order
+    jpeg_component_t comp[JPEG_MAX_COMPONENTS];
+    uint8_t ncomp;
+    int16_t width, height;
+    uint8_t hmax, vmax;
+    uint16_t restart_interval;
+    bool have_frame;
+
+    //** 熵解码位缓冲 - 有效位在高位 / Entropy bit buffer - valid bits at the top
+    uint32_t bits;
+    int8_t nbits;
+    uint8_t marker;                       // 扫描数据中遇到的标记，0表示没有 / marker hit inside scan data, 0 = none
+
+    int16_t* coef;
+} jpeg_t;
+
+//** ========================================
+//** 熵解码 / Entropy Decoding
+//** ========================================
+
+//** 扫描数据的下一个字节 - 处理0xFF00填充，遇到标记后只给0
+//** Next byte of scan data - handles 0xFF00 stuffing, yields zeros once a marker is hit
+static uint8_t jpeg_data_byte(jpeg_t* j) {
+    if (j->marker) return 0;
+
+    uint8_t b = display_image_byte(j->io);
+    if (b != 0xFF) return b;
+
+    uint8_t m = display_image_byte(j->io);
+    while (m == 0xFF && !j->io->error) m = display_image_byte(j->io);
+    if (m == 0x00) return 0xFF;
+
+    j->marker = m;
+    return 0;
+}
+
+static void jpeg_fill(jpeg_t* j) {
+    while (j->nbits <= 24) {
+        j->bits |= (uint32_t)jpeg_data_byte(j) << (24 - j->nbits);
+        j->nbits += 8;
+    }
+}
+
+static uint32_t jpeg_bits(jpeg_t* j, uint8_t n) {
+    if (n == 0) return 0;
+    jpeg_fill(j);
+    uint32_t v = j->bits >> (32 - n);
+    j->bits <<= n;
+    j->nbits -= n;
+    return v;
+}
+
+//** n位差值还原成有符号数 / Extend an n-bit difference to a signed value
+static int32_t jpeg_extend(uint32_t v, uint8_t n) {
+    if (n == 0) return 0;
+    return (v < (1u << (n - 1))) ? (int32_t)v - (1 << n) + 1 : (int32_t)v;
+}
+
+static uint8_t jpeg_decode(jpeg_t* j, const jpeg_huff_t* h) {
+    jpeg_fill(j);
+
+    uint16_t e = h->fast[j->bits >> (32 - JPEG_FAST_BITS)];
+    if (e) {
+        uint8_t len = (uint8_t)(e >> 8);
+        j->bits <<= len;
+        j->nbits -= len;
+        return (uint8_t)e;
+    }
+
+    for (uint8_t len = JPEG_FAST_BITS + 1; len <= 16; len++) {
+        int32_t code = (int32_t)(j->bits >> (32 - len));
+        if (code <= h->maxcode[len]) {
+            j->bits <<= len;
+            j->nbits -= len;
+            return h->values[code + h->valoff[len]];
+        }
+    }
+    display_image_fail(j->io, DISPLAY_IMAGE_ERR_CORRUPT);
+    return 0;
+}
+
+//** 码表超额 (某个长度的码数放不下) 返回false - 不检查的话短码会写出fast[]
+//** Returns false for an over-subscribed table (more codes than a length can hold) - unchecked, short codes
+//** would write past fast[]
+static bool jpeg_build_huff(jpeg_huff_t* h, const uint8_t counts[16]) {
+    uint16_t codes[256];
+    uint8_t lengths[256];
+    int32_t code = 0;
+    uint16_t k = 0;
+
+    memset(h->fast, 0, sizeof(h->fast));
+    h->maxcode[0] = -1;
+    for (uint8_t len = 1; len <= 16; len++) {
+        h->valoff[len] = (int32_t)k - code;
+        for (uint8_t i = 0; i < counts[len - 1]; i++, k++) {
+            codes[k] = (uint16_t)code++;
+            lengths[k] = len;
+        }
+        if (code > (1 << len)) return false;
+        h->maxcode[len] = counts[len - 1] ? code - 1 : -1;
+        code <<= 1;
+    }
+
+    //** 短码展开成查找表 / Short codes expand into the lookup table
+    for (uint16_t s = 0; s < k; s++) {
+        if (lengths[s] > JPEG_FAST_BITS) continue;
+        uint16_t fill = (uint16_t)(1u << (JPEG_FAST_BITS - lengths[s]));
+        uint16_t base = (uint16_t)(codes[s] << (JPEG_FAST_BITS - lengths[s]));
+        if (base + fill > (1u << JPEG_FAST_BITS)) return false;
+        for (uint16_t i = 0; i < fill; i++) {
+            h->fast[base + i] = (uint16_t)((lengths[s] << 8) | h->values[s]);
+        }
+    }
+    return true;
+}
+
+//** ========================================
+//** 反变换 / Inverse Transform
+//** ========================================
+
+#define FIX(x) ((int32_t)((x) * 4096 + 0.5))
+
+//** 一维8点IDCT，结果在 x0..x3 和 t0..t3 / 1-D 8-point IDCT, result in x0..x3 and t0..t3
+#define JPEG_IDCT_1D(s0, s1, s2, s3, s4, s5, s6, s7)              \
+    int32_t p1 = ((s2) + (s6)) * FIX(0.5411961);                  \
+    int32_t t2 = p1 + (s6) * FIX(-1.847759065);                   \
+    int32_t t3 = p1 + (s2) * FIX(0.765366865);                    \
+    int32_t t0 = ((s0) + (s4)) * 4096;                            \
+    int32_t t1 = ((s0) - (s4)) * 4096;                            \
+    int32_t x0 = t0 + t3, x3 = t0 - t3, x1 = t1 + t2, x2 = t1 - t2; \
+    t0 = (s7); t1 = (s5); t2 = (s3); t3 = (s1);                   \
+    int32_t p3 = t0 + t2, p4 = t1 + t3;                           \
+    p1 = t0 + t3;                                                 \
+    int32_t p2 = t1 + t2;                                         \
+    int32_t p5 = (p3 + p4) * FIX(1.175875602);                    \
+    t0 *= FIX(0.298631336);                                       \
+    t1 *= FIX(2.053119869);                                       \
+    t2 *= FIX(3.072711026);                                       \
+    t3 *= FIX(1.501321110);                                       \
+    p1 = p5 + p1 * FIX(-0.899976223);                             \
+    p2 = p5 + p2 * FIX(-2.562915447);                             \
+    p3 *= FIX(-1.961570560);                                      \
+    p4 *= FIX(-0.390180644);                                      \
+    t3 += p1 + p4;                                                \
+    t2 += p2 + p3;                                                \
+    t1 += p2 + p4;                                                \
+    t0 += p1 + p3;
+
+static inline uint8_t jpeg_clamp(int32_t v) {
+    return (uint8_t)(v < 0 ? 0 : (v > 255 ? 255 : v));
+}
+
+//** 8位基线的系数在 ±1024 以内，反量化后最多再多半个量化步长；钳到 ±2047 合法图像不受影响，坏数据也不会让IDCT溢出
+//** 8-bit baseline coefficients stay within ±1024, plus at most half a quantiser step once dequantised; clamping
+//** to ±2047 leaves valid images untouched and keeps bad data from overflowing the IDCT
+#define JPEG_COEF_MAX 2047
+#define JPEG_COL_MAX  16384
+
+static inline int16_t jpeg_dequant(int32_t v, uint16_t q) {
+    int32_t d = v * (int32_t)q;
+    return (int16_t)(d < -JPEG_COEF_MAX ? -JPEG_COEF_MAX : (d > JPEG_COEF_MAX ? JPEG_COEF_MAX : d));
+}
+
+//** 列结果合法图像在 ±12000 以内；钳住以后行变换的中间值留在int32里
+//** Column results of valid images stay within ±12000; clamping keeps the row pass intermediates inside int32
+static inline int32_t jpeg_col(int32_t v) {
+    return v < -JPEG_COL_MAX ? -JPEG_COL_MAX : (v > JPEG_COL_MAX ? JPEG_COL_MAX : v);
+}
+
+static void jpeg_idct(const int16_t* in, uint8_t* out, uint16_t stride) {
+    int32_t ws[64];
+
+    //** 列 - 只有直流分量时直接展开 / Columns - DC-only columns expand directly
+    for (uint8_t c = 0; c < 8; c++) {
+        const int16_t* d = in + c;
+        int32_t* v = ws + c;
+        if (!d[8] && !d[16] && !d[24] && !d[32] && !d[40] && !d[48] && !d[56]) {
+            int32_t dc = d[0] * 4;
+            for (uint8_t r = 0; r < 8; r++) v[r * 8] = dc;
+            continue;
+        }
+        JPEG_IDCT_1D(d[0], d[8], d[16], d[24], d[32], d[40], d[48], d[56])
+        x0 += 512; x1 += 512; x2 += 512; x3 += 512;
+        v[0]  = jpeg_col((x0 + t3) >> 10);
+        v[56] = jpeg_col((x0 - t3) >> 10);
+        v[8]  = jpeg_col((x1 + t2) >> 10);
+        v[48] = jpeg_col((x1 - t2) >> 10);
+        v[16] = jpeg_col((x2 + t1) >> 10);
+        v[40] = jpeg_col((x2 - t1) >> 10);
+        v[24] = jpeg_col((x3 + t0) >> 10);
+        v[32] = jpeg_col((x3 - t0) >> 10);
+    }
+
+    //** 行 - 加128电平偏移 / Rows - add the 128 level shift
+    for (uint8_t r = 0; r < 8; r++, out += stride) {
+        const int32_t* v = ws + r * 8;
+        JPEG_IDCT_1D(v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7])
+        const int32_t bias = 65536 + (128 << 17);
+        x0 += bias; x1 += bias; x2 += bias; x3 += bias;
+        out[0] = jpeg_clamp((x0 + t3) >> 17);
+        out[7] = jpeg_clamp((x0 - t3) >> 17);
+        out[1] = jpeg_clamp((x1 + t2) >> 17);
+        out[6] = jpeg_clamp((x1 - t2) >> 17);
+        out[2] = jpeg_clamp((x2 + t1) >> 17);
+        out[5] = jpeg_clamp((x2 - t1) >> 17);
+        out[3] = jpeg_clamp((x3 + t0) >> 17);
+        out[4] = jpeg_clamp((x3 - t0) >> 17);
+    }
+}
+
+//** 解一个8x8块并反变换到样本平面 / Decode one 8x8 block and inverse-transform it into the sample plane
+static void jpeg_block(jpeg_t* j, jpeg_component_t* c, uint8_t* out, uint16_t stride) {
+    const jpeg_huff_t* dc = j->huff[c->td];
+    const jpeg_huff_t* ac = j->huff[2 + c->ta];
+    const uint16_t* q = j->qt[c->tq];
+    int16_t* coef = j->coef;
+    memset(coef, 0, 64 * sizeof(int16_t));
+
+    //** 直流类别最大11 (8位样本)，更大的会让jpeg_bits移位越界
+    //** The DC category is at most 11 for 8-bit samples; anything larger would over-shift jpeg_bits
+    uint8_t s = jpeg_decode(j, dc);
+    if (s > 11) {
+        display_image_fail(j->io, DISPLAY_IMAGE_ERR_CORRUPT);
+        return;
+    }
+    c->dc_pred = (int16_t)(c->dc_pred + jpeg_extend(jpeg_bits(j, s), s));
+    coef[0] = jpeg_dequant(c->dc_pred, q[0]);
+
+    for (uint8_t k = 1; k < 64;) {
+        uint8_t rs = jpeg_decode(j, ac);
+        uint8_t run = rs >> 4;
+        s = rs & 15;
+        if (s == 0) {
+            if (run != 15) break;     // 块结束 / end of block
+            k += 16;
+            continue;
+        }
+        k += run;
+        if (k > 63) {
+            display_image_fail(j->io, DISPLAY_IMAGE_ERR_CORRUPT);
+            return;
+        }
+        coef[jpeg_natural[k]] = jpeg_dequant(jpeg_extend(jpeg_bits(j, s), s), q[k]);
+        k++;
+    }
+
+    jpeg_idct(coef, out, stride);
+}
+
+//** ========================================
+//** 颜色转换 / Colour Conversion
+//** ========================================
+
+//** 一个MCU转成BGR565写进带缓冲 / One MCU converted to BGR565 into the band
+static void jpeg_mcu_to_band(jpeg_t* j, uint16_t* band, int16_t mcu_x) {
+    uint8_t mcu_w = (uint8_t)(8 * j->hmax);
+    uint8_t mcu_h = (uint8_t)(8 * j->vmax);
+    int16_t x0 = (int16_t)(mcu_x * mcu_w);
+    int16_t w = (j->width - x0 < mcu_w) ? (int16_t)(j->width - x0) : mcu_w;
+
+    const uint8_t* ys = j->comp[0].samples;
+    for (uint8_t row = 0; row < mcu_h; row++) {
+        uint16_t* dst = band + (int32_t)row * j->width + x0;
+        const uint8_t* yrow = ys + row * mcu_w;
+
+        if (j->ncomp == 1) {
+            for (int16_t i = 0; i < w; i++) dst[i] = display_px_pack_bgr565(yrow[i], yrow[i], yrow[i]);
+            continue;
+        }
+
+        const uint8_t* cb = j->comp[1].samples + (row >> (j->vmax - 1)) * 8;
+        const uint8_t* cr = j->comp[2].samples + (row >> (j->vmax - 1)) * 8;
+        for (int16_t i = 0; i < w; i++) {
+            int32_t y = yrow[i];
+            int32_t u = cb[i >> (j->hmax - 1)] - 128;
+            int32_t v = cr[i >> (j->hmax - 1)] - 128;
+            //** 16位定点的JFIF转换 / JFIF conversion in 16-bit fixed point
+            int32_t r = y + ((91881 * v + 32768) >> 16);
+            int32_t g = y - ((22554 * u + 46802 * v - 32768) >> 16);
+            int32_t b = y + ((116130 * u + 32768) >> 16);
+            dst[i] = display_px_pack_bgr565(jpeg_clamp(r), jpeg_clamp(g), jpeg_clamp(b));
+        }
+    }
+}
+
+//** ========================================
+//** 标记段 / Marker Segments
+//** ========================================
+
+static void jpeg_read_dqt(jpeg_t* j, uint16_t len) {
+    while (len > 0 && !j->io->error) {
+        uint8_t pq_tq = display_image_byte(j->io);
+        uint8_t tq = pq_tq & 15;
+        bool wide = (pq_tq >> 4) != 0;
+        if (tq > 3) {
+            display_image_fail(j->io, DISPLAY_IMAGE_ERR_CORRUPT);
+            return;
+        }
+        for (uint8_t k = 0; k < 64; k++) {
+            j->qt[tq][k] = wide ? display_image_be16(j->io) : display_image_byte(j->io);
+        }
+        uint16_t used = wide ? 129 : 65;
+        if (used > len) break;
+        len -= used;
+    }
+}
+
+static void jpeg_read_dht(jpeg_t* j, uint16_t len) {
+    while (len > 17 && !j->io->error) {
+        uint8_t tc_th = display_image_byte(j->io);
+        uint8_t tc = tc_th >> 4;
+        uint8_t th = tc_th & 15;
+        if (tc > 1 || th > 1) {
+            display_image_fail(j->io, DISPLAY_IMAGE_ERR_UNSUPPORTED);
+            return;
+        }
+
+        uint8_t counts[16];
+        uint16_t total = 0;
+        for (uint8_t i = 0; i < 16; i++) {
+            counts[i] = display_image_byte(j->io);
+            total += counts[i];
+        }
+        if (total > 256 || 17u + total > len) {
+            display_image_fail(j->io, DISPLAY_IMAGE_ERR_CORRUPT);
+            return;
+        }
+
+        jpeg_huff_t** slot = &j->huff[tc * 2 + th];
+        if (!*slot) *slot = (jpeg_huff_t*)display_image_alloc(j->io, sizeof(jpeg_huff_t));
+        if (!*slot) return;
+
+        for (uint16_t i = 0; i < total; i++) (*slot)->values[i] = display_image_byte(j->io);
+        if (!jpeg_build_huff(*slot, counts)) {
+            display_image_fail(j->io, DISPLAY_IMAGE_ERR_CORRUPT);
+            return;
+        }
+        len -= 17 + total;
+    }
+}
+
+static void jpeg_read_sof(jpeg_t* j) {
+    uint8_t precision = display_image_byte(j->io);
+    j->height = (int16_t)display_image_be16(j->io);
+    j->width = (int16_t)display_image_be16(j->io);
+    j->ncomp = display_image_byte(j->io);
+    if (j->io->error) return;
+
+    j->io->stats->width = j->width;
+    j->io->stats->height = j->height;
+    if (precision != 8 || (j->ncomp != 1 && j->ncomp != 3) || j->width <= 0 || j->height <= 0) {
+        display_image_fail(j->io, DISPLAY_IMAGE_ERR_UNSUPPORTED);
+        return;
+    }
+
+    for (uint8_t i = 0; i < j->ncomp; i++) {
+        jpeg_component_t* c = &j->comp[i];
+        c->id = display_image_byte(j->io);
+        uint8_t hv = display_image_byte(j->io);
+        c->h = hv >> 4;
+        c->v = hv & 15;
+        c->tq = display_image_byte(j->io) & 3;
+    }
+
+    //** 灰度图的MCU永远是一个块 / A greyscale MCU is always a single block
+    if (j->ncomp == 1) {
+        j->comp[0].h = j->comp[0].v = 1;
+    }
+
+    //** 只支持亮度1或2倍、色度1倍的采样 / Only luma 1x/2x with chroma 1x sampling
+    j->hmax = j->comp[0].h;
+    j->vmax = j->comp[0].v;
+    bool ok = j->hmax >= 1 && j->hmax <= 2 && j->vmax >= 1 && j->vmax <= 2;
+    for (uint8_t i = 1; i < j->ncomp; i++) {
+        ok = ok && j->comp[i].h == 1 && j->comp[i].v == 1;
+    }
+    if (!ok) {
+        display_image_fail(j->io, DISPLAY_IMAGE_ERR_UNSUPPORTED);
+        return;
+    }
+
+    for (uint8_t i = 0; i < j->ncomp; i++) {
+        jpeg_component_t* c = &j->comp[i];
+        c->samples = (uint8_t*)display_image_alloc(j->io, 64u * c->h * c->v);
+    }
+    j->coef = (int16_t*)display_image_alloc(j->io, 64 * sizeof(int16_t));
+    display_image_bands_alloc(j->io, j->width, (int16_t)(8 * j->vmax));
+    j->have_frame = true;
+}
+
+//** 重启标记 - 位缓冲清空，直流预测归零 / Restart marker - bit buffer flushed, DC predictors reset
+static void jpeg_restart(jpeg_t* j) {
+    j->bits = 0;
+    j->nbits = 0;
+    if (!j->marker) {
+        uint8_t b = display_image_byte(j->io);
+        while (b != 0xFF && !j->io->error) b = display_image_byte(j->io);
+        while (b == 0xFF && !j->io->error) b = display_image_byte(j->io);
+        j->marker = b;
+    }
+    if (j->marker < 0xD0 || j->marker > 0xD7) {
+        display_image_fail(j->io, DISPLAY_IMAGE_ERR_CORRUPT);
+        return;
+    }
+    j->marker = 0;
+    for (uint8_t i = 0; i < j->ncomp; i++) j->comp[i].dc_pred = 0;
+}
+
+static void jpeg_scan(jpeg_t* j) {
+    uint8_t ns = display_image_byte(j->io);
+    if (!j->have_frame || ns != j->ncomp) {
+        display_image_fail(j->io, DISPLAY_IMAGE_ERR_UNSUPPORTED);  // 非交错扫描 / non-interleaved scans
+        return;
+    }
+
+    for (uint8_t i = 0; i < ns; i++) {
+        uint8_t id = display_image_byte(j->io);
+        uint8_t tables = display_image_byte(j->io);
+        jpeg_component_t* c = NULL;
+        for (uint8_t k = 0; k < j->ncomp; k++) {
+            if (j->comp[k].id == id) c = &j->comp[k];
+        }
+        if (!c || (tables >> 4) > 1 || (tables & 15) > 1) {
+            display_image_fail(j->io, DISPLAY_IMAGE_ERR_CORRUPT);
+            return;
+        }
+        c->td = tables >> 4;
+        c->ta = tables & 15;
+        c->dc_pred = 0;
+        if (!j->huff[c->td] || !j->huff[2 + c->ta]) {
+            display_image_fail(j->io, DISPLAY_IMAGE_ERR_CORRUPT);
+            return;
+        }
+    }
+    display_image_skip(j->io, 3);  // Ss, Se, Ah/Al - 基线固定值 / fixed for baseline
+    if (j->io->error) return;
+
+    uint8_t mcu_w = (uint8_t)(8 * j->hmax);
+    uint8_t mcu_h = (uint8_t)(8 * j->vmax);
+    int16_t mcus_x = (int16_t)((j->width + mcu_w - 1) / mcu_w);
+    int16_t mcus_y = (int16_t)((j->height + mcu_h - 1) / mcu_h);
+    uint16_t until_restart = j->restart_interval;
+
+    for (int16_t my = 0; my < mcus_y && !j->io->error; my++) {
+        uint16_t* band = display_image_band(j->io);
+        for (int16_t mx = 0; mx < mcus_x && !j->io->error; mx++) {
+            if (j->restart_interval) {
+                if (until_restart == 0) {
+                    jpeg_restart(j);
+                    until_restart = j->restart_interval;
+                }
+                until_restart--;
+            }
+
+            for (uint8_t i = 0; i < j->ncomp; i++) {
+                jpeg_component_t* c = &j->comp[i];
+                uint16_t stride = (uint16_t)(8 * c->h);
+                for (uint8_t by = 0; by < c->v; by++) {
+                    for (uint8_t bx = 0; bx < c->h; bx++) {
+                        jpeg_block(j, c, c->samples + by * 8 * stride + bx * 8, stride);
+                    }
+                }
+            }
+            jpeg_mcu_to_band(j, band, mx);
+        }
+        if (j->io->error) return;
+
+        int16_t row = (int16_t)(my * mcu_h);
+        int16_t lines = (j->height - row < mcu_h) ? (int16_t)(j->height - row) : mcu_h;
+        display_image_band_emit(j->io, row, j->width, lines);
+    }
+}
+
+display_image_result_t display_image_jpeg(display_image_ctx_t* ctx) {
+    jpeg_t* j = (jpeg_t*)display_image_alloc(ctx, sizeof(jpeg_t));
+    if (!j) return ctx->error;
+    memset(j, 0, sizeof(*j));
+    j->io = ctx;
+
+    while (!ctx->error) {
+        uint8_t b = display_image_byte(ctx);
+        if (b != 0xFF) continue;                // 标记之间的垃圾 / junk between markers
+        uint8_t m = display_image_byte(ctx);
+        while (m == 0xFF && !ctx->error) m = display_image_byte(ctx);
+
+        if (m == 0xD8 || (m >= 0xD0 && m <= 0xD7) || m == 0x01) continue;  // 无长度的标记 / markers without length
+        if (m == 0xD9) break;
+
+        uint16_t len = display_image_be16(ctx);
+        if (len < 2) {
+            display_image_fail(ctx, DISPLAY_IMAGE_ERR_CORRUPT);
+            break;
+        }
+        len -= 2;
+
+        switch (m) {
+            case 0xC0:
+            case 0xC1:
+                jpeg_read_sof(j);
+                break;
+            case 0xC4:
+                jpeg_read_dht(j, len);
+                break;
+            case 0xDB:
+                jpeg_read_dqt(j, len);
+                break;
+            case 0xDD:
+                j->restart_interval = display_image_be16(ctx);
+                break;
+            case 0xDA:
+                jpeg_scan(j);
+                //** 基线只有一次扫描 - 帧完成即结束 / Baseline has one scan - done when the frame is
+                return ctx->error;
+            case 0xC2: case 0xC3: case 0xC5: case 0xC6: case 0xC7:
+            case 0xC9: case 0xCA: case 0xCB: case 0xCD: case 0xCE: case 0xCF:
+                display_image_fail(ctx, DISPLAY_IMAGE_ERR_UNSUPPORTED);  // 渐进/无损/算术编码 / progressive, lossless, arithmetic
+                break;
+            default:
+                display_image_skip(ctx, len);     // APPn, COM, ...
+                break;
+        }
+    }
+
+    //** 没有扫描就结束 / Ended without a scan
+    if (!ctx->error) display_image_fail(ctx, DISPLAY_IMAGE_ERR_CORRUPT);
+    return ctx->error;
+}
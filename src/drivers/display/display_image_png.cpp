@@ -0,0 +1,604 @@
+//** 非隔行PNG流式解码 / Streaming Non-Interlaced PNG Decoder
+//**
+//** IDAT数据边读边解压，每解出一行扫描线就反滤波、转换进带缓冲
+//** IDAT data is inflated while it is read; each completed scanline is unfiltered and converted into the band
+//**
+//** 内存: 32KB LZ77窗口 + 两行扫描线 + 两个带缓冲 / Memory: 32KB LZ77 window + two scanlines + two bands
+//** 不校验CRC和Adler-32 - 损坏的数据由解压自身发现
+//** CRC and Adler-32 are not verified - corrupt data is caught by inflate itself
+
+#include "display_image_internal.h"
+#include "display_pixels.h"
+#include <string.h>
+
+#define PNG_WINDOW_SIZE 32768u
+#define PNG_MAX_BITS 15
+#define PNG_FAST_BITS 9
+#define PNG_CHUNK(a, b, c, d) (((uint32_t)(a) << 24) | ((uint32_t)(b) << 16) | ((uint32_t)(c) << 8) | (uint32_t)(d))
+
+typedef struct {
+    uint16_t fast[1 << PNG_FAST_BITS];   // (长度 << 12) | 符号，0表示走慢路径 / (length << 12) | symbol, 0 = slow path
+    int16_t count[PNG_MAX_BITS + 1];
+    int16_t symbol[288];
+} png_huff_t;
+
+typedef struct {
+    display_image_ctx_t* io;
+
+    //** 图像参数 / Image parameters
+    int16_t width, height;
+    uint8_t depth;
+    uint8_t color_type;
+    uint8_t channels;
+    uint8_t filter_bpp;                  // 反滤波的字节距离 / byte distance used by the filters
+    uint32_t row_bytes;                  // 不含滤波类型字节 / excluding the filter-type byte
+    uint8_t palette[256][4];             // r, g, b, a
+
+    //** IDAT字节流 / IDAT byte stream
+    uint32_t idat_left;
+
+    //** 解压状态 / Inflate state
+    uint32_t bitbuf;
+    uint8_t bitcnt;
+    uint8_t* window;
+    uint32_t wpos;                       // 已输出的总字节数 / total bytes produced
+    png_huff_t lencode, distcode;
+
+    //** 扫描线组装 / Scanline assembly
+    uint8_t* cur;
+    uint8_t* prev;
+    uint32_t col;
+    int16_t row;
+    int16_t band_lines;                  // 每带行数 / lines per band
+    int16_t band_row;                    // 当前带已写行数 / lines written into the current band
+} png_t;
+
+//** ========================================
+//** IDAT字节流 - 跨块连续 / IDAT Byte Stream - Continuous Across Chunks
+//** ========================================
+
+static uint8_t png_idat_byte(png_t* p) {
+    while (p->idat_left == 0) {
+        display_image_skip(p->io, 4);    // 上一块的CRC / CRC of the previous chunk
+        uint32_t len = display_image_be32(p->io);
+        uint32_t type = display_image_be32(p->io);
+        if (p->io->error) return 0;
+        if (type != PNG_CHUNK('I', 'D', 'A', 'T')) {
+            display_image_fail(p->io, DISPLAY_IMAGE_ERR_CORRUPT);  // 数据没完IDAT就断了 / IDAT ran out early
+            return 0;
+        }
+        p->idat_left = len;
+    }
+    p->idat_left--;
+    return display_image_byte(p->io);
+}
+
+static void png_need(png_t* p, uint8_t n) {
+    while (p->bitcnt < n && !p->io->error) {
+        p->bitbuf |= (uint32_t)png_idat_byte(p) << p->bitcnt;
+        p->bitcnt += 8;
+    }
+}
+
+static uint32_t png_bits(png_t* p, uint8_t n) {
+    if (n == 0) return 0;
+    png_need(p, n);
+    uint32_t v = p->bitbuf & ((1u << n) - 1);
+    p->bitbuf >>= n;
+    p->bitcnt -= n;
+    return v;
+}
+
+//** ========================================
+//** 霍夫曼表 / Huffman Tables
+//** ========================================
+
+//** 由码长构造 - 过度分配的码长集是损坏 / Build from code lengths - an over-subscribed set is corrupt
+static bool png_build_huff(png_huff_t* h, const uint8_t* lengths, uint16_t n) {
+    int16_t offs[PNG_MAX_BITS + 1];
+    memset(h->count, 0, sizeof(h->count));
+    memset(h->fast, 0, sizeof(h->fast));
+
+    for (uint16_t s = 0; s < n; s++) h->count[lengths[s]]++;
+    if (h->count[0] == (int16_t)n) return true;  // 空表 - 只在不用时合法 / empty - fine as long as unused
+
+    int32_t left = 1;
+    for (uint8_t len = 1; len <= PNG_MAX_BITS; len++) {
+        left = (left << 1) - h->count[len];
+        if (left < 0) return false;
+    }
+
+    offs[1] = 0;
+    for (uint8_t len = 1; len < PNG_MAX_BITS; len++) offs[len + 1] = (int16_t)(offs[len] + h->count[len]);
+    for (uint16_t s = 0; s < n; s++) {
+        if (lengths[s]) h->symbol[offs[lengths[s]]++] = (int16_t)s;
+    }
+
+    //** 短码按位反转后展开成查找表 - deflate的码从低位开始读
+    //** Short codes are bit-reversed into the lookup table - deflate codes are read from the low bit
+    uint16_t code = 0;
+    uint16_t index = 0;
+    for (uint8_t len = 1; len <= PNG_FAST_BITS; len++) {
+        for (int16_t i = 0; i < h->count[len]; i++, code++, index++) {
+            uint16_t rev = 0;
+            for (uint8_t b = 0; b < len; b++) rev |= (uint16_t)(((code >> b) & 1) << (len - 1 - b));
+            for (uint16_t k = rev; k < (1u << PNG_FAST_BITS); k += (uint16_t)(1u << len)) {
+                h->fast[k] = (uint16_t)((len << 12) | h->symbol[index]);
+            }
+        }
+        code <<= 1;
+    }
+    return true;
+}
+
+static int16_t png_decode(png_t* p, const png_huff_t* h) {
+    png_need(p, 16);
+
+    uint16_t e = h->fast[p->bitbuf & ((1u << PNG_FAST_BITS) - 1)];
+    if (e) {
+        uint8_t len = (uint8_t)(e >> 12);
+        p->bitbuf >>= len;
+        p->bitcnt -= len;
+        return (int16_t)(e & 0x0FFF);
+    }
+
+    //** 长码逐位走规范码 / Long codes walk the canonical code bit by bit
+    int32_t code = 0, first = 0, index = 0;
+    for (uint8_t len = 1; len <= PNG_MAX_BITS; len++) {
+        code |= (int32_t)((p->bitbuf >> (len - 1)) & 1);
+        int32_t count = h->count[len];
+        if (code - count < first) {
+            p->bitbuf >>= len;
+            p->bitcnt -= len;
+            return h->symbol[index + (code - first)];
+        }
+        index += count;
+        first = (first + count) << 1;
+        code <<= 1;
+    }
+    display_image_fail(p->io, DISPLAY_IMAGE_ERR_CORRUPT);
+    return -1;
+}
+
+//** ========================================
+//** 扫描线 / Scanlines
+//** ========================================
+
+static inline uint8_t png_paeth(uint8_t a, uint8_t b, uint8_t c) {
+    int16_t pa = (int16_t)(b - c), pb = (int16_t)(a - c);
+    int16_t pc = (int16_t)(pa + pb);
+    if (pa < 0) pa = (int16_t)-pa;
+    if (pb < 0) pb = (int16_t)-pb;
+    if (pc < 0) pc = (int16_t)-pc;
+    if (pa <= pb && pa <= pc) return a;
+    return pb <= pc ? b : c;
+}
+
+static void png_unfilter(png_t* p) {
+    uint8_t* x = p->cur + 1;
+    const uint8_t* up = p->prev + 1;
+    uint8_t bpp = p->filter_bpp;
+
+    switch (p->cur[0]) {
+        case 0:
+            break;
+        case 1:
+            for (uint32_t i = bpp; i < p->row_bytes; i++) x[i] = (uint8_t)(x[i] + x[i - bpp]);
+            break;
+        case 2:
+            for (uint32_t i = 0; i < p->row_bytes; i++) x[i] = (uint8_t)(x[i] + up[i]);
+            break;
+        case 3:
+            for (uint32_t i = 0; i < p->row_bytes; i++) {
+                uint8_t a = i >= bpp ? x[i - bpp] : 0;
+                x[i] = (uint8_t)(x[i] + ((a + up[i]) >> 1));
+            }
+            break;
+        case 4:
+            for (uint32_t i = 0; i < p->row_bytes; i++) {
+                uint8_t a = i >= bpp ? x[i - bpp] : 0;
+                uint8_t c = i >= bpp ? up[i - bpp] : 0;
+                x[i] = (uint8_t)(x[i] + png_paeth(a, up[i], c));
+            }
+            break;
+        default:
+            display_image_fail(p->io, DISPLAY_IMAGE_ERR_CORRUPT);
+            break;
+    }
+}
+
+//** 第i个样本 - 16位取高字节，低位深度放大到8位
+//** Sample i - 16-bit takes the high byte, low depths are scaled up to 8 bits
+static inline uint8_t png_sample(const png_t* p, const uint8_t* data, uint32_t i, bool scale) {
+    switch (p->depth) {
+        case 16: return data[i * 2];
+        case 8:  return data[i];
+        default: {
+            uint32_t bit = i * p->depth;
+            uint8_t v = (uint8_t)((data[bit >> 3] >> (8 - p->depth - (bit & 7))) & ((1u << p->depth) - 1));
+            return scale ? (uint8_t)(v * (255 / ((1u << p->depth) - 1))) : v;
+        }
+    }
+}
+
+static inline uint8_t png_over_black(uint8_t c, uint8_t a) {
+    return (uint8_t)(((uint16_t)c * a + 127) / 255);
+}
+
+static void png_row_to_band(png_t* p) {
+    const uint8_t* data = p->cur + 1;
+    uint16_t* dst = display_image_band(p->io) + (int32_t)p->band_row * p->width;
+
+    for (int16_t i = 0; i < p->width; i++) {
+        uint8_t r, g, b, a = 255;
+        uint32_t s = (uint32_t)i * p->channels;
+        switch (p->color_type) {
+            case 0:
+                r = g = b = png_sample(p, data, s, true);
+                break;
+            case 2:
+                r = png_sample(p, data, s, false);
+                g = png_sample(p, data, s + 1, false);
+                b = png_sample(p, data, s + 2, false);
+                break;
+            case 3: {
+                const uint8_t* c = p->palette[png_sample(p, data, s, false)];
+                r = c[0]; g = c[1]; b = c[2]; a = c[3];
+                break;
+            }
+            case 4:
+                r = g = b = png_sample(p, data, s, false);
+                a = png_sample(p, data, s + 1, false);
+                break;
+            default:
+                r = png_sample(p, data, s, false);
+                g = png_sample(p, data, s + 1, false);
+                b = png_sample(p, data, s + 2, false);
+                a = png_sample(p, data, s + 3, false);
+                break;
+        }
+        if (a != 255) {
+            r = png_over_black(r, a);
+            g = png_over_black(g, a);
+            b = png_over_black(b, a);
+        }
+        dst[i] = display_px_pack_bgr565(r, g, b);
+    }
+}
+
+static void png_row_done(png_t* p) {
+    png_unfilter(p);
+    if (p->io->error) return;
+    png_row_to_band(p);
+
+    uint8_t* t = p->prev;
+    p->prev = p->cur;
+    p->cur = t;
+    p->col = 0;
+    p->row++;
+    p->band_row++;
+
+    if (p->band_row == p->band_lines || p->row == p->height) {
+        display_image_band_emit(p->io, (int16_t)(p->row - p->band_row), p->width, p->band_row);
+        p->band_row = 0;
+    }
+}
+
+//** 解压出的一个字节 - 进窗口，也进当前扫描线
+//** One inflated byte - into the window and into the current scanline
+static inline void png_out(png_t* p, uint8_t byte) {
+    p->window[p->wpos++ & (PNG_WINDOW_SIZE - 1)] = byte;
+    if (p->row >= p->height) return;  // 图像之后的多余数据 / surplus data after the image
+    p->cur[p->col++] = byte;
+    if (p->col == p->row_bytes + 1) png_row_done(p);
+}
+
+//** ========================================
+//** 解压 / Inflate
+//** ========================================
+
+static const uint16_t png_len_base[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const uint8_t png_len_extra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static const uint16_t png_dist_base[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+static const uint8_t png_dist_extra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+//** 位缓冲里可能还预取着整字节，先用完它们 / Whole bytes may still be prefetched in the bit buffer, use them first
+static uint8_t png_aligned_byte(png_t* p) {
+    return p->bitcnt ? (uint8_t)png_bits(p, 8) : png_idat_byte(p);
+}
+
+static void png_stored(png_t* p) {
+    png_bits(p, p->bitcnt & 7);  // 丢到字节边界 / discard to the byte boundary
+    uint16_t len = png_aligned_byte(p);
+    len |= (uint16_t)(png_aligned_byte(p) << 8);
+    uint16_t nlen = png_aligned_byte(p);
+    nlen |= (uint16_t)(png_aligned_byte(p) << 8);
+    if ((uint16_t)~nlen != len) {
+        display_image_fail(p->io, DISPLAY_IMAGE_ERR_CORRUPT);
+        return;
+    }
+    while (len-- && !p->io->error && p->row < p->height) png_out(p, png_aligned_byte(p));
+}
+
+static void png_codes(png_t* p) {
+    while (!p->io->error && p->row < p->height) {
+        int16_t sym = png_decode(p, &p->lencode);
+        if (sym < 0) return;
+        if (sym < 256) {
+            png_out(p, (uint8_t)sym);
+            continue;
+        }
+        if (sym == 256) return;
+
+        sym -= 257;
+        if (sym >= 29) {
+            display_image_fail(p->io, DISPLAY_IMAGE_ERR_CORRUPT);
+            return;
+        }
+        uint32_t len = png_len_base[sym] + png_bits(p, png_len_extra[sym]);
+
+        int16_t dsym = png_decode(p, &p->distcode);
+        if (dsym < 0 || dsym >= 30) {
+            display_image_fail(p->io, DISPLAY_IMAGE_ERR_CORRUPT);
+            return;
+        }
+        uint32_t dist = png_dist_base[dsym] + png_bits(p, png_dist_extra[dsym]);
+        if (dist > p->wpos) {
+            display_image_fail(p->io, DISPLAY_IMAGE_ERR_CORRUPT);
+            return;
+        }
+
+        while (len--) png_out(p, p->window[(p->wpos - dist) & (PNG_WINDOW_SIZE - 1)]);
+    }
+}
+
+static void png_fixed(png_t* p) {
+    uint8_t lengths[288];
+    uint16_t s = 0;
+    for (; s < 144; s++) lengths[s] = 8;
+    for (; s < 256; s++) lengths[s] = 9;
+    for (; s < 280; s++) lengths[s] = 7;
+    for (; s < 288; s++) lengths[s] = 8;
+    png_build_huff(&p->lencode, lengths, 288);
+    for (s = 0; s < 30; s++) lengths[s] = 5;
+    png_build_huff(&p->distcode, lengths, 30);
+    png_codes(p);
+}
+
+static void png_dynamic(png_t* p) {
+    static const uint8_t order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+    uint8_t lengths[288 + 32];
+
+    uint16_t nlen = (uint16_t)(png_bits(p, 5) + 257);
+    uint16_t ndist = (uint16_t)(png_bits(p, 5) + 1);
+    uint16_t ncode = (uint16_t)(png_bits(p, 4) + 4);
+    if (nlen > 286 || ndist > 30) {
+        display_image_fail(p->io, DISPLAY_IMAGE_ERR_CORRUPT);
+        return;
+    }
+
+    //** 码长的码长 - 借用距离表 / Code-length code - borrows the distance table
+    memset(lengths, 0, 19);
+    for (uint16_t i = 0; i < ncode; i++) lengths[order[i]] = (uint8_t)png_bits(p, 3);
+    if (!png_build_huff(&p->distcode, lengths, 19)) {
+        display_image_fail(p->io, DISPLAY_IMAGE_ERR_CORRUPT);
+        return;
+    }
+
+    uint16_t index = 0;
+    while (index < nlen + ndist && !p->io->error) {
+        int16_t sym = png_decode(p, &p->distcode);
+        if (sym < 0) return;
+        if (sym < 16) {
+            lengths[index++] = (uint8_t)sym;
+            continue;
+        }
+
+        uint8_t value = 0;
+        uint16_t repeat;
+        if (sym == 16) {
+            if (index == 0) {
+                display_image_fail(p->io, DISPLAY_IMAGE_ERR_CORRUPT);
+                return;
+            }
+            value = lengths[index - 1];
+            repeat = (uint16_t)(3 + png_bits(p, 2));
+        } else if (sym == 17) {
+            repeat = (uint16_t)(3 + png_bits(p, 3));
+        } else {
+            repeat = (uint16_t)(11 + png_bits(p, 7));
+        }
+        if (index + repeat > nlen + ndist) {
+            display_image_fail(p->io, DISPLAY_IMAGE_ERR_CORRUPT);
+            return;
+        }
+        while (repeat--) lengths[index++] = value;
+    }
+    if (p->io->error) return;
+
+    if (lengths[256] == 0 || !png_build_huff(&p->lencode, lengths, nlen) ||
+        !png_build_huff(&p->distcode, lengths + nlen, ndist)) {
+        display_image_fail(p->io, DISPLAY_IMAGE_ERR_CORRUPT);
+        return;
+    }
+    png_codes(p);
+}
+
+static void png_inflate(png_t* p) {
+    uint8_t cmf = png_idat_byte(p);
+    uint8_t flg = png_idat_byte(p);
+    if ((cmf & 15) != 8 || ((cmf << 8) | flg) % 31 != 0 || (flg & 0x20)) {
+        display_image_fail(p->io, DISPLAY_IMAGE_ERR_CORRUPT);
+        return;
+    }
+
+    bool last = false;
+    while (!last && !p->io->error && p->row < p->height) {
+        last = png_bits(p, 1) != 0;
+        switch (png_bits(p, 2)) {
+            case 0: png_stored(p); break;
+            case 1: png_fixed(p); break;
+            case 2: png_dynamic(p); break;
+            default: display_image_fail(p->io, DISPLAY_IMAGE_ERR_CORRUPT); break;
+        }
+    }
+
+    //** 压缩流结束了图像还没满 / Stream ended before the image was complete
+    if (!p->io->error && p->row < p->height) display_image_fail(p->io, DISPLAY_IMAGE_ERR_CORRUPT);
+}
+
+//** ========================================
+//** 块解析 / Chunk Parsing
+//** ========================================
+
+static bool png_read_ihdr(png_t* p, uint32_t len) {
+    uint32_t w = display_image_be32(p->io);
+    uint32_t h = display_image_be32(p->io);
+    p->depth = display_image_byte(p->io);
+    p->color_type = display_image_byte(p->io);
+    uint8_t compression = display_image_byte(p->io);
+    uint8_t filter = display_image_byte(p->io);
+    uint8_t interlace = display_image_byte(p->io);
+    if (p->io->error) return false;
+
+    if (len != 13 || w == 0 || h == 0 || compression || filter) {
+        display_image_fail(p->io, DISPLAY_IMAGE_ERR_CORRUPT);
+        return false;
+    }
+    if (interlace || w > 0x7FFF || h > 0x7FFF) {
+        display_image_fail(p->io, DISPLAY_IMAGE_ERR_UNSUPPORTED);
+        return false;
+    }
+
+    static const uint8_t channels[7] = { 1, 0, 3, 1, 2, 0, 4 };
+    uint8_t d = p->depth;
+    bool ok;
+    switch (p->color_type) {
+        case 0:  ok = d == 1 || d == 2 || d == 4 || d == 8 || d == 16; break;
+        case 3:  ok = d == 1 || d == 2 || d == 4 || d == 8; break;
+        case 2:
+        case 4:
+        case 6:  ok = d == 8 || d == 16; break;
+        default: ok = false; break;
+    }
+    if (!ok) {
+        display_image_fail(p->io, DISPLAY_IMAGE_ERR_CORRUPT);
+        return false;
+    }
+
+    p->width = (int16_t)w;
+    p->height = (int16_t)h;
+    p->io->stats->width = p->width;
+    p->io->stats->height = p->height;
+    p->channels = channels[p->color_type];
+    uint32_t bits_per_pixel = (uint32_t)p->channels * d;
+    p->filter_bpp = (uint8_t)(bits_per_pixel >= 8 ? bits_per_pixel / 8 : 1);
+    p->row_bytes = (w * bits_per_pixel + 7) / 8;
+    return true;
+}
+
+static void png_read_plte(png_t* p, uint32_t len) {
+    uint32_t n = len / 3;
+    for (uint32_t i = 0; i < n && !p->io->error; i++) {
+        uint8_t r = display_image_byte(p->io);
+        uint8_t g = display_image_byte(p->io);
+        uint8_t b = display_image_byte(p->io);
+        if (i < 256) {
+            p->palette[i][0] = r;
+            p->palette[i][1] = g;
+            p->palette[i][2] = b;
+        }
+    }
+    display_image_skip(p->io, len - n * 3);
+}
+
+//** 调色板透明度；灰度/RGB的色键透明不支持，当作不透明
+//** Palette alpha; colour-key transparency for grey/RGB is not supported and treated as opaque
+static void png_read_trns(png_t* p, uint32_t len) {
+    if (p->color_type != 3) {
+        display_image_skip(p->io, len);
+        return;
+    }
+    for (uint32_t i = 0; i < len && !p->io->error; i++) {
+        uint8_t a = display_image_byte(p->io);
+        if (i < 256) p->palette[i][3] = a;
+    }
+}
+
+//** 按剩余预算决定每带行数 / Lines per band follow the remaining budget
+static bool png_alloc_buffers(png_t* p) {
+    p->window = (uint8_t*)display_image_alloc(p->io, PNG_WINDOW_SIZE);
+    p->cur = (uint8_t*)display_image_alloc(p->io, p->row_bytes + 1);
+    p->prev = (uint8_t*)display_image_alloc(p->io, p->row_bytes + 1);
+    if (p->io->error) return false;
+    memset(p->prev, 0, p->row_bytes + 1);
+
+    uint32_t line_bytes = (uint32_t)p->width * sizeof(uint16_t) * 2;
+    uint32_t room = (p->io->pool_size - p->io->pool_used) / line_bytes;
+    p->band_lines = (int16_t)(room < DISPLAY_IMAGE_PNG_LINES ? room : DISPLAY_IMAGE_PNG_LINES);
+    if (p->band_lines > p->height) p->band_lines = p->height;
+    if (p->band_lines == 0) {
+        display_image_fail(p->io, DISPLAY_IMAGE_ERR_MEMORY);
+        return false;
+    }
+    return display_image_bands_alloc(p->io, p->width, p->band_lines);
+}
+
+display_image_result_t display_image_png(display_image_ctx_t* ctx) {
+    //** 签名剩下的6个字节 / The remaining 6 signature bytes
+    static const uint8_t signature[6] = { 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    for (uint8_t i = 0; i < 6; i++) {
+        if (display_image_byte(ctx) != signature[i]) {
+            display_image_fail(ctx, DISPLAY_IMAGE_ERR_FORMAT);
+            return ctx->error;
+        }
+    }
+
+    png_t* p = (png_t*)display_image_alloc(ctx, sizeof(png_t));
+    if (!p) return ctx->error;
+    memset(p, 0, sizeof(*p));
+    p->io = ctx;
+    for (uint16_t i = 0; i < 256; i++) p->palette[i][3] = 255;
+
+    bool have_header = false;
+    while (!ctx->error) {
+        uint32_t len = display_image_be32(ctx);
+        uint32_t type = display_image_be32(ctx);
+        if (ctx->error) break;
+
+        if (type == PNG_CHUNK('I', 'H', 'D', 'R')) {
+            have_header = png_read_ihdr(p, len);
+        } else if (type == PNG_CHUNK('P', 'L', 'T', 'E')) {
+            png_read_plte(p, len);
+        } else if (type == PNG_CHUNK('t', 'R', 'N', 'S')) {
+            png_read_trns(p, len);
+        } else if (type == PNG_CHUNK('I', 'D', 'A', 'T')) {
+            if (!have_header) {
+                display_image_fail(ctx, DISPLAY_IMAGE_ERR_CORRUPT);
+                break;
+            }
+            if (!png_alloc_buffers(p)) break;
+            p->idat_left = len;
+            png_inflate(p);
+            //** 图像完整就结束，不读IEND / Done once the image is complete, IEND is not read
+            return ctx->error;
+        } else if (type == PNG_CHUNK('I', 'E', 'N', 'D')) {
+            display_image_fail(ctx, DISPLAY_IMAGE_ERR_CORRUPT);
+            break;
+        } else {
+            display_image_skip(ctx, len);
+        }
+        display_image_skip(ctx, 4);  // CRC
+    }
+    return ctx->error;
+}
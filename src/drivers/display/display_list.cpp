@@ -0,0 +1,245 @@
+//** 保留模式显示列表实现 / Retained Display List Implementation
+//**
+//** 命令格式 - 16字节头 + 负载，4字节对齐 / Command format - 16-byte header + payload, 4-byte aligned
+//**   FILL: a,b,c,d = x,y,w,h          LINE: a,b,c,d = x0,y0,x1,y1
+//**   TEXT: a,b = x,y  font,size + 字符串 / string
+//**   BLIT: a,b,c,d = x,y,w,h  + 像素 / pixels
+
+#include "display_list.h"
+#include "display_raster.h"
+#include <string.h>
+
+typedef enum {
+    DISPLAY_CMD_FILL = 1,
+    DISPLAY_CMD_LINE,
+    DISPLAY_CMD_TEXT,
+    DISPLAY_CMD_BLIT
+} display_cmd_type_t;
+
+typedef struct {
+    uint8_t type;
+    uint8_t font;
+    uint8_t size;
+    uint8_t reserved;
+    uint32_t length;            // 含头部和填充 / including header and padding
+    int16_t a, b, c, d;
+    uint16_t fg, bg;
+} display_cmd_t;
+
+//** 回放操作 - 直线已拆成FILL / Playback op - lines already split into FILLs
+typedef struct {
+    uint8_t type;
+    uint8_t font;
+    uint8_t size;
+    display_rect_t r;
+    uint16_t fg, bg;
+    const void* data;
+} display_list_op_t;
+
+//** 回放批次 - 单线程使用，文件内静态 / Playback batch - single-threaded, file-static
+static display_list_op_t batch[DISPLAY_LIST_MAX_OPS];
+static uint8_t batch_count = 0;
+static display_list_t* batch_owner = NULL;
+
+#define FNV_OFFSET 2166136261u
+#define FNV_PRIME 16777619u
+
+static uint32_t fnv1a(uint32_t hash, const uint8_t* data, uint32_t len) {
+    for (uint32_t i = 0; i < len; i++) {
+        hash = (hash ^ data[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+//** ========================================
+//** 回放 - 合并与发出 / Playback - Merge and Emit
+//** ========================================
+
+static void batch_emit(void) {
+    const display_list_target_t* t = batch_owner->target;
+
+    for (uint8_t i = 0; i < batch_count; i++) {
+        const display_list_op_t* op = &batch[i];
+        switch (op->type) {
+            case DISPLAY_CMD_FILL:
+                t->fill(t->ctx, op->r.x, op->r.y, op->r.w, op->r.h, op->fg);
+                batch_owner->stats.windows_after++;
+                break;
+
+            case DISPLAY_CMD_BLIT:
+                t->blit(t->ctx, op->r.x, op->r.y, op->r.w, op->r.h, (const uint16_t*)op->data);
+                batch_owner->stats.windows_after++;
+                break;
+
+            case DISPLAY_CMD_TEXT:
+                t->text(t->ctx, op->r.x, op->r.y, (const char*)op->data, op->font, op->size, op->fg, op->bg);
+                batch_owner->stats.windows_after += strlen((const char*)op->data);
+                break;
+        }
+    }
+    batch_count = 0;
+}
+
+//** 两个同色填充的并集恰好是一个矩形时才能合并
+//** Two same-colour fills merge only when their union is exactly a rectangle
+static bool batch_mergeable(const display_list_op_t* a, const display_list_op_t* b) {
+    if (a->type != DISPLAY_CMD_FILL || b->type != DISPLAY_CMD_FILL || a->fg != b->fg) return false;
+
+    display_rect_t u = display_rect_union(&a->r, &b->r);
+    uint32_t covered = display_rect_area(&a->r) + display_rect_area(&b->r) - display_rect_overlap(&a->r, &b->r);
+    return display_rect_area(&u) == covered;
+}
+
+static void batch_add(const display_list_op_t* op) {
+    //** 往前找能合并的操作，遇到相交的就停 - 不能越过它
+    //** Look back for a merge partner, stop at the first overlap - we cannot move past it
+    if (op->type != DISPLAY_CMD_TEXT) {
+        for (int16_t i = (int16_t)batch_count - 1; i >= 0; i--) {
+            display_list_op_t* prev = &batch[i];
+            if (batch_mergeable(prev, op)) {
+                prev->r = display_rect_union(&prev->r, &op->r);
+                return;
+            }
+            //** 文字的范围未知，当作与一切相交 / Text bounds are unknown, treat as overlapping everything
+            if (prev->type == DISPLAY_CMD_TEXT || display_rect_overlap(&prev->r, &op->r)) break;
+        }
+    }
+
+    if (batch_count == DISPLAY_LIST_MAX_OPS) {
+        batch_emit();
+    }
+    batch[batch_count++] = *op;
+}
+
+static void line_run(void* ctx, int16_t x, int16_t y, int16_t w, int16_t h) {
+    display_list_op_t op = *(const display_list_op_t*)ctx;
+    op.r.x = x;
+    op.r.y = y;
+    op.r.w = w;
+    op.r.h = h;
+    batch_add(&op);
+}
+
+//** 单条命令进入批次 / One command into the batch
+static void play_command(const display_cmd_t* cmd, const void* payload) {
+    display_list_op_t op;
+    op.type = cmd->type;
+    op.font = cmd->font;
+    op.size = cmd->size;
+    op.r.x = cmd->a;
+    op.r.y = cmd->b;
+    op.r.w = cmd->c;
+    op.r.h = cmd->d;
+    op.fg = cmd->fg;
+    op.bg = cmd->bg;
+    op.data = payload;
+
+    if (cmd->type == DISPLAY_CMD_LINE) {
+        op.type = DISPLAY_CMD_FILL;
+        display_raster_line(cmd->a, cmd->b, cmd->c, cmd->d, line_run, &op);
+        return;
+    }
+    batch_add(&op);
+}
+
+static void play_arena(display_list_t* list) {
+    batch_owner = list;
+    uint32_t offset = 0;
+    while (offset < list->used) {
+        const display_cmd_t* cmd = (const display_cmd_t*)(list->arena + offset);
+        play_command(cmd, cmd + 1);
+        offset += cmd->length;
+    }
+    //** 负载指针指向arena，必须在arena重用前发出 / Payload pointers point into the arena, emit before reuse
+    batch_emit();
+}
+
+//** ========================================
+//** 录制 / Recording
+//** ========================================
+
+void display_list_init(display_list_t* list, uint8_t* arena, uint32_t capacity,
+                       const display_list_target_t* target) {
+    memset(list, 0, sizeof(*list));
+    list->arena = arena;
+    list->capacity = capacity;
+    list->target = target;
+}
+
+void display_list_begin(display_list_t* list) {
+    list->used = 0;
+    list->hash = FNV_OFFSET;
+    list->spilled = false;
+}
+
+static void record(display_list_t* list, display_cmd_t* cmd, const void* payload, uint32_t payload_len) {
+    cmd->reserved = 0;
+    cmd->length = (sizeof(display_cmd_t) + payload_len + 3u) & ~3u;
+    list->stats.commands++;
+
+    //** arena装不下 - 先把已录制的回放掉，本帧不再参与跳过判断
+    //** Arena full - play what we have, this frame no longer takes part in the skip check
+    if (list->used + cmd->length > list->capacity) {
+        play_arena(list);
+        list->used = 0;
+        list->spilled = true;
+    }
+
+    //** 比整个arena还大的命令直接回放 / A command larger than the whole arena plays directly
+    if (cmd->length > list->capacity) {
+        batch_owner = list;
+        play_command(cmd, payload);
+        batch_emit();
+        return;
+    }
+
+    uint8_t* dst = list->arena + list->used;
+    memcpy(dst, cmd, sizeof(display_cmd_t));
+    if (payload_len) memcpy(dst + sizeof(display_cmd_t), payload, payload_len);
+    memset(dst + sizeof(display_cmd_t) + payload_len, 0, cmd->length - sizeof(display_cmd_t) - payload_len);
+
+    list->hash = fnv1a(list->hash, dst, cmd->length);
+    list->used += cmd->length;
+}
+
+void display_list_fill(display_list_t* list, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    display_cmd_t cmd = { DISPLAY_CMD_FILL, 0, 0, 0, 0, x, y, w, h, color, 0 };
+    list->stats.windows_before++;
+    record(list, &cmd, NULL, 0);
+}
+
+void display_list_line(display_list_t* list, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+    display_cmd_t cmd = { DISPLAY_CMD_LINE, 0, 0, 0, 0, x0, y0, x1, y1, color, 0 };
+    list->stats.windows_before += display_raster_line(x0, y0, x1, y1, NULL, NULL);
+    record(list, &cmd, NULL, 0);
+}
+
+void display_list_text(display_list_t* list, int16_t x, int16_t y, const char* text, uint8_t font, uint8_t size,
+                       uint16_t fg, uint16_t bg) {
+    uint32_t len = (uint32_t)strlen(text);
+    display_cmd_t cmd = { DISPLAY_CMD_TEXT, font, size, 0, 0, x, y, 0, 0, fg, bg };
+    list->stats.windows_before += len;
+    record(list, &cmd, text, len + 1);
+}
+
+void display_list_blit(display_list_t* list, int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t* pixels) {
+    display_cmd_t cmd = { DISPLAY_CMD_BLIT, 0, 0, 0, 0, x, y, w, h, 0, 0 };
+    list->stats.windows_before++;
+    record(list, &cmd, pixels, (uint32_t)w * (uint32_t)h * sizeof(uint16_t));
+}
+
+bool display_list_end(display_list_t* list) {
+    if (!list->spilled && list->last_valid &&
+        list->hash == list->last_hash && list->used == list->last_used) {
+        list->stats.frames_skipped++;
+        return false;
+    }
+
+    play_arena(list);
+    list->stats.frames_played++;
+
+    list->last_hash = list->hash;
+    list->last_used = list->used;
+    list->last_valid = !list->spilled;
+    return true;
+}
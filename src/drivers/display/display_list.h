@@ -0,0 +1,76 @@
+#pragma once
+
+//** 保留模式显示列表 - 录制、合并、回放 / Retained Display List - Record, Merge, Play Back
+//**
+//** 设计要点 / Design Notes:
+//** 1. 命令录进调用者提供的字节缓冲(arena)，无动态分配
+//**    Commands are recorded into a caller-provided byte arena, no dynamic allocation
+//** 2. 回放时把直线拆成段，能拼成矩形的同色段合并成一个窗口
+//**    Playback splits lines into runs and merges same-colour runs that form a rectangle into one window
+//** 3. 合并只跨越不相交的命令，绘制顺序语义不变
+//**    Merging only moves across non-overlapping commands, painter's order is preserved
+//** 4. 与上一帧完全相同时跳过回放 / Playback is skipped when identical to the previous frame
+//** 5. 纯C数据，回放目标可替换 / Plain C data, replaceable playback target
+
+#include "display_dirty.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//** 合并窗口 - 回放时最多同时持有这么多个操作 / Merge window - ops held at once during playback
+#define DISPLAY_LIST_MAX_OPS 64
+
+//** 回放目标 - 设备上就是显示驱动 / Playback target - the display driver on device
+typedef struct {
+    void (*fill)(void* ctx, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    void (*blit)(void* ctx, int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t* pixels);
+    void (*text)(void* ctx, int16_t x, int16_t y, const char* text, uint8_t font, uint8_t size,
+                 uint16_t fg, uint16_t bg);
+    void* ctx;
+} display_list_target_t;
+
+typedef struct {
+    uint32_t commands;          // 录制的命令数 / commands recorded
+    uint32_t windows_before;    // 立即模式下的窗口数 / windows immediate mode would open
+    uint32_t windows_after;     // 合并后实际的窗口数 / windows actually opened after merging
+    uint32_t frames_played;
+    uint32_t frames_skipped;    // 与上一帧相同而跳过 / skipped as identical to the previous frame
+} display_list_stats_t;
+
+typedef struct {
+    uint8_t* arena;
+    uint32_t capacity;
+    uint32_t used;
+    uint32_t hash;              // 本帧命令流的FNV-1a / FNV-1a of this frame's command stream
+    uint32_t last_hash;
+    uint32_t last_used;
+    bool last_valid;
+    bool spilled;               // 本帧arena溢出过，已提前回放 / arena overflowed, partly played early
+    const display_list_target_t* target;
+    display_list_stats_t stats;
+} display_list_t;
+
+void display_list_init(display_list_t* list, uint8_t* arena, uint32_t capacity,
+                       const display_list_target_t* target);
+
+//** 一帧的录制 / Recording one frame
+void display_list_begin(display_list_t* list);
+void display_list_fill(display_list_t* list, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+void display_list_line(display_list_t* list, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+void display_list_text(display_list_t* list, int16_t x, int16_t y, const char* text, uint8_t font, uint8_t size,
+                       uint16_t fg, uint16_t bg);
+void display_list_blit(display_list_t* list, int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t* pixels);
+
+//** 结束录制并回放 - 返回false表示与上一帧相同已跳过
+//** End recording and play back - false means identical to the previous frame and skipped
+bool display_list_end(display_list_t* list);
+
+//** 屏幕被别人改过 - 下一帧必须回放 / Someone else drew on the screen - next frame must play
+static inline void display_list_invalidate(display_list_t* list) { list->last_valid = false; }
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,210 @@
+//** 像素格式转换内核实现 / Pixel-Format Conversion Kernels Implementation
+//**
+//** 字并行版本在32位字里同时处理两个像素，只有对齐时才走宽路径
+//** Word-parallel versions process two pixels inside one 32-bit word, taking the wide path only when aligned
+//** (Xtensa上非对齐的32位访问会异常 / unaligned 32-bit accesses fault on Xtensa)
+
+#include "display_pixels.h"
+
+#define PX_LITTLE_ENDIAN (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+
+static inline bool px_aligned(const void* p) {
+    return ((uintptr_t)p & 3u) == 0;
+}
+
+//** ========================================
+//** 标量版本 - 标准答案 / Scalar Versions - the Reference
+//** ========================================
+
+void display_px_rgb888_to_bgr565_scalar(uint16_t* dst, const uint8_t* src, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++, src += 3) {
+        dst[i] = display_px_pack_bgr565(src[0], src[1], src[2]);
+    }
+}
+
+void display_px_swap_bytes_scalar(uint16_t* dst, const uint16_t* src, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        uint16_t c = src[i];
+        dst[i] = (uint16_t)((c << 8) | (c >> 8));
+    }
+}
+
+void display_px_swap_channels_scalar(uint16_t* dst, const uint16_t* src, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        uint16_t c = src[i];
+        dst[i] = (uint16_t)((c & 0x07E0) | (c >> 11) | ((c & 0x001F) << 11));
+    }
+}
+
+//** ========================================
+//** 字并行版本 / Word-Parallel Versions
+//** ========================================
+
+void display_px_rgb888_to_bgr565_wide(uint16_t* dst, const uint8_t* src, uint32_t count) {
+#if PX_LITTLE_ENDIAN
+    //** 跳过k个像素后dst和src都对齐 - 四个像素内找不到就全走标量
+    //** After k pixels both dst and src are aligned - if no k within four pixels, go all scalar
+    uint32_t k = 0;
+    while (k < 4 && !(px_aligned(dst + k) && px_aligned(src + 3 * k))) k++;
+    if (k == 4 || k > count) k = count;
+
+    display_px_rgb888_to_bgr565_scalar(dst, src, k);
+    dst += k;
+    src += 3 * k;
+    count -= k;
+
+    //** 三个字 = 四个像素 / Three words = four pixels
+    //**   w0 = r0 g0 b0 r1   w1 = g1 b1 r2 g2   w2 = b2 r3 g3 b3  (低字节在前 / low byte first)
+    const uint32_t* in = (const uint32_t*)src;
+    uint32_t* out = (uint32_t*)dst;
+    for (; count >= 4; count -= 4, in += 3, out += 2) {
+        uint32_t w0 = in[0], w1 = in[1], w2 = in[2];
+        uint32_t p0 = display_px_pack_bgr565((uint8_t)w0, (uint8_t)(w0 >> 8), (uint8_t)(w0 >> 16));
+        uint32_t p1 = display_px_pack_bgr565((uint8_t)(w0 >> 24), (uint8_t)w1, (uint8_t)(w1 >> 8));
+        uint32_t p2 = display_px_pack_bgr565((uint8_t)(w1 >> 16), (uint8_t)(w1 >> 24), (uint8_t)w2);
+        uint32_t p3 = display_px_pack_bgr565((uint8_t)(w2 >> 8), (uint8_t)(w2 >> 16), (uint8_t)(w2 >> 24));
+        out[0] = p0 | (p1 << 16);
+        out[1] = p2 | (p3 << 16);
+    }
+    display_px_rgb888_to_bgr565_scalar((uint16_t*)out, (const uint8_t*)in, count);
+#else
+    display_px_rgb888_to_bgr565_scalar(dst, src, count);
+#endif
+}
+
+//** 两个16位像素的公共前奏：对齐dst，src跟着对齐才走宽路径
+//** Shared prologue for 16-bit kernels: align dst, go wide only if src lines up too
+static bool px_wide_prologue(uint16_t** dst, const uint16_t** src, uint32_t* count,
+                             void (*scalar)(uint16_t*, const uint16_t*, uint32_t)) {
+    if (*count && !px_aligned(*dst)) {
+        scalar(*dst, *src, 1);
+        (*dst)++;
+        (*src)++;
+        (*count)--;
+    }
+    if (!px_aligned(*src)) {
+        scalar(*dst, *src, *count);
+        return false;
+    }
+    return true;
+}
+
+void display_px_swap_bytes_wide(uint16_t* dst, const uint16_t* src, uint32_t count) {
+    if (!px_wide_prologue(&dst, &src, &count, display_px_swap_bytes_scalar)) return;
+
+    const uint32_t* in = (const uint32_t*)src;
+    uint32_t* out = (uint32_t*)dst;
+    for (; count >= 2; count -= 2) {
+        uint32_t w = *in++;
+        *out++ = ((w & 0x00FF00FFu) << 8) | ((w >> 8) & 0x00FF00FFu);
+    }
+    display_px_swap_bytes_scalar((uint16_t*)out, (const uint16_t*)in, count);
+}
+
+void display_px_swap_channels_wide(uint16_t* dst, const uint16_t* src, uint32_t count) {
+    if (!px_wide_prologue(&dst, &src, &count, display_px_swap_channels_scalar)) return;
+
+    const uint32_t* in = (const uint32_t*)src;
+    uint32_t* out = (uint32_t*)dst;
+    for (; count >= 2; count -= 2) {
+        uint32_t w = *in++;
+        *out++ = (w & 0x07E007E0u) | ((w >> 11) & 0x001F001Fu) | ((w & 0x001F001Fu) << 11);
+    }
+    display_px_swap_channels_scalar((uint16_t*)out, (const uint16_t*)in, count);
+}
+
+//** ========================================
+//** PIE版本 - ESP32-S3的128位向量指令 / PIE Version - ESP32-S3 128-Bit Vector Instructions
+//** ========================================
+
+#if DISPLAY_PIXELS_PIE
+static inline bool px_aligned16(const void* p) {
+    return ((uintptr_t)p & 15u) == 0;
+}
+
+//** 每步32字节：VUNZIP把低字节和高字节分到两个寄存器，VZIP反过来交织回去
+//** 32 bytes per step: VUNZIP splits low and high bytes into two registers, VZIP interleaves them back the other
+//** way round
+//**   q0 = lo0 hi0 lo1 hi1 ...   ->   q0 = lo0 lo1 ...  q1 = hi0 hi1 ...   ->   hi0 lo0 hi1 lo1 ...
+void display_px_swap_bytes_pie(uint16_t* dst, const uint16_t* src, uint32_t count) {
+    //** VLD/VST忽略地址低4位 - dst先对齐到16字节，src跟着对齐才走向量路径
+    //** VLD/VST ignore the low 4 address bits - align dst to 16 bytes first, go vector only if src lines up too
+    while (count && !px_aligned16(dst)) {
+        display_px_swap_bytes_scalar(dst++, src++, 1);
+        count--;
+    }
+    if (!px_aligned16(src)) {
+        display_px_swap_bytes_wide(dst, src, count);
+        return;
+    }
+
+    for (uint32_t blocks = count / 16; blocks; blocks--) {
+        __asm__ volatile(
+            "ee.vld.128.ip q0, %0, 16\n"
+            "ee.vld.128.ip q1, %0, 16\n"
+            "ee.vunzip.8 q0, q1\n"
+            "ee.vzip.8 q1, q0\n"
+            "ee.vst.128.ip q1, %1, 16\n"
+            "ee.vst.128.ip q0, %1, 16\n"
+            : "+r"(src), "+r"(dst)
+            :
+            : "memory");
+    }
+    display_px_swap_bytes_wide(dst, src, count % 16);
+}
+
+//** 第一次调用时选实现 - 用奇数长度和原地两种情况对一遍标量版
+//** Pick the implementation on the first call - checked against scalar with an odd length and in place
+static void px_swap_bytes_select(uint16_t* dst, const uint16_t* src, uint32_t count);
+static void (*px_swap_bytes_impl)(uint16_t*, const uint16_t*, uint32_t) = px_swap_bytes_select;
+
+static void px_swap_bytes_select(uint16_t* dst, const uint16_t* src, uint32_t count) {
+    static uint16_t in[72] __attribute__((aligned(16)));
+    static uint16_t got[72] __attribute__((aligned(16)));
+    static uint16_t want[72];
+    for (uint32_t i = 0; i < 72; i++) in[i] = (uint16_t)(i * 0x9E37u + 0x1234u);
+    display_px_swap_bytes_scalar(want, in, 72);
+
+    //** 对齐、错开一个像素、原地 / Aligned, one pixel off, in place
+    bool ok = true;
+    display_px_swap_bytes_pie(got, in, 71);
+    for (uint32_t i = 0; i < 71; i++) ok = ok && got[i] == want[i];
+    display_px_swap_bytes_pie(got + 1, in + 1, 71);
+    for (uint32_t i = 1; i < 72; i++) ok = ok && got[i] == want[i];
+    display_px_swap_bytes_pie(in, in, 72);
+    for (uint32_t i = 0; i < 72; i++) ok = ok && in[i] == want[i];
+
+    px_swap_bytes_impl = ok ? display_px_swap_bytes_pie : display_px_swap_bytes_wide;
+    px_swap_bytes_impl(dst, src, count);
+}
+#endif
+
+//** ========================================
+//** 公共入口 / Public Entry Points
+//** ========================================
+
+void display_px_rgb888_to_bgr565(uint16_t* dst, const uint8_t* src, uint32_t count) {
+#if DISPLAY_PIXELS_WIDE
+    display_px_rgb888_to_bgr565_wide(dst, src, count);
+#else
+    display_px_rgb888_to_bgr565_scalar(dst, src, count);
+#endif
+}
+
+void display_px_swap_bytes(uint16_t* dst, const uint16_t* src, uint32_t count) {
+#if DISPLAY_PIXELS_PIE
+    px_swap_bytes_impl(dst, src, count);
+#elif DISPLAY_PIXELS_WIDE
+    display_px_swap_bytes_wide(dst, src, count);
+#else
+    display_px_swap_bytes_scalar(dst, src, count);
+#endif
+}
+
+void display_px_swap_channels(uint16_t* dst, const uint16_t* src, uint32_t count) {
+#if DISPLAY_PIXELS_WIDE
+    display_px_swap_channels_wide(dst, src, count);
+#else
+    display_px_swap_channels_scalar(dst, src, count);
+#endif
+}
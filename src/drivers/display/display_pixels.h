@@ -0,0 +1,79 @@
+#pragma once
+
+//** 像素格式转换内核 / Pixel-Format Conversion Kernels
+//**
+//** 设计要点 / Design Notes:
+//** 1. 面板是BGR565 - 红色在低5位，见 DISPLAY_RED / Panel is BGR565 - red in the low 5 bits, see DISPLAY_RED
+//** 2. 每个内核都有标量版本，作为结果的标准答案
+//**    Every kernel has a scalar version that defines the correct result
+//** 3. 字并行版本一次处理两个(RGB888为四个)像素，结果与标量版逐位相同
+//**    Word-parallel versions handle two (four for RGB888) pixels per step, bit-identical to scalar
+//** 4. 16位内核可以原地转换(dst == src)，但不能部分重叠
+//**    16-bit kernels may run in place (dst == src) but buffers must not partially overlap
+//** 5. ESP32-S3上字节交换还有PIE(128位向量)版本，第一次调用时和标量版对一遍，不一致就退回字并行版
+//**    On ESP32-S3 the byte swap also has a PIE (128-bit vector) version; the first call checks it against
+//**    scalar and falls back to word-parallel if they disagree
+
+#include <stdint.h>
+
+//** CONFIG_IDF_TARGET_ESP32S3 只在sdkconfig.h里，没有编译参数定义它；不先包含的话固件走标量版，
+//** 而且先包含Arduino.h的文件和没包含的文件看到的开关不一样
+//** CONFIG_IDF_TARGET_ESP32S3 only comes from sdkconfig.h and no build flag defines it; without this include
+//** the firmware builds the scalar kernels, and files that include Arduino.h first see different switches
+#ifdef ESP_PLATFORM
+#include "sdkconfig.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//** ESP32-S3上默认走字并行版本 / Word-parallel versions are the default on ESP32-S3
+#ifndef DISPLAY_PIXELS_WIDE
+#if defined(CONFIG_IDF_TARGET_ESP32S3) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define DISPLAY_PIXELS_WIDE 1
+#else
+#define DISPLAY_PIXELS_WIDE 0
+#endif
+#endif
+
+//** ESP32-S3上字节交换默认走PIE / The byte swap uses PIE by default on ESP32-S3
+#ifndef DISPLAY_PIXELS_PIE
+#if defined(CONFIG_IDF_TARGET_ESP32S3)
+#define DISPLAY_PIXELS_PIE 1
+#else
+#define DISPLAY_PIXELS_PIE 0
+#endif
+#endif
+
+//** 单个像素打包成BGR565 / Pack one pixel into BGR565
+static inline uint16_t display_px_pack_bgr565(uint8_t r, uint8_t g, uint8_t b) {
+    return (uint16_t)(((uint16_t)(b >> 3) << 11) | ((uint16_t)(g >> 2) << 5) | (r >> 3));
+}
+
+//** RGB888(每像素r,g,b三字节) -> BGR565本机字节序 / RGB888 (r,g,b bytes per pixel) -> BGR565 native order
+void display_px_rgb888_to_bgr565(uint16_t* dst, const uint8_t* src, uint32_t count);
+
+//** 16位像素高低字节交换 - 本机字节序 <-> 线上字节序
+//** Swap the two bytes of each 16-bit pixel - native order <-> wire order
+void display_px_swap_bytes(uint16_t* dst, const uint16_t* src, uint32_t count);
+
+//** 红蓝通道交换 - RGB565 <-> BGR565 / Swap red and blue channels - RGB565 <-> BGR565
+void display_px_swap_channels(uint16_t* dst, const uint16_t* src, uint32_t count);
+
+//** 两种实现都导出，方便逐位比较 / Both implementations are exported for bit-for-bit comparison
+void display_px_rgb888_to_bgr565_scalar(uint16_t* dst, const uint8_t* src, uint32_t count);
+void display_px_swap_bytes_scalar(uint16_t* dst, const uint16_t* src, uint32_t count);
+void display_px_swap_channels_scalar(uint16_t* dst, const uint16_t* src, uint32_t count);
+
+void display_px_rgb888_to_bgr565_wide(uint16_t* dst, const uint8_t* src, uint32_t count);
+void display_px_swap_bytes_wide(uint16_t* dst, const uint16_t* src, uint32_t count);
+void display_px_swap_channels_wide(uint16_t* dst, const uint16_t* src, uint32_t count);
+
+#if DISPLAY_PIXELS_PIE
+void display_px_swap_bytes_pie(uint16_t* dst, const uint16_t* src, uint32_t count);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,45 @@
+//** 光栅化辅助实现 / Raster Helpers Implementation
+
+#include "display_raster.h"
+#include <stdlib.h>
+
+uint16_t display_raster_line(int16_t x0, int16_t y0, int16_t x1, int16_t y1, display_run_fn run, void* ctx) {
+    bool steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep) {
+        int16_t t;
+        t = x0; x0 = y0; y0 = t;
+        t = x1; x1 = y1; y1 = t;
+    }
+    if (x0 > x1) {
+        int16_t t;
+        t = x0; x0 = x1; x1 = t;
+        t = y0; y0 = y1; y1 = t;
+    }
+
+    int16_t dx = x1 - x0;
+    int16_t dy = abs(y1 - y0);
+    int16_t err = dx >> 1;
+    int16_t ystep = (y0 < y1) ? 1 : -1;
+    int16_t run_start = x0;
+    uint16_t runs = 0;
+
+    for (int16_t x = x0; x <= x1; x++) {
+        err -= dy;
+        if (err < 0 || x == x1) {
+            //** 一段结束 - steep时段是竖直的 / Run ends - vertical when steep
+            int16_t len = x - run_start + 1;
+            if (run) {
+                if (steep) {
+                    run(ctx, y0, run_start, 1, len);
+                } else {
+                    run(ctx, run_start, y0, len, 1);
+                }
+            }
+            runs++;
+            y0 += ystep;
+            err += dx;
+            run_start = x + 1;
+        }
+    }
+    return runs;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+//** 光栅化辅助 - 图元拆成矩形段 / Raster Helpers - Primitives Split into Rectangular Runs
+//**
+//** 所有图元最终都是一串矩形填充 / Every primitive ends up as a sequence of rectangle fills
+//** 纯C数据，不依赖Arduino / Plain C data, no Arduino dependency
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*display_run_fn)(void* ctx, int16_t x, int16_t y, int16_t w, int16_t h);
+
+//** Bresenham直线 - 拆成水平段(陡峭时为竖直段)，与TFT_eSPI的drawLine窗口数相同
+//** Bresenham line - split into horizontal runs (vertical when steep), same window count as TFT_eSPI's drawLine
+//** 返回段数 / Returns the number of runs
+uint16_t display_raster_line(int16_t x0, int16_t y0, int16_t x1, int16_t y1, display_run_fn run, void* ctx);
+
+#ifdef __cplusplus
+}
+#endif
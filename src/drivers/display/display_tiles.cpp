@@ -0,0 +1,78 @@
+//** 图块哈希变化检测实现 / Tile-Hash Change Detection Implementation
+
+#include "display_tiles.h"
+#include <string.h>
+
+void display_tiles_init(display_tiles_t* tiles) {
+    memset(tiles, 0, sizeof(*tiles));
+}
+
+void display_tiles_invalidate(display_tiles_t* tiles) {
+    memset(tiles->valid, 0, sizeof(tiles->valid));
+}
+
+//** 每次吃两个像素的乘法哈希 - 一个16x16图块128次乘法
+//** Multiplicative hash eating two pixels at a time - 128 multiplies per 16x16 tile
+static uint32_t display_tile_hash(const display_fb_t* fb, const display_rect_t* r) {
+    uint32_t h = 2166136261u;
+    for (int16_t row = 0; row < r->h; row++) {
+        const uint16_t* p = display_fb_at(fb, r->x, r->y + row);
+        int16_t i = 0;
+        for (; i + 1 < r->w; i += 2) {
+            h = (h ^ ((uint32_t)p[i] | ((uint32_t)p[i + 1] << 16))) * 16777619u;
+        }
+        if (i < r->w) {
+            h = (h ^ p[i]) * 16777619u;
+        }
+    }
+    return h;
+}
+
+void display_tiles_filter(display_tiles_t* tiles, const display_fb_t* fb,
+                          const display_dirty_t* in, display_dirty_t* out) {
+    //** 一个图块可能被多个脏矩形覆盖 - 每帧只看一次
+    //** A tile may sit under several dirty rects - look at it once per frame
+    bool seen[DISPLAY_TILES_Y][DISPLAY_TILES_X];
+    memset(seen, 0, sizeof(seen));
+
+    display_tile_stats_t frame = { 1, 0, 0, 0 };
+    display_dirty_clear(out);
+
+    for (uint8_t i = 0; i < in->count; i++) {
+        const display_rect_t* d = &in->rects[i];
+        int16_t tx0 = d->x / DISPLAY_TILE_SIZE;
+        int16_t ty0 = d->y / DISPLAY_TILE_SIZE;
+        int16_t tx1 = (d->x + d->w - 1) / DISPLAY_TILE_SIZE;
+        int16_t ty1 = (d->y + d->h - 1) / DISPLAY_TILE_SIZE;
+
+        for (int16_t ty = ty0; ty <= ty1; ty++) {
+            for (int16_t tx = tx0; tx <= tx1; tx++) {
+                if (seen[ty][tx]) continue;
+                seen[ty][tx] = true;
+
+                display_rect_t tile = { (int16_t)(tx * DISPLAY_TILE_SIZE), (int16_t)(ty * DISPLAY_TILE_SIZE),
+                                        DISPLAY_TILE_SIZE, DISPLAY_TILE_SIZE };
+                display_rect_clip(&tile, fb->width, fb->height);
+
+                uint32_t h = display_tile_hash(fb, &tile);
+                frame.tiles_hashed++;
+                if (tiles->valid[ty][tx] && tiles->hash[ty][tx] == h) continue;
+
+                tiles->hash[ty][tx] = h;
+                tiles->valid[ty][tx] = true;
+                frame.tiles_sent++;
+                display_dirty_add(out, &tile);
+            }
+        }
+    }
+
+    uint32_t before = display_dirty_area(in);
+    uint32_t after = display_dirty_area(out);
+    frame.bytes_saved = before > after ? (before - after) * sizeof(uint16_t) : 0;
+
+    tiles->last = frame;
+    tiles->total.frames++;
+    tiles->total.tiles_hashed += frame.tiles_hashed;
+    tiles->total.tiles_sent += frame.tiles_sent;
+    tiles->total.bytes_saved += frame.bytes_saved;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+//** 图块哈希变化检测 - 整屏重绘只发送真正变了的图块
+//** Tile-Hash Change Detection - Full Redraws Send Only Tiles That Really Changed
+//**
+//** 设计要点 / Design Notes:
+//** 1. 屏幕切成16x16图块，每块保存上次发送内容的32位哈希
+//**    Screen cut into 16x16 tiles, each keeps a 32-bit hash of what was last sent
+//** 2. 只对脏矩形覆盖的图块做哈希 / Only tiles touched by dirty rectangles are hashed
+//** 3. 变了的图块重新进脏列表，相邻图块在那里合并
+//**    Changed tiles go back into a dirty list, where neighbouring tiles merge
+//** 4. 哈希碰撞会留下一个旧图块 - 32位下可以接受
+//**    A hash collision leaves one stale tile - acceptable at 32 bits
+
+#include "display_framebuffer.h"
+#include "hardware_config.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DISPLAY_TILE_SIZE 16
+#define DISPLAY_TILES_X ((HW_DISPLAY_WIDTH + DISPLAY_TILE_SIZE - 1) / DISPLAY_TILE_SIZE)
+#define DISPLAY_TILES_Y ((HW_DISPLAY_HEIGHT + DISPLAY_TILE_SIZE - 1) / DISPLAY_TILE_SIZE)
+
+typedef struct {
+    uint32_t frames;
+    uint32_t tiles_hashed;
+    uint32_t tiles_sent;
+    uint32_t bytes_saved;       // 相对于直接推送脏矩形 / relative to pushing the dirty rects as-is
+} display_tile_stats_t;
+
+typedef struct {
+    uint32_t hash[DISPLAY_TILES_Y][DISPLAY_TILES_X];
+    bool valid[DISPLAY_TILES_Y][DISPLAY_TILES_X];
+    display_tile_stats_t last;  // 最近一帧 / most recent frame
+    display_tile_stats_t total;
+} display_tiles_t;
+
+void display_tiles_init(display_tiles_t* tiles);
+
+//** 面板内容未知 - 下一帧所有被触及的图块都发送 / Panel content unknown - every touched tile is sent next frame
+void display_tiles_invalidate(display_tiles_t* tiles);
+
+//** 把脏列表过滤成只含变化图块的列表 / Filter a dirty list down to the tiles that changed
+void display_tiles_filter(display_tiles_t* tiles, const display_fb_t* fb,
+                          const display_dirty_t* in, display_dirty_t* out);
+
+#ifdef __cplusplus
+}
+#endif
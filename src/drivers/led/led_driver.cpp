@@ -2,22 +2,138 @@
 //** "Bad programmers worry about the code. Good programmers worry about data structures."
 
 #include "led_driver.h"
+#include <Arduino.h>
 #include <FastLED.h>
+#include <string.h>
 #include "core/config/hardware_config.h"
+#include "led_rmt.h"
+
+#if HW_LED_RMT_ASYNC
+#include <driver/rmt.h>
+#endif
 
 //** 唯一的数据结构 - LED数组
 static CRGB leds[HW_LED_COUNT];
 
+//** 上次真正发出去的帧 - 和它一样就不再发
+//** WS2812每次show都要关中断重发整条灯带，主循环每10ms都会设一次颜色
+static CRGB shown[HW_LED_COUNT];
+static uint8_t shown_brightness;
+static uint32_t shown_us;
+static led_stats_t stats;
+
+#define LED_MIN_SHOW_US (1000000UL / HW_LED_MAX_REFRESH_HZ)
+
+#if HW_LED_RMT_ASYNC
+//** ========================================
+//** 非阻塞发送 - 提前编码成RMT符号，两块缓冲轮流用
+//** ========================================
+
+#define LED_RMT_SYMBOL_COUNT LED_RMT_SYMBOLS(HW_LED_COUNT)
+
+static const led_rmt_timing_t rmt_timing = LED_RMT_TIMING_WS2812;
+static rmt_item32_t rmt_symbols[2][LED_RMT_SYMBOL_COUNT];
+static uint8_t rmt_sending = 1;     // 正在发(或最后发过)的缓冲，编码总是写另一块
+static bool rmt_queued = false;     // 另一块已编码，等通道空闲
+
+static bool rmt_busy(void) {
+    return rmt_wait_tx_done((rmt_channel_t)HW_LED_RMT_CHANNEL, 0) != ESP_OK;
+}
+
+//** 通道空了就把排队的帧发出去 - 立即返回
+static void rmt_pump(void) {
+    if (!rmt_queued || rmt_busy()) return;
+    rmt_sending ^= 1;
+    rmt_queued = false;
+    rmt_write_items((rmt_channel_t)HW_LED_RMT_CHANNEL, rmt_symbols[rmt_sending], LED_RMT_SYMBOL_COUNT, false);
+}
+
+static void rmt_transmit(void) {
+    //** 排队的帧还没发 - 直接覆盖，新帧优先
+    if (rmt_queued) {
+        stats.replaced++;
+    }
+
+    led_color_t frame[HW_LED_COUNT];
+    for (uint8_t i = 0; i < HW_LED_COUNT; i++) {
+        frame[i].r = leds[i].r;
+        frame[i].g = leds[i].g;
+        frame[i].b = leds[i].b;
+    }
+    led_rmt_encode(frame, HW_LED_COUNT, FastLED.getBrightness(), &rmt_timing,
+                   (led_rmt_symbol_t*)rmt_symbols[rmt_sending ^ 1]);
+    rmt_queued = true;
+
+    rmt_pump();
+    if (rmt_queued) stats.queued++;
+}
+
+static bool rmt_init(void) {
+    rmt_config_t config = RMT_DEFAULT_CONFIG_TX((gpio_num_t)HW_LED_PIN, (rmt_channel_t)HW_LED_RMT_CHANNEL);
+    config.clk_div = LED_RMT_CLK_DIV;
+    config.mem_block_num = 2;  // 两块96个符号，3个LED以内整帧一次装下，不靠中断续填
+    config.tx_config.idle_output_en = true;
+    config.tx_config.idle_level = RMT_IDLE_LEVEL_LOW;
+    if (rmt_config(&config) != ESP_OK) return false;
+    return rmt_driver_install(config.channel, 0, 0) == ESP_OK;
+}
+#endif
+
+//** 发出去 - RMT模式下只编码排队，不等发送结束
+static void led_show(uint32_t now) {
+#if HW_LED_RMT_ASYNC
+    rmt_transmit();
+#else
+    FastLED.show();
+#endif
+    memcpy(shown, leds, sizeof(leds));
+    shown_brightness = FastLED.getBrightness();
+    shown_us = now;
+    stats.shows++;
+}
+
+//** 输出级 - 所有写LED的路径都从这里出去
+//** 推迟的帧不用单独补发：led_process()每次循环都会重新设颜色
+static void led_commit(void) {
+#if HW_LED_RMT_ASYNC
+    rmt_pump();
+#endif
+    if (FastLED.getBrightness() == shown_brightness && memcmp(leds, shown, sizeof(leds)) == 0) {
+        stats.skipped++;
+        return;
+    }
+
+    uint32_t now = micros();
+    if (now - shown_us < LED_MIN_SHOW_US) {
+        stats.deferred++;
+        return;
+    }
+    led_show(now);
+}
+
+//** 推迟的帧要等下一次提交才发 - 调度器据此决定多久以后再叫led_process()
+bool led_pending(void) {
+#if HW_LED_RMT_ASYNC
+    if (rmt_queued) return true;
+#endif
+    return FastLED.getBrightness() != shown_brightness || memcmp(leds, shown, sizeof(leds)) != 0;
+}
+
 //** 初始化 - 简单直接，无状态跟踪
 bool led_init(void) {
+#if HW_LED_RMT_ASYNC
+    //** FastLED只用来做颜色运算和记亮度，不挂控制器，RMT通道归我们
+    if (!rmt_init()) return false;
+#else
     FastLED.addLeds<WS2812, HW_LED_PIN, GRB>(leds, HW_LED_COUNT);
+#endif
     FastLED.setBrightness(HW_LED_BRIGHTNESS);
     
-    //** 清除所有LED
+    //** 清除所有LED - 灯带状态未知，无条件发一次
     for (uint8_t i = 0; i < HW_LED_COUNT; i++) {
         leds[i] = CRGB::Black;
     }
-    FastLED.show();
+    led_show(micros());
     return true;
 }
 
@@ -26,13 +142,21 @@ void led_set_color(uint8_t r, uint8_t g, uint8_t b) {
     for (uint8_t i = 0; i < HW_LED_COUNT; i++) {
         leds[i] = CRGB(r, g, b);
     }
-    FastLED.show();
+    led_commit();
+}
+
+//** 逐颗设置 - 一次提交整帧
+void led_set_pixels(const led_color_t* pixels) {
+    for (uint8_t i = 0; i < HW_LED_COUNT; i++) {
+        leds[i] = CRGB(pixels[i].r, pixels[i].g, pixels[i].b);
+    }
+    led_commit();
 }
 
 //** 设置亮度 - 直接调用FastLED
 void led_set_brightness(uint8_t brightness) {
     FastLED.setBrightness(brightness);
-    FastLED.show();
+    led_commit();
 }
 
 //** 设置HSV颜色 - 直接使用FastLED转换
@@ -41,10 +165,18 @@ void led_set_hsv(uint8_t h, uint8_t s, uint8_t v) {
     for (uint8_t i = 0; i < HW_LED_COUNT; i++) {
         leds[i] = hsv_color;
     }
-    FastLED.show();
+    led_commit();
 }
 
 //** 关闭LED - 就是设置为黑色
 void led_off(void) {
     led_set_color(0, 0, 0);
-}
\ No newline at end of file
+}
+
+const led_stats_t* led_get_stats(void) {
+    return &stats;
+}
+
+void led_reset_stats(void) {
+    memset(&stats, 0, sizeof(stats));
+}
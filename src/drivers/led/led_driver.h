@@ -15,12 +15,26 @@ typedef struct {
     uint8_t r, g, b;
 } led_color_t;
 
+//** 输出统计 - 真正发出去的 vs 因为没变化省掉的
+typedef struct {
+    uint32_t shows;     // FastLED.show() 次数
+    uint32_t skipped;   // 像素和亮度都没变，不发
+    uint32_t deferred;  // 变了但离上次发送太近，留给下一次
+    uint32_t queued;    // 上一帧还在发，排队等通道空闲
+    uint32_t replaced;  // 排队的帧还没发就被更新的帧替换
+} led_stats_t;
+
 //** LED 接口 - 扁平化，无初始化检查垃圾
 bool led_init(void);
 void led_set_color(uint8_t r, uint8_t g, uint8_t b);
+void led_set_pixels(const led_color_t* pixels);  // HW_LED_COUNT个，每颗各自的颜色
 void led_set_hsv(uint8_t h, uint8_t s, uint8_t v);
 void led_set_brightness(uint8_t brightness);
 void led_off(void);
+bool led_pending(void);  // 有帧被推迟或还在排队，需要再提交一次
+
+const led_stats_t* led_get_stats(void);
+void led_reset_stats(void);
 
 //** 便捷函数 - 直接设置，无废话
 static inline void led_red(void)   { led_set_color(255, 0, 0); }
@@ -0,0 +1,30 @@
+//** ESP32-S3 HoloCubic - WS2812 RMT Encoder Implementation
+
+#include "led_rmt.h"
+
+static led_rmt_symbol_t* encode_byte(uint8_t value, led_rmt_symbol_t bit0, led_rmt_symbol_t bit1,
+                                     led_rmt_symbol_t* out) {
+    for (uint8_t mask = 0x80; mask; mask >>= 1) {
+        *out++ = (value & mask) ? bit1 : bit0;
+    }
+    return out;
+}
+
+size_t led_rmt_encode(const led_color_t* pixels, uint16_t count, uint8_t brightness,
+                      const led_rmt_timing_t* timing, led_rmt_symbol_t* out) {
+    led_rmt_symbol_t bit0 = led_rmt_symbol(timing->t0h, 1, timing->t0l, 0);
+    led_rmt_symbol_t bit1 = led_rmt_symbol(timing->t1h, 1, timing->t1l, 0);
+    led_rmt_symbol_t* p = out;
+
+    //** WS2812线上顺序是GRB
+    for (uint16_t i = 0; i < count; i++) {
+        p = encode_byte(led_scale8(pixels[i].g, brightness), bit0, bit1, p);
+        p = encode_byte(led_scale8(pixels[i].r, brightness), bit0, bit1, p);
+        p = encode_byte(led_scale8(pixels[i].b, brightness), bit0, bit1, p);
+    }
+
+    //** 复位 - 两半都是低电平
+    uint16_t half = (uint16_t)(timing->reset / 2);
+    *p++ = led_rmt_symbol(half, 0, (uint16_t)(timing->reset - half), 0);
+    return (size_t)(p - out);
+}
@@ -0,0 +1,54 @@
+//** ESP32-S3 HoloCubic - WS2812 RMT Encoder
+//** Linus原则：编码是纯函数 - 颜色进，RMT符号出，主机上逐位对比
+//**
+//** - 每个LED 24位，GRB顺序，高位先发；每位一个RMT符号 (高电平 + 低电平)
+//** - 最后一个符号是复位低电平，下一帧紧接着发也能锁存
+//** - 亮度和FastLED一样按 scale8 缩放: c * (1 + brightness) >> 8
+//** - 符号布局和IDF的 rmt_item32_t 相同，可以直接交给 rmt_write_items()
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "led_driver.h"  // led_color_t
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LED_RMT_BITS_PER_LED 24
+#define LED_RMT_SYMBOLS(count) ((size_t)(count) * LED_RMT_BITS_PER_LED + 1)
+
+//** RMT时钟: APB 80MHz / 2 = 40MHz，每tick 25ns
+#define LED_RMT_CLK_DIV 2
+
+//** 单位都是RMT tick；duration字段只有15位
+typedef struct {
+    uint16_t t0h, t0l;      // 0码
+    uint16_t t1h, t1l;      // 1码
+    uint16_t reset;         // 帧尾低电平，拆成两半放进一个符号，最多 2 * 32767
+} led_rmt_timing_t;
+
+//** WS2812B @ 25ns/tick: 0码 0.4/0.85us，1码 0.8/0.45us，复位300us (新批次的WS2812B要280us)
+#define LED_RMT_TIMING_WS2812 { 16, 34, 32, 18, 12000 }
+
+//** rmt_item32_t.val: duration0[14:0] level0[15] duration1[30:16] level1[31]
+typedef uint32_t led_rmt_symbol_t;
+
+static inline led_rmt_symbol_t led_rmt_symbol(uint16_t d0, uint8_t l0, uint16_t d1, uint8_t l1) {
+    return (uint32_t)(d0 & 0x7FFF) | ((uint32_t)(l0 & 1) << 15) |
+           ((uint32_t)(d1 & 0x7FFF) << 16) | ((uint32_t)(l1 & 1) << 31);
+}
+
+//** FastLED的scale8 / FastLED's scale8
+static inline uint8_t led_scale8(uint8_t c, uint8_t scale) {
+    return (uint8_t)(((uint16_t)c * (1 + (uint16_t)scale)) >> 8);
+}
+
+//** 编码一帧 - out至少 LED_RMT_SYMBOLS(count) 个符号；返回写入的符号数
+size_t led_rmt_encode(const led_color_t* pixels, uint16_t count, uint8_t brightness,
+                      const led_rmt_timing_t* timing, led_rmt_symbol_t* out);
+
+#ifdef __cplusplus
+}
+#endif
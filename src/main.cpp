@@ -5,16 +5,21 @@
 #include "debug_config.h"    // 必须首先包含，定义所有编译开关
 #include "hardware_config.h" // 硬件配置
 #include "panic.h"           // 系统恐慌处理
+#include "serial_out.h"      // 串口输出 (两个核共用一把锁)
 #include "system_boot.h"     // 系统启动
 #include <Arduino.h>
 
 #if ENABLE_TFT_TESTS
 #include "test/tft_display_test.h"
+#else
+#include "app/monitoring/status_screen.h"
 #endif
 
 #if ENABLE_IMU_TESTS
 #include "imu_gesture_driver.h" // 使用库版本的IMU手势驱动 - Arduino自动找到lib/IMUGesture/src/
 #include "test/imu_gesture_test.h" // 使用主工程的测试模块 - 测试代码属于主工程
+#include "QMI8658.h"
+#include "app_trace.h"
 #endif
 
 #if ENABLE_FLASH_TESTS
@@ -25,48 +30,64 @@
 #include "test/sd_card_diagnostic.h"
 #endif
 
+#if ENABLE_TFT_TESTS
+//** WiFi状态变了才重画TFT测试页 - 原来每10秒重读一遍
+static void tft_on_wifi(const event_t* event, void* ctx) {
+  serial_out.println("=== Auto TFT Display Update ===");
+  tft_display_test_run(); // 显示WiFi状态、Flash和SD卡内容
+}
+#endif
+
 //** Arduino setup() - 系统启动入口点
 //** Linus原则：main() 只做调度，具体实现在独立模块中
 void setup() {
   boot_result_t result = system_boot_sequence();
 
   if (result != BOOT_OK) {
-    Serial.printf("FATAL: Boot failed with error %d at stage: %s\n", result,
+    serial_out.printf("FATAL: Boot failed with error %d at stage: %s\n", result,
                   get_boot_stage_name(get_boot_stage()));
     system_panic(PANIC_BOOT_FAILED, "System boot sequence failed");
   }
 
+#if ENABLE_TFT_TESTS
+  event_subscribe(app_event_bus(), EVENT_MASK(EVENT_WIFI_STATE), tft_on_wifi, NULL);
+#else
+  //** 屏幕归帧节拍 - TFT测试套件直接画屏，和它二选一
+  status_screen_init();
+  app_set_render(status_screen_render);
+#endif
+
   //** 初始化成功后，执行一次性存储测试写入
   
 #if ENABLE_FLASH_TESTS
-  Serial.println("=== Flash Storage Write Test ===");
+  serial_out.println("=== Flash Storage Write Test ===");
   
   // Flash写入测试 - 只执行一次
   if (storage_test_write_ssid()) {
-    Serial.println("✓ Flash write completed in setup()");
+    serial_out.println("✓ Flash write completed in setup()");
   } else {
-    Serial.println("✗ Flash write failed in setup()");
+    serial_out.println("✗ Flash write failed in setup()");
   }
   
-  Serial.println("=== Flash Storage Write Complete ===");
+  serial_out.println("=== Flash Storage Write Complete ===");
 #endif
 
 #if ENABLE_SD_TESTS
-  Serial.println("=== SD Card Storage Write Test ===");
+  serial_out.println("=== SD Card Storage Write Test ===");
   
   // SD卡诊断 - 帮助调试连接问题
-  Serial.println("=== Running SD Card Diagnostic ===");
+  serial_out.println("=== Running SD Card Diagnostic ===");
   sd_card_diagnostic_run();
-  Serial.println("=== SD Card Diagnostic Complete ===");
+  serial_out.println("=== SD Card Diagnostic Complete ===");
   
   // SD卡写入测试 - 只执行一次
   if (storage_test_write_password_sd()) {
-    Serial.println("✓ SD card write completed in setup()");
+    serial_out.println("✓ SD card write completed in setup()");
   } else {
-    Serial.println("✗ SD card write failed in setup()");
+    serial_out.println("✗ SD card write failed in setup()");
   }
   
-  Serial.println("=== SD Card Storage Write Complete ===");
+  serial_out.println("=== SD Card Storage Write Complete ===");
 #endif
 
   //** 初始化成功 - setup() 结束后 Arduino 会自动调用 loop()
@@ -82,26 +103,24 @@ void loop() {
     if (!system_health_check()) {
       system_panic(PANIC_OUT_OF_MEMORY, "System health check failed");
     }
+    event_publish(EVENT_HEALTH, 1, (int32_t)ESP.getFreeHeap());
     last_health_check = now;
   }
 
   //** 运行应用逻辑Wi-Fi，heart beat，command_handler等。
   app_run();
 
-#if ENABLE_TFT_TESTS
-  //** TFT显示更新 - 显示WiFi状态和存储内容
-  static uint32_t last_tft_update = 0;
-
-  if (now - last_tft_update > HW_SYSTEM_TFT_UPDATE_MS) { // TFT显示更新间隔
-    Serial.println("=== Auto TFT Display Update ===");
-    tft_display_test_run(); // 显示WiFi状态、Flash和SD卡内容
-    last_tft_update = now;
-  }
-#endif
-
 #if ENABLE_IMU_TESTS
   //** IMU手势识别测试 - 使用库版本的驱动和主工程的测试模块
   ImuGestureData *gesture_data = imu_gesture_get_data();
+  if (gesture_data->isValid) {
+    event_publish(EVENT_IMU_GESTURE, 0, 0); // 测试函数会清掉isValid，先发事件
+    if (app_trace_active()) {
+      float acc[3], gyro[3];
+      QMI8658_read_xyz(acc, gyro, NULL);
+      app_trace_imu(0, acc, gyro);          // 驱动没给手势编号，和事件一样记0
+    }
+  }
   imu_test_gesture_recognition(
       gesture_data);                  // 调用主工程的测试函数，内部会重置isValid
   imu_test_configuration_functions(); // 调用主工程的配置测试函数
@@ -0,0 +1,364 @@
+//** ESP32-S3 HoloCubic - 资源包主机检查 / Asset Pack Checks on the Host
+//**
+//** make assets-test
+//** .pio/build/native_assets_test/program scripts/images pack.bin [pack.bin ...]
+//**
+//** 包由 scripts/5_asset_pack.py 打 (make assets-test 从 scripts/images 的PNG打一个QOI565包和一个--raw包)，
+//** 这里用设备上的 display_assets_open / find / display_asset_decode 读它。每项打印一行，出错打印FAIL，任何失败退出码1。
+//** Packs are built by scripts/5_asset_pack.py (make assets-test packs the PNGs in scripts/images once as QOI565
+//** and once with --raw) and read here with the device's display_assets_open / find / display_asset_decode. Each
+//** check prints one row, failures print FAIL, and any failure exits with 1.
+//**
+//** pixels   每个资源按名字找到，解出的像素和源PNG逐位相同 - 源图用设备的PNG解码器解 (image-test核对过它和Pillow一致)；
+//**          整张解一遍，再按不规则的块数解一遍，游程跨块时结果必须一样
+//**          Every asset is found by name and decodes bit for bit to its source PNG - the source is decoded with
+//**          the device's PNG decoder, which image-test checks against Pillow; decoded whole and again in uneven
+//**          pieces, which must give the same pixels when runs straddle pieces
+//** lookup   不在包里的名字、超长的名字返回NULL；每次查找和每个像素的主机ns
+//**          Names not in the pack and over-long names return NULL; host ns per lookup and per pixel
+//** reject   包的每个截断长度、改坏的头和索引 (magic/版本/数量/偏移/长度/编码/名字结尾/顺序/原始像素长度) 都必须打不开
+//**          Every truncated length of the pack and a corrupted header or index (magic, version, count, offset,
+//**          length, codec, name terminator, order, raw pixel length) must all fail to open
+//** corrupt  压缩数据截短或随机改坏 - 解码器报错或照样解完，但不越过数据末尾，也不多给像素
+//**          Compressed data cut short or randomly corrupted - the decoder reports an error or finishes anyway,
+//**          but never reads past the end of the data or returns extra pixels
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "display_assets.h"
+#include "display_image.h"
+
+#define CANVAS_SIZE 256
+#define MAX_PIXELS (CANVAS_SIZE * CANVAS_SIZE)
+
+static uint32_t failures;
+static uint8_t pool[DISPLAY_IMAGE_BUDGET];
+static uint16_t source[MAX_PIXELS];
+static uint16_t decoded[MAX_PIXELS];
+static uint16_t pieces[MAX_PIXELS];
+
+static uint64_t host_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void fail(const char* check, const char* what) {
+  failures++;
+  if (failures <= 20) printf("FAIL %s: %s\n", check, what);
+}
+
+//** xorshift32 - 每次运行结果相同 / same results on every run
+static uint32_t rng_state = 0x12345678u;
+
+static uint32_t rng(void) {
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+//** 整个文件读进4字节对齐的内存 - 和映射的分区一样 / Whole file read into 4-byte aligned memory, like the
+//** mapped partition
+static uint8_t* load(const char* path, uint32_t* size) {
+  FILE* f = fopen(path, "rb");
+  if (!f) return NULL;
+  fseek(f, 0, SEEK_END);
+  long n = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  uint8_t* data = (uint8_t*)malloc(n > 0 ? (size_t)n : 1);   // malloc至少8字节对齐 / malloc is at least 8-byte aligned
+  *size = (uint32_t)fread(data, 1, n, f);
+  fclose(f);
+  return data;
+}
+
+// ========================================
+// 源图 / Source Images
+// ========================================
+
+typedef struct {
+  const uint8_t* data;
+  uint32_t size;
+  uint32_t pos;
+} memory_reader_t;
+
+static int32_t memory_read(void* ctx, uint8_t* buf, uint32_t len) {
+  memory_reader_t* r = (memory_reader_t*)ctx;
+  uint32_t n = r->size - r->pos;
+  if (n > len) n = len;
+  memcpy(buf, r->data + r->pos, n);
+  r->pos += n;
+  return (int32_t)n;
+}
+
+static void source_band(void* ctx, int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t* pixels) {
+  const display_image_stats_t* stats = (const display_image_stats_t*)ctx;
+  for (int16_t row = 0; row < h; row++) {
+    memcpy(&source[(uint32_t)(y + row) * stats->width + x], &pixels[row * w], (size_t)w * sizeof(uint16_t));
+  }
+}
+
+//** 源PNG解成BGR565，和资源包里的像素同一种格式 / Source PNG decoded to BGR565, the format the pack stores
+static bool load_source(const char* dir, const char* name, int16_t* width, int16_t* height) {
+  char path[512];
+  snprintf(path, sizeof(path), "%s/%s.png", dir, name);
+  uint32_t size = 0;
+  uint8_t* data = load(path, &size);
+  if (!data) return false;
+  memory_reader_t mem = { data, size, 0 };
+  display_image_reader_t reader = { memory_read, &mem };
+  display_image_stats_t stats;
+  memset(&stats, 0, sizeof(stats));
+  display_image_result_t result =
+      display_image_decode(&reader, pool, sizeof(pool), 0, 0, source_band, &stats, &stats);
+  free(data);
+  *width = stats.width;
+  *height = stats.height;
+  return result == DISPLAY_IMAGE_OK;
+}
+
+// ========================================
+// 像素和查找 / Pixels and Lookup
+// ========================================
+
+static void check_pixels(const char* pack_name, const display_assets_t* pack, const char* dir) {
+  char what[192];
+  for (uint16_t i = 0; i < pack->count; i++) {
+    const display_asset_entry_t* e = &pack->entries[i];
+    if (display_assets_find(pack, e->name) != e) {
+      snprintf(what, sizeof(what), "%s: find(\"%s\") did not return its own entry", pack_name, e->name);
+      fail("pixels", what);
+      continue;
+    }
+    int16_t w = 0, h = 0;
+    if (!load_source(dir, e->name, &w, &h)) {
+      snprintf(what, sizeof(what), "%s: cannot decode the source %s/%s.png", pack_name, dir, e->name);
+      fail("pixels", what);
+      continue;
+    }
+    uint32_t count = (uint32_t)e->width * e->height;
+    if (e->width != w || e->height != h || count > MAX_PIXELS) {
+      snprintf(what, sizeof(what), "%s: %s is %ux%u in the pack, %dx%d in the source", pack_name, e->name,
+               (unsigned)e->width, (unsigned)e->height, w, h);
+      fail("pixels", what);
+      continue;
+    }
+
+    display_asset_decoder_t dec;
+    display_asset_decoder_init(&dec, pack, e);
+    uint32_t got = display_asset_decode(&dec, decoded, count);
+    bool whole_ok = got == count && !dec.error && memcmp(decoded, source, count * sizeof(uint16_t)) == 0;
+
+    //** 不规则的块 - 1、2、3...个像素，游程和字面量会跨块 / Uneven pieces - 1, 2, 3... pixels, so runs and
+    //** literals straddle pieces
+    display_asset_decoder_init(&dec, pack, e);
+    uint32_t done = 0;
+    for (uint32_t piece = 1; done < count && !dec.error; piece = piece % 97 + 1) {
+      uint32_t n = count - done < piece ? count - done : piece;
+      done += display_asset_decode(&dec, pieces + done, n);
+    }
+    bool pieces_ok = done == count && !dec.error && memcmp(pieces, source, count * sizeof(uint16_t)) == 0;
+
+    if (!whole_ok || !pieces_ok) {
+      uint32_t first = 0;
+      while (first < count && (whole_ok ? pieces : decoded)[first] == source[first]) first++;
+      snprintf(what, sizeof(what), "%s: %s differs from its source at pixel %lu (%s)", pack_name, e->name,
+               (unsigned long)first, whole_ok ? "in pieces" : "whole");
+      fail("pixels", what);
+    }
+    printf("pixels,%s,%s,%ux%u,%s,%lu,%.1f%%,%s\n", pack_name, e->name, (unsigned)e->width, (unsigned)e->height,
+           e->codec == DISPLAY_ASSET_RAW ? "raw" : "qoi565", (unsigned long)e->length,
+           100.0 * e->length / (count * sizeof(uint16_t)), whole_ok && pieces_ok ? "same" : "DIFFERENT");
+  }
+}
+
+static void check_lookup(const char* pack_name, const display_assets_t* pack) {
+  static const char* const misses[] = { "", "missing", "png_rgb9", "PNG_RGB8", "png_rgb8_long_name" };
+  for (uint32_t i = 0; i < sizeof(misses) / sizeof(misses[0]); i++) {
+    if (display_assets_find(pack, misses[i])) {
+      char what[128];
+      snprintf(what, sizeof(what), "%s: find(\"%s\") returned an entry", pack_name, misses[i]);
+      fail("lookup", what);
+    }
+  }
+  if (!pack->count) return;
+
+  //** 查找 - 一半命中一半不中 / Lookups - half hits, half misses
+  const uint32_t rounds = 200000;
+  volatile uint32_t found = 0;
+  uint64_t start = host_ns();
+  for (uint32_t r = 0; r < rounds; r++) {
+    const char* name = (r & 1) ? pack->entries[r % pack->count].name : misses[r % 5];
+    if (display_assets_find(pack, name)) found++;
+  }
+  double lookup_ns = (double)(host_ns() - start) / rounds;
+
+  //** 解码 - 整包解到至少50ms / Decode - the whole pack, repeated for at least 50 ms
+  uint64_t pixels = 0, elapsed = 0;
+  start = host_ns();
+  do {
+    for (uint16_t i = 0; i < pack->count; i++) {
+      const display_asset_entry_t* e = &pack->entries[i];
+      uint32_t count = (uint32_t)e->width * e->height;
+      if (count > MAX_PIXELS) continue;
+      display_asset_decoder_t dec;
+      display_asset_decoder_init(&dec, pack, e);
+      pixels += display_asset_decode(&dec, decoded, count);
+    }
+    elapsed = host_ns() - start;
+  } while (elapsed < 50000000ull);
+  printf("lookup,%s,%u assets,%.1f ns/find,%.2f ns/pixel,%.1f Mpix/s\n", pack_name, (unsigned)pack->count, lookup_ns,
+         (double)elapsed / pixels, pixels * 1e3 / elapsed);
+}
+
+// ========================================
+// 坏包 / Bad Packs
+// ========================================
+
+//** 改一份拷贝，必须打不开 / Corrupt a copy, which must fail to open
+static uint8_t* scratch;
+
+static void reject_case(const char* pack_name, const char* what_changed, const uint8_t* data, uint32_t size,
+                        void (*corrupt)(display_asset_entry_t* entries, display_assets_header_t* header)) {
+  memcpy(scratch, data, size);
+  display_assets_header_t* header = (display_assets_header_t*)scratch;
+  corrupt((display_asset_entry_t*)(header + 1), header);
+  display_assets_t pack;
+  if (display_assets_open(&pack, scratch, size)) {
+    char what[128];
+    snprintf(what, sizeof(what), "%s: opened with %s", pack_name, what_changed);
+    fail("reject", what);
+  }
+}
+
+static void bad_magic(display_asset_entry_t* e, display_assets_header_t* h) { h->magic ^= 1; }
+static void bad_version(display_asset_entry_t* e, display_assets_header_t* h) { h->version++; }
+static void bad_count(display_asset_entry_t* e, display_assets_header_t* h) { h->count = 0xFFFF; }
+static void bad_size(display_asset_entry_t* e, display_assets_header_t* h) { h->size++; }
+static void bad_offset_low(display_asset_entry_t* e, display_assets_header_t* h) { e[0].offset = 4; }
+static void bad_offset_high(display_asset_entry_t* e, display_assets_header_t* h) { e[0].offset = h->size + 4; }
+static void bad_length(display_asset_entry_t* e, display_assets_header_t* h) { e[0].length = h->size; }
+static void bad_codec(display_asset_entry_t* e, display_assets_header_t* h) { e[0].codec = 2; }
+static void bad_name(display_asset_entry_t* e, display_assets_header_t* h) {
+  memset(e[0].name, 'x', DISPLAY_ASSET_NAME_MAX);
+}
+static void bad_order(display_asset_entry_t* e, display_assets_header_t* h) {
+  if (h->count > 1) {
+    e[1].hash = e[0].hash - 1;
+  } else {
+    h->magic = 0;  // 只有一项时没有顺序可言 / a single entry has no order to break
+  }
+}
+//** 原始像素的宽高改大 - 解码时会缺数据 / Raw width and height made larger - decoding would run short
+static void bad_raw_size(display_asset_entry_t* e, display_assets_header_t* h) {
+  for (uint16_t i = 0; i < h->count; i++) {
+    if (e[i].codec == DISPLAY_ASSET_RAW) {
+      e[i].width = 60000;
+      e[i].height = 60000;
+      return;
+    }
+  }
+  h->magic = 0;  // 没有原始项 / no raw entry
+}
+
+static void check_reject(const char* pack_name, const uint8_t* data, uint32_t size) {
+  display_assets_t pack;
+  uint32_t opened = 0;
+  for (uint32_t len = 0; len < size; len++) {
+    if (display_assets_open(&pack, data, len)) opened++;
+  }
+  if (opened) {
+    char what[128];
+    snprintf(what, sizeof(what), "%s: %lu truncated lengths opened", pack_name, (unsigned long)opened);
+    fail("reject", what);
+  }
+  if (display_assets_open(&pack, data + 1, size - 1)) fail("reject", "an unaligned pack opened");
+
+  reject_case(pack_name, "a bad magic", data, size, bad_magic);
+  reject_case(pack_name, "a bad version", data, size, bad_version);
+  reject_case(pack_name, "count 65535", data, size, bad_count);
+  reject_case(pack_name, "a size past the end", data, size, bad_size);
+  reject_case(pack_name, "data inside the index", data, size, bad_offset_low);
+  reject_case(pack_name, "data past the end", data, size, bad_offset_high);
+  reject_case(pack_name, "a length past the end", data, size, bad_length);
+  reject_case(pack_name, "codec 2", data, size, bad_codec);
+  reject_case(pack_name, "an unterminated name", data, size, bad_name);
+  reject_case(pack_name, "unsorted hashes", data, size, bad_order);
+  reject_case(pack_name, "a raw entry larger than its data", data, size, bad_raw_size);
+  printf("reject,%s,%lu truncated lengths,11 corrupted headers\n", pack_name, (unsigned long)size);
+}
+
+//** 压缩数据截短或改坏 - 解码器不能越过末尾，不能多给像素
+//** Compressed data cut short or corrupted - the decoder must not pass the end or return extra pixels
+static void check_corrupt(const char* pack_name, const uint8_t* data, uint32_t size) {
+  display_assets_t pack;
+  uint32_t cases = 0, errors = 0, bad = 0;
+  for (uint32_t round = 0; round < 2000; round++) {
+    memcpy(scratch, data, size);
+    if (!display_assets_open(&pack, scratch, size) || !pack.count) return;
+    display_asset_entry_t* e = (display_asset_entry_t*)&pack.entries[round % pack.count];
+    uint32_t count = (uint32_t)e->width * e->height;
+    if (count > MAX_PIXELS || e->codec != DISPLAY_ASSET_QOI565 || !e->length) continue;
+
+    if (round & 1) {
+      e->length = rng() % e->length;
+    } else {
+      for (uint32_t k = 1 + rng() % 8; k; k--) scratch[e->offset + rng() % e->length] = (uint8_t)rng();
+    }
+    display_asset_decoder_t dec;
+    display_asset_decoder_init(&dec, &pack, e);
+    const uint8_t* end = dec.end;
+    uint32_t done = 0;
+    while (done < count && !dec.error) {
+      uint32_t n = count - done < 61 ? count - done : 61;
+      uint32_t got = display_asset_decode(&dec, decoded + done, n);
+      //** 少给像素必须同时报错 / Short output must come with an error
+      if (got > n || (got < n && !dec.error)) {
+        bad++;
+        break;
+      }
+      done += got;
+    }
+    if (dec.src > end) bad++;
+    if (dec.error) errors++;
+    cases++;
+  }
+  if (bad) {
+    char what[128];
+    snprintf(what, sizeof(what), "%s: %lu corrupted streams read past the end or returned extra pixels", pack_name,
+             (unsigned long)bad);
+    fail("corrupt", what);
+  }
+  printf("corrupt,%s,%lu streams,%lu reported errors\n", pack_name, (unsigned long)cases, (unsigned long)errors);
+}
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    fprintf(stderr, "usage: %s <source image dir> <pack.bin>... - make assets-test builds the packs\n", argv[0]);
+    return 2;
+  }
+  const char* dir = argv[1];
+  for (int a = 2; a < argc; a++) {
+    const char* pack_name = argv[a];
+    uint32_t size = 0;
+    uint8_t* data = load(pack_name, &size);
+    display_assets_t pack;
+    if (!data || !display_assets_open(&pack, data, size)) {
+      fail(pack_name, "cannot read or open the pack");
+      free(data);
+      continue;
+    }
+    scratch = (uint8_t*)malloc(size);
+    check_pixels(pack_name, &pack, dir);
+    check_lookup(pack_name, &pack);
+    check_reject(pack_name, data, size);
+    check_corrupt(pack_name, data, size);
+    free(scratch);
+    free(data);
+  }
+
+  printf("assets: %s\n", failures ? "FAIL" : "OK");
+  return failures ? 1 : 0;
+}
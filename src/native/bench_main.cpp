@@ -0,0 +1,41 @@
+//** ESP32-S3 HoloCubic - 主机上的显示基准 / Display Benchmark on the Host
+//**
+//** pio run -e native_bench -t exec                 # 默认规模 / default scale
+//** .pio/build/native_bench/program 10 > now.csv     # 10倍调用次数 / 10x the calls
+//**
+//** 驱动跑在TFT_eSPI替身上，像素进假SPI总线 - us是主机CPU时间，bus_us是ESP32上的线上时间
+//** The driver runs on the TFT_eSPI stand-in, pixels go to the fake SPI bus - us is host CPU time,
+//** bus_us is wire time on the ESP32
+
+#include <Arduino.h>
+#include "display_driver.h"
+#include "display_bench.h"
+#include "display_fake_spi.h"
+#include "hardware_config.h"
+
+static display_fake_spi_t spi;
+
+static uint32_t bench_clock(void) {
+  return micros();
+}
+
+static void bench_emit(void* ctx, const char* line) {
+  printf("%s\n", line);
+}
+
+int main(int argc, char** argv) {
+  display_init();
+  display_fake_spi_init(&spi, HW_DISPLAY_SPI_FREQ);
+  display_set_sink(&spi.sink);
+  display_set_transport(&spi.transport);
+
+  display_bench_config_t config = { bench_clock, bench_emit, NULL, HW_DISPLAY_SPI_FREQ, 1 };
+  if (argc > 1) config.scale = (uint16_t)atoi(argv[1]);
+
+  uint32_t done = display_bench_run(&config);
+
+  //** 假总线自己的计数 - 不含TFT_eSPI直接画的文字 / The fake bus's own counts - excludes text drawn by TFT_eSPI
+  printf("# fake_spi bytes=%llu windows=%lu bus_us=%lu\n", (unsigned long long)spi.bytes,
+         (unsigned long)spi.windows, (unsigned long)display_spi_us(spi.cycles, spi.hz));
+  return done ? 0 : 1;
+}
@@ -0,0 +1,311 @@
+//** ESP32-S3 HoloCubic - 命令解析主机压测 / Line Command Parser Fuzz and Benchmark on the Host
+//**
+//** pio run -e native_command_bench -t exec
+//** .pio/build/native_command_bench/program 2000000 [seed]     # 每项的行数 / lines per test
+//**
+//** 模糊：随机字节 (大量\r\n、退格、控制字符和超长行) 喂给收行器和解析器，每行检查不变量，出错退出码1。
+//** 吞吐量：一段真实的命令流 (大多带参数) 逐字节收行、切分、查表、调用，报每秒多少条命令和MB/s；
+//** 再单独比较有序表二分查找和逐个strcmp查找。
+//** Fuzz: random bytes (plenty of \r\n, backspace, control characters and over-long lines) go through the line
+//** reader and the parser, with invariants checked on every line; any failure exits with 1.
+//** Throughput: a realistic command stream (mostly with arguments) is read byte by byte, tokenized, looked up and
+//** dispatched, reported as commands per second and MB/s; then the sorted-table binary search is compared with a
+//** linear strcmp scan.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "command_line.h"
+
+static uint64_t host_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+//** 处理函数做一点真正的工作，免得被编译器整个优化掉
+static volatile uint32_t sink;
+
+static void count_handler(uint8_t argc, char* argv[]) {
+  sink += argc + (uint8_t)argv[argc - 1][0];
+}
+
+//** 和固件差不多的一张表：单字母的老命令加上带参数的新命令 / Roughly the firmware's table: the old single-letter
+//** commands plus the new ones with arguments
+static const command_t bench_commands[] = {
+  {"h", count_handler, "h", 0, 0, 0},             {"help", count_handler, NULL, 0, 0, 0},
+  {"w", count_handler, "w", 0, 0, 0},             {"f", count_handler, "f", 0, 0, COMMAND_RENDER},
+  {"F", count_handler, NULL, 0, 0, COMMAND_RENDER}, {"p", count_handler, "p", 0, 0, 0},
+  {"P", count_handler, NULL, 0, 0, 0},            {"T", count_handler, "T", 0, 0, 0},
+  {"r", count_handler, "r", 0, 0, COMMAND_RENDER}, {"g", count_handler, NULL, 0, 0, COMMAND_RENDER},
+  {"b", count_handler, NULL, 0, 0, COMMAND_RENDER}, {"o", count_handler, "o", 0, 0, COMMAND_RENDER},
+  {"c", count_handler, "c", 0, 0, 0},             {"B", count_handler, "B", 0, 0, COMMAND_RENDER},
+  {"1", count_handler, "1", 0, 0, COMMAND_RENDER}, {"2", count_handler, "2", 0, 0, COMMAND_RENDER},
+  {"3", count_handler, "3", 0, 0, COMMAND_RENDER}, {"4", count_handler, "4", 0, 0, COMMAND_RENDER},
+  {"stats", count_handler, "stats", 0, 1, COMMAND_RENDER},
+  {"bright", count_handler, "bright", 1, 1, COMMAND_RENDER},
+  {"hb", count_handler, "hb", 0, 1, 0},
+  {"led", count_handler, "led", 3, 4, COMMAND_RENDER},
+  {"file", count_handler, "file", 1, 3, 0},
+  {"wifi", count_handler, "wifi", 0, 2, 0},
+};
+#define BENCH_COMMAND_COUNT (sizeof(bench_commands) / sizeof(bench_commands[0]))
+
+static void register_all(void) {
+  command_registry_reset();
+  if (!command_register(bench_commands, BENCH_COMMAND_COUNT)) {
+    fprintf(stderr, "register failed\n");
+    exit(1);
+  }
+}
+
+//** ========================================
+//** 模糊 / Fuzz
+//** ========================================
+
+static uint32_t rng_state;
+
+static uint32_t rng(void) {
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+//** 偏向会出问题的字节 / Biased toward the bytes that cause trouble
+static char fuzz_byte(void) {
+  static const char interesting[] = " \t\r\n\b\x7f\x1b" "0x-+ ";
+  uint32_t r = rng() % 100;
+  if (r < 25) return interesting[rng() % (sizeof(interesting) - 1)];
+  if (r < 45) return bench_commands[rng() % BENCH_COMMAND_COUNT].name[0];
+  if (r < 55) return (char)('0' + rng() % 10);
+  return (char)(rng() & 0xFF);
+}
+
+static uint32_t failures = 0;
+
+static void fail(const char* what, const char* line) {
+  if (failures++ < 10) fprintf(stderr, "FAIL %s: \"%s\"\n", what, line);
+}
+
+static void check_line(const command_line_t* line) {
+  if (line->len >= COMMAND_LINE_MAX || line->buf[line->len] != '\0') {
+    fail("unterminated line", "");
+    return;
+  }
+  for (uint8_t i = 0; i < line->len; i++) {
+    if ((uint8_t)line->buf[i] < ' ' || line->buf[i] == 0x7F) fail("control byte kept", line->buf);
+  }
+  if (line->overflow) return;
+
+  char text[COMMAND_LINE_MAX];
+  memcpy(text, line->buf, sizeof(text));
+  const command_t* command;
+  uint8_t argc;
+  char* argv[COMMAND_MAX_ARGS];
+  command_result_t result = command_parse(text, &command, &argc, argv);
+
+  if (argc > COMMAND_MAX_ARGS) fail("argc", line->buf);
+  for (uint8_t i = 0; i < argc && result != COMMAND_TOO_LONG; i++) {
+    if (argv[i] < text || argv[i] >= text + sizeof(text) || !argv[i][0] || strpbrk(argv[i], " \t")) {
+      fail("argv outside the line or not a word", line->buf);
+    }
+  }
+  switch (result) {
+  case COMMAND_OK:
+    if (!command || strcmp(command->name, argv[0]) != 0) fail("wrong command", line->buf);
+    else if (argc - 1 < command->min_args || argc - 1 > command->max_args) fail("arg count not checked", line->buf);
+    else command->fn(argc, argv);
+    break;
+  case COMMAND_UNKNOWN:
+    for (uint8_t i = 0; i < BENCH_COMMAND_COUNT; i++) {
+      if (strcmp(bench_commands[i].name, argv[0]) == 0) fail("missed a command", line->buf);
+    }
+    break;
+  case COMMAND_EMPTY:
+    if (strspn(line->buf, " \t") != line->len) fail("non-empty line reported empty", line->buf);
+    break;
+  default:
+    break;
+  }
+}
+
+static void fuzz_lines(uint32_t count) {
+  command_line_t line;
+  command_line_reset(&line);
+  uint32_t lines = 0, overflows = 0;
+  while (lines < count) {
+    if (command_line_feed(&line, fuzz_byte())) {
+      overflows += line.overflow;
+      check_line(&line);
+      command_line_reset(&line);
+      lines++;
+    }
+  }
+  printf("fuzz lines     %10u lines, %u too long, %u failures\n", lines, overflows, failures);
+}
+
+//** 数字参数和strtoull对照 / Numeric arguments checked against strtoull
+static void fuzz_numbers(uint32_t count) {
+  static const char digits[] = "0123456789abcdefxX-+ ";
+  uint32_t accepted = 0;
+  for (uint32_t n = 0; n < count; n++) {
+    char text[16];
+    uint8_t len = (uint8_t)(rng() % (sizeof(text) - 1));
+    for (uint8_t i = 0; i < len; i++) text[i] = digits[rng() % (sizeof(digits) - 1)];
+    text[len] = '\0';
+    uint32_t max = rng() % 3 == 0 ? 0xFFFFFFFFu : rng() % 100000u;
+
+    uint32_t value = 0;
+    bool ok = command_arg_u32(text, 0, max, &value);
+    char* end = text;
+    bool digit = text[0] >= '0' && text[0] <= '9';
+    int base = text[0] == '0' && (text[1] == 'x' || text[1] == 'X') ? 16 : 10;
+    unsigned long long ref = digit ? strtoull(text, &end, base) : 0;
+    bool ref_ok = digit && !*end && ref <= max;
+    if (ok != ref_ok || (ok && value != ref)) fail("number", text);
+    accepted += ok;
+  }
+  printf("fuzz numbers   %10u strings, %u accepted, %u failures\n", count, accepted, failures);
+}
+
+//** 固定的例子 - 前导0是十进制，只有0x/0X是十六进制 / Fixed cases - leading zeros stay decimal, only 0x/0X
+//** selects hex
+static void check_numbers(void) {
+  static const struct {
+    const char* text;
+    bool ok;
+    uint32_t value;
+  } cases[] = {
+    {"0", true, 0},           {"00", true, 0},           {"010", true, 10},        {"08", true, 8},
+    {"0255", true, 255},      {"0x10", true, 16},        {"0X1f", true, 31},       {"0xFFFFFFFF", true, 0xFFFFFFFFu},
+    {"4294967295", true, 0xFFFFFFFFu}, {"4294967296", false, 0}, {"0x100000000", false, 0}, {"0x", false, 0},
+    {"1f", false, 0},         {"0b1", false, 0},         {"0x-1", false, 0},       {"-1", false, 0},
+    {" 1", false, 0},         {"1 ", false, 0},          {"", false, 0},
+  };
+  for (uint32_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+    uint32_t value = 0;
+    bool ok = command_arg_u32(cases[i].text, 0, 0xFFFFFFFFu, &value);
+    if (ok != cases[i].ok || (ok && value != cases[i].value)) fail("number case", cases[i].text);
+  }
+  uint32_t value = 0;
+  if (command_arg_u32("0256", 0, 255, &value)) fail("number range", "0256");
+}
+
+static void fuzz_register(void) {
+  command_registry_reset();
+  //** 打乱顺序登记，索引要一直有序；重名要被拒 / Register in shuffled order; the index must stay sorted and
+  //** duplicates must be refused
+  uint8_t order[BENCH_COMMAND_COUNT];
+  for (uint8_t i = 0; i < BENCH_COMMAND_COUNT; i++) order[i] = i;
+  for (uint8_t i = BENCH_COMMAND_COUNT - 1; i > 0; i--) {
+    uint8_t j = (uint8_t)(rng() % (i + 1));
+    uint8_t t = order[i];
+    order[i] = order[j];
+    order[j] = t;
+  }
+  for (uint8_t i = 0; i < BENCH_COMMAND_COUNT; i++) {
+    if (!command_register(&bench_commands[order[i]], 1)) fail("register", bench_commands[order[i]].name);
+  }
+  if (command_register(&bench_commands[0], 1)) fail("duplicate accepted", bench_commands[0].name);
+  for (uint8_t i = 1; i < command_count(); i++) {
+    if (strcmp(command_at(i - 1)->name, command_at(i)->name) >= 0) fail("index not sorted", command_at(i)->name);
+  }
+  for (uint8_t i = 0; i < BENCH_COMMAND_COUNT; i++) {
+    if (command_find(bench_commands[i].name) != &bench_commands[i]) fail("find", bench_commands[i].name);
+  }
+}
+
+//** ========================================
+//** 吞吐量 / Throughput
+//** ========================================
+
+static const char* const stream_lines[] = {
+  "bright 128", "stats frame", "hb 2000", "led 255 0 64 500", "w", "f", "stats", "p",
+  "file put /anim/a.lsc 512", "r", "wifi scan", "nope 1 2", "bright 999999999999", "   o   ",
+};
+#define STREAM_LINES (sizeof(stream_lines) / sizeof(stream_lines[0]))
+
+static void bench_stream(uint32_t count) {
+  //** 先拼成一段连续的字节流，\r\n结尾 - 和串口监视器发的一样 / Build one contiguous byte stream ending each line
+  //** with \r\n - what a serial monitor sends
+  size_t cap = 0;
+  for (uint32_t i = 0; i < STREAM_LINES; i++) cap += strlen(stream_lines[i]) + 2;
+  cap *= count / STREAM_LINES + 1;
+  char* stream = (char*)malloc(cap);
+  size_t len = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    const char* text = stream_lines[i % STREAM_LINES];
+    size_t n = strlen(text);
+    memcpy(stream + len, text, n);
+    memcpy(stream + len + n, "\r\n", 2);
+    len += n + 2;
+  }
+
+  command_line_t line;
+  command_line_reset(&line);
+  uint32_t dispatched = 0;
+  uint64_t t0 = host_ns();
+  for (size_t i = 0; i < len; i++) {
+    if (!command_line_feed(&line, stream[i])) continue;
+    const command_t* command;
+    uint8_t argc;
+    char* argv[COMMAND_MAX_ARGS];
+    if (command_parse(line.buf, &command, &argc, argv) == COMMAND_OK) {
+      command->fn(argc, argv);
+      dispatched++;
+    }
+    command_line_reset(&line);
+  }
+  uint64_t spent = host_ns() - t0;
+  free(stream);
+
+  printf("stream         %10.2f M lines/s %8.1f ns/line %8.1f MB/s  (%u of %u dispatched)\n",
+         count / (spent / 1e9) / 1e6, (double)spent / count, len / (spent / 1e9) / 1e6, dispatched, count);
+}
+
+static const command_t* find_linear(const char* name) {
+  for (uint8_t i = 0; i < BENCH_COMMAND_COUNT; i++) {
+    if (strcmp(bench_commands[i].name, name) == 0) return &bench_commands[i];
+  }
+  return NULL;
+}
+
+static void bench_lookup(uint32_t count) {
+  const char* names[BENCH_COMMAND_COUNT + 2];
+  for (uint8_t i = 0; i < BENCH_COMMAND_COUNT; i++) names[i] = bench_commands[i].name;
+  names[BENCH_COMMAND_COUNT] = "nope";
+  names[BENCH_COMMAND_COUNT + 1] = "zzz";
+  const uint32_t name_count = BENCH_COMMAND_COUNT + 2;
+
+  uint64_t t0 = host_ns();
+  for (uint32_t i = 0; i < count; i++) sink += command_find(names[i % name_count]) != NULL;
+  uint64_t sorted = host_ns() - t0;
+
+  t0 = host_ns();
+  for (uint32_t i = 0; i < count; i++) sink += find_linear(names[i % name_count]) != NULL;
+  uint64_t linear = host_ns() - t0;
+
+  printf("lookup sorted  %10.1f ns   linear %8.1f ns   (%u commands)\n", (double)sorted / count,
+         (double)linear / count, (unsigned)BENCH_COMMAND_COUNT);
+}
+
+int main(int argc, char** argv) {
+  uint32_t count = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : 2000000u;
+  if (count == 0) count = 2000000u;
+  rng_state = argc > 2 ? (uint32_t)strtoul(argv[2], NULL, 0) : 0x2545F491u;
+  if (rng_state == 0) rng_state = 1;
+
+  printf("# command_bench %u lines per test, line max %u, %u args max, seed 0x%08x\n", count, COMMAND_LINE_MAX - 1,
+         COMMAND_MAX_ARGS, rng_state);
+  fuzz_register();
+  fuzz_lines(count / 4);
+  check_numbers();
+  fuzz_numbers(count / 4);
+
+  register_all();
+  bench_stream(count);
+  bench_lookup(count);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,965 @@
+//** ESP32-S3 HoloCubic - 显示驱动主机检查 / Display Driver Checks on the Host
+//**
+//** pio run -e native_display_test -t exec
+//** .pio/build/native_display_test/program fb        # 只跑一项 / one check only
+//**
+//** 驱动跑在TFT_eSPI替身上，像素进假SPI总线的内存面板 - 每项打印自己的报告，出错打印FAIL，任何失败退出码1。
+//** The driver runs on the TFT_eSPI stand-in, pixels land in the fake SPI bus's in-memory panel - each check
+//** prints its own report, failures print FAIL, and any failure exits with 1.
+//**
+//** fb   同一串状态屏帧在立即模式、帧缓冲、帧缓冲+瓦片、帧缓冲+字形缓存下各画一遍，逐帧比较面板像素和推送字节
+//**      The same status-screen frames drawn in immediate mode, framebuffer, framebuffer + tiles and
+//**      framebuffer + glyph cache, comparing panel pixels and bytes pushed frame by frame
+//** flush 异步刷新引擎跑在有传输时间的假总线上：提交不等传输、带的顺序、忙时不发、总线利用率
+//**      The async flush engine on a fake bus with transfer time: submit doesn't wait for the wire, band order,
+//**      nothing sent while busy, bus utilisation
+//** list  一张几十个图元的状态页直接画和经显示列表回放，打印合并前后的SPI命令数，像素必须相同，第二帧必须跳过
+//**      A status page of a few dozen primitives drawn directly and played back through a display list, printing
+//**      the SPI command count before and after batching; pixels must match and the second frame must be skipped
+//** tiles 整屏重绘只改时钟或信号强度的一位：哈希/发送的图块数、省下的字节，和参考画面逐块比出来的变化对照
+//**      Full redraws where only a clock or RSSI digit changes: tiles hashed/sent and bytes saved, checked against
+//**      the tiles that really differ between reference frames
+//** glyphs 小图集上一串查找的命中/未命中/LRU淘汰逐步核对，再报有无缓存时每秒画多少字形 (轮流跑、取最快) 和每屏光栅化几个字
+//**      Hits, misses and LRU evictions checked step by step on a small atlas, then glyphs per second with and
+//**      without the cache (alternating, best trial) and how many glyphs each screen rasterises
+//** pixels 像素内核的标准答案，再在奇数长度、非对齐指针和原地转换下逐位比较标量版和字并行版
+//**      Golden pixel-kernel outputs, then scalar vs word-parallel bit for bit on odd lengths, unaligned
+//**      pointers and in place
+//** console 打印40行，每行之后按ST7789滚动寄存器看到的屏幕和"最后几行从上往下排"的模型比较
+//**      40 lines printed, after each one the screen seen through the ST7789 scroll registers is compared
+//**      against the model "the last few lines from the top down"
+
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+#include <time.h>
+#include "display_driver.h"
+#include "display_fake_spi.h"
+#include "display_glyphs.h"
+#include "display_flush.h"
+#include "display_list.h"
+#include "display_pixels.h"
+#include "display_tiles.h"
+#include "hardware_config.h"
+
+#define PANEL_PIXELS ((uint32_t)HW_DISPLAY_WIDTH * HW_DISPLAY_HEIGHT)
+
+static uint32_t failures;
+
+static uint64_t host_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void fail(const char* check, const char* what) {
+  failures++;
+  if (failures <= 10) printf("FAIL %s: %s\n", check, what);
+}
+
+static display_fake_spi_t spi;
+static uint16_t spi_panel[PANEL_PIXELS];
+
+//** 换成假总线，面板清黑 / Switch to the fake bus with a black panel
+static void use_fake_spi(void) {
+  display_fake_spi_init(&spi, HW_DISPLAY_SPI_FREQ);
+  memset(spi_panel, 0, sizeof(spi_panel));
+  display_fake_spi_panel(&spi, spi_panel, HW_DISPLAY_WIDTH, HW_DISPLAY_HEIGHT);
+  display_set_sink(&spi.sink);
+  display_set_transport(&spi.transport);
+}
+
+//** 回到TFT_eSPI替身自己的面板 / Back to the TFT_eSPI stand-in's own panel
+static void use_tft(void) {
+  display_set_sink(NULL);
+  display_set_transport(NULL);
+  display_clear(DISPLAY_BLACK);
+}
+
+//** 两块面板不同的像素数，第一个不同处写进where / Pixels that differ between two panels, the first one goes
+//** into where
+static uint32_t panel_diff(const uint16_t* a, const uint16_t* b, char* where, size_t size) {
+  uint32_t diff = 0;
+  for (uint32_t i = 0; i < PANEL_PIXELS; i++) {
+    if (a[i] == b[i]) continue;
+    if (!diff) snprintf(where, size, "(%lu,%lu) 0x%04X != 0x%04X", (unsigned long)(i % HW_DISPLAY_WIDTH),
+                        (unsigned long)(i / HW_DISPLAY_WIDTH), b[i], a[i]);
+    diff++;
+  }
+  return diff;
+}
+
+//** ========================================
+//** fb - 帧缓冲 vs 立即模式 / Framebuffer vs Immediate Mode
+//** ========================================
+
+#define FB_FRAMES 40
+#define FB_MODES 4
+
+static const char* const fb_mode_names[FB_MODES] = { "immediate", "fb", "fb_tiles", "fb_glyphs" };
+
+//** 一块状态屏 - 每20帧整屏重画，其余帧只改时钟、进度条、闪点和一段线，文字有被矩形压住的和出屏的
+//** A status screen - a full redraw every 20 frames, the rest only touch the clock, the progress bar, a sparkle
+//** and a line segment; some text is partly covered by a rect and some runs off the screen
+static void fb_draw_frame(uint32_t frame) {
+  char clock[16];
+  if (frame % 20 == 0) {
+    display_clear(DISPLAY_BLACK);
+    display_rect(0, 0, HW_DISPLAY_WIDTH, 24, DISPLAY_BLUE);
+    display_text(8, 4, "HoloCubic", 1, 2, DISPLAY_WHITE, DISPLAY_BLUE);
+    display_rect(8, 40, 100, 60, DISPLAY_CYAN);
+    display_text(12, 44, "WiFi", 1, 1, DISPLAY_BLACK, DISPLAY_CYAN);
+    display_rect(8, 200, 224, 12, DISPLAY_WHITE);
+  }
+
+  //** 先清底再写字 - 帧缓冲模式最常见的写法 / Clear the box, then write - the most common pattern in
+  //** framebuffer mode
+  snprintf(clock, sizeof(clock), "12:%02lu", (unsigned long)(frame % 60));
+  display_rect(120, 40, 112, 24, DISPLAY_BLACK);
+  display_text(124, 44, clock, 1, 2, DISPLAY_GREEN, DISPLAY_BLACK);
+
+  display_rect(8, 200, (int16_t)((frame % 20 + 1) * 11), 12, DISPLAY_MAGENTA);
+  display_pixel((int16_t)(frame * 37 % HW_DISPLAY_WIDTH), (int16_t)(frame * 53 % 80 + 110), DISPLAY_YELLOW);
+  display_line((int16_t)(frame * 6 % HW_DISPLAY_WIDTH), 120, (int16_t)((frame * 6 + 5) % HW_DISPLAY_WIDTH), 180,
+               DISPLAY_RED);
+
+  display_text(8, 110, "status ok", 1, 1, DISPLAY_WHITE, DISPLAY_BLACK);
+  display_rect((int16_t)(8 + frame % 40), 112, 4, 4, DISPLAY_RED);
+  display_text((int16_t)(200 + frame % 8), 228, "edge", 1, 2, DISPLAY_YELLOW, DISPLAY_BLACK);
+}
+
+static bool fb_mode_begin(uint32_t mode) {
+  if (mode == 0) {
+    use_tft();
+    return true;
+  }
+  use_fake_spi();
+  if (!display_framebuffer_enable(true)) return false;
+  display_tiles_enable(mode == 2);
+  return mode != 3 || display_glyph_cache_enable(16 * 1024);
+}
+
+static void fb_mode_end(uint32_t mode) {
+  display_glyph_cache_enable(0);
+  display_tiles_enable(false);
+  display_framebuffer_enable(false);
+}
+
+static void check_fb(void) {
+  static uint16_t reference[FB_FRAMES][PANEL_PIXELS];
+  uint32_t bytes[FB_MODES][FB_FRAMES];
+  uint64_t totals[FB_MODES] = { 0 };
+  char what[160], where[64];
+
+  for (uint32_t mode = 0; mode < FB_MODES; mode++) {
+    if (!fb_mode_begin(mode)) {
+      snprintf(what, sizeof(what), "%s could not be enabled", fb_mode_names[mode]);
+      fail("fb", what);
+      fb_mode_end(mode);
+      continue;
+    }
+
+    for (uint32_t frame = 0; frame < FB_FRAMES; frame++) {
+      uint32_t before = display_get_stats()->bytes;
+      uint64_t spi_before = spi.bytes;
+      fb_draw_frame(frame);
+
+      if (mode == 0) {
+        bytes[mode][frame] = display_get_stats()->bytes - before;
+        memcpy(reference[frame], display_tft()->panel(), sizeof(reference[frame]));
+      } else {
+        display_flush();
+        bytes[mode][frame] = (uint32_t)(spi.bytes - spi_before);
+        uint32_t diff = panel_diff(spi_panel, reference[frame], where, sizeof(where));
+        if (diff) {
+          snprintf(what, sizeof(what), "%s frame %lu: %lu pixels differ, first %s", fb_mode_names[mode],
+                   (unsigned long)frame, (unsigned long)diff, where);
+          fail("fb", what);
+        }
+      }
+      totals[mode] += bytes[mode][frame];
+    }
+    fb_mode_end(mode);
+  }
+
+  printf("# fb: bytes pushed per frame, pixels compared against immediate mode\n");
+  printf("frame,%s,%s,%s,%s\n", fb_mode_names[0], fb_mode_names[1], fb_mode_names[2], fb_mode_names[3]);
+  for (uint32_t frame = 0; frame < FB_FRAMES; frame++) {
+    printf("%lu,%lu,%lu,%lu,%lu\n", (unsigned long)frame, (unsigned long)bytes[0][frame],
+           (unsigned long)bytes[1][frame], (unsigned long)bytes[2][frame], (unsigned long)bytes[3][frame]);
+  }
+  printf("total,%llu,%llu,%llu,%llu\n", (unsigned long long)totals[0], (unsigned long long)totals[1],
+         (unsigned long long)totals[2], (unsigned long long)totals[3]);
+}
+
+//** ========================================
+//** flush - 有传输时间的异步刷新 / Async Flush with Transfer Time
+//** ========================================
+
+//** 每读一次时钟过这么多 - 相当于两次轮询之间CPU做的别的事
+//** Every clock read costs this much - stands for the other work the CPU does between two polls
+#define FLUSH_POLL_COST_US 5
+
+static uint32_t flush_now_us;
+static display_fence_t flush_done_fences[8];
+static uint32_t flush_done_count;
+
+static uint32_t flush_clock(void) {
+  return flush_now_us += FLUSH_POLL_COST_US;
+}
+
+static void flush_done(display_fence_t fence, void* ctx) {
+  if (flush_done_count < 8) flush_done_fences[flush_done_count] = fence;
+  flush_done_count++;
+}
+
+typedef struct {
+  const char* name;
+  uint8_t count;
+  display_rect_t rects[3];
+} flush_frame_t;
+
+//** 整屏、奇数宽度和最后一带不满的几块、空帧 / Full screen, a few blocks with odd widths and a short last band,
+//** an empty frame
+static const flush_frame_t flush_frames[] = {
+  { "full", 1, { { 0, 0, HW_DISPLAY_WIDTH, HW_DISPLAY_HEIGHT } } },
+  { "rects", 3, { { 0, 0, HW_DISPLAY_WIDTH, 24 }, { 17, 50, 101, 33 }, { 201, 231, 39, 9 } } },
+  { "empty", 0, { { 0, 0, 0, 0 } } },
+};
+#define FLUSH_FRAME_COUNT (sizeof(flush_frames) / sizeof(flush_frames[0]))
+
+static void flush_dirty(const flush_frame_t* frame, display_dirty_t* dirty) {
+  display_dirty_clear(dirty);
+  for (uint8_t i = 0; i < frame->count; i++) dirty->rects[i] = frame->rects[i];
+  dirty->count = frame->count;
+}
+
+//** 脏矩形里是源帧，外面没被碰过 - 源帧每个像素的值都不同，带错位了一定对不上
+//** Inside the dirty rects the panel matches the source, outside it is untouched - every source pixel has its
+//** own value, so a misplaced band can't match
+static uint32_t flush_panel_errors(const uint16_t* src, const display_dirty_t* dirty) {
+  uint32_t errors = 0;
+  for (uint32_t i = 0; i < PANEL_PIXELS; i++) {
+    int16_t x = (int16_t)(i % HW_DISPLAY_WIDTH), y = (int16_t)(i / HW_DISPLAY_WIDTH);
+    bool inside = false;
+    for (uint8_t r = 0; r < dirty->count; r++) {
+      const display_rect_t* d = &dirty->rects[r];
+      if (x >= d->x && x < d->x + d->w && y >= d->y && y < d->y + d->h) inside = true;
+    }
+    if (spi_panel[i] != (inside ? src[i] : 0)) errors++;
+  }
+  return errors;
+}
+
+static void check_flush(void) {
+  static uint16_t src[PANEL_PIXELS];
+  static uint16_t band0[HW_DISPLAY_WIDTH * DISPLAY_FLUSH_BAND_LINES], band1[HW_DISPLAY_WIDTH * DISPLAY_FLUSH_BAND_LINES];
+  display_flush_engine_t engine;
+  display_dirty_t dirty;
+  uint32_t violations = 0, short_windows = 0;
+  char what[160];
+
+  for (uint32_t i = 0; i < PANEL_PIXELS; i++) src[i] = (uint16_t)(i * 40503u);  // 奇数乘子是双射 / odd multiplier, a bijection
+
+  use_fake_spi();
+  spi.clock_us = flush_clock;
+  display_flush_engine_init(&engine, &spi.transport, band0, band1, HW_DISPLAY_WIDTH * DISPLAY_FLUSH_BAND_LINES);
+  engine.on_done = flush_done;
+
+  printf("# flush: %lu Hz, %d lines per band, %d us per poll\n", (unsigned long)spi.hz, DISPLAY_FLUSH_BAND_LINES,
+         FLUSH_POLL_COST_US);
+  printf("frame,rects,bands,bus_us,elapsed_us,bus_util_pct,busy_polls,idle_max_us\n");
+  for (uint32_t f = 0; f < FLUSH_FRAME_COUNT; f++) {
+    const flush_frame_t* frame = &flush_frames[f];
+    memset(spi_panel, 0, sizeof(spi_panel));
+    flush_dirty(frame, &dirty);
+    display_fake_spi_reset(&spi);
+    uint32_t bands = engine.bands_sent, polls = engine.busy_polls, done = flush_done_count;
+    uint32_t start = flush_now_us;
+
+    display_fence_t fence = display_flush_engine_submit(&engine, src, HW_DISPLAY_WIDTH, &dirty);
+    if (frame->count && display_flush_engine_reached(&engine, fence)) {
+      snprintf(what, sizeof(what), "%s: submit returned after the transfer finished", frame->name);
+      fail("flush", what);
+    }
+    while (!display_flush_engine_reached(&engine, fence)) display_flush_engine_poll(&engine);
+    uint32_t elapsed = flush_now_us - start;
+
+    uint32_t errors = flush_panel_errors(src, &dirty);
+    if (errors) {
+      snprintf(what, sizeof(what), "%s: %lu pixels wrong on the panel", frame->name, (unsigned long)errors);
+      fail("flush", what);
+    }
+    if (flush_done_count != done + 1 || flush_done_fences[done % 8] != fence) {
+      snprintf(what, sizeof(what), "%s: done callback ran %lu times", frame->name,
+               (unsigned long)(flush_done_count - done));
+      fail("flush", what);
+    }
+
+    //** 整屏时总线应该几乎不停 - 填充藏在传输后面 / For a full screen the bus should hardly ever stop - filling
+    //** hides behind the transfer
+    uint32_t util = elapsed ? (uint32_t)((uint64_t)spi.busy_us * 100 / elapsed) : 100;
+    if (f == 0 && (util < 90 || engine.busy_polls == polls)) {
+      snprintf(what, sizeof(what), "%s: bus busy %lu%% of the flush, %lu busy polls", frame->name,
+               (unsigned long)util, (unsigned long)(engine.busy_polls - polls));
+      fail("flush", what);
+    }
+    violations += spi.busy_violations;
+    short_windows += spi.short_windows;
+    printf("%s,%u,%lu,%lu,%lu,%lu,%lu,%lu\n", frame->name, frame->count, (unsigned long)(engine.bands_sent - bands),
+           (unsigned long)spi.busy_us, (unsigned long)elapsed, (unsigned long)util,
+           (unsigned long)(engine.busy_polls - polls), (unsigned long)spi.idle_max_us);
+  }
+
+  //** 上一帧还在路上时提交 - 先等它完，回调按顺序 / Submit while the previous frame is in flight - it finishes
+  //** first and the callbacks come in order
+  uint32_t done = flush_done_count;
+  flush_dirty(&flush_frames[1], &dirty);
+  display_fake_spi_reset(&spi);
+  display_fence_t first = display_flush_engine_submit(&engine, src, HW_DISPLAY_WIDTH, &dirty);
+  display_fence_t second = display_flush_engine_submit(&engine, src, HW_DISPLAY_WIDTH, &dirty);
+  display_flush_engine_wait(&engine);
+  if (flush_done_count != done + 2 || flush_done_fences[done % 8] != first || flush_done_fences[(done + 1) % 8] != second) {
+    fail("flush", "back-to-back submits: callbacks missing or out of order");
+  }
+
+  violations += spi.busy_violations;
+  short_windows += spi.short_windows;
+  if (violations || short_windows) {
+    snprintf(what, sizeof(what), "%lu window()/send() while busy, %lu windows not filled exactly",
+             (unsigned long)violations, (unsigned long)short_windows);
+    fail("flush", what);
+  }
+  spi.clock_us = NULL;
+}
+
+//** ========================================
+//** list - 显示列表合并前后的SPI命令数 / SPI Commands Before and After Display List Batching
+//** ========================================
+
+//** 每个窗口 CASET + RASET + RAMWR 三条命令 / Every window is three commands: CASET + RASET + RAMWR
+#define LIST_COMMANDS_PER_WINDOW 3
+
+static display_list_t* page_list;  // NULL = 直接画 / NULL = draw directly
+
+static void page_fill(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  if (page_list) display_list_fill(page_list, x, y, w, h, color);
+  else display_rect(x, y, w, h, color);
+}
+
+static void page_line(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+  if (page_list) display_list_line(page_list, x0, y0, x1, y1, color);
+  else display_line(x0, y0, x1, y1, color);
+}
+
+static void page_text(int16_t x, int16_t y, const char* text, uint16_t fg, uint16_t bg) {
+  if (page_list) display_list_text(page_list, x, y, text, 1, 1, fg, bg);
+  else display_text(x, y, text, 1, 1, fg, bg);
+}
+
+//** 像tft_display_test_run()那样的状态页：标题、边框、逐行画的色带、几行标签和值、一排小格子
+//** A status page like tft_display_test_run()'s: a title, a border, colour bands drawn line by line, a few
+//** label/value rows and a row of small cells
+static void list_draw_page(void) {
+  static const uint16_t bands[] = { DISPLAY_RED, DISPLAY_GREEN, DISPLAY_BLUE, DISPLAY_YELLOW };
+  static const char* const labels[] = { "WiFi", "Flash", "SD", "IMU", "Heap" };
+  static const char* const values[] = { "up", "8 MB", "none", "ok", "201 KB" };
+
+  page_fill(0, 0, HW_DISPLAY_WIDTH, HW_DISPLAY_HEIGHT, DISPLAY_BLACK);
+  page_fill(0, 0, HW_DISPLAY_WIDTH, 20, DISPLAY_BLUE);
+  page_text(6, 6, "TFT test", DISPLAY_WHITE, DISPLAY_BLUE);
+
+  page_line(4, 24, 235, 24, DISPLAY_WHITE);
+  page_line(4, 235, 235, 235, DISPLAY_WHITE);
+  page_line(4, 24, 4, 235, DISPLAY_WHITE);
+  page_line(235, 24, 235, 235, DISPLAY_WHITE);
+
+  for (int16_t y = 0; y < 32; y++) {
+    page_line(10, (int16_t)(30 + y), 229, (int16_t)(30 + y), bands[y / 8]);
+  }
+
+  for (int16_t i = 0; i < 5; i++) {
+    page_text(12, (int16_t)(72 + i * 14), labels[i], DISPLAY_CYAN, DISPLAY_BLACK);
+    page_text(80, (int16_t)(72 + i * 14), values[i], DISPLAY_WHITE, DISPLAY_BLACK);
+  }
+
+  for (int16_t i = 0; i < 12; i++) {
+    page_fill((int16_t)(12 + i * 18), 150, 16, 16, (i & 1) ? DISPLAY_MAGENTA : DISPLAY_GREEN);
+  }
+  page_line(12, 190, 227, 220, DISPLAY_YELLOW);
+}
+
+static void check_list(void) {
+  static uint8_t arena[8 * 1024];
+  static uint16_t reference[PANEL_PIXELS];
+  display_list_t list;
+  char what[160];
+
+  use_tft();
+  display_stats_t before = *display_get_stats();
+  page_list = NULL;
+  list_draw_page();
+  uint32_t direct_windows = display_get_stats()->windows - before.windows;
+  uint32_t direct_bytes = display_get_stats()->bytes - before.bytes;
+  memcpy(reference, display_tft()->panel(), sizeof(reference));
+
+  use_tft();
+  display_list_init(&list, arena, sizeof(arena), display_list_target());
+  uint32_t windows[2], bytes[2], commands = 0;
+  bool played[2];
+  for (uint32_t frame = 0; frame < 2; frame++) {
+    before = *display_get_stats();
+    page_list = &list;
+    display_list_begin(&list);
+    list_draw_page();
+    played[frame] = display_list_end(&list);
+    page_list = NULL;
+    windows[frame] = display_get_stats()->windows - before.windows;
+    bytes[frame] = display_get_stats()->bytes - before.bytes;
+    if (frame == 0) commands = list.stats.commands;
+  }
+
+  char where[64];
+  uint32_t diff = panel_diff(display_tft()->panel(), reference, where, sizeof(where));
+  if (diff) {
+    snprintf(what, sizeof(what), "%lu pixels differ from direct drawing, first %s", (unsigned long)diff, where);
+    fail("list", what);
+  }
+  if (!played[0] || windows[0] >= direct_windows) {
+    snprintf(what, sizeof(what), "batching opened %lu windows, direct drawing %lu", (unsigned long)windows[0],
+             (unsigned long)direct_windows);
+    fail("list", what);
+  }
+  if (played[1] || windows[1]) fail("list", "the unchanged second frame was played back");
+
+  printf("# list: %lu commands per frame, %lu arena bytes\n", (unsigned long)commands,
+         (unsigned long)list.last_used);
+  printf("path,windows,spi_commands,pixel_bytes\n");
+  printf("direct,%lu,%lu,%lu\n", (unsigned long)direct_windows,
+         (unsigned long)direct_windows * LIST_COMMANDS_PER_WINDOW, (unsigned long)direct_bytes);
+  printf("batched,%lu,%lu,%lu\n", (unsigned long)windows[0],
+         (unsigned long)windows[0] * LIST_COMMANDS_PER_WINDOW, (unsigned long)bytes[0]);
+  printf("unchanged,%lu,%lu,%lu\n", (unsigned long)windows[1],
+         (unsigned long)windows[1] * LIST_COMMANDS_PER_WINDOW, (unsigned long)bytes[1]);
+}
+
+//** ========================================
+//** tiles - 图块哈希的统计 / Tile Hash Statistics
+//** ========================================
+
+#define TILES_FRAMES 5
+#define TILES_COUNT (DISPLAY_TILES_X * DISPLAY_TILES_Y)
+
+//** 0: 第一帧  1: 原样重画  2: 时钟变一位  3: 信号强度变一位  4: 只重画时钟框
+//** 0: first frame  1: the same redraw  2: one clock digit  3: one RSSI digit  4: only the clock box redrawn
+static void tiles_draw_frame(uint32_t frame) {
+  static const char* const clocks[TILES_FRAMES] = { "12:30", "12:30", "12:31", "12:31", "12:32" };
+  static const char* const rssi[TILES_FRAMES] = { "-61 dBm", "-61 dBm", "-61 dBm", "-62 dBm", "-62 dBm" };
+
+  if (frame < 4) {
+    display_clear(DISPLAY_BLACK);
+    display_rect(0, 0, HW_DISPLAY_WIDTH, 24, DISPLAY_BLUE);
+    display_text(8, 4, "HoloCubic", 1, 2, DISPLAY_WHITE, DISPLAY_BLUE);
+    display_rect(8, 120, 224, 60, DISPLAY_CYAN);
+    display_text(16, 140, rssi[frame], 1, 2, DISPLAY_BLACK, DISPLAY_CYAN);
+  }
+  display_rect(60, 60, 120, 32, DISPLAY_BLACK);
+  display_text(72, 66, clocks[frame], 1, 3, DISPLAY_GREEN, DISPLAY_BLACK);
+}
+
+//** 两张面板之间有像素不同的图块数 / Tiles with any pixel different between two panels
+static uint32_t tiles_changed(const uint16_t* a, const uint16_t* b) {
+  uint32_t changed = 0;
+  for (int16_t ty = 0; ty < DISPLAY_TILES_Y; ty++) {
+    for (int16_t tx = 0; tx < DISPLAY_TILES_X; tx++) {
+      bool differs = false;
+      for (int16_t y = ty * DISPLAY_TILE_SIZE; y < (ty + 1) * DISPLAY_TILE_SIZE && y < HW_DISPLAY_HEIGHT; y++) {
+        for (int16_t x = tx * DISPLAY_TILE_SIZE; x < (tx + 1) * DISPLAY_TILE_SIZE && x < HW_DISPLAY_WIDTH; x++) {
+          if (a[y * HW_DISPLAY_WIDTH + x] != b[y * HW_DISPLAY_WIDTH + x]) differs = true;
+        }
+      }
+      if (differs) changed++;
+    }
+  }
+  return changed;
+}
+
+static void check_tiles(void) {
+  static uint16_t reference[TILES_FRAMES][PANEL_PIXELS];
+  display_tile_stats_t last, total;
+  char what[160], where[64];
+
+  use_tft();
+  for (uint32_t frame = 0; frame < TILES_FRAMES; frame++) {
+    tiles_draw_frame(frame);
+    memcpy(reference[frame], display_tft()->panel(), sizeof(reference[frame]));
+  }
+
+  use_fake_spi();
+  if (!display_framebuffer_enable(true)) {
+    fail("tiles", "framebuffer could not be enabled");
+    return;
+  }
+  display_tiles_enable(true);
+
+  //** 时钟框是60..180 x 60..92，碰到9x3个图块 / The clock box is 60..180 x 60..92 and touches 9x3 tiles
+  const uint32_t box_tiles = (179 / DISPLAY_TILE_SIZE - 60 / DISPLAY_TILE_SIZE + 1) * (91 / DISPLAY_TILE_SIZE - 60 / DISPLAY_TILE_SIZE + 1);
+
+  printf("# tiles: %dx%d tiles of %d px\n", DISPLAY_TILES_X, DISPLAY_TILES_Y, DISPLAY_TILE_SIZE);
+  printf("frame,tiles_hashed,tiles_sent,tiles_changed,bytes_saved,spi_bytes\n");
+  for (uint32_t frame = 0; frame < TILES_FRAMES; frame++) {
+    uint64_t spi_before = spi.bytes;
+    tiles_draw_frame(frame);
+    display_flush();
+    uint32_t sent_bytes = (uint32_t)(spi.bytes - spi_before);
+    display_tile_stats(&last, NULL);
+
+    uint32_t expected_sent = frame ? tiles_changed(reference[frame - 1], reference[frame]) : TILES_COUNT;
+    uint32_t expected_hashed = frame < 4 ? TILES_COUNT : box_tiles;
+    if (last.tiles_hashed != expected_hashed || last.tiles_sent != expected_sent) {
+      snprintf(what, sizeof(what), "frame %lu: hashed %lu sent %lu, expected %lu and %lu", (unsigned long)frame,
+               (unsigned long)last.tiles_hashed, (unsigned long)last.tiles_sent, (unsigned long)expected_hashed,
+               (unsigned long)expected_sent);
+      fail("tiles", what);
+    }
+    if (frame < 4 && last.bytes_saved + sent_bytes != PANEL_PIXELS * sizeof(uint16_t)) {
+      snprintf(what, sizeof(what), "frame %lu: %lu bytes saved + %lu sent is not a full screen", (unsigned long)frame,
+               (unsigned long)last.bytes_saved, (unsigned long)sent_bytes);
+      fail("tiles", what);
+    }
+    uint32_t diff = panel_diff(spi_panel, reference[frame], where, sizeof(where));
+    if (diff) {
+      snprintf(what, sizeof(what), "frame %lu: %lu pixels differ, first %s", (unsigned long)frame,
+               (unsigned long)diff, where);
+      fail("tiles", what);
+    }
+    printf("%lu,%lu,%lu,%lu,%lu,%lu\n", (unsigned long)frame, (unsigned long)last.tiles_hashed,
+           (unsigned long)last.tiles_sent, (unsigned long)expected_sent, (unsigned long)last.bytes_saved,
+           (unsigned long)sent_bytes);
+  }
+
+  display_tile_stats(NULL, &total);
+  printf("total,%lu,%lu,,%lu,\n", (unsigned long)total.tiles_hashed, (unsigned long)total.tiles_sent,
+         (unsigned long)total.bytes_saved);
+  display_tiles_enable(false);
+  display_framebuffer_enable(false);
+}
+
+//** ========================================
+//** glyphs - 字形缓存 / Glyph Cache
+//** ========================================
+
+#define GLYPH_W 6
+#define GLYPH_H 8
+#define GLYPH_SLOTS 4               // 图集正好放下这么多个1号字形 / the atlas holds exactly this many size-1 glyphs
+#define GLYPH_TEXT_TRIALS 9          // 取最快的一次 - 被抢占的那几次扔掉 / best of these - preempted trials are dropped
+#define GLYPH_TEXT_TRIAL_NS 20000000ull  // 每次至少这么久，远大于计时器的抖动 / each at least this long, far above timer noise
+
+static uint32_t glyph_renders;
+
+static void fake_glyph_measure(void* ctx, uint8_t ch, uint8_t font, uint8_t size, int16_t* w, int16_t* h) {
+  *w = (int16_t)(GLYPH_W * size);
+  *h = (int16_t)(GLYPH_H * size);
+}
+
+static uint16_t fake_glyph_pixel(const display_glyph_key_t* key, int32_t i) {
+  return (uint16_t)(key->fg ^ (key->ch * 0x0101u) ^ (uint32_t)i * 31u);
+}
+
+static void fake_glyph_render(void* ctx, const display_glyph_key_t* key, uint16_t* pixels, int16_t w, int16_t h) {
+  glyph_renders++;
+  for (int32_t i = 0; i < (int32_t)w * h; i++) pixels[i] = fake_glyph_pixel(key, i);
+}
+
+static bool glyph_pixels_ok(const display_glyph_key_t* key, const uint16_t* pixels, int16_t w, int16_t h) {
+  for (int32_t i = 0; i < (int32_t)w * h; i++) {
+    if (pixels[i] != fake_glyph_pixel(key, i)) return false;
+  }
+  return true;
+}
+
+//** 每秒画多少字形 - 一屏16行30个字符反复画至少20ms / Glyphs per second - a screen of 16 rows of 30 characters
+//** drawn over and over for at least 20 ms
+static double glyph_text_trial(uint32_t* screens, uint32_t* glyphs_per_screen) {
+  static const char* const lines[2] = { "WiFi up  -61 dBm  ch 6  12:30", "Heap 201 KB  PSRAM 7.9 MB  ok " };
+  uint32_t glyphs = 0;
+  uint64_t start = host_ns(), ns = 0;
+  *screens = 0;
+  do {
+    for (int16_t row = 0; row < 16; row++) {
+      display_text(0, (int16_t)(row * 14), lines[row & 1], 1, 1, DISPLAY_WHITE, DISPLAY_BLACK);
+      glyphs += strlen(lines[row & 1]);
+    }
+    (*screens)++;
+    ns = host_ns() - start;
+  } while (ns < GLYPH_TEXT_TRIAL_NS);
+  *glyphs_per_screen = glyphs / *screens;
+  return glyphs * 1e9 / (double)ns;
+}
+
+static void check_glyphs(void) {
+  static uint8_t atlas[GLYPH_SLOTS * GLYPH_W * GLYPH_H * sizeof(uint16_t)];
+  static const display_glyph_source_t source = { fake_glyph_measure, fake_glyph_render, NULL };
+  display_glyph_cache_t cache;
+  char what[160];
+
+  //** 键的顺序和预期：A B C D满了，之后每次未命中淘汰最久没用的
+  //** Lookups and what to expect: A B C D fill the atlas, after that every miss evicts the least recently used
+  static const char sequence[] = "ABCDAEBADCEA";
+  static const char expected[] = "mmmmhmmhhmmh";
+  display_glyph_cache_init(&cache, atlas, sizeof(atlas), &source);
+  glyph_renders = 0;
+  for (uint32_t i = 0; sequence[i]; i++) {
+    display_glyph_key_t key = { DISPLAY_WHITE, DISPLAY_BLACK, (uint8_t)sequence[i], 1, 1 };
+    uint32_t hits = cache.stats.hits;
+    int16_t w, h;
+    const uint16_t* pixels = display_glyph_get(&cache, &key, &w, &h);
+    bool hit = cache.stats.hits != hits;
+    if (hit != (expected[i] == 'h') || !pixels || !glyph_pixels_ok(&key, pixels, w, h)) {
+      snprintf(what, sizeof(what), "step %lu '%c': %s, expected a %s", (unsigned long)i, sequence[i],
+               !pixels ? "no pixels" : hit ? "hit" : "miss", expected[i] == 'h' ? "hit" : "miss");
+      fail("glyphs", what);
+    }
+  }
+  if (cache.stats.hits != 4 || cache.stats.misses != 8 || cache.stats.evictions != 4 || glyph_renders != 8 ||
+      cache.stats.entries != GLYPH_SLOTS || cache.stats.bytes_used != sizeof(atlas)) {
+    snprintf(what, sizeof(what), "after the sequence: hits %lu misses %lu evictions %lu renders %lu entries %u",
+             (unsigned long)cache.stats.hits, (unsigned long)cache.stats.misses, (unsigned long)cache.stats.evictions,
+             (unsigned long)glyph_renders, cache.stats.entries);
+    fail("glyphs", what);
+  }
+
+  //** 2号字形要整个图集 - 四个全被淘汰；8号比图集大，不缓存
+  //** A size-2 glyph needs the whole atlas - all four are evicted; size 8 is larger than the atlas, not cached
+  display_glyph_key_t big = { DISPLAY_WHITE, DISPLAY_BLACK, 'Z', 1, 2 };
+  display_glyph_key_t huge = { DISPLAY_WHITE, DISPLAY_BLACK, 'Z', 1, 8 };
+  int16_t w, h;
+  const uint16_t* pixels = display_glyph_get(&cache, &big, &w, &h);
+  if (!pixels || cache.stats.evictions != 8 || cache.stats.entries != 1) {
+    snprintf(what, sizeof(what), "size 2: %lu evictions, %u entries", (unsigned long)cache.stats.evictions,
+             cache.stats.entries);
+    fail("glyphs", what);
+  }
+  pixels = display_glyph_get(&cache, &huge, &w, &h);
+  if (pixels || cache.stats.uncacheable != 1 || w != GLYPH_W * 8 || h != GLYPH_H * 8) {
+    fail("glyphs", "size 8: expected an uncacheable miss with its size filled in");
+  }
+
+  printf("# glyphs: %u-byte atlas, %u lookups\n", (unsigned)sizeof(atlas), (unsigned)(strlen(sequence) + 2));
+  printf("hits,misses,evictions,uncacheable,renders\n");
+  printf("%lu,%lu,%lu,%lu,%lu\n", (unsigned long)cache.stats.hits, (unsigned long)cache.stats.misses,
+         (unsigned long)cache.stats.evictions, (unsigned long)cache.stats.uncacheable, (unsigned long)glyph_renders);
+
+  //** 驱动上的吞吐量 - 立即模式、帧缓冲不缓存、帧缓冲加缓存 / Throughput on the driver - immediate mode,
+  //** framebuffer uncached, framebuffer cached
+  //** 主机上假字体几乎不花时间，所以fb_cached和fb_uncached差不多，还略慢 (vs_uncached在0.9-1.0)：
+  //** 缓存每个6x8的字单独拷一次，不缓存是一行一个精灵。缓存在设备上省的是TFT_eSPI真正的字体光栅化，
+  //** 看rasterised_per_screen一列 - 不缓存每屏每个字都画，缓存后只有每次开缓存后第一屏的未命中。
+  //** 两种模式轮流跑：速度各取最快的一次，vs_uncached取相邻两次之比的中位数，机器忙闲对两边一样
+  //** On the host the fake font costs almost nothing, so fb_cached runs level with or slightly below fb_uncached
+  //** (vs_uncached 0.9-1.0): the cache copies each 6x8 glyph separately, uncached draws a whole line as one
+  //** sprite. What the cache saves on the device is TFT_eSPI's real font rasterising, shown in the
+  //** rasterised_per_screen column - uncached draws every glyph on every screen, cached only the misses on the
+  //** first screen after the cache is enabled. The two modes take turns: each rate is its best trial, and
+  //** vs_uncached is the median ratio of neighbouring trials, so a busy host affects both alike
+  use_fake_spi();
+  uint32_t screens = 0, per_screen = 0;
+  double immediate = 0.0, uncached = 0.0, cached = 0.0;
+  for (uint32_t trial = 0; trial < GLYPH_TEXT_TRIALS; trial++) {
+    double rate = glyph_text_trial(&screens, &per_screen);
+    if (rate > immediate) immediate = rate;
+  }
+  if (!display_framebuffer_enable(true)) {
+    fail("glyphs", "framebuffer could not be enabled");
+    return;
+  }
+  uint32_t cached_screens = 0, misses = 0, lookups = 0;
+  double ratios[GLYPH_TEXT_TRIALS];
+  bool spilled = false;
+  for (uint32_t trial = 0; trial < GLYPH_TEXT_TRIALS; trial++) {
+    double rate_uncached = glyph_text_trial(&screens, &per_screen);
+    if (rate_uncached > uncached) uncached = rate_uncached;
+
+    display_glyph_cache_enable(DISPLAY_GLYPH_DEFAULT_BUDGET);
+    double rate = glyph_text_trial(&screens, &per_screen);
+    if (rate > cached) cached = rate;
+    ratios[trial] = rate / rate_uncached;
+    for (uint32_t i = trial; i > 0 && ratios[i] < ratios[i - 1]; i--) {  // 插入排序 / insertion sort
+      double t = ratios[i];
+      ratios[i] = ratios[i - 1];
+      ratios[i - 1] = t;
+    }
+    const display_glyph_stats_t* stats = display_glyph_stats();
+    cached_screens += screens;
+    misses += stats->misses;
+    lookups += stats->hits + stats->misses;
+    if (stats->uncacheable || stats->evictions) spilled = true;
+    display_glyph_cache_enable(0);
+  }
+  printf("# glyph rate: best of %u trials of at least %llu ms, fb_uncached and fb_cached alternating; vs_uncached is "
+         "the median ratio of neighbouring trials\n",
+         (unsigned)GLYPH_TEXT_TRIALS, (unsigned long long)(GLYPH_TEXT_TRIAL_NS / 1000000ull));
+  printf("mode,glyphs_per_s,vs_uncached,rasterised_per_screen,hit_pct\n");
+  printf("immediate,%.0f,,%lu,\n", immediate, (unsigned long)per_screen);
+  printf("fb_uncached,%.0f,1.00,%lu,\n", uncached, (unsigned long)per_screen);
+  printf("fb_cached,%.0f,%.2f,%.3f,%.1f\n", cached, ratios[GLYPH_TEXT_TRIALS / 2], (double)misses / cached_screens,
+         lookups ? (lookups - misses) * 100.0 / lookups : 0.0);
+  if (spilled) fail("glyphs", "the status screen text did not fit the default budget");
+  display_framebuffer_enable(false);
+}
+
+//** ========================================
+//** pixels - 像素格式内核 / Pixel-Format Kernels
+//** ========================================
+
+#define PX_MAX 256
+#define PX_CANARY 0xA5A5
+
+typedef void (*px16_fn)(uint16_t*, const uint16_t*, uint32_t);
+typedef void (*px888_fn)(uint16_t*, const uint8_t*, uint32_t);
+
+//** 手算的答案 - 面板是BGR565，红色在低5位 / Worked out by hand - the panel is BGR565, red in the low 5 bits
+static const struct {
+  uint8_t r, g, b;
+  uint16_t bgr565;
+} px_golden_rgb[] = {
+  { 255, 0, 0, DISPLAY_RED },     { 0, 255, 0, DISPLAY_GREEN }, { 0, 0, 255, DISPLAY_BLUE },
+  { 255, 255, 255, DISPLAY_WHITE }, { 0, 0, 0, DISPLAY_BLACK }, { 8, 4, 8, 0x0821 },
+  { 7, 3, 7, 0x0000 },            { 0x12, 0x34, 0x56, 0x51A2 },
+};
+
+static const uint16_t px_golden_16[][3] = {  // 输入, 字节交换, 红蓝交换 / input, byte swap, channel swap
+  { 0x1234, 0x3412, 0xA222 }, { 0xF800, 0x00F8, 0x001F }, { 0x001F, 0x1F00, 0xF800 },
+  { 0x07E0, 0xE007, 0x07E0 }, { 0xFFFF, 0xFFFF, 0xFFFF },
+};
+
+//** 一种16位内核在一种长度和偏移下和标量版比较，dst两头放哨兵
+//** Compare one 16-bit kernel against scalar at one length and offset, with canaries around dst
+static bool px16_matches(px16_fn scalar, px16_fn wide, uint32_t count, uint32_t src_off, uint32_t dst_off,
+                         bool in_place) {
+  static uint16_t src[PX_MAX + 8], want[PX_MAX + 8], got[PX_MAX + 8];
+  for (uint32_t i = 0; i < PX_MAX + 8; i++) {
+    src[i] = (uint16_t)(i * 0x9E37u + 0x1234u);
+    want[i] = got[i] = PX_CANARY;
+  }
+  if (in_place) {
+    memcpy(want + dst_off, src + src_off, count * sizeof(uint16_t));
+    memcpy(got + dst_off, src + src_off, count * sizeof(uint16_t));
+    scalar(want + dst_off, want + dst_off, count);
+    wide(got + dst_off, got + dst_off, count);
+  } else {
+    scalar(want + dst_off, src + src_off, count);
+    wide(got + dst_off, src + src_off, count);
+  }
+  return memcmp(want, got, sizeof(want)) == 0;
+}
+
+static bool px888_matches(uint32_t count, uint32_t src_off, uint32_t dst_off) {
+  static uint8_t src[PX_MAX * 3 + 8];
+  static uint16_t want[PX_MAX + 8], got[PX_MAX + 8];
+  for (uint32_t i = 0; i < sizeof(src); i++) src[i] = (uint8_t)(i * 167u + 13u);
+  for (uint32_t i = 0; i < PX_MAX + 8; i++) want[i] = got[i] = PX_CANARY;
+  display_px_rgb888_to_bgr565_scalar(want + dst_off, src + src_off, count);
+  display_px_rgb888_to_bgr565_wide(got + dst_off, src + src_off, count);
+  return memcmp(want, got, sizeof(want)) == 0;
+}
+
+static void check_pixels(void) {
+  char what[160];
+  uint32_t cases = 0;
+
+  for (uint32_t i = 0; i < sizeof(px_golden_rgb) / sizeof(px_golden_rgb[0]); i++) {
+    uint8_t rgb[3] = { px_golden_rgb[i].r, px_golden_rgb[i].g, px_golden_rgb[i].b };
+    uint16_t scalar, wide;
+    display_px_rgb888_to_bgr565_scalar(&scalar, rgb, 1);
+    display_px_rgb888_to_bgr565_wide(&wide, rgb, 1);
+    if (scalar != px_golden_rgb[i].bgr565 || wide != px_golden_rgb[i].bgr565) {
+      snprintf(what, sizeof(what), "rgb888 %u,%u,%u -> 0x%04X / 0x%04X, expected 0x%04X", rgb[0], rgb[1], rgb[2],
+               scalar, wide, px_golden_rgb[i].bgr565);
+      fail("pixels", what);
+    }
+  }
+  for (uint32_t i = 0; i < sizeof(px_golden_16) / sizeof(px_golden_16[0]); i++) {
+    uint16_t in = px_golden_16[i][0], out[4];
+    display_px_swap_bytes_scalar(&out[0], &in, 1);
+    display_px_swap_bytes_wide(&out[1], &in, 1);
+    display_px_swap_channels_scalar(&out[2], &in, 1);
+    display_px_swap_channels_wide(&out[3], &in, 1);
+    if (out[0] != px_golden_16[i][1] || out[1] != px_golden_16[i][1] || out[2] != px_golden_16[i][2] ||
+        out[3] != px_golden_16[i][2]) {
+      snprintf(what, sizeof(what), "0x%04X -> swap 0x%04X/0x%04X channels 0x%04X/0x%04X", in, out[0], out[1],
+               out[2], out[3]);
+      fail("pixels", what);
+    }
+  }
+
+  //** 0..67覆盖每种余数，239..241是屏宽附近；偏移一个像素就是非对齐的32位字
+  //** 0..67 covers every remainder, 239..241 sits around the screen width; one pixel off is an unaligned word
+  static const uint32_t extra[] = { 239, 240, 241, PX_MAX };
+  for (uint32_t n = 0; n < 68 + sizeof(extra) / sizeof(extra[0]); n++) {
+    uint32_t count = n < 68 ? n : extra[n - 68];
+    for (uint32_t src_off = 0; src_off < 4; src_off++) {
+      for (uint32_t dst_off = 0; dst_off < 4; dst_off++) {
+        static const char* const names[2] = { "swap_bytes", "swap_channels" };
+        static const px16_fn scalar[2] = { display_px_swap_bytes_scalar, display_px_swap_channels_scalar };
+        static const px16_fn wide[2] = { display_px_swap_bytes_wide, display_px_swap_channels_wide };
+        for (uint32_t k = 0; k < 2; k++) {
+          bool ok = px16_matches(scalar[k], wide[k], count, src_off, dst_off, false);
+          if (src_off == 0) ok = ok && px16_matches(scalar[k], wide[k], count, 0, dst_off, true);
+          if (!ok) {
+            snprintf(what, sizeof(what), "%s: %lu pixels, src +%lu dst +%lu", names[k], (unsigned long)count,
+                     (unsigned long)src_off, (unsigned long)dst_off);
+            fail("pixels", what);
+          }
+          cases++;
+        }
+        //** RGB888的源按字节错开 / RGB888 sources are offset by bytes
+        if (!px888_matches(count, src_off, dst_off)) {
+          snprintf(what, sizeof(what), "rgb888: %lu pixels, src +%lu bytes dst +%lu", (unsigned long)count,
+                   (unsigned long)src_off, (unsigned long)dst_off);
+          fail("pixels", what);
+        }
+        cases++;
+      }
+    }
+  }
+  printf("# pixels: %lu scalar vs word-parallel cases, DISPLAY_PIXELS_WIDE=%d DISPLAY_PIXELS_PIE=%d\n",
+         (unsigned long)cases, DISPLAY_PIXELS_WIDE, DISPLAY_PIXELS_PIE);
+}
+
+//** ========================================
+//** console - 滚动后哪些行可见 / Which Lines Are Visible After Scrolling
+//** ========================================
+
+#define CONSOLE_TOP 24
+#define CONSOLE_HEIGHT 200
+#define CONSOLE_PRINTS 40
+
+//** 参考屏幕：控制台外是开始前的面板，控制台里是最后lines行从上往下排 - 用替身自己的TFT_eSPI画
+//** Reference screen: outside the console the panel from before it began, inside it the last lines lines from
+//** the top down - drawn with a TFT_eSPI stand-in of its own
+static void console_reference(TFT_eSPI* ref, const uint16_t* before, char texts[][24], uint32_t printed,
+                              uint16_t lines, int16_t line_h) {
+  ref->setSwapBytes(true);
+  ref->setAddrWindow(0, 0, HW_DISPLAY_WIDTH, HW_DISPLAY_HEIGHT);
+  ref->pushPixels(before, PANEL_PIXELS);
+  ref->fillRect(0, CONSOLE_TOP, HW_DISPLAY_WIDTH, lines * line_h, DISPLAY_BLACK);
+  ref->setTextFont(1);
+  ref->setTextSize(2);
+  ref->setTextColor(DISPLAY_GREEN, DISPLAY_BLACK);
+  uint32_t first = printed > lines ? printed - lines : 0;
+  for (uint32_t i = first; i < printed; i++) {
+    ref->drawString(texts[i], 0, CONSOLE_TOP + (int32_t)(i - first) * line_h);
+  }
+}
+
+//** 屏幕上看到的和参考不同的像素 / Pixels the screen shows that differ from the reference
+static uint32_t console_diff(const TFT_eSPI* tft, const TFT_eSPI* ref, char* where, size_t size) {
+  uint32_t diff = 0;
+  for (int16_t y = 0; y < HW_DISPLAY_HEIGHT; y++) {
+    for (int16_t x = 0; x < HW_DISPLAY_WIDTH; x++) {
+      uint16_t got = tft->screenPixel(x, y), want = ref->panel()[y * HW_DISPLAY_WIDTH + x];
+      if (got == want) continue;
+      if (!diff) snprintf(where, size, "(%d,%d) 0x%04X != 0x%04X", x, y, got, want);
+      diff++;
+    }
+  }
+  return diff;
+}
+
+//** 控制台上下各画一块，再打印40行：每行之后按ST7789的滚动寄存器看屏幕，必须和"最后几行从上往下排"的模型一致，
+//** 控制台外不变，写满后每行正好一次VSCRSADD；结束后屏幕回到不滚动
+//** Blocks drawn above and below the console, then 40 lines printed: after each one the screen as seen through
+//** the ST7789 scroll registers must match the model "the last few lines from the top down", nothing outside the
+//** console changes, and once full every line costs exactly one VSCRSADD; afterwards the screen is unscrolled
+static void check_console(void) {
+  char what[192], where[64];
+  static uint16_t before[PANEL_PIXELS];
+  static char texts[CONSOLE_PRINTS][24];
+  TFT_eSPI* tft = display_tft();
+  TFT_eSPI ref;
+  ref.init();
+
+  use_tft();
+  display_rect(0, 0, HW_DISPLAY_WIDTH, CONSOLE_TOP, DISPLAY_BLUE);
+  display_text(4, 4, "header", 1, 2, DISPLAY_WHITE, DISPLAY_BLUE);
+  display_rect(0, CONSOLE_TOP + CONSOLE_HEIGHT - 8, HW_DISPLAY_WIDTH,
+               HW_DISPLAY_HEIGHT - CONSOLE_TOP - CONSOLE_HEIGHT + 8, DISPLAY_RED);
+  memcpy(before, tft->panel(), sizeof(before));
+
+  if (!display_console_begin(CONSOLE_TOP, CONSOLE_HEIGHT, 1, 2, DISPLAY_GREEN, DISPLAY_BLACK)) {
+    fail("console", "display_console_begin failed");
+    return;
+  }
+  int16_t line_h = tft->fontHeight();
+  uint16_t lines = (uint16_t)(CONSOLE_HEIGHT / line_h);
+  uint32_t scrolls_before = tft->scrollWrites(), bad_steps = 0;
+
+  for (uint32_t n = 0; n < CONSOLE_PRINTS; n++) {
+    //** 长短不一，旧行留下的尾巴会被看出来 / Varying lengths, so a tail left by an older line would show
+    snprintf(texts[n], sizeof(texts[n]), "%lu%.*s", (unsigned long)n, (int)(n * 7 % 13), "-------------");
+    display_console_print(texts[n]);
+
+    console_reference(&ref, before, texts, n + 1, lines, line_h);
+    uint32_t diff = console_diff(tft, &ref, where, sizeof(where));
+    uint32_t scrolls = tft->scrollWrites() - scrolls_before;
+    uint32_t want_scrolls = n + 1 > lines ? n + 1 - lines : 0;
+    if (diff || scrolls != want_scrolls) {
+      bad_steps++;
+      snprintf(what, sizeof(what), "after %lu lines: %lu pixels differ from the model, first %s; %lu scrolls, "
+               "expected %lu", (unsigned long)(n + 1), (unsigned long)diff, diff ? where : "-",
+               (unsigned long)scrolls, (unsigned long)want_scrolls);
+      fail("console", what);
+    }
+  }
+
+  //** 结束 - 不滚动，控制台区域清成背景色 / End - no scrolling, the console area cleared to the background
+  display_console_end();
+  console_reference(&ref, before, texts, 0, lines, line_h);
+  uint32_t diff = console_diff(tft, &ref, where, sizeof(where));
+  if (diff) {
+    snprintf(what, sizeof(what), "after display_console_end: %lu pixels differ, first %s", (unsigned long)diff, where);
+    fail("console", what);
+  }
+
+  printf("# console: %u lines of %d px at y=%d, %d printed, %lu scrolls, %lu steps off the model\n", lines, line_h,
+         CONSOLE_TOP, CONSOLE_PRINTS, (unsigned long)(tft->scrollWrites() - scrolls_before - 1),
+         (unsigned long)bad_steps);
+}
+
+//** ========================================
+//** 入口 / Entry
+//** ========================================
+
+typedef struct {
+  const char* name;
+  void (*run)(void);
+} display_check_t;
+
+static const display_check_t checks[] = {
+  { "fb", check_fb },
+  { "flush", check_flush },
+  { "list", check_list },
+  { "tiles", check_tiles },
+  { "glyphs", check_glyphs },
+  { "pixels", check_pixels },
+  { "console", check_console },
+};
+#define CHECK_COUNT (sizeof(checks) / sizeof(checks[0]))
+
+int main(int argc, char** argv) {
+  display_init();
+
+  uint32_t ran = 0;
+  for (uint32_t i = 0; i < CHECK_COUNT; i++) {
+    if (argc > 1 && strcmp(argv[1], checks[i].name) != 0) continue;
+    uint32_t before = failures;
+    checks[i].run();
+    printf("%s: %s\n", checks[i].name, failures == before ? "OK" : "FAIL");
+    ran++;
+  }
+  if (!ran) {
+    fprintf(stderr, "unknown check: %s\n", argv[1]);
+    return 2;
+  }
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,125 @@
+//** ESP32-S3 HoloCubic - 事件总线主机基准 / Event Bus Benchmark on the Host
+//**
+//** pio run -e native_event_bench -t exec
+//** .pio/build/native_event_bench/program 2000000     # 每种配置的事件数 / events per configuration
+//**
+//** 吞吐量：发布+分发一个事件的平均耗时，订阅者从1到32个，全部订阅或者每个只订一种类型。
+//** 延迟：一次排入1/8/32个事件再分发，从发布到第一个和最后一个订阅者被调用的时间。
+//** Throughput: average cost to post and dispatch one event with 1 to 32 subscribers, either all
+//** subscribed to everything or each to a single type.
+//** Latency: queue a burst of 1/8/32 events, dispatch, and time from post to the first and the last
+//** subscriber call.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "event_bus.h"
+
+static event_bus_t bus;
+
+static uint64_t host_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+//** 订阅者做一点真正的工作，免得被编译器整个优化掉
+static volatile uint32_t sink;
+
+static void count_handler(const event_t* event, void* ctx) {
+  sink += (uint32_t)event->value;
+}
+
+static void subscribe_all(uint8_t subs, bool selective) {
+  event_bus_init(&bus);
+  for (uint8_t i = 0; i < subs; i++) {
+    uint32_t mask = selective ? EVENT_MASK(i % EVENT_TYPE_COUNT) : EVENT_MASK_ALL;
+    event_subscribe(&bus, mask, count_handler, NULL);
+  }
+}
+
+static void bench_throughput(uint8_t subs, bool selective, uint32_t count) {
+  subscribe_all(subs, selective);
+
+  uint64_t t0 = host_ns();
+  for (uint32_t i = 0; i < count; i++) {
+    event_t event = { (uint16_t)(i % EVENT_TYPE_COUNT), 0, (int32_t)i, 0 };
+    event_bus_post(&bus, &event);
+    //** 和设备上一样：攒几条才分发一次
+    if ((i & 7) == 7) event_bus_dispatch(&bus, 0);
+  }
+  event_bus_dispatch(&bus, 0);
+  uint64_t spent = host_ns() - t0;
+
+  printf("throughput %-9s %4u %10.2f %10.1f %12.2f\n", selective ? "one-type" : "all", subs,
+         (double)count / (spent / 1e9) / 1e6, (double)spent / count, (double)bus.delivered / count);
+}
+
+//** 延迟：value是事件在这一批里的序号，记下每个事件第一个和最后一个订阅者被调用的时刻
+static uint64_t posted_ns[EVENT_BUS_DEPTH];
+static uint64_t first_ns[EVENT_BUS_DEPTH];
+static uint64_t last_ns[EVENT_BUS_DEPTH];
+
+static void latency_handler(const event_t* event, void* ctx) {
+  uint64_t now = host_ns();
+  uint32_t slot = (uint32_t)event->value;
+  if (!first_ns[slot]) first_ns[slot] = now;
+  last_ns[slot] = now;
+}
+
+static int cmp_u64(const void* a, const void* b) {
+  uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+  return x < y ? -1 : x > y;
+}
+
+static void bench_latency(uint8_t subs, uint8_t burst, uint32_t rounds) {
+  event_bus_init(&bus);
+  for (uint8_t i = 0; i < subs; i++) event_subscribe(&bus, EVENT_MASK_ALL, latency_handler, NULL);
+
+  uint64_t* first = (uint64_t*)malloc(sizeof(uint64_t) * rounds * burst);
+  uint64_t* last = (uint64_t*)malloc(sizeof(uint64_t) * rounds * burst);
+  uint32_t n = 0;
+
+  for (uint32_t r = 0; r < rounds; r++) {
+    memset(first_ns, 0, sizeof(first_ns));
+    for (uint8_t i = 0; i < burst; i++) {
+      event_t event = { EVENT_WIFI_STATE, 0, i, 0 };
+      posted_ns[i] = host_ns();
+      event_bus_post(&bus, &event);
+    }
+    event_bus_dispatch(&bus, 0);
+    for (uint8_t i = 0; i < burst; i++, n++) {
+      first[n] = first_ns[i] - posted_ns[i];
+      last[n] = last_ns[i] - posted_ns[i];
+    }
+  }
+
+  qsort(first, n, sizeof(uint64_t), cmp_u64);
+  qsort(last, n, sizeof(uint64_t), cmp_u64);
+  printf("latency    burst=%-3u %4u %10llu %10llu %12llu %10llu\n", burst, subs,
+         (unsigned long long)first[n / 2], (unsigned long long)first[n * 99 / 100],
+         (unsigned long long)last[n / 2], (unsigned long long)last[n * 99 / 100]);
+  free(first);
+  free(last);
+}
+
+int main(int argc, char** argv) {
+  uint32_t count = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : 2000000u;
+  if (count == 0) count = 2000000u;
+
+  printf("# event_bench %u events per configuration, ring %u, %u event types\n", count, EVENT_BUS_DEPTH,
+         EVENT_TYPE_COUNT);
+  printf("test       subscribe  subs   M events/s   ns/event  calls/event\n");
+  static const uint8_t sub_counts[] = { 1, 4, 8, 16, 32 };
+  for (uint8_t s = 0; s < sizeof(sub_counts); s++) bench_throughput(sub_counts[s], false, count);
+  for (uint8_t s = 0; s < sizeof(sub_counts); s++) bench_throughput(sub_counts[s], true, count);
+
+  printf("\ntest       burst      subs  first_p50  first_p99     last_p50   last_p99  (ns)\n");
+  static const uint8_t bursts[] = { 1, 8, 32 };
+  for (uint8_t b = 0; b < sizeof(bursts); b++) {
+    bench_latency(1, bursts[b], count / 256);
+    bench_latency(32, bursts[b], count / 256);
+  }
+  return 0;
+}
@@ -0,0 +1,208 @@
+//** 主机构建用的Arduino替身实现 / Arduino Stand-in for Host Builds
+
+#include "Arduino.h"
+#include <errno.h>
+#include <poll.h>
+#include <stdarg.h>
+#include <time.h>
+#include <unistd.h>
+
+HostSerial Serial;
+EspClass ESP;
+
+//** ========================================
+//** Print
+//** ========================================
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (n < size && write(buffer[n])) n++;
+    return n;
+}
+
+size_t Print::printf(const char* format, ...) {
+    char stack[256];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(stack, sizeof(stack), format, args);
+    va_end(args);
+    if (len < 0) return 0;
+    if ((size_t)len < sizeof(stack)) return write((const uint8_t*)stack, (size_t)len);
+
+    //** 长输出另外分配 / Long output gets its own buffer
+    char* heap = (char*)malloc((size_t)len + 1);
+    if (!heap) return 0;
+    va_start(args, format);
+    vsnprintf(heap, (size_t)len + 1, format, args);
+    va_end(args);
+    size_t n = write((const uint8_t*)heap, (size_t)len);
+    free(heap);
+    return n;
+}
+
+size_t Print::print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+size_t Print::print(char c) { return write((uint8_t)c); }
+size_t Print::print(int value) { return printf("%d", value); }
+size_t Print::print(unsigned int value) { return printf("%u", value); }
+size_t Print::print(long value) { return printf("%ld", value); }
+size_t Print::print(unsigned long value) { return printf("%lu", value); }
+size_t Print::print(double value, int digits) { return printf("%.*f", digits, value); }
+size_t Print::println(void) { return print("\r\n"); }
+size_t Print::println(const char* s) { return print(s) + println(); }
+size_t Print::println(char c) { return print(c) + println(); }
+size_t Print::println(int value) { return print(value) + println(); }
+size_t Print::println(unsigned int value) { return print(value) + println(); }
+size_t Print::println(long value) { return print(value) + println(); }
+size_t Print::println(unsigned long value) { return print(value) + println(); }
+size_t Print::println(double value, int digits) { return print(value, digits) + println(); }
+
+size_t HostSerial::write(uint8_t c) { return write(&c, 1); }
+
+size_t HostSerial::write(const uint8_t* buffer, size_t size) {
+    if (output_fd < 0) return fwrite(buffer, 1, size, stdout);
+    size_t n = 0;
+    while (n < size) {
+        ssize_t put = ::write(output_fd, buffer + n, size - n);
+        if (put < 0) {
+            if (errno != EAGAIN && errno != EINTR) break;
+            struct pollfd pfd = { output_fd, POLLOUT, 0 };
+            poll(&pfd, 1, 100);
+            continue;
+        }
+        n += (size_t)put;
+    }
+    return n;
+}
+void HostSerial::flush(void) { fflush(stdout); }
+
+//** 有空间且stdin可读时才读，读到EOF就不再读 / Reads only when there is room and stdin is readable, stops at EOF
+void HostSerial::poll_input(void) {
+    if (input_fd < 0 || rx_count == HOST_SERIAL_RX_SIZE) return;
+    struct pollfd pfd = { input_fd, POLLIN, 0 };
+    if (poll(&pfd, 1, 0) <= 0) return;
+
+    uint8_t buf[HOST_SERIAL_RX_SIZE];
+    ssize_t got = ::read(input_fd, buf, HOST_SERIAL_RX_SIZE - rx_count);
+    if (got <= 0) {
+        input_fd = -1;
+        return;
+    }
+    inject(buf, (size_t)got);
+}
+
+size_t HostSerial::inject(const uint8_t* data, size_t len) {
+    size_t n = 0;
+    for (; n < len && rx_count < HOST_SERIAL_RX_SIZE; n++, rx_count++) {
+        rx[(rx_head + rx_count) % HOST_SERIAL_RX_SIZE] = data[n];
+    }
+    return n;
+}
+
+int HostSerial::available(void) {
+    poll_input();
+    return (int)rx_count;
+}
+
+int HostSerial::read(void) {
+    int c = peek();
+    if (c >= 0) {
+        rx_head = (rx_head + 1) % HOST_SERIAL_RX_SIZE;
+        rx_count--;
+    }
+    return c;
+}
+
+//** 和HWCDC一样只拿已经到了的，不等 / Like HWCDC, takes only what has arrived, never waits
+size_t HostSerial::read(uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    for (int c; n < size && (c = read()) >= 0; n++) buffer[n] = (uint8_t)c;
+    return n;
+}
+
+int HostSerial::peek(void) {
+    if (rx_count == 0) poll_input();
+    return rx_count ? rx[rx_head] : -1;
+}
+
+//** ========================================
+//** ESP
+//** ========================================
+
+uint32_t EspClass::getCycleCount(void) { return (uint32_t)(host_clock_us() * getCpuFreqMHz()); }
+
+void EspClass::restart(void) {
+    fflush(stdout);
+    fprintf(stderr, "# ESP.restart() at %lu ms\n", millis());
+    exit(3);
+}
+
+//** ========================================
+//** 时间 - 从第一次调用开始计 / Time - counted from the first call
+//** 虚拟时间 = 主机时间 * cpu_scale + 跳过的睡眠 / Virtual time = host time * cpu_scale + skipped sleeps
+//** ========================================
+
+static uint64_t host_now_us(void) {
+    static uint64_t origin = 0;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t now = (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+    if (!origin) origin = now;
+    return now - origin;
+}
+
+static double clock_cpu_scale = 1.0;
+static bool clock_realtime = false;
+static uint64_t clock_skipped_us = 0;
+static uint64_t clock_reads = 0;
+
+void host_clock_config(double cpu_scale, bool realtime) {
+    clock_cpu_scale = cpu_scale;
+    clock_realtime = realtime;
+}
+
+uint64_t host_clock_us(void) {
+    if (clock_realtime) return host_now_us();
+    //** 确定性模式 - 读一次走1us，忙等的循环也能结束 / Deterministic mode - each read costs 1us so busy-waits still end
+    if (clock_cpu_scale <= 0) return clock_skipped_us + clock_reads++;
+    return clock_skipped_us + (uint64_t)((double)host_now_us() * clock_cpu_scale);
+}
+
+void host_clock_advance_to(uint64_t us) {
+    uint64_t now = host_clock_us();
+    if (us <= now) return;
+    if (clock_realtime) {
+        usleep((useconds_t)(us - now));
+    } else {
+        clock_skipped_us += us - now;
+    }
+}
+
+unsigned long millis(void) { return (unsigned long)(uint32_t)(host_clock_us() / 1000u); }
+unsigned long micros(void) { return (unsigned long)(uint32_t)host_clock_us(); }
+
+//** 任务里的delay让出CPU，和vTaskDelay一样；任务外直接拨时钟 / delay() inside a task yields like vTaskDelay;
+//** outside any task it just moves the clock
+void delay(uint32_t ms) {
+    if (xTaskGetCurrentTaskHandle()) {
+        vTaskDelay(pdMS_TO_TICKS(ms));
+    } else {
+        host_clock_advance_to(host_clock_us() + (uint64_t)ms * 1000u);
+    }
+}
+
+void delayMicroseconds(uint32_t us) { host_clock_advance_to(host_clock_us() + us); }
+void yield(void) { taskYIELD(); }
+
+//** ========================================
+//** 硬件 - 空操作 / Hardware - No-ops
+//** ========================================
+
+void pinMode(uint8_t pin, uint8_t mode) {}
+void digitalWrite(uint8_t pin, uint8_t value) {}
+
+double ledcSetup(uint8_t channel, double freq, uint8_t resolution_bits) { return freq; }
+void ledcAttachPin(uint8_t pin, uint8_t channel) {}
+void ledcWrite(uint8_t channel, uint32_t duty) {}
+
+void* ps_malloc(size_t size) { return malloc(size); }
+void* ps_calloc(size_t n, size_t size) { return calloc(n, size); }
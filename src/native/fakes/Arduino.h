@@ -0,0 +1,154 @@
+#pragma once
+
+//** 主机构建用的Arduino替身 - 只有src/用到的部分 / Arduino Stand-in for Host Builds - Only What src/ Uses
+//**
+//** - Serial 写到stdout，从stdin读 / Serial writes to stdout and reads from stdin
+//** - millis()/micros() 是虚拟时钟：主机CPU时间加上跳过的睡眠 / millis()/micros() are a virtual clock:
+//**   host CPU time plus the sleeps that were skipped
+//** - ESP 报固定的内存数字，周期计数由虚拟时钟折算 / ESP reports fixed heap numbers, the cycle count
+//**   is derived from the virtual clock
+//** - ps_malloc() 就是malloc / ps_malloc() is plain malloc
+//** - PWM等硬件调用是空操作 / PWM and other hardware calls are no-ops
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+
+#define ARDUINO_RUNNING_CORE 1      // loop()所在的核，和sdkconfig一致 / the core loop() runs on, as in sdkconfig
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+
+#define IRAM_ATTR
+
+class Print;
+
+class Printable {
+public:
+    virtual ~Printable() {}
+    virtual size_t printTo(Print& p) const = 0;
+};
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size);
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+    size_t print(const char* s);
+    size_t print(char c);
+    size_t print(int value);
+    size_t print(unsigned int value);
+    size_t print(long value);
+    size_t print(unsigned long value);
+    size_t print(double value, int digits = 2);
+    size_t print(const Printable& value) { return value.printTo(*this); }
+    size_t println(void);
+    size_t println(const char* s);
+    size_t println(char c);
+    size_t println(int value);
+    size_t println(unsigned int value);
+    size_t println(long value);
+    size_t println(unsigned long value);
+    size_t println(double value, int digits = 2);
+    size_t println(const Printable& value) { return print(value) + println(); }
+};
+
+class Stream : public Print {
+public:
+    virtual int available(void) = 0;
+    virtual int read(void) = 0;
+    virtual int peek(void) = 0;
+    virtual void flush(void) {}
+};
+
+#define HOST_SERIAL_RX_SIZE 256
+
+//** 串口 - stdout输出，stdin输入 (不阻塞) / Serial - output to stdout, input from stdin (never blocks)
+class HostSerial : public Stream {
+public:
+    HostSerial() : rx_head(0), rx_count(0), input_fd(0), output_fd(-1) {}
+    void begin(unsigned long baud) {}
+    operator bool() const { return true; }
+    size_t write(uint8_t c);
+    size_t write(const uint8_t* buffer, size_t size);
+    int available(void);
+    int read(void);
+    size_t read(uint8_t* buffer, size_t size);
+    int peek(void);
+    void flush(void);
+
+    //** 替身专有 - 换输入源 (-1 = 不读)，直接塞字节 / Fake only - change the input fd (-1 = none), push bytes directly
+    void set_input(int fd) { input_fd = fd; }
+    //** 替身专有 - 输出写到这个fd，写满了等 (-1 = stdout) / Fake only - output goes to this fd, waiting while it is
+    //** full (-1 = stdout)
+    void set_output(int fd) { output_fd = fd; }
+    size_t inject(const uint8_t* data, size_t len);
+
+private:
+    void poll_input(void);
+
+    uint8_t rx[HOST_SERIAL_RX_SIZE];
+    uint32_t rx_head, rx_count;
+    int input_fd;
+    int output_fd;
+};
+
+extern HostSerial Serial;
+
+//** 芯片信息 - 数字是ESP32-S3 N8R8的典型值 / Chip info - typical ESP32-S3 N8R8 numbers
+class EspClass {
+public:
+    uint32_t getFreeHeap(void) { return 256 * 1024; }
+    uint32_t getMinFreeHeap(void) { return 240 * 1024; }
+    uint32_t getHeapSize(void) { return 320 * 1024; }
+    uint32_t getMaxAllocHeap(void) { return 200 * 1024; }
+    uint32_t getPsramSize(void) { return 8 * 1024 * 1024; }
+    uint32_t getFreePsram(void) { return 8 * 1024 * 1024; }
+    uint32_t getCpuFreqMHz(void) { return 240; }
+    uint32_t getCycleCount(void);
+    const char* getChipModel(void) { return "ESP32-S3 (host)"; }
+    uint8_t getChipRevision(void) { return 0; }
+    uint32_t getFlashChipSize(void) { return 8 * 1024 * 1024; }
+    uint32_t getFlashChipSpeed(void) { return 80000000; }
+    uint8_t getFlashChipMode(void) { return 0; }
+    //** 主机上没法重启 - 退出码3 / No restart on the host - exit code 3
+    [[noreturn]] void restart(void);
+};
+
+extern EspClass ESP;
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield(void);
+
+//** 替身专有 - 虚拟时钟 / Fake only - virtual clock
+//** cpu_scale: 主机CPU时间乘这个数记进虚拟时间；0 = 只有睡眠推进时钟，每次读时钟走1us，结果可重复
+//**            host CPU time is multiplied by this; 0 = only sleeps move the clock, each read adds 1us, runs repeat exactly
+//** realtime:  睡眠真的睡，虚拟时间就是墙上时间 / sleeps really sleep, virtual time is wall time
+void host_clock_config(double cpu_scale, bool realtime);
+uint64_t host_clock_us(void);
+void host_clock_advance_to(uint64_t us);
+
+static inline void noInterrupts(void) {}
+static inline void interrupts(void) {}
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+
+double ledcSetup(uint8_t channel, double freq, uint8_t resolution_bits);
+void ledcAttachPin(uint8_t pin, uint8_t channel);
+void ledcWrite(uint8_t channel, uint32_t duty);
+
+void* ps_malloc(size_t size);
+void* ps_calloc(size_t n, size_t size);
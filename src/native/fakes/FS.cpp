@@ -0,0 +1,130 @@
+//** 主机构建用的Arduino FS和SPIFFS替身实现 / Arduino FS and SPIFFS Stand-ins for Host Builds
+
+#include "FS.h"
+#include "SPIFFS.h"
+#include <ftw.h>
+#include <sys/stat.h>
+
+SPIFFSFS SPIFFS;
+
+namespace fs {
+
+//** ========================================
+//** File
+//** ========================================
+
+static void close_file(FILE* fp) {
+    if (fp) fclose(fp);
+}
+
+File::File(FILE* fp, const char* path) : fp_(fp, close_file), name_(strdup(path), free) {}
+
+size_t File::write(uint8_t c) { return write(&c, 1); }
+size_t File::write(const uint8_t* buffer, size_t size) { return fp_ ? fwrite(buffer, 1, size, fp_.get()) : 0; }
+
+int File::available(void) {
+    if (!fp_) return 0;
+    return (int)(size() - position());
+}
+
+int File::read(void) {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int File::peek(void) {
+    if (!fp_) return -1;
+    int c = fgetc(fp_.get());
+    if (c != EOF) ungetc(c, fp_.get());
+    return c == EOF ? -1 : c;
+}
+
+void File::flush(void) {
+    if (fp_) fflush(fp_.get());
+}
+
+size_t File::read(uint8_t* buf, size_t size) { return fp_ ? fread(buf, 1, size, fp_.get()) : 0; }
+
+bool File::seek(uint32_t pos, SeekMode mode) {
+    static const int whence[] = { SEEK_SET, SEEK_CUR, SEEK_END };
+    return fp_ && fseek(fp_.get(), (long)pos, whence[mode]) == 0;
+}
+
+size_t File::position(void) const {
+    if (!fp_) return 0;
+    long pos = ftell(fp_.get());
+    return pos < 0 ? 0 : (size_t)pos;
+}
+
+size_t File::size(void) const {
+    struct stat st;
+    if (!fp_ || fstat(fileno(fp_.get()), &st) != 0) return 0;
+    return (size_t)st.st_size;
+}
+
+const char* File::name(void) const { return name_ ? name_.get() : ""; }
+
+//** ========================================
+//** FS
+//** ========================================
+
+FS::FS(const char* root) { set_root(root); }
+
+void FS::set_root(const char* root) {
+    snprintf(root_, sizeof(root_), "%s", root);
+}
+
+bool FS::host_path(const char* path, char* out, size_t cap) const {
+    if (!path || path[0] != '/') return false;
+    int len = snprintf(out, cap, "%s%s", root_, path);
+    return len > 0 && (size_t)len < cap;
+}
+
+File FS::open(const char* path, const char* mode) {
+    char host[512];
+    if (!host_path(path, host, sizeof(host))) return File();
+
+    //** 只认 r/w/a，都按二进制打开 / Only r/w/a, always binary
+    const char* host_mode = mode[0] == 'w' ? "wb" : mode[0] == 'a' ? "ab" : "rb";
+    struct stat st;
+    if (host_mode[0] == 'r' && (stat(host, &st) != 0 || !S_ISREG(st.st_mode))) return File();
+
+    FILE* fp = fopen(host, host_mode);
+    return fp ? File(fp, path) : File();
+}
+
+bool FS::exists(const char* path) {
+    char host[512];
+    struct stat st;
+    return host_path(path, host, sizeof(host)) && stat(host, &st) == 0;
+}
+
+bool FS::remove(const char* path) {
+    char host[512];
+    return host_path(path, host, sizeof(host)) && ::remove(host) == 0;
+}
+
+}  // namespace fs
+
+//** ========================================
+//** SPIFFS
+//** ========================================
+
+bool SPIFFSFS::begin(bool formatOnFail, const char* basePath, uint8_t maxOpenFiles, const char* partitionLabel) {
+    struct stat st;
+    mounted = mounted || (stat(root_, &st) == 0 && S_ISDIR(st.st_mode)) || formatOnFail;
+    return mounted;
+}
+
+static size_t used_total;
+
+static int add_file_size(const char* path, const struct stat* st, int type, struct FTW* ftw) {
+    if (type == FTW_F) used_total += (size_t)st->st_size;
+    return 0;
+}
+
+size_t SPIFFSFS::usedBytes(void) {
+    used_total = 0;
+    if (mounted) nftw(root_, add_file_size, 8, FTW_PHYS);
+    return used_total;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+//** 主机构建用的Arduino FS替身 - 文件在主机目录里 / Arduino FS Stand-in for Host Builds - Files Live in a Host Directory
+//**
+//** - 设备路径 "/anim/x.lsc" 对应 <根目录>/anim/x.lsc / The device path "/anim/x.lsc" maps to <root>/anim/x.lsc
+//** - File的副本共享同一个打开的文件，和真库一样 / Copies of a File share one open file, as in the real library
+
+#include <memory>
+#include "Arduino.h"
+
+namespace fs {
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+class File : public Stream {
+public:
+    File() {}
+    explicit File(FILE* fp, const char* path);
+
+    size_t write(uint8_t c);
+    size_t write(const uint8_t* buffer, size_t size);
+    int available(void);
+    int read(void);
+    int peek(void);
+    void flush(void);
+    size_t read(uint8_t* buf, size_t size);
+    bool seek(uint32_t pos, SeekMode mode = SeekSet);
+    size_t position(void) const;
+    size_t size(void) const;
+    void close(void) { fp_.reset(); }
+    const char* name(void) const;
+    operator bool() const { return (bool)fp_; }
+
+private:
+    std::shared_ptr<FILE> fp_;
+    std::shared_ptr<char> name_;
+};
+
+class FS {
+public:
+    explicit FS(const char* root);
+
+    File open(const char* path, const char* mode = "r");
+    bool exists(const char* path);
+    bool remove(const char* path);
+
+    //** 替身专有 - 根目录 / Fake only - the root directory
+    void set_root(const char* root);
+    const char* root(void) const { return root_; }
+
+protected:
+    bool host_path(const char* path, char* out, size_t cap) const;
+
+    char root_[256];
+};
+
+}  // namespace fs
+
+using fs::File;
+using fs::FS;
+using fs::SeekMode;
+using fs::SeekSet;
+using fs::SeekCur;
+using fs::SeekEnd;
@@ -0,0 +1,30 @@
+//** 主机构建用的FastLED替身实现 / FastLED Stand-in for Host Builds
+
+#include "FastLED.h"
+#include <string.h>
+
+CFastLED FastLED;
+
+//** 普通六段HSV - 颜色不要求和FastLED的rainbow一致 / Plain six-sector HSV - not FastLED's rainbow mapping
+CRGB::CRGB(const CHSV& hsv) {
+    uint8_t sector = (uint8_t)(hsv.h / 43);
+    uint8_t rem = (uint8_t)((hsv.h - sector * 43) * 6);
+    uint8_t p = (uint8_t)((hsv.v * (255 - hsv.s)) >> 8);
+    uint8_t q = (uint8_t)((hsv.v * (255 - ((hsv.s * rem) >> 8))) >> 8);
+    uint8_t t = (uint8_t)((hsv.v * (255 - ((hsv.s * (255 - rem)) >> 8))) >> 8);
+    switch (sector) {
+        case 0:  r = hsv.v; g = t; b = p; break;
+        case 1:  r = q; g = hsv.v; b = p; break;
+        case 2:  r = p; g = hsv.v; b = t; break;
+        case 3:  r = p; g = q; b = hsv.v; break;
+        case 4:  r = t; g = p; b = hsv.v; break;
+        default: r = hsv.v; g = p; b = q; break;
+    }
+}
+
+void CFastLED::show(void) {
+    show_count++;
+    if (leds && led_count > 0) memcpy(wire, leds, (size_t)led_count * sizeof(CRGB));
+    wire_brightness = brightness;
+    if (on_show) on_show(wire, led_count, brightness);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+//** 主机构建用的FastLED替身 - 灯带换成计数器 / FastLED Stand-in for Host Builds - the Strip Becomes a Counter
+//**
+//** - show() 只计数并拷贝当前帧，设了on_show就交给它 / show() only counts and copies the current frame, and hands it to
+//**   on_show when set
+//** - 只有led_driver用到的接口 / Only the interface led_driver uses
+
+#include <stdint.h>
+#include "Arduino.h"
+
+struct CHSV {
+    uint8_t h, s, v;
+    CHSV() : h(0), s(0), v(0) {}
+    CHSV(uint8_t hue, uint8_t sat, uint8_t val) : h(hue), s(sat), v(val) {}
+};
+
+struct CRGB {
+    uint8_t r, g, b;
+
+    enum HTMLColorCode { Black = 0x000000, White = 0xFFFFFF };
+
+    CRGB() : r(0), g(0), b(0) {}
+    CRGB(uint8_t red, uint8_t green, uint8_t blue) : r(red), g(green), b(blue) {}
+    CRGB(HTMLColorCode code) : r((uint8_t)(code >> 16)), g((uint8_t)(code >> 8)), b((uint8_t)code) {}
+    CRGB(const CHSV& hsv);
+
+    bool operator==(const CRGB& o) const { return r == o.r && g == o.g && b == o.b; }
+    bool operator!=(const CRGB& o) const { return !(*this == o); }
+};
+
+enum EOrder { RGB = 0012, GRB = 0102 };
+
+template <uint8_t DATA_PIN, EOrder RGB_ORDER> class WS2812 {};
+
+#define FASTLED_FAKE_MAX_LEDS 64
+
+class CFastLED {
+public:
+    template <template <uint8_t, EOrder> class CHIPSET, uint8_t DATA_PIN, EOrder RGB_ORDER>
+    void addLeds(CRGB* data, int count) {
+        leds = data;
+        led_count = count < FASTLED_FAKE_MAX_LEDS ? count : FASTLED_FAKE_MAX_LEDS;
+    }
+
+    void setBrightness(uint8_t scale) { brightness = scale; }
+    uint8_t getBrightness(void) { return brightness; }
+    void show(void);
+
+    //** 替身专有 - 发出去的帧和次数 / Fake only - frames sent and how many
+    uint32_t show_count;
+    CRGB wire[FASTLED_FAKE_MAX_LEDS];   // 上次show时的像素，未乘亮度 / pixels at the last show, before brightness
+    uint8_t wire_brightness;
+    void (*on_show)(const CRGB* pixels, int count, uint8_t brightness);   // 灯带的去处 / where the strip goes
+
+    CRGB* leds;
+    int led_count;
+    uint8_t brightness;
+};
+
+extern CFastLED FastLED;
@@ -0,0 +1,251 @@
+//** 主机构建用的FreeRTOS和esp_timer替身实现 / FreeRTOS and esp_timer Stand-ins for Host Builds
+
+#include "freertos/FreeRTOS.h"
+#include "esp_timer.h"
+#include "Arduino.h"
+#include <ucontext.h>
+
+#define HOST_MAX_TASKS   8
+#define HOST_MAX_TIMERS  8
+#define HOST_STACK_MIN   (256 * 1024)   // 主机的printf比设备上费栈 / printf on the host needs far more stack
+#define HOST_NEVER       UINT64_MAX
+
+struct host_task {
+    ucontext_t ctx;
+    void* stack;
+    TaskFunction_t fn;
+    void* arg;
+    const char* name;
+    BaseType_t core;
+    uint32_t notify;
+    bool blocked;
+    bool wants_notify;      // 通知到了就醒 / a notification wakes it
+    bool done;
+    uint64_t wake_us;       // 到这个时间就醒 / wakes at this time
+};
+
+struct esp_timer {
+    esp_timer_cb_t callback;
+    void* arg;
+    const char* name;
+    uint64_t due_us;
+    uint64_t period_us;
+    bool armed;
+    bool used;
+};
+
+static host_task tasks[HOST_MAX_TASKS];
+static uint8_t task_count = 0;
+static uint8_t next_pick = 0;
+static host_task* current = NULL;
+static ucontext_t sched_ctx;
+static uint32_t switches = 0;
+static bool (*stop_check)(void) = NULL;
+
+static esp_timer timers[HOST_MAX_TIMERS];
+
+//** ========================================
+//** 任务 / Tasks
+//** ========================================
+
+static void task_entry(void) {
+    host_task* task = current;
+    task->fn(task->arg);
+    //** FreeRTOS任务不该返回 - 这里只是不再调度它 / FreeRTOS tasks must not return - here it is simply never run again
+    task->done = true;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stack_depth, void* arg,
+                                   UBaseType_t priority, TaskHandle_t* created, BaseType_t core) {
+    if (task_count >= HOST_MAX_TASKS) return pdFAIL;
+
+    size_t stack_size = stack_depth * 8u > HOST_STACK_MIN ? stack_depth * 8u : HOST_STACK_MIN;
+    host_task* task = &tasks[task_count];
+    memset(task, 0, sizeof(*task));
+    task->stack = malloc(stack_size);
+    if (!task->stack) return pdFAIL;
+
+    getcontext(&task->ctx);
+    task->ctx.uc_stack.ss_sp = task->stack;
+    task->ctx.uc_stack.ss_size = stack_size;
+    task->ctx.uc_link = &sched_ctx;
+    makecontext(&task->ctx, task_entry, 0);
+
+    task->fn = fn;
+    task->arg = arg;
+    task->name = name;
+    task->core = core == tskNO_AFFINITY ? 0 : core;
+    task_count++;
+
+    if (created) *created = task;
+    return pdPASS;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) { return current; }
+
+BaseType_t xPortGetCoreID(void) { return current ? current->core : 0; }
+
+//** 切回调度循环，醒来时清掉阻塞状态 / Switch back to the scheduler loop, clear the blocked state on wake-up
+static void task_block(uint64_t wake_us, bool wants_notify) {
+    host_task* task = current;
+    task->blocked = true;
+    task->wake_us = wake_us;
+    task->wants_notify = wants_notify;
+    swapcontext(&task->ctx, &sched_ctx);
+    task->blocked = false;
+}
+
+static uint64_t ticks_to_deadline(TickType_t ticks) {
+    if (ticks == portMAX_DELAY) return HOST_NEVER;
+    return host_clock_us() + (uint64_t)ticks * portTICK_PERIOD_MS * 1000u;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    if (task) task->notify++;
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks) {
+    host_task* task = current;
+    if (!task) return 0;
+    if (task->notify == 0 && ticks) task_block(ticks_to_deadline(ticks), true);
+
+    uint32_t value = task->notify;
+    if (value) task->notify = clear_on_exit ? 0 : value - 1;
+    return value;
+}
+
+void vTaskDelay(TickType_t ticks) {
+    if (!current) return;
+    task_block(ticks ? ticks_to_deadline(ticks) : 0, false);
+}
+
+void host_task_yield(void) {
+    if (current) task_block(0, false);
+}
+
+//** ========================================
+//** esp_timer
+//** ========================================
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* out_handle) {
+    if (!args || !args->callback || !out_handle) return ESP_ERR_INVALID_ARG;
+    for (uint8_t i = 0; i < HOST_MAX_TIMERS; i++) {
+        if (timers[i].used) continue;
+        memset(&timers[i], 0, sizeof(timers[i]));
+        timers[i].callback = args->callback;
+        timers[i].arg = args->arg;
+        timers[i].name = args->name;
+        timers[i].used = true;
+        *out_handle = &timers[i];
+        return ESP_OK;
+    }
+    return ESP_ERR_NO_MEM;
+}
+
+static esp_err_t timer_start(esp_timer_handle_t timer, uint64_t timeout_us, uint64_t period_us) {
+    if (!timer || !timer->used) return ESP_ERR_INVALID_ARG;
+    if (timer->armed) return ESP_ERR_INVALID_STATE;
+    timer->due_us = host_clock_us() + timeout_us;
+    timer->period_us = period_us;
+    timer->armed = true;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us) {
+    return timer_start(timer, timeout_us, 0);
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period_us) {
+    return timer_start(timer, period_us, period_us);
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+    if (!timer || !timer->used) return ESP_ERR_INVALID_ARG;
+    if (!timer->armed) return ESP_ERR_INVALID_STATE;
+    timer->armed = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer) {
+    if (!timer || !timer->used) return ESP_ERR_INVALID_ARG;
+    if (timer->armed) return ESP_ERR_INVALID_STATE;
+    timer->used = false;
+    return ESP_OK;
+}
+
+int64_t esp_timer_get_time(void) { return (int64_t)host_clock_us(); }
+
+//** ========================================
+//** 调度循环 / Scheduler Loop
+//** ========================================
+
+static void fire_timers(uint64_t now) {
+    for (uint8_t i = 0; i < HOST_MAX_TIMERS; i++) {
+        esp_timer* timer = &timers[i];
+        if (!timer->used || !timer->armed || timer->due_us > now) continue;
+        if (timer->period_us) {
+            timer->due_us += timer->period_us;
+        } else {
+            timer->armed = false;
+        }
+        timer->callback(timer->arg);
+    }
+}
+
+static bool task_ready(const host_task* task, uint64_t now) {
+    if (task->done) return false;
+    if (!task->blocked) return true;
+    if (task->wants_notify && task->notify) return true;
+    return task->wake_us <= now;
+}
+
+//** 轮转 - 刚让出的任务排到最后 / Round robin - the task that just yielded goes to the back
+static host_task* pick_ready(uint64_t now) {
+    for (uint8_t n = 0; n < task_count; n++) {
+        uint8_t i = (uint8_t)((next_pick + n) % task_count);
+        if (task_ready(&tasks[i], now)) {
+            next_pick = (uint8_t)((i + 1) % task_count);
+            return &tasks[i];
+        }
+    }
+    return NULL;
+}
+
+static uint64_t next_deadline(void) {
+    uint64_t next = HOST_NEVER;
+    for (uint8_t i = 0; i < HOST_MAX_TIMERS; i++) {
+        if (timers[i].used && timers[i].armed && timers[i].due_us < next) next = timers[i].due_us;
+    }
+    for (uint8_t i = 0; i < task_count; i++) {
+        if (!tasks[i].done && tasks[i].wake_us < next) next = tasks[i].wake_us;
+    }
+    return next;
+}
+
+bool host_rtos_run(uint64_t until_us) {
+    for (;;) {
+        uint64_t now = host_clock_us();
+        if (now >= until_us) return true;
+
+        fire_timers(now);
+        host_task* task = pick_ready(now);
+        if (task) {
+            current = task;
+            switches++;
+            swapcontext(&sched_ctx, &task->ctx);
+            current = NULL;
+            if (stop_check && stop_check()) return true;
+            continue;
+        }
+
+        //** 没有能跑的 - 时钟跳到下一个到期时间 / Nothing can run - jump the clock to the next deadline
+        uint64_t next = next_deadline();
+        if (next == HOST_NEVER) return false;
+        host_clock_advance_to(next < until_us ? next : until_us);
+    }
+}
+
+uint32_t host_rtos_switches(void) { return switches; }
+
+void host_rtos_stop_when(bool (*stop)(void)) { stop_check = stop; }
@@ -0,0 +1,9 @@
+#pragma once
+
+//** 主机构建用的QMI8658替身 - 读数由host_imu_set()给 / QMI8658 Stand-in for Host Builds - Readings Come from host_imu_set()
+
+unsigned char QMI8658_init(void);
+void QMI8658_read_xyz(float acc[3], float gyro[3], unsigned int* tim_count);
+
+//** 替身专有 - 设下一次读到的加速度(mg)和角速度(dps) / Fake only - set the next acceleration (mg) and rate (dps) read
+void host_imu_set(const float acc[3], const float gyro[3]);
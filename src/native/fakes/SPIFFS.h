@@ -0,0 +1,30 @@
+#pragma once
+
+//** 主机构建用的SPIFFS替身 - 默认根目录是data/ (uploadfs上传的目录) / SPIFFS Stand-in for Host Builds - the Root
+//** Defaults to data/ (the directory uploadfs writes)
+//**
+//** - 目录不存在时begin(true)也成功，当作刚格式化的空分区 / begin(true) succeeds on a missing directory, as a freshly
+//**   formatted empty partition
+//** - 总容量是FLASH_8MB.csv里spiffs分区的大小 / Total size is the spiffs partition in FLASH_8MB.csv
+
+#include "FS.h"
+
+#define SPIFFS_HOST_ROOT  "data"
+#define SPIFFS_HOST_BYTES 0x100000
+
+class SPIFFSFS : public fs::FS {
+public:
+    SPIFFSFS() : fs::FS(SPIFFS_HOST_ROOT), mounted(false) {}
+
+    bool begin(bool formatOnFail = false, const char* basePath = "/spiffs", uint8_t maxOpenFiles = 10,
+               const char* partitionLabel = NULL);
+    void end(void) { mounted = false; }
+    bool format(void) { return true; }
+    size_t totalBytes(void) { return SPIFFS_HOST_BYTES; }
+    size_t usedBytes(void);
+
+private:
+    bool mounted;
+};
+
+extern SPIFFSFS SPIFFS;
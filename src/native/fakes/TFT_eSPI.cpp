@@ -0,0 +1,238 @@
+//** 主机构建用的TFT_eSPI替身实现 / TFT_eSPI Stand-in for Host Builds
+
+#include "TFT_eSPI.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GLCD_W 6
+#define GLCD_H 8
+
+TFT_eSPI::TFT_eSPI(int16_t w, int16_t h)
+    : _width(w), _height(h), rotation(0), pixels(NULL), swap_bytes(false),
+      win_x(0), win_y(0), win_w(0), win_h(0), win_pos(0),
+      textfont(1), textsize(1), textcolor(TFT_WHITE), textbgcolor(TFT_BLACK),
+      command(0), data_len(0), scroll_tfa(0), scroll_vsa(ST7789_GRAM_HEIGHT), scroll_vsp(0), scroll_writes(0) {
+}
+
+void TFT_eSPI::init(void) {
+    if (!pixels) pixels = (uint16_t*)calloc((size_t)TFT_WIDTH * TFT_HEIGHT, sizeof(uint16_t));
+}
+
+void TFT_eSPI::setRotation(uint8_t r) {
+    rotation = r;
+    bool portrait = (r & 1) == 0;
+    _width = portrait ? TFT_WIDTH : TFT_HEIGHT;
+    _height = portrait ? TFT_HEIGHT : TFT_WIDTH;
+}
+
+void TFT_eSPI::setAddrWindow(int32_t x, int32_t y, int32_t w, int32_t h) {
+    win_x = x;
+    win_y = y;
+    win_w = w;
+    win_h = h;
+    win_pos = 0;
+}
+
+void TFT_eSPI::pushPixels(const void* data, uint32_t len) {
+    //** swap为true时输入是本机字节序，否则已经是线上字节序 / With swap on the input is native order, else wire order
+    const uint16_t* src = (const uint16_t*)data;
+    for (uint32_t i = 0; i < len && win_w > 0; i++, win_pos++) {
+        uint16_t c = swap_bytes ? src[i] : (uint16_t)((src[i] << 8) | (src[i] >> 8));
+        int32_t x = win_x + win_pos % win_w;
+        int32_t y = win_y + win_pos / win_w;
+        if (pixels && x >= 0 && y >= 0 && x < _width && y < _height) pixels[y * _width + x] = c;
+    }
+}
+
+void TFT_eSPI::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+    if (!pixels) return;
+    int32_t x1 = x + w < _width ? x + w : _width;
+    int32_t y1 = y + h < _height ? y + h : _height;
+    if (x < 0) x = 0;
+    if (y < 0) y = 0;
+    for (int32_t row = y; row < y1; row++) {
+        for (int32_t col = x; col < x1; col++) pixels[row * _width + col] = (uint16_t)color;
+    }
+}
+
+void TFT_eSPI::writecommand(uint8_t c) {
+    command = c;
+    data_len = 0;
+}
+
+//** 只解码垂直滚动的两个命令，参数都是高字节在前的16位数 / Only the two vertical scroll commands are decoded,
+//** their parameters are 16-bit, high byte first
+void TFT_eSPI::writedata(uint8_t d) {
+    if (data_len < sizeof(data)) data[data_len++] = d;
+    if (command == 0x33 && data_len == 6) {             // VSCRDEF: TFA, VSA, BFA
+        scroll_tfa = (uint16_t)(data[0] << 8 | data[1]);
+        scroll_vsa = (uint16_t)(data[2] << 8 | data[3]);
+    } else if (command == 0x37 && data_len == 2) {      // VSCRSADD: VSP
+        scroll_vsp = (uint16_t)(data[0] << 8 | data[1]);
+        scroll_writes++;
+    }
+}
+
+uint16_t TFT_eSPI::screenPixel(int32_t x, int32_t y) const {
+    //** 滚动区里第y行显示从VSP起往下数的那行显存，到区尾绕回区首
+    //** Row y of the scroll area shows the memory row that many rows after VSP, wrapping at the end of the area
+    int32_t row = y;
+    if (scroll_vsa && y >= scroll_tfa && y < scroll_tfa + scroll_vsa) {
+        row = scroll_tfa + (y - scroll_tfa + (int32_t)scroll_vsp - scroll_tfa + scroll_vsa) % scroll_vsa;
+    }
+    if (!pixels || x < 0 || row < 0 || x >= _width || row >= _height) return 0;
+    return pixels[row * _width + x];
+}
+
+uint16_t TFT_eSPI::readPixel(int32_t x, int32_t y) {
+    if (!pixels || x < 0 || y < 0 || x >= _width || y >= _height) return 0;
+    return pixels[y * _width + x];
+}
+
+int16_t TFT_eSPI::textWidth(const char* string) {
+    return (int16_t)(strlen(string) * GLCD_W * textsize);
+}
+
+int16_t TFT_eSPI::fontHeight(int16_t font) {
+    return (int16_t)(GLCD_H * textsize);
+}
+
+int16_t TFT_eSPI::drawString(const char* string, int32_t x, int32_t y) {
+    //** 背景色的字符格里5x7个点，点阵由字符码算出 - 不是真字形，但不同字符的像素不同
+    //** A 5x7 dot grid inside a background cell, lit from the character code - not the real glyph, but different
+    //** characters give different pixels
+    int32_t cw = GLCD_W * textsize;
+    int32_t ch = GLCD_H * textsize;
+    for (const char* c = string; *c; c++, x += cw) {
+        fillRect(x, y, cw, ch, textbgcolor);
+        if (*c == ' ') continue;
+        uint64_t bits = ((uint64_t)(uint8_t)*c * 0x9E3779B97F4A7C15ull) >> 16;
+        for (int32_t dot = 0; dot < (GLCD_W - 1) * (GLCD_H - 1); dot++) {
+            if (!((bits >> dot) & 1)) continue;
+            fillRect(x + dot % (GLCD_W - 1) * textsize, y + dot / (GLCD_W - 1) * textsize, textsize, textsize, textcolor);
+        }
+    }
+    return textWidth(string);
+}
+
+TFT_eSprite::TFT_eSprite(TFT_eSPI* tft) : TFT_eSPI(0, 0) {
+}
+
+void* TFT_eSprite::createSprite(int16_t w, int16_t h, uint8_t frames) {
+    deleteSprite();
+    pixels = (uint16_t*)calloc((size_t)w * h, sizeof(uint16_t));
+    if (pixels) {
+        _width = w;
+        _height = h;
+    }
+    return pixels;
+}
+
+void TFT_eSprite::deleteSprite(void) {
+    free(pixels);
+    pixels = NULL;
+    _width = 0;
+    _height = 0;
+}
+
+//** ========================================
+//** PNG - zlib只用不压缩的块，不依赖库 / zlib with stored blocks only, no library needed
+//** ========================================
+
+static uint32_t png_crc(uint32_t crc, const uint8_t* data, size_t len) {
+    static uint32_t table[256];
+    if (!table[1]) {
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[n] = c;
+        }
+    }
+    for (size_t i = 0; i < len; i++) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+static void png_be32(uint8_t* out, uint32_t v) {
+    out[0] = (uint8_t)(v >> 24);
+    out[1] = (uint8_t)(v >> 16);
+    out[2] = (uint8_t)(v >> 8);
+    out[3] = (uint8_t)v;
+}
+
+static bool png_chunk(FILE* fp, const char* type, const uint8_t* data, uint32_t len) {
+    uint8_t head[8];
+    png_be32(head, len);
+    memcpy(head + 4, type, 4);
+    uint32_t crc = png_crc(0xFFFFFFFFu, head + 4, 4);
+    crc = png_crc(crc, data, len) ^ 0xFFFFFFFFu;
+    uint8_t tail[4];
+    png_be32(tail, crc);
+    return fwrite(head, 1, 8, fp) == 8 && fwrite(data, 1, len, fp) == len && fwrite(tail, 1, 4, fp) == 4;
+}
+
+bool TFT_eSPI::savePNG(const char* path) const {
+    if (!pixels || _width <= 0 || _height <= 0) return false;
+
+    //** 每行一个过滤字节(0)再跟RGB / Each row is a filter byte (0) followed by RGB
+    size_t stride = (size_t)_width * 3 + 1;
+    size_t raw_len = stride * (size_t)_height;
+    size_t blocks = (raw_len + 65534) / 65535;
+    size_t zlen = 2 + blocks * 5 + raw_len + 4;
+    uint8_t* raw = (uint8_t*)malloc(raw_len);
+    uint8_t* z = (uint8_t*)malloc(zlen);
+    if (!raw || !z) {
+        free(raw);
+        free(z);
+        return false;
+    }
+
+    for (int32_t y = 0; y < _height; y++) {
+        uint8_t* row = raw + (size_t)y * stride;
+        row[0] = 0;
+        for (int32_t x = 0; x < _width; x++) {
+            uint16_t c = pixels[y * _width + x];
+            uint8_t r = (uint8_t)((c >> 11) & 0x1F), g = (uint8_t)((c >> 5) & 0x3F), b = (uint8_t)(c & 0x1F);
+            row[1 + x * 3] = (uint8_t)((r << 3) | (r >> 2));
+            row[2 + x * 3] = (uint8_t)((g << 2) | (g >> 4));
+            row[3 + x * 3] = (uint8_t)((b << 3) | (b >> 2));
+        }
+    }
+
+    uint8_t* out = z;
+    *out++ = 0x78;
+    *out++ = 0x01;
+    uint32_t a = 1, b = 0;
+    for (size_t pos = 0; pos < raw_len;) {
+        uint16_t len = (uint16_t)(raw_len - pos > 65535 ? 65535 : raw_len - pos);
+        *out++ = pos + len == raw_len ? 1 : 0;
+        *out++ = (uint8_t)len;
+        *out++ = (uint8_t)(len >> 8);
+        *out++ = (uint8_t)~len;
+        *out++ = (uint8_t)(~len >> 8);
+        memcpy(out, raw + pos, len);
+        for (uint16_t i = 0; i < len; i++) {
+            a = (a + raw[pos + i]) % 65521;
+            b = (b + a) % 65521;
+        }
+        out += len;
+        pos += len;
+    }
+    png_be32(out, (b << 16) | a);
+
+    uint8_t ihdr[13];
+    png_be32(ihdr, (uint32_t)_width);
+    png_be32(ihdr + 4, (uint32_t)_height);
+    ihdr[8] = 8;    // 每通道8位 / 8 bits per channel
+    ihdr[9] = 2;    // RGB
+    ihdr[10] = ihdr[11] = ihdr[12] = 0;
+
+    static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    FILE* fp = fopen(path, "wb");
+    bool ok = fp && fwrite(signature, 1, 8, fp) == 8 && png_chunk(fp, "IHDR", ihdr, 13) &&
+              png_chunk(fp, "IDAT", z, (uint32_t)zlen) && png_chunk(fp, "IEND", NULL, 0);
+    if (fp) ok = fclose(fp) == 0 && ok;
+    free(raw);
+    free(z);
+    return ok;
+}
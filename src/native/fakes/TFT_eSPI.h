@@ -0,0 +1,111 @@
+#pragma once
+
+//** 主机构建用的TFT_eSPI替身 - 画进内存里的面板 / TFT_eSPI Stand-in for Host Builds - Draws into an In-Memory Panel
+//**
+//** - 只有显示驱动用到的接口 / Only the interface the display driver uses
+//** - 面板按本机字节序存RGB565，setSwapBytes语义和真库一致 / The panel holds native-order RGB565,
+//**   setSwapBytes behaves as in the real library
+//** - 文字按GLCD字体 (6x8) 的度量画字符格，格里的点阵由字符码算出 - 像素不是真字形，但每个字符不同，字节数对
+//**   Text draws cells with GLCD (6x8) metrics, dots inside computed from the character code - not the real
+//**   glyphs, but distinct per character, and byte counts are right
+//** - 面板内存就是显存；VSCRDEF/VSCRSADD命令被解码，screenPixel() 按滚动寄存器给出屏幕上看到的像素
+//**   The panel memory is the frame memory; VSCRDEF/VSCRSADD commands are decoded, and screenPixel() gives
+//**   what the screen shows under the scroll registers
+//** - 没有DMA，initDMA返回false / No DMA, initDMA returns false
+//** - savePNG() 把面板存成PNG (不压缩) / savePNG() writes the panel as an (uncompressed) PNG
+
+#include <stdint.h>
+
+//** Setup24_ST7789.h 里驱动检查的配置 / The Setup24_ST7789.h settings the driver checks
+#define LOAD_GLCD
+#define TFT_MISO -1
+#define TFT_MOSI 42
+#define TFT_SCLK 41
+#define TFT_CS -1
+#define TFT_DC 40
+#define TFT_RST 45
+#define TFT_BL 46
+#define SPI_FREQUENCY 40000000
+
+#define TFT_WIDTH 240
+#define TFT_HEIGHT 240
+
+#define ST7789_DISPON 0x29
+#define ST7789_GRAM_HEIGHT 320
+
+#define TFT_BLACK 0x0000
+#define TFT_WHITE 0xFFFF
+
+class TFT_eSPI {
+public:
+    TFT_eSPI(int16_t w = TFT_WIDTH, int16_t h = TFT_HEIGHT);
+    ~TFT_eSPI() {}
+
+    void begin(void) { init(); }
+    void init(void);
+    bool initDMA(bool ctrl_cs = false) { return false; }
+    bool dmaBusy(void) { return false; }
+    void dmaWait(void) {}
+
+    void setRotation(uint8_t r);
+    uint8_t getRotation(void) { return rotation; }
+    int16_t width(void) { return _width; }
+    int16_t height(void) { return _height; }
+
+    void writecommand(uint8_t c);
+    void writedata(uint8_t d);
+
+    void setSwapBytes(bool swap) { swap_bytes = swap; }
+    bool getSwapBytes(void) { return swap_bytes; }
+
+    void startWrite(void) {}
+    void endWrite(void) {}
+    void setAddrWindow(int32_t x, int32_t y, int32_t w, int32_t h);
+    void pushPixels(const void* data, uint32_t len);
+    void pushPixelsDMA(uint16_t* data, uint32_t len) { pushPixels(data, len); }
+
+    void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+    void fillScreen(uint32_t color) { fillRect(0, 0, _width, _height, color); }
+    uint16_t readPixel(int32_t x, int32_t y);
+
+    void setTextFont(uint8_t font) { textfont = font; }
+    void setTextSize(uint8_t size) { textsize = size ? size : 1; }
+    void setTextColor(uint16_t fg, uint16_t bg) { textcolor = fg; textbgcolor = bg; }
+    int16_t textWidth(const char* string);
+    int16_t fontHeight(int16_t font);
+    int16_t fontHeight(void) { return fontHeight(textfont); }
+    int16_t drawString(const char* string, int32_t x, int32_t y);
+
+    //** 面板内容 - 行优先，宽 = width() / Panel contents - row-major, stride = width()
+    const uint16_t* panel(void) const { return pixels; }
+    //** 替身专有 - 面板存成24位PNG / Fake only - save the panel as a 24-bit PNG
+    bool savePNG(const char* path) const;
+    //** 替身专有 - 屏幕(x, y)经垂直滚动映射后显示的像素，和VSCRSADD写了几次
+    //** Fake only - the pixel shown at screen (x, y) through the vertical scroll mapping, and VSCRSADD write count
+    uint16_t screenPixel(int32_t x, int32_t y) const;
+    uint32_t scrollWrites(void) const { return scroll_writes; }
+
+protected:
+    int16_t _width, _height;
+    uint8_t rotation;
+    uint16_t* pixels;
+    bool swap_bytes;
+    int32_t win_x, win_y, win_w, win_h, win_pos;
+    uint8_t textfont, textsize;
+    uint16_t textcolor, textbgcolor;
+    uint8_t command, data[6], data_len;
+    uint16_t scroll_tfa, scroll_vsa, scroll_vsp;
+    uint32_t scroll_writes;
+};
+
+//** 精灵 - 同样的接口画进自己的缓冲 / Sprite - the same interface drawing into its own buffer
+class TFT_eSprite : public TFT_eSPI {
+public:
+    explicit TFT_eSprite(TFT_eSPI* tft);
+    ~TFT_eSprite() { deleteSprite(); }
+
+    void setColorDepth(int8_t bits) {}
+    void* createSprite(int16_t w, int16_t h, uint8_t frames = 1);
+    void deleteSprite(void);
+    void fillSprite(uint32_t color) { fillRect(0, 0, _width, _height, color); }
+};
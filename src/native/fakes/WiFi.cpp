@@ -0,0 +1,131 @@
+//** 主机构建用的WiFi替身实现 / WiFi Stand-in for Host Builds
+
+#include "WiFi.h"
+
+WiFiClass WiFi;
+
+WiFiClass::WiFiClass()
+    : event_count_(0), next_event_(0), mode_(WIFI_OFF), link_(LINK_IDLE), ap_up_(false), started_(false),
+      forced_(false), forced_status_(WL_IDLE_STATUS),
+      connect_start_ms_(0), connect_delay_ms_(2000), rssi_(-55), last_status_(WL_IDLE_STATUS), transitions_(0) {
+    script("0:up");
+}
+
+bool WiFiClass::script(const char* timeline) {
+    event_count_ = 0;
+    next_event_ = 0;
+    const char* p = timeline;
+    while (*p) {
+        if (event_count_ >= WIFI_HOST_MAX_EVENTS) return false;
+        event_t* event = &events_[event_count_];
+
+        char* end;
+        event->at_ms = (uint32_t)strtoul(p, &end, 10);
+        if (end == p || *end != ':') return false;
+        p = end + 1;
+
+        if (strncmp(p, "up", 2) == 0) {
+            event->action = ACTION_UP;
+            p += 2;
+        } else if (strncmp(p, "down", 4) == 0) {
+            event->action = ACTION_DOWN;
+            p += 4;
+        } else if (strncmp(p, "rssi=", 5) == 0 || strncmp(p, "delay=", 6) == 0) {
+            event->action = p[0] == 'r' ? ACTION_RSSI : ACTION_DELAY;
+            p = strchr(p, '=') + 1;
+            event->value = (int32_t)strtol(p, &end, 10);
+            if (end == p) return false;
+            p = end;
+        } else {
+            return false;
+        }
+
+        //** 必须按时间排好 / Must be in time order
+        if (event_count_ && event->at_ms < events_[event_count_ - 1].at_ms) return false;
+        event_count_++;
+        if (*p == ',') p++;
+        else if (*p) return false;
+    }
+    return true;
+}
+
+//** 到时间的时间线事件按自己的时间生效，不是按调用status()的时间 / Due events take effect at their own time,
+//** not at the time status() happened to be called
+void WiFiClass::update(void) {
+    uint32_t now = millis();
+    while (next_event_ < event_count_ && (int32_t)(now - events_[next_event_].at_ms) >= 0) {
+        const event_t* event = &events_[next_event_++];
+        switch (event->action) {
+        case ACTION_UP:
+            if (!ap_up_ && link_ == LINK_CONNECTING) connect_start_ms_ = event->at_ms;
+            ap_up_ = true;
+            break;
+        case ACTION_DOWN:
+            ap_up_ = false;
+            if (link_ == LINK_CONNECTED) link_ = LINK_LOST;
+            break;
+        case ACTION_RSSI:
+            rssi_ = (int8_t)event->value;
+            break;
+        case ACTION_DELAY:
+            connect_delay_ms_ = (uint32_t)event->value;
+            break;
+        }
+    }
+    if (link_ == LINK_CONNECTING && ap_up_ && now - connect_start_ms_ >= connect_delay_ms_) link_ = LINK_CONNECTED;
+}
+
+void WiFiClass::connect(void) {
+    update();
+    started_ = true;
+    link_ = LINK_CONNECTING;
+    connect_start_ms_ = millis();
+}
+
+wl_status_t WiFiClass::begin(const char* ssid, const char* passphrase) {
+    connect();
+    return status();
+}
+
+bool WiFiClass::reconnect(void) {
+    if (!started_) return false;
+    connect();
+    return true;
+}
+
+bool WiFiClass::disconnect(bool wifioff) {
+    update();
+    link_ = LINK_IDLE;
+    return true;
+}
+
+wl_status_t WiFiClass::link_status(void) const {
+    switch (link_) {
+    case LINK_CONNECTED: return WL_CONNECTED;
+    case LINK_LOST:      return WL_CONNECTION_LOST;
+    case LINK_CONNECTING:
+    case LINK_IDLE:      return started_ ? WL_DISCONNECTED : WL_IDLE_STATUS;
+    default:             return WL_IDLE_STATUS;
+    }
+}
+
+wl_status_t WiFiClass::status(void) {
+    update();
+    wl_status_t status = forced_ ? forced_status_ : link_status();
+    if (status != last_status_) {
+        last_status_ = status;
+        transitions_++;
+    }
+    return status;
+}
+
+//** 回放时原样报记录里的值，设备没连上时读到的也是记录下来的 / When replaying, report the recorded value as is,
+//** including whatever the device read while disconnected
+int8_t WiFiClass::RSSI(void) {
+    if (forced_) return rssi_;
+    return status() == WL_CONNECTED ? rssi_ : 0;
+}
+
+IPAddress WiFiClass::localIP(void) {
+    return status() == WL_CONNECTED ? IPAddress(192, 168, 4, 2) : IPAddress();
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+//** 主机构建用的WiFi替身 - 连接按脚本的时间线走 / WiFi Stand-in for Host Builds - Connections Follow a Scripted Timeline
+//**
+//** 时间线是逗号分隔的 "毫秒:动作" / The timeline is a comma-separated list of "ms:action":
+//**   up          AP出现，正在连的在delay毫秒后连上 / the AP appears, a pending connect succeeds delay ms later
+//**   down        AP消失，已连上的变成WL_CONNECTION_LOST / the AP disappears, a live link becomes WL_CONNECTION_LOST
+//**   rssi=-70    之后报的信号强度 / signal strength reported from then on
+//**   delay=2000  之后每次连接要多久 / how long each connect takes from then on
+//** 例 / Example: "0:up,30000:down,45000:up,60000:rssi=-85"
+//** 默认 "0:up"，连接2秒，RSSI -55 / Default "0:up", 2 s connects, RSSI -55
+
+#include "Arduino.h"
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_SCAN_COMPLETED = 2,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED = 6,
+} wl_status_t;
+
+typedef enum {
+    WIFI_OFF = 0,
+    WIFI_STA = 1,
+    WIFI_AP = 2,
+    WIFI_AP_STA = 3,
+} wifi_mode_t;
+
+class IPAddress : public Printable {
+public:
+    IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) { bytes[0] = a; bytes[1] = b; bytes[2] = c; bytes[3] = d; }
+    uint8_t operator[](int i) const { return bytes[i]; }
+    size_t printTo(Print& p) const { return p.printf("%u.%u.%u.%u", bytes[0], bytes[1], bytes[2], bytes[3]); }
+
+private:
+    uint8_t bytes[4];
+};
+
+#define WIFI_HOST_MAX_EVENTS 32
+
+class WiFiClass {
+public:
+    WiFiClass();
+
+    bool mode(wifi_mode_t m) { mode_ = m; return true; }
+    wifi_mode_t getMode(void) { return mode_; }
+    wl_status_t begin(const char* ssid, const char* passphrase = NULL);
+    bool reconnect(void);
+    bool disconnect(bool wifioff = false);
+    wl_status_t status(void);
+    bool isConnected(void) { return status() == WL_CONNECTED; }
+    int8_t RSSI(void);
+    IPAddress localIP(void);
+
+    //** 替身专有 - 设时间线，格式不对返回false / Fake only - set the timeline, false on a malformed one
+    bool script(const char* timeline);
+    //** 替身专有 - status()报过的状态变化次数 / Fake only - status changes status() has reported
+    uint32_t transitions(void) const { return transitions_; }
+    //** 替身专有 - 回放用：之后status()/RSSI()只报给的值，时间线不再起作用 / Fake only - for replay: from then on
+    //** status()/RSSI() report exactly these values and the timeline no longer applies
+    void force_status(wl_status_t status) { forced_ = true; forced_status_ = status; }
+    void force_rssi(int8_t rssi) { forced_ = true; rssi_ = rssi; }
+
+private:
+    enum link_t { LINK_IDLE, LINK_CONNECTING, LINK_CONNECTED, LINK_LOST };
+    enum action_t { ACTION_UP, ACTION_DOWN, ACTION_RSSI, ACTION_DELAY };
+
+    struct event_t {
+        uint32_t at_ms;
+        uint8_t action;
+        int32_t value;
+    };
+
+    void update(void);
+    wl_status_t link_status(void) const;
+    void connect(void);
+
+    event_t events_[WIFI_HOST_MAX_EVENTS];
+    uint8_t event_count_, next_event_;
+    wifi_mode_t mode_;
+    link_t link_;
+    bool ap_up_, started_, forced_;
+    wl_status_t forced_status_;
+    uint32_t connect_start_ms_, connect_delay_ms_;
+    int8_t rssi_;
+    wl_status_t last_status_;
+    uint32_t transitions_;
+};
+
+extern WiFiClass WiFi;
@@ -0,0 +1,19 @@
+#pragma once
+
+//** 主机构建用的I2C替身 - 总线上什么都没有 / I2C Stand-in for Host Builds - Nothing on the Bus
+
+#include "Arduino.h"
+
+class TwoWire {
+public:
+    bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0) { return true; }
+    bool setClock(uint32_t frequency) { return true; }
+    void setTimeout(uint16_t timeout_ms) {}
+    void beginTransmission(uint8_t address) {}
+    uint8_t endTransmission(bool stop = true) { return 2; }    // 2 = 地址没有应答 / address NACK
+    uint8_t requestFrom(uint8_t address, uint8_t len) { return 0; }
+    int available(void) { return 0; }
+    int read(void) { return -1; }
+};
+
+extern TwoWire Wire;
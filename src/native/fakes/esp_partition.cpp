@@ -0,0 +1,70 @@
+//** 主机构建用的分区表替身实现 / Partition Table Stand-in for Host Builds
+
+#include "esp_partition.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HOST_MAX_PARTITIONS 4
+
+typedef struct {
+    esp_partition_t part;
+    uint8_t* data;
+} host_partition_t;
+
+static host_partition_t partitions[HOST_MAX_PARTITIONS];
+static uint8_t partition_count = 0;
+
+bool host_partition_load(const char* label, esp_partition_type_t type, esp_partition_subtype_t subtype,
+                         const char* path) {
+    if (partition_count >= HOST_MAX_PARTITIONS) return false;
+    FILE* fp = fopen(path, "rb");
+    if (!fp) return false;
+
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    uint8_t* data = size > 0 ? (uint8_t*)malloc((size_t)size) : NULL;
+    bool ok = data && fread(data, 1, (size_t)size, fp) == (size_t)size;
+    fclose(fp);
+    if (!ok) {
+        free(data);
+        return false;
+    }
+
+    host_partition_t* slot = &partitions[partition_count++];
+    memset(&slot->part, 0, sizeof(slot->part));
+    slot->part.type = type;
+    slot->part.subtype = subtype;
+    slot->part.size = (uint32_t)size;
+    snprintf(slot->part.label, sizeof(slot->part.label), "%s", label);
+    slot->data = data;
+    return true;
+}
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char* label) {
+    for (uint8_t i = 0; i < partition_count; i++) {
+        const esp_partition_t* part = &partitions[i].part;
+        if (part->type != type) continue;
+        if (subtype != ESP_PARTITION_SUBTYPE_ANY && part->subtype != subtype) continue;
+        if (label && strcmp(label, part->label) != 0) continue;
+        return part;
+    }
+    return NULL;
+}
+
+esp_err_t esp_partition_mmap(const esp_partition_t* partition, size_t offset, size_t size,
+                             spi_flash_mmap_memory_t memory, const void** out_ptr, spi_flash_mmap_handle_t* out_handle) {
+    for (uint8_t i = 0; i < partition_count; i++) {
+        if (&partitions[i].part != partition) continue;
+        if (offset + size > partition->size) return ESP_ERR_INVALID_SIZE;
+        *out_ptr = partitions[i].data + offset;
+        *out_handle = i;
+        return ESP_OK;
+    }
+    return ESP_ERR_INVALID_ARG;
+}
+
+//** 内容一直留着，和设备上映射的只读Flash一样 / The contents stay, like read-only flash mapped on the device
+void spi_flash_munmap(spi_flash_mmap_handle_t handle) {}
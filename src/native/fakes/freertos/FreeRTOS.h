@@ -0,0 +1,59 @@
+#pragma once
+
+//** 主机构建用的FreeRTOS替身 - 协作式任务 / FreeRTOS Stand-in for Host Builds - Cooperative Tasks
+//**
+//** - 每个任务一个ucontext和自己的栈，一次只跑一个 / Each task is a ucontext with its own stack, one runs at a time
+//** - 只在阻塞处切换：ulTaskNotifyTake、vTaskDelay、delay()、taskYIELD / Switches only where a task blocks:
+//**   ulTaskNotifyTake, vTaskDelay, delay(), taskYIELD
+//** - 所有任务都在等时，虚拟时钟直接跳到最近的到期时间 / When every task waits, the virtual clock jumps straight to
+//**   the nearest deadline
+//** - 两个核轮流跑，不是同时跑 / The two cores take turns instead of running at the same time
+//** - 1 tick = 1 ms
+
+#include <stdint.h>
+
+typedef int32_t BaseType_t;
+typedef uint32_t UBaseType_t;
+typedef uint32_t TickType_t;
+typedef void (*TaskFunction_t)(void*);
+typedef struct host_task* TaskHandle_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdFAIL 0
+#define pdPASS 1
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFFu)
+#define configTICK_RATE_HZ 1000
+#define portTICK_PERIOD_MS (1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms) * configTICK_RATE_HZ / 1000)
+#define tskNO_AFFINITY 0x7FFFFFFF
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stack_depth, void* arg,
+                                   UBaseType_t priority, TaskHandle_t* created, BaseType_t core);
+//** 任务外 (主机main里) 返回NULL / NULL outside any task (in the host main)
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks);
+void vTaskDelay(TickType_t ticks);
+void host_task_yield(void);
+#define taskYIELD() host_task_yield()
+//** 任务外算核0，和esp_timer任务一样 / Outside any task counts as core 0, like the esp_timer task
+BaseType_t xPortGetCoreID(void);
+
+//** 任务不会被抢占，临界区什么都不用做 / Tasks are never preempted, so critical sections are no-ops
+typedef struct {
+    uint32_t owner;
+} portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED {0}
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+
+//** 替身专有 - 调度循环，在主机main里调用 / Fake only - the scheduler loop, called from the host main
+//** 跑到虚拟时间until_us为止；所有任务都永远等下去时返回false / Runs until virtual time until_us;
+//** returns false once every task waits forever
+bool host_rtos_run(uint64_t until_us);
+//** 替身专有 - 每次任务切回调度循环后问一次，返回true时host_rtos_run马上返回；NULL = 不问
+//** Fake only - asked each time a task switches back to the scheduler loop; true makes host_rtos_run return at once;
+//** NULL = never asked
+void host_rtos_stop_when(bool (*stop)(void));
+uint32_t host_rtos_switches(void);
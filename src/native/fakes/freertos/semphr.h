@@ -0,0 +1,31 @@
+#pragma once
+
+//** 互斥锁替身 / Mutex Stand-in
+//**
+//** 任务不会被抢占，拿锁的代码里也不阻塞，所以锁只记有没有人拿着；重复拿说明代码在锁里让出了CPU
+//** Tasks are never preempted and nothing blocks while holding the lock, so it only records whether it is taken;
+//** taking it twice means the code yielded while holding it
+
+#include "FreeRTOS.h"
+#include <stdlib.h>
+
+typedef struct {
+    bool taken;
+} StaticSemaphore_t;
+typedef StaticSemaphore_t* SemaphoreHandle_t;
+
+static inline SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t* buffer) {
+    buffer->taken = false;
+    return buffer;
+}
+
+static inline BaseType_t xSemaphoreTake(SemaphoreHandle_t lock, TickType_t ticks) {
+    if (lock->taken) abort();
+    lock->taken = true;
+    return pdTRUE;
+}
+
+static inline BaseType_t xSemaphoreGive(SemaphoreHandle_t lock) {
+    lock->taken = false;
+    return pdTRUE;
+}
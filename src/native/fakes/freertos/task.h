@@ -0,0 +1,4 @@
+#pragma once
+
+//** 任务接口都在FreeRTOS.h里 / The task API lives in FreeRTOS.h
+#include "FreeRTOS.h"
@@ -0,0 +1,37 @@
+//** 主机构建用的I2C、QMI8658和手势驱动替身实现 / I2C, QMI8658 and Gesture Driver Stand-ins for Host Builds
+
+#include "Wire.h"
+#include "QMI8658.h"
+#include "imu_gesture_driver.h"
+
+TwoWire Wire;
+
+//** 平放静止 - z轴1g / Lying flat and still - 1 g on z
+static float imu_acc[3] = { 0.0f, 0.0f, 1000.0f };
+static float imu_gyro[3] = { 0.0f, 0.0f, 0.0f };
+static ImuGestureData gesture_data;
+
+unsigned char QMI8658_init(void) { return 1; }
+
+void QMI8658_read_xyz(float acc[3], float gyro[3], unsigned int* tim_count) {
+    memcpy(acc, imu_acc, sizeof(imu_acc));
+    memcpy(gyro, imu_gyro, sizeof(imu_gyro));
+    if (tim_count) *tim_count = (unsigned int)micros();
+}
+
+void host_imu_set(const float acc[3], const float gyro[3]) {
+    memcpy(imu_acc, acc, sizeof(imu_acc));
+    memcpy(imu_gyro, gyro, sizeof(imu_gyro));
+}
+
+void imu_gesture_init(void) { memset(&gesture_data, 0, sizeof(gesture_data)); }
+
+ImuGestureData* imu_gesture_get_data(void) { return &gesture_data; }
+
+bool imu_gesture_has_gesture(const ImuGestureData* data) { return data->isValid && data->gesture != GESTURE_NONE; }
+
+void host_imu_gesture(ImuGestureType gesture) {
+    QMI8658_read_xyz(gesture_data.acc, gesture_data.gyro, NULL);
+    gesture_data.gesture = gesture;
+    gesture_data.isValid = true;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+//** 主机构建用的IMU手势驱动替身 - 手势由host_imu_gesture()给 / IMU Gesture Driver Stand-in for Host Builds - Gestures
+//** Come from host_imu_gesture()
+
+#include <stdint.h>
+
+typedef enum {
+    GESTURE_NONE = 0,
+    GESTURE_LEFT,
+    GESTURE_RIGHT,
+    GESTURE_UP,
+    GESTURE_DOWN,
+    GESTURE_FORWARD,
+    GESTURE_BACK,
+} ImuGestureType;
+
+typedef struct {
+    float acc[3];
+    float gyro[3];
+    ImuGestureType gesture;
+    bool isValid;
+} ImuGestureData;
+
+void imu_gesture_init(void);
+ImuGestureData* imu_gesture_get_data(void);
+bool imu_gesture_has_gesture(const ImuGestureData* data);
+
+//** 替身专有 - 报一次手势，读数取QMI8658替身当前的值 / Fake only - report one gesture with the current QMI8658 readings
+void host_imu_gesture(ImuGestureType gesture);
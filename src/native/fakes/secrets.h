@@ -0,0 +1,7 @@
+#pragma once
+
+//** 主机模拟用的假凭据 - 连不连得上由WiFi替身的时间线决定 / Fake Credentials for the Host Simulation - the WiFi
+//** Stand-in's timeline decides whether it connects
+
+#define WIFI_SSID_1     "holocubic-sim"
+#define WIFI_PASSWORD_1 "simulated"
@@ -0,0 +1,441 @@
+//** ESP32-S3 HoloCubic - 图像解码器主机检查 / Image Decoder Checks on the Host
+//**
+//** pio run -e native_image_test -t exec
+//** .pio/build/native_image_test/program scripts/images     # 语料目录 / corpus directory
+//**
+//** 语料由 scripts/8_image_corpus.py 生成并提交 - corpus.txt 列出每个文件的期望结果和允许误差。
+//** The corpus is generated by scripts/8_image_corpus.py and committed - corpus.txt lists each file's
+//** expected result and allowed error.
+//**
+//** 每个文件：和设备同样的内存池预算解一遍，带必须落在图像内、每个像素恰好写一次，再和参考像素比；
+//** 然后用1字节的短读再解一遍必须得到同样的像素，最后报吞吐量和内存池峰值。
+//** Each file: decoded with the device's pool budget, bands must stay inside the image and write every pixel
+//** exactly once, then compared against the reference pixels; decoded again with 1-byte short reads, which
+//** must give the same pixels; finally throughput and the pool high-water mark are reported.
+//**
+//** 另外：两张小图的每个截断前缀、读取器报错、内存池不够 - 都必须返回错误而不是崩溃或写出界；几张小图随机改坏
+//** 几千次，解出什么都行，但不能崩溃、写出界或超出内存池。
+//** PNG解完最后一个deflate块就停，不读Adler-32、CRC和IEND，所以只缺这20字节的前缀可以成功，但像素必须完整。
+//** Also: every truncated prefix of two small images, a failing reader and a pool that is too small - each must
+//** return an error instead of crashing or writing out of bounds; a few small images are randomly corrupted a few
+//** thousand times each, where any result will do as long as nothing crashes, writes out of bounds or overruns the
+//** pool. PNG stops after the last deflate block without reading the Adler-32, CRC and IEND, so prefixes missing
+//** only those 20 bytes may succeed, with every pixel.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "display_image.h"
+#include "display_pixels.h"
+
+#define CANVAS_SIZE 256
+
+static uint32_t failures;
+static uint8_t pool[DISPLAY_IMAGE_BUDGET];
+
+static uint64_t host_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void fail(const char* file, const char* what) {
+  failures++;
+  if (failures <= 20) printf("FAIL %s: %s\n", file, what);
+}
+
+//** 整个文件读进内存 / Whole file read into memory
+static uint8_t* load(const char* path, uint32_t* size) {
+  FILE* f = fopen(path, "rb");
+  if (!f) return NULL;
+  fseek(f, 0, SEEK_END);
+  long n = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  uint8_t* data = (uint8_t*)malloc(n > 0 ? n : 1);
+  *size = (uint32_t)fread(data, 1, n, f);
+  fclose(f);
+  return data;
+}
+
+// ========================================
+// 读取器和画布 / Reader and Canvas
+// ========================================
+
+typedef struct {
+  const uint8_t* data;
+  uint32_t size;
+  uint32_t pos;
+  uint32_t max_read;    // 每次最多给几个字节 - 测短读 / most bytes per read - tests short reads
+  int32_t fail_at;      // 读到这里返回-1，负数不失败 / return -1 from here, negative never fails
+} memory_reader_t;
+
+static int32_t memory_read(void* ctx, uint8_t* buf, uint32_t len) {
+  memory_reader_t* r = (memory_reader_t*)ctx;
+  if (r->fail_at >= 0 && r->pos >= (uint32_t)r->fail_at) return -1;
+  uint32_t n = r->size - r->pos;
+  if (n > len) n = len;
+  if (r->max_read && n > r->max_read) n = r->max_read;
+  memcpy(buf, r->data + r->pos, n);
+  r->pos += n;
+  return (int32_t)n;
+}
+
+typedef struct {
+  uint16_t pixels[CANVAS_SIZE * CANVAS_SIZE];
+  uint8_t writes[CANVAS_SIZE * CANVAS_SIZE];
+  uint32_t out_of_bounds;
+  int16_t last_y;
+  uint32_t backwards;   // 带往回走的次数 / bands that went back up
+  int32_t right, bottom;  // 所有带的右下边界，出界的也算 / right and bottom edge of all bands, out of bounds or not
+} canvas_t;
+
+static canvas_t canvas, canvas_short;
+
+static void canvas_band(void* ctx, int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t* pixels) {
+  canvas_t* c = (canvas_t*)ctx;
+  if (x + w > c->right) c->right = x + w;
+  if (y + h > c->bottom) c->bottom = y + h;
+  if (x < 0 || y < 0 || w <= 0 || h <= 0 || x + w > CANVAS_SIZE || y + h > CANVAS_SIZE) {
+    c->out_of_bounds++;
+    return;
+  }
+  if (y < c->last_y) c->backwards++;
+  c->last_y = y;
+  for (int16_t row = 0; row < h; row++) {
+    for (int16_t col = 0; col < w; col++) {
+      uint32_t i = (uint32_t)(y + row) * CANVAS_SIZE + x + col;
+      c->pixels[i] = pixels[row * w + col];
+      if (c->writes[i] < 255) c->writes[i]++;
+    }
+  }
+}
+
+static display_image_result_t decode(const uint8_t* data, uint32_t size, uint32_t max_read, int32_t fail_at,
+                                     uint32_t pool_size, canvas_t* c, display_image_stats_t* stats) {
+  memory_reader_t mem = { data, size, 0, max_read, fail_at };
+  display_image_reader_t reader = { memory_read, &mem };
+  memset(c, 0, sizeof(*c));
+  memset(stats, 0, sizeof(*stats));
+  return display_image_decode(&reader, pool, pool_size, 0, 0, canvas_band, c, stats);
+}
+
+// ========================================
+// 语料 / Corpus
+// ========================================
+
+static const struct {
+  const char* name;
+  display_image_result_t result;
+} result_names[] = {
+  { "ok", DISPLAY_IMAGE_OK },
+  { "format", DISPLAY_IMAGE_ERR_FORMAT },
+  { "unsupported", DISPLAY_IMAGE_ERR_UNSUPPORTED },
+  { "memory", DISPLAY_IMAGE_ERR_MEMORY },
+  { "io", DISPLAY_IMAGE_ERR_IO },
+  { "corrupt", DISPLAY_IMAGE_ERR_CORRUPT },
+};
+
+//** 和参考像素比 - 返回RGB565各通道最大误差 / Compared against the reference - returns the largest per-channel
+//** RGB565 error
+static uint32_t compare(const char* name, const canvas_t* c, const uint8_t* ref, uint32_t ref_size, int16_t w,
+                        int16_t h, uint64_t* error_sum) {
+  char what[160];
+  if (ref_size != (uint32_t)w * h * 3) {
+    snprintf(what, sizeof(what), "reference has %lu bytes, expected %dx%dx3", (unsigned long)ref_size, w, h);
+    fail(name, what);
+    return 0;
+  }
+  uint32_t worst = 0;
+  for (int16_t y = 0; y < h; y++) {
+    for (int16_t x = 0; x < w; x++) {
+      const uint8_t* rgb = ref + ((uint32_t)y * w + x) * 3;
+      uint16_t want = display_px_pack_bgr565(rgb[0], rgb[1], rgb[2]);
+      uint16_t got = c->pixels[(uint32_t)y * CANVAS_SIZE + x];
+      int32_t d[3] = { (got & 0x1F) - (want & 0x1F), ((got >> 5) & 0x3F) - ((want >> 5) & 0x3F),
+                       (got >> 11) - (want >> 11) };
+      for (int k = 0; k < 3; k++) {
+        uint32_t e = (uint32_t)abs(d[k]);
+        if (e > worst) worst = e;
+        *error_sum += e;
+      }
+    }
+  }
+  return worst;
+}
+
+//** 允许的误差 - "最大/平均"，RGB565单位，max < 0不比像素 / Allowed error - "max/mean" in RGB565 steps,
+//** max < 0 skips the pixel comparison
+typedef struct {
+  int max;
+  double mean;
+} tolerance_t;
+
+//** 一个语料文件 / One corpus file
+static void check_file(const char* dir, const char* name, display_image_result_t expect, tolerance_t tolerance) {
+  char path[512], what[160];
+  uint32_t size = 0;
+  snprintf(path, sizeof(path), "%s/%s", dir, name);
+  uint8_t* data = load(path, &size);
+  if (!data) {
+    fail(name, "cannot read file");
+    return;
+  }
+
+  display_image_stats_t stats;
+  display_image_result_t result = decode(data, size, 0, -1, sizeof(pool), &canvas, &stats);
+  if (result != expect) {
+    snprintf(what, sizeof(what), "got \"%s\", expected \"%s\"", display_image_result_name(result),
+             display_image_result_name(expect));
+    fail(name, what);
+  }
+  if (canvas.out_of_bounds) {
+    snprintf(what, sizeof(what), "%lu bands outside the canvas", (unsigned long)canvas.out_of_bounds);
+    fail(name, what);
+  }
+  if (stats.peak_bytes > sizeof(pool)) {
+    snprintf(what, sizeof(what), "peak %lu bytes over the %lu byte pool", (unsigned long)stats.peak_bytes,
+             (unsigned long)sizeof(pool));
+    fail(name, what);
+  }
+
+  if (result != DISPLAY_IMAGE_OK || expect != DISPLAY_IMAGE_OK) {
+    printf("%s,%lu,%s,,,,,,,\n", name, (unsigned long)size, display_image_result_name(result));
+    free(data);
+    return;
+  }
+
+  //** 每个像素恰好写一次，带从上往下 / Every pixel written exactly once, bands top to bottom
+  uint32_t wrong_writes = 0;
+  for (int16_t y = 0; y < CANVAS_SIZE; y++) {
+    for (int16_t x = 0; x < CANVAS_SIZE; x++) {
+      bool inside = x < stats.width && y < stats.height;
+      if (canvas.writes[(uint32_t)y * CANVAS_SIZE + x] != (inside ? 1 : 0)) wrong_writes++;
+    }
+  }
+  if (wrong_writes || canvas.backwards) {
+    snprintf(what, sizeof(what), "%lu pixels not written exactly once, %lu bands went back up",
+             (unsigned long)wrong_writes, (unsigned long)canvas.backwards);
+    fail(name, what);
+  }
+
+  //** 参考像素 / Reference pixels
+  char max_error[16] = "", mean_error[16] = "";
+  if (tolerance.max >= 0) {
+    char ref_path[512];
+    snprintf(ref_path, sizeof(ref_path), "%s", path);
+    char* dot = strrchr(ref_path, '.');
+    if (dot) strcpy(dot, ".rgb");
+    uint32_t ref_size = 0;
+    uint8_t* ref = load(ref_path, &ref_size);
+    if (!ref) {
+      fail(name, "cannot read reference pixels");
+    } else {
+      uint64_t error_sum = 0;
+      uint32_t worst = compare(name, &canvas, ref, ref_size, stats.width, stats.height, &error_sum);
+      double mean = (double)error_sum / ((double)stats.width * stats.height * 3);
+      if (worst > (uint32_t)tolerance.max || mean > tolerance.mean) {
+        snprintf(what, sizeof(what), "off by up to %lu RGB565 steps (mean %.3f), tolerance %d/%.2f",
+                 (unsigned long)worst, mean, tolerance.max, tolerance.mean);
+        fail(name, what);
+      }
+      snprintf(max_error, sizeof(max_error), "%lu", (unsigned long)worst);
+      snprintf(mean_error, sizeof(mean_error), "%.3f", mean);
+      free(ref);
+    }
+  }
+
+  //** 1字节短读必须得到同样的像素 / 1-byte short reads must give the same pixels
+  display_image_stats_t short_stats;
+  result = decode(data, size, 1, -1, sizeof(pool), &canvas_short, &short_stats);
+  if (result != DISPLAY_IMAGE_OK || memcmp(canvas.pixels, canvas_short.pixels, sizeof(canvas.pixels)) != 0) {
+    snprintf(what, sizeof(what), "1-byte reads gave \"%s\" and different pixels", display_image_result_name(result));
+    fail(name, what);
+  }
+
+  //** 吞吐量 - 重复解到至少50ms / Throughput - decoded repeatedly for at least 50 ms
+  uint32_t runs = 0;
+  uint64_t start = host_ns(), elapsed = 0;
+  do {
+    decode(data, size, 0, -1, sizeof(pool), &canvas_short, &short_stats);
+    runs++;
+    elapsed = host_ns() - start;
+  } while (elapsed < 50000000ull);
+  double seconds = (double)elapsed / 1e9 / runs;
+  printf("%s,%lu,ok,%dx%d,%lu,%lu,%.1f,%.1f,%s,%s\n", name, (unsigned long)size, stats.width, stats.height,
+         (unsigned long)stats.bands, (unsigned long)stats.peak_bytes, size / seconds / 1e6,
+         (double)stats.width * stats.height / seconds / 1e6, max_error, mean_error);
+  free(data);
+}
+
+// ========================================
+// 截断、读错误、内存不够 / Truncation, Read Errors, Small Pool
+// ========================================
+
+//** trailer - 解码器不读的文件尾字节数 / trailer - bytes at the end of the file the decoder never reads
+static void check_robustness(const char* dir, const char* name, uint32_t trailer) {
+  char path[512], what[160];
+  uint32_t size = 0;
+  snprintf(path, sizeof(path), "%s/%s", dir, name);
+  uint8_t* data = load(path, &size);
+  if (!data) {
+    fail(name, "cannot read file");
+    return;
+  }
+  display_image_stats_t stats, full_stats;
+  decode(data, size, 0, -1, sizeof(pool), &canvas_short, &full_stats);
+
+  //** 每个截断前缀 - 缺的不只是文件尾就必须失败，成功的像素必须完整
+  //** Every truncated prefix - it must fail unless only the trailer is missing, and a success has every pixel
+  uint32_t early = 0, incomplete = 0, out_of_bounds = 0;
+  uint32_t counts[DISPLAY_IMAGE_ERR_CORRUPT + 1] = { 0 };
+  for (uint32_t len = 0; len < size; len++) {
+    display_image_result_t result = decode(data, len, 0, -1, sizeof(pool), &canvas, &stats);
+    counts[result]++;
+    out_of_bounds += canvas.out_of_bounds;
+    if (result != DISPLAY_IMAGE_OK) continue;
+    if (len + trailer < size) early++;
+    if (memcmp(canvas.pixels, canvas_short.pixels, sizeof(canvas.pixels)) != 0) incomplete++;
+  }
+  if (early || incomplete || out_of_bounds) {
+    snprintf(what, sizeof(what), "%lu truncated prefixes decoded as ok, %lu with missing pixels, %lu bands out of "
+             "bounds", (unsigned long)early, (unsigned long)incomplete, (unsigned long)out_of_bounds);
+    fail(name, what);
+  }
+  printf("# %s: %lu prefixes -> ok %lu, format %lu, io %lu, corrupt %lu, unsupported %lu\n", name,
+         (unsigned long)size, (unsigned long)counts[DISPLAY_IMAGE_OK], (unsigned long)counts[DISPLAY_IMAGE_ERR_FORMAT],
+         (unsigned long)counts[DISPLAY_IMAGE_ERR_IO], (unsigned long)counts[DISPLAY_IMAGE_ERR_CORRUPT],
+         (unsigned long)counts[DISPLAY_IMAGE_ERR_UNSUPPORTED]);
+
+  //** 读取器在中途报错 / The reader fails half way
+  display_image_result_t result = decode(data, size, 0, (int32_t)(size / 2), sizeof(pool), &canvas, &stats);
+  if (result != DISPLAY_IMAGE_ERR_IO) {
+    snprintf(what, sizeof(what), "failing reader gave \"%s\"", display_image_result_name(result));
+    fail(name, what);
+  }
+
+  //** 池比峰值小一个字节 - PNG减少每带行数照样解，JPEG报内存不够 / A pool one byte short of the peak - PNG
+  //** decodes with fewer lines per band, JPEG reports out of budget
+  result = decode(data, size, 0, -1, full_stats.peak_bytes - 1, &canvas, &stats);
+  bool same = memcmp(canvas.pixels, canvas_short.pixels, sizeof(canvas.pixels)) == 0;
+  if ((result != DISPLAY_IMAGE_OK && result != DISPLAY_IMAGE_ERR_MEMORY) || (result == DISPLAY_IMAGE_OK && !same) ||
+      canvas.out_of_bounds) {
+    snprintf(what, sizeof(what), "pool one byte short of the peak gave \"%s\"%s", display_image_result_name(result),
+             same ? "" : " with different pixels");
+    fail(name, what);
+  }
+  printf("# %s: pool %lu -> %s, %lu bands (%lu with the full pool)\n", name,
+         (unsigned long)(full_stats.peak_bytes - 1), display_image_result_name(result), (unsigned long)stats.bands,
+         (unsigned long)full_stats.bands);
+
+  //** 1KB的池什么都解不了 / A 1 KB pool decodes nothing
+  result = decode(data, size, 0, -1, 1024, &canvas, &stats);
+  if (result != DISPLAY_IMAGE_ERR_MEMORY || canvas.out_of_bounds) {
+    snprintf(what, sizeof(what), "1 KB pool gave \"%s\"", display_image_result_name(result));
+    fail(name, what);
+  }
+  free(data);
+}
+
+// ========================================
+// 变异语料 / Mutated Corpus
+// ========================================
+
+//** xorshift32 - 每次运行结果相同 / same results on every run
+static uint32_t rng_state = 0x12345678u;
+
+static uint32_t rng(void) {
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+//** 随机改1-8个字节，四分之一再截断 - 结果是什么都行，但带不能出界、峰值不能超过池
+//** 1-8 random bytes changed, a quarter also truncated - any result will do, but bands must stay in bounds and
+//** the peak must fit the pool
+static void check_mutations(const char* dir, const char* name, uint32_t count) {
+  char path[512], what[160];
+  uint32_t size = 0;
+  snprintf(path, sizeof(path), "%s/%s", dir, name);
+  uint8_t* data = load(path, &size);
+  if (!data || !size) {
+    fail(name, "cannot read file");
+    free(data);
+    return;
+  }
+  uint8_t* mutated = (uint8_t*)malloc(size);
+  display_image_stats_t stats;
+  uint32_t out_of_bounds = 0, over_pool = 0;
+  uint32_t counts[DISPLAY_IMAGE_ERR_CORRUPT + 1] = { 0 };
+  for (uint32_t i = 0; i < count; i++) {
+    memcpy(mutated, data, size);
+    uint32_t changes = 1 + rng() % 8;
+    for (uint32_t c = 0; c < changes; c++) mutated[rng() % size] = (uint8_t)rng();
+    uint32_t len = (rng() % 4) ? size : rng() % size;
+    display_image_result_t result = decode(mutated, len, 0, -1, sizeof(pool), &canvas, &stats);
+    counts[result]++;
+    //** 改坏的尺寸可能比画布大 - 那时只查带在图像里 / A corrupted size may exceed the canvas - then the bands
+    //** are only checked against the image
+    bool fits = stats.width <= CANVAS_SIZE && stats.height <= CANVAS_SIZE;
+    bool outside = stats.bands && (canvas.right > stats.width || canvas.bottom > stats.height);
+    if (outside || (fits && canvas.out_of_bounds)) out_of_bounds++;
+    if (stats.peak_bytes > sizeof(pool)) over_pool++;
+  }
+  if (out_of_bounds || over_pool) {
+    snprintf(what, sizeof(what), "%lu mutations wrote bands out of bounds, %lu went over the pool",
+             (unsigned long)out_of_bounds, (unsigned long)over_pool);
+    fail(name, what);
+  }
+  printf("# %s: %lu mutations -> ok %lu, format %lu, io %lu, corrupt %lu, unsupported %lu, memory %lu\n", name,
+         (unsigned long)count, (unsigned long)counts[DISPLAY_IMAGE_OK], (unsigned long)counts[DISPLAY_IMAGE_ERR_FORMAT],
+         (unsigned long)counts[DISPLAY_IMAGE_ERR_IO], (unsigned long)counts[DISPLAY_IMAGE_ERR_CORRUPT],
+         (unsigned long)counts[DISPLAY_IMAGE_ERR_UNSUPPORTED], (unsigned long)counts[DISPLAY_IMAGE_ERR_MEMORY]);
+  free(mutated);
+  free(data);
+}
+
+int main(int argc, char** argv) {
+  const char* dir = argc > 1 ? argv[1] : "scripts/images";
+  char path[512], line[256];
+  snprintf(path, sizeof(path), "%s/corpus.txt", dir);
+  FILE* list = fopen(path, "r");
+  if (!list) {
+    fprintf(stderr, "cannot open %s - run scripts/8_image_corpus.py\n", path);
+    return 2;
+  }
+
+  printf("# pool %lu bytes, %d byte reads\n", (unsigned long)sizeof(pool), DISPLAY_IMAGE_CHUNK);
+  printf("file,bytes,result,size,bands,peak_bytes,MB_s,Mpix_s,max_err,mean_err\n");
+  uint32_t files = 0;
+  while (fgets(line, sizeof(line), list)) {
+    char name[128], expect[32], tolerance[16];
+    if (line[0] == '#' || sscanf(line, "%127s %31s %15s", name, expect, tolerance) != 3) continue;
+    int found = -1;
+    for (uint32_t i = 0; i < sizeof(result_names) / sizeof(result_names[0]); i++) {
+      if (strcmp(expect, result_names[i].name) == 0) found = (int)i;
+    }
+    if (found < 0) {
+      fail(name, "unknown expected result in corpus.txt");
+      continue;
+    }
+    tolerance_t allowed = { -1, 0 };
+    if (strcmp(tolerance, "-") != 0 && sscanf(tolerance, "%d/%lf", &allowed.max, &allowed.mean) == 1) {
+      allowed.mean = allowed.max;
+    }
+    check_file(dir, name, result_names[found].result, allowed);
+    files++;
+  }
+  fclose(list);
+
+  check_robustness(dir, "png_rgb8.png", 4 + 4 + 12);   // Adler-32, IDAT CRC, IEND
+  check_robustness(dir, "jpg_420.jpg", 0);
+  check_mutations(dir, "png_rgb8.png", 3000);
+  check_mutations(dir, "png_pal8.png", 3000);
+  check_mutations(dir, "jpg_420.jpg", 3000);
+  check_mutations(dir, "jpg_444.jpg", 3000);
+  check_mutations(dir, "jpg_restart.jpg", 3000);
+
+  printf("images: %lu files, %s\n", (unsigned long)files, failures ? "FAIL" : "OK");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,191 @@
+//** ESP32-S3 HoloCubic - 延迟直方图检查 / Latency Histogram Checks
+//**
+//** pio run -e native_lat_hist -t exec
+//**
+//** lat_hist是纯函数，这里在主机上逐格核对。每项打印一行，出错打印FAIL，任何失败退出码1。
+//** lat_hist is pure, so it is checked bucket by bucket on the host. Each check prints one row, failures print
+//** FAIL, and any failure exits with 1.
+//**
+//** buckets     每一格的上下界首尾相接覆盖整个uint32，格宽不超过下界的1/8，上下界都落回自己这一格
+//**             Bucket bounds tile the whole uint32 range end to end, no bucket is wider than 1/8 of its low
+//**             bound, and both bounds map back to their own bucket
+//** values      2的幂附近和随机的值都落在自己那一格的上下界之内
+//**             Values around powers of two and random values fall inside their bucket's bounds
+//** percentile  和排序后的精确百分位比：不小于精确值，不超过它那一格的上界和最大值，p0是最小值，p100是最大值
+//**             Against exact percentiles from a sorted copy: never below the exact value, never above its
+//**             bucket's high bound or the max, p0 is the min and p100 the max
+//** stats       样本数、最小、最大、总和；空的直方图百分位是0
+//**             Sample count, min, max, total; an empty histogram's percentiles are 0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lat_hist.h"
+
+#define SAMPLES 20000
+
+static uint32_t failures;
+static lat_hist_t hist;
+static uint32_t data[SAMPLES];
+static uint32_t sorted[SAMPLES];
+
+static void fail(const char* check, const char* what) {
+  failures++;
+  if (failures <= 20) printf("FAIL %s: %s\n", check, what);
+}
+
+//** xorshift32 - 每次运行结果相同 / same results on every run
+static uint32_t rng_state = 0x12345678u;
+
+static uint32_t rng(void) {
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+static void check_buckets(void) {
+  char what[160];
+  uint32_t worst_width = 0;
+  for (uint32_t b = 0; b < LAT_HIST_BUCKETS; b++) {
+    uint32_t low = lat_hist_bucket_low(b), high = lat_hist_bucket_high(b);
+    if (low > high || lat_hist_bucket(low) != b || lat_hist_bucket(high) != b) {
+      snprintf(what, sizeof(what), "bucket %lu [%lu, %lu] does not map back to itself", (unsigned long)b,
+               (unsigned long)low, (unsigned long)high);
+      fail("buckets", what);
+    }
+    if (b + 1 < LAT_HIST_BUCKETS && lat_hist_bucket_low(b + 1) != high + 1) {
+      snprintf(what, sizeof(what), "gap or overlap after bucket %lu (high %lu, next low %lu)", (unsigned long)b,
+               (unsigned long)high, (unsigned long)lat_hist_bucket_low(b + 1));
+      fail("buckets", what);
+    }
+    //** 宽度 <= 下界/8，即相对误差不超过1/8 / width <= low/8, so the relative error stays within 1/8
+    uint32_t width = high - low + 1;
+    if (b >= LAT_HIST_SUB && (uint64_t)width * LAT_HIST_SUB > low) {
+      snprintf(what, sizeof(what), "bucket %lu is %lu wide for a low bound of %lu", (unsigned long)b,
+               (unsigned long)width, (unsigned long)low);
+      fail("buckets", what);
+    }
+    if (width > worst_width) worst_width = width;
+  }
+  if (lat_hist_bucket_low(0) != 0 || lat_hist_bucket_high(LAT_HIST_BUCKETS - 1) != 0xFFFFFFFFu) {
+    fail("buckets", "the buckets do not cover 0 .. 0xFFFFFFFF");
+  }
+  printf("buckets,%u,widest=%lu\n", (unsigned)LAT_HIST_BUCKETS, (unsigned long)worst_width);
+}
+
+static void check_value(uint32_t v, uint32_t* checked) {
+  uint32_t b = lat_hist_bucket(v);
+  (*checked)++;
+  if (b >= LAT_HIST_BUCKETS || v < lat_hist_bucket_low(b) || v > lat_hist_bucket_high(b)) {
+    char what[128];
+    snprintf(what, sizeof(what), "%lu lands in bucket %lu outside its bounds", (unsigned long)v, (unsigned long)b);
+    fail("values", what);
+  }
+}
+
+static void check_values(void) {
+  uint32_t checked = 0;
+  for (uint32_t v = 0; v < 4096; v++) check_value(v, &checked);
+  for (uint32_t bit = 0; bit < 32; bit++) {
+    uint32_t p = 1u << bit;
+    for (int32_t d = -3; d <= 3; d++) check_value(p + (uint32_t)d, &checked);
+  }
+  for (uint32_t i = 0; i < 1000000; i++) check_value(rng() >> (rng() % 32), &checked);
+  printf("values,%lu\n", (unsigned long)checked);
+}
+
+static int compare_u32(const void* a, const void* b) {
+  uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+  return x < y ? -1 : x > y;
+}
+
+//** 一组数据 - 加进直方图，每个百分位和精确值比 / One data set - add it, compare every percentile to the exact one
+static void percentile_case(const char* name, uint32_t n) {
+  char what[192];
+  lat_hist_reset(&hist);
+  for (uint32_t i = 0; i < n; i++) lat_hist_add(&hist, data[i]);
+  memcpy(sorted, data, n * sizeof(uint32_t));
+  qsort(sorted, n, sizeof(uint32_t), compare_u32);
+
+  uint32_t worst_over = 0;
+  for (uint32_t p = 0; p <= 100; p++) {
+    uint32_t rank = (uint32_t)(((uint64_t)n * p + 99) / 100);     // 和lat_hist一样向上取整 / rounded up as lat_hist does
+    uint32_t exact = rank ? sorted[rank - 1] : sorted[0];
+    uint32_t got = lat_hist_percentile(&hist, (uint8_t)p);
+    uint32_t limit = lat_hist_bucket_high(lat_hist_bucket(exact));
+    if (limit > sorted[n - 1]) limit = sorted[n - 1];
+    if (got < exact || got > limit) {
+      snprintf(what, sizeof(what), "%s p%lu = %lu, exact %lu, allowed up to %lu", name, (unsigned long)p,
+               (unsigned long)got, (unsigned long)exact, (unsigned long)limit);
+      fail("percentile", what);
+    }
+    if (got - exact > worst_over) worst_over = got - exact;
+  }
+  if (lat_hist_percentile(&hist, 0) != sorted[0] || lat_hist_percentile(&hist, 100) != sorted[n - 1]) {
+    snprintf(what, sizeof(what), "%s p0/p100 are not the min/max", name);
+    fail("percentile", what);
+  }
+  printf("percentile,%s,%lu,p50=%lu,p99=%lu,max=%lu,worst_over=%lu\n", name, (unsigned long)n,
+         (unsigned long)lat_hist_percentile(&hist, 50), (unsigned long)lat_hist_percentile(&hist, 99),
+         (unsigned long)hist.max, (unsigned long)worst_over);
+}
+
+static void check_percentiles(void) {
+  for (uint32_t i = 0; i < SAMPLES; i++) data[i] = rng() % 100000;
+  percentile_case("uniform", SAMPLES);
+
+  //** 对数均匀 - 每个2的幂区间样本一样多，像CPU周期 / Log-uniform - equal samples per power of two, like cycle counts
+  for (uint32_t i = 0; i < SAMPLES; i++) data[i] = rng() >> (rng() % 32);
+  percentile_case("log_uniform", SAMPLES);
+
+  //** 长尾 - 99%很快，1%慢了一千倍 / Long tail - 99% fast, 1% a thousand times slower
+  for (uint32_t i = 0; i < SAMPLES; i++) data[i] = i % 100 ? 900 + rng() % 200 : 900000 + rng() % 200000;
+  percentile_case("tail", SAMPLES);
+
+  for (uint32_t i = 0; i < SAMPLES; i++) data[i] = 4242;
+  percentile_case("constant", SAMPLES);
+
+  data[0] = 7;
+  percentile_case("single", 1);
+
+  data[0] = 0;
+  data[1] = 0xFFFFFFFFu;
+  percentile_case("extremes", 2);
+
+  for (uint32_t i = 0; i < 101; i++) data[i] = i;
+  percentile_case("small", 101);
+}
+
+static void check_stats(void) {
+  lat_hist_reset(&hist);
+  if (lat_hist_percentile(&hist, 50) != 0 || lat_hist_percentile(&hist, 100) != 0) {
+    fail("stats", "an empty histogram has a non-zero percentile");
+  }
+  uint64_t total = 0;
+  for (uint32_t i = 0; i < 1000; i++) {
+    uint32_t v = 1000 + i * 37;
+    lat_hist_add(&hist, v);
+    total += v;
+  }
+  lat_hist_add(&hist, 0xFFFFFFFFu);
+  total += 0xFFFFFFFFu;
+  if (hist.samples != 1001 || hist.min != 1000 || hist.max != 0xFFFFFFFFu || hist.total != total) {
+    fail("stats", "samples, min, max or total wrong");
+  }
+  uint32_t sum = 0;
+  for (uint32_t b = 0; b < LAT_HIST_BUCKETS; b++) sum += hist.counts[b];
+  if (sum != hist.samples) fail("stats", "bucket counts do not add up to samples");
+  printf("stats,%lu,min=%lu,max=%lu\n", (unsigned long)hist.samples, (unsigned long)hist.min, (unsigned long)hist.max);
+}
+
+int main(int argc, char** argv) {
+  printf("# lat_hist: %u buckets, %u per power of two\n", (unsigned)LAT_HIST_BUCKETS, (unsigned)LAT_HIST_SUB);
+  check_buckets();
+  check_values();
+  check_percentiles();
+  check_stats();
+
+  printf("lat_hist: %s\n", failures ? "FAIL" : "OK");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,93 @@
+//** ESP32-S3 HoloCubic - 主机上的LED脚本模拟 / LED Script Simulation on the Host
+//**
+//** pio run -e native_led_script
+//** .pio/build/native_led_script/program status.lsc 10000 wifi > status.csv
+//**
+//** 参数 / Arguments: 脚本 [模拟毫秒，默认5000] [状态名或位号，逗号分隔]
+//** 用和设备相同的解释器按1ms一个tick跑虚拟时间，颜色或背光变化时输出一行CSV；
+//** 最后输出每个tick的主机耗时和单个tick执行的最多指令数
+//** Runs the device's interpreter on virtual time, one tick per ms, and prints a CSV line whenever
+//** the colour or backlight changes; ends with host time per tick and the most instructions in one tick
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "led_script.h"
+
+static uint8_t image[LED_SCRIPT_HEADER_SIZE + LED_SCRIPT_MAX_CODE];
+static led_script_t script;
+
+static const char* const state_names[LED_STATE_COUNT] = { "wifi", "wifi_busy", "wifi_failed" };
+
+static uint32_t parse_state(char* text) {
+  uint32_t state = 0;
+  for (char* name = strtok(text, ","); name; name = strtok(NULL, ",")) {
+    int bit = -1;
+    for (int i = 0; i < LED_STATE_COUNT; i++) {
+      if (strcmp(name, state_names[i]) == 0) bit = i;
+    }
+    if (bit < 0) bit = atoi(name);
+    state |= 1u << (bit & 31);
+  }
+  return state;
+}
+
+static uint64_t host_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s script.lsc [ms] [state,...]\n", argv[0]);
+    return 2;
+  }
+
+  FILE* file = fopen(argv[1], "rb");
+  if (!file) {
+    perror(argv[1]);
+    return 1;
+  }
+  size_t len = fread(image, 1, sizeof(image), file);
+  fclose(file);
+
+  uint32_t duration = argc > 2 ? (uint32_t)atoi(argv[2]) : 5000;
+  uint32_t state = argc > 3 ? parse_state(argv[3]) : 0;
+
+  led_script_result_t result = led_script_bind(&script, image, len);
+  if (result != LED_SCRIPT_OK) {
+    fprintf(stderr, "%s: %s\n", argv[1], led_script_result_str(result));
+    return 1;
+  }
+
+  printf("ms,r,g,b,backlight\n");
+  led_script_start(&script, 0);
+
+  led_color_t last = { 0, 0, 0 };
+  int16_t last_light = -1;
+  uint32_t max_steps = 0;
+  uint64_t spent = 0;
+
+  for (uint32_t now = 0; now <= duration; now++) {
+    uint32_t before = script.executed;
+    uint64_t t0 = host_ns();
+    led_script_step(&script, now, state);
+    led_color_t color = led_script_color(&script, now);
+    int16_t light = led_script_backlight(&script, now);
+    spent += host_ns() - t0;
+
+    if (script.executed - before > max_steps) max_steps = script.executed - before;
+    if (now == 0 || memcmp(&color, &last, sizeof(color)) != 0 || light != last_light) {
+      printf("%lu,%u,%u,%u,%d\n", (unsigned long)now, color.r, color.g, color.b, light);
+      last = color;
+      last_light = light;
+    }
+  }
+
+  static const char* const status_names[] = { "idle", "running", "done", "fault" };
+  printf("# status=%s instructions=%lu max_per_tick=%lu ns_per_tick=%.1f\n", status_names[script.status],
+         (unsigned long)script.executed, (unsigned long)max_steps, (double)spent / (duration + 1));
+  return script.status == LED_SCRIPT_FAULT ? 1 : 0;
+}
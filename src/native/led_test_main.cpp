@@ -0,0 +1,485 @@
+//** ESP32-S3 HoloCubic - LED主机检查 / LED Checks on the Host
+//**
+//** pio run -e native_led_test -t exec
+//** .pio/build/native_led_test/program wave        # 只跑一项 / one check only
+//**
+//** 每项打印自己的报告，出错打印FAIL，任何失败退出码1。
+//** Each check prints its own report, failures print FAIL, and any failure exits with 1.
+//**
+//** wave   每种波形的全部65536个相位和double参考比，亮度误差不超过 ±8/65535，插值后的8位颜色不超过 ±1；
+//**        再报每个tick (每颗LED求相位、亮度、插值) 的主机周期数，和原来的浮点sin()呼吸灯对照
+//**        Every shape at all 65536 phases against a double reference, level within ±8/65535 and interpolated
+//**        8-bit colour within ±1; then host cycles per tick (phase, level and lerp per LED), next to the
+//**        old floating-point sin() pulse
+//** output 真正的led_manager + led_driver跑在FastLED替身和虚拟时钟上：颜色不变时show次数不再增加，闪烁只在边沿发，
+//**        亮度不变不发，5ms内的第二次变化推迟到下一次提交
+//**        The real led_manager + led_driver on the FastLED fake and the virtual clock: the show count stops rising
+//**        while the colour is static, a blink only sends on its edges, an unchanged brightness is not sent, and a
+//**        second change within 5 ms waits for the next commit
+//** rmt    led_rmt_encode的符号流和手写的标准答案逐字相同：GRB顺序、高位先发、亮度缩放、复位符号、不写出界，
+//**        时序在WS2812B的容差内
+//**        led_rmt_encode's symbol stream matches hand-written golden words: GRB order, MSB first, brightness
+//**        scaling, the reset symbol, no writes past the end, and timings inside the WS2812B tolerances
+//** layers 图层栈：每颗LED取盖住它的最上层，超时或释放后下面的接上；再报1-4个动画图层时每个tick的合成代价
+//**        The layer stack: every LED takes the highest layer covering it, and the one below resumes after a
+//**        timeout or release; then the per-tick compositing cost with 1-4 animated layers
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Arduino.h"
+#include "FastLED.h"
+#include "core/config/hardware_config.h"
+#include "led_manager.h"
+#include "led_rmt.h"
+#include "led_wave.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_CYCLES 1
+#else
+#define HAVE_CYCLES 0
+#endif
+
+#define LED_COUNT HW_LED_COUNT
+#define WAVE_LEVEL_TOLERANCE 8      // led_wave.h里写的界 / the bound led_wave.h states
+#define TICKS 200000
+
+static uint32_t failures;
+
+static void fail(const char* check, const char* what) {
+  failures++;
+  if (failures <= 10) printf("FAIL %s: %s\n", check, what);
+}
+
+static uint64_t host_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t host_cycles(void) {
+#if HAVE_CYCLES
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+//** ========================================
+//** wave - 定点波形 vs double / Fixed-Point Waves vs Double
+//** ========================================
+
+static const char* const wave_names[LED_WAVE_COUNT] = { "square", "sine", "triangle", "sawtooth", "ease", "breathe" };
+
+//** led_wave.h 注释里的定义，t = phase / 65536 / The definitions in led_wave.h's comments, t = phase / 65536
+static double wave_reference(led_wave_shape_t shape, uint16_t phase) {
+  double t = phase / 65536.0;
+  double tri = t < 0.5 ? 2 * t : 2 - 2 * t;
+  switch (shape) {
+    case LED_WAVE_SQUARE:   return phase < 0x8000u ? 1.0 : 0.0;
+    case LED_WAVE_SINE:     return (sin(2 * M_PI * t) + 1) / 2;
+    case LED_WAVE_TRIANGLE: return tri;
+    case LED_WAVE_SAWTOOTH: return t;
+    case LED_WAVE_EASE:     return tri * tri * (3 - 2 * tri);
+    case LED_WAVE_BREATHE:  return pow((1 - cos(2 * M_PI * t)) / 2, 2.2);
+    default:                return 0;
+  }
+}
+
+static int channel_error(uint8_t got, uint8_t from, uint8_t to, double level) {
+  return abs((int)got - (int)lround(from + (to - from) * level));
+}
+
+//** 原来的呼吸灯 - 每颗LED一次sin()和三次浮点乘法 / The old pulse - one sin() and three float multiplies per LED
+static led_color_t float_pulse(led_color_t top, uint32_t elapsed_ms, uint16_t period_ms) {
+  float level = (sinf(2.0f * (float)M_PI * (float)(elapsed_ms % period_ms) / period_ms) + 1.0f) / 2.0f;
+  led_color_t c = { (uint8_t)(top.r * level), (uint8_t)(top.g * level), (uint8_t)(top.b * level) };
+  return c;
+}
+
+static volatile uint8_t tick_sink;
+
+static void check_wave(void) {
+  char what[128];
+  static const led_color_t pairs[][2] = {
+    { { 0, 0, 0 }, { 255, 255, 255 } },
+    { { 0, 0, 0 }, { 0, 128, 255 } },
+    { { 255, 64, 0 }, { 3, 200, 77 } },
+    { { 10, 20, 30 }, { 11, 19, 250 } },
+  };
+
+  printf("shape,max_level_err,mean_level_err,max_color_err\n");
+  for (uint8_t shape = 0; shape < LED_WAVE_COUNT; shape++) {
+    uint32_t level_worst = 0, color_worst = 0;
+    double level_sum = 0;
+    for (uint32_t p = 0; p <= 0xFFFF; p++) {
+      uint16_t phase = (uint16_t)p;
+      uint16_t level = led_wave_level((led_wave_shape_t)shape, phase);
+      double ref = wave_reference((led_wave_shape_t)shape, phase);
+      double err = fabs(level - ref * LED_WAVE_ONE);
+      level_sum += err;
+      if ((uint32_t)lround(err) > level_worst) level_worst = (uint32_t)lround(err);
+
+      //** 颜色误差对照参考亮度，包含了亮度误差和插值舍入 / Colour error against the reference level covers both
+      //** the level error and the lerp rounding
+      for (uint32_t k = 0; k < sizeof(pairs) / sizeof(pairs[0]); k++) {
+        led_color_t a = pairs[k][0], b = pairs[k][1];
+        led_color_t c = led_color_lerp(a, b, level);
+        int e = channel_error(c.r, a.r, b.r, ref);
+        if (channel_error(c.g, a.g, b.g, ref) > e) e = channel_error(c.g, a.g, b.g, ref);
+        if (channel_error(c.b, a.b, b.b, ref) > e) e = channel_error(c.b, a.b, b.b, ref);
+        if ((uint32_t)e > color_worst) color_worst = (uint32_t)e;
+      }
+    }
+    printf("%s,%lu,%.3f,%lu\n", wave_names[shape], (unsigned long)level_worst, level_sum / 65536,
+           (unsigned long)color_worst);
+    if (level_worst > WAVE_LEVEL_TOLERANCE || color_worst > 1) {
+      snprintf(what, sizeof(what), "%s: level off by %lu/65535, colour by %lu", wave_names[shape],
+               (unsigned long)level_worst, (unsigned long)color_worst);
+      fail("wave", what);
+    }
+  }
+
+  //** 端点精确 / Exact endpoints
+  led_color_t a = { 1, 2, 3 }, b = { 250, 251, 252 };
+  led_color_t at0 = led_color_lerp(a, b, 0), at1 = led_color_lerp(a, b, LED_WAVE_ONE);
+  if (memcmp(&at0, &a, sizeof(a)) != 0 || memcmp(&at1, &b, sizeof(b)) != 0) {
+    fail("wave", "led_color_lerp does not hit its endpoints exactly");
+  }
+
+  //** 关键帧: 相邻两帧之间和浮点插值比 / Keyframes: against a float lerp between neighbouring frames
+  static const led_keyframe_t frames[] = {
+    { 0x0000, { 255, 0, 0 } }, { 0x4000, { 0, 255, 0 } }, { 0x9000, { 0, 0, 255 } }, { 0xE000, { 255, 255, 255 } },
+  };
+  const uint8_t count = sizeof(frames) / sizeof(frames[0]);
+  uint32_t key_worst = 0;
+  for (uint32_t p = 0; p <= 0xFFFF; p++) {
+    uint8_t i = count - 1;
+    for (uint8_t k = 0; k < count; k++) {
+      if (frames[k].at <= p) i = k;
+    }
+    const led_keyframe_t* from = &frames[i];
+    const led_keyframe_t* to = &frames[(i + 1) % count];
+    double span = (uint16_t)(to->at - from->at), pos = (uint16_t)(p - from->at);
+    led_color_t c = led_keyframes_sample(frames, count, (uint16_t)p);
+    int e = channel_error(c.r, from->color.r, to->color.r, pos / span);
+    if (channel_error(c.g, from->color.g, to->color.g, pos / span) > e) {
+      e = channel_error(c.g, from->color.g, to->color.g, pos / span);
+    }
+    if (channel_error(c.b, from->color.b, to->color.b, pos / span) > e) {
+      e = channel_error(c.b, from->color.b, to->color.b, pos / span);
+    }
+    if ((uint32_t)e > key_worst) key_worst = (uint32_t)e;
+  }
+  printf("keyframes,,,%lu\n", (unsigned long)key_worst);
+  if (key_worst > 1) {
+    snprintf(what, sizeof(what), "keyframes: colour off by %lu", (unsigned long)key_worst);
+    fail("wave", what);
+  }
+
+  //** 每个tick: 每颗LED一次相位、亮度、插值 - 和led_manager的led_layer_color一样
+  //** Per tick: phase, level and lerp once per LED - as led_manager's led_layer_color does
+  printf("tick,ns_tick,cycles_tick\n");
+  led_color_t base = { 0, 0, 0 }, top = { 0, 128, 255 };
+  for (int variant = 0; variant < 2; variant++) {
+    uint64_t ns = host_ns(), cycles = host_cycles();
+    for (uint32_t tick = 0; tick < TICKS; tick++) {
+      for (uint8_t led = 0; led < LED_COUNT; led++) {
+        led_color_t c;
+        if (variant == 0) {
+          uint16_t phase = (uint16_t)(led_wave_phase(tick * 20, 2000) + led * 0x2000);
+          c = led_color_lerp(base, top, led_wave_level(LED_WAVE_SINE, phase));
+        } else {
+          c = float_pulse(top, tick * 20 + led * 250, 2000);
+        }
+        tick_sink = (uint8_t)(tick_sink + c.r + c.g + c.b);
+      }
+    }
+    ns = host_ns() - ns;
+    cycles = host_cycles() - cycles;
+    printf("%s,%.1f,%s%.1f\n", variant == 0 ? "fixed_sine" : "float_sin", (double)ns / TICKS, HAVE_CYCLES ? "" : "~",
+           HAVE_CYCLES ? (double)cycles / TICKS : 0.0);
+  }
+  printf("# wave: %d LEDs per tick, host cycles (rdtsc), not ESP32 cycles\n", LED_COUNT);
+}
+
+//** ========================================
+//** output - 输出级省掉的show / Shows the Output Stage Saves
+//** ========================================
+
+//** 跑ticks个LED帧 - 和LED任务一样每LED_FRAME_MS叫一次led_process()
+//** Runs ticks LED frames - led_process() every LED_FRAME_MS, as the LED task does
+static void output_run(uint32_t ticks) {
+  for (uint32_t i = 0; i < ticks; i++) {
+    host_clock_advance_to(host_clock_us() + LED_FRAME_MS * 1000u);
+    led_process();
+  }
+}
+
+static void output_expect(bool ok, const char* what) {
+  if (!ok) fail("output", what);
+}
+
+static void check_output(void) {
+  char what[160];
+  const led_stats_t* stats = led_get_stats();
+  host_clock_config(0, false);
+  led_manager_init();
+  output_expect(stats->shows == 1 && FastLED.show_count == 1, "led_init did not send exactly one black frame");
+
+  //** 固定颜色 - 第一帧发，之后全部省掉 / Static colour - the first frame goes out, every later one is skipped
+  led_reset_stats();
+  uint32_t fake_before = FastLED.show_count;
+  led_set_solid(LED_PRIORITY_SYSTEM, 0, 128, 255, 0);
+  output_run(500);
+  uint32_t static_shows = stats->shows;
+  output_run(500);
+  printf("case,ticks,shows,skipped,deferred\n");
+  printf("static,1000,%lu,%lu,%lu\n", (unsigned long)stats->shows, (unsigned long)stats->skipped,
+         (unsigned long)stats->deferred);
+  output_expect(static_shows == 1 && stats->shows == 1, "the show count kept rising for a static colour");
+  output_expect(stats->shows + stats->skipped == 1000, "a static frame was neither sent nor skipped");
+  output_expect(FastLED.show_count - fake_before == stats->shows, "FastLED.show() calls differ from stats->shows");
+  output_expect(FastLED.wire[0] == CRGB(0, 128, 255) && FastLED.wire[LED_COUNT - 1] == CRGB(0, 128, 255),
+                "the strip does not hold the static colour");
+  output_expect(!led_pending(), "a static colour left a frame pending");
+
+  //** 闪烁 - 2秒里每250ms一个边沿 / Blink - one edge every 250 ms over 2 seconds
+  led_reset_stats();
+  fake_before = FastLED.show_count;
+  led_set_blink(LED_PRIORITY_TEST, 255, 0, 0, 500, 0);
+  output_run(100);
+  printf("blink,100,%lu,%lu,%lu\n", (unsigned long)stats->shows, (unsigned long)stats->skipped,
+         (unsigned long)stats->deferred);
+  if (stats->shows < 8 || stats->shows > 9 || FastLED.show_count - fake_before != stats->shows) {
+    snprintf(what, sizeof(what), "a 500 ms blink over 2 s sent %lu frames, want its 8-9 edges",
+             (unsigned long)stats->shows);
+    fail("output", what);
+  }
+
+  //** 释放闪烁 - 下面的固定颜色发一次就停 / Releasing the blink - the colour below goes out once, then stops
+  led_release(LED_PRIORITY_TEST);
+  led_reset_stats();
+  output_run(100);
+  output_expect(stats->shows <= 1 && FastLED.wire[0] == CRGB(0, 128, 255), "the layer below did not settle");
+
+  //** 亮度 - 一样的不发，变了发一次 / Brightness - the same value is not sent, a new one once
+  led_reset_stats();
+  led_set_brightness(FastLED.getBrightness());
+  output_expect(stats->shows == 0 && stats->skipped == 1, "an unchanged brightness was sent");
+  host_clock_advance_to(host_clock_us() + LED_FRAME_MS * 1000u);
+  led_set_brightness((uint8_t)(FastLED.getBrightness() ^ 0x10));
+  output_expect(stats->shows == 1 && FastLED.wire_brightness == FastLED.getBrightness(), "a new brightness was not sent");
+
+  //** 限速 - 5ms内第二次变化推迟，下一次提交补发 / Rate limit - a second change within 5 ms waits for the next commit
+  led_reset_stats();
+  host_clock_advance_to(host_clock_us() + LED_FRAME_MS * 1000u);
+  led_set_color(1, 2, 3);
+  led_set_color(4, 5, 6);
+  output_expect(stats->shows == 1 && stats->deferred == 1 && led_pending(), "a change inside 5 ms was not deferred");
+  host_clock_advance_to(host_clock_us() + 1000000u / HW_LED_MAX_REFRESH_HZ);
+  led_set_color(4, 5, 6);
+  output_expect(stats->shows == 2 && !led_pending() && FastLED.wire[0] == CRGB(4, 5, 6),
+                "the deferred frame was not sent by the next commit");
+}
+
+//** ========================================
+//** rmt - RMT符号的标准答案 / Golden RMT Symbols
+//** ========================================
+
+//** LED_RMT_TIMING_WS2812按rmt_item32_t手算的字 - 不用led_rmt_symbol()，布局错了也能抓到
+//** Words computed by hand from LED_RMT_TIMING_WS2812 in the rmt_item32_t layout - not via led_rmt_symbol(), so a
+//** wrong layout is caught too
+#define RMT_BIT0  0x00228010u       // 16 tick高 + 34 tick低 / 16 ticks high + 34 ticks low
+#define RMT_BIT1  0x00128020u       // 32 tick高 + 18 tick低 / 32 ticks high + 18 ticks low
+#define RMT_RESET 0x17701770u       // 6000 + 6000 tick低 / 6000 + 6000 ticks low
+#define RMT_TICK_NS 25
+#define RMT_CANARY 0xDEADBEEFu
+
+typedef struct {
+  const char* name;
+  led_color_t pixels[3];
+  uint16_t count;
+  uint8_t brightness;
+  uint8_t wire[9];                  // 线上的GRB字节，按scale8手算 / GRB bytes on the wire, scale8 by hand
+} rmt_case_t;
+
+static const rmt_case_t rmt_cases[] = {
+  { "red",       { { 255, 0, 0 } },                                 1, 255, { 0x00, 0xFF, 0x00 } },
+  { "green",     { { 0, 255, 0 } },                                 1, 255, { 0xFF, 0x00, 0x00 } },
+  { "blue",      { { 0, 0, 255 } },                                 1, 255, { 0x00, 0x00, 0xFF } },
+  { "msb_first", { { 0x80, 0x01, 0xA5 } },                          1, 255, { 0x01, 0x80, 0xA5 } },
+  { "half",      { { 255, 128, 1 } },                               1, 128, { 0x40, 0x80, 0x00 } },
+  { "dark",      { { 255, 255, 255 } },                             1, 0,   { 0x00, 0x00, 0x00 } },
+  { "strip",     { { 1, 2, 3 }, { 0x10, 0x20, 0x30 }, { 255, 254, 253 } }, 3, 255,
+                 { 0x02, 0x01, 0x03, 0x20, 0x10, 0x30, 0xFE, 0xFF, 0xFD } },
+  { "strip_64",  { { 1, 2, 3 }, { 0x10, 0x20, 0x30 }, { 255, 254, 253 } }, 3, 64,
+                 { 0x00, 0x00, 0x00, 0x08, 0x04, 0x0C, 0x40, 0x40, 0x40 } },
+};
+
+static void check_rmt(void) {
+  char what[160];
+  const led_rmt_timing_t timing = LED_RMT_TIMING_WS2812;
+
+  //** 时序 - WS2812B: T0H/T1H 0.4/0.8us ±150ns，一位1.25us ±600ns，复位 ≥ 280us
+  //** Timings - WS2812B: T0H/T1H 0.4/0.8 us ±150 ns, one bit 1.25 us ±600 ns, reset >= 280 us
+  uint32_t t0h = timing.t0h * RMT_TICK_NS, t1h = timing.t1h * RMT_TICK_NS;
+  uint32_t bit0 = (timing.t0h + timing.t0l) * RMT_TICK_NS, bit1 = (timing.t1h + timing.t1l) * RMT_TICK_NS;
+  printf("timing,t0h_ns,t1h_ns,bit0_ns,bit1_ns,reset_us\n");
+  printf("ws2812,%lu,%lu,%lu,%lu,%lu\n", (unsigned long)t0h, (unsigned long)t1h, (unsigned long)bit0,
+         (unsigned long)bit1, (unsigned long)(timing.reset * RMT_TICK_NS / 1000));
+  if (t0h < 250 || t0h > 550 || t1h < 650 || t1h > 950 || bit0 < 650 || bit0 > 1850 || bit1 < 650 || bit1 > 1850 ||
+      timing.reset * RMT_TICK_NS < 280000) {
+    fail("rmt", "LED_RMT_TIMING_WS2812 is outside the WS2812B tolerances");
+  }
+
+  printf("case,symbols,mismatches\n");
+  for (uint32_t c = 0; c < sizeof(rmt_cases) / sizeof(rmt_cases[0]); c++) {
+    const rmt_case_t* rc = &rmt_cases[c];
+    led_rmt_symbol_t golden[LED_RMT_SYMBOLS(3)], out[LED_RMT_SYMBOLS(3) + 1];
+    size_t want = LED_RMT_SYMBOLS(rc->count);
+    for (size_t i = 0; i < want - 1; i++) {
+      golden[i] = (rc->wire[i / 8] & (0x80 >> (i % 8))) ? RMT_BIT1 : RMT_BIT0;
+    }
+    golden[want - 1] = RMT_RESET;
+    for (size_t i = 0; i < sizeof(out) / sizeof(out[0]); i++) out[i] = RMT_CANARY;
+
+    size_t got = led_rmt_encode(rc->pixels, rc->count, rc->brightness, &timing, out);
+    uint32_t mismatches = 0, first = 0;
+    for (size_t i = 0; i < want; i++) {
+      if (out[i] != golden[i] && mismatches++ == 0) first = (uint32_t)i;
+    }
+    printf("%s,%lu,%lu\n", rc->name, (unsigned long)got, (unsigned long)mismatches);
+    if (got != want || out[want] != RMT_CANARY) {
+      snprintf(what, sizeof(what), "%s: %lu symbols returned, want %lu, or wrote past the end", rc->name,
+               (unsigned long)got, (unsigned long)want);
+      fail("rmt", what);
+    }
+    if (mismatches) {
+      snprintf(what, sizeof(what), "%s: %lu symbols differ, first #%lu is 0x%08lX, want 0x%08lX", rc->name,
+               (unsigned long)mismatches, (unsigned long)first, (unsigned long)out[first],
+               (unsigned long)golden[first]);
+      fail("rmt", what);
+    }
+  }
+}
+
+//** ========================================
+//** layers - 图层合成 / Layer Compositing
+//** ========================================
+
+static void layer_request(led_priority_t priority, led_mode_t mode, led_color_t color, uint64_t leds,
+                          uint32_t duration_ms) {
+  led_request_t request;
+  memset(&request, 0, sizeof(request));
+  request.priority = priority;
+  request.mode = mode;
+  request.red = color.r;
+  request.green = color.g;
+  request.blue = color.b;
+  request.period_ms = 1000;
+  request.duration_ms = duration_ms;
+  request.wave = LED_WAVE_BREATHE;
+  request.leds = leds;
+  request.spread = 0x4000;
+  led_request(&request);
+}
+
+static void layers_clear(void) {
+  for (uint8_t i = 0; i < LED_LAYER_COUNT; i++) led_release((led_priority_t)i);
+}
+
+//** 灯带上的颜色 (替身记的是未乘亮度的像素) / The colours on the strip (the fake keeps pixels before brightness)
+static bool strip_is(led_color_t led0, led_color_t led1) {
+  return FastLED.wire[0] == CRGB(led0.r, led0.g, led0.b) && FastLED.wire[1] == CRGB(led1.r, led1.g, led1.b);
+}
+
+static void check_layers(void) {
+  char what[160];
+  host_clock_config(0, false);
+  led_manager_init();
+  layers_clear();
+
+  //** IDLE全部A，SYSTEM只盖LED1为B，TEST全部C 100ms，PANIC只盖LED0为D 60ms
+  //** IDLE all A, SYSTEM only LED1 as B, TEST all C for 100 ms, PANIC only LED0 as D for 60 ms
+  const led_color_t a = { 0, 0, 255 }, b = { 0, 255, 0 }, c = { 255, 255, 0 }, d = { 255, 0, 0 }, off = { 0, 0, 0 };
+  layer_request(LED_PRIORITY_IDLE, LED_MODE_SOLID, a, 0, 0);
+  layer_request(LED_PRIORITY_SYSTEM, LED_MODE_SOLID, b, 1ULL << 1, 0);
+  layer_request(LED_PRIORITY_TEST, LED_MODE_SOLID, c, 0, 100);
+  layer_request(LED_PRIORITY_PANIC, LED_MODE_SOLID, d, 1ULL << 0, 60);
+  output_run(1);
+  if (!strip_is(d, c)) fail("layers", "PANIC on LED0 and TEST on LED1 should show");
+  output_run(3);                      // 80ms - PANIC超时 / PANIC timed out
+  if (!strip_is(c, c)) fail("layers", "TEST did not resume under the expired PANIC layer");
+  output_run(2);                      // 120ms - TEST超时 / TEST timed out
+  if (!strip_is(a, b)) fail("layers", "IDLE and SYSTEM did not resume under the expired TEST layer");
+  led_release(LED_PRIORITY_SYSTEM);
+  output_run(1);
+  if (!strip_is(a, a)) fail("layers", "IDLE did not resume on LED1 after SYSTEM was released");
+  led_release(LED_PRIORITY_IDLE);
+  output_run(1);
+  if (!strip_is(off, off)) fail("layers", "LEDs with no layer are not off");
+
+  //** 代价 - 每层都是动画；层i盖住LED i % HW_LED_COUNT，上面的层不会把下面的全挡掉
+  //** Cost - every layer animates; layer i covers LED i % HW_LED_COUNT, so upper layers do not hide all below
+  printf("layers,ticks,ns_tick,cycles_tick,shows\n");
+  for (uint8_t n = 0; n <= LED_LAYER_COUNT; n++) {
+    layers_clear();
+    for (uint8_t i = 0; i < n; i++) {
+      led_color_t color = { (uint8_t)(64 * i), 128, (uint8_t)(255 - 64 * i) };
+      layer_request((led_priority_t)i, i % 2 ? LED_MODE_WAVE : LED_MODE_PULSE, color, 1ULL << (i % LED_COUNT), 0);
+    }
+    output_run(10);
+    led_reset_stats();
+    const uint32_t ticks = 100000;
+    uint64_t ns = host_ns(), cycles = host_cycles();
+    output_run(ticks);
+    ns = host_ns() - ns;
+    cycles = host_cycles() - cycles;
+    printf("%u,%lu,%.1f,%s%.1f,%lu\n", n, (unsigned long)ticks, (double)ns / ticks, HAVE_CYCLES ? "" : "~",
+           HAVE_CYCLES ? (double)cycles / ticks : 0.0, (unsigned long)led_get_stats()->shows);
+    if (n && led_get_stats()->shows == 0) {
+      snprintf(what, sizeof(what), "%u animated layers never reached the strip", n);
+      fail("layers", what);
+    }
+  }
+  layers_clear();
+  printf("# layers: %d LEDs, led_process() including the output stage and the fake FastLED.show(), host cycles\n",
+         LED_COUNT);
+}
+
+//** ========================================
+//** 入口 / Entry
+//** ========================================
+
+typedef struct {
+  const char* name;
+  void (*run)(void);
+} led_check_t;
+
+static const led_check_t checks[] = {
+  { "wave", check_wave },
+  { "output", check_output },
+  { "rmt", check_rmt },
+  { "layers", check_layers },
+};
+#define CHECK_COUNT (sizeof(checks) / sizeof(checks[0]))
+
+int main(int argc, char** argv) {
+  uint32_t ran = 0;
+  for (uint32_t i = 0; i < CHECK_COUNT; i++) {
+    if (argc > 1 && strcmp(argv[1], checks[i].name) != 0) continue;
+    uint32_t before = failures;
+    checks[i].run();
+    printf("%s: %s\n", checks[i].name, failures == before ? "OK" : "FAIL");
+    ran++;
+  }
+  if (!ran) {
+    fprintf(stderr, "unknown check: %s\n", argv[1]);
+    return 2;
+  }
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,481 @@
+//** ESP32-S3 HoloCubic - 二进制串口协议回环测试 / Binary Link Loopback Test over a pty
+//**
+//** pio run -e native_link_bench -t exec
+//** .pio/build/native_link_bench/program [选项] [串口]
+//**   (无串口)           建一对pty，设备端在另一个线程里跑 / make a pty pair, device side runs in another thread
+//**   /dev/ttyACM0       同样的测试对真设备跑 / the same tests against a real device
+//**   --serve            只跑pty的设备端，打印路径给scripts/7_usb_link.py / pty device side only, prints the path
+//**                      for scripts/7_usb_link.py
+//**   --frames N         上传几张整屏图 (默认200) / full-screen images to upload (default 200)
+//**   --pings N          回显几个1KB的PING (默认2000) / 1KB PINGs to echo (default 2000)
+//**   --corrupt P        每千帧随机改坏P帧的一个字节，测重发 / corrupt one byte in P of every 1000 frames, tests resending
+//**
+//** 设备端就是src/app/interface/usb_link.cpp和link_proto.cpp，和固件同一份代码，跑在native/fakes的Serial上；
+//** 交给渲染核的图在这里逐像素核对，晚一圈才画完，走一遍忙了重试的路。出错或者结果不对退出码1。
+//** The device side is src/app/interface/usb_link.cpp and link_proto.cpp, the same code as the firmware, running on
+//** native/fakes' Serial; images handed to the render core are checked pixel by pixel here and finish one pass
+//** later, exercising the busy/retry path. Errors or wrong results exit 1.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <atomic>
+#include <thread>
+#include "app/core/app_main.h"
+#include "app/interface/command_handler.h"
+#include "app/interface/link_proto.h"
+#include "app/interface/usb_link.h"
+#include <Arduino.h>
+
+#define SCREEN_W            240
+#define SCREEN_H            240
+#define SCREEN_BYTES        (SCREEN_W * SCREEN_H * 2)
+#define DATA_CHUNK          (LINK_PAYLOAD_MAX - 4)
+#define RESEND_MS           100         // 这么久窗口没动就从base重发 / resend from base after this long without progress
+#define REPLY_TIMEOUT_MS    3000
+
+static uint64_t host_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+//** 第frame张图的第i个像素 - 两端都按这个生成和核对 / Pixel i of image `frame` - both ends generate and check this
+static uint16_t test_pixel(uint32_t frame, uint32_t i) {
+  return (uint16_t)(frame * 2654435761u + i * 40503u);
+}
+
+//** ========================================
+//** 串口 / Port
+//** ========================================
+
+static void port_raw(int fd) {
+  struct termios tio;
+  if (tcgetattr(fd, &tio) == 0) {
+    cfmakeraw(&tio);
+    tcsetattr(fd, TCSANOW, &tio);
+  }
+}
+
+static bool port_write(int fd, const uint8_t* data, size_t len) {
+  while (len) {
+    ssize_t n = write(fd, data, len);
+    if (n < 0) {
+      if (errno != EAGAIN && errno != EINTR) return false;
+      struct pollfd pfd = {fd, POLLOUT, 0};
+      poll(&pfd, 1, 100);
+      continue;
+    }
+    data += n;
+    len -= (size_t)n;
+  }
+  return true;
+}
+
+static size_t port_read(int fd, uint8_t* buf, size_t cap, int timeout_ms) {
+  struct pollfd pfd = {fd, POLLIN, 0};
+  if (poll(&pfd, 1, timeout_ms) <= 0) return 0;
+  ssize_t n = read(fd, buf, cap);
+  return n > 0 ? (size_t)n : 0;
+}
+
+//** ========================================
+//** 设备端 - 真的usb_link，command_handler_process()的喂法 / Device Side - the real usb_link, fed the way
+//** command_handler_process() feeds it
+//** ========================================
+
+//** usb_link的METRICS要读的别的模块 - 这里没有，给空的 / Other modules usb_link's METRICS reads - absent here, empty
+static frame_pacer_t bench_pacer;
+static app_msg_stats_t bench_inbox;
+static command_stats_t bench_commands;
+
+frame_pacer_t* app_frame_pacer(void) { return &bench_pacer; }
+const app_msg_stats_t* app_inbox_stats(void) { return &bench_inbox; }
+const command_stats_t* command_handler_stats(void) { return &bench_commands; }
+
+typedef struct {
+  const uint16_t* blit;         // 交给"渲染核"了还没画 / handed to the "render core", not drawn yet
+  int16_t blit_w, blit_h;
+  uint32_t images, bad_images;
+} device_t;
+
+static device_t dev;
+
+static bool device_blit(int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t* pixels) {
+  dev.blit = pixels;
+  dev.blit_w = w;
+  dev.blit_h = h;
+  return true;
+}
+
+//** 渲染核画完 - 核对第images张图，再告诉usb_link / The render core finishes - check image `images`, then tell usb_link
+static void device_draw(void) {
+  if (!dev.blit) return;
+  bool ok = dev.blit_w == SCREEN_W && dev.blit_h == SCREEN_H;
+  for (uint32_t i = 0; ok && i < SCREEN_W * SCREEN_H; i++) ok = dev.blit[i] == test_pixel(dev.images, i);
+  dev.bad_images += !ok;
+  dev.images++;
+  dev.blit = NULL;
+  usb_link_blit_done();
+}
+
+static void device_run(int fd, std::atomic<bool>* stop) {
+  memset(&dev, 0, sizeof(dev));
+  Serial.set_input(-1);
+  Serial.set_output(fd);
+  usb_link_init();
+  usb_link_set_blit(device_blit);
+
+  uint8_t buf[4096];
+  size_t len = 0, pos = 0;
+  while (!stop->load()) {
+    device_draw();
+    if (pos == len) {
+      len = port_read(fd, buf, sizeof(buf), 50);
+      pos = 0;
+    }
+    //** 上一帧还没处理掉 - 剩下的字节先不动，下一圈画完再试 / A frame is still pending - leave the rest of the
+    //** bytes until the next pass has drawn
+    while (pos < len && usb_link_retry()) {
+      usb_link_feed(buf[pos++]);     // 文本字节这里没有命令行，丢掉 / no command line here, text is dropped
+    }
+    usb_link_flush();
+  }
+}
+
+//** ========================================
+//** 主机端 / Host Side
+//** ========================================
+
+#define REPLY_QUEUE 32
+
+typedef struct {
+  uint8_t msg;
+  uint16_t len;
+  uint8_t data[LINK_PAYLOAD_MAX];
+} reply_t;
+
+typedef struct {
+  int fd;
+  link_rx_t rx;
+  link_tx_window_t win;
+  uint8_t sent[LINK_WINDOW][LINK_WIRE_MAX];     // 没确认的帧，按seq % LINK_WINDOW放 / unacked frames by seq % LINK_WINDOW
+  uint16_t sent_len[LINK_WINDOW];
+  uint8_t wire[LINK_WIRE_MAX];
+  uint64_t progress_ns;                         // 窗口上次前进 / last time the window moved
+  uint8_t fast_base;                            // 这个base已经因为重复确认重发过 / already resent on a duplicate ack
+  bool fast_done;
+  reply_t replies[REPLY_QUEUE];
+  uint8_t reply_head, reply_count;
+  uint32_t corrupt_permille, corrupted, resent, errors, tx_bytes, rx_bytes, lost_replies;
+  uint32_t rng;
+} client_t;
+
+static void client_init(client_t* c, int fd, uint32_t corrupt_permille) {
+  memset(c, 0, sizeof(*c));
+  c->fd = fd;
+  c->corrupt_permille = corrupt_permille;
+  c->rng = 0x9E3779B9u;
+  c->progress_ns = host_ns();
+  link_rx_reset(&c->rx);
+  //** 先发两个0x00，对方不管在帧里还是帧外都回到帧开头 / Two 0x00 first put the other end at a frame start either way
+  static const uint8_t sync[2] = {LINK_ESCAPE, LINK_ESCAPE};
+  port_write(fd, sync, sizeof(sync));
+}
+
+static uint32_t client_rng(client_t* c) {
+  c->rng ^= c->rng << 13;
+  c->rng ^= c->rng >> 17;
+  c->rng ^= c->rng << 5;
+  return c->rng;
+}
+
+//** 发到线上 - 按概率改坏一个字节 (不改成0，不碰两头的分界) / Put on the wire - maybe corrupt one byte (never into
+//** 0, never a delimiter)
+static void client_wire(client_t* c, const uint8_t* wire, size_t len) {
+  if (c->corrupt_permille && client_rng(c) % 1000 < c->corrupt_permille && len > 2) {
+    uint8_t bad[LINK_WIRE_MAX];
+    memcpy(bad, wire, len);
+    size_t at = 1 + client_rng(c) % (len - 2);
+    uint8_t flip = (uint8_t)(1u << (client_rng(c) % 8));
+    if ((bad[at] ^ flip) == 0) flip ^= 0x80;
+    bad[at] ^= flip;
+    c->corrupted++;
+    port_write(c->fd, bad, len);
+  } else {
+    port_write(c->fd, wire, len);
+  }
+  c->tx_bytes += (uint32_t)len;
+}
+
+static void client_resend(client_t* c) {
+  for (uint8_t seq = c->win.base; seq != c->win.next; seq++) {
+    client_wire(c, c->sent[seq % LINK_WINDOW], c->sent_len[seq % LINK_WINDOW]);
+    c->resent++;
+  }
+  c->progress_ns = host_ns();
+}
+
+static void client_on_frame(client_t* c, const link_frame_t* frame) {
+  if (link_tx_acked(&c->win, frame->ack)) {
+    c->progress_ns = host_ns();
+    c->fast_done = false;
+  } else if (frame->msg == LINK_MSG_ACK && link_tx_in_flight(&c->win) &&
+             !(c->fast_done && c->fast_base == c->win.base)) {
+    //** 重复确认 - 对方丢了base这一帧，整个窗口重发一次 / Duplicate ack - the device lost frame `base`, resend the
+    //** window once
+    c->fast_base = c->win.base;
+    c->fast_done = true;
+    client_resend(c);
+  }
+  if (frame->msg == LINK_MSG_ACK) return;
+  if (c->reply_count == REPLY_QUEUE) {
+    c->lost_replies++;
+    return;
+  }
+  reply_t* reply = &c->replies[(c->reply_head + c->reply_count++) % REPLY_QUEUE];
+  reply->msg = frame->msg;
+  reply->len = frame->len;
+  memcpy(reply->data, frame->payload, frame->len);
+}
+
+//** 收一批；文本原样打到stderr / Receive one batch; text goes to stderr unchanged
+static void client_poll(client_t* c, int timeout_ms) {
+  uint8_t buf[4096];
+  size_t n = port_read(c->fd, buf, sizeof(buf), timeout_ms);
+  c->rx_bytes += (uint32_t)n;
+  for (size_t i = 0; i < n; i++) {
+    bool done;
+    if (!link_rx_feed(&c->rx, buf[i], &done)) fputc(buf[i], stderr);
+    if (!done) continue;
+    link_frame_t frame;
+    if (link_rx_frame(&c->rx, &frame) != LINK_OK) {
+      c->errors++;
+      continue;
+    }
+    client_on_frame(c, &frame);
+  }
+  if (link_tx_in_flight(&c->win) && host_ns() - c->progress_ns > RESEND_MS * 1000000ull) client_resend(c);
+}
+
+static void client_send(client_t* c, uint8_t msg, const uint8_t* payload, uint16_t len) {
+  link_frame_t frame = {msg, 0, 0, 0, payload, len};
+  client_wire(c, c->wire, link_frame_encode(c->wire, &frame));
+}
+
+//** 按序号发 - 窗口满了先收 / Sequenced send - receive first while the window is full
+static void client_send_seq(client_t* c, uint8_t msg, const uint8_t* payload, uint16_t len) {
+  while (!link_tx_can_send(&c->win)) client_poll(c, 1);
+  uint8_t slot = c->win.next % LINK_WINDOW;
+  link_frame_t frame = {msg, LINK_FLAG_SEQ, c->win.next, 0, payload, len};
+  c->sent_len[slot] = (uint16_t)link_frame_encode(c->sent[slot], &frame);
+  if (!link_tx_in_flight(&c->win)) c->progress_ns = host_ns();
+  c->win.next++;
+  client_wire(c, c->sent[slot], c->sent_len[slot]);
+}
+
+static bool client_reply(client_t* c, reply_t* out, int timeout_ms) {
+  uint64_t until = host_ns() + (uint64_t)timeout_ms * 1000000ull;
+  while (c->reply_count == 0) {
+    if (host_ns() > until) return false;
+    client_poll(c, 1);
+  }
+  *out = c->replies[c->reply_head];
+  c->reply_head = (uint8_t)((c->reply_head + 1) % REPLY_QUEUE);
+  c->reply_count--;
+  return true;
+}
+
+//** ========================================
+//** 测试 / Tests
+//** ========================================
+
+static uint32_t failures = 0;
+
+static void fail(const char* what) {
+  if (failures++ < 10) fprintf(stderr, "FAIL %s\n", what);
+}
+
+static void test_metrics(client_t* c) {
+  client_send(c, LINK_MSG_METRICS_GET, NULL, 0);
+  reply_t reply;
+  if (!client_reply(c, &reply, REPLY_TIMEOUT_MS) || reply.msg != LINK_MSG_METRICS || reply.len < 2 ||
+      reply.len != 2 + reply.data[1] * 4 || reply.data[0] != USB_LINK_METRICS_VERSION ||
+      reply.data[1] != USB_LINK_METRIC_COUNT) {
+    fail("metrics");
+    return;
+  }
+  printf("metrics        version %u, %u values\n", reply.data[0], reply.data[1]);
+}
+
+//** 整屏图一张接一张，不等回复；回复边收边数 / Full-screen images back to back without waiting; replies are counted
+//** as they come
+static void test_upload(client_t* c, uint32_t frames) {
+  static uint16_t pixels[SCREEN_W * SCREEN_H];
+  uint8_t payload[LINK_PAYLOAD_MAX];
+  uint32_t ok = 0, replies = 0;
+  uint32_t resent0 = c->resent;
+  uint64_t t0 = host_ns();
+
+  for (uint32_t f = 0; f < frames; f++) {
+    for (uint32_t i = 0; i < SCREEN_W * SCREEN_H; i++) pixels[i] = test_pixel(f, i);
+    link_put_u16(payload, 0);
+    link_put_u16(payload + 2, 0);
+    link_put_u16(payload + 4, SCREEN_W);
+    link_put_u16(payload + 6, SCREEN_H);
+    client_send_seq(c, LINK_MSG_FB_BEGIN, payload, 8);
+    for (uint32_t offset = 0; offset < SCREEN_BYTES; offset += DATA_CHUNK) {
+      uint32_t n = SCREEN_BYTES - offset < DATA_CHUNK ? SCREEN_BYTES - offset : DATA_CHUNK;
+      link_put_u32(payload, offset);
+      memcpy(payload + 4, (const uint8_t*)pixels + offset, n);
+      client_send_seq(c, LINK_MSG_FB_DATA, payload, (uint16_t)(n + 4));
+    }
+    client_send_seq(c, LINK_MSG_FB_END, NULL, 0);
+
+    reply_t reply;
+    while (c->reply_count && client_reply(c, &reply, 0)) {
+      replies++;
+      ok += reply.msg == LINK_MSG_STATUS && reply.data[1] == LINK_STATUS_OK;
+    }
+  }
+  while (replies < frames) {
+    reply_t reply;
+    if (!client_reply(c, &reply, REPLY_TIMEOUT_MS)) break;
+    replies++;
+    ok += reply.msg == LINK_MSG_STATUS && reply.data[1] == LINK_STATUS_OK;
+  }
+  uint64_t spent = host_ns() - t0;
+  if (ok != frames) fail("upload: not every image arrived intact");
+
+  double mb = (double)frames * SCREEN_BYTES / 1e6;
+  printf("upload         %8.2f MB/s %8.1f fps   %u/%u images ok, %u frames resent\n", mb / (spent / 1e9),
+         frames / (spent / 1e9), ok, frames, c->resent - resent0);
+}
+
+//** 1KB的PING，最多LINK_WINDOW个在路上；PING不按序号、不重发，所以这里不改坏帧
+//** 1KB PINGs, up to LINK_WINDOW in flight; PINGs are unsequenced and never resent, so no corruption here
+static void test_echo(client_t* c, uint32_t pings) {
+  uint32_t corrupt = c->corrupt_permille;
+  c->corrupt_permille = 0;
+  uint8_t payload[LINK_PAYLOAD_MAX];
+  uint32_t sent = 0, received = 0, bad = 0;
+  uint64_t t0 = host_ns();
+
+  while (received < pings) {
+    while (sent < pings && sent - received < LINK_WINDOW) {
+      for (uint16_t i = 0; i < sizeof(payload); i++) payload[i] = (uint8_t)(sent * 7u + i);
+      client_send(c, LINK_MSG_PING, payload, sizeof(payload));
+      sent++;
+    }
+    reply_t reply;
+    if (!client_reply(c, &reply, REPLY_TIMEOUT_MS)) {
+      fail("echo: reply timed out");
+      break;
+    }
+    if (reply.msg != LINK_MSG_PONG) continue;
+    if (reply.len != sizeof(payload)) bad++;
+    received++;
+  }
+  uint64_t spent = host_ns() - t0;
+  if (bad) fail("echo: wrong payload");
+
+  double mb = (double)pings * sizeof(payload) / 1e6;
+  printf("echo           %8.2f MB/s each way   %u pings\n", mb / (spent / 1e9), pings);
+
+  //** 单个小帧往返 / Round trip of one small frame
+  const uint32_t rounds = 200;
+  t0 = host_ns();
+  for (uint32_t i = 0; i < rounds; i++) {
+    client_send(c, LINK_MSG_PING, payload, 16);
+    reply_t reply;
+    if (!client_reply(c, &reply, REPLY_TIMEOUT_MS)) fail("ping timed out");
+  }
+  printf("round trip     %8.1f us\n", (host_ns() - t0) / 1e3 / rounds);
+  c->corrupt_permille = corrupt;
+}
+
+int main(int argc, char** argv) {
+  const char* port = NULL;
+  bool serve = false;
+  uint32_t frames = 200, pings = 2000, corrupt = 0;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--serve") == 0) {
+      serve = true;
+    } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+      frames = (uint32_t)strtoul(argv[++i], NULL, 0);
+    } else if (strcmp(argv[i], "--pings") == 0 && i + 1 < argc) {
+      pings = (uint32_t)strtoul(argv[++i], NULL, 0);
+    } else if (strcmp(argv[i], "--corrupt") == 0 && i + 1 < argc) {
+      corrupt = (uint32_t)strtoul(argv[++i], NULL, 0);
+    } else if (argv[i][0] != '-') {
+      port = argv[i];
+    } else {
+      fprintf(stderr, "usage: %s [--serve] [--frames N] [--pings N] [--corrupt PERMILLE] [PORT]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  int host_fd, device_fd = -1;
+  if (port) {
+    host_fd = open(port, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (host_fd < 0) {
+      perror(port);
+      return 1;
+    }
+  } else {
+    host_fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (host_fd < 0 || grantpt(host_fd) || unlockpt(host_fd)) {
+      perror("posix_openpt");
+      return 1;
+    }
+    device_fd = open(ptsname(host_fd), O_RDWR | O_NOCTTY | O_NONBLOCK);
+    port_raw(device_fd);
+    fcntl(host_fd, F_SETFL, O_NONBLOCK);
+  }
+  port_raw(host_fd);
+
+  std::atomic<bool> stop(false);
+  if (serve) {
+    //** 设备端在pty主端上跑，客户端开从端；这边的从端fd一直开着，客户端断开重连时pty不会挂断
+    //** The device side runs on the pty master and the client opens the slave; our slave fd stays open so the pty
+    //** does not hang up when the client reconnects
+    if (port) {
+      fprintf(stderr, "--serve makes its own pty\n");
+      return 2;
+    }
+    fprintf(stderr, "link_bench: device on %s (Ctrl-C to stop)\n", ptsname(host_fd));
+    printf("%s\n", ptsname(host_fd));
+    fflush(stdout);
+    device_run(host_fd, &stop);
+    return 0;
+  }
+
+  printf("# link_bench %s, payload %u, window %u, %u images, %u pings, corrupt %u/1000\n",
+         port ? port : "pty loopback", LINK_PAYLOAD_MAX, LINK_WINDOW, frames, pings, corrupt);
+  std::thread device;
+  if (!port) device = std::thread(device_run, device_fd, &stop);
+
+  static client_t client;
+  client_init(&client, host_fd, corrupt);
+  test_metrics(&client);
+  test_upload(&client, frames);
+  test_echo(&client, pings);
+  printf("wire           %u bytes out, %u bytes in, %u corrupted, %u crc errors seen, %u replies lost\n",
+         client.tx_bytes, client.rx_bytes, client.corrupted, client.errors, client.lost_replies);
+
+  stop.store(true);
+  if (device.joinable()) {
+    device.join();
+    const usb_link_stats_t* stats = usb_link_stats();
+    printf("device         %u frames, %u crc errors, %u resent, %u busy, %u images drawn, %u bad\n", stats->rx_frames,
+           stats->errors, stats->resent, stats->busy, dev.images, dev.bad_images);
+    if (dev.bad_images || dev.images != frames || stats->fb_uploads != frames) fail("device: images drawn wrong");
+  }
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,238 @@
+//** ESP32-S3 HoloCubic - 帧节拍器的虚拟时钟检查 / Frame Pacer Checks on a Virtual Clock
+//**
+//** pio run -e native_pacer -t exec
+//**
+//** 和app_main的帧任务一样的循环：睡到frame_pacer_wait_us，开始一帧，渲染，刷新。每种场景打印一行，
+//** 出错打印FAIL，任何失败退出码1。
+//** The same loop as app_main's frame task: sleep for frame_pacer_wait_us, begin a frame, render, flush. Each
+//** scenario prints one row, failures print FAIL, and any failure exits with 1.
+//**
+//** steady    预算内 - 没有跳帧，帧间隔等于周期，开始时间不漂移
+//**           Within budget - no skips, every interval is one period, begin times do not drift
+//** jitter    唤醒晚0-2ms - 间隔会抖，但开始时间始终在各自周期的格点之后2ms内
+//**           Wakeups up to 2 ms late - intervals jitter, but every begin stays within 2 ms of its grid point
+//** over      每帧1.5个周期 - 晚了的帧马上画，隔一帧跳一个周期，截止时间留在原来的相位上
+//**           1.5 periods per frame - a late frame runs at once, every other period is skipped, deadlines keep
+//**           their phase
+//** stall     一帧卡了5.3个周期 - 整周期数的跳帧，后面几帧晚画，每帧追回一点空闲，之后回到格点
+//**           One frame stalls 5.3 periods - whole missed periods skipped, the next few frames run late, each
+//**           catching up by its idle time, then back on the grid
+//** no_flush  刷新完成一直没报 - 下一帧开始时补上，idle为0
+//**           The flush never reports done - the next begin closes the frame with zero idle
+//** wrap      从micros()回绕前开始 - 和steady一样
+//**           Starting just before micros() wraps - same as steady
+//** fps       中途从60改到30fps - 之后的间隔是新周期
+//**           Switching from 60 to 30 fps mid-run - the intervals afterwards are the new period
+//**
+//** 每种场景都要满足：开始的帧 + 跳过的帧 = 从第一帧到最后一帧经过的周期数 + 1
+//** Every scenario must satisfy: frames begun + frames skipped = periods from the first to the last begin + 1
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "frame_pacer.h"
+
+#define FPS       60
+#define FRAMES    600
+
+static uint32_t failures;
+static frame_pacer_t pacer;
+static uint32_t vnow;             // 虚拟时钟 (us)
+
+static void fail(const char* scenario, const char* what) {
+  failures++;
+  if (failures <= 20) printf("FAIL %s: %s\n", scenario, what);
+}
+
+//** 一帧的代价 - 帧序号进，渲染/刷新的us出；flush为0表示不报刷新完成
+//** One frame's cost - frame number in, render/flush us out; flush 0 means done is never reported
+typedef struct {
+  uint32_t render_us;
+  uint32_t flush_us;
+  uint32_t late_us;           // 唤醒晚了多少 / how late the wakeup is
+} frame_cost_t;
+
+typedef frame_cost_t (*cost_fn)(uint32_t frame);
+
+//** 跑frames帧 - 每次开始时记录相对start的相位误差
+//** Runs frames frames - records each begin's offset from the grid anchored at start
+typedef struct {
+  uint32_t begins;
+  uint32_t off_grid;          // 开始时间离格点超过max_late的次数 / begins further than max_late from the grid
+  uint32_t max_offset_us;
+  uint32_t false_wakeups;     // 醒来但begin返回false / woke up but begin returned false
+  uint32_t last_begin_us;
+} run_result_t;
+
+static run_result_t run(uint32_t start, uint32_t frames, cost_fn cost, uint32_t max_late) {
+  run_result_t r = { 0, 0, 0, 0, start };
+  vnow = start;
+  for (uint32_t i = 0; i < frames; i++) {
+    frame_cost_t c = cost(i);
+    vnow += frame_pacer_wait_us(&pacer, vnow) + c.late_us;
+    if (!frame_pacer_begin(&pacer, vnow)) {
+      r.false_wakeups++;
+      continue;
+    }
+    r.begins++;
+    r.last_begin_us = vnow;
+    uint32_t offset = (vnow - start) % pacer.period_us;
+    if (offset > r.max_offset_us) r.max_offset_us = offset;
+    if (offset > max_late) r.off_grid++;
+
+    vnow += c.render_us;
+    frame_pacer_rendered(&pacer, vnow);
+    if (c.flush_us) {
+      vnow += c.flush_us;
+      frame_pacer_flushed(&pacer, vnow);
+    }
+  }
+  return r;
+}
+
+static void report(const char* name, const run_result_t* r) {
+  printf("%s,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n", name, (unsigned long)pacer.frames, (unsigned long)pacer.skipped,
+         (unsigned long)frame_hist_percentile(&pacer.interval, 50),
+         (unsigned long)frame_hist_percentile(&pacer.interval, 99), (unsigned long)pacer.interval.max_us,
+         (unsigned long)frame_hist_percentile(&pacer.render, 99), (unsigned long)frame_hist_percentile(&pacer.flush, 99),
+         (unsigned long)frame_hist_percentile(&pacer.idle, 50), (unsigned long)r->max_offset_us);
+}
+
+static void expect(const char* name, bool ok, const char* what) {
+  if (!ok) fail(name, what);
+}
+
+//** 每个周期的格点要么开始了一帧，要么记了一次跳帧 / Every grid slot either began a frame or counted a skip
+static void expect_slots(const char* name, const run_result_t* r, uint32_t start) {
+  uint32_t slots = (r->last_begin_us - start) / pacer.period_us + 1;
+  if (r->begins + pacer.skipped != slots) {
+    char what[128];
+    snprintf(what, sizeof(what), "%lu begun + %lu skipped != %lu slots", (unsigned long)r->begins,
+             (unsigned long)pacer.skipped, (unsigned long)slots);
+    fail(name, what);
+  }
+}
+
+// ========================================
+// 场景 / Scenarios
+// ========================================
+
+static frame_cost_t cost_steady(uint32_t frame) {
+  frame_cost_t c = { 5000, 8000, 0 };
+  return c;
+}
+
+static frame_cost_t cost_jitter(uint32_t frame) {
+  frame_cost_t c = { 5000, 8000, (uint32_t)rand() % 2000 };
+  return c;
+}
+
+static frame_cost_t cost_over(uint32_t frame) {
+  frame_cost_t c = { 15000, 10000, 0 };   // 25ms = 1.5周期 / 1.5 periods
+  return c;
+}
+
+static frame_cost_t cost_stall(uint32_t frame) {
+  uint32_t period = 1000000u / FPS;
+  frame_cost_t c = { 5000, 8000, 0 };
+  if (frame == 100) c.render_us = period * 53 / 10;
+  return c;
+}
+
+static frame_cost_t cost_no_flush(uint32_t frame) {
+  frame_cost_t c = { 5000, 0, 0 };
+  return c;
+}
+
+static void scenario_steady(const char* name, uint32_t start) {
+  frame_pacer_init(&pacer, FPS, start);
+  run_result_t r = run(start, FRAMES, cost_steady, 0);
+  report(name, &r);
+  expect_slots(name, &r, start);
+  expect(name, pacer.frames == FRAMES && pacer.skipped == 0, "frames rendered or skipped wrong");
+  expect(name, r.off_grid == 0 && r.false_wakeups == 0, "a begin left the grid or woke up early");
+  expect(name, pacer.interval.samples == FRAMES - 1 && pacer.interval.max_us == pacer.period_us &&
+               pacer.interval.total_us == (uint64_t)pacer.period_us * (FRAMES - 1), "an interval is not one period");
+  expect(name, pacer.idle.max_us == pacer.period_us - 13000, "idle is not period - render - flush");
+}
+
+static void scenario_jitter(const char* name) {
+  srand(1);
+  frame_pacer_init(&pacer, FPS, 0);
+  run_result_t r = run(0, FRAMES, cost_jitter, 2000);
+  report(name, &r);
+  expect_slots(name, &r, 0);
+  expect(name, pacer.frames == FRAMES && pacer.skipped == 0, "jitter inside the budget caused skips");
+  expect(name, r.off_grid == 0 && r.false_wakeups == 0, "late wakeups drifted the deadline");
+  expect(name, pacer.interval.max_us < pacer.period_us + 2000, "an interval longer than period + jitter");
+}
+
+static void scenario_over(const char* name) {
+  frame_pacer_init(&pacer, FPS, 0);
+  run_result_t r = run(0, FRAMES, cost_over, 0);
+  report(name, &r);
+  //** 每帧结束时下一帧已经到期，晚半个周期或一整个周期 - 背靠背每25ms一帧，每3个格点画2帧跳1个
+  //** Each frame ends with the next one already due, half or a whole period late - back to back every 25 ms,
+  //** two frames and one skip per three grid slots
+  expect_slots(name, &r, 0);
+  expect(name, pacer.frames == FRAMES && pacer.skipped == (FRAMES - 1) / 2, "not one skip per two frames");
+  expect(name, pacer.interval.max_us == 25000 && pacer.idle.max_us == 0, "over-budget frames did not run back to back");
+  expect(name, (pacer.deadline_us % pacer.period_us) == 0, "the deadline lost its phase");
+}
+
+static void scenario_stall(const char* name) {
+  frame_pacer_init(&pacer, FPS, 0);
+  run_result_t r = run(0, FRAMES, cost_stall, 0);
+  report(name, &r);
+  //** 卡住的帧在格点上开始，stall后结束；下一帧立刻开始，晚了的整周期数记为跳帧。它晚了stall % P，
+  //** 之后每帧追回 P - 13ms 的空闲 / The stalled frame begins on the grid and ends stall later; the next frame
+  //** begins at once with the whole periods it is late counted as skips. It is stall % P late, and every frame
+  //** after catches up by its P - 13 ms of idle
+  uint32_t stall = pacer.period_us * 53 / 10 + 8000;
+  uint32_t slack = pacer.period_us - 13000;
+  uint32_t catch_up = (stall % pacer.period_us + slack - 1) / slack;
+  expect_slots(name, &r, 0);
+  expect(name, pacer.skipped == (stall - pacer.period_us) / pacer.period_us, "skips are not the whole periods missed");
+  expect(name, r.off_grid == catch_up && r.last_begin_us % pacer.period_us == 0,
+         "after the stall the frames did not return to the grid");
+  expect(name, pacer.interval.max_us == stall, "the stall interval is not the stalled frame's length");
+}
+
+static void scenario_no_flush(const char* name) {
+  frame_pacer_init(&pacer, FPS, 0);
+  run_result_t r = run(0, FRAMES, cost_no_flush, 0);
+  report(name, &r);
+  expect_slots(name, &r, 0);
+  expect(name, pacer.frames == FRAMES - 1 && pacer.in_frame, "begin did not close the previous frame");
+  expect(name, pacer.idle.max_us == 0 && pacer.flush.max_us == pacer.period_us - 5000,
+         "a frame closed by begin should have zero idle and flush until the next begin");
+}
+
+static void scenario_fps(const char* name) {
+  frame_pacer_init(&pacer, FPS, 0);
+  run(0, FRAMES / 2, cost_steady, 0);
+  frame_pacer_set_fps(&pacer, 30, vnow);
+  frame_pacer_reset_stats(&pacer);
+  uint32_t start = vnow;
+  run_result_t r = run(start, FRAMES / 2, cost_steady, 0);
+  report(name, &r);
+  expect_slots(name, &r, start);
+  expect(name, pacer.period_us == 33333 && pacer.skipped == 0, "30 fps period or skips wrong");
+  expect(name, pacer.interval.max_us == 33333 && r.off_grid == 0, "intervals after the switch are not 33333 us");
+}
+
+int main(int argc, char** argv) {
+  printf("# frame pacer: %d fps, %d frames per scenario, virtual clock\n", FPS, FRAMES);
+  printf("scenario,frames,skipped,interval_p50,interval_p99,interval_max,render_p99,flush_p99,idle_p50,"
+         "max_grid_offset\n");
+  scenario_steady("steady", 0);
+  scenario_jitter("jitter");
+  scenario_over("over");
+  scenario_stall("stall");
+  scenario_no_flush("no_flush");
+  scenario_steady("wrap", 0xFFFFFFFFu - 100u * (1000000u / FPS));
+  scenario_fps("fps");
+
+  printf("pacer: %s\n", failures ? "FAIL" : "OK");
+  return failures ? 1 : 0;
+}
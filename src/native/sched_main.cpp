@@ -0,0 +1,342 @@
+//** ESP32-S3 HoloCubic - 主机上的调度器模拟 / Scheduler Simulation on the Host
+//**
+//** pio run -e native_sched -t exec
+//** .pio/build/native_sched/program 600        # 模拟600秒 / simulate 600 s
+//**
+//** 虚拟时钟上跑和app_main相同的任务组合，每个任务按设备上量到的量级消耗时间；
+//** 串口命令按随机间隔到达。同样的负载再用旧的 "全部轮询 + delay(10)" 主循环跑一遍做对比。
+//** Runs the same task mix as app_main on a virtual clock, each task spending roughly what it costs on
+//** the device; serial commands arrive at random intervals. The same load then runs through the old
+//** "poll everything + delay(10)" loop for comparison.
+//**
+//** 之前先检查时间轮本身：micros()回绕、一圈 (64格，65.5ms) 以外的截止时间、睡过头好几圈，
+//** 任务不能早跑、不能漏跑、不能有空唤醒；不对退出码1
+//** Before that the wheel itself is checked: micros() wrapping, deadlines more than one revolution (64 slots,
+//** 65.5 ms) away, and oversleeping several revolutions - no task may run early or be missed, and no wakeup
+//** may be empty; any failure exits with 1
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "app_sched.h"
+
+#define FRAME_US        33333u      // 30 fps
+#define RENDER_US       4000u
+#define BANDS           24u         // 240行 / DISPLAY_FLUSH_BAND_LINES
+#define BAND_US         960u        // 10行RGB565 @ 40MHz SPI (HW_DISPLAY_SPI_FREQ)
+#define LED_US          20000u      // 动画帧
+#define WIFI_US         5000000u
+#define HEARTBEAT_US    1000000u
+#define COMMAND_GAP_US  700000u     // 串口命令平均间隔
+#define WAKE_US         20u         // esp_timer回调到主循环被唤醒
+
+static uint32_t vnow;               // 虚拟时钟 (us)
+static app_sched_t sched;
+static int8_t task_display, task_frame, task_command;
+
+//** 串口事件 - 指数分布的到达间隔，记下到达时间算延迟
+static uint32_t next_command_us;
+static uint32_t command_arrived_us;
+static bool command_waiting;
+static uint32_t command_max_us;
+
+static uint32_t rand_gap(uint32_t mean) {
+  //** 两个均匀分布的和 - 够用，不需要真正的指数分布
+  return (uint32_t)(((uint64_t)rand() % mean) + ((uint64_t)rand() % mean));
+}
+
+static void command_arrive(void) {
+  command_arrived_us = next_command_us;
+  command_waiting = true;
+  next_command_us += 1 + rand_gap(COMMAND_GAP_US);
+}
+
+static void command_serve(void) {
+  if (!command_waiting) return;
+  uint32_t late = vnow - command_arrived_us;
+  if (late > command_max_us) command_max_us = late;
+  command_waiting = false;
+  vnow += 100;
+}
+
+//** 刷新引擎 - 和display_flush一样，DMA发完一带要等poll才开始下一带
+static uint32_t frame_bands;        // 每帧脏了几带 - 整屏重画24，静止界面0
+static bool flushing;
+static bool frame_blocked;          // 帧任务到期时上一帧还在传 - 传完叫醒它
+static uint32_t bands_left;
+static uint32_t band_end_us;
+
+static void flush_start(void) {
+  flushing = frame_bands > 0;
+  bands_left = frame_bands ? frame_bands - 1 : 0;
+  band_end_us = vnow + BAND_US;
+}
+
+static void flush_poll(void) {
+  vnow += 15;
+  if (!flushing || (int32_t)(vnow - band_end_us) < 0) return;
+  if (bands_left) {
+    bands_left--;
+    band_end_us = vnow + BAND_US;
+  } else {
+    flushing = false;
+    if (frame_blocked) app_sched_signal(&sched, task_frame);   // 刷新完成回调
+  }
+}
+
+//** display_fence_wait - 原地轮询到发完
+static void flush_wait(void) {
+  while (flushing) {
+    if ((int32_t)(vnow - band_end_us) < 0) vnow = band_end_us;
+    flush_poll();
+  }
+}
+
+//** ===== 新主循环里的任务 =====
+
+//** 在途的一带落地时再来 - display_flush_wait_us()
+static uint32_t run_display(uint32_t now, void* ctx) {
+  flush_poll();
+  if (!flushing) return APP_SCHED_IDLE;
+  return (int32_t)(band_end_us - now) > 0 ? band_end_us - now : 1;
+}
+
+//** 截止时间按周期前进，和frame_pacer一样
+static uint32_t frame_deadline;
+
+static uint32_t run_frame(uint32_t now, void* ctx) {
+  frame_blocked = flushing;           // 上一帧还在传 - 等刷新完成叫醒
+  if (frame_blocked) return APP_SCHED_IDLE;
+  vnow += RENDER_US;
+  flush_start();
+  app_sched_signal(&sched, task_display);
+  frame_deadline += FRAME_US;
+  return frame_deadline - now;
+}
+
+static uint32_t run_led(uint32_t now, void* ctx) { vnow += 50; return LED_US; }
+static uint32_t run_wifi(uint32_t now, void* ctx) { vnow += 200; return WIFI_US; }
+static uint32_t run_heartbeat(uint32_t now, void* ctx) { vnow += 20; return HEARTBEAT_US; }
+static uint32_t run_command(uint32_t now, void* ctx) { command_serve(); return APP_SCHED_IDLE; }
+
+static void report(const char* name, uint32_t seconds, uint32_t wakeups, uint32_t worst_late, uint32_t busy_us) {
+  printf("%-5s %-10s %8.1f %10lu %12lu %8.2f\n", frame_bands ? "full" : "idle", name, (double)wakeups / seconds, (unsigned long)worst_late,
+         (unsigned long)command_max_us, 100.0 * busy_us / (seconds * 1000000.0));
+}
+
+static void run_scheduler(uint32_t seconds) {
+  vnow = 0;
+  flushing = false;
+  frame_blocked = false;
+  command_max_us = 0;
+  command_waiting = false;
+  srand(1);
+  next_command_us = rand_gap(COMMAND_GAP_US);
+
+  frame_deadline = 0;
+  app_sched_init(&sched, vnow);
+  task_display = app_sched_add(&sched, "display", run_display, NULL, APP_SCHED_IDLE, vnow);
+  task_frame = app_sched_add(&sched, "frame", run_frame, NULL, 0, vnow);
+  app_sched_add(&sched, "wifi", run_wifi, NULL, 0, vnow);
+  app_sched_add(&sched, "led", run_led, NULL, 0, vnow);
+  task_command = app_sched_add(&sched, "command", run_command, NULL, APP_SCHED_IDLE, vnow);
+  app_sched_add(&sched, "heartbeat", run_heartbeat, NULL, HEARTBEAT_US, vnow);
+
+  uint32_t end = seconds * 1000000u;
+  uint32_t busy = 0;
+  while ((int32_t)(vnow - end) < 0) {
+    uint32_t before = vnow;
+    app_sched_dispatch(&sched, vnow);
+    busy += vnow - before;
+
+    //** 睡到最近的截止时间，或者被串口事件提前叫醒
+    uint32_t timeout = app_sched_timeout_us(&sched, vnow);
+    if (timeout == 0) continue;
+    uint32_t wake = timeout == APP_SCHED_IDLE ? end : vnow + timeout;
+    if ((int32_t)(next_command_us - wake) < 0) {
+      wake = (int32_t)(next_command_us - vnow) > 0 ? next_command_us : vnow;
+      command_arrive();
+      app_sched_signal(&sched, task_command);
+    }
+    vnow = wake + WAKE_US;
+  }
+
+  report("tickless", seconds, sched.wakeups, sched.max_late_us, busy);
+  for (uint8_t i = 0; i < sched.count; i++) {
+    const app_task_t* t = &sched.tasks[i];
+    printf("#     %-10s runs/s %7.1f  max_late_us %6lu\n", t->name, (double)t->runs / seconds,
+           (unsigned long)t->max_late_us);
+  }
+}
+
+//** ===== 旧主循环：每次都轮询全部模块，然后 delay(min(下一帧, 10ms)) =====
+
+static void run_polling(uint32_t seconds) {
+  vnow = 0;
+  flushing = false;
+  frame_blocked = false;
+  command_max_us = 0;
+  command_waiting = false;
+  srand(1);
+  next_command_us = rand_gap(COMMAND_GAP_US);
+
+  uint32_t wifi_due = 0, beat_due = HEARTBEAT_US;
+  frame_deadline = 0;
+  uint32_t wakeups = 0, worst = 0, busy = 0;
+  uint32_t end = seconds * 1000000u;
+
+  while ((int32_t)(vnow - end) < 0) {
+    uint32_t before = vnow;
+    wakeups++;
+    while ((int32_t)(next_command_us - vnow) <= 0) command_arrive();
+
+    flush_poll();
+    if ((int32_t)(vnow - frame_deadline) >= 0) {
+      if (vnow - frame_deadline > worst) worst = vnow - frame_deadline;
+      flush_wait();
+      vnow += RENDER_US;
+      flush_start();
+      frame_deadline += FRAME_US;
+    }
+    if ((int32_t)(vnow - wifi_due) >= 0) {
+      if (vnow - wifi_due > worst) worst = vnow - wifi_due;
+      wifi_due = vnow + WIFI_US;
+      vnow += 200;
+    }
+    vnow += 50;                                           // led_process每次循环都跑
+    command_serve();
+    if ((int32_t)(vnow - beat_due) >= 0) {
+      if (vnow - beat_due > worst) worst = vnow - beat_due;
+      beat_due = vnow + HEARTBEAT_US;
+      vnow += 20;
+    }
+    busy += vnow - before;
+
+    uint32_t until = frame_deadline - vnow;
+    uint32_t sleep_ms = (int32_t)until <= 0 ? 0 : until / 1000;
+    if (sleep_ms > 10) sleep_ms = 10;
+    vnow += sleep_ms * 1000;
+  }
+
+  report("delay(10)", seconds, wakeups, worst, busy);
+}
+
+//** ===== 时间轮检查 =====
+
+//** 一圈是 64 * 1024us = 65536us - 周期覆盖格内、正好一格、一圈、一圈多、好几圈
+static const uint32_t wheel_periods[] = { 700, 1024, 20000, 65536, 70001, 1000000, 5000000 };
+#define WHEEL_TASKS   (sizeof(wheel_periods) / sizeof(wheel_periods[0]))
+#define WHEEL_SECONDS 12u
+#define WHEEL_STALL_US 300000u      // 睡过头4.6圈
+
+static uint32_t failures;
+static uint32_t wheel_due[WHEEL_TASKS];
+static uint32_t wheel_runs[WHEEL_TASKS];
+static uint32_t wheel_early;
+
+static void fail(const char* check, const char* what) {
+  failures++;
+  if (failures <= 20) printf("FAIL %s: %s\n", check, what);
+}
+
+static uint32_t run_wheel(uint32_t now, void* ctx) {
+  uint32_t i = (uint32_t)(uintptr_t)ctx;
+  if ((int32_t)(now - wheel_due[i]) < 0) wheel_early++;
+  wheel_runs[i]++;
+  wheel_due[i] = now + wheel_periods[i];
+  return wheel_periods[i];
+}
+
+//** 每次睡到app_sched_timeout_us()正好的时间 - 唤醒不晚，所以不该有延迟；stall_at以后睡过头一次
+static void check_wheel(const char* name, uint32_t start, bool stall) {
+  char what[160];
+  app_sched_init(&sched, start);
+  wheel_early = 0;
+  for (uint32_t i = 0; i < WHEEL_TASKS; i++) {
+    wheel_runs[i] = 0;
+    wheel_due[i] = start + wheel_periods[i];
+    app_sched_add(&sched, "wheel", run_wheel, (void*)(uintptr_t)i, wheel_periods[i], start);
+  }
+
+  uint32_t now = start, empty = 0, left_behind = 0, last = start, stall_late = 0;
+  bool stalled = !stall;
+  while (now - start < WHEEL_SECONDS * 1000000u) {
+    if (app_sched_dispatch(&sched, now) == 0 && now != start) empty++;   // 开始时什么都没到期
+    last = now;
+    for (uint32_t i = 0; i < WHEEL_TASKS; i++) {
+      if ((int32_t)(wheel_due[i] - now) <= 0) left_behind++;
+    }
+
+    uint32_t timeout = app_sched_timeout_us(&sched, now);
+    if (timeout == APP_SCHED_IDLE) break;
+    if (!stalled && now - start >= 3000000u) {
+      //** 越过好几圈才醒 - 下一次dispatch要把错过的全补上，延迟就是睡过头的量
+      stall_late = WHEEL_STALL_US;
+      timeout += WHEEL_STALL_US;
+      stalled = true;
+    }
+    now += timeout;
+  }
+
+  uint32_t expect_runs = 0, runs = 0;
+  for (uint32_t i = 0; i < WHEEL_TASKS; i++) {
+    runs += wheel_runs[i];
+    expect_runs += (last - start) / wheel_periods[i];
+  }
+  printf("%-12s 0x%08lX %6lu %8lu %6lu %6lu %8lu\n", name, (unsigned long)start, (unsigned long)sched.wakeups,
+         (unsigned long)runs, (unsigned long)empty, (unsigned long)wheel_early, (unsigned long)sched.max_late_us);
+
+  if (wheel_early || left_behind) {
+    snprintf(what, sizeof(what), "%lu runs before their deadline, %lu deadlines left behind a dispatch",
+             (unsigned long)wheel_early, (unsigned long)left_behind);
+    fail(name, what);
+  }
+  if (empty) {
+    snprintf(what, sizeof(what), "%lu wakeups ran nothing - the timeout pointed at another revolution",
+             (unsigned long)empty);
+    fail(name, what);
+  }
+  if (sched.max_late_us > stall_late) {
+    snprintf(what, sizeof(what), "a task ran %lu us late, only the %lu us oversleep is allowed",
+             (unsigned long)sched.max_late_us, (unsigned long)stall_late);
+    fail(name, what);
+  }
+  //** 没睡过头时每个任务正好在每个周期跑一次；睡过头时每个任务只少跑 stall / period 次以内
+  //** Without the oversleep every task runs exactly once per period; with it each loses at most stall / period runs
+  uint32_t lost = 0;
+  if (stall) {
+    for (uint32_t i = 0; i < WHEEL_TASKS; i++) lost += WHEEL_STALL_US / wheel_periods[i] + 1;
+  }
+  if (runs > expect_runs || runs + lost < expect_runs) {
+    snprintf(what, sizeof(what), "%lu runs, want %lu (at most %lu fewer)", (unsigned long)runs,
+             (unsigned long)expect_runs, (unsigned long)lost);
+    fail(name, what);
+  }
+}
+
+int main(int argc, char** argv) {
+  uint32_t seconds = argc > 1 ? (uint32_t)atoi(argv[1]) : 60;
+  if (seconds == 0 || seconds > 4000) seconds = 60;
+
+  printf("# wheel %u s virtual, periods 700 us .. 5 s, waking exactly at app_sched_timeout_us()\n", WHEEL_SECONDS);
+  printf("wheel        start      wakeups  runs  empty  early max_late\n");
+  check_wheel("zero", 0, false);
+  check_wheel("wrap", 0xFFFFFFFFu - 2500000u, false);
+  check_wheel("wrap_stall", 0xFFFFFFFFu - 3100000u, true);
+  check_wheel("stall", 0, true);
+  printf("wheel: %s\n\n", failures ? "FAIL" : "OK");
+
+  printf("# sched_sim %lu s virtual, 30fps frame, LED %u ms, serial command every ~%u ms\n",
+         (unsigned long)seconds, LED_US / 1000, COMMAND_GAP_US / 1000);
+  printf("ui    loop       wakeups/s  worst_late_us  command_max_us   busy%%\n");
+
+  //** 整屏每帧重画，和静止界面 (刷新什么都不发) / full redraw every frame, and a static screen
+  static const uint32_t loads[] = { BANDS, 0 };
+  for (uint8_t i = 0; i < 2; i++) {
+    frame_bands = loads[i];
+    run_polling(seconds);
+    run_scheduler(seconds);
+  }
+  return failures ? 1 : 0;
+}
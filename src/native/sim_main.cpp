@@ -0,0 +1,393 @@
+//** ESP32-S3 HoloCubic - 主机模拟 / Host Simulation
+//**
+//** pio run -e native
+//** .pio/build/native/program [选项 / options] < commands.txt
+//**
+//**   --seconds N        跑多少虚拟秒，默认60 / virtual seconds to run, default 60
+//**   --realtime         虚拟时间跟墙上时间走，交互用 / pace virtual time to the wall clock, for interactive use
+//**   --cpu-scale X      主机CPU时间乘X记进虚拟时间，默认1；0 = 结果可重复 / host CPU time counts X times, default 1;
+//**                      0 = repeatable runs (see Arduino.h)
+//**   --wifi TIMELINE    WiFi时间线，格式见WiFi.h / WiFi timeline, format in WiFi.h
+//**   --data DIR         SPIFFS的根目录，默认data / SPIFFS root directory, default data
+//**   --assets FILE      资源包映像，当作assets分区 / asset pack image, mounted as the assets partition
+//**   --png FILE         结束时把屏幕存成PNG / save the screen as a PNG at the end
+//**   --png-every MS     每MS虚拟毫秒存一张；FILE里有%u时换成毫秒数 / save one every MS virtual ms; a %u in FILE
+//**                      becomes the timestamp
+//**   --leds FILE        LED帧变了就记一行CSV / log a CSV row whenever the LED frame changes
+//**   --record FILE      结束时把输入记录存成文件 / save the input trace to FILE at the end
+//**   --replay FILE      重放设备存的输入记录 (串口命令T)，代替stdin和WiFi时间线；强制--cpu-scale 0
+//**                      replay an input trace saved on the device (serial command T) in place of stdin and the
+//**                      WiFi timeline; forces --cpu-scale 0
+//**
+//** 设备的setup()/loop()原样跑在FreeRTOS替身的loopTask里，app_io任务是另一个替身任务。
+//** 串口输出就是stdout，模拟自己的汇总打到stderr。
+//** The device's setup()/loop() run unmodified in the FreeRTOS stand-in's loopTask, with app_io as another task.
+//** Serial output is stdout; the simulation's own summary goes to stderr.
+//**
+//** 回放按设备app_init()的时刻对齐：记录里的时间减去记录开始的时间，加上主机上app_init()的时间。
+//** 回放的输入在设备读到它之前半个轮询周期送进去，主机的轮询比设备早一点也能读到同一个值 (见replay_lead_us)。
+//** 结束时报每圈loop()的主机耗时，和记录里设备上每圈的间隔。
+//** Replay is aligned on the device's app_init(): trace time minus the trace start, plus the host's app_init() time.
+//** Each input goes in half a poll period before the device read it, so a host poll that runs slightly ahead of the
+//** device still reads the same value (see replay_lead_us). At the end it reports the host time of each
+//** loop() pass, and the device's pass-to-pass interval from the trace.
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include <SPIFFS.h>
+#include <WiFi.h>
+#include <esp_partition.h>
+#include <QMI8658.h>
+#include <imu_gesture_driver.h>
+#include <chrono>
+#include <vector>
+#include "app_main.h"
+#include "app_constants.h"
+#include "app_trace.h"
+#include "hardware_config.h"
+#include "lat_hist.h"
+#include "display_assets_flash.h"
+#include "display_driver.h"
+
+void setup(void);
+void loop(void);
+
+#define WORST_COUNT 5
+
+//** 最慢的几圈，从慢到快 / The slowest passes, slowest first
+struct worst_t {
+    uint32_t value[WORST_COUNT];
+    uint32_t at_ms[WORST_COUNT];
+
+    void add(uint32_t v, uint32_t ms) {
+        if (v <= value[WORST_COUNT - 1]) return;
+        int i = WORST_COUNT - 1;
+        for (; i > 0 && value[i - 1] < v; i--) {
+            value[i] = value[i - 1];
+            at_ms[i] = at_ms[i - 1];
+        }
+        value[i] = v;
+        at_ms[i] = ms;
+    }
+};
+
+static uint32_t loop_calls = 0;
+static FILE* led_log = NULL;
+static lat_hist_t host_loop_ns;
+static worst_t host_worst;
+
+//** 和arduino-esp32的loopTask一样，只是每圈让一次 - 替身任务不会被抢占
+//** Like arduino-esp32's loopTask, except it yields every pass - stand-in tasks are never preempted
+static void loop_task(void* arg) {
+    setup();
+    for (;;) {
+        uint32_t at_ms = millis();
+        auto start = std::chrono::steady_clock::now();
+        loop();
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        uint32_t pass_ns = ns > UINT32_MAX ? UINT32_MAX : (uint32_t)ns;
+        lat_hist_add(&host_loop_ns, pass_ns);
+        host_worst.add(pass_ns, at_ms);
+        loop_calls++;
+        taskYIELD();
+    }
+}
+
+static void log_leds(const CRGB* pixels, int count, uint8_t brightness) {
+    static CRGB last[FASTLED_FAKE_MAX_LEDS];
+    static uint8_t last_brightness;
+    static bool logged = false;
+    if (logged && brightness == last_brightness && memcmp(last, pixels, (size_t)count * sizeof(CRGB)) == 0) return;
+    memcpy(last, pixels, (size_t)count * sizeof(CRGB));
+    last_brightness = brightness;
+    logged = true;
+
+    fprintf(led_log, "%lu,%u", millis(), brightness);
+    for (int i = 0; i < count; i++) fprintf(led_log, ",%02x%02x%02x", pixels[i].r, pixels[i].g, pixels[i].b);
+    fprintf(led_log, "\n");
+}
+
+static void save_png(const char* pattern, uint32_t ms) {
+    if (!display_tft()) return;
+    char path[512];
+    snprintf(path, sizeof(path), pattern, ms);
+    if (!display_tft()->savePNG(path)) fprintf(stderr, "# PNG write failed: %s\n", path);
+}
+
+static const char* png = NULL;
+static uint32_t png_every_ms = 0;
+static uint64_t png_us = UINT64_MAX;
+
+//** 跑到end_us，路上按时存PNG；所有任务都永远等下去时返回false
+//** Run to end_us, saving PNGs on schedule; false once every task waits forever
+static bool run_until(uint64_t end_us) {
+    bool alive = true;
+    while (alive && host_clock_us() < end_us) {
+        alive = host_rtos_run(png_us < end_us ? png_us : end_us);
+        if (host_clock_us() >= png_us) {
+            save_png(png, (uint32_t)(png_us / 1000u));
+            png_us += (uint64_t)png_every_ms * 1000u;
+        }
+    }
+    return alive;
+}
+
+static void print_hist(const char* name, const lat_hist_t* hist, const worst_t* worst, const char* unit) {
+    if (!hist->samples) return;
+    fprintf(stderr, "# %s (%s): %u passes, p50 %u, p99 %u, max %u, avg %llu\n", name, unit, hist->samples,
+            lat_hist_percentile(hist, 50), lat_hist_percentile(hist, 99), hist->max,
+            (unsigned long long)(hist->total / hist->samples));
+    fprintf(stderr, "#   slowest:");
+    for (int i = 0; i < WORST_COUNT && worst->value[i]; i++) fprintf(stderr, " %u @%ums", worst->value[i], worst->at_ms[i]);
+    fprintf(stderr, "\n");
+}
+
+static bool read_file(const char* path, std::vector<uint8_t>* out) {
+    FILE* fp = fopen(path, "rb");
+    if (!fp) return false;
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), fp)) > 0) out->insert(out->end(), chunk, chunk + n);
+    fclose(fp);
+    return true;
+}
+
+static bool save_trace(const char* path) {
+    uint32_t len;
+    const uint8_t* data = app_trace_snapshot(&len);
+    FILE* fp = data ? fopen(path, "wb") : NULL;
+    if (!fp) return false;
+    bool ok = fwrite(data, 1, len, fp) == len;
+    return fclose(fp) == 0 && ok;
+}
+
+//** 设备记下的输入，在设备读到的时刻送给替身 / Hand a recorded input to the stand-ins at the time the device read it
+static void replay_apply(const input_trace_record_t* record) {
+    switch (record->type) {
+    case INPUT_TRACE_SERIAL:
+        Serial.inject(record->payload, 1);
+        break;
+    case INPUT_TRACE_WIFI_STATUS:
+        WiFi.force_status((wl_status_t)record->payload[0]);
+        break;
+    case INPUT_TRACE_WIFI_RSSI:
+        WiFi.force_rssi((int8_t)record->payload[0]);
+        break;
+    case INPUT_TRACE_IMU: {
+        float acc[3], gyro[3];
+        input_trace_unpack_imu(record->payload, acc, gyro);
+        host_imu_set(acc, gyro);
+        host_imu_gesture((ImuGestureType)record->arg);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+//** 固件是轮询读这些输入的：主机和设备的轮询时刻差几个us，输入按设备读到的时刻送进去，主机那次轮询可能刚好
+//** 早了一点，要等下一轮。提前半个轮询周期送，前一轮还读不到，这一轮一定读得到
+//** The firmware polls these inputs and the host's polls land a few us away from the device's, so an input delivered
+//** exactly when the device read it can just miss the host's poll and wait a whole period. Delivered half a period
+//** early, the previous poll still cannot see it and this one always does
+static uint64_t replay_lead_us(uint8_t type) {
+    switch (type) {
+    case INPUT_TRACE_SERIAL:
+        return APP_COMMAND_POLL_MS * 500ull;
+    case INPUT_TRACE_WIFI_STATUS:
+    case INPUT_TRACE_WIFI_RSSI:
+        return HW_WIFI_STATUS_CHECK_MS * 500ull;
+    default:
+        return 0;
+    }
+}
+
+//** 跑到主机的app_init()之后第一次切换，返回app_init()时的虚拟时间 - 主机自己的记录从那里开始
+//** Run to the first switch after the host's app_init() and return the virtual time of app_init() - the host's own
+//** trace starts there
+static bool replay_align(uint64_t* host_start_us) {
+    bool alive = true;
+    host_rtos_stop_when(app_trace_active);
+    while (alive && !app_trace_active()) alive = host_rtos_run(UINT64_MAX);
+    host_rtos_stop_when(NULL);
+    if (!alive) return false;
+
+    uint32_t len;
+    const uint8_t* data = app_trace_snapshot(&len);
+    input_trace_reader_t own;
+    if (input_trace_open(&own, data, len) != INPUT_TRACE_OK) return false;
+    *host_start_us = own.start_us;
+    return true;
+}
+
+//** end_us为0时跑到记录结束后1秒 / With end_us 0, run until 1 s after the trace ends
+static bool replay(input_trace_reader_t* reader, uint64_t end_us) {
+    //** 设备第一次读WiFi状态一定有记录，这个初值读不到 / The device's first status read is always recorded, so
+    //** this initial value is never seen
+    WiFi.force_status(WL_DISCONNECTED);
+
+    uint64_t host_start_us;
+    if (!replay_align(&host_start_us)) {
+        fprintf(stderr, "# firmware never reached app_init()\n");
+        return false;
+    }
+
+    lat_hist_t device_loop_us;
+    worst_t device_worst = {};
+    lat_hist_reset(&device_loop_us);
+    uint32_t counts[INPUT_TRACE_TYPE_COUNT] = {};
+    uint64_t last_tick_us = UINT64_MAX;
+    uint64_t trace_end_us = host_start_us;
+    bool alive = true;
+
+    input_trace_record_t record;
+    input_trace_result_t result = INPUT_TRACE_OK;
+    while (alive && (result = input_trace_next(reader, &record)) == INPUT_TRACE_OK && record.type) {
+        uint64_t at_us = host_start_us + (record.time_us - reader->start_us);
+        uint64_t lead_us = replay_lead_us(record.type);
+        counts[record.type]++;
+        trace_end_us = at_us;
+
+        if (record.type == INPUT_TRACE_TICK) {
+            if (last_tick_us != UINT64_MAX) {
+                uint64_t gap = at_us - last_tick_us;
+                uint32_t gap_us = gap > UINT32_MAX ? UINT32_MAX : (uint32_t)gap;
+                lat_hist_add(&device_loop_us, gap_us);
+                device_worst.add(gap_us, (uint32_t)(last_tick_us / 1000u));
+            }
+            last_tick_us = at_us;
+            continue;
+        }
+        alive = run_until(at_us > host_start_us + lead_us ? at_us - lead_us : host_start_us);
+        if (alive) replay_apply(&record);
+    }
+    if (alive && result != INPUT_TRACE_OK) fprintf(stderr, "# trace stops early: %s\n", input_trace_result_str(result));
+
+    if (alive) alive = run_until(end_us ? end_us : trace_end_us + 1000000u);
+    if (!alive) fprintf(stderr, "# every task is waiting forever - stopping\n");
+
+    fprintf(stderr, "# replayed %u serial bytes, %u WiFi status, %u RSSI, %u IMU, %u device loop passes\n",
+            counts[INPUT_TRACE_SERIAL], counts[INPUT_TRACE_WIFI_STATUS], counts[INPUT_TRACE_WIFI_RSSI],
+            counts[INPUT_TRACE_IMU], counts[INPUT_TRACE_TICK]);
+    print_hist("device loop interval", &device_loop_us, &device_worst, "us");
+    return alive;
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "usage: %s [--seconds N] [--realtime] [--cpu-scale X] [--wifi TIMELINE] [--data DIR]\n"
+            "          [--assets FILE] [--png FILE] [--png-every MS] [--leds FILE] [--record FILE]\n"
+            "          [--replay FILE]\n",
+            prog);
+}
+
+int main(int argc, char** argv) {
+    double seconds = 60;
+    bool seconds_set = false;
+    double cpu_scale = 1;
+    bool realtime = false;
+    const char* record = NULL;
+    std::vector<uint8_t> trace;
+    input_trace_reader_t reader;
+    bool replaying = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* opt = argv[i];
+        const char* val = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(opt, "--realtime") == 0) {
+            realtime = true;
+            continue;
+        }
+        if (!val) {
+            usage(argv[0]);
+            return 2;
+        }
+        i++;
+        if (strcmp(opt, "--seconds") == 0) {
+            seconds = atof(val);
+            seconds_set = true;
+        } else if (strcmp(opt, "--cpu-scale") == 0) {
+            cpu_scale = atof(val);
+        } else if (strcmp(opt, "--wifi") == 0) {
+            if (!WiFi.script(val)) {
+                fprintf(stderr, "bad WiFi timeline: %s\n", val);
+                return 2;
+            }
+        } else if (strcmp(opt, "--data") == 0) {
+            SPIFFS.set_root(val);
+        } else if (strcmp(opt, "--assets") == 0) {
+            if (!host_partition_load(DISPLAY_ASSETS_PARTITION, ESP_PARTITION_TYPE_DATA,
+                                     (esp_partition_subtype_t)DISPLAY_ASSETS_SUBTYPE, val)) {
+                fprintf(stderr, "cannot read asset pack: %s\n", val);
+                return 2;
+            }
+        } else if (strcmp(opt, "--png") == 0) {
+            png = val;
+        } else if (strcmp(opt, "--png-every") == 0) {
+            png_every_ms = (uint32_t)strtoul(val, NULL, 0);
+        } else if (strcmp(opt, "--leds") == 0) {
+            led_log = fopen(val, "w");
+            if (!led_log) {
+                fprintf(stderr, "cannot write %s\n", val);
+                return 2;
+            }
+            fprintf(led_log, "ms,brightness,leds\n");
+            FastLED.on_show = log_leds;
+        } else if (strcmp(opt, "--record") == 0) {
+            record = val;
+        } else if (strcmp(opt, "--replay") == 0) {
+            if (!read_file(val, &trace)) {
+                fprintf(stderr, "cannot read %s\n", val);
+                return 2;
+            }
+            input_trace_result_t result = input_trace_open(&reader, trace.data(), (uint32_t)trace.size());
+            if (result != INPUT_TRACE_OK) {
+                fprintf(stderr, "cannot replay %s: %s\n", val, input_trace_result_str(result));
+                return 2;
+            }
+            if (reader.truncated) fprintf(stderr, "# trace was truncated on the device - replay ends where it does\n");
+            replaying = true;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (replaying) {
+        //** 输入全来自记录，虚拟时间只由代码路径决定 / Every input comes from the trace and virtual time
+        //** depends only on the code path
+        cpu_scale = 0;
+        realtime = false;
+        Serial.set_input(-1);
+    }
+    host_clock_config(cpu_scale, realtime);
+    if (xTaskCreatePinnedToCore(loop_task, "loopTask", 8192, NULL, 1, NULL, ARDUINO_RUNNING_CORE) != pdPASS) {
+        fprintf(stderr, "cannot create loopTask\n");
+        return 1;
+    }
+
+    auto wall_start = std::chrono::steady_clock::now();
+    if (png && png_every_ms) png_us = (uint64_t)png_every_ms * 1000u;
+    uint64_t end_us = (uint64_t)(seconds * 1e6);
+    bool alive;
+    if (replaying) {
+        alive = replay(&reader, seconds_set ? end_us : 0);
+    } else {
+        alive = run_until(end_us);
+        if (!alive) fprintf(stderr, "# every task is waiting forever - stopping\n");
+    }
+
+    fflush(stdout);
+    if (png) save_png(png, millis());
+    if (led_log) fclose(led_log);
+    if (record && !save_trace(record)) fprintf(stderr, "# cannot write trace %s\n", record);
+
+    double virt = host_clock_us() / 1e6;
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+    fprintf(stderr, "# sim: %.3f s virtual in %.3f s wall (%.0fx), %u loop() calls, %u task switches\n", virt, wall,
+            wall > 0 ? virt / wall : 0.0, loop_calls, host_rtos_switches());
+    fprintf(stderr, "# frames %u (skipped %u), LED shows %u, WiFi transitions %u\n", app_frame_pacer()->frames,
+            app_frame_pacer()->skipped, FastLED.show_count, WiFi.transitions());
+    print_hist("host loop() time", &host_loop_ns, &host_worst, "ns");
+    return alive ? 0 : 1;
+}
@@ -0,0 +1,106 @@
+//** ESP32-S3 HoloCubic - SPSC队列主机压测 / SPSC Queue Stress Test on the Host
+//**
+//** pio run -e native_spsc -t exec
+//** .pio/build/native_spsc/program 20000000      # 每轮消息数 / messages per run
+//**
+//** 一个线程push一个线程pop，和两个核的用法一样。每条消息的每个字节都由序号决定，
+//** 消费者逐字节核对：丢消息、重复、乱序、读到写了一半的槽都会报错并返回1。
+//** 不同容量各跑一轮，最后报吞吐量。
+//** One thread pushes and one pops, as the two cores do. Every byte of every message is derived from
+//** its sequence number and the consumer checks all of them: a lost, duplicated, reordered or torn
+//** message fails the run with exit code 1. Runs once per capacity and reports throughput.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <chrono>
+#include "app_msg.h"
+
+//** 小消息 - 只测队列本身的开销
+struct small_msg_t {
+  uint32_t seq;
+  uint32_t check;
+};
+
+static void fill(small_msg_t* msg, uint32_t seq) {
+  msg->seq = seq;
+  msg->check = ~seq * 2654435761u;
+}
+
+static bool verify(const small_msg_t* msg, uint32_t seq) {
+  return msg->seq == seq && msg->check == ~seq * 2654435761u;
+}
+
+//** 真正在核间传的消息 - led_request_t整个被填满
+static void fill(app_msg_t* msg, uint32_t seq) {
+  uint8_t* bytes = (uint8_t*)msg;
+  for (size_t i = 0; i < sizeof(*msg); i++) bytes[i] = (uint8_t)(seq * 31u + i);
+  msg->event.value = (int32_t)seq;
+}
+
+static bool verify(const app_msg_t* msg, uint32_t seq) {
+  app_msg_t want;
+  fill(&want, seq);
+  return memcmp(msg, &want, sizeof(want)) == 0;
+}
+
+template <typename T, uint32_t N>
+static bool run(const char* name, uint32_t count) {
+  static spsc_queue<T, N> queue;
+  uint32_t errors = 0, first_bad = 0;
+  uint64_t full = 0, empty = 0;
+
+  auto start = std::chrono::steady_clock::now();
+
+  std::thread consumer([&] {
+    T msg;
+    for (uint32_t seq = 0; seq < count; seq++) {
+      while (!queue.pop(&msg)) {
+        empty++;
+        std::this_thread::yield();
+      }
+      if (!verify(&msg, seq) && errors++ == 0) first_bad = seq;
+    }
+  });
+
+  std::thread producer([&] {
+    T msg;
+    for (uint32_t seq = 0; seq < count; seq++) {
+      fill(&msg, seq);
+      while (!queue.push(msg)) {
+        full++;
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  producer.join();
+  consumer.join();
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  bool ok = errors == 0 && queue.empty();
+  printf("%-10s %5u %4zu %10u %8.2f %10.1f %12llu %12llu  %s", name, N, sizeof(T), count, seconds,
+         count / seconds / 1e6, (unsigned long long)full, (unsigned long long)empty, ok ? "ok" : "FAIL");
+  if (errors) printf(" (%u bad, first at %u)", errors, first_bad);
+  printf("\n");
+  return ok;
+}
+
+int main(int argc, char** argv) {
+  uint32_t count = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : 10000000u;
+  if (count == 0) count = 10000000u;
+
+  printf("# spsc_stress %u messages per run, %u hardware threads\n", count, std::thread::hardware_concurrency());
+  printf("msg        depth size   messages  seconds      M/s   full_spins  empty_spins\n");
+
+  bool ok = true;
+  //** 容量2最容易暴露下标和槽重用的错误
+  ok &= run<small_msg_t, 2>("small", count);
+  ok &= run<small_msg_t, 16>("small", count);
+  ok &= run<small_msg_t, 1024>("small", count);
+  ok &= run<app_msg_t, 2>("app_msg", count / 4);
+  ok &= run<app_msg_t, APP_MSG_QUEUE_DEPTH>("app_msg", count / 4);
+  ok &= run<app_msg_t, 256>("app_msg", count / 4);
+  return ok ? 0 : 1;
+}
@@ -82,7 +82,8 @@ static bool panic_handle_user_input(void) {
     return true;
 }
 
-//** 等待用户输入或超时重启
+//** 等待用户输入或超时重启 - 不返回，system_panic才能是noreturn
+static void panic_wait_for_user_or_restart(void) __attribute__((noreturn));
 static void panic_wait_for_user_or_restart(void) {
     unsigned long start_time = millis();
     const unsigned long timeout_ms = HW_PANIC_TIMEOUT_MS;
@@ -96,6 +97,9 @@ static void panic_wait_for_user_or_restart(void) {
     Serial.println("Timeout reached. Restarting system...");
     delay(PANIC_RESTART_DELAY_MS);
     ESP.restart();
+    while (1) {
+        //** Arduino的EspClass::restart()没有声明noreturn，这里兜底
+    }
 }
 
 void system_panic(panic_reason_t reason, const char* message) {
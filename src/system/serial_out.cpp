@@ -0,0 +1,26 @@
+//** ESP32-S3 HoloCubic - Serialized Serial Output Implementation
+
+#include "serial_out.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+SerialOut serial_out;
+
+static StaticSemaphore_t g_lock_buf;
+static SemaphoreHandle_t g_lock = NULL;
+
+void serial_out_init(void) {
+  if (!g_lock) g_lock = xSemaphoreCreateMutexStatic(&g_lock_buf);
+}
+
+size_t SerialOut::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+size_t SerialOut::write(const uint8_t* buffer, size_t size) {
+  if (!g_lock) return Serial.write(buffer, size);
+  xSemaphoreTake(g_lock, portMAX_DELAY);
+  size_t n = Serial.write(buffer, size);
+  xSemaphoreGive(g_lock);
+  return n;
+}
@@ -0,0 +1,25 @@
+//** ESP32-S3 HoloCubic - Serialized Serial Output Header
+//** Linus原则：一个串口，一把锁 - 两个核的输出一段一段地写，谁也不插进谁中间
+//**
+//** - CONFIG_DISABLE_HAL_LOCKS=1，HWCDC自己不加锁；两个核同时Serial.write会把发送缓冲写乱
+//** - app_init()开IO任务以后还会打印的代码都写serial_out，不直接写Serial (usb_link的帧、命令输出、日志)
+//** - 每次write()整段在锁里：printf是一次write，usb_link一帧是一次write，都不会被拆开
+//** - print()+println()是两次write，中间可能夹进另一个核的一整段 - 字节不会乱，只是换行晚一点
+//** - serial_out_init()之前只有一个任务，不加锁直接写
+//** - panic不走这里：关了中断以后不能等锁
+
+#pragma once
+
+#include <Arduino.h>
+
+class SerialOut : public Print {
+public:
+  using Print::write;
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+};
+
+extern SerialOut serial_out;
+
+//** 建锁 - 在app_init()里、开IO任务之前调用
+void serial_out_init(void);